@@ -8,6 +8,10 @@
 
 #include "logdevice/admin/AdminAPIUtils.h"
 
+#include <algorithm>
+
+#include <folly/Conv.h>
+
 #include "logdevice/admin/Conv.h"
 #include "logdevice/admin/toString.h"
 #include "logdevice/common/AuthoritativeStatus.h"
@@ -140,6 +144,10 @@ void forFilteredNodes(
       res &= (node_sd.location &&
               node_sd.location->matchesPrefix(location_filter_str));
     }
+    // filter by the explicit set of node indexes
+    if (filter->node_indexes_ref().has_value()) {
+      res &= filter->node_indexes_ref()->count(index) > 0;
+    }
     return res;
   };
 
@@ -150,6 +158,34 @@ void forFilteredNodes(
   }
 }
 
+folly::Optional<std::string>
+applyNodesStatePagination(const thrift::NodesStateRequest& request,
+                          std::vector<node_index_t>& node_ids) {
+  // Page tokens are only meaningful on a deterministic order.
+  std::sort(node_ids.begin(), node_ids.end());
+  if (request.page_token_ref().has_value() &&
+      !request.page_token_ref()->empty()) {
+    auto last_seen =
+        folly::tryTo<node_index_t>(request.page_token_ref().value());
+    if (!last_seen.hasValue()) {
+      throw thrift::InvalidRequest(
+          "Malformed page_token, expected a token returned in "
+          "NodesStateResponse.next_page_token");
+    }
+    node_ids.erase(
+        node_ids.begin(),
+        std::upper_bound(node_ids.begin(), node_ids.end(), last_seen.value()));
+  }
+  if (request.page_size_ref().has_value() &&
+      request.page_size_ref().value() > 0 &&
+      node_ids.size() >
+          static_cast<size_t>(request.page_size_ref().value())) {
+    node_ids.resize(request.page_size_ref().value());
+    return folly::to<std::string>(node_ids.back());
+  }
+  return folly::none;
+}
+
 // TODO: Deprecate and use Maintenance Manager instead.
 thrift::ShardOperationalState
 toShardOperationalState(membership::StorageState storage_state,
@@ -53,6 +53,20 @@ void forFilteredNodes(
     const thrift::NodesFilter* filter,
     NodeFunctor fn);
 
+/**
+ * Applies the pagination arguments of a NodesStateRequest to the list of
+ * matching node indexes: sorts `node_ids`, drops everything up to and
+ * including the node encoded in page_token and truncates the list to
+ * page_size entries. Returns the token to set as next_page_token in the
+ * response if more nodes remain, folly::none otherwise.
+ *
+ * Throws thrift::InvalidRequest if the request carries a malformed
+ * page_token.
+ */
+folly::Optional<std::string>
+applyNodesStatePagination(const thrift::NodesStateRequest& request,
+                          std::vector<node_index_t>& node_ids);
+
 void fillNodeConfig(
     thrift::NodeConfig& out,
     node_index_t node_index,
@@ -53,7 +53,7 @@ NodesStateAPIHandler::semifuture_getNodesState(
 
   auto filter = req->filter_ref().value_or(NodesFilter());
   if (isMaintenanceManagerEnabled()) {
-    return maintenance_manager_->getNodesState(filter)
+    return maintenance_manager_->getNodesState(*req)
         .via(getThreadManager())
         .thenValue([](auto&& expected_output) {
           if (expected_output.hasError()) {
@@ -67,19 +67,32 @@ NodesStateAPIHandler::semifuture_getNodesState(
     // state.
     auto out = std::make_unique<NodesStateResponse>();
     auto nodes_configuration = processor_->getNodesConfiguration();
-    bool force = false;
-    if (req) {
-      force = req->force_ref().value_or(false);
+    auto version =
+        static_cast<int64_t>(nodes_configuration->getVersion().val());
+    // Delta polling: the caller already has this version, don't bother
+    // materializing the states again.
+    if (req->known_version_ref().has_value() &&
+        req->known_version_ref().value() == version) {
+      out->set_version(version);
+      return std::move(out);
     }
-    std::vector<thrift::NodeState> result_states;
+    bool force = req->force_ref().value_or(false);
+    std::vector<node_index_t> node_ids;
     forFilteredNodes(*nodes_configuration, &filter, [&](node_index_t index) {
+      node_ids.push_back(index);
+    });
+    auto next_page_token = applyNodesStatePagination(*req, node_ids);
+    if (next_page_token.has_value()) {
+      out->set_next_page_token(std::move(next_page_token).value());
+    }
+    std::vector<thrift::NodeState> result_states;
+    for (node_index_t index : node_ids) {
       thrift::NodeState node_state;
       toNodeState(node_state, index, force);
       result_states.push_back(std::move(node_state));
-    });
+    }
     out->set_states(std::move(result_states));
-    out->set_version(
-        static_cast<int64_t>(nodes_configuration->getVersion().val()));
+    out->set_version(version);
     return std::move(out);
   }
 }
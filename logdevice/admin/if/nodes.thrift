@@ -474,6 +474,12 @@ struct NodesFilter {
    * row, cluster, and etc.
    */
   3: optional string location,
+  /**
+   * If set, only nodes whose index is in this set match. Applied in addition
+   * to the other fields of the filter. This allows tooling that tracks a
+   * fixed set of nodes to fetch their states in a single call.
+   */
+  4: optional set<common.NodeIndex> node_indexes,
 }
 
 struct NodesConfigResponse {
@@ -490,6 +496,11 @@ struct NodesStateResponse {
    */
   1: NodesState states,
   2: common.unsigned64 version,
+  /**
+   * Set when the request carried a page_size and more matching nodes remain.
+   * Pass it back in NodesStateRequest.page_token to fetch the next page.
+   */
+  3: optional string next_page_token,
 }
 
 struct NodesStateRequest {
@@ -499,4 +510,22 @@ struct NodesStateRequest {
    * is not fully ready. We don't throw NodeNotReady exception in this case.
    */
   2: optional bool force (deprecated),
+  /**
+   * The version of a previous NodesStateResponse. If set and the state
+   * version on the server is still the same, the response carries no states,
+   * only the (unchanged) version. Pollers can use this to avoid transferring
+   * and materializing unchanged state on every round.
+   */
+  3: optional common.unsigned64 known_version,
+  /**
+   * Maximum number of node states to return in one response. If more nodes
+   * match the filter, next_page_token is set in the response. 0 or unset
+   * means no limit.
+   */
+  4: optional common.unsigned64 page_size,
+  /**
+   * Continuation token from the next_page_token of a previous response.
+   * Resumes the listing right after the last node of that response.
+   */
+  5: optional string page_token,
 }
@@ -288,8 +288,15 @@ void MaintenanceManager::cancelMetadataNodesetMonitorTimer() {
 
 void MaintenanceManager::activateReevaluationTimer() {
   if (!reevaluation_timer_) {
-    reevaluation_timer_ =
-        std::make_unique<Timer>([this]() { add([this]() { scheduleRun(); }); });
+    reevaluation_timer_ = std::make_unique<Timer>([this]() {
+      add([this]() {
+        // Periodic reevaluations re-run every workflow so that transient
+        // failures (e.g. a failed event log write) are retried even if no
+        // inputs changed.
+        full_run_requested_ = true;
+        scheduleRun();
+      });
+    });
   }
   if (!reevaluation_timer_->isActive()) {
     reevaluation_timer_->activate(
@@ -304,6 +311,32 @@ void MaintenanceManager::cancelReevaluationTimer() {
   }
 }
 
+void MaintenanceManager::activateCoalescingTimer(
+    std::chrono::milliseconds delay) {
+  if (!coalescing_timer_) {
+    coalescing_timer_ = std::make_unique<Timer>([this]() {
+      add([this]() {
+        // The manager may have been stopped or kicked off a run through
+        // another path while this callback was queued.
+        if (status_ == MMStatus::AWAITING_STATE_CHANGE && run_evaluate_) {
+          evaluate();
+        }
+      });
+    });
+  }
+  // Re-activating an active timer extends the coalescing window;
+  // `scheduleRun` bounds the total delay with
+  // maintenance-manager-coalescing-max-delay.
+  coalescing_timer_->activate(delay);
+  ld_debug("Coalescing timer activated");
+}
+
+void MaintenanceManager::cancelCoalescingTimer() {
+  if (coalescing_timer_) {
+    coalescing_timer_->cancel();
+  }
+}
+
 folly::SemiFuture<folly::Unit> MaintenanceManager::stop() {
   auto pf = folly::makePromiseContract<folly::Unit>();
   add([this, mpromise = std::move(pf.first)]() mutable {
@@ -316,6 +349,7 @@ folly::SemiFuture<folly::Unit> MaintenanceManager::stop() {
 void MaintenanceManager::stopInternal() {
   deps_->stopSubscription();
   cancelReevaluationTimer();
+  cancelCoalescingTimer();
   cancelMetadataNodesetMonitorTimer();
   if (status_ == MMStatus::STARTING ||
       status_ == MMStatus::AWAITING_STATE_CHANGE) {
@@ -335,7 +369,9 @@ void MaintenanceManager::scheduleRun() {
   // 1/ This is the first run and we have an initial ClusterMaintenanceState
   // and EventLogRebuildingSet
   // 2/ MM is actually waiting for a state change
-  // (i.e status_ == AWAITING_STATE_CHANGE)
+  // (i.e status_ == AWAITING_STATE_CHANGE). In this case the run can be
+  // held back by maintenance-manager-coalescing-delay so that a burst of
+  // state changes results in a single run.
   run_evaluate_ = true;
   if (status_ == MMStatus::STARTING && last_cms_version_ != LSN_INVALID &&
       last_ers_version_ != LSN_INVALID) {
@@ -347,7 +383,23 @@ void MaintenanceManager::scheduleRun() {
     activateMetadataNodesetMonitorTimer();
     evaluate();
   } else if (status_ == MMStatus::AWAITING_STATE_CHANGE) {
-    evaluate();
+    auto delay = deps_->settings()->maintenance_manager_coalescing_delay;
+    if (delay.count() <= 0) {
+      evaluate();
+      return;
+    }
+    // Coalesce bursts of state changes: (re)arm a short timer and only
+    // evaluate once it fires, unless the oldest pending state change has
+    // already been held back for too long.
+    auto now = SteadyTimestamp::now();
+    if (!oldest_pending_run_.has_value()) {
+      oldest_pending_run_ = now;
+    } else if (now - oldest_pending_run_.value() >=
+               deps_->settings()->maintenance_manager_coalescing_max_delay) {
+      evaluate();
+      return;
+    }
+    activateCoalescingTimer(delay);
   }
 }
 
@@ -363,14 +415,26 @@ MaintenanceManager::getNodeState(node_index_t node) {
 }
 
 folly::SemiFuture<folly::Expected<NodesStateResponse, MaintenanceError>>
-MaintenanceManager::getNodesState(thrift::NodesFilter filter) {
+MaintenanceManager::getNodesState(thrift::NodesStateRequest request) {
   return folly::via(this).thenValue(
-      [this, filter = std::move(filter)](
+      [this, request = std::move(request)](
           auto &&) -> folly::Expected<NodesStateResponse, MaintenanceError> {
         if (shouldStopProcessing()) {
           return folly::makeUnexpected(MaintenanceError(E::SHUTDOWN));
         }
         NodesStateResponse response;
+        auto version =
+            static_cast<int64_t>(nodes_config_->getVersion().val());
+
+        // Delta polling: the caller already has this version, don't bother
+        // materializing the states again.
+        if (request.known_version_ref().has_value() &&
+            request.known_version_ref().value() == version) {
+          response.set_version(version);
+          return response;
+        }
+
+        auto filter = request.filter_ref().value_or(thrift::NodesFilter());
         std::vector<node_index_t> node_ids;
         std::vector<NodeState> states;
 
@@ -378,6 +442,11 @@ MaintenanceManager::getNodesState(thrift::NodesFilter filter) {
           node_ids.push_back(index);
         });
 
+        auto next_page_token = applyNodesStatePagination(request, node_ids);
+        if (next_page_token.has_value()) {
+          response.set_next_page_token(std::move(next_page_token).value());
+        }
+
         const ClusterState* cluster_state =
             deps_->getProcessor()->cluster_state_.get();
         for (const auto& node_id : node_ids) {
@@ -389,8 +458,7 @@ MaintenanceManager::getNodesState(thrift::NodesFilter filter) {
           states.push_back(std::move(expected_state).value());
         }
         response.set_states(std::move(states));
-        response.set_version(
-            static_cast<int64_t>(nodes_config_->getVersion().val()));
+        response.set_version(version);
         return response;
       });
 }
@@ -982,6 +1050,12 @@ void MaintenanceManager::evaluate() {
   STAT_INCR(deps_->getStats(), admin_server.mm_evaluations);
   run_evaluate_ = false;
   cancelReevaluationTimer();
+  cancelCoalescingTimer();
+  oldest_pending_run_.reset();
+  skip_unchanged_workflows_ =
+      deps_->settings()->maintenance_manager_skip_unchanged_workflows &&
+      !full_run_requested_;
+  full_run_requested_ = false;
 
   // This is required because it is possible that we are running evaluate
   // again before the NodesConfig update from previous iteration makes it
@@ -1761,16 +1835,42 @@ MaintenanceManager::runShardWorkflows() {
     // The shard should be in NodesConfig since workflow is created
     // only for shards in the config
     ld_check(shard_state.has_value());
+    auto data_health = getShardDataHealthInternal(shard_id);
+    auto rebuilding_mode = getCurrentRebuildingMode(shard_id);
+    bool is_draining = isShardDraining(shard_id);
+    bool is_non_authoritative = isRebuildingNonAuthoritative(shard_id);
+    bool use_force_restore_flag =
+        deps_->settings()->use_force_restore_rebuilding_flag;
     shards.push_back(shard_id);
-    futures.push_back(
-        wf->run(shard_state.value(),
-                exclude_from_nodeset,
-                getShardDataHealthInternal(shard_id),
-                getCurrentRebuildingMode(shard_id),
-                isShardDraining(shard_id),
-                isRebuildingNonAuthoritative(shard_id),
-                gossip_state,
-                deps_->settings()->use_force_restore_rebuilding_flag));
+    if (skip_unchanged_workflows_ &&
+        it.second.second != MaintenanceStatus::RETRY &&
+        it.second.second != MaintenanceStatus::BLOCKED_UNTIL_SAFE &&
+        wf->sameInputs(shard_state.value(),
+                       exclude_from_nodeset,
+                       data_health,
+                       rebuilding_mode,
+                       is_draining,
+                       is_non_authoritative,
+                       gossip_state,
+                       use_force_restore_flag)) {
+      // Nothing this workflow looks at has changed since its last run, so
+      // re-running it would recompute the same status (and possibly
+      // re-write the same event log record). Reuse the previous status
+      // instead. RETRY is excluded because it means the last event log
+      // write failed and must be re-attempted; BLOCKED_UNTIL_SAFE is
+      // excluded so that the maintenance gets another safety check run.
+      STAT_INCR(deps_->getStats(), admin_server.mm_workflow_runs_skipped);
+      futures.push_back(folly::makeSemiFuture(it.second.second));
+      continue;
+    }
+    futures.push_back(wf->run(shard_state.value(),
+                              exclude_from_nodeset,
+                              data_health,
+                              rebuilding_mode,
+                              is_draining,
+                              is_non_authoritative,
+                              gossip_state,
+                              use_force_restore_flag));
   }
   return std::make_pair(std::move(shards), std::move(futures));
 }
@@ -1921,6 +2021,17 @@ MaintenanceManager::runSequencerWorkflows() {
           "We don't have ClusterState, assumed that node %i is FULLY_STARTED",
           node);
     }
+    if (skip_unchanged_workflows_ &&
+        it.second.second != MaintenanceStatus::RETRY &&
+        it.second.second != MaintenanceStatus::BLOCKED_UNTIL_SAFE &&
+        wf->sameInputs(node_state.value(), gossip_state)) {
+      // Inputs did not change since the last run; reuse the previous
+      // status instead of re-running the workflow. See runShardWorkflows
+      // for why RETRY and BLOCKED_UNTIL_SAFE are excluded.
+      STAT_INCR(deps_->getStats(), admin_server.mm_workflow_runs_skipped);
+      futures.push_back(folly::makeSemiFuture(it.second.second));
+      continue;
+    }
     futures.push_back(wf->run(node_state.value(), gossip_state));
   }
   return std::make_pair(std::move(nodes), std::move(futures));
@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include <folly/Optional.h>
 #include <folly/container/F14Map.h>
 #include <folly/container/F14Set.h>
 #include <folly/futures/Future.h>
@@ -255,12 +256,13 @@ class MaintenanceManager : public SerialWorkContext {
   getNodeState(node_index_t node);
 
   /*
-   * Takes a filter, it will match the nodes, combine the results
+   * Takes a request with a filter, it will match the nodes, apply the
+   * pagination and version arguments of the request, combine the results
    * and get the state from the maintenance manager.
    */
   folly::SemiFuture<
       folly::Expected<thrift::NodesStateResponse, MaintenanceError>>
-  getNodesState(thrift::NodesFilter filter);
+  getNodesState(thrift::NodesStateRequest request);
 
   // Getter that returns a SemiFuture with ShardState for a given shard
   folly::SemiFuture<folly::Expected<ShardState, Status>>
@@ -396,6 +398,20 @@ class MaintenanceManager : public SerialWorkContext {
   // callback indicating the need to call `evaluate()`
   bool run_evaluate_{false};
 
+  // Set to true when the periodic reevaluation timer fires to force the
+  // next evaluation to re-run every workflow even if its inputs did not
+  // change. Starts out true so that the first evaluation is a full run
+  bool full_run_requested_{true};
+
+  // True if the evaluation currently in progress is allowed to reuse the
+  // previous status of workflows whose inputs did not change. Computed at
+  // the top of `evaluate()` from `full_run_requested_` and the settings
+  bool skip_unchanged_workflows_{false};
+
+  // Time at which the oldest state change still held back by the
+  // coalescing timer was received. Unset when no run is pending
+  folly::Optional<SteadyTimestamp> oldest_pending_run_;
+
   // State delivered by the ClusterMaintenanceStateMachine
   std::unique_ptr<ClusterMaintenanceState> cluster_maintenance_state_;
 
@@ -693,10 +709,20 @@ class MaintenanceManager : public SerialWorkContext {
   // polluting the MM API by passing the sample around.
   MaintenanceManagerTracer::PeriodicStateSample state_tracer_sample_;
 
+  // A timer that debounces `evaluate()` while waiting for state changes:
+  // subscription callbacks arriving within
+  // maintenance-manager-coalescing-delay of each other are coalesced into
+  // a single run
+  std::unique_ptr<Timer> coalescing_timer_;
+
   virtual void activateReevaluationTimer();
 
   virtual void cancelReevaluationTimer();
 
+  void activateCoalescingTimer(std::chrono::milliseconds delay);
+
+  void cancelCoalescingTimer();
+
   // Returns true if status_ is STOPPING
   bool shouldStopProcessing();
 
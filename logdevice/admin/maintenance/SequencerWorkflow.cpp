@@ -13,9 +13,12 @@ namespace facebook { namespace logdevice { namespace maintenance {
 folly::SemiFuture<MaintenanceStatus>
 SequencerWorkflow::run(const membership::SequencerNodeState& node_state,
                        ClusterStateNodeState node_gossip_state) {
+  has_run_ = true;
   current_sequencing_state_ = node_state.sequencer_enabled
       ? SequencingState::ENABLED
       : SequencingState::DISABLED;
+  current_manual_override_ = node_state.manual_override;
+  current_gossip_state_ = node_gossip_state;
 
   auto promise_future = folly::makePromiseContract<MaintenanceStatus>();
 
@@ -49,6 +52,19 @@ SequencerWorkflow::run(const membership::SequencerNodeState& node_state,
   return std::move(promise_future.second);
 }
 
+bool SequencerWorkflow::sameInputs(
+    const membership::SequencerNodeState& node_state,
+    ClusterStateNodeState node_gossip_state) const {
+  // `run` only consumes the sequencer_enabled and manual_override flags
+  // from the SequencerNodeState, so only those fields are compared.
+  auto sequencing_state = node_state.sequencer_enabled
+      ? SequencingState::ENABLED
+      : SequencingState::DISABLED;
+  return has_run_ && sequencing_state == current_sequencing_state_ &&
+      node_state.manual_override == current_manual_override_ &&
+      node_gossip_state == current_gossip_state_;
+}
+
 void SequencerWorkflow::setTargetOpState(SequencingState state) {
   target_op_state_ = state;
 }
@@ -41,6 +41,13 @@ class SequencerWorkflow {
   run(const membership::SequencerNodeState& node_state,
       ClusterStateNodeState node_gossip_state);
 
+  // Returns true if `run` has been called at least once and none of the
+  // given parameters differ from what the last call observed. Used by
+  // MaintenanceManager to skip re-running workflows whose inputs did
+  // not change.
+  bool sameInputs(const membership::SequencerNodeState& node_state,
+                  ClusterStateNodeState node_gossip_state) const;
+
   // Sets the target_op_state_ to given value
   // Can only be SequencingState::ENABLED or SequencingState::DISABLED
   void setTargetOpState(SequencingState state);
@@ -67,9 +74,18 @@ class SequencerWorkflow {
   SequencingState target_op_state_{SequencingState::UNKNOWN};
   // The shard this workflow is for
   node_index_t node_;
+  // True once `run` has been called at least once. Until then
+  // `sameInputs` always returns false
+  bool has_run_{false};
   // True if Sequencing is enabled in NodesConfig.
   // Updated every time run is called
   SequencingState current_sequencing_state_;
+  // The last manual override flag seen in the SequencerNodeState.
+  // Updated every time run is called
+  bool current_manual_override_{false};
+  // The last known gossip state for the node.
+  // Updated every time run is called
+  ClusterStateNodeState current_gossip_state_{ClusterStateNodeState::DEAD};
   // If true, skip safety check for this workflow
   bool skip_safety_check_{false};
   // Last time the status_ was updated
@@ -50,7 +50,9 @@ ShardWorkflow::run(const membership::ShardState& shard_state,
           .str()
           .c_str());
 
+  has_run_ = true;
   current_storage_state_ = shard_state.storage_state;
+  current_manual_override_ = shard_state.manual_override;
   is_excluded_from_nodeset_ = excluded_from_nodeset;
   current_data_health_ = data_health;
   gossip_state_ = node_gossip_state;
@@ -117,6 +119,27 @@ ShardWorkflow::run(const membership::ShardState& shard_state,
   }
 }
 
+bool ShardWorkflow::sameInputs(const membership::ShardState& shard_state,
+                               bool excluded_from_nodeset,
+                               ShardDataHealth data_health,
+                               RebuildingMode rebuilding_mode,
+                               bool is_draining,
+                               bool is_non_authoritative,
+                               ClusterStateNodeState node_gossip_state,
+                               bool use_force_restore_flag) const {
+  // `run` only consumes the storage state and the manual override flag
+  // from the membership ShardState, so only those fields are compared.
+  return has_run_ && shard_state.storage_state == current_storage_state_ &&
+      shard_state.manual_override == current_manual_override_ &&
+      excluded_from_nodeset == is_excluded_from_nodeset_ &&
+      data_health == current_data_health_ &&
+      rebuilding_mode == current_rebuilding_mode_ &&
+      is_draining == current_is_draining_ &&
+      is_non_authoritative == current_rebuilding_is_non_authoritative_ &&
+      node_gossip_state == gossip_state_ &&
+      use_force_restore_flag == use_force_restore_flag_;
+}
+
 void ShardWorkflow::writeToEventLog(
     std::unique_ptr<EventLogRecord> event,
     std::function<void(Status st, lsn_t lsn, const std::string& str)> cb)
@@ -79,6 +79,22 @@ class ShardWorkflow {
       ClusterStateNodeState node_gossip_state,
       bool use_force_restore_flag);
 
+  /**
+   * Returns true if `run` has been called at least once and none of the
+   * given parameters differ from what the last call observed. Since `run`
+   * is a pure function of these inputs (plus targets that re-create the
+   * workflow when they change), MaintenanceManager uses this to skip
+   * re-running workflows whose inputs did not change.
+   */
+  bool sameInputs(const membership::ShardState& shard_state,
+                  bool excluded_from_nodeset,
+                  ShardDataHealth data_health,
+                  RebuildingMode rebuilding_mode,
+                  bool is_draining,
+                  bool is_non_authoritative,
+                  ClusterStateNodeState node_gossip_state,
+                  bool use_force_restore_flag) const;
+
   // Returns the ShardID for this workflow
   ShardID getShardID() const;
 
@@ -162,9 +178,15 @@ class ShardWorkflow {
   // Latest MaintenanceStatus. Updated every time `run`
   // is called
   MaintenanceStatus status_;
+  // True once `run` has been called at least once. Until then
+  // `sameInputs` always returns false
+  bool has_run_{false};
   // The last StorageState as informed by MM for this shard
   // Gets updated every time `run` is called
   membership::StorageState current_storage_state_;
+  // The last manual override flag seen in the membership ShardState.
+  // Gets updated every time `run` is called
+  bool current_manual_override_{false};
   // Whether we are currently being excluded from nodesets or not.
   bool is_excluded_from_nodeset_{false};
   // The last ShardDataHealth as informed by the MM for this
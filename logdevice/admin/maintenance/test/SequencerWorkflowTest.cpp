@@ -91,3 +91,29 @@ TEST(SequencerWorkflowTest, DisableSequencerSkipSafety) {
   future = wf->run(node_state, ClusterStateNodeState::FULLY_STARTED);
   ASSERT_EQ(std::move(future).get(), MaintenanceStatus::COMPLETED);
 }
+
+TEST(SequencerWorkflowTest, SameInputs) {
+  auto wf = std::make_unique<SequencerWorkflow>(node_index_t(1));
+  wf->setTargetOpState(SequencingState::DISABLED);
+  membership::SequencerNodeState node_state;
+  node_state.sequencer_enabled = true;
+  // Before the first run sameInputs should always be false.
+  ASSERT_FALSE(
+      wf->sameInputs(node_state, ClusterStateNodeState::FULLY_STARTED));
+
+  auto future = wf->run(node_state, ClusterStateNodeState::FULLY_STARTED);
+  ASSERT_EQ(
+      std::move(future).get(), MaintenanceStatus::AWAITING_SAFETY_CHECK);
+  ASSERT_TRUE(
+      wf->sameInputs(node_state, ClusterStateNodeState::FULLY_STARTED));
+
+  // Any change in the inputs should be detected.
+  ASSERT_FALSE(wf->sameInputs(node_state, ClusterStateNodeState::DEAD));
+  node_state.sequencer_enabled = false;
+  ASSERT_FALSE(
+      wf->sameInputs(node_state, ClusterStateNodeState::FULLY_STARTED));
+  node_state.sequencer_enabled = true;
+  node_state.manual_override = true;
+  ASSERT_FALSE(
+      wf->sameInputs(node_state, ClusterStateNodeState::FULLY_STARTED));
+}
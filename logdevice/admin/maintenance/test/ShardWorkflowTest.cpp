@@ -895,4 +895,72 @@ TEST_F(ShardWorkflowTest, UndrainShardAfterEmpty) {
   //... rest of workflow is same as test above
 }
 
+TEST_F(ShardWorkflowTest, SameInputs) {
+  init();
+  wf->addTargetOpState({ShardOperationalState::DRAINED});
+  wf->shouldSkipSafetyCheck(false);
+  membership::ShardState shard_state;
+  shard_state.storage_state = membership::StorageState::READ_WRITE;
+
+  // Before the first run sameInputs should always be false.
+  ASSERT_FALSE(wf->sameInputs(shard_state,
+                              /* excluded_from_nodeset = */ false,
+                              ShardDataHealth::HEALTHY,
+                              RebuildingMode::INVALID,
+                              false /*is_draining*/,
+                              false /*is_non_authoritative*/,
+                              ClusterStateNodeState::FULLY_STARTED,
+                              true));
+
+  auto result = wf->run(shard_state,
+                        /* excluded_from_nodeset = */ false,
+                        ShardDataHealth::HEALTHY,
+                        RebuildingMode::INVALID,
+                        false /*is_draining*/,
+                        false /*is_non_authoritative*/,
+                        ClusterStateNodeState::FULLY_STARTED,
+                        true);
+  ASSERT_EQ(std::move(result).get(), MaintenanceStatus::AWAITING_SAFETY_CHECK);
+
+  // Identical inputs after a run should match.
+  ASSERT_TRUE(wf->sameInputs(shard_state,
+                             /* excluded_from_nodeset = */ false,
+                             ShardDataHealth::HEALTHY,
+                             RebuildingMode::INVALID,
+                             false /*is_draining*/,
+                             false /*is_non_authoritative*/,
+                             ClusterStateNodeState::FULLY_STARTED,
+                             true));
+
+  // Any change in the inputs should be detected.
+  shard_state.storage_state = membership::StorageState::READ_ONLY;
+  ASSERT_FALSE(wf->sameInputs(shard_state,
+                              /* excluded_from_nodeset = */ false,
+                              ShardDataHealth::HEALTHY,
+                              RebuildingMode::INVALID,
+                              false /*is_draining*/,
+                              false /*is_non_authoritative*/,
+                              ClusterStateNodeState::FULLY_STARTED,
+                              true));
+  shard_state.storage_state = membership::StorageState::READ_WRITE;
+  shard_state.manual_override = true;
+  ASSERT_FALSE(wf->sameInputs(shard_state,
+                              /* excluded_from_nodeset = */ false,
+                              ShardDataHealth::HEALTHY,
+                              RebuildingMode::INVALID,
+                              false /*is_draining*/,
+                              false /*is_non_authoritative*/,
+                              ClusterStateNodeState::FULLY_STARTED,
+                              true));
+  shard_state.manual_override = false;
+  ASSERT_FALSE(wf->sameInputs(shard_state,
+                              /* excluded_from_nodeset = */ false,
+                              ShardDataHealth::HEALTHY,
+                              RebuildingMode::INVALID,
+                              false /*is_draining*/,
+                              false /*is_non_authoritative*/,
+                              ClusterStateNodeState::DEAD,
+                              true));
+}
+
 }}} // namespace facebook::logdevice::maintenance
@@ -264,6 +264,12 @@ SafetyChecker::performSafetyCheck(
         const auto nodes_config = processor_->getNodesConfiguration();
         ClusterState* cluster_state = processor_->cluster_state_.get();
 
+        // Many logs share the same historical nodesets, and all other inputs
+        // of the per-epoch availability check are fixed for this run, so the
+        // batches below memoize results in a shared per-run cache instead of
+        // re-evaluating every epoch from scratch.
+        auto impact_cache = std::make_shared<safety::NodeSetImpactCache>();
+
         // Check impact on capacity
         Impact capacity_impact;
         if (check_capacity) {
@@ -346,7 +352,8 @@ SafetyChecker::performSafetyCheck(
                                                   abort_on_error_,
                                                   error_sample_size_,
                                                   nodes_config,
-                                                  cluster_state);
+                                                  cluster_state,
+                                                  impact_cache.get());
           if (impact.hasError()) {
             // The operation failed. Possibly because we don't have metadata for
             // this log-id. This is critical.
@@ -415,7 +422,8 @@ SafetyChecker::performSafetyCheck(
                                          safety_margin,
                                          this,
                                          cfg,
-                                         cluster_state](auto&&) {
+                                         cluster_state,
+                                         impact_cache](auto&&) {
                                return safety::checkImpactOnLogs(
                                    mbatch,
                                    metadata,
@@ -428,7 +436,8 @@ SafetyChecker::performSafetyCheck(
                                    abort_on_error_,
                                    error_sample_size_,
                                    processor_->getNodesConfiguration(),
-                                   cluster_state);
+                                   cluster_state,
+                                   impact_cache.get());
                              }));
           --chunks;
         }
@@ -448,10 +457,21 @@ SafetyChecker::performSafetyCheck(
                      return mergeImpact(
                          std::move(acc), result, error_sample_size_);
                    })
-            .thenValue([start_time](folly::Expected<Impact, Status> result) {
+            .thenValue([start_time, impact_cache, this](
+                           folly::Expected<Impact, Status> result) {
               std::chrono::seconds total_time =
                   std::chrono::duration_cast<std::chrono::seconds>(
                       std::chrono::steady_clock::now() - start_time);
+              ld_info("Safety check nodeset impact cache: %zu hits, %zu "
+                      "misses",
+                      impact_cache->hits(),
+                      impact_cache->misses());
+              STAT_ADD(processor_->stats_,
+                       admin_server.safety_checker_impact_cache_hits,
+                       impact_cache->hits());
+              STAT_ADD(processor_->stats_,
+                       admin_server.safety_checker_impact_cache_misses,
+                       impact_cache->misses());
               if (result.hasValue()) {
                 size_t logs_affected_cnt = 0;
                 if (result->logs_affected_ref().has_value()) {
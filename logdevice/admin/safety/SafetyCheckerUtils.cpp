@@ -16,6 +16,50 @@ using namespace facebook::logdevice::configuration;
 
 namespace facebook { namespace logdevice { namespace safety {
 
+std::string
+NodeSetImpactCache::makeKey(const StorageSet& storage_set,
+                            const ReplicationProperty& replication,
+                            configuration::StorageState target_storage_state,
+                            bool require_fully_started) {
+  std::string key = replication.toString();
+  key += '|';
+  key += std::to_string(static_cast<int>(target_storage_state));
+  key += require_fully_started ? "|1" : "|0";
+  for (const ShardID& shard : storage_set) {
+    key += '|';
+    key += shard.toString();
+  }
+  return key;
+}
+
+folly::Optional<std::pair<bool, bool>>
+NodeSetImpactCache::get(const StorageSet& storage_set,
+                        const ReplicationProperty& replication,
+                        configuration::StorageState target_storage_state,
+                        bool require_fully_started) const {
+  const std::string key = makeKey(
+      storage_set, replication, target_storage_state, require_fully_started);
+  auto cache = cache_.rlock();
+  auto it = cache->find(key);
+  if (it == cache->end()) {
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return folly::none;
+  }
+  hits_.fetch_add(1, std::memory_order_relaxed);
+  return it->second;
+}
+
+void NodeSetImpactCache::put(const StorageSet& storage_set,
+                             const ReplicationProperty& replication,
+                             configuration::StorageState target_storage_state,
+                             bool require_fully_started,
+                             std::pair<bool, bool> result) {
+  cache_.wlock()->emplace(
+      makeKey(
+          storage_set, replication, target_storage_state, require_fully_started),
+      result);
+}
+
 folly::Expected<Impact, Status> checkImpactOnLogs(
     const std::vector<logid_t>& log_ids,
     const std::shared_ptr<LogMetaDataFetcher::Results>& metadata,
@@ -29,7 +73,8 @@ folly::Expected<Impact, Status> checkImpactOnLogs(
     size_t error_sample_size,
     const std::shared_ptr<const configuration::nodes::NodesConfiguration>&
         nodes_config,
-    ClusterState* cluster_state) {
+    ClusterState* cluster_state,
+    NodeSetImpactCache* impact_cache) {
   std::set<thrift::OperationImpact> impact_result_all;
   std::vector<thrift::ImpactOnEpoch> affected_logs_sample;
   size_t logs_done = 0;
@@ -47,7 +92,8 @@ folly::Expected<Impact, Status> checkImpactOnLogs(
                                    target_storage_state,
                                    safety_margin,
                                    nodes_config,
-                                   cluster_state);
+                                   cluster_state,
+                                   impact_cache);
     logs_done++;
     if (result.hasError()) {
       // The operation failed. Possibly because we don't have metadata for
@@ -93,7 +139,8 @@ folly::Expected<thrift::ImpactOnEpoch, Status> checkImpactOnLog(
     const SafetyMargin& safety_margin,
     const std::shared_ptr<const configuration::nodes::NodesConfiguration>&
         nodes_config,
-    ClusterState* cluster_state) {
+    ClusterState* cluster_state,
+    NodeSetImpactCache* impact_cache) {
   ld_assert(metadata_cache);
   if (metadata_cache->find(log_id) == metadata_cache->end()) {
     // We cannot find the epoch metadata for this log. This can have multiple
@@ -149,7 +196,8 @@ folly::Expected<thrift::ImpactOnEpoch, Status> checkImpactOnLog(
                                   safety_margin,
                                   nodes_config,
                                   cluster_state,
-                                  require_fully_started);
+                                  require_fully_started,
+                                  impact_cache);
 
     if (safe_writes && safe_reads) {
       continue;
@@ -256,7 +304,8 @@ Impact checkMetadataStorageSet(
                                   safety_margin,
                                   nodes_config,
                                   cluster_state,
-                                  /* require_fully_started = */ false);
+                                  /* require_fully_started = */ false,
+                                  /* impact_cache = */ nullptr);
 
     if (!safe_writes) {
       impact_result.insert(thrift::OperationImpact::WRITE_AVAILABILITY_LOSS);
@@ -300,7 +349,18 @@ std::pair<bool, bool> checkReadWriteAvailablity(
     const SafetyMargin& safety_margin,
     const std::shared_ptr<const nodes::NodesConfiguration>& nodes_config,
     ClusterState* cluster_state,
-    bool require_fully_started_nodes) {
+    bool require_fully_started_nodes,
+    NodeSetImpactCache* impact_cache) {
+  if (impact_cache != nullptr) {
+    auto cached = impact_cache->get(storage_set,
+                                    replication_property,
+                                    target_storage_state,
+                                    require_fully_started_nodes);
+    if (cached.hasValue()) {
+      return cached.value();
+    }
+  }
+
   bool safe_writes;
   bool safe_reads = true;
 
@@ -454,6 +514,14 @@ std::pair<bool, bool> checkReadWriteAvailablity(
     }
   }
 
+  if (impact_cache != nullptr) {
+    impact_cache->put(storage_set,
+                      replication_property,
+                      target_storage_state,
+                      require_fully_started_nodes,
+                      std::make_pair(safe_reads, safe_writes));
+  }
+
   return std::make_pair(safe_reads, safe_writes);
 }
 
@@ -7,6 +7,9 @@
  */
 #pragma once
 
+#include <folly/Optional.h>
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
 #include <folly/container/F14Set.h>
 
 #include "logdevice/admin/if/gen-cpp2/safety_types.h"
@@ -20,6 +23,50 @@
 
 namespace facebook { namespace logdevice { namespace safety {
 
+/**
+ * Memoizes the (safe_for_reads, safe_for_writes) result of
+ * checkReadWriteAvailablity() for the duration of a single safety check run.
+ * Many logs (and epochs) share the same storage set and replication
+ * property, and all other inputs of the check (authoritative statuses,
+ * gossip state, the shards targeted by the operation) are fixed for the
+ * run, so the result only depends on the key below. Thread-safe: one
+ * instance is shared across the log batches that
+ * SafetyChecker::performSafetyCheck() fans out to the CPU executor. Must
+ * not outlive the run it was created for.
+ */
+class NodeSetImpactCache {
+ public:
+  folly::Optional<std::pair<bool, bool>>
+  get(const StorageSet& storage_set,
+      const ReplicationProperty& replication,
+      configuration::StorageState target_storage_state,
+      bool require_fully_started) const;
+
+  void put(const StorageSet& storage_set,
+           const ReplicationProperty& replication,
+           configuration::StorageState target_storage_state,
+           bool require_fully_started,
+           std::pair<bool, bool> result);
+
+  size_t hits() const {
+    return hits_.load(std::memory_order_relaxed);
+  }
+  size_t misses() const {
+    return misses_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  static std::string makeKey(const StorageSet& storage_set,
+                             const ReplicationProperty& replication,
+                             configuration::StorageState target_storage_state,
+                             bool require_fully_started);
+
+  mutable std::atomic<size_t> hits_{0};
+  mutable std::atomic<size_t> misses_{0};
+  folly::Synchronized<folly::F14FastMap<std::string, std::pair<bool, bool>>>
+      cache_;
+};
+
 /**
  * Performs safety check on given logs
  */
@@ -36,7 +83,8 @@ folly::Expected<Impact, Status> checkImpactOnLogs(
     size_t error_sample_size,
     const std::shared_ptr<const configuration::nodes::NodesConfiguration>&
         nodes_config,
-    ClusterState* cluster_state);
+    ClusterState* cluster_state,
+    NodeSetImpactCache* impact_cache);
 /**
  * Perform safety check on a single log.
  */
@@ -50,7 +98,8 @@ folly::Expected<thrift::ImpactOnEpoch, Status> checkImpactOnLog(
     const SafetyMargin& safety_margin,
     const std::shared_ptr<const configuration::nodes::NodesConfiguration>&
         nodes_config,
-    ClusterState* cluster_state);
+    ClusterState* cluster_state,
+    NodeSetImpactCache* impact_cache);
 
 /**
  * Checks whether a node is alive in the FailureDetector (gossip) or not.
@@ -74,7 +123,9 @@ Impact checkMetadataStorageSet(
     size_t error_sample_size);
 
 /**
- * Returns (safe_for_reads, safe_for_write) pair.
+ * Returns (safe_for_reads, safe_for_write) pair. If `impact_cache' is not
+ * nullptr, results are memoized in it per (storage set, replication,
+ * target state, fully-started requirement).
  */
 std::pair<bool, bool> checkReadWriteAvailablity(
     const ShardAuthoritativeStatusMap& shard_status,
@@ -86,7 +137,8 @@ std::pair<bool, bool> checkReadWriteAvailablity(
     const std::shared_ptr<const configuration::nodes::NodesConfiguration>&
         nodes_config,
     ClusterState* cluster_state,
-    bool require_fully_started_nodes);
+    bool require_fully_started_nodes,
+    NodeSetImpactCache* impact_cache);
 
 /**
  * Makes sure there will be enough sequencing capacity that's alive and
@@ -212,6 +212,52 @@ void AdminServerSettings::defineSettings(SettingEasyInit& init) {
      SERVER,
      SettingsCategory::AdminAPI)
 
+    ("maintenance-manager-coalescing-delay",
+     &maintenance_manager_coalescing_delay,
+     "0s",
+     [](std::chrono::milliseconds val) -> void {
+       if (val.count() < 0) {
+         throw boost::program_options::error(
+           "maintenance-manager-coalescing-delay must be non-negative"
+         );
+       }
+     },
+     "How long MaintenanceManager waits after a state change notification "
+     "before running an evaluation. Bursts of ClusterMaintenanceState, event "
+     "log and NodesConfiguration updates arriving within this window are "
+     "coalesced into a single run, which helps the manager keep up during "
+     "mass events like rolling restarts. 0 (default) evaluates immediately "
+     "on every state change",
+     SERVER,
+     SettingsCategory::AdminAPI)
+
+    ("maintenance-manager-coalescing-max-delay",
+     &maintenance_manager_coalescing_max_delay,
+     "10s",
+     [](std::chrono::milliseconds val) -> void {
+       if (val.count() <= 0) {
+         throw boost::program_options::error(
+           "maintenance-manager-coalescing-max-delay must be positive"
+         );
+       }
+     },
+     "Upper bound on how long MaintenanceManager keeps extending the "
+     "coalescing window while state changes keep arriving. An evaluation is "
+     "forced once the oldest pending state change is this old",
+     SERVER,
+     SettingsCategory::AdminAPI)
+
+    ("maintenance-manager-skip-unchanged-workflows",
+     &maintenance_manager_skip_unchanged_workflows,
+     "false",
+     nullptr,
+     "If true, MaintenanceManager does not re-run maintenance workflows whose "
+     "inputs did not change since their last run and reuses their previous "
+     "status instead. Evaluations triggered by the periodic reevaluation "
+     "timer always re-run every workflow",
+     SERVER,
+     SettingsCategory::AdminAPI)
+
     ("enable-safety-check-periodic-metadata-update",
      &enable_safety_check_periodic_metadata_update,
      "false",
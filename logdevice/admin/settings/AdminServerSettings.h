@@ -66,6 +66,19 @@ struct AdminServerSettings : public SettingsBundle {
   // How often to check if Metadata Nodeset needs to be updated
   std::chrono::milliseconds maintenance_manager_metadata_nodeset_update_period;
 
+  // How long to wait after a state change notification before running an
+  // evaluation in MaintenanceManager so that bursts of updates are coalesced
+  // into a single run. 0 disables coalescing.
+  std::chrono::milliseconds maintenance_manager_coalescing_delay;
+
+  // Upper bound on how long a state change can be held back by coalescing
+  // before an evaluation is forced.
+  std::chrono::milliseconds maintenance_manager_coalescing_max_delay;
+
+  // If true, MaintenanceManager does not re-run workflows whose inputs did
+  // not change since their last run and reuses their previous status.
+  bool maintenance_manager_skip_unchanged_workflows;
+
   /// ** Used ONLY for experimentation and testing
   bool block_maintenance_rsm;
 
@@ -252,4 +252,40 @@ TEST(AdminAPIUtilsTest, FillNodeConfigPopulatesAllFields) {
   EXPECT_EQ(expected, actual);
 }
 
+TEST(AdminAPIUtilsTest, NodesStatePagination) {
+  std::vector<node_index_t> node_ids{4, 1, 3, 0, 2};
+  thrift::NodesStateRequest request;
+
+  // No pagination arguments: the list is only sorted.
+  auto token = applyNodesStatePagination(request, node_ids);
+  EXPECT_FALSE(token.has_value());
+  EXPECT_EQ(std::vector<node_index_t>({0, 1, 2, 3, 4}), node_ids);
+
+  // First page of two.
+  request.set_page_size(2);
+  token = applyNodesStatePagination(request, node_ids);
+  ASSERT_TRUE(token.has_value());
+  EXPECT_EQ(std::vector<node_index_t>({0, 1}), node_ids);
+
+  // Second page resumes after the returned token.
+  node_ids = {4, 1, 3, 0, 2};
+  request.set_page_token(token.value());
+  token = applyNodesStatePagination(request, node_ids);
+  ASSERT_TRUE(token.has_value());
+  EXPECT_EQ(std::vector<node_index_t>({2, 3}), node_ids);
+
+  // Last (short) page carries no continuation token.
+  node_ids = {4, 1, 3, 0, 2};
+  request.set_page_token(token.value());
+  token = applyNodesStatePagination(request, node_ids);
+  EXPECT_FALSE(token.has_value());
+  EXPECT_EQ(std::vector<node_index_t>({4}), node_ids);
+
+  // A malformed token is rejected.
+  node_ids = {0, 1};
+  request.set_page_token("not-a-token");
+  EXPECT_THROW(
+      applyNodesStatePagination(request, node_ids), thrift::InvalidRequest);
+}
+
 } // namespace facebook::logdevice
@@ -144,7 +144,9 @@ typedef AdminCommandTable<uint32_t,                  /* Shard id */
                           uint64_t,    /* Read buffer bytes */
                           uint64_t,    /* Records in flight */
                           std::string, /* Read pointer */
-                          double       /* Progress */
+                          double,      /* Progress */
+                          std::chrono::milliseconds, /* ETA */
+                          std::chrono::milliseconds  /* ETA p95 */
                           >
     InfoRebuildingShardsTable;
 
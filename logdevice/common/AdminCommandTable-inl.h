@@ -227,6 +227,46 @@ void AdminCommandTable<Args...>::printJson(folly::io::Appender& output,
   output.printf("%s", "\r\n");
 }
 
+template <typename... Args>
+void AdminCommandTable<Args...>::printJsonHeader(folly::io::Appender& output,
+                                                 std::size_t max_col_) const {
+  unsigned int max_col = std::min(max_col_, numCols());
+
+  folly::dynamic headers =
+      folly::dynamic(names_.begin(), names_.begin() + max_col);
+  auto serialized =
+      folly::json::serialize(headers, folly::json::serialization_opts());
+  output.printf("{\"headers\":%s,\"rows\":[", serialized.c_str());
+}
+
+template <typename... Args>
+bool AdminCommandTable<Args...>::printJsonRows(folly::io::Appender& output,
+                                               bool first_row,
+                                               std::size_t max_col_) const {
+  unsigned int max_col = std::min(max_col_, numCols());
+
+  for (auto& r : rows_) {
+    folly::dynamic row = folly::dynamic::array;
+    for (int i = 0; i < max_col; ++i) {
+      if (r[i].hasValue()) {
+        row.push_back(r[i].value());
+      } else {
+        row.push_back(nullptr);
+      }
+    }
+    auto serialized =
+        folly::json::serialize(row, folly::json::serialization_opts());
+    output.printf("%s%s", first_row ? "" : ",", serialized.c_str());
+    first_row = false;
+  }
+  return first_row;
+}
+
+template <typename... Args>
+void AdminCommandTable<Args...>::printJsonFooter(folly::io::Appender& output) {
+  output.printf("%s", "]}\r\n");
+}
+
 template <typename... Args>
 std::string AdminCommandTable<Args...>::toString(bool json,
                                                  size_t max_col_) const {
@@ -157,6 +157,35 @@ class AdminCommandTable {
   void printJson(folly::io::Appender& output,
                  std::size_t max_col_ = numCols()) const;
 
+  /**
+   * Chunked json printing, for commands that stream a large logical table as
+   * a sequence of smaller tables without materializing all the rows at once.
+   * Print the header once, then the rows of each chunk as it becomes
+   * available, then the footer. The concatenated output is a single json
+   * document equivalent to what printJson() would produce for the merged
+   * table:
+   *
+   *   table.printJsonHeader(output);
+   *   bool first_row = true;
+   *   for (auto& chunk : chunks) {
+   *     first_row = chunk.printJsonRows(output, first_row);
+   *   }
+   *   MyTableType::printJsonFooter(output);
+   */
+  void printJsonHeader(folly::io::Appender& output,
+                       std::size_t max_col_ = numCols()) const;
+
+  /**
+   * @param first_row  true iff no rows have been printed yet; controls comma
+   *                   placement.
+   * @return value to pass as `first_row` to the next call.
+   */
+  bool printJsonRows(folly::io::Appender& output,
+                     bool first_row,
+                     std::size_t max_col_ = numCols()) const;
+
+  static void printJsonFooter(folly::io::Appender& output);
+
   std::string toString(bool json = false, size_t max_col_ = numCols()) const;
 
  private:
@@ -396,12 +396,12 @@ void AllSequencers::notifyWorkerActivationCompletion(logid_t logid, Status st) {
     if (c_st == E::OK) {
       ld_debug("Received requests of clearing buffer.");
       w->appenderBuffer().processQueue(
-          c_logid, AppenderBuffer::processBufferedAppender);
+          c_logid, AppenderBuffer::makeDrainCallback());
 
       if (!MetaDataLog::isMetaDataLog(c_logid)) {
         w->appenderBuffer().processQueue(
             MetaDataLog::metaDataLogID(c_logid),
-            AppenderBuffer::processBufferedAppender);
+            AppenderBuffer::makeDrainCallback());
       }
     } else {
       // Sequencer activation failed becaused of an error from epoch store or
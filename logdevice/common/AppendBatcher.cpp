@@ -0,0 +1,129 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/AppendBatcher.h"
+
+#include <limits>
+
+#include "logdevice/common/AppendRequest.h"
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/Compatibility.h"
+#include "logdevice/common/stats/Stats.h"
+#include "logdevice/common/util.h"
+
+namespace facebook { namespace logdevice {
+
+namespace {
+AppendRequest* findRequest(request_id_t rqid) {
+  auto& map = Worker::onThisThread()->runningAppends().map;
+  auto it = map.find(rqid);
+  if (it == map.end()) {
+    // The request went away (e.g. timed out) while its append was queued.
+    return nullptr;
+  }
+  ld_check(it->second);
+  return checked_downcast<AppendRequest*>(it->second.get());
+}
+} // namespace
+
+bool AppendBatcher::append(NodeID dest,
+                           const APPEND_Header& header,
+                           PayloadHolder payload) {
+  const ConnectionInfo* info =
+      Worker::onThisThread()->sender().getConnectionInfo(Address(dest));
+  if (info == nullptr || !info->protocol.has_value() ||
+      info->protocol.value() < Compatibility::APPEND_BATCH_MESSAGE_SUPPORT) {
+    // Connection is gone, still handshaking, or the peer doesn't speak
+    // APPEND_BATCH; the caller falls back to a plain APPEND.
+    return false;
+  }
+
+  if (num_pending_ == 0) {
+    flush_timer_.activate(std::chrono::microseconds(0));
+  }
+
+  BatchKey key{dest, header.logid, header.seen, header.timeout_ms,
+               header.flags};
+  Batch& batch = pending_[key];
+  if (batch.records.empty()) {
+    batch.header = APPEND_BATCH_Header{
+        header.logid, header.seen, header.timeout_ms, header.flags, 0};
+  }
+  batch.payload_bytes += payload.size();
+  batch.records.push_back(
+      APPEND_BATCH_Message::BatchedRecord{header.rqid, std::move(payload)});
+  ++num_pending_;
+
+  const Settings& settings = Worker::settings();
+  if (batch.records.size() >= settings.append_batch_max_records ||
+      batch.payload_bytes >= settings.append_batch_max_payload_bytes ||
+      batch.records.size() == std::numeric_limits<uint16_t>::max()) {
+    // Close out this batch early so it stays within the configured bounds
+    // (record_count is 16 bits in any case).
+    num_pending_ -= batch.records.size();
+    sendBatch(dest, std::move(batch));
+    pending_.erase(key);
+  }
+  return true;
+}
+
+void AppendBatcher::flush() {
+  flush_timer_.cancel();
+  for (auto& kv : pending_) {
+    sendBatch(kv.first.dest, std::move(kv.second));
+  }
+  pending_.clear();
+  num_pending_ = 0;
+}
+
+void AppendBatcher::sendBatch(NodeID dest, Batch batch) {
+  ld_check(!batch.records.empty());
+  ld_check(batch.records.size() <= std::numeric_limits<uint16_t>::max());
+  // A batch of one is about the same size on the wire as a plain APPEND,
+  // so bursts that fail to materialize cost nothing; no special case.
+  batch.header.record_count = static_cast<uint16_t>(batch.records.size());
+
+  std::vector<request_id_t> rqids;
+  rqids.reserve(batch.records.size());
+  for (const auto& rec : batch.records) {
+    rqids.push_back(rec.rqid);
+  }
+
+  WORKER_STAT_INCR(client.append_batches_sent);
+  WORKER_STAT_ADD(client.appends_batched, rqids.size());
+
+  auto msg = std::make_unique<APPEND_BATCH_Message>(batch.header,
+                                                    std::move(batch.records));
+  int rv =
+      Worker::onThisThread()->sender().sendMessage(std::move(msg), dest);
+  if (rv != 0) {
+    // Fail each append the way a plain APPEND send failure would; the
+    // requests decide between noReply() and terminal errors. This may
+    // destroy the requests.
+    const Status st = err;
+    for (request_id_t rqid : rqids) {
+      AppendRequest* rq = findRequest(rqid);
+      if (rq != nullptr) {
+        rq->onBatchedAppendSendError(st, dest);
+      }
+    }
+    return;
+  }
+
+  // Give each request the same fail-fast-on-disconnect behavior a plain
+  // APPEND send would have installed.
+  for (request_id_t rqid : rqids) {
+    AppendRequest* rq = findRequest(rqid);
+    if (rq != nullptr) {
+      rq->onBatchedAppendSent(dest);
+    }
+  }
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,110 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <vector>
+
+#include <folly/container/F14Map.h>
+#include <folly/hash/Hash.h>
+
+#include "logdevice/common/NodeID.h"
+#include "logdevice/common/Timer.h"
+#include "logdevice/common/protocol/APPEND_BATCH_Message.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file AppendBatcher coalesces client appends into APPEND_BATCH messages,
+ *       the write-path counterpart of AppendedCoalescer. A client issuing
+ *       many small appends to one log otherwise pays protocol framing and
+ *       one server-side Worker dispatch per record; batching amortizes
+ *       both while each record keeps its own LSN and its own APPENDED
+ *       reply.
+ *
+ *       One instance per Worker. When --append-batch-max-records is
+ *       nonzero, eligible AppendRequests (see
+ *       AppendRequest::canBatchAppend()) enqueue here instead of sending a
+ *       plain APPEND; a zero-delay timer flushes one APPEND_BATCH per
+ *       (sequencer node, log, shared header fields) when the event loop
+ *       turns, so appends issued in the same loop iteration share a frame.
+ *       APPENDED replies are routed back to the individual requests by
+ *       rqid exactly as for plain APPENDs.
+ *
+ *       Not thread-safe; confined to the owning Worker.
+ */
+
+class AppendBatcher {
+ public:
+  AppendBatcher() : flush_timer_([this] { flush(); }) {}
+
+  /**
+   * Queues an append for a coalesced send to sequencer node @param dest
+   * when the event loop turns. @param header is the header a plain APPEND
+   * would carry; appends share a batch iff all its fields except rqid
+   * match.
+   *
+   * @return true if the append was queued; false if the connection to
+   *         `dest` doesn't speak APPEND_BATCH (or isn't handshaken yet)
+   *         and the caller must send a plain APPEND itself.
+   */
+  bool
+  append(NodeID dest, const APPEND_Header& header, PayloadHolder payload);
+
+  /**
+   * Sends all pending batches now. Called by the zero-delay timer; also
+   * safe to call directly.
+   */
+  void flush();
+
+  size_t numPending() const {
+    return num_pending_;
+  }
+
+ private:
+  struct Batch {
+    APPEND_BATCH_Header header;
+    std::vector<APPEND_BATCH_Message::BatchedRecord> records;
+    size_t payload_bytes{0};
+  };
+
+  // Destination node plus every APPEND_BATCH_Header field that must
+  // coincide for two appends to share a batch.
+  struct BatchKey {
+    NodeID dest;
+    logid_t logid;
+    epoch_t seen;
+    uint32_t timeout_ms;
+    APPEND_flags_t flags;
+
+    bool operator==(const BatchKey& o) const {
+      return dest == o.dest && logid == o.logid && seen == o.seen &&
+          timeout_ms == o.timeout_ms && flags == o.flags;
+    }
+
+    struct Hash {
+      size_t operator()(const BatchKey& k) const {
+        return folly::hash::hash_combine(k.dest.index(),
+                                         k.dest.generation(),
+                                         k.logid.val_,
+                                         k.seen.val_,
+                                         k.timeout_ms,
+                                         k.flags);
+      }
+    };
+  };
+
+  void sendBatch(NodeID dest, Batch batch);
+
+  Timer flush_timer_;
+
+  // (node, log, header) -> appends queued since the last flush
+  folly::F14FastMap<BatchKey, Batch, BatchKey::Hash> pending_;
+  size_t num_pending_{0};
+};
+
+}} // namespace facebook::logdevice
@@ -13,6 +13,7 @@
 #include <folly/stats/BucketedTimeSeries.h>
 #include <folly/synchronization/Baton.h>
 
+#include "logdevice/common/AppendBatcher.h"
 #include "logdevice/common/AppendProbeController.h"
 #include "logdevice/common/MetaDataLog.h"
 #include "logdevice/common/Processor.h"
@@ -341,6 +342,23 @@ std::unique_ptr<APPEND_Message> AppendRequest::createAppendMessage() {
 void AppendRequest::sendAppendMessage() {
   const NodeID dest = sequencer_node_;
 
+  Worker* w = Worker::onThisThread(false);
+  if (w != nullptr && canBatchAppend()) {
+    APPEND_Header header = {
+        id_,
+        record_.logid,
+        getSeenEpoch(record_.logid),
+        uint32_t(
+            std::min<decltype(timeout_)::rep>(timeout_.count(), UINT_MAX)),
+        getAppendFlags()};
+    if (w->appendBatcher().append(dest, header, payload_)) {
+      // The batcher sends the APPEND_BATCH when the event loop turns; the
+      // APPENDED reply is routed back to this request by rqid as usual.
+      return;
+    }
+    // The connection doesn't speak APPEND_BATCH; send a plain APPEND.
+  }
+
   auto msg = createAppendMessage();
 
   // make sure that on_socket_close_ is not active in case we're resending this
@@ -359,6 +377,37 @@ void AppendRequest::sendAppendMessage() {
   }
 }
 
+bool AppendRequest::canBatchAppend() {
+  if (getSettings().append_batch_max_records == 0) {
+    return false;
+  }
+  // APPEND_BATCH can't carry per-record attributes, redirect history,
+  // stream state or payload groups; those go out as plain APPEND.
+  const APPEND_flags_t incompatible = APPEND_Header::CUSTOM_KEY |
+      APPEND_Header::CUSTOM_COUNTERS | APPEND_Header::WRITE_STREAM_REQUEST |
+      APPEND_Header::WRITE_STREAM_RESUME |
+      APPEND_Header::LSN_BEFORE_REDIRECT | APPEND_Header::PAYLOAD_GROUP;
+  return (getAppendFlags() & incompatible) == 0;
+}
+
+void AppendRequest::onBatchedAppendSent(NodeID dest) {
+  // make sure that on_socket_close_ is not active in case the append was
+  // resent
+  on_socket_close_.deactivate();
+  int rv = Worker::onThisThread()->sender().registerOnConnectionClosed(
+      Address(dest), on_socket_close_);
+  if (rv != 0) {
+    // The connection closed between the batch send and this call; fail the
+    // same way the close callback would have. `this` may be destroyed now.
+    noReply(E::PEER_CLOSED, Address(dest), /*request_sent=*/true);
+  }
+}
+
+void AppendRequest::onBatchedAppendSendError(Status st, NodeID dest) {
+  handleMessageSendError(MessageType::APPEND, st, dest);
+  // `this` may be destroyed now
+}
+
 void AppendRequest::handleMessageSendError(MessageType type,
                                            Status st,
                                            const NodeID dest) {
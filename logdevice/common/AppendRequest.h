@@ -214,6 +214,21 @@ class AppendRequest : public AppendRequestBase,
                                size_t max_payload_size,
                                bool allow_extra);
 
+  /**
+   * Called by the Worker's AppendBatcher after it sent this request's append
+   * as part of an APPEND_BATCH message to `dest`: installs the same on-close
+   * callback on the connection that a plain APPEND send would have, so the
+   * request fails fast if the connection goes away while the append is in
+   * flight.
+   */
+  void onBatchedAppendSent(NodeID dest);
+
+  /**
+   * Called by the AppendBatcher if sending the APPEND_BATCH carrying this
+   * request's append failed synchronously. May destroy the request.
+   */
+  void onBatchedAppendSendError(Status st, NodeID dest);
+
   // see on_socket_close_ below
   class SocketClosedCallback : public SocketCallback {
    public:
@@ -289,6 +304,12 @@ class AppendRequest : public AppendRequestBase,
   // Returns the set of flags that included in APPEND messages.
   virtual APPEND_flags_t getAppendFlags();
 
+  // True if this append may be coalesced into an APPEND_BATCH message:
+  // batching is enabled in settings and the append carries none of the
+  // per-record extras (custom keys/counters, stream state, redirect
+  // history, payload groups) the batch format can't represent.
+  bool canBatchAppend();
+
   /*
    * Including protected accessors to expose read/write access to private fields
    * from child class (mainly StreamAppendRequest). In cases where copy
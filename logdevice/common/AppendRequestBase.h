@@ -7,7 +7,7 @@
  */
 #pragma once
 
-#include <unordered_map>
+#include <folly/container/F14Map.h>
 
 #include "logdevice/common/Request.h"
 #include "logdevice/include/Err.h"
@@ -30,11 +30,15 @@ struct APPENDED_Header;
 struct APPEND_PROBE_REPLY_Header;
 class AppendRequestBase;
 
-// Wrapper instead of typedef to allow forward-declaring in Worker.h
+// Wrapper instead of typedef to allow forward-declaring in Worker.h.
+// F14 (open addressing) rather than std::unordered_map: this map is hit on
+// every append reply and its lookups show up in Worker cache-miss profiles.
+// Note that F14 iterators and references to the mapped unique_ptr don't
+// survive rehashing; the pointed-to request objects are stable as always.
 struct AppendRequestMap {
-  std::unordered_map<request_id_t,
-                     std::unique_ptr<AppendRequestBase>,
-                     request_id_t::Hash>
+  folly::F14FastMap<request_id_t,
+                    std::unique_ptr<AppendRequestBase>,
+                    request_id_t::Hash>
       map;
 };
 
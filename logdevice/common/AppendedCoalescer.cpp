@@ -0,0 +1,88 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/AppendedCoalescer.h"
+
+#include <limits>
+
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/APPENDED_BATCH_Message.h"
+#include "logdevice/common/protocol/Compatibility.h"
+#include "logdevice/common/stats/Stats.h"
+
+namespace facebook { namespace logdevice {
+
+bool AppendedCoalescer::noteReply(ClientID to, const APPENDED_Header& reply) {
+  // Replies with a sequencer batching offset have a variable-size trailer
+  // and must go out as plain APPENDED (SequencerBatching sends those itself).
+  ld_check(!(reply.flags & APPENDED_Header::INCLUDES_SEQ_BATCHING_OFFSET));
+
+  const ConnectionInfo* info =
+      Worker::onThisThread()->sender().getConnectionInfo(Address(to));
+  if (info == nullptr || !info->protocol.has_value() ||
+      info->protocol.value() < Compatibility::APPENDED_BATCH_MESSAGE_SUPPORT) {
+    // Connection is gone, still handshaking, or the peer doesn't speak
+    // APPENDED_BATCH; the caller falls back to a plain reply.
+    return false;
+  }
+
+  if (num_pending_ == 0) {
+    flush_timer_.activate(std::chrono::microseconds(0));
+  }
+
+  std::vector<APPENDED_Header>& replies = pending_[to];
+  replies.push_back(reply);
+  ++num_pending_;
+
+  if (replies.size() == std::numeric_limits<uint16_t>::max()) {
+    // reply_count is 16 bits; close out this client's batch early.
+    num_pending_ -= replies.size();
+    sendBatch(to, std::move(replies));
+    pending_.erase(to);
+  }
+  return true;
+}
+
+void AppendedCoalescer::flush() {
+  flush_timer_.cancel();
+  for (auto& kv : pending_) {
+    sendBatch(kv.first, std::move(kv.second));
+  }
+  pending_.clear();
+  num_pending_ = 0;
+}
+
+void AppendedCoalescer::sendBatch(ClientID to,
+                                  std::vector<APPENDED_Header> replies) {
+  ld_check(!replies.empty());
+
+  std::unique_ptr<Message> msg;
+  if (replies.size() == 1) {
+    // A batch of one would only add framing; send a plain APPENDED.
+    msg = std::make_unique<APPENDED_Message>(replies[0]);
+  } else {
+    STAT_ADD(Worker::stats(), appended_replies_coalesced, replies.size());
+    APPENDED_BATCH_Header hdr{static_cast<uint16_t>(replies.size())};
+    msg = std::make_unique<APPENDED_BATCH_Message>(hdr, std::move(replies));
+  }
+
+  int rv = Worker::onThisThread()->sender().sendMessage(std::move(msg), to);
+  if (rv != 0) {
+    // The client may simply have disconnected while replies were pending;
+    // its requests will time out, same as a failed plain APPENDED send.
+    RATELIMIT_LEVEL(err == E::NOTCONN ? dbg::Level::DEBUG : dbg::Level::INFO,
+                    std::chrono::seconds(10),
+                    10,
+                    "Failed to send coalesced APPENDED replies to %s: %s",
+                    to.toString().c_str(),
+                    error_description(err));
+  }
+}
+
+}} // namespace facebook::logdevice
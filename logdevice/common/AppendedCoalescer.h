@@ -0,0 +1,73 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <vector>
+
+#include <folly/container/F14Map.h>
+
+#include "logdevice/common/ClientID.h"
+#include "logdevice/common/Timer.h"
+#include "logdevice/common/protocol/APPENDED_Message.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file AppendedCoalescer batches APPENDED replies on sequencer nodes. A
+ *       client pipelining tens of thousands of appends per second over one
+ *       connection otherwise gets one APPENDED message per append, so reply
+ *       framing makes up half the reverse-path packets between the producer
+ *       tier and the sequencer.
+ *
+ *       One instance per Worker. When --appended-reply-coalescing-enabled is
+ *       set, Appenders record their reply header here instead of sending
+ *       immediately; a zero-delay timer flushes one APPENDED_BATCH per
+ *       pending client when the event loop turns, so every reply produced in
+ *       the same loop iteration shares a frame. Replies to clients whose
+ *       connection predates APPENDED_BATCH_MESSAGE_SUPPORT, and replies
+ *       carrying a sequencer batching offset, keep using plain APPENDED.
+ *
+ *       Not thread-safe; confined to the owning Worker.
+ */
+
+class AppendedCoalescer {
+ public:
+  AppendedCoalescer() : flush_timer_([this] { flush(); }) {}
+
+  /**
+   * Queues @param reply for a coalesced send to @param to when the event
+   * loop turns.
+   *
+   * @return true if the reply was queued; false if the client's connection
+   *         doesn't speak APPENDED_BATCH and the caller must send a plain
+   *         APPENDED itself.
+   */
+  bool noteReply(ClientID to, const APPENDED_Header& reply);
+
+  /**
+   * Sends all pending replies now. Called by the zero-delay timer; also safe
+   * to call directly (e.g. on shutdown).
+   */
+  void flush();
+
+  size_t numPending() const {
+    return num_pending_;
+  }
+
+ private:
+  void sendBatch(ClientID to, std::vector<APPENDED_Header> replies);
+
+  Timer flush_timer_;
+
+  // client -> replies produced since the last flush
+  folly::F14FastMap<ClientID, std::vector<APPENDED_Header>, ClientID::Hash>
+      pending_;
+  size_t num_pending_{0};
+};
+
+}} // namespace facebook::logdevice
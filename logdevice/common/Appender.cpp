@@ -14,6 +14,7 @@
 
 #include "logdevice/common/Address.h"
 #include "logdevice/common/AppendRequest.h"
+#include "logdevice/common/AppendedCoalescer.h"
 #include "logdevice/common/AppenderTracer.h"
 #include "logdevice/common/Checksum.h"
 #include "logdevice/common/ClusterState.h"
@@ -25,12 +26,14 @@
 #include "logdevice/common/PayloadHolder.h"
 #include "logdevice/common/PeriodicReleases.h"
 #include "logdevice/common/Processor.h"
+#include "logdevice/common/ReleaseCoalescer.h"
 #include "logdevice/common/Sequencer.h"
 #include "logdevice/common/SocketSender.h"
 #include "logdevice/common/TailRecord.h"
 #include "logdevice/common/TraceLogger.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/WorkerTimeoutStats.h"
+#include "logdevice/common/chrono_util.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/common/protocol/APPENDED_Message.h"
 #include "logdevice/common/protocol/DELETE_Message.h"
@@ -538,8 +541,21 @@ int Appender::sendWave() {
 
   cancelStoreTimer();
 
+  StatsHolder* stats = getStats();
+  auto* wave_hist = stats && stats->get().server_histograms
+      ? &stats->get().server_histograms->appender_wave_send_latency
+      : nullptr;
+  // Decide whether to time this wave before reading the clock, so unsampled
+  // waves skip the timestamps entirely.
+  const uint64_t start_cycles =
+      wave_hist && wave_hist->shouldRecord() ? cycle_timestamp() : 0;
+
   int rv = trySendingWavesOfStores(cfg_synced, append_ctx);
 
+  if (start_cycles != 0) {
+    wave_hist->addSampled(cycles_to_usec(cycle_timestamp() - start_cycles));
+  }
+
   if (replies_expected_ < recipients_.getReplication()) {
     // We failed to send a complete wave. Up the current wave id so that
     // the Appender ignores replies to any STORE message we did send.
@@ -651,7 +667,11 @@ int Appender::start(std::shared_ptr<EpochSequencer> epoch_sequencer,
     tail_optimized = logcfg->attrs().tailOptimized().value();
   }
 
-  prepareTailRecord(tail_optimized);
+  // keep the payload around also when this node caches recent records for
+  // tailing readers (see SequencerTailCache)
+  const bool tail_cache_enabled =
+      getSettings().sequencer_recent_records_cache_bytes > 0;
+  prepareTailRecord(tail_optimized || tail_cache_enabled);
   ld_check(tail_record_ != nullptr);
 
   STAT_INCR(getStats(), appender_start);
@@ -862,13 +882,11 @@ void Appender::sendReply(lsn_t lsn, Status status, NodeID redirect) {
                  append_message_count_);
     if (created_on_) { // can be null in tests
       // Bump the per-log-group stats
-      if (auto log_path =
-              created_on_->getConfiguration()->getLogGroupPath(log_id_)) {
+      if (const std::string* log_path =
+              created_on_->getLogGroupPathCached(log_id_)) {
         ld_check(getPayload());
-        LOG_GROUP_TIME_SERIES_ADD(getStats(),
-                                  append_out_bytes,
-                                  log_path.value(),
-                                  getPayload()->size());
+        LOG_GROUP_TIME_SERIES_ADD(
+            getStats(), append_out_bytes, *log_path, getPayload()->size());
       }
     }
   } else {
@@ -897,6 +915,16 @@ void Appender::sendReply(lsn_t lsn, Status status, NodeID redirect) {
     return;
   }
 
+  if (getSettings().appended_reply_coalescing_enabled) {
+    // Batch with replies to other appends finishing in the same event loop
+    // iteration; one APPENDED_BATCH per client goes out when the loop turns.
+    // Falls through to a plain reply if the client doesn't speak the batch.
+    if (Worker::onThisThread()->appendedCoalescer().noteReply(
+            reply_to_, replyhdr)) {
+      return;
+    }
+  }
+
   auto reply = std::make_unique<APPENDED_Message>(replyhdr);
 
   int rv = sender_->sendMessage(std::move(reply), reply_to_);
@@ -1848,6 +1876,16 @@ void Appender::sendReleases(const ShardID* dests,
           store_hdr_.rid.toString().c_str(),
           ndests);
 
+  if (Worker::settings().release_coalescing_window.count() > 0) {
+    // Batch with other reapings in the same micro-window; one RELEASE per
+    // (shard, log) goes out when the window closes.
+    ReleaseCoalescer& coalescer = Worker::onThisThread()->releaseCoalescer();
+    for (size_t dest_num = 0; dest_num < ndests; ++dest_num) {
+      coalescer.noteRelease(dests[dest_num], store_hdr_.rid, release_type);
+    }
+    return;
+  }
+
   for (size_t dest_num = 0; dest_num < ndests; ++dest_num) {
     const ShardID& dest = dests[dest_num];
 
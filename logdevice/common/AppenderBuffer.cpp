@@ -213,17 +213,49 @@ void AppenderBuffer::processQueue(logid_t logid, AppenderCallback cb) {
 AppenderBuffer::Action
 AppenderBuffer::processBufferedAppender(logid_t logid,
                                         AppenderUniqPtr& appender) {
+  // find the corresponding data log sequencer
+  const logid_t datalog_id = MetaDataLog::dataLogID(logid);
+  std::shared_ptr<Sequencer> sequencer =
+      Worker::onThisThread()->processor_->allSequencers().findSequencer(
+          datalog_id);
+  return processBufferedAppenderImpl(logid, appender, sequencer);
+}
+
+/* static */
+AppenderBuffer::AppenderCallback AppenderBuffer::makeDrainCallback() {
+  // Memoizes the sequencer lookup across all appenders drained for the same
+  // log. The Sequencer object for a log is stable for the lifetime of the
+  // drain (drains run on one Worker and AllSequencers never replaces a
+  // Sequencer in place), so reusing it is equivalent to looking it up per
+  // appender, minus the map access and refcount traffic.
+  struct Cache {
+    logid_t logid{LOGID_INVALID};
+    std::shared_ptr<Sequencer> sequencer;
+  };
+  auto cache = std::make_shared<Cache>();
+  return [cache](logid_t logid, AppenderUniqPtr& appender) {
+    if (cache->logid != logid) {
+      cache->logid = logid;
+      cache->sequencer =
+          Worker::onThisThread()->processor_->allSequencers().findSequencer(
+              MetaDataLog::dataLogID(logid));
+    }
+    return processBufferedAppenderImpl(logid, appender, cache->sequencer);
+  };
+}
+
+/* static */
+AppenderBuffer::Action AppenderBuffer::processBufferedAppenderImpl(
+    logid_t logid,
+    AppenderUniqPtr& appender,
+    const std::shared_ptr<Sequencer>& sequencer) {
   ld_check(appender.get());
 
   Action action = Action::DESTROY;
   RunAppenderStatus appender_status = RunAppenderStatus::ERROR_DELETE;
   const Worker* w = Worker::onThisThread();
 
-  // find the corresponding data log sequencer
-  const logid_t datalog_id = MetaDataLog::dataLogID(logid);
   const bool metadata_log = MetaDataLog::isMetaDataLog(logid);
-  std::shared_ptr<Sequencer> sequencer =
-      w->processor_->allSequencers().findSequencer(datalog_id);
 
   if (!sequencer) {
     err = E::NOSEQUENCER;
@@ -118,6 +118,16 @@ class AppenderBuffer {
    */
   static Action processBufferedAppender(logid_t logid, AppenderUniqPtr& ap);
 
+  /**
+   * Returns an AppenderCallback equivalent to processBufferedAppender()
+   * except that the sequencer lookup (AllSequencers map access + shared_ptr
+   * acquisition) is done once per drained queue rather than once per
+   * appender. Use for post-activation drains, where thousands of buffered
+   * appends for the same log are submitted back-to-back and the drain loop
+   * should do no more per-append work than submission itself.
+   */
+  static AppenderCallback makeDrainCallback();
+
   /**
    * Empty AppenderCallback that does not nothing so that Appenders just got
    * destroyed while poped out of the queue
@@ -125,6 +135,13 @@ class AppenderBuffer {
   static const AppenderCallback EMPTY_APPENDER_CB;
 
  private:
+  // shared implementation of processBufferedAppender() and the callback
+  // returned by makeDrainCallback(); takes the already-looked-up sequencer
+  static Action
+  processBufferedAppenderImpl(logid_t logid,
+                              AppenderUniqPtr& ap,
+                              const std::shared_ptr<Sequencer>& sequencer);
+
   // capacity of the AppenderBuffer queue
   size_t appender_buffer_queue_cap_;
 
@@ -7,10 +7,15 @@
  */
 #include "logdevice/common/AppenderPrep.h"
 
+#include <folly/Random.h>
+
 #include "logdevice/common/Appender.h"
 #include "logdevice/common/AppenderBuffer.h"
 #include "logdevice/common/Checksum.h"
+#include "logdevice/common/LogGroupAppendThrottle.h"
+#include "logdevice/common/PrincipalThrottle.h"
 #include "logdevice/common/MetaDataLogWriter.h"
+#include "logdevice/common/PayloadTransformStage.h"
 #include "logdevice/common/PermissionChecker.h"
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/Sender.h"
@@ -19,6 +24,7 @@
 #include "logdevice/common/SequencerLocator.h"
 #include "logdevice/common/UpdateableSecurityInfo.h"
 #include "logdevice/common/Worker.h"
+#include "logdevice/common/request_util.h"
 
 namespace facebook { namespace logdevice {
 
@@ -66,10 +72,52 @@ void AppenderPrep::sendReply(std::unique_ptr<Appender> appender,
 }
 
 void AppenderPrep::execute() {
+  std::shared_ptr<PayloadTransformStage> stage = getPayloadTransformStage();
+  if (stage != nullptr && !payload_transformed_) {
+    payload_transformed_ = true;
+    // Transforms can be CPU-heavy (envelope encryption, schema validation),
+    // so run the stage on a background thread while the payload is still
+    // owned by this AppenderPrep and resume on this Worker once it's done.
+    // If the background queue is full (or we're not on a Worker, as in some
+    // tests), run the stage inline instead of dropping the append.
+    Worker* w = Worker::onThisThread(false);
+    if (w != nullptr) {
+      Processor* processor = w->processor_;
+      const worker_id_t idx = w->idx_;
+      const WorkerType worker_type = w->worker_type_;
+      std::shared_ptr<AppenderPrep> prep = shared_from_this();
+      auto transform_and_resume = [prep, stage, processor, idx, worker_type] {
+        prep->transform_status_ = stage->transform(
+            prep->header_.logid, folly::Range<PayloadHolder*>(&prep->payload_, 1));
+        std::unique_ptr<Request> req = FuncRequest::make(
+            idx, worker_type, RequestType::MISC, [prep] { prep->execute(); });
+        int rv = processor->postWithRetrying(req);
+        ld_check(rv == 0);
+      };
+      if (processor->enqueueToBackgroundIfNotFull(
+              std::move(transform_and_resume))) {
+        return;
+      }
+    }
+    transform_status_ = stage->transform(
+        header_.logid, folly::Range<PayloadHolder*>(&payload_, 1));
+  }
   execute(constructAppender());
 }
 
 void AppenderPrep::execute(std::unique_ptr<Appender> appender) {
+  if (transform_status_ != E::OK) {
+    RATELIMIT_INFO(std::chrono::seconds(2),
+                   10,
+                   "APPEND request from %s for log %lu rejected by the "
+                   "payload transform stage: %s",
+                   Sender::describeConnection(from_).c_str(),
+                   header_.logid.val_,
+                   error_description(transform_status_));
+    sendError(appender.get(), transform_status_);
+    return;
+  }
+
   // Appends for a metadata log is handled by the corresponding data
   // log sequencer of the log, so here we mask the MetaDataLog::ID_SHIFT
   // bit of the logid to find the data log sequencer
@@ -99,6 +147,37 @@ void AppenderPrep::execute(std::unique_ptr<Appender> appender) {
     return;
   }
 
+  if (!checkAppendRateLimit()) {
+    // The log group is over its configured append throughput ceiling.
+    // Reject before the Appender starts occupying a slot in the sequencer
+    // window or issuing stores, so a runaway producer can't starve log
+    // groups that share this sequencer node.
+    RATELIMIT_INFO(std::chrono::seconds(10),
+                   2,
+                   "APPEND request from %s for log %lu rejected because the "
+                   "log group is over its configured append rate limit",
+                   Sender::describeConnection(from_).c_str(),
+                   header_.logid.val_);
+    STAT_ADD(stats(), append_rejected_rate_limited, append_message_count_);
+    sendError(appender.get(), E::SEQNOBUFS);
+    return;
+  }
+
+  if (!checkPrincipalRateLimit()) {
+    // The client's principal is over its configured append throughput
+    // ceiling. Throttle the noisy tenant at admission instead of letting
+    // it degrade everyone sharing this sequencer node.
+    RATELIMIT_INFO(std::chrono::seconds(10),
+                   2,
+                   "APPEND request from %s for log %lu rejected because its "
+                   "principal is over its configured append rate limit",
+                   Sender::describeConnection(from_).c_str(),
+                   header_.logid.val_);
+    STAT_ADD(stats(), append_rejected_principal_limited, append_message_count_);
+    sendError(appender.get(), E::SEQNOBUFS);
+    return;
+  }
+
   // Verify the integrity of the checksum bits: CHECKSUM_PARITY should be the
   // XNOR of the other two.
   bool expected_parity = bool(header_.flags & APPEND_Header::CHECKSUM) ==
@@ -211,6 +290,36 @@ void AppenderPrep::onSequencerNodeFound(Status st,
     return;
   }
 
+  // We're the node the log hashes to, but the sequencer load spreader may
+  // have decided that the log's sequencer should run elsewhere. If so,
+  // redirect new appends to the chosen node; the client will bring up a
+  // sequencer there through the usual redirect handling (NO_REDIRECT on
+  // redirect cycles), which preempts ours. shouldRedirect() keeps honoring
+  // the client's flags and no_redirect_until_, so clients that can't follow
+  // the redirect are still served here.
+  if (redirect_decision == Decision::CORRECT_NODE && sequencer != nullptr) {
+    NodeID target = sequencer->getRelocationTarget();
+    if (target.isNodeID() && target.index() != getMyNodeID().index()) {
+      if (!isAlive(target) || isBoycotted(target)) {
+        // The target went away; forget about relocating this log.
+        sequencer->setRelocationTarget(NodeID());
+      } else {
+        Decision target_decision = shouldRedirect(target, sequencer.get());
+        if (target_decision == Decision::REDIRECT) {
+          STAT_ADD(stats(), append_redirected_for_load, append_message_count_);
+          sendRedirect(appender.get(), target, E::REDIRECTED);
+          return;
+        }
+        if (target_decision == Decision::FLAG_NO_REDIRECT) {
+          // The client couldn't get the target to take the log over (e.g. a
+          // redirect cycle). Give up on relocating it to avoid bouncing
+          // every new client.
+          sequencer->setRelocationTarget(NodeID());
+        }
+      }
+    }
+  }
+
   auto bump_activation_stats = [this, datalog_id](
                                    Decision redir_decision, bool preempted) {
     switch (redir_decision) {
@@ -348,6 +457,23 @@ void AppenderPrep::onSequencerNodeFound(Status st,
       return;
     }
 
+    if (shouldShedForOverload(*sequencer)) {
+      // Some shards in the nodeset are graylisted as overloaded (their
+      // storage task queues reported excessive sojourn times in STORED
+      // replies). Shed a matching fraction of incoming appends while the
+      // remaining shards can still keep up, instead of accepting everything
+      // and racing toward the checkNodeSet() cliff and client timeouts.
+      RATELIMIT_INFO(std::chrono::seconds(10),
+                     1,
+                     "Shedding APPEND request from %s for log %lu because "
+                     "part of the nodeset is overloaded",
+                     Sender::describeConnection(from_).c_str(),
+                     header_.logid.val_);
+      STAT_ADD(stats(), append_rejected_overload_shed, append_message_count_);
+      sendError(appender.get(), E::OVERLOADED);
+      return;
+    }
+
     auto state = sequencer->getState();
     if ((state == Sequencer::State::ACTIVE ||
          state == Sequencer::State::PREEMPTED) &&
@@ -985,6 +1111,45 @@ bool AppenderPrep::isAcceptingWork() const {
   return Worker::onThisThread()->isAcceptingWork();
 }
 
+bool AppenderPrep::checkAppendRateLimit() {
+  if (!from_.valid()) {
+    // Internal appends (e.g. batches re-injected by SequencerBatching) are
+    // exempt: their constituent appends were already charged when they
+    // arrived over the wire.
+    return true;
+  }
+  Worker* w = Worker::onThisThread(false);
+  if (w == nullptr) {
+    // May happen in tests.
+    return true;
+  }
+  return w->logGroupAppendThrottle().isAllowed(header_.logid, payload_.size());
+}
+
+bool AppenderPrep::checkPrincipalRateLimit() {
+  if (!from_.valid()) {
+    // Internal appends are exempt for the same reason as in
+    // checkAppendRateLimit().
+    return true;
+  }
+  Worker* w = Worker::onThisThread(false);
+  if (w == nullptr) {
+    // May happen in tests.
+    return true;
+  }
+  return w->principalThrottle().allowAppend(getPrincipal(), payload_.size());
+}
+
+bool AppenderPrep::shouldShedForOverload(const Sequencer& sequencer) const {
+  if (!getSettings().append_overload_shedding || !from_.valid()) {
+    // Internal appends (e.g. batches re-injected by SequencerBatching) are
+    // never shed; their constituent appends were already admitted.
+    return false;
+  }
+  double fraction = sequencer.getOverloadedHeadroomFraction();
+  return fraction > 0 && folly::Random::randDouble01() < fraction;
+}
+
 void AppenderPrep::sendError(Appender* appender, Status status) const {
   ld_check(appender != nullptr);
   appender->sendError(status);
@@ -1038,6 +1203,12 @@ SequencerLocator& AppenderPrep::getSequencerLocator() {
   return *Worker::onThisThread()->processor_->sequencer_locator_;
 }
 
+std::shared_ptr<PayloadTransformStage>
+AppenderPrep::getPayloadTransformStage() const {
+  Worker* w = Worker::onThisThread(false);
+  return w != nullptr ? w->processor_->payloadTransformStage() : nullptr;
+}
+
 // needed for tests mock
 std::shared_ptr<PermissionChecker> AppenderPrep::getPermissionChecker() {
   if (Worker::settings().require_permission_message_types.count(
@@ -26,6 +26,7 @@
 namespace facebook { namespace logdevice {
 
 class Appender;
+class PayloadTransformStage;
 class Sequencer;
 class StatsHolder;
 class SequencerLocator;
@@ -134,6 +135,24 @@ class AppenderPrep : public std::enable_shared_from_this<AppenderPrep> {
   // shutting down).
   virtual bool isAcceptingWork() const;
 
+  // Charges the append's payload against the log group's configured append
+  // throughput ceiling, if any. Returns false if the log group is over its
+  // ceiling and the append should be rejected. See LogGroupAppendThrottle.h.
+  virtual bool checkAppendRateLimit();
+
+  // Charges the append's payload against the client principal's configured
+  // append throughput ceiling, if any. Returns false if the principal is
+  // over its ceiling and the append should be rejected. See
+  // PrincipalThrottle.h.
+  virtual bool checkPrincipalRateLimit();
+
+  // Decides whether this append should be probabilistically shed because
+  // part of the log's nodeset is graylisted as overloaded. The shed
+  // probability matches the fraction of write headroom those shards consume,
+  // so load drops off gradually instead of collapsing once checkNodeSet()
+  // starts failing. Gated by the append-overload-shedding setting.
+  virtual bool shouldShedForOverload(const Sequencer& sequencer) const;
+
   // Reply to the client with a given error status.
   virtual void sendError(Appender*, Status) const;
 
@@ -165,6 +184,11 @@ class AppenderPrep : public std::enable_shared_from_this<AppenderPrep> {
   // Returns processor's sequencer locator
   virtual SequencerLocator& getSequencerLocator();
 
+  // Returns the Processor's pluggable payload transform stage, or nullptr if
+  // none is loaded.  See PayloadTransformStage.h.
+  virtual std::shared_ptr<PayloadTransformStage> getPayloadTransformStage()
+      const;
+
   // Write stream request id, if the append belongs to a write stream.
   write_stream_request_id_t write_stream_rqid_ =
       WRITE_STREAM_REQUEST_ID_INVALID;
@@ -192,6 +216,12 @@ class AppenderPrep : public std::enable_shared_from_this<AppenderPrep> {
   bool allow_batching_ = true;
   // only allow the append to go through on the following epoch, if set
   folly::Optional<epoch_t> acceptable_epoch_;
+  // Set once execute() has run the payload through the transform stage (or
+  // handed it to a background thread to do so), so the resumed execute()
+  // doesn't transform it again.
+  bool payload_transformed_ = false;
+  // Outcome of the transform stage; anything but E::OK fails the append.
+  Status transform_status_ = E::OK;
   // Constructs an Appender after the message is received
   std::unique_ptr<Appender> constructAppender();
 
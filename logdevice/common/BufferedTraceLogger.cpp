@@ -0,0 +1,73 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/BufferedTraceLogger.h"
+
+#include "logdevice/common/ThreadID.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/stats/Stats.h"
+
+namespace facebook { namespace logdevice {
+
+BufferedTraceLogger::BufferedTraceLogger(
+    std::shared_ptr<TraceLogger> underlying,
+    const std::shared_ptr<UpdateableConfig> cluster_config,
+    const folly::Optional<NodeID>& my_node_id,
+    size_t queue_size,
+    StatsHolder* stats)
+    : TraceLogger(cluster_config, my_node_id),
+      underlying_(std::move(underlying)),
+      stats_(stats),
+      queue_(queue_size) {
+  ld_check(underlying_ != nullptr);
+  ld_check(queue_size > 0);
+  drain_thread_ = std::thread([this] { drainLoop(); });
+}
+
+BufferedTraceLogger::~BufferedTraceLogger() {
+  // Wake the draining thread with a shutdown marker. Samples still queued
+  // behind it are delivered first; samples pushed after it are dropped.
+  queue_.blockingWrite(Entry{std::string(), 0, nullptr});
+  drain_thread_.join();
+}
+
+void BufferedTraceLogger::pushSample(const std::string& table,
+                                     int32_t sample_rate,
+                                     std::unique_ptr<TraceSample> sample) {
+  if (sample == nullptr) {
+    return;
+  }
+  if (queue_.write(Entry{table, sample_rate, std::move(sample)})) {
+    STAT_INCR(stats_, trace_samples_buffered);
+  } else {
+    STAT_INCR(stats_, trace_samples_dropped);
+  }
+}
+
+folly::Optional<double>
+BufferedTraceLogger::getSamplePercentageForTracer(const std::string& tracer) {
+  return underlying_->getSamplePercentageForTracer(tracer);
+}
+
+double BufferedTraceLogger::getDefaultSamplePercentage() const {
+  return underlying_->getDefaultSamplePercentage();
+}
+
+void BufferedTraceLogger::drainLoop() {
+  ThreadID::set(ThreadID::Type::UTILITY, "ld:trace-drain");
+  while (true) {
+    Entry entry;
+    queue_.blockingRead(entry);
+    if (entry.sample == nullptr) {
+      break;
+    }
+    underlying_->pushSample(
+        entry.table, entry.sample_rate, std::move(entry.sample));
+  }
+}
+
+}} // namespace facebook::logdevice
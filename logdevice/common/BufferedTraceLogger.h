@@ -0,0 +1,69 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <memory>
+#include <thread>
+
+#include <folly/MPMCQueue.h>
+
+#include "logdevice/common/TraceLogger.h"
+#include "logdevice/common/TraceSample.h"
+#include "logdevice/common/configuration/UpdateableConfig.h"
+
+namespace facebook { namespace logdevice {
+
+class StatsHolder;
+
+/**
+ * A TraceLogger decorator that makes pushSample() non-blocking. Samples are
+ * written into a bounded lock-free queue and handed to the wrapped logger by
+ * a dedicated draining thread, so whatever serialization and publishing the
+ * underlying plugin does happens off the Worker threads. This allows much
+ * higher trace sampling rates than pushing through the plugin synchronously.
+ *
+ * If the queue is full the sample is dropped and trace_samples_dropped is
+ * bumped; tracing is best-effort and must never stall a Worker.
+ */
+class BufferedTraceLogger : public TraceLogger {
+ public:
+  BufferedTraceLogger(std::shared_ptr<TraceLogger> underlying,
+                      const std::shared_ptr<UpdateableConfig> cluster_config,
+                      const folly::Optional<NodeID>& my_node_id,
+                      size_t queue_size,
+                      StatsHolder* stats = nullptr);
+
+  ~BufferedTraceLogger() override;
+
+  // Thread safe, never blocks. Drops the sample if the queue is full.
+  void pushSample(const std::string& table,
+                  int32_t sample_rate,
+                  std::unique_ptr<TraceSample> sample) override;
+
+  folly::Optional<double>
+  getSamplePercentageForTracer(const std::string& tracer) override;
+
+  double getDefaultSamplePercentage() const override;
+
+ private:
+  struct Entry {
+    std::string table;
+    int32_t sample_rate;
+    // nullptr is the shutdown marker written by the destructor.
+    std::unique_ptr<TraceSample> sample;
+  };
+
+  void drainLoop();
+
+  const std::shared_ptr<TraceLogger> underlying_;
+  StatsHolder* const stats_;
+  folly::MPMCQueue<Entry> queue_;
+  std::thread drain_thread_;
+};
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,165 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include <folly/small_vector.h>
+
+#include "logdevice/common/CopySetManager.h"
+#include "logdevice/common/NodeSetState.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file CachingCopySetManager turns per-append copyset selection into an
+ *       array index in the common case. The underlying selector (typically
+ *       WeightedCopySetSelector, which re-walks its weighted domain tree on
+ *       every select()) is only consulted to fill a small cache of
+ *       precomputed copysets; appends then cycle through the cache
+ *       round-robin, with the usual shuffle applied per use so recipients
+ *       still see varied chain orders.
+ *
+ *       The cache is valid as long as the nodeset's health generation
+ *       (NodeSetState::healthGeneration(), bumped on any shard availability
+ *       transition: out-of-space, slow/graylisted, probing, boycotts) is
+ *       unchanged. Any transition invalidates the cache wholesale and the
+ *       next append repopulates it from the underlying selector, so
+ *       unavailable nodes stop appearing in copysets as quickly as they
+ *       would without the cache.
+ *
+ *       Not used for logs with sticky copysets (StickyCopySetManager
+ *       already amortizes selection over whole blocks).
+ *
+ *       All methods are called on the Worker that owns the log's sequencer,
+ *       so no synchronization is needed on the cache itself.
+ */
+
+class CachingCopySetManager : public CopySetManager {
+ public:
+  /**
+   * State only contains the underlying copyset selector's state.
+   */
+  class State : public CopySetManager::State {
+   public:
+    explicit State(std::unique_ptr<CopySetSelector::State> csss)
+        : css_state(std::move(csss)) {}
+
+    void reset() override {
+      if (css_state) {
+        css_state->reset();
+      }
+    }
+    std::unique_ptr<CopySetSelector::State> css_state;
+  };
+
+  CachingCopySetManager(std::unique_ptr<CopySetSelector> css,
+                        std::shared_ptr<NodeSetState> nodeset_state,
+                        size_t cache_size)
+      : CopySetManager(std::move(css), nodeset_state),
+        cache_size_(std::max<size_t>(cache_size, 1)) {
+    cache_.reserve(cache_size_);
+  }
+
+  CopySetSelector::Result
+  getCopySet(StoreChainLink copyset_out[],
+             copyset_size_t* copyset_size_out,
+             bool* chain_out,
+             const AppendContext& /*append_ctx*/,
+             folly::Optional<lsn_t>& block_starting_lsn_out,
+             CopySetManager::State& csm_state) override {
+    block_starting_lsn_out.reset();
+
+    const uint64_t gen = nodeset_state_->healthGeneration();
+    if (gen != cached_generation_) {
+      cache_.clear();
+      next_ = 0;
+      cached_generation_ = gen;
+    }
+
+    if (cache_.size() < cache_size_) {
+      // Cache still filling up (or just invalidated). Run the real selector
+      // and remember the result; copysets that came back with chaining
+      // disabled are kept out of the cache so a transient condition doesn't
+      // stick around for many appends.
+      State& state = checked_downcast<State&>(csm_state);
+      CopySetSelector::Result res = underlying_selector_->select(
+          copyset_out, copyset_size_out, chain_out, state.css_state.get());
+      if (res != CopySetSelector::Result::SUCCESS) {
+        return res;
+      }
+      if (chain_out == nullptr || *chain_out) {
+        cache_.emplace_back(
+            copyset_out, copyset_out + *copyset_size_out, chain_out != nullptr);
+      }
+      shuffleCopySet(
+          copyset_out, *copyset_size_out, chain_out ? *chain_out : false);
+      return res;
+    }
+
+    if (next_ >= cache_.size()) {
+      next_ = 0;
+    }
+    const CachedCopySet& cached = cache_[next_++];
+    std::copy(cached.copyset.begin(), cached.copyset.end(), copyset_out);
+    *copyset_size_out = cached.copyset.size();
+    if (chain_out) {
+      *chain_out = cached.chain;
+    }
+    shuffleCopySet(
+        copyset_out, *copyset_size_out, chain_out ? *chain_out : false);
+    return CopySetSelector::Result::SUCCESS;
+  }
+
+  CopySetSelector::Result
+  getCopysetUsingUnderlyingSelector(logid_t /*log_id*/,
+                                    StoreChainLink copyset_out[],
+                                    copyset_size_t* copyset_size_out) override {
+    return underlying_selector_->select(copyset_out, copyset_size_out);
+  }
+
+  CopySetSelector::Result augmentCopySet(StoreChainLink inout_copyset[],
+                                         copyset_size_t existing_copyset_size,
+                                         copyset_size_t* out_full_size,
+                                         bool fill_client_id = false,
+                                         bool* chain_out = nullptr) override {
+    // Augments are rare (rebuilding/recovery); bypass the cache.
+    return underlying_selector_->augment(inout_copyset,
+                                         existing_copyset_size,
+                                         out_full_size,
+                                         fill_client_id,
+                                         chain_out,
+                                         DefaultRNG::get(),
+                                         false);
+  }
+
+  std::unique_ptr<CopySetManager::State> createState() const override {
+    return std::make_unique<State>(underlying_selector_->createState());
+  }
+
+ private:
+  struct CachedCopySet {
+    CachedCopySet(const StoreChainLink* begin,
+                  const StoreChainLink* end,
+                  bool chain)
+        : copyset(begin, end), chain(chain) {}
+    copyset_chain_t copyset;
+    bool chain;
+  };
+
+  const size_t cache_size_;
+
+  // copysets computed under cached_generation_; cycled through round-robin
+  std::vector<CachedCopySet> cache_;
+  size_t next_ = 0;
+  uint64_t cached_generation_ = std::numeric_limits<uint64_t>::max();
+};
+
+}} // namespace facebook::logdevice
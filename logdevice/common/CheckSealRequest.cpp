@@ -7,6 +7,7 @@
  */
 #include "logdevice/common/CheckSealRequest.h"
 
+#include "logdevice/common/AllSequencers.h"
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/Sender.h"
 #include "logdevice/common/Worker.h"
@@ -192,6 +193,16 @@ void CheckSealRequest::onReply(ShardID from,
   } else if (replies_successful_ == copyset_.size()) {
     // If all nodes have replied successfully, finish request.
     // No retry will be sent to client
+    auto cache_ttl = Worker::settings().check_seal_cache_ttl;
+    if (cache_ttl.count() > 0) {
+      // Remember the all-clear result so that GET_SEQ_STATE messages
+      // arriving within the TTL can skip the CHECK_SEAL fan-out.
+      auto& seqmap = Worker::onThisThread()->processor_->allSequencers();
+      auto seq = seqmap.findSequencer(log_id_);
+      if (seq) {
+        seq->setSealsCheckedUntil(cache_ttl);
+      }
+    }
     gss_message_->continueExecution(from_);
     finalize();
   } else if (recvd_from_.size() == copyset_.size()) {
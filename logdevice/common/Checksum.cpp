@@ -9,6 +9,7 @@
 
 #include <folly/hash/Checksum.h>
 #include <folly/hash/Hash.h>
+#include <folly/io/IOBuf.h>
 
 namespace facebook { namespace logdevice {
 
@@ -21,6 +22,35 @@ uint64_t checksum_64bit(Slice slice) {
   return folly::hash::SpookyHashV2::Hash64(slice.data, slice.size, seed);
 }
 
+uint32_t checksum_32bit(const folly::IOBuf& chain) {
+  // folly::crc32c() (hardware-accelerated where available) takes the running
+  // checksum as its starting value, so feeding it the buffers one by one
+  // yields the CRC of the concatenated bytes.
+  uint32_t crc = ~0U;
+  for (const auto& buf : chain) {
+    if (!buf.empty()) {
+      crc = folly::crc32c(buf.data(), buf.size(), crc);
+    }
+  }
+  return crc;
+}
+
+uint64_t checksum_64bit(const folly::IOBuf& chain) {
+  // SpookyHash's incremental interface produces the same value as the
+  // one-shot Hash64() used above for contiguous buffers.
+  const uint64_t seed = 0x5715d9be01f6a3f8ULL; // must match checksum_64bit()
+  folly::hash::SpookyHashV2 state;
+  state.Init(seed, seed);
+  for (const auto& buf : chain) {
+    if (!buf.empty()) {
+      state.Update(buf.data(), buf.size());
+    }
+  }
+  uint64_t h1, h2;
+  state.Final(&h1, &h2);
+  return h1;
+}
+
 Slice checksum_bytes(Slice blob, int nbits, char* buf_out) {
   ld_check(nbits == 32 || nbits == 64);
   if (nbits == 64) {
@@ -9,6 +9,10 @@
 
 #include "logdevice/common/types_internal.h"
 
+namespace folly {
+class IOBuf;
+}
+
 namespace facebook { namespace logdevice {
 
 /**
@@ -39,6 +43,15 @@ namespace facebook { namespace logdevice {
 uint32_t checksum_32bit(Slice slice);
 uint64_t checksum_64bit(Slice slice);
 
+/**
+ * Same as above, but walk an IOBuf chain buffer by buffer instead of
+ * requiring contiguous memory, so chained buffers don't have to be
+ * linearized just to be checksummed. Produces the same value as the Slice
+ * versions would over the concatenated bytes.
+ */
+uint32_t checksum_32bit(const folly::IOBuf& chain);
+uint64_t checksum_64bit(const folly::IOBuf& chain);
+
 /**
  * Writes a binary checksum of the given blob to the given output buffer.  The
  * output buffer must be at least 8 bytes large to fit a 64-bit checksum.
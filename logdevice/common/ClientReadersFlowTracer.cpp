@@ -659,6 +659,33 @@ void ClientReadersFlowTracer::updateShouldTrack() {
   }
 }
 
+size_t ClientReadersFlowTracer::suggestWindowSize(size_t current,
+                                                  size_t max_records) {
+  // Convert the byte budget into a record cap using the observed average
+  // record size. Until we've seen enough traffic to estimate it, the only
+  // bound is the buffer capacity.
+  size_t limit = max_records;
+  if (speed_records_moving_avg_ >= 1.0 && speed_bytes_moving_avg_ > 0.0) {
+    const double avg_record_size =
+        speed_bytes_moving_avg_ / speed_records_moving_avg_;
+    const double budget = Worker::settings().client_read_window_max_bytes;
+    limit = std::min(
+        limit, std::max(size_t(1), static_cast<size_t>(budget / avg_record_size)));
+  }
+
+  size_t next;
+  if (redelivery_activations_ > 0) {
+    // The application has been rejecting records since the last window
+    // slide; reading further ahead only grows memory, not throughput.
+    next = std::max(size_t(1), current / 2);
+  } else {
+    // Delivery is smooth; probe for more readahead.
+    next = current + std::max(size_t(1), max_records / 8);
+  }
+  redelivery_activations_ = 0;
+  return std::min(next, limit);
+}
+
 void ClientReadersFlowTracer::onRedeliveryTimerInactive() {
   updateShouldTrack();
   if (tracer_ignoring_overload_) {
@@ -667,6 +694,7 @@ void ClientReadersFlowTracer::onRedeliveryTimerInactive() {
 }
 
 void ClientReadersFlowTracer::onRedeliveryTimerActive() {
+  ++redelivery_activations_;
   updateShouldTrack();
   if (tracer_ignoring_overload_) {
     tracer_ignoring_overload_->onRedeliveryTimerActive();
@@ -96,6 +96,20 @@ class ClientReadersFlowTracer : public SampledTracer {
   folly::Optional<std::chrono::milliseconds> estimateTimeLag() const;
   folly::Optional<int64_t> estimateByteLag() const;
 
+  /**
+   * Suggests a flow-control window size (in records) for the owning
+   * ClientReadStream; used when the client-adaptive-read-window setting is
+   * enabled. Probes for more readahead while delivery is smooth, cuts the
+   * window in half when the application has been rejecting records
+   * (redelivery timer activations since the last call), and converts
+   * client-read-window-max-bytes into a record cap using the observed
+   * average record size.
+   *
+   * @param current      window size used for the last window
+   * @param max_records  hard cap (the read buffer capacity)
+   */
+  size_t suggestWindowSize(size_t current, size_t max_records);
+
   void onSettingsUpdated();
   std::string lastReportedStatePretty() const;
   std::string lastTailInfoPretty() const;
@@ -133,6 +147,8 @@ class ClientReadersFlowTracer : public SampledTracer {
   Status last_sync_seq_request_result_{E::OK};
 
   size_t sample_counter_{0};
+  // Redelivery timer activations since the last suggestWindowSize() call.
+  size_t redelivery_activations_{0};
   size_t last_num_bytes_read_{0};
   size_t last_num_records_read_{0};
   bool should_track_{true};
@@ -146,12 +146,19 @@ void ClusterState::postUpdateToWorkers(node_index_t node_id, NodeState state) {
 void ClusterState::setNodeState(node_index_t idx,
                                 ClusterState::NodeState state) {
   ld_check(idx >= 0);
-  folly::SharedMutex::ReadHolder read_lock(mutex_);
-  auto node_state = node_state_map_.find(idx);
-  if (node_state == node_state_map_.end()) {
+  const auto states = node_states_.get();
+  if (static_cast<size_t>(idx) >= states->size()) {
     return;
   }
-  ClusterState::NodeState prev = node_state->second->exchange(state);
+  // Only replace the state byte of the packed word, leaving the health
+  // status untouched in case a concurrent setNodeStatus() races with us.
+  auto& entry = (*states)[idx];
+  PackedNodeState cur = entry.load();
+  PackedNodeState next;
+  do {
+    next = (cur & ~kNodeStateMask) | static_cast<PackedNodeState>(state);
+  } while (!entry.compare_exchange_weak(cur, next));
+  ClusterState::NodeState prev = unpackState(cur);
   if ((prev != state) && processor_) {
     if (!processor_->settings()->server) {
       // this is a client stats
@@ -169,12 +176,18 @@ void ClusterState::setNodeState(node_index_t idx,
 }
 void ClusterState::setNodeStatus(node_index_t idx, NodeHealthStatus status) {
   ld_check(idx >= 0);
-  folly::SharedMutex::ReadHolder read_lock(mutex_);
-  auto node_status = node_status_map_.find(idx);
-  if (node_status == node_status_map_.end()) {
+  const auto states = node_states_.get();
+  if (static_cast<size_t>(idx) >= states->size()) {
     return;
   }
-  NodeHealthStatus prev = node_status->second->exchange(status);
+  auto& entry = (*states)[idx];
+  PackedNodeState cur = entry.load();
+  PackedNodeState next;
+  do {
+    next = (cur & ~kNodeStatusMask) |
+        (static_cast<PackedNodeState>(status) << kNodeStatusShift);
+  } while (!entry.compare_exchange_weak(cur, next));
+  NodeHealthStatus prev = unpackStatus(cur);
   if ((prev != status) && processor_) {
     RATELIMIT_INFO(std::chrono::seconds(1),
                    10,
@@ -185,30 +198,62 @@ void ClusterState::setNodeStatus(node_index_t idx, NodeHealthStatus status) {
   }
 }
 
+uint8_t ClusterState::getShardQoS(node_index_t idx, shard_index_t shard) const {
+  ld_check(idx >= 0);
+  auto scores = shard_qos_scores_.rlock();
+  auto it = scores->find(idx);
+  if (it == scores->end() || static_cast<size_t>(shard) >= it->second.size()) {
+    // no scores published for this node/shard; assume fully healthy
+    return SHARD_QOS_MAX;
+  }
+  return it->second[shard];
+}
+
+void ClusterState::setShardQoS(node_index_t idx, std::vector<uint8_t> scores) {
+  ld_check(idx >= 0);
+  {
+    // don't grab the write lock if nothing changed; this is called on
+    // every gossip round for every node
+    auto current = shard_qos_scores_.rlock();
+    auto it = current->find(idx);
+    if (it == current->end() ? scores.empty() : it->second == scores) {
+      return;
+    }
+  }
+  auto locked = shard_qos_scores_.wlock();
+  if (scores.empty()) {
+    locked->erase(idx);
+  } else {
+    (*locked)[idx] = std::move(scores);
+  }
+}
+
 std::vector<std::pair<node_index_t, uint16_t>>
 ClusterState::getWholeClusterStatus() {
-  folly::SharedMutex::ReadHolder read_lock(mutex_);
+  const auto states = node_states_.get();
   std::vector<std::pair<node_index_t, uint16_t>> vector{};
-  for (auto& n : node_status_map_) {
-    vector.emplace_back(std::make_pair(n.first, n.second->load()));
+  vector.reserve(states->size());
+  // the array is indexed by node id, so the result is already sorted.
+  for (node_index_t nid = 0; nid < states->size(); ++nid) {
+    vector.emplace_back(nid, unpackStatus((*states)[nid].load()));
   }
-  std::sort(vector.begin(), vector.end());
   return vector;
 }
 
 std::vector<std::pair<node_index_t, uint16_t>>
 ClusterState::getWholeClusterState() {
-  folly::SharedMutex::ReadHolder read_lock(mutex_);
+  const auto states = node_states_.get();
   std::vector<std::pair<node_index_t, uint16_t>> vector{};
-  for (auto& n : node_state_map_) {
-    vector.emplace_back(std::make_pair(n.first, n.second->load()));
+  vector.reserve(states->size());
+  // the array is indexed by node id, so the result is already sorted.
+  for (node_index_t nid = 0; nid < states->size(); ++nid) {
+    vector.emplace_back(nid, unpackState((*states)[nid].load()));
   }
-  std::sort(vector.begin(), vector.end());
   return vector;
 }
 
 bool ClusterState::isClusterSeqHealthAboveThreshold() {
-  folly::SharedMutex::ReadHolder read_lock(mutex_);
+  const auto states = node_states_.get();
   auto sequencer_membership =
       Worker::onThisThread()->getNodesConfiguration()->getSequencerMembership();
   auto num_sequencers = sequencer_membership->numNodes();
@@ -217,9 +262,10 @@ bool ClusterState::isClusterSeqHealthAboveThreshold() {
         processor_->settings()->maximum_percent_unhealthy_seq_nodes *
         num_sequencers;
     auto num_unhealthy = 0;
-    for (auto& n : node_status_map_) {
-      if (n.second->load() == NodeHealthStatus::UNHEALTHY &&
-          sequencer_membership->hasNode(n.first)) {
+    for (node_index_t nid = 0; nid < states->size(); ++nid) {
+      if (unpackStatus((*states)[nid].load()) ==
+              NodeHealthStatus::UNHEALTHY &&
+          sequencer_membership->hasNode(nid)) {
         num_unhealthy++;
         if (num_unhealthy >= maximum_number_unhealthy) {
           return false;
@@ -315,18 +361,13 @@ void ClusterState::onGetClusterStateDone(
 void ClusterState::resizeClusterState(size_t new_size, bool notifySubscribers) {
   folly::SharedMutex::WriteHolder write_lock(mutex_);
   if (cluster_size_ != new_size) {
-    auto new_state_map = folly::F14FastMap<
-        node_index_t,
-        std::unique_ptr<std::atomic<ClusterState::NodeState>>>{};
-    auto new_status_map =
-        folly::F14FastMap<node_index_t,
-                          std::unique_ptr<std::atomic<NodeHealthStatus>>>{};
+    const auto old_states = node_states_.get();
+    auto new_states = std::make_shared<NodeStateArray>(new_size);
     bool have_failure_detector =
         processor_ && processor_->isFailureDetectorRunning();
-    for (int i = 0; i < new_size; i++) {
-      if (i < cluster_size_) {
-        new_state_map.insert({i, std::move(node_state_map_.at(i))});
-        new_status_map.insert({i, std::move(node_status_map_.at(i))});
+    for (size_t i = 0; i < new_size; i++) {
+      if (i < old_states->size()) {
+        (*new_states)[i].store((*old_states)[i].load());
       } else {
         /* If we have failure detector, mark new nodes as dead by default;
          * the failure detector will then change their state as needed.
@@ -336,16 +377,13 @@ void ClusterState::resizeClusterState(size_t new_size, bool notifySubscribers) {
          */
         auto state = have_failure_detector ? ClusterState::NodeState::DEAD
                                            : ClusterState::NodeState::UNKNOWN;
-        new_state_map.insert(
-            {i, std::make_unique<std::atomic<ClusterState::NodeState>>(state)});
         // If we have failure detector, mark new nodes as unhealthy by default;
         // FD will change their state as needed. Otherwise, treat nodes as
         // healthy by default. This maintains consistency with the way node
         // state is treated.
         auto status = have_failure_detector ? NodeHealthStatus::UNHEALTHY
                                             : NodeHealthStatus::HEALTHY;
-        new_status_map.insert(
-            {i, std::make_unique<std::atomic<NodeHealthStatus>>(status)});
+        (*new_states)[i].store(packNodeState(state, status));
         if (processor_ && notifySubscribers) {
           postUpdateToWorkers(i, state);
         }
@@ -354,8 +392,7 @@ void ClusterState::resizeClusterState(size_t new_size, bool notifySubscribers) {
     ld_info("Cluster state size updated from %lu to %lu",
             cluster_size_.load(),
             new_size);
-    node_state_map_.swap(new_state_map);
-    node_status_map_.swap(new_status_map);
+    node_states_.update(std::move(new_states));
     cluster_size_ = new_size;
   }
 }
@@ -364,10 +401,11 @@ void ClusterState::updateNodesInConfig(
     const configuration::nodes::ServiceDiscoveryConfig& sd_config) {
   folly::SharedMutex::WriteHolder write_lock(mutex_);
 
-  nodes_in_config_.clear();
+  auto nodes = std::make_shared<std::unordered_set<node_index_t>>();
   for (auto& node : sd_config) {
-    nodes_in_config_.insert(node.first);
+    nodes->insert(node.first);
   }
+  nodes_in_config_.update(std::move(nodes));
 }
 
 void ClusterState::noteConfigurationChanged() {
@@ -14,12 +14,14 @@
 #include <memory>
 #include <numeric>
 #include <set>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include <folly/Optional.h>
 #include <folly/SharedMutex.h>
-#include <folly/container/F14Map.h>
+#include <folly/Synchronized.h>
 
 #include "logdevice/common/NodeHealthStatus.h"
 #include "logdevice/common/NodeID.h"
@@ -101,8 +103,8 @@ class ClusterState {
   virtual ~ClusterState() {}
 
   inline bool isNodeInConfig(node_index_t idx) const {
-    folly::SharedMutex::ReadHolder read_lock(mutex_);
-    return nodes_in_config_.count(idx) > 0;
+    const auto nodes = nodes_in_config_.get();
+    return nodes->count(idx) > 0;
   }
 
   // defaultState is used if the stat of the node is UNKNOWN.
@@ -142,16 +144,16 @@ class ClusterState {
   NodeState
   getNodeState(node_index_t idx,
                NodeState defaultState = NodeState::FULLY_STARTED) const {
-    folly::SharedMutex::ReadHolder read_lock(mutex_);
-    // check the node list if the index falls within what we know
+    // check the node array if the index falls within what we know
     // otherwise fall back to considering the node dead. If the index is beyond
-    // the size of this list, it means this node is not yet in our configuration
-    // anyway.
+    // the size of this array, it means this node is not yet in our
+    // configuration anyway.
     ld_check(idx >= 0);
-    auto node_state = node_state_map_.find(idx);
-    auto state = node_state == node_state_map_.end()
-        ? NodeState::DEAD
-        : node_state->second->load();
+    const auto states = node_states_.get();
+    if (static_cast<size_t>(idx) >= states->size()) {
+      return NodeState::DEAD;
+    }
+    auto state = unpackState((*states)[idx].load());
 
     // We return the default supplied state if we don't know what is the state
     // yet.
@@ -162,15 +164,16 @@ class ClusterState {
   }
 
   NodeHealthStatus getNodeStatus(node_index_t idx) const {
-    folly::SharedMutex::ReadHolder read_lock(mutex_);
-    // check the node list if the index falls within what we know
+    // check the node array if the index falls within what we know
     // otherwise fall back to considering the node undefined. If the index is
-    // beyond the size of this list, it means this node is not yet in our
+    // beyond the size of this array, it means this node is not yet in our
     // configuration anyway.
     ld_check(idx >= 0);
-    auto node_status = node_status_map_.find(idx);
-    return node_status == node_status_map_.end() ? NodeHealthStatus::UNDEFINED
-                                                 : node_status->second->load();
+    const auto states = node_states_.get();
+    if (static_cast<size_t>(idx) >= states->size()) {
+      return NodeHealthStatus::UNDEFINED;
+    }
+    return unpackStatus((*states)[idx].load());
   }
 
   // Returns a vectorized representation of the hashmap containing the health
@@ -214,6 +217,24 @@ class ClusterState {
 
   void setNodeStatus(node_index_t idx, NodeHealthStatus status);
 
+  // Highest (fully healthy) per-shard storage QoS score.
+  static constexpr uint8_t SHARD_QOS_MAX = 100;
+
+  /**
+   * @return  per-shard storage QoS score of the given node, as published by
+   *          that node through gossip. 100 means fully healthy, 0 completely
+   *          degraded. Nodes (or shards) for which no scores were published
+   *          -- probing disabled, or an older server -- are reported as
+   *          fully healthy.
+   */
+  uint8_t getShardQoS(node_index_t idx, shard_index_t shard) const;
+
+  /**
+   * Replaces the per-shard storage QoS scores of the given node. An empty
+   * vector means the node stopped publishing scores.
+   */
+  void setShardQoS(node_index_t idx, std::vector<uint8_t> scores);
+
   /**
    * Asynchronously updates this ClusterState object.
    * Executes a GetClusterStateRequest.
@@ -254,9 +275,34 @@ class ClusterState {
   void waitForRefresh();
 
  private:
+  // Per-node state and health status, packed into one word so that readers
+  // can fetch both with a single atomic load and writers can update one
+  // field without disturbing the other. NodeState lives in the low byte,
+  // NodeHealthStatus in the second byte.
+  using PackedNodeState = uint32_t;
+  using NodeStateArray = std::vector<std::atomic<PackedNodeState>>;
+
+  static constexpr PackedNodeState kNodeStateMask = 0xff;
+  static constexpr int kNodeStatusShift = 8;
+  static constexpr PackedNodeState kNodeStatusMask = 0xff << kNodeStatusShift;
+
+  static PackedNodeState packNodeState(NodeState state,
+                                       NodeHealthStatus status) {
+    return static_cast<PackedNodeState>(state) |
+        (static_cast<PackedNodeState>(status) << kNodeStatusShift);
+  }
+
+  static NodeState unpackState(PackedNodeState packed) {
+    return static_cast<NodeState>(packed & kNodeStateMask);
+  }
+
+  static NodeHealthStatus unpackStatus(PackedNodeState packed) {
+    return static_cast<NodeHealthStatus>((packed & kNodeStatusMask) >>
+                                         kNodeStatusShift);
+  }
+
   size_t getClusterSize() {
-    folly::SharedMutex::ReadHolder read_lock(mutex_);
-    return cluster_size_;
+    return cluster_size_.load();
   }
 
   void resizeClusterState(size_t new_size, bool notifySubscribers);
@@ -265,11 +311,20 @@ class ClusterState {
 
   void notifyRefreshComplete();
 
+  // Serializes structural updates (resizing the node state array and
+  // replacing the set of nodes in config). Readers never take it: they work
+  // on a snapshot obtained from the FastUpdateableSharedPtrs below.
   folly::SharedMutex mutex_;
-  folly::F14FastMap<node_index_t, std::unique_ptr<std::atomic<NodeState>>>
-      node_state_map_{};
 
-  std::unordered_set<node_index_t> nodes_in_config_;
+  // Flat array indexed by node id of the packed per-node state words. The
+  // array itself is immutable in size; growing or shrinking the cluster
+  // publishes a fresh array, so a reader holding an old snapshot simply
+  // observes the old size.
+  FastUpdateableSharedPtr<NodeStateArray> node_states_{
+      std::make_shared<NodeStateArray>()};
+
+  FastUpdateableSharedPtr<std::unordered_set<node_index_t>> nodes_in_config_{
+      std::make_shared<std::unordered_set<node_index_t>>()};
   std::atomic<size_t> cluster_size_{0};
   std::atomic<std::chrono::steady_clock::duration> last_refresh_{
       std::chrono::steady_clock::duration::zero()};
@@ -277,13 +332,16 @@ class ClusterState {
   std::mutex cv_mutex_;
   std::condition_variable cv_;
 
+  // Per-shard storage QoS scores by node id. Unlike the packed per-node
+  // state words above, these are variable-length and are updated at gossip
+  // frequency at most, so a mutex-protected map is good enough.
+  folly::Synchronized<std::unordered_map<node_index_t, std::vector<uint8_t>>>
+      shard_qos_scores_;
+
   Processor* processor_;
   std::atomic<bool> shutdown_{false};
   folly::SharedMutex shutdown_mutex_;
   FastUpdateableSharedPtr<std::vector<node_index_t>> boycotted_nodes_{
       std::make_shared<std::vector<node_index_t>>()};
-  folly::F14FastMap<node_index_t,
-                    std::unique_ptr<std::atomic<NodeHealthStatus>>>
-      node_status_map_{};
 };
 }} // namespace facebook::logdevice
@@ -11,6 +11,7 @@
 
 #include "folly/Function.h"
 #include "logdevice/common/Request.h"
+#include "logdevice/common/RequestPool.h"
 #include "logdevice/common/RequestType.h"
 #include "logdevice/common/types_internal.h"
 #include "logdevice/include/Err.h"
@@ -30,7 +31,9 @@ namespace facebook { namespace logdevice {
  * uses folly::Function.
  */
 template <template <class...> class FunctionType, typename... Args>
-class CompletionRequestBase : public Request {
+class CompletionRequestBase
+    : public Request,
+      public PooledRequest<CompletionRequestBase<FunctionType, Args...>> {
  private:
   template <int...>
   struct seq {};
@@ -21,6 +21,7 @@
 #include <sys/ioctl.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <zstd.h>
 
 #include "logdevice/common/AdminCommandTable.h"
 #include "logdevice/common/BWAvailableCallback.h"
@@ -168,6 +169,7 @@ Connection::Connection(NodeID server_name,
       this, std::move(sock_adapter), conn_description_, deps_->getEvBase());
   sock_write_cb_ = SocketWriteCallback(proto_handler_.get());
   proto_handler_->getSentEvent()->attachCallback([this] { drainSendQueue(); });
+  maybeEnableZeroCopySends();
 }
 
 Connection::Connection(int fd,
@@ -227,6 +229,7 @@ Connection::Connection(int fd,
       this, std::move(sock_adapter), conn_description_, deps_->getEvBase());
   sock_write_cb_ = SocketWriteCallback(proto_handler_.get());
   proto_handler_->getSentEvent()->attachCallback([this] { drainSendQueue(); });
+  maybeEnableZeroCopySends();
   // Set the read callback.
   read_cb_.reset(new MessageReader(*proto_handler_, getProto()));
   proto_handler_->sock()->setReadCB(read_cb_.get());
@@ -236,6 +239,12 @@ Connection::~Connection() {
   auto g = folly::makeGuard(deps_->setupContextGuard());
   ld_debug("Destroying Socket %s", conn_description_.c_str());
   close(E::SHUTDOWN);
+  if (zstd_cctx_ != nullptr) {
+    ZSTD_freeCCtx(zstd_cctx_);
+  }
+  if (zstd_dctx_ != nullptr) {
+    ZSTD_freeDCtx(zstd_dctx_);
+  }
 }
 
 bool Connection::isNodeConnectionAddressOrGenerationOutdated() const {
@@ -753,6 +762,7 @@ void Connection::close(Status reason) {
   }
   sock_write_cb_.clear();
   sendChain_.reset();
+  prioritySendChain_.reset();
   sched_write_chain_.cancelTimeout();
   // Invoke closeNow to close the socket.
   proto_handler_->sock()->closeNow();
@@ -862,6 +872,12 @@ bool Connection::isChecksummingEnabled(MessageType msgtype) {
     return false;
   }
 
+  // TLS record MACs already protect this hop; the end-to-end payload
+  // checksum carried in records is verified regardless.
+  if (getSettings().checksumming_skip_ssl && isSSL()) {
+    return false;
+  }
+
   auto& msg_checksum_set = getSettings().checksumming_blacklisted_messages;
   return msg_checksum_set.find((char)msgtype) == msg_checksum_set.end();
 }
@@ -873,37 +889,151 @@ std::unique_ptr<folly::IOBuf> Connection::serializeMessage(const Message& msg) {
     close(err);
     return nullptr;
   }
-  return result;
+  return maybeCompressMessage(msg, std::move(result));
+}
+
+std::unique_ptr<folly::IOBuf>
+Connection::maybeCompressMessage(const Message& msg,
+                                 std::unique_ptr<folly::IOBuf> buf) {
+  if (!handshaken_ || !info_.protocol_compression ||
+      isHandshakeMessage(msg.type_) ||
+      getProto() < Compatibility::COMPRESSED_MESSAGE_SUPPORT) {
+    return buf;
+  }
+
+  const size_t orig_len = buf->computeChainDataLength();
+  if (orig_len < getSettings().protocol_compression_threshold) {
+    return buf;
+  }
+
+  if (zstd_cctx_ == nullptr) {
+    zstd_cctx_ = ZSTD_createCCtx();
+    if (zstd_cctx_ == nullptr) { // unlikely
+      return buf;
+    }
+  }
+
+  // zstd needs contiguous input, so chained buffers (e.g. RECORD messages
+  // referencing record payloads without copying them) get flattened here;
+  // we're trading that copy and the compression CPU for wire bytes.
+  const uint8_t* data = buf->coalesce().data();
+
+  const size_t bound = ZSTD_compressBound(orig_len);
+  auto out = folly::IOBuf::create(sizeof(ProtocolHeader) + bound);
+  out->advance(sizeof(ProtocolHeader));
+  const size_t csize =
+      ZSTD_compressCCtx(zstd_cctx_,
+                        out->writableTail(),
+                        bound,
+                        data,
+                        orig_len,
+                        getSettings().protocol_compression_zstd_level);
+  if (ZSTD_isError(csize) || sizeof(ProtocolHeader) + csize >= orig_len) {
+    // Compression failed or did not shrink the frame (already-compressed
+    // or high-entropy payloads); send the original.
+    return buf;
+  }
+  out->append(csize);
+
+  ProtocolHeader protohdr;
+  protohdr.len = sizeof(ProtocolHeader) + csize;
+  protohdr.type = MessageType::COMPRESSED;
+  // The wrapped message keeps its own checksum; it is verified after
+  // decompression on the peer, covering this hop end to end.
+  protohdr.cksum = 0;
+  out->prepend(sizeof(ProtocolHeader));
+  memcpy(
+      static_cast<void*>(out->writableData()), &protohdr, sizeof(ProtocolHeader));
+
+  STAT_INCR(deps_->getStats(), protocol_messages_compressed);
+  STAT_ADD(deps_->getStats(),
+           protocol_compression_bytes_saved,
+           orig_len - (sizeof(ProtocolHeader) + csize));
+  return out;
 }
 
 Connection::SendStatus
-Connection::sendBuffer(std::unique_ptr<folly::IOBuf>&& io_buf) {
+Connection::sendBuffer(std::unique_ptr<folly::IOBuf>&& io_buf,
+                       Priority priority) {
   if (proto_handler_->good()) {
-    if (sendChain_) {
+    // Latency-critical messages (priority CLIENT_HIGH and above, e.g.
+    // APPENDED/STORED acks and recovery traffic) are staged in a separate
+    // lane that is flushed ahead of bulk traffic buffered in the same tick.
+    const bool hipri = priority <= Priority::CLIENT_HIGH;
+    auto& chain = hipri ? prioritySendChain_ : sendChain_;
+    if (chain) {
       ld_check(sched_write_chain_.isScheduled());
-      sendChain_->prependChain(std::move(io_buf));
+      folly::IOBuf* tail = chain->prev();
+      if (!io_buf->isChained() && !tail->isSharedOne() &&
+          io_buf->length() <= tail->tailroom()) {
+        // Pack small messages into the spare capacity of the chain's tail
+        // buffer instead of growing the chain. This keeps the number of
+        // iovecs per flush (and the number of buffers the socket has to walk)
+        // proportional to bytes sent rather than messages sent. Zero-copy
+        // buffers are shared and are left chained as-is.
+        memcpy(tail->writableTail(), io_buf->data(), io_buf->length());
+        tail->append(io_buf->length());
+        STAT_INCR(deps_->getStats(), sock_messages_coalesced);
+      } else {
+        chain->prependChain(std::move(io_buf));
+      }
     } else {
-      sendChain_ = std::move(io_buf);
-      ld_check(!sched_write_chain_.isScheduled());
-      sched_write_chain_.attachCallback([this]() { scheduleWriteChain(); });
-      sched_write_chain_.scheduleTimeout(
-          getSettings().socket_batching_time_trigger);
-      sched_start_time_ = SteadyTimestamp::now();
+      chain = std::move(io_buf);
+      (hipri ? hipri_sched_start_time_ : sched_start_time_) =
+          SteadyTimestamp::now();
+      if (!sched_write_chain_.isScheduled()) {
+        sched_write_chain_.attachCallback([this]() { scheduleWriteChain(); });
+        sched_write_chain_.scheduleTimeout(
+            getSettings().socket_batching_time_trigger);
+      }
     }
   }
   return Connection::SendStatus::SCHEDULED;
 }
 
+void Connection::maybeEnableZeroCopySends() {
+  const size_t threshold = getSettings().tcp_zero_copy_threshold;
+  if (threshold == 0 || info_.connection_type == ConnectionType::SSL) {
+    // TLS re-encrypts the payload into fresh buffers before it hits the
+    // socket, so pinning the plaintext chain would not save the copy.
+    return;
+  }
+  // For sockets that have not connected yet this returns false, but the
+  // request is remembered and SO_ZEROCOPY is applied once the fd exists.
+  // The enable func is installed regardless: if the kernel ends up
+  // rejecting SO_ZEROCOPY, writes simply stay on the copying path.
+  proto_handler_->sock()->setZeroCopy(true);
+  proto_handler_->sock()->setZeroCopyEnableFunc(
+      [threshold](const std::unique_ptr<folly::IOBuf>& chain) {
+        return chain->computeChainDataLength() >= threshold;
+      });
+}
+
 void Connection::scheduleWriteChain() {
   auto g = folly::makeGuard(deps_->setupContextGuard());
   if (!proto_handler_->good()) {
     return;
   }
-  ld_check(sendChain_);
+  ld_check(sendChain_ || prioritySendChain_);
   auto now = SteadyTimestamp::now();
-  STAT_ADD(deps_->getStats(),
-           sock_write_sched_delay,
-           to_msec(now - sched_start_time_).count());
+  if (prioritySendChain_) {
+    STAT_ADD(deps_->getStats(),
+             sock_write_sched_delay_hipri,
+             to_msec(now - hipri_sched_start_time_).count());
+  }
+  if (sendChain_) {
+    STAT_ADD(deps_->getStats(),
+             sock_write_sched_delay,
+             to_msec(now - sched_start_time_).count());
+  }
+  if (prioritySendChain_) {
+    // Drain the high-priority lane first so that latency-critical messages
+    // go out ahead of any bulk traffic staged in the same tick.
+    if (sendChain_) {
+      prioritySendChain_->prependChain(std::move(sendChain_));
+    }
+    sendChain_ = std::move(prioritySendChain_);
+  }
 
   // Get bytes that are added to sendq but not yet added in the asyncSocket.
   auto bytes_in_sendq = getBufferedBytesSize() - sock_write_cb_.bytes_buffered;
@@ -930,7 +1060,8 @@ int Connection::serializeMessage(std::unique_ptr<Envelope>&& envelope) {
   }
 
   const auto msglen = serialized_buf->computeChainDataLength();
-  Connection::SendStatus status = sendBuffer(std::move(serialized_buf));
+  Connection::SendStatus status =
+      sendBuffer(std::move(serialized_buf), msg.priority());
   if (status == Connection::SendStatus::ERROR) {
     RATELIMIT_CRITICAL(std::chrono::seconds(1),
                        2,
@@ -1267,7 +1398,7 @@ void Connection::drainSendQueue() {
   // Check if all buffers were drained here if that is the case close the
   // connection.
   if (close_reason_ != E::UNKNOWN && cb.write_chains.size() == 0 &&
-      !sendChain_) {
+      !sendChain_ && !prioritySendChain_) {
     close(close_reason_);
   }
 }
@@ -1404,6 +1535,11 @@ int Connection::dispatchMessageBody(ProtocolHeader header,
                                     std::unique_ptr<folly::IOBuf> inbuf) {
   auto g = folly::makeGuard(deps_->setupContextGuard());
   ProtocolHeader& ph = header;
+
+  if (ph.type == MessageType::COMPRESSED) {
+    // Transport-level wrapper; unwrap it and dispatch the message inside.
+    return dispatchCompressedMessage(ph, std::move(inbuf));
+  }
   // Tell the Worker that we're processing a message, so it can time it.
   // The time will include message's deserialization, checksumming,
   // onReceived, destructor and Socket's processing overhead.
@@ -1434,8 +1570,11 @@ int Connection::dispatchMessageBody(ProtocolHeader header,
     ld_check(!retry_receipt_of_message_.isScheduled());
     retry_receipt_of_message_.attachCallback(
         [this, hdr = header, payload = std::move(inbuf)]() mutable {
+          // Deliver the messages the reader parsed behind this one before
+          // resuming reads, so they are not reordered with new data.
           if (proto_handler_->dispatchMessageBody(hdr, std::move(payload)) ==
-              0) {
+                  0 &&
+              read_cb_->drainPendingMessages() == 0) {
             proto_handler_->sock()->setReadCB(read_cb_.get());
           }
         });
@@ -1573,6 +1712,87 @@ int Connection::dispatchMessageBody(ProtocolHeader header,
   return 0;
 }
 
+int Connection::dispatchCompressedMessage(const ProtocolHeader& ph,
+                                          std::unique_ptr<folly::IOBuf> inbuf) {
+  // `inbuf` holds one zstd frame wrapping a complete serialized message,
+  // inner ProtocolHeader included (see maybeCompressMessage()).
+  const size_t min_protohdr_bytes =
+      sizeof(ProtocolHeader) - sizeof(ProtocolHeader::cksum);
+
+  auto compressed = inbuf->coalesce();
+  const unsigned long long content_size =
+      ZSTD_getFrameContentSize(compressed.data(), compressed.size());
+  if (content_size == ZSTD_CONTENTSIZE_ERROR ||
+      content_size == ZSTD_CONTENTSIZE_UNKNOWN ||
+      content_size <= min_protohdr_bytes ||
+      content_size > Message::MAX_LEN + sizeof(ProtocolHeader)) {
+    RATELIMIT_ERROR(std::chrono::seconds(1),
+                    2,
+                    "PROTOCOL ERROR: got a COMPRESSED message with invalid "
+                    "content size %llu from peer %s",
+                    content_size,
+                    conn_description_.c_str());
+    err = E::BADMSG;
+    return -1;
+  }
+
+  if (zstd_dctx_ == nullptr) {
+    zstd_dctx_ = ZSTD_createDCtx();
+    if (zstd_dctx_ == nullptr) { // unlikely
+      err = E::NOMEM;
+      return -1;
+    }
+  }
+
+  auto out = folly::IOBuf::create(content_size);
+  const size_t dsize = ZSTD_decompressDCtx(zstd_dctx_,
+                                           out->writableTail(),
+                                           content_size,
+                                           compressed.data(),
+                                           compressed.size());
+  if (ZSTD_isError(dsize) || dsize != content_size) {
+    RATELIMIT_ERROR(std::chrono::seconds(1),
+                    2,
+                    "PROTOCOL ERROR: failed to decompress a COMPRESSED "
+                    "message from peer %s: %s",
+                    conn_description_.c_str(),
+                    ZSTD_isError(dsize) ? ZSTD_getErrorName(dsize)
+                                        : "truncated frame");
+    err = E::BADMSG;
+    return -1;
+  }
+  out->append(dsize);
+
+  ProtocolHeader inner_ph;
+  memcpy(&inner_ph, out->data(), min_protohdr_bytes);
+  const size_t protohdr_bytes =
+      ProtocolHeader::bytesNeeded(inner_ph.type, getProto());
+  if (inner_ph.type == MessageType::COMPRESSED ||
+      isHandshakeMessage(inner_ph.type) || inner_ph.len != dsize ||
+      protohdr_bytes > dsize) {
+    RATELIMIT_ERROR(std::chrono::seconds(1),
+                    2,
+                    "PROTOCOL ERROR: COMPRESSED message from peer %s wraps an "
+                    "invalid message of type %s and length %u (frame size "
+                    "%zu)",
+                    conn_description_.c_str(),
+                    messageTypeNames()[inner_ph.type].c_str(),
+                    inner_ph.len,
+                    dsize);
+    err = E::BADMSG;
+    return -1;
+  }
+  if (protohdr_bytes == sizeof(ProtocolHeader)) {
+    // Pick up the checksum field so the wrapped message's checksum is
+    // verified by the regular path after decompression.
+    memcpy(&inner_ph, out->data(), sizeof(ProtocolHeader));
+  }
+  out->trimStart(protohdr_bytes);
+
+  STAT_INCR(deps_->getStats(), protocol_messages_decompressed);
+  return dispatchMessageBody(inner_ph, std::move(out));
+}
+
 int Connection::pushOnCloseCallback(SocketCallback& cb) {
   if (cb.active()) {
     RATELIMIT_CRITICAL(
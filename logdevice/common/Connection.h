@@ -35,6 +35,7 @@ namespace facebook { namespace logdevice {
 
 class BWAvailableCallback;
 class FlowGroup;
+class MessageReader;
 class ProtocolHandler;
 class SocketAdapter;
 class SocketCallback;
@@ -586,10 +587,13 @@ class Connection : public TrafficShappingSocket {
     ERROR, // Hit errors when writing the bytes.
   };
   /**
-   * Writes a serialized buffer into the socket.
+   * Writes a serialized buffer into the socket. Buffers of priority
+   * CLIENT_HIGH and above are staged in a separate lane that is flushed
+   * ahead of lower-priority traffic.
    * @returns SendStatus based on the status of the write.
    */
-  SendStatus sendBuffer(std::unique_ptr<folly::IOBuf>&& buffer_chain);
+  SendStatus sendBuffer(std::unique_ptr<folly::IOBuf>&& buffer_chain,
+                        Priority priority);
   /**
    * For asyncsocket based connections, to batch data better we schedule a zero
    * timeout event in sendBuffer. It allows to batch all the data going to same
@@ -683,6 +687,31 @@ class Connection : public TrafficShappingSocket {
    */
   std::unique_ptr<folly::IOBuf> serializeMessage(const Message& msg);
 
+  /**
+   * Wraps a serialized message in a zstd-compressed COMPRESSED frame if the
+   * peer negotiated compression during handshake (see
+   * ConnectionInfo::protocol_compression) and compressing actually shrinks
+   * the frame. Returns the buffer unchanged otherwise.
+   */
+  std::unique_ptr<folly::IOBuf>
+  maybeCompressMessage(const Message& msg, std::unique_ptr<folly::IOBuf> buf);
+
+  /**
+   * Turns on MSG_ZEROCOPY sends for write chains above
+   * tcp-zero-copy-threshold bytes if the setting is nonzero and the
+   * transport supports it. Called once after the SocketAdapter is handed to
+   * the ProtocolHandler. No-op on SSL connections, where the payload is
+   * re-encrypted into fresh buffers anyway.
+   */
+  void maybeEnableZeroCopySends();
+
+  /**
+   * Unwraps a received COMPRESSED frame and dispatches the message inside
+   * it through dispatchMessageBody().
+   */
+  int dispatchCompressedMessage(const ProtocolHeader& ph,
+                                std::unique_ptr<folly::IOBuf> inbuf);
+
   /**
    * Invoked by connect() to initiate the connection to peer.
    * Returns Future that is fulfilled once the connection completes.
@@ -944,7 +973,7 @@ class Connection : public TrafficShappingSocket {
 
   // Read callback installed in AsyncSocket to read data and pass it to higher
   // layers.
-  std::unique_ptr<folly::AsyncSocket::ReadCallback> read_cb_;
+  std::unique_ptr<MessageReader> read_cb_;
 
   // If receive of a message hit ENOBUFS then we will retry the same message
   // again till it succeeds. This will all stop reading more messages from the
@@ -959,6 +988,12 @@ class Connection : public TrafficShappingSocket {
   // not invoke computeChainDataLength on it frequently.
   std::unique_ptr<folly::IOBuf> sendChain_;
 
+  // Same as sendChain_ but for latency-critical messages (priority
+  // CLIENT_HIGH and above, e.g. APPENDED/STORED acks and recovery traffic).
+  // Drained ahead of sendChain_ at each flush so that acks don't queue
+  // behind bulk RECORD traffic staged in the same tick.
+  std::unique_ptr<folly::IOBuf> prioritySendChain_;
+
   // Timer used to schedule event as soon as data is added to sendChain_.The
   // callback of this timer add data into the asyncsocket.
   EvTimer sched_write_chain_;
@@ -966,6 +1001,9 @@ class Connection : public TrafficShappingSocket {
   // Used to note down delays in writing into the asyncsocket.
   SteadyTimestamp sched_start_time_;
 
+  // Same as sched_start_time_ for the high-priority lane.
+  SteadyTimestamp hipri_sched_start_time_;
+
   // Momemnt of last activity happened on this connection such as
   // - connection created
   // - message sent
@@ -996,6 +1034,13 @@ class Connection : public TrafficShappingSocket {
   // for them.
   const uint16_t pre_handshake_proto_;
 
+  // Per-connection zstd contexts for COMPRESSED protocol frames. Created
+  // lazily on first use, reused across messages to amortize their allocation
+  // cost, and freed in the destructor. nullptr until compression is actually
+  // exercised on this connection.
+  struct ZSTD_CCtx_s* zstd_cctx_{nullptr};
+  struct ZSTD_DCtx_s* zstd_dctx_{nullptr};
+
   friend class ConnectionTest;
 };
 
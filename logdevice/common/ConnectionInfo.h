@@ -89,6 +89,13 @@ struct ConnectionInfo {
    */
   folly::Optional<ClientID> our_name_at_peer = folly::none;
 
+  /**
+   * True once both ends of a handshaken connection agreed (via
+   * HELLO_Header::ZSTD_COMPRESSION and ACK_Header::OPT_ZSTD_COMPRESSION) to
+   * wrap large messages in zstd-compressed COMPRESSED frames.
+   */
+  bool protocol_compression = false;
+
   /**
    * Node location of peer end point if known. Before handshake and for outgoing
    * connections this field is guaranteed to be folly::none.
@@ -7,14 +7,21 @@
  */
 #pragma once
 
+#include <cstdint>
+#include <limits>
+
 #include <folly/small_vector.h>
 
 #include "logdevice/common/ClientID.h"
 #include "logdevice/common/ShardID.h"
+#include "logdevice/common/types_internal.h"
 
 namespace facebook { namespace logdevice {
 
-constexpr size_t COPYSET_INLINE_DEFAULT = 6;
+// Copysets bigger than this spill to the heap. Sized to cover every
+// replication factor we run in practice, so the whole store pipeline
+// (Appender, STORE_Message, rebuilding records) works on inline arrays.
+constexpr size_t COPYSET_INLINE_DEFAULT = 8;
 
 // a StoreChainLink describes one link in a message delivery chain
 struct StoreChainLink {
@@ -36,17 +43,24 @@ struct StoreChainLink {
   }
 };
 
+// A copyset can never exceed COPYSET_SIZE_MAX entries, so a one-byte size
+// field is enough; this shrinks every copyset-carrying structure compared
+// to small_vector's default word-sized bookkeeping.
+static_assert(COPYSET_SIZE_MAX <= std::numeric_limits<uint8_t>::max(),
+              "copyset sizes must fit in the inline uint8_t size field");
+
 /**
  * In-memory representation of a copyset. Uses a folly::small_vector with a
- * customizable number of inlined elements.
+ * customizable number of inlined elements and a one-byte size field.
  *
  * @tparam inline_  Number of elements to store inline.
  */
 template <size_t inline_ = COPYSET_INLINE_DEFAULT>
-using copyset_custsz_t = folly::small_vector<ShardID, inline_>;
+using copyset_custsz_t = folly::small_vector<ShardID, inline_, uint8_t>;
 
 template <size_t inline_ = COPYSET_INLINE_DEFAULT>
-using copyset_chain_custsz_t = folly::small_vector<StoreChainLink, inline_>;
+using copyset_chain_custsz_t =
+    folly::small_vector<StoreChainLink, inline_, uint8_t>;
 
 /**
  * In-memory representation of a copyset with default number of elements
@@ -0,0 +1,80 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <folly/container/EvictingCacheMap.h>
+
+#include "logdevice/include/types.h"
+
+/**
+ * @file Per-Worker cache of the weighted failure domain hierarchies built
+ *       by WeightedCopySetSelector. A new selector is created for a log
+ *       whenever its epoch metadata or the cluster config changes, and it
+ *       used to rebuild its hierarchy from scratch each time; during a
+ *       config-change storm that's one rebuild per log owned by the
+ *       Worker. With the cache, a rebuilt selector for the same log shares
+ *       the previous selector's (immutable) hierarchy if nothing relevant
+ *       changed, or derives a new version from it by adjusting only the
+ *       affected domain paths if just some weights changed.
+ *
+ *       The hierarchy is stored type-erased so that Worker and this cache
+ *       don't need to know about WeightedCopySetSelector's internals; the
+ *       selector validates an entry by comparing the topology fingerprint
+ *       and weights it recorded, so stale entries are harmless and no
+ *       invalidation hooks are needed.
+ *
+ *       Only accessed from the owning Worker, so no locking.
+ */
+
+namespace facebook { namespace logdevice {
+
+class CopySetHierarchyCache {
+ public:
+  struct Entry {
+    // The latest hierarchy built for this log, shared with the selectors
+    // referencing it. Immutable once published; re-weighting replaces the
+    // pointer with a new copy (copy-on-write).
+    std::shared_ptr<const void> hierarchy;
+    // Everything other than the weights that determined the shape of the
+    // hierarchy, serialized by the selector.
+    std::string topology;
+    // The weights the hierarchy was built with, in nodeset order. Compared
+    // against the new weights to find the nodes whose domain paths need
+    // adjusting.
+    std::vector<double> weights;
+    // Number of incremental re-weights since the last full build; used to
+    // bound the numerical error they accumulate.
+    int reweights{0};
+  };
+
+  // Returns the entry for this log, or nullptr if there is none. The
+  // returned pointer is valid until the next put() or find().
+  Entry* find(logid_t logid) {
+    auto it = cache_.find(logid);
+    return it != cache_.end() ? &it->second : nullptr;
+  }
+
+  void put(logid_t logid, Entry entry) {
+    cache_.set(logid, std::move(entry));
+  }
+
+ private:
+  // Bounds the number of cached entries. Entries are a few hundred bytes
+  // plus one shared hierarchy per log (which the live selector holds
+  // anyway), so memory stays modest even on sequencer nodes with many
+  // logs; logs beyond the capacity just rebuild as before.
+  static constexpr size_t kCapacity = 10000;
+
+  folly::EvictingCacheMap<logid_t, Entry, logid_t::Hash> cache_{kCapacity};
+};
+
+}} // namespace facebook::logdevice
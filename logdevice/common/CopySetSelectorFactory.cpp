@@ -7,6 +7,7 @@
  */
 #include "logdevice/common/CopySetSelectorFactory.h"
 
+#include "logdevice/common/CachingCopySetManager.h"
 #include "logdevice/common/CrossDomainCopySetSelector.h"
 #include "logdevice/common/LinearCopySetSelector.h"
 #include "logdevice/common/MetaDataLog.h"
@@ -119,6 +120,11 @@ std::unique_ptr<CopySetManager> CopySetSelectorFactory::createManager(
                                  nodeset_state,
                                  sticky_copysets_block_size,
                                  sticky_copysets_block_max_time));
+  } else if (settings.copyset_cache_size > 0) {
+    res = std::unique_ptr<CopySetManager>(
+        new CachingCopySetManager(std::move(copyset_selector),
+                                  nodeset_state,
+                                  settings.copyset_cache_size));
   } else {
     res = std::unique_ptr<CopySetManager>(new PassThroughCopySetManager(
         std::move(copyset_selector), nodeset_state));
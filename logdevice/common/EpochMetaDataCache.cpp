@@ -7,8 +7,38 @@
  */
 #include "logdevice/common/EpochMetaDataCache.h"
 
+#include <cstdio>
+#include <cstring>
+
+#include <folly/FileUtil.h>
+
+#include "logdevice/common/configuration/nodes/NodesConfiguration.h"
+
 namespace facebook { namespace logdevice {
 
+namespace {
+
+// header of the snapshot blob produced by toSnapshotBlob()
+constexpr uint32_t SNAPSHOT_MAGIC = 0x454d4443; // "EMDC"
+constexpr uint32_t SNAPSHOT_FORMAT_VERSION = 1;
+
+template <typename T>
+void appendRaw(std::string& out, const T& val) {
+  out.append(reinterpret_cast<const char*>(&val), sizeof(val));
+}
+
+template <typename T>
+bool readRaw(const std::string& blob, size_t& offset, T* val_out) {
+  if (blob.size() - offset < sizeof(T)) {
+    return false;
+  }
+  memcpy(val_out, blob.data() + offset, sizeof(T));
+  offset += sizeof(T);
+  return true;
+}
+
+} // namespace
+
 EpochMetaDataCache::EpochMetaDataCache(size_t max_entries)
     : cache_(max_entries) {
   ld_check(max_entries > 0);
@@ -97,4 +127,105 @@ void EpochMetaDataCache::setMetaData(logid_t logid,
   cache_.set(std::make_pair(logid, epoch), {until, source, metadata});
 }
 
+std::string EpochMetaDataCache::toSnapshotBlob() const {
+  folly::SharedMutex::ReadHolder read_guard(cache_mutex_);
+  std::string blob;
+  appendRaw(blob, SNAPSHOT_MAGIC);
+  appendRaw(blob, SNAPSHOT_FORMAT_VERSION);
+  uint64_t num_entries = 0;
+  const size_t num_entries_offset = blob.size();
+  appendRaw(blob, num_entries);
+
+  for (const auto& entry : cache_) {
+    std::string metadata_blob = entry.second.metadata.toStringPayload();
+    if (metadata_blob.empty()) {
+      // e.g., invalid metadata; skip the entry rather than fail the snapshot
+      continue;
+    }
+    appendRaw(blob, entry.first.first.val_);  // logid
+    appendRaw(blob, entry.first.second.val_); // epoch
+    appendRaw(blob, entry.second.until.val_);
+    appendRaw(blob, static_cast<uint32_t>(metadata_blob.size()));
+    blob += metadata_blob;
+    ++num_entries;
+  }
+
+  memcpy(&blob[num_entries_offset], &num_entries, sizeof(num_entries));
+  return blob;
+}
+
+int EpochMetaDataCache::restoreFromSnapshotBlob(
+    const std::string& blob,
+    const configuration::nodes::NodesConfiguration& cfg) {
+  size_t offset = 0;
+  uint32_t magic, version;
+  uint64_t num_entries;
+  if (!readRaw(blob, offset, &magic) || magic != SNAPSHOT_MAGIC ||
+      !readRaw(blob, offset, &version) || version != SNAPSHOT_FORMAT_VERSION ||
+      !readRaw(blob, offset, &num_entries)) {
+    err = E::BADMSG;
+    return -1;
+  }
+
+  int restored = 0;
+  for (uint64_t i = 0; i < num_entries; ++i) {
+    logid_t::raw_type logid_raw;
+    epoch_t::raw_type epoch_raw, until_raw;
+    uint32_t metadata_size;
+    if (!readRaw(blob, offset, &logid_raw) ||
+        !readRaw(blob, offset, &epoch_raw) ||
+        !readRaw(blob, offset, &until_raw) ||
+        !readRaw(blob, offset, &metadata_size) ||
+        blob.size() - offset < metadata_size) {
+      err = E::BADMSG;
+      return -1;
+    }
+
+    EpochMetaData metadata;
+    int rv = metadata.fromPayload(
+        Payload(blob.data() + offset, metadata_size), logid_t(logid_raw), cfg);
+    offset += metadata_size;
+    if (rv != 0 || !metadata.isValid()) {
+      // skip entries that no longer validate (e.g., against a newer nodes
+      // configuration) instead of discarding the whole snapshot
+      continue;
+    }
+
+    // restored entries are always demoted to CACHED_SOFT; see docblock
+    setMetaData(logid_t(logid_raw),
+                epoch_t(epoch_raw),
+                epoch_t(until_raw),
+                RecordSource::CACHED_SOFT,
+                metadata);
+    ++restored;
+  }
+
+  return restored;
+}
+
+int EpochMetaDataCache::persistToFile(const std::string& path) const {
+  const std::string blob = toSnapshotBlob();
+  const std::string tmp_path = path + ".tmp";
+  if (!folly::writeFile(blob, tmp_path.c_str())) {
+    err = E::FAILED;
+    return -1;
+  }
+  if (rename(tmp_path.c_str(), path.c_str()) != 0) {
+    err = E::FAILED;
+    return -1;
+  }
+  return 0;
+}
+
+int EpochMetaDataCache::restoreFromFile(
+    const std::string& path,
+    const configuration::nodes::NodesConfiguration& cfg) {
+  std::string blob;
+  if (!folly::readFile(path.c_str(), blob)) {
+    err = E::NOTFOUND;
+    return -1;
+  }
+  return restoreFromSnapshotBlob(blob, cfg);
+}
+
 }} // namespace facebook::logdevice
@@ -80,6 +80,41 @@ class EpochMetaDataCache : boost::noncopyable {
                    RecordSource source,
                    const EpochMetaData& metadata);
 
+  /**
+   * Serializes the current contents of the cache into a binary snapshot
+   * (versioned header followed by one record per entry) that can later be
+   * restored with restoreFromSnapshotBlob(). Entries whose metadata fails to
+   * serialize are skipped.
+   */
+  std::string toSnapshotBlob() const;
+
+  /**
+   * Re-populates the cache from a snapshot produced by toSnapshotBlob().
+   * All restored entries are inserted with RecordSource::CACHED_SOFT: epoch
+   * metadata records are immutable once written to the metadata log, but a
+   * snapshot can not know whether an entry was still the tail when the
+   * process came back up, so consumers that need consistent/last information
+   * will verify against the metadata log as they already do for soft
+   * entries. Entries that fail validation are skipped.
+   *
+   * @return  number of entries restored, or -1 with err set to E::BADMSG if
+   *          the blob is malformed or has an unknown format version.
+   */
+  int restoreFromSnapshotBlob(
+      const std::string& blob,
+      const configuration::nodes::NodesConfiguration& cfg);
+
+  /**
+   * Convenience wrappers around the snapshot blob that write to / read from
+   * a file on local disk. persistToFile() writes to a temporary file first
+   * and renames it into place. Both return 0 on success and -1 on failure
+   * (with err set; persistToFile sets E::FAILED on I/O errors,
+   * restoreFromFile sets E::NOTFOUND if the file can not be read).
+   */
+  int persistToFile(const std::string& path) const;
+  int restoreFromFile(const std::string& path,
+                      const configuration::nodes::NodesConfiguration& cfg);
+
  private:
   using Key = std::pair<logid_t, epoch_t>;
 
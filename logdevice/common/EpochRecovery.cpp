@@ -102,6 +102,7 @@ bool EpochRecovery::onSealed(ShardID from,
   // starts.
   lng_ = std::max(lng_, lng);
   max_seen_esn_ = std::max(max_seen_esn_, max_seen_esn);
+  trimDigestBelowLng();
 
   if (epoch_size.isValid()) {
     epoch_size_map_.max(epoch_size);
@@ -256,6 +257,14 @@ void EpochRecovery::onDigestRecord(ShardID from,
     return;
   }
 
+  if (lng_ != ESN_INVALID && lsn_to_esn(lsn) < lng_) {
+    // The consensus LNG moved past this record after its digest stream
+    // started. The entry would be trimmed before mutations anyway; drop it
+    // now so its payload isn't buffered while slower digest streams finish.
+    STAT_INCR(deps_->getStats(), epoch_recovery_digest_below_lng);
+    return;
+  }
+
   digest_.onRecord(from, std::move(record));
   // ownership of record was transferred to digest_
 
@@ -1290,6 +1299,16 @@ esn_t EpochRecovery::computeDigestStart() const {
   return lng_ == ESN_MAX ? ESN_MAX : esn_t(lng_.val_ + 1);
 }
 
+void EpochRecovery::trimDigestBelowLng() {
+  if (lng_ == ESN_INVALID || digestComplete()) {
+    return;
+  }
+  // same bound as the pre-mutation trim in startMutations(): entries below
+  // lng_ are discarded, the entry at lng_ is kept until the tail record of
+  // the epoch is decided
+  digest_.trim(esn_t(lng_.val_ - 1));
+}
+
 void EpochRecovery::onDigestStreamStarted(ShardID from,
                                           read_stream_id_t rsid,
                                           lsn_t last_known_good_lsn,
@@ -1323,6 +1342,7 @@ void EpochRecovery::onDigestStreamStarted(ShardID from,
                    identify().c_str());
           lng_ = lng_received;
           STAT_INCR(deps_->getStats(), lng_update_digest_started);
+          trimDigestBelowLng();
         }
       }
     }
@@ -537,6 +537,17 @@ class EpochRecovery {
    */
   esn_t computeDigestStart() const;
 
+  /**
+   * Discard digest entries that fell below the consensus LNG as it advanced
+   * during the digest phase (e.g., because of a late SEALED or STARTED
+   * reply). Such entries never need mutation and would be trimmed when
+   * digest processing starts anyway; trimming them eagerly releases their
+   * payloads instead of buffering them until the slowest digest stream
+   * completes. The entry at lng_ itself is retained since it may be needed
+   * to determine the tail record of the epoch.
+   */
+  void trimDigestBelowLng();
+
   /**
    * Compute the tail record and accumulative log attributes of the epoch based
    * on information from SEALED and digest replies.
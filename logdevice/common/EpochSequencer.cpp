@@ -18,6 +18,7 @@
 #include "logdevice/common/OffsetMap.h"
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/Sequencer.h"
+#include "logdevice/common/SequencerTailCache.h"
 #include "logdevice/common/TailRecord.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/configuration/Configuration.h"
@@ -310,6 +311,13 @@ bool EpochSequencer::noteAppenderReaped(Appender::FullyReplicated replicated,
 
   // Step 1.5: if lng changed, update tail record for the epoch
   if (lng_changed_out) {
+    if (SequencerTailCache* tail_cache = parent_->getTailCache()) {
+      // make the record available to tailing readers polling the sequencer;
+      // since LNG only advances when all previous Appenders of the epoch are
+      // fully replicated, the cache receives every replicated record in
+      // LSN order
+      tail_cache->push(*tail_record);
+    }
     // no need to do compare and swap here since this function is called
     // sequentially as Appenders are reaped
     tail_record_.store(std::move(tail_record));
@@ -620,6 +628,35 @@ bool EpochSequencer::checkNodeSet() const {
   return true;
 }
 
+double EpochSequencer::getOverloadedHeadroomFraction() const {
+  std::shared_ptr<CopySetManager> copyset_manager_ptr = getCopySetManager();
+  std::shared_ptr<const EpochMetaData> epoch_metadata = getMetaData();
+  if (copyset_manager_ptr == nullptr || epoch_metadata == nullptr) {
+    return 0.0;
+  }
+
+  auto nodeset_state = copyset_manager_ptr->getNodeSetState();
+  ld_check(nodeset_state);
+  const nodeset_ssize_t overloaded = nodeset_state->numNotAvailableShards(
+      NodeSetState::NotAvailableReason::OVERLOADED);
+  if (overloaded <= 0) {
+    return 0.0;
+  }
+
+  // With N shards and replication factor r, copyset picking keeps working
+  // until more than N - r shards are unavailable. Count how much of that
+  // slack (plus the final shard that would tip checkNodeSet() over) is
+  // already consumed by overloaded shards. The counters are maintained by
+  // concurrently running Appenders, so this is an estimate, which is fine
+  // for probabilistic shedding.
+  const size_t nshards = nodeset_state->numShards();
+  const size_t replication =
+      std::min((size_t)epoch_metadata->replication.getReplicationFactor(),
+               nshards);
+  const double headroom = nshards - replication + 1;
+  return std::min(1.0, overloaded / headroom);
+}
+
 void EpochSequencer::schedulePeriodicReleases() {
   parent_->schedulePeriodicReleases();
 }
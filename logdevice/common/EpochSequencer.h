@@ -383,6 +383,17 @@ class EpochSequencer : public std::enable_shared_from_this<EpochSequencer> {
    */
   bool checkNodeSet() const;
 
+  /**
+   * @return  fraction (in [0, 1]) of this epoch's spare nodeset capacity
+   *          that is currently eaten by shards graylisted as OVERLOADED,
+   *          i.e. shards whose storage task queues reported overload in
+   *          STORED replies. 0 while all shards keep up; 1 when losing one
+   *          more shard would make checkNodeSet() fail. Used by AppenderPrep
+   *          to shed a matching fraction of incoming appends before the
+   *          nodeset hits that cliff.
+   */
+  double getOverloadedHeadroomFraction() const;
+
   /**
    * Called when the cluster config has changed causing the effective nodeset
    * to change. Rebuild the copyset manager.
@@ -12,7 +12,9 @@
 #include "logdevice/common/ConstructorFailed.h"
 #include "logdevice/common/EventHandler.h"
 #include "logdevice/common/EventLoop.h"
+#include "logdevice/common/Worker.h"
 #include "logdevice/common/debug.h"
+#include "logdevice/common/stats/Stats.h"
 
 namespace facebook { namespace logdevice {
 
@@ -133,15 +135,24 @@ void EventLoopTaskQueue::executeTasks(uint32_t tokens) {
     tokens -= dequeues_to_execute[i];
   }
 
-  // Then, do a final pass to assign all remaining tokens by order of priority.
-  for (uint32_t i = 0; tokens > 0; ++i) {
-    ld_assert(i < dequeues_to_execute.size());
+  // Then, do a final pass to assign all remaining tokens, starting from
+  // the priority the previous iteration's leftovers stopped at and cycling
+  // from there: a priority with backlog beyond its quantum gets the extra
+  // capacity every kNumberOfPriorities-th iteration instead of the highest
+  // priority absorbing it every time.
+  for (uint32_t n = 0; tokens > 0 && n < kNumberOfPriorities; ++n) {
+    const size_t i = (leftover_priority_rr_ + n) % kNumberOfPriorities;
     auto tasks_remaining = tasks_available[i] - dequeues_to_execute[i];
     auto dequeues = std::min(tokens, tasks_remaining);
     tokens -= dequeues;
     dequeues_to_execute[i] += dequeues;
   }
+  // Producers post to the semaphore only after enqueueing, so all tokens
+  // are always covered by available tasks.
+  ld_assert(tokens == 0);
+  leftover_priority_rr_ = (leftover_priority_rr_ + 1) % kNumberOfPriorities;
 
+  const auto start_time = std::chrono::steady_clock::now();
   for (size_t i = 0; i < dequeues_to_execute.size(); ++i) {
     while (dequeues_to_execute[i]--) {
       auto t = queues_[i].dequeue();
@@ -152,6 +163,16 @@ void EventLoopTaskQueue::executeTasks(uint32_t tokens) {
       t.function();
     }
   }
+  const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start_time);
+  if (UNLIKELY(elapsed > iteration_budget_)) {
+    // One batch monopolized the loop long enough to starve timers and
+    // network events; account for it so latency variance is attributable.
+    STAT_INCR(Worker::stats(), event_loop_iteration_overruns);
+    STAT_ADD(Worker::stats(),
+             event_loop_iteration_overrun_usec,
+             (elapsed - iteration_budget_).count());
+  }
 }
 
 }} // namespace facebook::logdevice
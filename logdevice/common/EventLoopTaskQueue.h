@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <numeric>
 
@@ -127,6 +128,16 @@ class EventLoopTaskQueue {
                         uint32_t(0));
   }
 
+  /**
+   * Task batches that run longer than this are counted in the
+   * event_loop_iteration_overruns stat together with the time over budget.
+   * Driven by the worker-iteration-overrun-threshold setting; must be
+   * called on the EventLoop thread (or before the loop starts running).
+   */
+  void setIterationBudget(std::chrono::microseconds budget) {
+    iteration_budget_ = budget;
+  }
+
  private:
   EvBase& base_;
 
@@ -149,6 +160,17 @@ class EventLoopTaskQueue {
   std::array<uint32_t, kNumberOfPriorities> dequeues_per_iteration_;
   uint32_t total_dequeues_per_iteration_;
 
+  // Priority that leftover tokens (tokens unused by queues with less
+  // backlog than their quantum) are offered to first in the next
+  // iteration; advances round robin so leftovers don't always top up the
+  // highest priority. Only touched on the EventLoop thread.
+  size_t leftover_priority_rr_{0};
+
+  // See setIterationBudget(). Default matches the
+  // worker-iteration-overrun-threshold setting default.
+  std::chrono::microseconds iteration_budget_{
+      std::chrono::milliseconds(10)};
+
   // The data structures of choice for queue is an UnboundedQueue paired with a
   // LifoEventSem. The posting codepath writes into the queue, then posts to
   // the semaphore. LifoEventSem ensures that the FD hooked up to the event
@@ -33,6 +33,16 @@ class FlowGroupDependencies {
     p_fgp_stats->*stat_field = val;
   }
 
+  void statsAdd(StatsCounter PerFlowGroupStats::*stat_field,
+                NodeLocationScope scope,
+                size_t val) {
+    auto p_fgp_stats = statsGet(scope);
+    if (!p_fgp_stats) {
+      return;
+    }
+    p_fgp_stats->*stat_field += val;
+  }
+
   void statsSet(StatsCounter PerShapingPriorityStats::*stat_field,
                 NodeLocationScope scope,
                 Priority p,
@@ -88,6 +88,18 @@ ClusterState* GetRsmSnapshotRequest::getClusterState() const {
   return Worker::getClusterState();
 }
 
+node_index_t GetRsmSnapshotRequest::getPreferredNode() const {
+  Worker* w = Worker::onThisThread(false);
+  return w ? w->runningGetRsmSnapshotRequests().preferred_node : -1;
+}
+
+void GetRsmSnapshotRequest::setPreferredNode(node_index_t idx) {
+  Worker* w = Worker::onThisThread(false);
+  if (w) {
+    w->runningGetRsmSnapshotRequests().preferred_node = idx;
+  }
+}
+
 void GetRsmSnapshotRequest::start() {
   if (!candidates_.size()) {
     auto limit_reached = retryLimitReached();
@@ -102,6 +114,18 @@ void GetRsmSnapshotRequest::start() {
   }
 
   const auto& nodes_cfg = getNodesConfiguration();
+
+  // Prefer the node that most recently served a snapshot, if it's still a
+  // valid candidate; fetching all RSM snapshots from the same peer lets a
+  // bootstrapping node reuse a single connection. onError() drops the hint
+  // if the peer stops delivering.
+  const node_index_t preferred = getPreferredNode();
+  if (preferred >= 0 && candidates_.count(preferred) &&
+      nodes_cfg->isNodeInServiceDiscoveryConfig(preferred)) {
+    sendTo(nodes_cfg->getNodeID(preferred));
+    return;
+  }
+
   auto random_it = std::next(
       candidates_.begin(),
       folly::Random::rand32(static_cast<uint32_t>(candidates_.size())));
@@ -127,6 +151,11 @@ void GetRsmSnapshotRequest::onError(Status st, NodeID dest) {
            key_.c_str());
   cancelWaveTimer();
   candidates_.erase(dest.index());
+  if (dest.index() == getPreferredNode()) {
+    // Don't make every subsequent request pay a wave timeout on a peer that
+    // stopped delivering snapshots.
+    setPreferredNode(-1);
+  }
   start();
 }
 
@@ -272,6 +301,9 @@ void GetRsmSnapshotRequest::finalize(
              .c_str(),
          msg_snapshot_blob.size());
 
+  if (msg_hdr.st == E::OK && last_dest_.isNodeID()) {
+    setPreferredNode(last_dest_.index());
+  }
   finalize(msg_hdr.st, msg_snapshot_blob, msg_hdr.snapshot_ver);
 }
 
@@ -32,6 +32,12 @@ struct GetRsmSnapshotRequestMap {
                      std::unique_ptr<GetRsmSnapshotRequest>,
                      request_id_t::Hash>
       map;
+  // Node that most recently served a snapshot to a request on this worker,
+  // or -1.  Subsequent requests try it first, so that a cold-starting node
+  // pulls the snapshots of all its replicated state machines (logsconfig,
+  // event log, maintenance log) from one peer over one connection instead
+  // of fanning out to random nodes.
+  node_index_t preferred_node{-1};
 };
 
 class GetRsmSnapshotRequest : public Request {
@@ -106,6 +112,9 @@ class GetRsmSnapshotRequest : public Request {
   virtual ClusterState* getClusterState() const;
   virtual void registerWithWorker();
   virtual void destroyRequest();
+  // Sticky peer hint, see GetRsmSnapshotRequestMap::preferred_node.
+  virtual node_index_t getPreferredNode() const;
+  virtual void setPreferredNode(node_index_t idx);
   std::unique_ptr<SenderBase> sender_;
   // Holds the candidate server nodes to which this request can be sent
   std::unordered_set<node_index_t> candidates_;
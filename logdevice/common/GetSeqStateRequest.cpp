@@ -9,9 +9,11 @@
 #include "logdevice/common/GetSeqStateRequest.h"
 
 #include "logdevice/common/EpochMetaDataMap.h"
+#include "logdevice/common/MetaDataLog.h"
 #include "logdevice/common/NodeID.h"
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/Sender.h"
+#include "logdevice/common/SequencerHintsCache.h"
 #include "logdevice/common/TailRecord.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/protocol/GET_SEQ_STATE_Message.h"
@@ -700,6 +702,18 @@ void GetSeqStateRequest::finalize() {
         error_description(status_));
   }
 
+  if (status_ == E::OK && dest_.isNodeID()) {
+    // Remember which node answered (and the released tail it reported) so
+    // that the next run of this client can route its first message straight
+    // to it. See SequencerHintsCache.
+    SequencerHintsCache* hints =
+        Worker::onThisThread()->processor_->sequencer_hints_cache_;
+    if (hints != nullptr) {
+      hints->setHint(
+          MetaDataLog::dataLogID(log_id_), dest_, last_released_lsn_);
+    }
+  }
+
   executeCallbacks();
 }
 
@@ -10,10 +10,10 @@
 #include <functional>
 #include <list>
 #include <memory>
-#include <unordered_map>
 #include <vector>
 
 #include <folly/Memory.h>
+#include <folly/container/F14Map.h>
 #include <folly/hash/Hash.h>
 
 #include "logdevice/common/BWAvailableCallback.h"
@@ -76,10 +76,19 @@ class GetSeqStateRequestMap {
    */
   bool deleteGssEntryWithRequestId(logid_t log_id, request_id_t rqid);
 
+  size_t size() const {
+    return map_.size();
+  }
+
+  size_t bucketCount() const {
+    return map_.bucket_count();
+  }
+
  private:
   // Each element of the list corresponds to a unique combination of
-  // GetSeqStateRequest::Options
-  std::unordered_map<logid_t, std::list<GetSeqStateRequestEntry>, logid_t::Hash>
+  // GetSeqStateRequest::Options. Open-addressing map; the lists' nodes stay
+  // put when the table rehashes, so entry pointers remain valid.
+  folly::F14FastMap<logid_t, std::list<GetSeqStateRequestEntry>, logid_t::Hash>
       map_;
 };
 
@@ -0,0 +1,173 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/GetTailRecordsRequest.h"
+
+#include <algorithm>
+
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/GET_TAIL_RECORDS_Message.h"
+#include "logdevice/common/protocol/TAIL_RECORDS_REPLY_Message.h"
+#include "logdevice/common/util.h"
+
+namespace facebook { namespace logdevice {
+
+Request::Execution GetTailRecordsRequest::execute() {
+  if (max_records_ == 0) {
+    // not in the Worker's map yet, so cannot go through finalize()
+    callback_(E::INVALID_PARAM, LSN_INVALID, {});
+    return Execution::COMPLETE;
+  }
+
+  // transfer ownership of `this' to the Worker's map of running requests
+  auto insert_result =
+      Worker::onThisThread()->runningGetTailRecords().map.insert(
+          std::make_pair(id_, std::unique_ptr<GetTailRecordsRequest>(this)));
+  ld_check(insert_result.second);
+
+  request_timer_.assign([this] { onClientTimeout(); });
+  request_timer_.activate(client_timeout_);
+
+  router_ = std::make_unique<SequencerRouter>(log_id_, this);
+  router_->start();
+  return Execution::CONTINUE;
+}
+
+void GetTailRecordsRequest::onSequencerKnown(
+    NodeID dest,
+    SequencerRouter::flags_t /*flags*/) {
+  ld_check(dest.isNodeID());
+  dest_ = dest;
+  sendTo(dest);
+}
+
+void GetTailRecordsRequest::onSequencerRoutingFailure(Status status) {
+  ld_check(status != E::OK);
+  finalize(status, LSN_INVALID, {});
+}
+
+void GetTailRecordsRequest::sendTo(NodeID dest) {
+  ld_debug("Sending GET_TAIL_RECORDS for log %lu (rqid:%lu) to node %s, "
+           "start_lsn %s",
+           log_id_.val_,
+           id_.val(),
+           dest.toString().c_str(),
+           lsn_to_string(start_lsn_).c_str());
+
+  GET_TAIL_RECORDS_Header header = {id_,
+                                    log_id_,
+                                    start_lsn_,
+                                    static_cast<uint32_t>(std::min(
+                                        max_records_, size_t{UINT32_MAX})),
+                                    /*flags=*/0};
+  auto msg = std::make_unique<GET_TAIL_RECORDS_Message>(header);
+  if (Worker::onThisThread()->sender().sendMessage(std::move(msg), dest) !=
+      0) {
+    if (err == E::PROTONOSUPPORT) {
+      // the node is running a protocol version that predates
+      // GET_TAIL_RECORDS; there is no point in trying other nodes
+      finalize(E::NOTSUPPORTED, LSN_INVALID, {});
+      return;
+    }
+    router_->onNodeUnavailable(dest, err);
+  }
+}
+
+void GetTailRecordsRequest::onReply(NodeID from,
+                                    TAIL_RECORDS_REPLY_Message& msg) {
+  // discard replies from nodes other than the latest one the request was
+  // sent to
+  if (from.isNodeID() && dest_.isNodeID() && from.index() != dest_.index()) {
+    return;
+  }
+
+  const Status status = msg.status_;
+  ld_debug("Node %s replied to GET_TAIL_RECORDS for log %lu (rqid:%lu) "
+           "with status %s, %u record(s)",
+           from.toString().c_str(),
+           log_id_.val_,
+           id_.val(),
+           error_name(status),
+           msg.header_.num_records);
+
+  switch (status) {
+    case E::REDIRECTED:
+    case E::PREEMPTED:
+      ld_check(msg.redirect_.isNodeID());
+      router_->onRedirected(from, msg.redirect_, status);
+      break;
+    case E::NOSEQUENCER:
+    case E::NOTREADY:
+    case E::SHUTDOWN:
+    case E::REBUILDING:
+      router_->onNodeUnavailable(from, status);
+      break;
+    case E::OK:
+      finalize(E::OK, msg.header_.tail_lsn, std::move(msg.records_));
+      break;
+    default:
+      // STALE, NOTSUPPORTED, AGAIN, INVALID_PARAM, ...: let the caller
+      // decide whether to fall back to storage reads or retry later
+      finalize(status, LSN_INVALID, {});
+      break;
+  }
+}
+
+void GetTailRecordsRequest::onMessageSent(NodeID to, Status status) {
+  if (status == E::OK) {
+    return;
+  }
+
+  if (to != dest_) {
+    // a message to a previous destination failed after we moved on
+    return;
+  }
+
+  RATELIMIT_INFO(std::chrono::seconds(10),
+                 10,
+                 "Failed to send GET_TAIL_RECORDS message to %s for log %lu: "
+                 "%s",
+                 to.toString().c_str(),
+                 log_id_.val_,
+                 error_description(status));
+
+  if (status == E::PROTONOSUPPORT) {
+    finalize(E::NOTSUPPORTED, LSN_INVALID, {});
+    return;
+  }
+
+  if (status == E::SSLREQUIRED) {
+    router_->onShouldRetry(to, status);
+    return;
+  }
+
+  router_->onNodeUnavailable(to, status);
+}
+
+void GetTailRecordsRequest::onClientTimeout() {
+  ld_debug("GET_TAIL_RECORDS request for log %lu (rqid:%lu) timed out",
+           log_id_.val_,
+           id_.val());
+  finalize(E::TIMEDOUT, LSN_INVALID, {});
+}
+
+void GetTailRecordsRequest::finalize(Status status,
+                                     lsn_t tail_lsn,
+                                     std::vector<TailRecord> records) {
+  callback_(status, tail_lsn, std::move(records));
+  callback_ = nullptr;
+
+  // destroys `this'
+  auto& rqmap = Worker::onThisThread()->runningGetTailRecords().map;
+  auto it = rqmap.find(id_);
+  ld_check(it != rqmap.end());
+  rqmap.erase(it);
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,128 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <folly/hash/Hash.h>
+
+#include "logdevice/common/Request.h"
+#include "logdevice/common/SequencerRouter.h"
+#include "logdevice/common/TailRecord.h"
+#include "logdevice/common/Timer.h"
+#include "logdevice/common/types_internal.h"
+#include "logdevice/include/Err.h"
+#include "logdevice/include/types.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file  GetTailRecordsRequest fetches recently appended records of a log
+ *        directly from the node running the log's sequencer (see
+ *        SequencerTailCache), skipping the storage-node round trip that a
+ *        regular read would take. It uses SequencerRouter internally to find
+ *        the sequencer node and follows redirects the same way appends do.
+ *
+ *        On E::STALE the requested range starts below the sequencer's ring
+ *        of recent records and the caller is expected to fall back to
+ *        reading from storage nodes.
+ */
+
+class GetTailRecordsRequest;
+class TAIL_RECORDS_REPLY_Message;
+
+// Wrapper instead of typedef to allow forward-declaring in Worker.h
+struct GetTailRecordsRequestMap {
+  std::unordered_map<request_id_t,
+                     std::unique_ptr<GetTailRecordsRequest>,
+                     request_id_t::Hash>
+      map;
+};
+
+class GetTailRecordsRequest : public Request, public SequencerRouter::Handler {
+ public:
+  /**
+   * @param status       E::OK on success (records may still be empty if
+   *                     nothing has been released in the range yet),
+   *                     E::STALE if the range starts below the sequencer's
+   *                     ring, E::NOTSUPPORTED if the sequencer does not cache
+   *                     recent records, or an error from the list in
+   *                     TAIL_RECORDS_REPLY_Message.h / SequencerRouter
+   * @param tail_lsn     the sequencer's last released LSN at the time of the
+   *                     reply; LSN_INVALID unless status is E::OK
+   * @param records      records with LSNs in [start_lsn, tail_lsn], in
+   *                     increasing LSN order, all with payloads
+   */
+  using Callback =
+      std::function<void(Status, lsn_t, std::vector<TailRecord>)>;
+
+  GetTailRecordsRequest(logid_t log_id,
+                        lsn_t start_lsn,
+                        size_t max_records,
+                        std::chrono::milliseconds client_timeout,
+                        Callback callback)
+      : Request(RequestType::GET_TAIL_RECORDS),
+        log_id_(log_id),
+        start_lsn_(start_lsn),
+        max_records_(max_records),
+        client_timeout_(client_timeout),
+        callback_(std::move(callback)) {}
+
+  int getThreadAffinity(int nthreads) override {
+    return folly::hash::twang_mix64(log_id_.val_) % nthreads;
+  }
+
+  Execution execute() override;
+
+  // SequencerRouter::Handler implementation
+  void onSequencerKnown(NodeID dest, SequencerRouter::flags_t flags) override;
+  void onSequencerRoutingFailure(Status status) override;
+
+  // Called when a TAIL_RECORDS_REPLY message is received from `from'.
+  void onReply(NodeID from, TAIL_RECORDS_REPLY_Message& msg);
+
+  // Called when the GET_TAIL_RECORDS message could not be sent (or was sent)
+  // to `to'.
+  void onMessageSent(NodeID to, Status status);
+
+  logid_t getLogID() const {
+    return log_id_;
+  }
+
+ protected: // tests can override
+  virtual void sendTo(NodeID dest);
+
+  // Invokes the callback and destroys this request.
+  virtual void finalize(Status status,
+                        lsn_t tail_lsn,
+                        std::vector<TailRecord> records);
+
+ private:
+  void onClientTimeout();
+
+  const logid_t log_id_;
+  const lsn_t start_lsn_;
+  const size_t max_records_;
+  const std::chrono::milliseconds client_timeout_;
+  Callback callback_;
+
+  std::unique_ptr<SequencerRouter> router_;
+
+  // gives up and reports E::TIMEDOUT when client_timeout_ expires
+  Timer request_timer_;
+
+  // node the message was last sent to; used to discard replies and send
+  // notifications from other nodes
+  NodeID dest_;
+};
+
+}} // namespace facebook::logdevice
@@ -159,7 +159,8 @@ Slice formRecordHeader(const STORE_Header& store_header,
                        std::string* buf,
                        const bool shard_id_in_copyset,
                        const std::map<KeyType, std::string>& optional_keys,
-                       const STORE_Extra& store_extra) {
+                       const STORE_Extra& store_extra,
+                       const std::string* optional_keys_serialized) {
   flags_t flags = store_header.flags & FLAG_MASK;
   uint32_t wave_or_recovery_epoch_to_store =
       getRecordWaveOrRecoveryEpoch(store_header, store_extra);
@@ -206,15 +207,32 @@ Slice formRecordHeader(const STORE_Header& store_header,
   for (copyset_size_t i = 0; i < store_header.copyset_size; ++i) {
     copyset_indexes.push_back(copyset[i].destination);
   }
-  return formRecordHeader(store_header.timestamp,
-                          store_header.last_known_good,
-                          flags,
-                          wave_or_recovery_epoch_to_store,
-                          folly::Range<const ShardID*>(
-                              copyset_indexes.begin(), copyset_indexes.end()),
-                          offsets_within_epoch,
-                          optional_keys,
-                          buf);
+
+  // Use the pre-serialized keys blob if the caller has one, saving a second
+  // pass over the keys here.
+  std::string optional_keys_string;
+  if (optional_keys_serialized == nullptr || optional_keys.empty()) {
+    serializeOptionalKeys(&optional_keys_string, optional_keys);
+    optional_keys_serialized = &optional_keys_string;
+  }
+  Slice optional_keys_slice = Slice::fromString(*optional_keys_serialized);
+
+  ld_check(buf != nullptr);
+  buf->clear();
+  buf->reserve(recordHeaderSizeEstimate(flags,
+                                        copyset_indexes.size(),
+                                        optional_keys_slice,
+                                        offsets_within_epoch));
+  return formRecordHeaderBufAppend(store_header.timestamp,
+                                   store_header.last_known_good,
+                                   flags,
+                                   wave_or_recovery_epoch_to_store,
+                                   folly::Range<const ShardID*>(
+                                       copyset_indexes.begin(),
+                                       copyset_indexes.end()),
+                                   offsets_within_epoch,
+                                   optional_keys_slice,
+                                   buf);
 }
 
 csi_flags_t formCopySetIndexFlags(const STORE_Header& store_header,
@@ -891,6 +909,27 @@ int isWrittenByRecovery(const Slice& log_store_blob,
   return 0;
 }
 
+int isPayloadDeduped(const Slice& log_store_blob, bool* is_deduped_out) {
+  ld_check(is_deduped_out);
+  const size_t offset = sizeof(uint64_t) + sizeof(esn_t);
+
+  // Check that blob is long enough for at least 2 bytes of varint flags.
+  static_assert(minLogStoreBlobSize() > offset + 1, "");
+  if (log_store_blob.size < minLogStoreBlobSize()) {
+    ld_error("Invalid record: too small (%zu bytes)", log_store_blob.size);
+    err = E::MALFORMED_RECORD;
+    return -1;
+  }
+
+  // Check that the flag fits in a 2-byte varint.
+  static_assert(FLAG_PAYLOAD_DEDUP < (1 << 14), "");
+
+  auto p = reinterpret_cast<const uint8_t*>(log_store_blob.data) + offset;
+  *is_deduped_out = testVarInt(p, FLAG_PAYLOAD_DEDUP);
+
+  return 0;
+}
+
 int parseFlags(const Slice& log_store_blob, flags_t* flags_out) {
   ld_check(flags_out != nullptr);
   return parse(log_store_blob,
@@ -907,6 +946,35 @@ int parseFlags(const Slice& log_store_blob, flags_t* flags_out) {
                -1 /* unused */);
 }
 
+int replaceFlags(const Slice& log_store_blob,
+                 flags_t new_flags,
+                 std::string* out) {
+  ld_check(out != nullptr);
+  const uint8_t* const start =
+      reinterpret_cast<const uint8_t*>(log_store_blob.data);
+  const uint8_t* const end = start + log_store_blob.size;
+  // Timestamp and last_known_good precede the flags varint.
+  const size_t flags_offset = sizeof(uint64_t) + sizeof(esn_t);
+  const uint8_t* ptr = start + flags_offset;
+  if (ptr >= end) {
+    err = E::MALFORMED_RECORD;
+    return -1;
+  }
+  flags_t old_flags;
+  if (parseFlagsValue(old_flags, &ptr, end) != 0) {
+    err = E::MALFORMED_RECORD;
+    return -1;
+  }
+  // `ptr` now points right past the old flags varint.
+  uint8_t varint_buf[folly::kMaxVarintLength32];
+  size_t varint_len = folly::encodeVarint(new_flags, varint_buf);
+  out->reserve(out->size() + flags_offset + varint_len + (end - ptr));
+  out->append(reinterpret_cast<const char*>(start), flags_offset);
+  out->append(reinterpret_cast<const char*>(varint_buf), varint_len);
+  out->append(reinterpret_cast<const char*>(ptr), end - ptr);
+  return 0;
+}
+
 int getCopysetHash(const Slice& log_store_blob, size_t* hash_out) {
   static thread_local std::array<ShardID, COPYSET_SIZE_MAX> copyset;
   ld_check(hash_out != nullptr);
@@ -975,6 +1043,7 @@ std::string flagsToString(flags_t flags) {
   FLAG(BUFFERED_WRITER_BLOB)
   FLAG(OFFSET_WITHIN_EPOCH)
   FLAG(CSI_DATA_ONLY)
+  FLAG(PAYLOAD_DEDUP)
   FLAG(WRITTEN_BY_RECOVERY)
   FLAG(CUSTOM_KEY)
   FLAG(BRIDGE)
@@ -84,6 +84,12 @@ const flags_t FLAG_OFFSET_WITHIN_EPOCH = 1u << 8; //=256
 // Record contains CSI data only. (copyset and HOLE flag) should not be written
 // to disk.
 const flags_t FLAG_CSI_DATA_ONLY = 1u << 9; //=512
+// Local to the storage node, never shipped in messages: the payload section
+// of the blob holds a reference into the store's dedup payload index (see
+// server/locallogstore/PayloadDedup.h) instead of the payload itself. Set by
+// the local log store on the write path and resolved (and cleared) by its
+// read iterators, so consumers of ReadIterator::getRecord() never see it.
+const flags_t FLAG_PAYLOAD_DEDUP = 1u << 10; //=1024
 // the record is written / overwritten by epoch recovery. In such case,
 // the wave number field is repurposed to store the `seal epoch' number
 // of the log recovery that stores this record.
@@ -253,13 +259,21 @@ Slice formRecordHeader(int64_t timestamp,
  *                              monotonically increasing order);
  *                              KeyType::FILTERABLE is used by server-side
  *                              filtering.[Experimental feature]
+ * @param optional_keys_serialized
+ *                              if non-null, `optional_keys' already laid out
+ *                              in serializeOptionalKeys() form; used verbatim
+ *                              instead of serializing the map again.
+ *                              STORE_Message::deserialize() builds this blob
+ *                              in the same pass that parses the keys off the
+ *                              wire.
  */
 Slice formRecordHeader(const STORE_Header& store_header,
                        const StoreChainLink* copyset,
                        std::string* buf,
                        bool shard_id_in_copyset,
                        const std::map<KeyType, std::string>& optional_keys,
-                       const STORE_Extra& store_extra = STORE_Extra());
+                       const STORE_Extra& store_extra = STORE_Extra(),
+                       const std::string* optional_keys_serialized = nullptr);
 
 /**
  * Form copyset index entry flags from the content of a STORE_Header.
@@ -395,12 +409,34 @@ int parseTimestamp(const Slice& log_store_blob,
  */
 int parseFlags(const Slice& log_store_blob, flags_t* flags_out);
 
+/**
+ * Appends a copy of `log_store_blob` to `out` with the flags bitset replaced
+ * by `new_flags`. Since flags are a varint, the copy may differ in length
+ * from the original. `log_store_blob` can be a full record blob or any
+ * prefix of one that extends past the flags varint (e.g. just the header);
+ * the bytes after the varint are copied through unchanged.
+ *
+ * Used by the local log store to mark records on the write path and unmark
+ * them on the read path (see FLAG_PAYLOAD_DEDUP).
+ *
+ * @return 0 on success, -1 with err set to MALFORMED_RECORD if the blob is
+ *         too short to contain the flags varint.
+ */
+int replaceFlags(const Slice& log_store_blob,
+                 flags_t new_flags,
+                 std::string* out);
+
 /**
  * Same as (parseFlags() & FLAG_WRITTEN_BY_RECOVERY) but faster.
  */
 int isWrittenByRecovery(const Slice& log_store_blob,
                         bool* is_written_by_recovery_out);
 
+/**
+ * Same as (parseFlags() & FLAG_PAYLOAD_DEDUP) but faster.
+ */
+int isPayloadDeduped(const Slice& log_store_blob, bool* is_deduped_out);
+
 /**
  * Computes a hash of record's copyset.
  */
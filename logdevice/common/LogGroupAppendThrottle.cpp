@@ -0,0 +1,71 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/LogGroupAppendThrottle.h"
+
+#include "logdevice/common/Processor.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/configuration/logs/LogsConfigTree.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/util.h"
+
+namespace facebook { namespace logdevice {
+
+bool LogGroupAppendThrottle::isAllowed(logid_t log_id, size_t cost) {
+  Worker* w = Worker::onThisThread(false);
+  if (w == nullptr) {
+    return true;
+  }
+
+  const logsconfig::LogGroupInDirectory* group =
+      w->getLogGroupByIDCached(log_id);
+  const std::string* path = w->getLogGroupPathCached(log_id);
+  if (group == nullptr || path == nullptr) {
+    // Not in config, or a metadata log; nothing to enforce.
+    return true;
+  }
+
+  auto it = throttles_.find(*path);
+  if (it == throttles_.end()) {
+    Throttle throttle;
+    const auto& extras = group->log_group->attrs().extras();
+    if (extras.hasValue()) {
+      const auto& map = extras.value();
+      auto kv = map.find(MAX_APPEND_RATE_ATTRIBUTE);
+      if (kv != map.end()) {
+        rate_limit_t limit;
+        if (parse_rate_limit(kv->second.c_str(), &limit) == 0) {
+          if (limit != RATE_UNLIMITED) {
+            // This Worker admits its even share of the ceiling; see the
+            // header for why the shares add up.
+            size_t nworkers = std::max(
+                1, w->processor_->getWorkerCount(WorkerType::GENERAL));
+            limit.first = std::max<size_t>(1, limit.first / nworkers);
+            throttle.limited = true;
+            throttle.limiter = RateLimiter(limit);
+          }
+        } else {
+          RATELIMIT_ERROR(std::chrono::seconds(10),
+                          2,
+                          "Invalid \"%s\" attribute \"%s\" on log group %s; "
+                          "not throttling appends for it",
+                          MAX_APPEND_RATE_ATTRIBUTE,
+                          kv->second.c_str(),
+                          path->c_str());
+        }
+      }
+    }
+    it = throttles_.emplace(*path, std::move(throttle)).first;
+  }
+
+  if (!it->second.limited) {
+    return true;
+  }
+  return it->second.limiter.isAllowed(cost);
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,80 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <string>
+
+#include <folly/container/F14Map.h>
+
+#include "logdevice/common/RateLimiter.h"
+#include "logdevice/include/types.h"
+
+/**
+ * @file Per-Worker enforcement of append throughput ceilings configured per
+ *       log group. Traffic shaping classifies traffic by peer scope only, so
+ *       a runaway producer writing to one log group can crowd out its
+ *       siblings on a shared sequencer node. LogGroupAppendThrottle lets a
+ *       log group be capped independently: over-quota appends are rejected
+ *       by AppenderPrep before an Appender starts consuming sequencer window
+ *       slots or storage resources.
+ *
+ *       The ceiling is configured through the log group's "extras"
+ *       attributes under the key "max-append-rate", in the same
+ *       "<count>/<duration>" format as rate limit settings (e.g.
+ *       "10M/1s", or "unlimited"). Log groups without the attribute are
+ *       not throttled.
+ *
+ *       Each Worker owns one instance and admits its even share of the
+ *       configured ceiling, mirroring how FlowGroupPolicy splits per-scope
+ *       bandwidth between the Senders; appends for a log group are spread
+ *       across Workers by client connection, so the shares add up to the
+ *       ceiling without any cross-thread coordination.
+ */
+
+namespace facebook { namespace logdevice {
+
+class LogGroupAppendThrottle {
+ public:
+  // Log group extras key holding the append throughput ceiling.
+  static constexpr const char* MAX_APPEND_RATE_ATTRIBUTE = "max-append-rate";
+
+  /**
+   * Charges `cost` bytes of payload against the append budget of the log
+   * group `log_id` belongs to.
+   *
+   * @return false if the log group has a configured ceiling and is over it,
+   *         in which case the append should be rejected. Logs without a
+   *         ceiling, logs not in config and metadata logs are always
+   *         allowed.
+   */
+  bool isAllowed(logid_t log_id, size_t cost);
+
+  /**
+   * Drops all cached throttles so that changed attribute values are picked
+   * up. Called from Worker::onLogsConfigUpdated(), together with the log
+   * group lookup cache invalidation.
+   */
+  void noteLogsConfigUpdated() {
+    throttles_.clear();
+  }
+
+ private:
+  struct Throttle {
+    // false if the log group has no (or an unparsable) ceiling configured;
+    // such entries are cached too, since unthrottled log groups are the
+    // common case on the append hot path.
+    bool limited{false};
+    RateLimiter limiter;
+  };
+
+  // Keyed by fully qualified log group path; the attribute is parsed once
+  // per log group per logs config version.
+  folly::F14FastMap<std::string, Throttle> throttles_;
+};
+
+}} // namespace facebook::logdevice
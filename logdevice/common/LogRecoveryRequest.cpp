@@ -161,7 +161,7 @@ int LogRecoveryRequest::getThreadAffinity(int nthreads) {
   // Otherwise, in order to make it easy to ensure that at most one
   // LogRecoveryRequest is running for each log, all requests for the same log
   // id are pinned to the same worker thread.
-  return folly::hash::twang_mix64(log_id_.val_) % nthreads;
+  return Processor::selectWorkerIdForLog(log_id_, nthreads).val_;
 }
 
 LogRecoveryRequest::LogRecoveryRequest(
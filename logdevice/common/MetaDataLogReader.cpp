@@ -8,6 +8,8 @@
 #include "logdevice/common/MetaDataLogReader.h"
 
 #include <folly/Memory.h>
+#include <folly/Synchronized.h>
+#include <folly/container/EvictingCacheMap.h>
 
 #include "logdevice/common/CompletionRequest.h"
 #include "logdevice/common/DataRecordOwnsPayload.h"
@@ -23,11 +25,106 @@
 
 namespace facebook { namespace logdevice {
 
+namespace {
+
+// Process-wide cache of metadata log contents, shared by all
+// MetaDataLogReaders; see CachedContents. Keeps the most recently used
+// metadata-log-cache-max-logs logs.
+using ContentsCache =
+    folly::EvictingCacheMap<logid_t,
+                            std::shared_ptr<const MetaDataLogReader::
+                                                CachedContents>,
+                            logid_t::Hash>;
+
+folly::Synchronized<ContentsCache>& contentsCache() {
+  static folly::Synchronized<ContentsCache> cache{ContentsCache(0)};
+  return cache;
+}
+
+} // namespace
+
 void MetaDataLogReader::start() {
+  if (mode_ == Mode::IGNORE_LAST_RELEASED && tryServeFromCache()) {
+    started_ = true;
+    return;
+  }
   startReading();
   started_ = true;
 }
 
+bool MetaDataLogReader::tryServeFromCache() {
+  Worker* w = Worker::onThisThread(false /*enforce_worker*/);
+  if (w == nullptr || w->immutable_settings_->metadata_log_cache_max_logs == 0) {
+    // no worker (tests) or cache disabled
+    return false;
+  }
+  {
+    auto cache = contentsCache().wlock();
+    auto it = cache->find(log_id_);
+    if (it == cache->end()) {
+      return false;
+    }
+    cached_contents_ = it->second;
+  }
+  const auto& records = cached_contents_->records;
+  if (records.size() < 2 || epoch_end_ >= records.back().epoch) {
+    // The requested range reaches the tail of the cached contents. Only
+    // intervals concluded by a later record are immutable, so this request
+    // has to read the log (and will refresh the cache).
+    cached_contents_.reset();
+    return false;
+  }
+  STAT_INCR(getStats(), metadata_log_reads_from_cache);
+  cache_delivery_timer_.assign([this] { deliverFromCache(); });
+  cache_delivery_timer_.activate(std::chrono::microseconds(0));
+  return true;
+}
+
+void MetaDataLogReader::deliverFromCache() {
+  ld_check(cached_contents_ != nullptr);
+  const auto& records = cached_contents_->records;
+  // Record i is effective until the next record's epoch minus one; the
+  // last record's interval is not concluded and is never served from
+  // cache (see tryServeFromCache()).
+  for (size_t i = 0;
+       started_ && i + 1 < records.size() && epoch_to_deliver_ <= epoch_end_;
+       ++i) {
+    const epoch_t until = epoch_t(records[i + 1].epoch.val_ - 1);
+    if (until < epoch_to_deliver_) {
+      continue;
+    }
+    metadata_ = std::make_unique<EpochMetaData>(records[i].metadata);
+    record_lsn_ = records[i].lsn;
+    record_timestamp_ = records[i].timestamp;
+    // From the requester's point of view this is indistinguishable from a
+    // real read: a concluded interval is delivered as NOT_LAST there too.
+    deliverMetaData(E::OK, until, /*last_record=*/false);
+  }
+  if (started_) {
+    ld_check(epoch_to_deliver_ > epoch_end_);
+    finalize();
+  }
+}
+
+void MetaDataLogReader::maybeStoreToCache() {
+  Worker* w = Worker::onThisThread(false /*enforce_worker*/);
+  if (w == nullptr) {
+    return;
+  }
+  const size_t max_logs = w->immutable_settings_->metadata_log_cache_max_logs;
+  if (max_logs == 0 || mode_ != Mode::IGNORE_LAST_RELEASED ||
+      !collection_valid_ || collected_records_.empty()) {
+    return;
+  }
+  auto contents = std::make_shared<CachedContents>();
+  contents->records = std::move(collected_records_);
+  auto cache = contentsCache().wlock();
+  if (cache->getMaxSize() != max_logs) {
+    cache->setMaxSize(max_logs);
+  }
+  cache->set(log_id_, std::move(contents));
+}
+
 void MetaDataLogReader::startReading() {
   STAT_INCR(getStats(), metadata_log_readers_started);
   Worker* w = Worker::onThisThread();
@@ -131,6 +228,7 @@ void MetaDataLogReader::onDataRecord(std::unique_ptr<DataRecord> record) {
     bad_epoch_ = true;
     error_reason_ = E::BADMSG;
     offending_lsns_.insert(metadata_read_lsn);
+    collection_valid_ = false;
     return;
   }
 
@@ -147,6 +245,7 @@ void MetaDataLogReader::onDataRecord(std::unique_ptr<DataRecord> record) {
     bad_epoch_ = true;
     error_reason_ = E::BADMSG;
     offending_lsns_.insert(metadata_read_lsn);
+    collection_valid_ = false;
     return;
   }
 
@@ -171,6 +270,7 @@ void MetaDataLogReader::onDataRecord(std::unique_ptr<DataRecord> record) {
       bad_epoch_ = true;
       error_reason_ = E::BADMSG;
       offending_lsns_.insert(metadata_read_lsn);
+      collection_valid_ = false;
     }
     return;
   }
@@ -179,6 +279,11 @@ void MetaDataLogReader::onDataRecord(std::unique_ptr<DataRecord> record) {
     first_metadata_epoch_ = epoch_read;
   }
 
+  if (collection_valid_) {
+    collected_records_.push_back(CachedRecord{
+        epoch_read, metadata_read_lsn, metadata_read_timestamp, *metadata_read});
+  }
+
   // at this time we are sure that current epoch metadata is effective with
   // epoch range [last_read_epoch, epoch_read - 1], conclude the current epoch
   // interval and deliver the epoch metadata if necessary
@@ -223,6 +328,7 @@ void MetaDataLogReader::onGapRecord(const GapRecord& gap) {
              lastReadEpoch().val_);
     bad_epoch_ = true;
     error_reason_ = E::DATALOSS;
+    collection_valid_ = false;
   }
 
   if (gap.type == GapType::NOTINCONFIG) {
@@ -244,6 +350,10 @@ void MetaDataLogReader::onGapRecord(const GapRecord& gap) {
     // might be a DATALOSS gap if all nodes are in rebuilding
     ld_check(gap.type == GapType::BRIDGE || gap.type == GapType::DATALOSS);
 
+    // we have seen the whole metadata log; remember its contents so later
+    // readers can be served locally
+    maybeStoreToCache();
+
     // we received the special gap indicating that there is no more
     // released records in metadata storage nodes at the current time
     // conclude the reader
@@ -13,6 +13,7 @@
 
 #include "logdevice/common/EpochMetaData.h"
 #include "logdevice/common/MetaDataLog.h"
+#include "logdevice/common/Timer.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/common/stats/Stats.h"
 #include "logdevice/common/types_internal.h"
@@ -245,6 +246,27 @@ class MetaDataLogReader {
     return epoch_start_;
   }
 
+  // One metadata log record as kept in the process-wide contents cache.
+  // Metadata logs are tiny (one record per nodeset change), so caching them
+  // whole is cheap.
+  struct CachedRecord {
+    epoch_t epoch;
+    lsn_t lsn;
+    std::chrono::milliseconds timestamp;
+    EpochMetaData metadata;
+  };
+
+  // All records of a metadata log at the time of a complete read, in epoch
+  // order. Readers requesting epochs strictly below the last record's epoch
+  // can be served from this without touching the metadata nodeset: once a
+  // later record exists, the earlier epoch intervals are immutable (writes
+  // to the metadata log are serialized, see invariant I5 above), so no
+  // invalidation is needed for them. Requests that include the tail still
+  // read the log, and refresh the cache on the way.
+  struct CachedContents {
+    std::vector<CachedRecord> records;
+  };
+
   // override in tests
  protected:
   virtual void startReading();
@@ -305,6 +327,22 @@ class MetaDataLogReader {
   // the first metadata epoch in the metadata log. used in assert only.
   epoch_t first_metadata_epoch_{EPOCH_INVALID};
 
+  // records accumulated during a full read, to be stored into the
+  // process-wide contents cache when the read completes cleanly
+  std::vector<CachedRecord> collected_records_;
+
+  // cleared if the read encounters anything that makes the contents
+  // untrustworthy for caching: malformed or out-of-order records, dataloss
+  bool collection_valid_{true};
+
+  // contents being served from the cache instead of a read stream, see
+  // tryServeFromCache()
+  std::shared_ptr<const CachedContents> cached_contents_;
+
+  // zero-delay timer used to deliver cached contents asynchronously,
+  // mirroring the delivery of a real read
+  Timer cache_delivery_timer_;
+
   // starting point of the current metadata epoch interval
   epoch_t lastReadEpoch() const {
     return metadata_ == nullptr ? EPOCH_INVALID : metadata_->h.epoch;
@@ -323,6 +361,19 @@ class MetaDataLogReader {
   // deliver current epoch metadata to the requester with an effective until
   // epoch
   void deliverMetaData(Status st, epoch_t until, bool last_record);
+
+  // If the contents cache has this metadata log and the requested epoch
+  // range lies strictly below the last cached record's epoch, arranges for
+  // the request to be served locally (via cache_delivery_timer_) and
+  // returns true. No read stream is created in that case.
+  bool tryServeFromCache();
+
+  // Delivers epoch metadata from cached_contents_, then finalizes.
+  void deliverFromCache();
+
+  // Stores collected_records_ into the contents cache if the read covered
+  // the whole log and saw nothing suspicious.
+  void maybeStoreToCache();
 };
 
 }} // namespace facebook::logdevice
@@ -179,7 +179,7 @@ Mutator::sendSTORE(ShardID shard,
     additional_flags |= STORE_Header::AMEND;
   }
 
-  folly::small_vector<StoreChainLink, 6> copyset(wave_shards.size());
+  copyset_chain_t copyset(wave_shards.size());
   std::transform(
       wave_shards.begin(), wave_shards.end(), copyset.begin(), [](ShardID s) {
         return StoreChainLink{s, ClientID()};
@@ -21,6 +21,7 @@
 #include "logdevice/common/libevent/LibEventCompatibility.h"
 #include "logdevice/common/plugin/PluginRegistry.h"
 #include "logdevice/common/protocol/ACK_Message.h"
+#include "logdevice/common/protocol/Compatibility.h"
 #include "logdevice/common/protocol/HELLO_Message.h"
 #include "logdevice/common/protocol/MessageDeserializers.h"
 #include "logdevice/common/protocol/MessageDispatch.h"
@@ -334,6 +335,12 @@ NetworkDependencies::createHelloMessage(NodeID destNodeID) {
     hdr.flags |= HELLO_Header::CSID;
   }
 
+  // Offer transparent zstd compression of large messages; the server grants
+  // it by setting OPT_ZSTD_COMPRESSION in the ACK.
+  if (getSettings().protocol_compression_enabled) {
+    hdr.flags |= HELLO_Header::ZSTD_COMPRESSION;
+  }
+
   std::unique_ptr<Message> hello = std::make_unique<HELLO_Message>(hdr);
   auto hello_v2 = static_cast<HELLO_Message*>(hello.get());
   hello_v2->source_node_id_ = source_node_id;
@@ -356,6 +363,11 @@ void NetworkDependencies::processHelloMessage(const Message& msg,
                                               ConnectionInfo& info) {
   const auto& hello = dynamic_cast<const HELLO_Message&>(msg);
   info.protocol = std::min(hello.header_.proto_max, getSettings().max_protocol);
+  // Mirrors the decision HELLO_Message::onReceived() advertises in the ACK.
+  info.protocol_compression =
+      (hello.header_.flags & HELLO_Header::ZSTD_COMPRESSION) &&
+      getSettings().protocol_compression_enabled &&
+      *info.protocol >= Compatibility::COMPRESSED_MESSAGE_SUPPORT;
 }
 
 void NetworkDependencies::processACKMessage(const Message& msg,
@@ -363,6 +375,8 @@ void NetworkDependencies::processACKMessage(const Message& msg,
   const auto& ack = static_cast<const ACK_Message&>(msg);
   info.our_name_at_peer = ClientID(ack.getHeader().client_idx);
   info.protocol = ack.getHeader().proto;
+  info.protocol_compression =
+      (ack.getHeader().options & ACK_Header::OPT_ZSTD_COMPRESSION) != 0;
 }
 
 std::unique_ptr<Message>
@@ -11,6 +11,7 @@
 
 #include <folly/CppAttributes.h>
 
+#include "logdevice/common/ClusterState.h"
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/Sender.h"
 #include "logdevice/common/Worker.h"
@@ -55,6 +56,11 @@ NodeAvailabilityChecker::checkNode(NodeSetState* nodeset_state,
     return NodeStatus::NOT_AVAILABLE;
   }
 
+  if (!checkShardQoS(shard)) {
+    // The shard's disk is degraded according to its gossiped QoS score
+    return NodeStatus::NOT_AVAILABLE;
+  }
+
   node_index_t dest_id = shard.node();
   ClientID our_name_at_peer;
 
@@ -169,6 +175,19 @@ bool NodeAvailabilityChecker::checkIsGraylisted(node_index_t index) const {
   return getGraylistedNodes().count(index) != 0;
 }
 
+bool NodeAvailabilityChecker::checkShardQoS(ShardID shard) const {
+  const int threshold = Worker::settings().gray_shard_qos_threshold;
+  if (threshold <= 0) {
+    // check disabled
+    return true;
+  }
+  ClusterState* cluster_state = Worker::getClusterState();
+  if (cluster_state == nullptr) {
+    return true;
+  }
+  return cluster_state->getShardQoS(shard.node(), shard.shard()) >= threshold;
+}
+
 const std::unordered_set<node_index_t>&
 NodeAvailabilityChecker::getGraylistedNodes() const {
   return Worker::onThisThread()->getGraylistedNodes();
@@ -80,6 +80,14 @@ class NodeAvailabilityChecker {
   //         false when the node is not graylisted
   virtual bool checkIsGraylisted(node_index_t index) const;
 
+  // check the shard's storage QoS score, as published by its node through
+  // gossip, against the configured gray-shard-qos-threshold
+  // @return true    if the check is disabled (threshold of 0) or the shard's
+  //                 score is at or above the threshold
+  //         false   the shard's disk is degraded and the shard should be
+  //                 considered unavailable
+  virtual bool checkShardQoS(ShardID shard) const;
+
   virtual const std::unordered_set<node_index_t>& getGraylistedNodes() const;
 
   // get the NodesConfiguration of the cluster. override in tests
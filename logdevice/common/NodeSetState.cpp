@@ -433,6 +433,7 @@ void NodeSetState::clearNotAvailableUntil(ShardID shard) {
   // We allow num to be negative because Thread A would eventually wake up and
   // increase the num counter, making the num correct again.
   num--;
+  health_generation_.fetch_add(1, std::memory_order_release);
   return;
 }
 
@@ -544,6 +545,10 @@ bool NodeSetState::setNotAvailableUntil(
     new_reason_unavailable_count++;
   }
 
+  if (old_reason != new_reason) {
+    health_generation_.fetch_add(1, std::memory_order_release);
+  }
+
   return true;
 }
 
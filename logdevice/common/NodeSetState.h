@@ -236,6 +236,16 @@ class NodeSetState : public std::enable_shared_from_this<NodeSetState> {
         reason == NotAvailableReason::LOW_WATERMARK_NOSPC;
   }
 
+  /**
+   * Monotonic counter bumped every time a shard in this nodeset changes
+   * availability state. Consumers (e.g. CachingCopySetManager) compare it
+   * against a remembered value to decide whether results derived from the
+   * nodeset state are still valid, without re-reading per-shard atomics.
+   */
+  uint64_t healthGeneration() const {
+    return health_generation_.load(std::memory_order_acquire);
+  }
+
   bool grayListingEnabledInSettings() const;
 
   /**
@@ -341,6 +351,9 @@ class NodeSetState : public std::enable_shared_from_this<NodeSetState> {
   std::atomic<nodeset_ssize_t> availability_counters_[static_cast<uint8_t>(
       NotAvailableReason::Count)] = {};
 
+  // see healthGeneration()
+  std::atomic<uint64_t> health_generation_{0};
+
   // controls when NodeSetState can be refreshed next
   std::atomic<std::chrono::steady_clock::duration> no_refresh_until_{
       std::chrono::steady_clock::duration::min()};
@@ -10,63 +10,82 @@
 
 #include "logdevice/common/protocol/ProtocolReader.h"
 #include "logdevice/common/protocol/ProtocolWriter.h"
+#include "logdevice/common/util.h"
 
 namespace facebook { namespace logdevice {
 
+constexpr counter_type_t OffsetMap::kCounterTypes[];
+
 OffsetMap::OffsetMap(
     std::initializer_list<std::pair<const counter_type_t, uint64_t>>
-        list) noexcept {
+        list) noexcept
+    : OffsetMap() {
   for (const auto& it : list) {
     setCounter(it.first, it.second);
   }
 }
 
-OffsetMap::OffsetMap(const OffsetMap& om) noexcept {
-  counterTypeMap_ = om.getCounterMap();
-}
-
 void OffsetMap::setCounter(const counter_type_t counter_type,
                            uint64_t counter_val) {
-  if (counter_val == BYTE_OFFSET_INVALID) {
-    counterTypeMap_.erase(counter_type);
-  } else {
-    counterTypeMap_[counter_type] = counter_val;
+  const int idx = counterIndex(counter_type);
+  // Setting a counter type that is not in kCounterTypes is a programming
+  // error; add the type to kCounterTypes to start tracking it.
+  ld_check(idx != -1);
+  if (idx != -1) {
+    counters_[idx] = counter_val;
   }
 }
 
 bool OffsetMap::isValid() const {
-  return counterTypeMap_.size() > 0;
+  for (uint64_t counter_val : counters_) {
+    if (counter_val != BYTE_OFFSET_INVALID) {
+      return true;
+    }
+  }
+  return false;
 }
 
 uint64_t OffsetMap::getCounter(const counter_type_t counter_type) const {
-  auto it = counterTypeMap_.find(counter_type);
-  if (it == counterTypeMap_.end()) {
-    return BYTE_OFFSET_INVALID;
-  }
-  return it->second;
+  const int idx = counterIndex(counter_type);
+  return idx == -1 ? BYTE_OFFSET_INVALID : counters_[idx];
 }
 
-const std::map<counter_type_t, uint64_t>& OffsetMap::getCounterMap() const {
-  return counterTypeMap_;
+std::map<counter_type_t, uint64_t> OffsetMap::getCounterMap() const {
+  std::map<counter_type_t, uint64_t> map;
+  for (size_t i = 0; i < kNumCounters; ++i) {
+    if (counters_[i] != BYTE_OFFSET_INVALID) {
+      map[kCounterTypes[i]] = counters_[i];
+    }
+  }
+  return map;
 }
 
 void OffsetMap::clear() {
-  counterTypeMap_.clear();
+  counters_.fill(BYTE_OFFSET_INVALID);
 }
 
 void OffsetMap::unsetCounter(counter_type_t counter_type) {
-  counterTypeMap_.erase(counter_type);
+  const int idx = counterIndex(counter_type);
+  if (idx != -1) {
+    counters_[idx] = BYTE_OFFSET_INVALID;
+  }
 }
 
 bool OffsetMap::isValidOffset(const counter_type_t counter_type) const {
-  return counterTypeMap_.find(counter_type) != counterTypeMap_.end();
+  return getCounter(counter_type) != BYTE_OFFSET_INVALID;
 }
 
 void OffsetMap::serialize(ProtocolWriter& writer) const {
-  writer.write(static_cast<uint8_t>(counterTypeMap_.size()));
-  for (const auto& counter : counterTypeMap_) {
-    writer.write(counter.first);
-    writer.write(counter.second);
+  uint8_t size = 0;
+  for (uint64_t counter_val : counters_) {
+    size += counter_val != BYTE_OFFSET_INVALID;
+  }
+  writer.write(size);
+  for (size_t i = 0; i < kNumCounters; ++i) {
+    if (counters_[i] != BYTE_OFFSET_INVALID) {
+      writer.write(kCounterTypes[i]);
+      writer.write(counters_[i]);
+    }
   }
 }
 
@@ -84,20 +103,18 @@ void OffsetMap::deserialize(ProtocolReader& reader,
       err = E::BADMSG;
       return;
     }
-    counterTypeMap_[counter_type] = counter_val;
+    const int idx = counterIndex(counter_type);
+    if (idx == -1) {
+      // A counter type this build does not track, presumably written by a
+      // newer version. Drop it; counters are best-effort.
+      continue;
+    }
+    counters_[idx] = counter_val;
   }
 }
 
 bool OffsetMap::operator==(const OffsetMap& om) const {
-  if (counterTypeMap_.size() != om.counterTypeMap_.size()) {
-    return false;
-  }
-  for (auto& it : counterTypeMap_) {
-    if (it.second != om.getCounter(it.first)) {
-      return false;
-    }
-  }
-  return true;
+  return counters_ == om.counters_;
 }
 
 bool OffsetMap::operator!=(const OffsetMap& om) const {
@@ -106,46 +123,59 @@ bool OffsetMap::operator!=(const OffsetMap& om) const {
 
 OffsetMap OffsetMap::mergeOffsets(OffsetMap lhs, const OffsetMap& rhs) {
   OffsetMap om = std::move(lhs);
-  for (auto& it : rhs.counterTypeMap_) {
-    om.counterTypeMap_[it.first] += it.second;
+  for (size_t i = 0; i < kNumCounters; ++i) {
+    if (rhs.counters_[i] == BYTE_OFFSET_INVALID) {
+      continue;
+    }
+    const uint64_t lhs_val =
+        om.counters_[i] == BYTE_OFFSET_INVALID ? 0 : om.counters_[i];
+    om.counters_[i] = lhs_val + rhs.counters_[i];
   }
   return om;
 }
 
 OffsetMap OffsetMap::getOffsetsDifference(OffsetMap lhs, const OffsetMap& rhs) {
   OffsetMap om = std::move(lhs);
-  for (auto& it : rhs.counterTypeMap_) {
-    ld_check(om.counterTypeMap_[it.first] >= it.second);
-    om.counterTypeMap_[it.first] -= it.second;
+  for (size_t i = 0; i < kNumCounters; ++i) {
+    if (rhs.counters_[i] == BYTE_OFFSET_INVALID) {
+      continue;
+    }
+    const uint64_t lhs_val =
+        om.counters_[i] == BYTE_OFFSET_INVALID ? 0 : om.counters_[i];
+    ld_check(lhs_val >= rhs.counters_[i]);
+    om.counters_[i] = lhs_val - rhs.counters_[i];
   }
   return om;
 }
 
 OffsetMap OffsetMap::operator*(uint64_t scalar) const {
   OffsetMap om;
-  for (auto& it : counterTypeMap_) {
-    om.counterTypeMap_[it.first] = it.second * scalar;
+  for (size_t i = 0; i < kNumCounters; ++i) {
+    if (counters_[i] != BYTE_OFFSET_INVALID) {
+      om.counters_[i] = counters_[i] * scalar;
+    }
   }
   return om;
 }
 
-OffsetMap& OffsetMap::operator=(const OffsetMap& om) noexcept {
-  counterTypeMap_ = om.getCounterMap();
-  return *this;
-}
-
 OffsetMap& OffsetMap::operator=(OffsetMap&& om) noexcept {
-  counterTypeMap_ = std::move(om.counterTypeMap_);
+  counters_ = om.counters_;
+  om.clear();
   return *this;
 }
 
-OffsetMap::OffsetMap(OffsetMap&& om) noexcept {
-  counterTypeMap_ = std::move(om.counterTypeMap_);
+OffsetMap::OffsetMap(OffsetMap&& om) noexcept : counters_(om.counters_) {
+  om.clear();
 }
 
 void OffsetMap::max(const OffsetMap& om) {
-  for (auto& it : om.getCounterMap()) {
-    counterTypeMap_[it.first] = std::max(it.second, counterTypeMap_[it.first]);
+  for (size_t i = 0; i < kNumCounters; ++i) {
+    if (om.counters_[i] == BYTE_OFFSET_INVALID) {
+      continue;
+    }
+    const uint64_t this_val =
+        counters_[i] == BYTE_OFFSET_INVALID ? 0 : counters_[i];
+    counters_[i] = std::max(om.counters_[i], this_val);
   }
 }
 
@@ -157,73 +187,81 @@ OffsetMap OffsetMap::fromLegacy(uint64_t offset) {
 
 RecordOffset OffsetMap::toRecord(OffsetMap om) {
   RecordOffset ro;
-  ro.offset_map->counterTypeMap_ = std::move(om.counterTypeMap_);
+  ro.offset_map->counters_ = om.counters_;
   return ro;
 }
 
 OffsetMap OffsetMap::fromRecord(RecordOffset record_offset) {
   OffsetMap om;
-  om.counterTypeMap_ = std::move(record_offset.offset_map->counterTypeMap_);
+  om.counters_ = record_offset.offset_map->counters_;
   return om;
 }
 
 std::string OffsetMap::toString() const {
   std::string res = "{";
   bool first = true;
-  for (const auto& counter : counterTypeMap_) {
+  for (size_t i = 0; i < kNumCounters; ++i) {
+    if (counters_[i] == BYTE_OFFSET_INVALID) {
+      continue;
+    }
     if (!first) {
       res += ", ";
     }
     first = false;
-    res += std::to_string(counter.first);
+    res += std::to_string(kCounterTypes[i]);
     res += ":";
-    if (counter.second == BYTE_OFFSET_INVALID) {
-      res += "invalid";
-    } else {
-      res += std::to_string(counter.second);
-    }
+    res += std::to_string(counters_[i]);
   }
   res += "}";
   return res;
 }
 
+AtomicOffsetMap::AtomicOffsetMap() noexcept {
+  for (auto& slot : atomicCounters_) {
+    slot.store(BYTE_OFFSET_INVALID, std::memory_order_relaxed);
+  }
+}
+
+void AtomicOffsetMap::markSlotSet(std::atomic<uint64_t>& slot) {
+  uint64_t expected = BYTE_OFFSET_INVALID;
+  slot.compare_exchange_strong(expected, 0);
+}
+
 void AtomicOffsetMap::atomicFetchMax(const OffsetMap& offsets_map) {
-  FairRWLock::UpgradeHolder upgradeLock(rw_lock_);
-  for (const auto& it : offsets_map.getCounterMap()) {
-    auto iterator = atomicCounterTypeMap_.find(it.first);
-    if (iterator == atomicCounterTypeMap_.end()) {
-      FairRWLock::WriteHolder writeLock(std::move(upgradeLock));
-      atomic_fetch_max(atomicCounterTypeMap_[it.first], it.second);
-      upgradeLock = FairRWLock::UpgradeHolder(std::move(writeLock));
-    } else {
-      atomic_fetch_max(atomicCounterTypeMap_[it.first], it.second);
+  for (size_t i = 0; i < OffsetMap::kNumCounters; ++i) {
+    const uint64_t counter_val =
+        offsets_map.getCounter(OffsetMap::kCounterTypes[i]);
+    if (counter_val == BYTE_OFFSET_INVALID) {
+      continue;
     }
+    markSlotSet(atomicCounters_[i]);
+    atomic_fetch_max(atomicCounters_[i], counter_val);
   }
 }
 
 OffsetMap AtomicOffsetMap::load() const {
   OffsetMap om;
-  FairRWLock::ReadHolder read_guard(rw_lock_);
-  for (const auto& it : atomicCounterTypeMap_) {
-    om.setCounter(it.first, it.second.load());
+  for (size_t i = 0; i < OffsetMap::kNumCounters; ++i) {
+    const uint64_t counter_val = atomicCounters_[i].load();
+    if (counter_val != BYTE_OFFSET_INVALID) {
+      om.setCounter(OffsetMap::kCounterTypes[i], counter_val);
+    }
   }
   return om;
 }
 
 OffsetMap AtomicOffsetMap::fetchAdd(const OffsetMap& offsets_map) {
   OffsetMap om;
-  uint64_t offset;
-  FairRWLock::UpgradeHolder upgradeLock(rw_lock_);
-  for (const auto& it : offsets_map.getCounterMap()) {
-    auto iterator = atomicCounterTypeMap_.find(it.first);
-    if (iterator == atomicCounterTypeMap_.end()) {
-      FairRWLock::WriteHolder writeLock(std::move(upgradeLock));
-      offset = atomicCounterTypeMap_[it.first].fetch_add(it.second) + it.second;
-      upgradeLock = FairRWLock::UpgradeHolder(std::move(writeLock));
-    } else {
-      offset = atomicCounterTypeMap_[it.first].fetch_add(it.second) + it.second;
+  for (size_t i = 0; i < OffsetMap::kNumCounters; ++i) {
+    const uint64_t counter_val =
+        offsets_map.getCounter(OffsetMap::kCounterTypes[i]);
+    if (counter_val == BYTE_OFFSET_INVALID) {
+      continue;
     }
-    om.setCounter(it.first, offset);
+    markSlotSet(atomicCounters_[i]);
+    const uint64_t offset =
+        atomicCounters_[i].fetch_add(counter_val) + counter_val;
+    om.setCounter(OffsetMap::kCounterTypes[i], offset);
   }
   return om;
 }
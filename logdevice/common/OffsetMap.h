@@ -8,11 +8,10 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <map>
 
-#include <folly/SharedMutex.h>
-
 #include "logdevice/common/SerializableData.h"
 #include "logdevice/include/RecordOffset.h"
 
@@ -22,6 +21,12 @@ namespace facebook { namespace logdevice {
  * @file map of counters that contains information on amount of data within
  *       epoch or at the end of epoch. Currently contains information on number
  *       of bytes. Refer to counter_type_t for information on tracked counters.
+ *
+ *       The set of counter types is fixed at compile time (kCounterTypes),
+ *       so the map is stored as a flat array indexed by counterIndex().
+ *       Reading or updating a counter is a single array access with no
+ *       allocation, which matters on the append path where a counter is
+ *       updated for every record.
  */
 
 class OffsetMap : public SerializableData {
@@ -29,7 +34,31 @@ class OffsetMap : public SerializableData {
   using SerializableData::deserialize;
   using SerializableData::serialize;
 
-  OffsetMap() noexcept = default;
+  // Counter types tracked by OffsetMap, in ascending order. The ascending
+  // order keeps serialize() wire-compatible with the older map-based
+  // representation, which wrote entries in key order.
+  static constexpr counter_type_t kCounterTypes[] = {BYTE_OFFSET};
+  static constexpr size_t kNumCounters =
+      sizeof(kCounterTypes) / sizeof(kCounterTypes[0]);
+
+  /**
+   * Slot of the given counter type in kCounterTypes, or -1 if the type is
+   * not tracked. With the current single-counter set this compiles down to
+   * one comparison.
+   */
+  static constexpr int counterIndex(counter_type_t counter_type) {
+    for (size_t i = 0; i < kNumCounters; ++i) {
+      if (kCounterTypes[i] == counter_type) {
+        return static_cast<int>(i);
+      }
+    }
+    return -1;
+  }
+
+  OffsetMap() noexcept {
+    counters_.fill(BYTE_OFFSET_INVALID);
+  }
+
   /*
    * Constructs an OffsetMap object from intializer_list. This constructor
    * performs setCounter(counter_type, counter_value) on each pair of the list
@@ -39,34 +68,35 @@ class OffsetMap : public SerializableData {
       std::initializer_list<std::pair<const counter_type_t, uint64_t>>
           list) noexcept;
 
-  OffsetMap(const OffsetMap& om) noexcept;
-  OffsetMap& operator=(const OffsetMap& om) noexcept;
+  OffsetMap(const OffsetMap& om) noexcept = default;
+  OffsetMap& operator=(const OffsetMap& om) noexcept = default;
 
   OffsetMap(OffsetMap&& om) noexcept;
   OffsetMap& operator=(OffsetMap&& om) noexcept;
 
   /**
-   * get counter_type value from CounterTypeMap
+   * get counter_type value
    * @param counter_type to read
    * @return  value of counter_type
    */
   uint64_t getCounter(counter_type_t counter_type) const;
 
   /**
-   * get counterTypeMap_
-   * @return  counterTypeMap_
+   * Materializes a std::map of the valid counters, e.g. for storing in a
+   * Thrift structure.
+   * @return  map of <counter_type, counter_value> for all valid counters
    */
-  const std::map<counter_type_t, uint64_t>& getCounterMap() const;
+  std::map<counter_type_t, uint64_t> getCounterMap() const;
 
   /**
-   * removes counter_type from counterTypeMap_
-   * @param counter_type  counter_type to remove from counterTypeMap_
+   * marks counter_type invalid (not set)
+   * @param counter_type  counter_type to unset
    */
   void unsetCounter(counter_type_t counter_type);
 
   /**
-   * set counter_type value from CounterTypeMap
-   * @param counter_type counter_type_t to add to counterTypeMap_
+   * set counter_type value
+   * @param counter_type counter_type_t to set; must be one of kCounterTypes
    * @param counter_val  value to set for counter_type
    */
   void setCounter(const counter_type_t counter_type, uint64_t counter_val);
@@ -78,20 +108,18 @@ class OffsetMap : public SerializableData {
   bool isValidOffset(const counter_type_t count) const;
 
   /**
-   * counterTypeMap_ would have BYTE_OFFSET_INVALID value for all counters
+   * All counters are set to BYTE_OFFSET_INVALID (unset)
    */
   void clear();
 
   /**
    * Check if OffsetMap is valid
-   * @return true if contains at least one counter exists
-   * (counterTypeMap_ size > 0)
+   * @return true if at least one counter is set
    */
   bool isValid() const;
 
   /**
-   * set counterTypeMap_ entries to be equal to the max of both OffsetMap
-   * entries
+   * set counter entries to be equal to the max of both OffsetMap entries
    */
   void max(const OffsetMap& om);
 
@@ -151,19 +179,22 @@ class OffsetMap : public SerializableData {
   // Multiply all entry by scalar
   OffsetMap operator*(uint64_t scalar) const;
 
-  // Check if the counterTypeMap_ are equal
+  // Check if the counters are equal
   bool operator==(const OffsetMap& om) const;
 
-  // Check if the counterTypeMap_ are not equal
+  // Check if the counters are not equal
   bool operator!=(const OffsetMap& om) const;
 
  private:
-  std::map<counter_type_t, uint64_t> counterTypeMap_;
+  // One slot per entry of kCounterTypes. A slot holding BYTE_OFFSET_INVALID
+  // means the counter is unset, matching the semantics of the older map-based
+  // representation where such counters were absent from the map.
+  std::array<uint64_t, kNumCounters> counters_;
 };
 
 class AtomicOffsetMap {
  public:
-  AtomicOffsetMap() noexcept = default;
+  AtomicOffsetMap() noexcept;
 
   /*
    * Performs atomic_fetch_max on every entry of offsets_map
@@ -181,9 +212,16 @@ class AtomicOffsetMap {
   OffsetMap fetchAdd(const OffsetMap& offsets_map);
 
  private:
-  using FairRWLock = folly::SharedMutexWritePriority;
-  FairRWLock rw_lock_;
-  std::map<counter_type_t, std::atomic<uint64_t>> atomicCounterTypeMap_;
+  // Flips a slot from the unset sentinel to zero so that fetch_add /
+  // fetch_max see an initial value of zero, as the map-based representation
+  // did when it default-constructed an entry. Lock-free; safe to race.
+  static void markSlotSet(std::atomic<uint64_t>& slot);
+
+  // Mirrors OffsetMap's flat layout with one atomic per tracked counter
+  // type, making fetchAdd() on the append path a plain lock-free fetch_add
+  // instead of a map lookup under a shared mutex. Slots start at
+  // BYTE_OFFSET_INVALID (counter unset).
+  std::array<std::atomic<uint64_t>, OffsetMap::kNumCounters> atomicCounters_;
 };
 
 }} // namespace facebook::logdevice
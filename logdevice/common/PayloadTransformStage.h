@@ -0,0 +1,49 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <folly/Range.h>
+
+#include "logdevice/common/PayloadHolder.h"
+#include "logdevice/include/Err.h"
+#include "logdevice/include/types.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Pluggable stage applied to append payloads before they enter the
+ * write path: compression, envelope encryption, schema validation and the
+ * like.  Loaded once per Processor through
+ * PluginType::PAYLOAD_TRANSFORM_STAGE_FACTORY and shared by all Workers.
+ *
+ * The same stage runs on clients (ClientImpl::append(), on the caller's
+ * thread) and on sequencer nodes (AppenderPrep, on a background thread), so
+ * a deployment can place the transform on whichever side holds the keys or
+ * the schema.
+ */
+
+class PayloadTransformStage {
+ public:
+  /**
+   * Transforms `payloads' in place; one entry per append, all destined for
+   * `log_id'.  Implementations are encouraged to vectorize across the batch.
+   *
+   * Must be thread-safe: calls come from application and background threads,
+   * never from a Worker, so a slow transform does not stall event loops.
+   *
+   * @return  E::OK if every payload was transformed; any other status fails
+   *          the whole batch and becomes the append status reported to the
+   *          writer.
+   */
+  virtual Status transform(logid_t log_id,
+                           folly::Range<PayloadHolder*> payloads) = 0;
+
+  virtual ~PayloadTransformStage() {}
+};
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,129 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/PrincipalThrottle.h"
+
+#include "logdevice/common/PrincipalIdentity.h"
+#include "logdevice/common/Processor.h"
+#include "logdevice/common/SecurityInformation.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/configuration/ServerConfig.h"
+
+namespace facebook { namespace logdevice {
+
+PrincipalThrottle::Throttle*
+PrincipalThrottle::findThrottle(const PrincipalIdentity* identity) {
+  if (identity == nullptr) {
+    return nullptr;
+  }
+  Worker* w = Worker::onThisThread(false);
+  if (w == nullptr) {
+    return nullptr;
+  }
+  auto scfg = w->getServerConfig();
+
+  auto lookup = [&](const std::string& name) -> Throttle* {
+    auto it = throttles_.find(name);
+    if (it == throttles_.end()) {
+      auto principal = scfg->getPrincipalByName(&name);
+      if (principal == nullptr) {
+        return nullptr;
+      }
+      Throttle throttle;
+      // Each Worker admits its even share of the ceilings; see the header
+      // for why the shares add up.
+      const size_t nworkers =
+          std::max(1, w->processor_->getWorkerCount(WorkerType::GENERAL));
+      if (principal->max_read_rate != RATE_UNLIMITED) {
+        rate_limit_t limit = principal->max_read_rate;
+        limit.first = std::max<size_t>(1, limit.first / nworkers);
+        throttle.read_limited = true;
+        throttle.read_limiter = RateLimiter(limit);
+      }
+      if (principal->max_append_rate != RATE_UNLIMITED) {
+        rate_limit_t limit = principal->max_append_rate;
+        limit.first = std::max<size_t>(1, limit.first / nworkers);
+        throttle.append_limited = true;
+        throttle.append_limiter = RateLimiter(limit);
+      }
+      it = throttles_.emplace(name, std::move(throttle)).first;
+    }
+    return it->second.read_limited || it->second.append_limited ? &it->second
+                                                                : nullptr;
+  };
+
+  // Mirrors the max_read_traffic_class lookup in START_onReceived(): the
+  // first identity with a configured ceiling wins. Fall back to the
+  // assigned well-known principal so that e.g. "unauthenticated" traffic
+  // can be capped as a whole.
+  for (const auto& kv : identity->identities) {
+    if (Throttle* t = lookup(kv.second)) {
+      return t;
+    }
+  }
+  if (!identity->type.empty()) {
+    return lookup(identity->type);
+  }
+  return nullptr;
+}
+
+bool PrincipalThrottle::chargeRead(const PrincipalIdentity* identity,
+                                   size_t bytes) {
+  Throttle* t = findThrottle(identity);
+  if (t == nullptr || !t->read_limited) {
+    return true;
+  }
+  t->read_bytes += bytes;
+  if (bytes > 0) {
+    // Always pay for what was already read, letting the budget run
+    // negative; further reads are deferred until it's nonnegative again.
+    RateLimiter::Duration unused;
+    t->read_limiter.isAllowed(bytes, &unused);
+  }
+  if (!t->read_limiter.isAllowed(0)) {
+    ++t->read_deferrals;
+    return false;
+  }
+  return true;
+}
+
+bool PrincipalThrottle::allowAppend(const PrincipalIdentity* identity,
+                                    size_t cost) {
+  Throttle* t = findThrottle(identity);
+  if (t == nullptr || !t->append_limited) {
+    return true;
+  }
+  if (!t->append_limiter.isAllowed(cost)) {
+    ++t->append_rejections;
+    return false;
+  }
+  t->append_bytes += cost;
+  return true;
+}
+
+std::vector<PrincipalThrottle::Consumption>
+PrincipalThrottle::getConsumption() const {
+  std::vector<Consumption> out;
+  out.reserve(throttles_.size());
+  for (const auto& kv : throttles_) {
+    const Throttle& t = kv.second;
+    if (!t.read_limited && !t.append_limited) {
+      // Cached negative lookup; nothing to report.
+      continue;
+    }
+    out.push_back(Consumption{kv.first,
+                              t.read_limited,
+                              t.append_limited,
+                              t.read_bytes,
+                              t.read_deferrals,
+                              t.append_bytes,
+                              t.append_rejections});
+  }
+  return out;
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,108 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <folly/container/F14Map.h>
+
+#include "logdevice/common/RateLimiter.h"
+
+/**
+ * @file Per-Worker enforcement of the per-principal throughput ceilings
+ *       configured in the "principals" section of the config. Traffic
+ *       shaping's flow groups classify by peer scope and traffic class, so
+ *       on a multi-tenant cluster one misbehaving client saturates the same
+ *       flow groups everyone else's traffic goes through. A principal can
+ *       now also carry "max_read_rate" and "max_append_rate" ceilings:
+ *       reads and appends on connections authenticated as that principal
+ *       are capped at the edge (CatchupQueue scheduling and AppenderPrep
+ *       admission respectively), while remaining subject to the flow group
+ *       they inherit through max_read_traffic_class as before.
+ *
+ *       Each Worker owns one instance and admits its even share of the
+ *       configured ceilings, mirroring LogGroupAppendThrottle: client
+ *       connections are spread across Workers, so the shares add up to the
+ *       ceiling without any cross-thread coordination.
+ *
+ *       Per-principal consumption is exposed through the
+ *       "info principal_shaping" admin command and the corresponding
+ *       ldquery table.
+ */
+
+namespace facebook { namespace logdevice {
+
+struct PrincipalIdentity;
+
+class PrincipalThrottle {
+ public:
+  /**
+   * Reports `bytes` of records queued for a client authenticated as
+   * `identity` and returns whether catchup may schedule more reads for it.
+   * The cost of a batch is only known after reading it, so reads are
+   * charged after the fact and the budget is allowed to run negative
+   * (RateLimiter usage mode 4); catchup then pauses until the debt has
+   * been paid off. Principals without a ceiling are always allowed.
+   */
+  bool chargeRead(const PrincipalIdentity* identity, size_t bytes);
+
+  /**
+   * Charges `cost` bytes of append payload against the principal's append
+   * budget.
+   *
+   * @return false if the principal has a configured ceiling and is over
+   *         it, in which case the append should be rejected; nothing is
+   *         charged in that case.
+   */
+  bool allowAppend(const PrincipalIdentity* identity, size_t cost);
+
+  // Per-principal consumption counters, as reported by the
+  // "info principal_shaping" admin command.
+  struct Consumption {
+    std::string principal;
+    bool read_limited;
+    bool append_limited;
+    size_t read_bytes;
+    size_t read_deferrals;
+    size_t append_bytes;
+    size_t append_rejections;
+  };
+  std::vector<Consumption> getConsumption() const;
+
+  /**
+   * Drops all cached throttles so that changed principal attributes are
+   * picked up. Called from Worker::onServerConfigUpdated().
+   */
+  void noteConfigUpdated() {
+    throttles_.clear();
+  }
+
+ private:
+  struct Throttle {
+    bool read_limited{false};
+    bool append_limited{false};
+    RateLimiter read_limiter;
+    RateLimiter append_limiter;
+    size_t read_bytes{0};
+    size_t read_deferrals{0};
+    size_t append_bytes{0};
+    size_t append_rejections{0};
+  };
+
+  // Resolves the connection's identities against the principals in config
+  // and returns the throttle of the first one carrying a ceiling, or
+  // nullptr if none of them does.
+  Throttle* findThrottle(const PrincipalIdentity* identity);
+
+  // Keyed by principal name; ceilings are parsed out of the config once
+  // per principal per server config version.
+  folly::F14FastMap<std::string, Throttle> throttles_;
+};
+
+}} // namespace facebook::logdevice
@@ -16,6 +16,7 @@
 #include <folly/Hash.h>
 #include <folly/MPMCQueue.h>
 #include <folly/Memory.h>
+#include <folly/Random.h>
 #include <folly/container/Array.h>
 #include <folly/synchronization/CallOnce.h>
 
@@ -46,6 +47,7 @@
 #include "logdevice/common/configuration/nodes/NodesConfigurationManager.h"
 #include "logdevice/common/event_log/EventLogRebuildingSet.h"
 #include "logdevice/common/plugin/CommonBuiltinPlugins.h"
+#include "logdevice/common/plugin/PayloadTransformStageFactory.h"
 #include "logdevice/common/plugin/SequencerLocatorFactory.h"
 #include "logdevice/common/plugin/StaticPluginLoader.h"
 #include "logdevice/common/plugin/ThriftClientFactoryPlugin.h"
@@ -239,6 +241,13 @@ void Processor::init() {
   security_info_ = std::make_unique<UpdateableSecurityInfo>(
       config_->updateableServerConfig(), plugin_registry_, settings_->server);
 
+  auto transform_factory =
+      plugin_registry_->getSinglePlugin<PayloadTransformStageFactory>(
+          PluginType::PAYLOAD_TRANSFORM_STAGE_FACTORY);
+  if (transform_factory) {
+    payload_transform_stage_ = (*transform_factory)();
+  }
+
   for (int i = 0; i < numOfWorkerTypes(); i++) {
     WorkerType worker_type = workerTypeByIndex(i);
     auto count = getWorkerCount(worker_type);
@@ -305,6 +314,8 @@ workers_t Processor::createWorkerPool(WorkerType type, size_t count) {
               local_settings->lo_requests_per_iteration),
           EvBase::FOLLY_EVENTBASE,
           /* start_running */ false));
+      loops.back()->getTaskQueue().setIterationBudget(
+          local_settings->worker_iteration_overrun_threshold);
       auto executor = folly::getKeepAliveToken(loops.back().get());
       worker.reset(createWorker(std::move(executor), worker_id_t(i), type));
     } catch (ConstructorFailed&) {
@@ -372,6 +383,26 @@ worker_id_t Processor::selectWorkerRandomly(uint64_t seed, WorkerType type) {
   return worker_id_t(folly::hash::twang_mix64(seed) % count);
 }
 
+worker_id_t Processor::selectWorkerIdForLog(logid_t log_id, int nworkers) {
+  ld_check_gt(nworkers, 0);
+  return worker_id_t(folly::hash::twang_mix64(log_id.val_) % nworkers);
+}
+
+worker_id_t Processor::selectWorkerQueueAware(WorkerType type) {
+  const auto count = getWorkerCount(type);
+  ld_check_gt(count, 0);
+  if (count == 1) {
+    return worker_id_t(0);
+  }
+  // Pick two distinct workers at random and route to the one with the
+  // shallower request queue (power of two choices).
+  size_t index1 = folly::Random::rand32(count);
+  size_t index2 = (index1 + folly::Random::rand32(1, count)) % count;
+  size_t depth1 = getWorker(worker_id_t(index1), type).getNumRequestsEnqueued();
+  size_t depth2 = getWorker(worker_id_t(index2), type).getNumRequestsEnqueued();
+  return worker_id_t(depth2 < depth1 ? index2 : index1);
+}
+
 int Processor::getTargetThreadForRequest(const std::unique_ptr<Request>& rq) {
   WorkerType worker_type = rq->getWorkerTypeAffinity();
   const int nworkers = getWorkerCount(worker_type);
@@ -384,7 +415,9 @@ int Processor::getTargetThreadForRequest(const std::unique_ptr<Request>& rq) {
   // If the Request does not care about which thread it runs on, schedule it
   // round-robin.
   if (target_thread == -1) {
-    target_thread = selectWorkerRandomly(rq->id_.val(), worker_type).val_;
+    target_thread = settings()->worker_queue_aware_routing
+        ? selectWorkerQueueAware(worker_type).val_
+        : selectWorkerRandomly(rq->id_.val(), worker_type).val_;
   }
   return target_thread;
 }
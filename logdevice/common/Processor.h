@@ -52,6 +52,7 @@ class ClientIdxAllocator;
 class ClusterState;
 class EventLogRebuildingSet;
 class EventLoop;
+class PayloadTransformStage;
 class PermissionChecker;
 class PluginRegistry;
 class PrincipalParser;
@@ -59,6 +60,7 @@ class ProcessorImpl;
 class Request;
 class SequencerBatching;
 class ReadStreamDebugInfoSamplingConfig;
+class SequencerHintsCache;
 class SequencerLocator;
 class SSLSessionCache;
 class StatsHolder;
@@ -454,6 +456,18 @@ class Processor : public folly::enable_shared_from_this<Processor>,
   // sequencer for a particular log.
   std::unique_ptr<SequencerLocator> sequencer_locator_;
 
+  // On clients, cache of per-log sequencer routing hints persisted across
+  // restarts, or nullptr if the feature is off (see --sequencer-hints-path).
+  // Owned by ClientImpl.
+  SequencerHintsCache* sequencer_hints_cache_{nullptr};
+
+  // Pluggable transform applied to append payloads on the write path, or
+  // nullptr if no plugin provides one.  Created once in init() and shared by
+  // all Workers.  See PayloadTransformStage.h.
+  std::shared_ptr<PayloadTransformStage> payloadTransformStage() const {
+    return payload_transform_stage_;
+  }
+
   // ResourceBudget used to limit the total number of accepted connections.
   // See Settings::max_incoming_connections_.
   ResourceBudget conn_budget_incoming_;
@@ -530,6 +544,23 @@ class Processor : public folly::enable_shared_from_this<Processor>,
    */
   worker_id_t selectWorkerRandomly(uint64_t seed, WorkerType type);
 
+  /**
+   * Deterministically maps a log to one worker of an `nworkers`-sized pool.
+   * This is the processor-wide log-to-Worker affinity: components that pin
+   * per-log work to a thread (log recovery, sequencer batching shards) map
+   * through this so they agree on the owning Worker and work for one log
+   * doesn't hop between Workers.
+   */
+  static worker_id_t selectWorkerIdForLog(logid_t log_id, int nworkers);
+
+  /**
+   * Selects the less loaded of two randomly chosen workers of the given
+   * type, by current request queue depth. Used instead of
+   * selectWorkerRandomly() for requests without a thread affinity when the
+   * worker-queue-aware-routing setting is enabled.
+   */
+  worker_id_t selectWorkerQueueAware(WorkerType type);
+
   /**
    * Selects a worker to process a Request when the Request owner does not
    * care.  Load-aware. This only works for WorkerType::GENERAL worker-pool
@@ -651,6 +682,9 @@ class Processor : public folly::enable_shared_from_this<Processor>,
   // Next ID for issueBufferedWriterID()
   std::atomic<buffered_writer_id_t::raw_type> next_buffered_writer_id_{1};
 
+  // See payloadTransformStage().
+  std::shared_ptr<PayloadTransformStage> payload_transform_stage_;
+
   // See isDataMissingFromShard().
   folly::ConcurrentBitSet<MAX_SHARDS> shards_not_missing_data_;
 
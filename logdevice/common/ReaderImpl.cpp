@@ -476,6 +476,10 @@ ssize_t ReaderImpl::read(size_t nrecords,
       // read stream that no longer exists, for example if the application
       // just stopped it or seeked to a different LSN.  Ignore the queue
       // entry.
+      if (head.getType() == QueueEntry::Type::DATA) {
+        // Also drop any background decode results held for the batch.
+        takePredecoded(head.getData());
+      }
       continue;
     }
 
@@ -682,9 +686,30 @@ void ReaderImpl::read_decodeBuffered(QueueEntry& entry) {
   // We shouldn't be decoding buffered writes while rebuilding
   ld_check(!entry.getData().extra_metadata_);
 
-  auto decoder = std::make_shared<BufferedWriteDecoderImpl>();
+  std::shared_ptr<BufferedWriteDecoderImpl> decoder;
   std::vector<PayloadGroup> payload_groups;
-  int rv = decoder->decodeOne(entry.releaseData(), payload_groups);
+  int rv = -1;
+
+  // If a background decode of this batch was started when it went onto the
+  // queue (see tryPredecode()), pick up its results; by the time the batch
+  // reaches the front of the queue the decode has usually long finished.  On
+  // failure fall through to the inline decode, which keeps the DATALOSS
+  // handling in one place.
+  std::shared_ptr<PredecodedBatch> predecoded = takePredecoded(entry.getData());
+  if (predecoded != nullptr) {
+    predecoded->done.wait();
+    if (predecoded->rv == 0) {
+      rv = 0;
+      decoder = std::move(predecoded->decoder);
+      payload_groups = std::move(predecoded->payload_groups);
+      entry.releaseData(); // the decoded records replace the batch
+    }
+  }
+
+  if (rv != 0) {
+    decoder = std::make_shared<BufferedWriteDecoderImpl>();
+    rv = decoder->decodeOne(entry.releaseData(), payload_groups);
+  }
   if (rv != 0) {
     // Whoops, decoding failed.  This is tragic and unlikely with checksums
     // but let's generate a DATALOSS gap to inform the client.
@@ -723,6 +748,60 @@ void ReaderImpl::read_decodeBuffered(QueueEntry& entry) {
   }
 }
 
+void ReaderImpl::tryPredecode(const DataRecordOwnsPayload& record) {
+  if (processor_ == nullptr) {
+    // tests may construct a ReaderImpl without a Processor
+    return;
+  }
+  const size_t threshold =
+      processor_->settings()->reader_bg_decode_bytes_threshold;
+  if (threshold == 0 || record.payload.size() < threshold) {
+    return;
+  }
+
+  auto state = std::make_shared<PredecodedBatch>();
+  // The job gets its own copy of the blob: the queued batch may be deleted
+  // (e.g. if the application stops reading the log) while the decode runs.
+  std::string blob(static_cast<const char*>(record.payload.data()),
+                   record.payload.size());
+  const logid_t log_id = record.logid;
+  const DataRecordAttributes attrs = record.attrs;
+
+  auto job = [state, log_id, attrs, blob = std::move(blob)]() mutable {
+    auto decoder = std::make_shared<BufferedWriteDecoderImpl>();
+    // Non-owning overload with buffer sharing disabled: decoded payloads end
+    // up in buffers owned by `decoder' or the PayloadGroups, so the blob
+    // copy can die as soon as we're done here.
+    DataRecord blob_record(
+        log_id, Payload(blob.data(), blob.size()), attrs.lsn, attrs.timestamp);
+    state->rv = decoder->decodeOne(blob_record, state->payload_groups);
+    if (state->rv == 0) {
+      state->decoder = std::move(decoder);
+    }
+    state->done.post();
+  };
+  if (!processor_->enqueueToBackgroundIfNotFull(std::move(job))) {
+    // Background queue is full; decoding inline in read() beats queueing up
+    // even more work behind it.
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(predecoded_mutex_);
+  predecoded_[&record] = std::move(state);
+}
+
+std::shared_ptr<ReaderImpl::PredecodedBatch>
+ReaderImpl::takePredecoded(const DataRecordOwnsPayload& record) {
+  std::lock_guard<std::mutex> lock(predecoded_mutex_);
+  auto it = predecoded_.find(&record);
+  if (it == predecoded_.end()) {
+    return nullptr;
+  }
+  auto state = std::move(it->second);
+  predecoded_.erase(it);
+  return state;
+}
+
 void ReaderImpl::notifyWorker(LogState& state) {
   std::unique_ptr<Request> req =
       std::make_unique<ReaderProgressRequest>(state.handle);
@@ -795,6 +874,10 @@ int ReaderBridgeImpl::onDataRecord(
     if (BufferedWriteDecoderImpl::getBatchSize(*record, &batch_size) == 0) {
       nrecords =
           std::min<size_t>(batch_size, std::numeric_limits<uint32_t>::max());
+      // Kick off a background decode of large batches before they are
+      // queued, so read() finds them already decompressed (see
+      // reader-bg-decode-bytes-threshold).
+      owner_->tryPredecode(*record);
     }
   }
 
@@ -802,6 +885,7 @@ int ReaderBridgeImpl::onDataRecord(
   int rv = onEntry(std::move(entry), notify_when_consumed);
   if (rv != 0) {
     record = entry.releaseData();
+    owner_->takePredecoded(*record);
   }
   return rv;
 }
@@ -33,6 +33,7 @@
 
 namespace facebook { namespace logdevice {
 
+class BufferedWriteDecoderImpl;
 class Processor;
 class ReaderBridgeImpl;
 
@@ -327,6 +328,24 @@ class ReaderImpl : public Reader {
   // - Decoded BufferedWriter writes.
   std::deque<QueueEntry> pre_queue_;
 
+  // Result of one background batch decode started by tryPredecode().  Shared
+  // between the background job (producer) and read() (consumer); `done'
+  // orders the hand-off.
+  struct PredecodedBatch {
+    Semaphore done;
+    int rv{-1};
+    std::shared_ptr<BufferedWriteDecoderImpl> decoder;
+    std::vector<PayloadGroup> payload_groups;
+  };
+
+  // Background decodes in flight, or finished but not yet consumed, keyed by
+  // the queued batch whose decode they hold.  Written by workers, drained by
+  // the application thread in read_decodeBuffered().
+  std::unordered_map<const DataRecordOwnsPayload*,
+                     std::shared_ptr<PredecodedBatch>>
+      predecoded_;
+  std::mutex predecoded_mutex_;
+
   // The following members comprise the synchronization mechanism between
   // producers (ClientReadStream instances running on worker threads) and the
   // consumer (read() running on an application thread).
@@ -447,6 +466,21 @@ class ReaderImpl : public Reader {
   // generated instead.
   void read_decodeBuffered(QueueEntry& entry);
 
+  // Called by ReaderBridgeImpl on a worker thread just before a
+  // buffered-write batch goes onto `queue_'.  If the batch is at least
+  // reader-bg-decode-bytes-threshold bytes, starts decoding it on the client
+  // Processor's background threads so that several queued batches decompress
+  // in parallel while read() drains the queue; read_decodeBuffered() finds
+  // the results ready (or nearly so) by the time the batch reaches the front
+  // of the queue.  The queue order is untouched, so delivery order is
+  // preserved for free.
+  void tryPredecode(const DataRecordOwnsPayload& record);
+
+  // Removes and returns the background decode state for `record', or nullptr
+  // if there isn't one.
+  std::shared_ptr<PredecodedBatch>
+  takePredecoded(const DataRecordOwnsPayload& record);
+
   ReaderBridge* TEST_getBridge();
 
   friend class TestReader;
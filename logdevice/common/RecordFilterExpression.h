@@ -0,0 +1,121 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+#include <cstdint>
+#include <string>
+
+#include <folly/Range.h>
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Bytecode format for server-side record filter expressions.
+ *       A filter expression is a small stack program evaluated against a
+ *       record's FILTERABLE key by ServerRecordExpressionFilter during the
+ *       storage scan. Clients build the program with
+ *       RecordFilterExpressionBuilder and ship the serialized bytes as
+ *       filter_key1 of a START message with filter type EXPRESSION.
+ *       Experimental feature: Use with caution.
+ */
+
+/**
+ * One-byte opcodes. Comparison ops push a bool; AND/OR/NOT combine the
+ * top of the stack. A valid program leaves exactly one bool on the stack.
+ *
+ * Encoding of operands:
+ *  - string operands are a 2-byte little-endian length followed by bytes;
+ *  - BYTE_EQ takes a 2-byte little-endian key offset and a 1-byte value.
+ */
+enum class RecordFilterOp : uint8_t {
+  // key == operand
+  KEY_EQ = 1,
+  // key < operand
+  KEY_LT = 2,
+  // key <= operand
+  KEY_LE = 3,
+  // key > operand
+  KEY_GT = 4,
+  // key >= operand
+  KEY_GE = 5,
+  // key starts with operand
+  KEY_PREFIX = 6,
+  // key[offset] == value; false if key is shorter than offset + 1
+  BYTE_EQ = 7,
+  AND = 8,
+  OR = 9,
+  NOT = 10,
+  MAX
+};
+
+/**
+ * Builds a serialized filter expression in postfix order, e.g.
+ *   builder.keyGe("a").keyLe("m").and_().byteEq(0, 'x').or_().str()
+ * is (key >= "a" && key <= "m") || key[0] == 'x'.
+ */
+class RecordFilterExpressionBuilder {
+ public:
+  RecordFilterExpressionBuilder& keyEq(folly::StringPiece key) {
+    return pushKeyOp(RecordFilterOp::KEY_EQ, key);
+  }
+  RecordFilterExpressionBuilder& keyLt(folly::StringPiece key) {
+    return pushKeyOp(RecordFilterOp::KEY_LT, key);
+  }
+  RecordFilterExpressionBuilder& keyLe(folly::StringPiece key) {
+    return pushKeyOp(RecordFilterOp::KEY_LE, key);
+  }
+  RecordFilterExpressionBuilder& keyGt(folly::StringPiece key) {
+    return pushKeyOp(RecordFilterOp::KEY_GT, key);
+  }
+  RecordFilterExpressionBuilder& keyGe(folly::StringPiece key) {
+    return pushKeyOp(RecordFilterOp::KEY_GE, key);
+  }
+  RecordFilterExpressionBuilder& keyPrefix(folly::StringPiece key) {
+    return pushKeyOp(RecordFilterOp::KEY_PREFIX, key);
+  }
+  RecordFilterExpressionBuilder& byteEq(uint16_t offset, uint8_t value) {
+    program_.push_back(static_cast<char>(RecordFilterOp::BYTE_EQ));
+    pushUint16(offset);
+    program_.push_back(static_cast<char>(value));
+    return *this;
+  }
+  RecordFilterExpressionBuilder& and_() {
+    program_.push_back(static_cast<char>(RecordFilterOp::AND));
+    return *this;
+  }
+  RecordFilterExpressionBuilder& or_() {
+    program_.push_back(static_cast<char>(RecordFilterOp::OR));
+    return *this;
+  }
+  RecordFilterExpressionBuilder& not_() {
+    program_.push_back(static_cast<char>(RecordFilterOp::NOT));
+    return *this;
+  }
+
+  const std::string& str() const {
+    return program_;
+  }
+
+ private:
+  RecordFilterExpressionBuilder& pushKeyOp(RecordFilterOp op,
+                                           folly::StringPiece key) {
+    program_.push_back(static_cast<char>(op));
+    pushUint16(static_cast<uint16_t>(key.size()));
+    program_.append(key.data(), key.size());
+    return *this;
+  }
+
+  void pushUint16(uint16_t val) {
+    program_.push_back(static_cast<char>(val & 0xff));
+    program_.push_back(static_cast<char>(val >> 8));
+  }
+
+  std::string program_;
+};
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,58 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/ReleaseCoalescer.h"
+
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/debug.h"
+
+namespace facebook { namespace logdevice {
+
+void ReleaseCoalescer::noteRelease(ShardID shard,
+                                   const RecordID& rid,
+                                   ReleaseType type) {
+  ld_check(type != ReleaseType::INVALID);
+
+  const bool was_empty = pending_.empty();
+  auto result = pending_.try_emplace(
+      Key(shard, rid.logid), RELEASE_Header{rid, type, shard.shard()});
+  if (!result.second) {
+    RELEASE_Header& hdr = result.first->second;
+    if (compose_lsn(rid.epoch, rid.esn) >
+        compose_lsn(hdr.rid.epoch, hdr.rid.esn)) {
+      hdr.rid = rid;
+      hdr.release_type = type;
+    }
+  }
+
+  if (was_empty) {
+    timer_.activate(window_);
+  }
+}
+
+void ReleaseCoalescer::flush() {
+  timer_.cancel();
+  Sender& sender = Worker::onThisThread()->sender();
+  for (const auto& kv : pending_) {
+    auto release_msg = std::make_unique<RELEASE_Message>(kv.second);
+    int rv = sender.sendMessage(std::move(release_msg), kv.first.first.asNodeID());
+    if (rv != 0) {
+      RATELIMIT_LEVEL(
+          err == E::DISABLED ? dbg::Level::DEBUG : dbg::Level::INFO,
+          std::chrono::seconds(10),
+          10,
+          "Failed to send a coalesced RELEASE for record %s to %s: %s",
+          kv.second.rid.toString().c_str(),
+          kv.first.first.toString().c_str(),
+          error_description(err));
+    }
+  }
+  pending_.clear();
+}
+
+}} // namespace facebook::logdevice
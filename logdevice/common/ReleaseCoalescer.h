@@ -0,0 +1,80 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <chrono>
+#include <utility>
+
+#include <folly/container/F14Map.h>
+
+#include "logdevice/common/ShardID.h"
+#include "logdevice/common/Timer.h"
+#include "logdevice/common/protocol/RELEASE_Message.h"
+#include "logdevice/common/types_internal.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file ReleaseCoalescer batches RELEASE fan-out on sequencer nodes. Every
+ *       Appender reaping that advances the last-known-good LSN sends one
+ *       RELEASE per copyset recipient; on a hot log a burst of retirements
+ *       turns into hundreds of near-identical RELEASEs per storage node
+ *       within a millisecond, all but the last of which are redundant
+ *       (RELEASE is cumulative: releasing an LSN releases everything up to
+ *       it).
+ *
+ *       One instance per Worker. Instead of sending immediately, Appenders
+ *       record the release here; for each (storage shard, log) only the
+ *       highest LSN is remembered, and a micro-window timer (typically 1ms,
+ *       see --release-coalescing-window) flushes one RELEASE per pending
+ *       (shard, log) pair. Periodic/broadcast releases (PeriodicReleases)
+ *       are unaffected and still provide the eventual-delivery guarantee.
+ *
+ *       Not thread-safe; confined to the owning Worker.
+ */
+
+class ReleaseCoalescer {
+ public:
+  explicit ReleaseCoalescer(std::chrono::microseconds window)
+      : window_(window), timer_([this] { flush(); }) {}
+
+  /**
+   * Records that records of log rid.logid up to rid (inclusive) may be
+   * released on @param shard. The actual RELEASE goes out when the window
+   * timer fires, carrying the highest LSN recorded for the (shard, log)
+   * pair in the meantime.
+   */
+  void noteRelease(ShardID shard, const RecordID& rid, ReleaseType type);
+
+  /**
+   * Sends all pending RELEASEs now. Called by the window timer; also safe
+   * to call directly (e.g. on shutdown).
+   */
+  void flush();
+
+  size_t numPending() const {
+    return pending_.size();
+  }
+
+ private:
+  using Key = std::pair<ShardID, logid_t>;
+  struct KeyHash {
+    size_t operator()(const Key& key) const {
+      return folly::hash::hash_combine(
+          ShardID::Hash()(key.first), key.second.val_);
+    }
+  };
+
+  const std::chrono::microseconds window_;
+  Timer timer_;
+
+  // (shard, log) -> highest release seen in the current window
+  folly::F14FastMap<Key, RELEASE_Header, KeyHash> pending_;
+};
+
+}} // namespace facebook::logdevice
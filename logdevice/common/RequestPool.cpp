@@ -0,0 +1,23 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/RequestPool.h"
+
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/stats/Stats.h"
+
+namespace facebook { namespace logdevice { namespace request_pool_detail {
+
+void noteHit() {
+  STAT_INCR(Worker::stats(), request_pool_hit);
+}
+
+void noteMiss() {
+  STAT_INCR(Worker::stats(), request_pool_miss);
+}
+
+}}} // namespace facebook::logdevice::request_pool_detail
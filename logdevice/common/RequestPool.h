@@ -0,0 +1,121 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file RequestPool recycles the memory of high-frequency Request
+ *       subclasses. Request objects are allocated on one thread and
+ *       destroyed on the Worker that executed them, so each thread keeps
+ *       its own intrusive freelist per request type: allocation pops from
+ *       the allocating thread's list, destruction pushes onto the
+ *       destroying thread's list. In steady state every Worker both posts
+ *       and executes requests, so the lists stay populated everywhere;
+ *       the per-thread cap bounds memory held when traffic is one-sided.
+ *
+ *       Opt a Request subclass in by additionally deriving from
+ *       PooledRequest<T>:
+ *
+ *         class ReleaseRequest : public Request,
+ *                                public PooledRequest<ReleaseRequest> {...};
+ *
+ *       Deriving further from a pooled type is safe: allocations whose
+ *       size doesn't match T fall through to the global allocator.
+ */
+
+namespace request_pool_detail {
+// Stats hooks live in RequestPool.cpp so this header doesn't pull in
+// Worker.h. Hit rate = hits / (hits + misses).
+void noteHit();
+void noteMiss();
+} // namespace request_pool_detail
+
+template <typename T>
+class RequestPool {
+ public:
+  static void* allocate() {
+    ThreadCache& cache = threadCache();
+    if (cache.head != nullptr) {
+      FreeNode* node = cache.head;
+      cache.head = node->next;
+      --cache.size;
+      request_pool_detail::noteHit();
+      return node;
+    }
+    request_pool_detail::noteMiss();
+    return ::operator new(sizeof(T));
+  }
+
+  static void deallocate(void* ptr) {
+    ThreadCache& cache = threadCache();
+    if (cache.size < kMaxFreePerThread) {
+      cache.head = new (ptr) FreeNode{cache.head};
+      ++cache.size;
+      return;
+    }
+    ::operator delete(ptr);
+  }
+
+ private:
+  struct FreeNode {
+    FreeNode* next;
+  };
+
+  static_assert(sizeof(T) >= sizeof(FreeNode),
+                "pooled type too small to hold a freelist link");
+  static_assert(alignof(T) <= alignof(std::max_align_t),
+                "over-aligned types can't go through ::operator new(size_t)");
+
+  // Enough to absorb a broadcast to every other Worker plus some burst;
+  // beyond that the memory goes back to the global allocator.
+  static constexpr size_t kMaxFreePerThread = 128;
+
+  struct ThreadCache {
+    FreeNode* head{nullptr};
+    size_t size{0};
+
+    ~ThreadCache() {
+      while (head != nullptr) {
+        FreeNode* node = head;
+        head = node->next;
+        ::operator delete(node);
+      }
+    }
+  };
+
+  static ThreadCache& threadCache() {
+    static thread_local ThreadCache cache;
+    return cache;
+  }
+};
+
+template <typename T>
+class PooledRequest {
+ public:
+  static void* operator new(size_t size) {
+    if (size != sizeof(T)) {
+      // a subclass of T that did not opt in itself
+      return ::operator new(size);
+    }
+    return RequestPool<T>::allocate();
+  }
+
+  static void operator delete(void* ptr, size_t size) {
+    if (size != sizeof(T)) {
+      ::operator delete(ptr);
+      return;
+    }
+    RequestPool<T>::deallocate(ptr);
+  }
+};
+
+}} // namespace facebook::logdevice
@@ -18,9 +18,10 @@ SSLFetcher::create(const std::string& cert_path,
                    const std::string& key_path,
                    const std::string& ca_path,
                    bool load_certs,
+                   bool enable_ktls,
                    StatsHolder* stats) {
-  std::unique_ptr<SSLFetcher> fetcher{
-      new SSLFetcher(cert_path, key_path, ca_path, load_certs, stats)};
+  std::unique_ptr<SSLFetcher> fetcher{new SSLFetcher(
+      cert_path, key_path, ca_path, load_certs, enable_ktls, stats)};
   fetcher->reloadSSLContext();
   return fetcher;
 }
@@ -29,11 +30,13 @@ SSLFetcher::SSLFetcher(const std::string& cert_path,
                        const std::string& key_path,
                        const std::string& ca_path,
                        bool load_certs,
+                       bool enable_ktls,
                        StatsHolder* stats)
     : cert_path_(cert_path),
       key_path_(key_path),
       ca_path_(ca_path),
       load_certs_(load_certs),
+      enable_ktls_(enable_ktls),
       stats_(stats) {}
 
 std::shared_ptr<folly::SSLContext> SSLFetcher::getSSLContext() const {
@@ -57,6 +60,25 @@ void SSLFetcher::reloadSSLContext() {
     context_->setOptions(SSL_OP_NO_COMPRESSION);
     SSL_CTX_set_mode(context_->getSSLCtx(), SSL_MODE_RELEASE_BUFFERS);
 
+    if (enable_ktls_) {
+#ifdef SSL_OP_ENABLE_KTLS
+      // Push the symmetric crypto state of established connections into the
+      // kernel socket after the handshake, so encryption happens in the
+      // kernel instead of on the Worker thread. OpenSSL silently keeps doing
+      // userspace crypto when the running kernel or the negotiated cipher
+      // doesn't support TLS offload.
+      context_->setOptions(SSL_OP_ENABLE_KTLS);
+      if (stats_) {
+        STAT_INCR(stats_, ssl_context_ktls_enabled);
+      }
+#else
+      RATELIMIT_WARNING(std::chrono::seconds(10),
+                        1,
+                        "--ssl-enable-ktls is set but this OpenSSL build has "
+                        "no kTLS support; using userspace encryption.");
+#endif
+    }
+
     context_->setSessionCacheContext(kSSLCacheContext);
 
     // Check peers cert not their hostname
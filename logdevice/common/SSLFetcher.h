@@ -32,6 +32,7 @@ class SSLFetcher {
                                             const std::string& key_path,
                                             const std::string& ca_path,
                                             bool load_certs,
+                                            bool enable_ktls,
                                             StatsHolder* stats = nullptr);
 
   virtual ~SSLFetcher() = default;
@@ -56,6 +57,7 @@ class SSLFetcher {
              const std::string& key_path,
              const std::string& ca_path,
              bool load_certs,
+             bool enable_ktls,
              StatsHolder* stats = nullptr);
 
  protected:
@@ -63,6 +65,11 @@ class SSLFetcher {
   const std::string key_path_;
   const std::string ca_path_;
   const bool load_certs_;
+  // Ask OpenSSL to offload symmetric crypto of established connections to
+  // the kernel (kTLS). Only takes effect if the OpenSSL build supports it;
+  // OpenSSL falls back to userspace crypto at runtime when the kernel or
+  // the negotiated cipher doesn't.
+  const bool enable_ktls_;
 
   std::shared_ptr<folly::SSLContext> context_;
   StatsHolder* stats_{nullptr};
@@ -23,6 +23,18 @@ void ProbabilityDistribution::push_back(double w) {
   weight_cumsum_.push_back(totalWeight() + w);
 }
 
+void ProbabilityDistribution::updateWeight(size_t idx, double w) {
+  ld_check(idx < weight_cumsum_.size());
+  ld_check(w >= 0);
+  const double delta = w - weight(idx);
+  if (delta == 0) {
+    return;
+  }
+  for (size_t i = idx; i < weight_cumsum_.size(); ++i) {
+    weight_cumsum_[i] += delta;
+  }
+}
+
 double ProbabilityDistribution::prefixSum(size_t count) const {
   ld_check(count <= weight_cumsum_.size());
   return count ? weight_cumsum_[count - 1] : 0;
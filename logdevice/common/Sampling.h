@@ -126,6 +126,12 @@ class ProbabilityDistribution {
 
   void push_back(double weight);
 
+  // Sets the weight at the given index, shifting the prefix sums after it.
+  // O(size() - idx). Note that repeated updates accumulate numerical error
+  // in the prefix sums; callers doing many updates should rebuild the
+  // distribution from scratch every once in a while.
+  void updateWeight(size_t idx, double weight);
+
   double weight(size_t idx) const;
 
   // Sum of the first this many weights.
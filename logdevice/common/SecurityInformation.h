@@ -12,6 +12,7 @@
 #include <utility>
 
 #include "logdevice/common/configuration/TrafficClass.h"
+#include "logdevice/common/types_internal.h"
 #include "logdevice/include/PermissionActions.h"
 
 namespace folly {
@@ -67,6 +68,18 @@ class Principal {
   // The RFC 2474 "Differentiated Services Field Code Point" value to use
   // for all packets sent on connections associated with this principal.
   uint8_t egress_dscp = 0;
+
+  // Maximum aggregate rate of record bytes each storage node serves to
+  // clients identified by this Principal, configured as
+  // "<count>/<duration>" (e.g. "100M/1s"). RATE_UNLIMITED means no
+  // ceiling; such principals are only subject to regular traffic shaping
+  // through the flow group they inherit via max_read_traffic_class.
+  // See PrincipalThrottle.h.
+  rate_limit_t max_read_rate = RATE_UNLIMITED;
+
+  // Like max_read_rate, but caps the append payload throughput each
+  // sequencer node admits from this Principal.
+  rate_limit_t max_append_rate = RATE_UNLIMITED;
 };
 
 /**
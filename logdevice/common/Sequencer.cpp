@@ -25,6 +25,7 @@
 #include "logdevice/common/PeriodicReleases.h"
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/SequencerBackgroundActivator.h"
+#include "logdevice/common/SequencerTailCache.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/configuration/Configuration.h"
 #include "logdevice/common/debug.h"
@@ -53,6 +54,11 @@ Sequencer::Sequencer(logid_t log_id,
   if (!MetaDataLog::isMetaDataLog(log_id)) {
     // create metadata log writer for a data log
     metadata_writer_ = std::make_unique<MetaDataLogWriter>(this);
+    const size_t tail_cache_bytes =
+        settings_.get()->sequencer_recent_records_cache_bytes;
+    if (tail_cache_bytes > 0) {
+      tail_cache_ = std::make_unique<SequencerTailCache>(tail_cache_bytes);
+    }
   }
 }
 
@@ -203,6 +209,10 @@ ActivateResult Sequencer::completeActivationWithMetaData(
     auto prev_epoch = current_epoch_.exchange(epoch.val_);
     setState(State::ACTIVE);
 
+    // This node is running the sequencer (again); stop redirecting appends
+    // away if the load spreader wanted the log relocated.
+    setRelocationTarget(NodeID());
+
     if (prev_epoch != epoch.val() - 1) {
       // If sequencer for previous epoch was on a different node, we don't know
       // what the append rate was up until now. Tell that to rate estimator.
@@ -1077,6 +1087,8 @@ void Sequencer::notePreempted(epoch_t epoch, NodeID preempted_by) {
           epoch.val(),
           log_id_.val());
   Seal prev = atomic_fetch_max(preempted_epoch_, Seal(epoch, preempted_by));
+  // A cached all-clear check-seal result is no longer trustworthy.
+  clearSealsCheckedUntil();
   if (epoch >= getCurrentEpoch() && prev.epoch <= epoch) {
     // The seal epoch is larger equal than the current epoch, and we are
     // actually advancing preempted_epoch_. Move the sequencer into PREEMPTED
@@ -1459,6 +1471,21 @@ void Sequencer::clearNoRedirectUntil() {
   no_redirect_until_ = std::chrono::steady_clock::duration::min();
 }
 
+bool Sequencer::checkSealsCheckedUntil() const {
+  return std::chrono::steady_clock::now().time_since_epoch() <
+      seals_checked_until_.load();
+}
+
+void Sequencer::setSealsCheckedUntil(
+    std::chrono::steady_clock::duration duration) {
+  auto until = std::chrono::steady_clock::now().time_since_epoch() + duration;
+  atomic_fetch_max(seals_checked_until_, until);
+}
+
+void Sequencer::clearSealsCheckedUntil() {
+  seals_checked_until_ = std::chrono::steady_clock::duration::min();
+}
+
 ///////////////////////////////////////////////
 
 /* static */
@@ -1922,6 +1949,15 @@ bool Sequencer::checkNodeSet() const {
   return current_epoch->checkNodeSet();
 }
 
+double Sequencer::getOverloadedHeadroomFraction() const {
+  auto current_epoch = getCurrentEpochSequencer();
+  if (current_epoch == nullptr) {
+    return 0.0;
+  }
+
+  return current_epoch->getOverloadedHeadroomFraction();
+}
+
 std::shared_ptr<const TailRecord> Sequencer::getTailRecord() const {
   // the read lock is needed to prevent the race that sequencer
   // activates between getting previous epoch offset and in-epoch offset
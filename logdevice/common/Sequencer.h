@@ -46,6 +46,7 @@ class MetaDataLogTrimmer;
 class PeriodicReleases;
 class Processor;
 enum class ReleaseType : uint8_t;
+class SequencerTailCache;
 class StatsHolder;
 struct NodeID;
 class RecoveredLSNs;
@@ -361,6 +362,26 @@ class Sequencer {
    */
   void clearNoRedirectUntil();
 
+  /**
+   * @return   true if a check-seal round for this log completed without
+   *           finding a preemptor recently enough that GET_SEQ_STATE may
+   *           skip the CHECK_SEAL fan-out. See seals_checked_until_.
+   */
+  bool checkSealsCheckedUntil() const;
+
+  /**
+   * Note that a check-seal round completed without finding a preemptor;
+   * further GET_SEQ_STATE messages may skip check-seals for the given
+   * duration.
+   */
+  void setSealsCheckedUntil(std::chrono::steady_clock::duration duration);
+
+  /**
+   * Invalidate the cached check-seal result; called when this sequencer
+   * learns of a preemptor.
+   */
+  void clearSealsCheckedUntil();
+
   /////////////////////// LogRecovery ///////////////////////
 
   /**
@@ -693,6 +714,15 @@ class Sequencer {
    */
   std::shared_ptr<const TailRecord> getTailRecord() const;
 
+  /**
+   * @return    ring of recently appended records served to tailing readers
+   *            via GET_TAIL_RECORDS, populated as Appenders are reaped.
+   *            nullptr unless --sequencer-recent-records-cache-bytes is set.
+   */
+  SequencerTailCache* getTailCache() const {
+    return tail_cache_.get();
+  }
+
   /**
    * @return    the accumulative, epoch-end OffsetMap of the previous epoch.
    *            it is invalid if the information is not available (e.g.,
@@ -735,6 +765,14 @@ class Sequencer {
    */
   bool checkNodeSet() const;
 
+  /**
+   * Fraction of the current epoch's spare nodeset capacity occupied by
+   * shards graylisted as OVERLOADED. Returns 0.0 if the sequencer does not
+   * yet have a current epoch. See
+   * EpochSequencer::getOverloadedHeadroomFraction() for details.
+   */
+  double getOverloadedHeadroomFraction() const;
+
   // expose settings
   const Settings& settings() const {
     return *settings_.get();
@@ -748,6 +786,18 @@ class Sequencer {
   // sequencer was only recently activated.
   std::pair<int64_t, std::chrono::milliseconds> appendRateEstimate() const;
 
+  // If valid, the sequencer load spreader decided that this log's sequencer
+  // should run on the returned node instead of this one; AppenderPrep
+  // redirects new appends there. Cleared when the sequencer is (re)activated
+  // on this node. See SequencerBackgroundActivator::checkSequencerLoad().
+  NodeID getRelocationTarget() const {
+    return relocation_target_.load(std::memory_order_relaxed);
+  }
+
+  void setRelocationTarget(NodeID target) {
+    relocation_target_.store(target, std::memory_order_relaxed);
+  }
+
   // timer callback for the epoch draining timer
   static void onDrainingTimerExpired(logid_t log_id,
                                      epoch_t draining,
@@ -899,6 +949,14 @@ class Sequencer {
   // Estimates rate of appends (in bytes/s). Used for adjusting nodeset size.
   RateEstimator append_rate_estimator_;
 
+  // Where the sequencer load spreader wants this log's sequencer to run.
+  // Invalid NodeID if this node isn't trying to relocate the log.
+  std::atomic<NodeID> relocation_target_{NodeID()};
+
+  // ring of recently appended records for serving tailing readers directly
+  // from the sequencer. nullptr if the feature is off (the default).
+  std::unique_ptr<SequencerTailCache> tail_cache_;
+
   // tail record of the previous epoch, only populated when log recovery
   // initiated by the current epoch is completed
   UpdateableSharedPtr<const TailRecord> tail_record_previous_epoch_;
@@ -920,6 +978,14 @@ class Sequencer {
   std::atomic<std::chrono::steady_clock::duration> no_redirect_until_{
       std::chrono::steady_clock::duration::min()};
 
+  // Until when GET_SEQ_STATE may rely on the result of the last successful
+  // check-seal round for this log instead of fanning out CHECK_SEAL messages
+  // again. Updated when a CheckSealRequest completes without finding a
+  // preemptor, cleared when a preemptor is noted. See
+  // Settings::check_seal_cache_ttl.
+  std::atomic<std::chrono::steady_clock::duration> seals_checked_until_{
+      std::chrono::steady_clock::duration::min()};
+
   // Maximum effective_since ever read by recovery.
   // @seealso onSequencerMetaDataRead
   std::atomic<epoch_t::raw_type> max_effective_since_read_{EPOCH_INVALID.val_};
@@ -10,10 +10,12 @@
 #include "logdevice/common/AllSequencers.h"
 #include "logdevice/common/EpochMetaDataUpdater.h"
 #include "logdevice/common/EpochSequencer.h"
+#include "logdevice/common/HashBasedSequencerLocator.h"
 #include "logdevice/common/MetaDataLog.h"
 #include "logdevice/common/MetaDataLogWriter.h"
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/Worker.h"
+#include "logdevice/common/configuration/InternalLogs.h"
 #include "logdevice/common/nodeset_selection/NodeSetSelectorFactory.h"
 
 namespace facebook { namespace logdevice {
@@ -25,7 +27,9 @@ SequencerBackgroundActivator::SequencerBackgroundActivator()
       unconditional_nodeset_randomization_enabled_(
           Worker::settings().nodeset_size_adjustment_min_factor == 0),
       nodeset_max_randomizations_(
-          Worker::settings().nodeset_max_randomizations) {}
+          Worker::settings().nodeset_max_randomizations),
+      load_spreading_period_(
+          Worker::settings().sequencer_load_spreading_period) {}
 
 void SequencerBackgroundActivator::checkWorkerAsserts() {
   Worker* w = Worker::onThisThread();
@@ -65,6 +69,7 @@ void SequencerBackgroundActivator::schedule(std::vector<logid_t> log_ids,
     queue_.push(log_id);
     ++num_scheduled;
   }
+  activateLoadSpreadingTimerIfNeeded();
   maybeProcessQueue();
 }
 
@@ -781,6 +786,124 @@ void SequencerBackgroundActivator::activateNodesetAdjustmentTimerIfNeeded(
   state.nodeset_adjustment_timer.activate(first_delay);
 }
 
+void SequencerBackgroundActivator::activateLoadSpreadingTimerIfNeeded() {
+  if (load_spreading_period_.count() <= 0 || load_spreading_timer_.isActive()) {
+    return;
+  }
+  if (!load_spreading_timer_.isAssigned()) {
+    load_spreading_timer_.assign([this] {
+      checkSequencerLoad();
+      if (load_spreading_period_.count() > 0) {
+        load_spreading_timer_.activate(load_spreading_period_);
+      }
+    });
+  }
+  // Randomly stagger the first check so that overloaded nodes don't all
+  // relocate their logs in lockstep.
+  load_spreading_timer_.activate(
+      to_usec(folly::Random::randDouble01() * load_spreading_period_));
+}
+
+void SequencerBackgroundActivator::checkSequencerLoad() {
+  checkWorkerAsserts();
+  const Settings& settings = Worker::settings();
+  if (settings.sequencer_load_spreading_period.count() <= 0) {
+    return;
+  }
+  Worker* worker = Worker::onThisThread();
+  Processor* processor = worker->processor_;
+  ClusterState* cluster_state = Worker::getClusterState();
+  if (cluster_state == nullptr) {
+    // We can't tell which nodes are alive; don't move sequencers around.
+    return;
+  }
+
+  struct Candidate {
+    logid_t log_id;
+    int64_t bytes_per_sec;
+  };
+  std::vector<Candidate> candidates;
+  int64_t total_bytes_per_sec = 0;
+  for (Sequencer& seq : processor->allSequencers().accessAll()) {
+    if (seq.getState() != Sequencer::State::ACTIVE) {
+      continue;
+    }
+    auto est = seq.appendRateEstimate();
+    if (est.second.count() <= 0) {
+      continue;
+    }
+    int64_t rate = est.first * 1000 / est.second.count();
+    total_bytes_per_sec += rate;
+    logid_t log_id = seq.getLogID();
+    if (seq.getRelocationTarget().isNodeID() ||
+        MetaDataLog::isMetaDataLog(log_id) ||
+        configuration::InternalLogs::isInternal(log_id)) {
+      // Already being relocated, or a log that should stay where it
+      // hashes to.
+      continue;
+    }
+    candidates.push_back({log_id, rate});
+  }
+
+  if (total_bytes_per_sec <
+      static_cast<int64_t>(settings.sequencer_load_spreading_threshold)) {
+    return;
+  }
+
+  std::sort(candidates.begin(),
+            candidates.end(),
+            [](const Candidate& a, const Candidate& b) {
+              return a.bytes_per_sec > b.bytes_per_sec;
+            });
+
+  auto nodes_configuration = worker->getNodesConfiguration();
+  const NodeID my_node_id = processor->getMyNodeID();
+  // A copy of the sequencers config with this node's weight zeroed out: the
+  // hash then picks, for each log, the node that would run its sequencer if
+  // we weren't in the ring. Different hot logs land on different nodes, so
+  // the load spreads instead of moving wholesale to one neighbour.
+  auto sequencers = std::make_shared<configuration::SequencersConfig>(
+      nodes_configuration->getSequencersConfig());
+  for (size_t i = 0; i < sequencers->nodes.size(); ++i) {
+    if (sequencers->nodes[i].index() == my_node_id.index()) {
+      sequencers->weights[i] = 0;
+    }
+  }
+
+  size_t relocated = 0;
+  for (const Candidate& candidate : candidates) {
+    if (relocated >= settings.sequencer_load_spreading_max_logs) {
+      break;
+    }
+    NodeID target;
+    int rv = HashBasedSequencerLocator::locateSequencer(
+        candidate.log_id,
+        nodes_configuration.get(),
+        /* log_attrs */ nullptr,
+        cluster_state,
+        /* use_health_based_hashing */ false,
+        &target,
+        sequencers);
+    if (rv != 0 || !target.isNodeID() ||
+        target.index() == my_node_id.index()) {
+      continue;
+    }
+    auto seq = processor->allSequencers().findSequencer(candidate.log_id);
+    if (!seq) {
+      continue;
+    }
+    ld_info("Relocating sequencer of log %lu (%ld B/s) to %s to spread "
+            "sequencer load (%ld B/s total on this node)",
+            candidate.log_id.val_,
+            candidate.bytes_per_sec,
+            target.toString().c_str(),
+            total_bytes_per_sec);
+    seq->setRelocationTarget(target);
+    WORKER_STAT_INCR(sequencer_load_relocations);
+    ++relocated;
+  }
+}
+
 void SequencerBackgroundActivator::onSettingsUpdated() {
   // Set val = new_val and return true if the original val was != new_val.
   auto upd = [](auto& val, auto new_val) {
@@ -791,6 +914,14 @@ void SequencerBackgroundActivator::onSettingsUpdated() {
     return false;
   };
 
+  if (upd(load_spreading_period_,
+          Worker::settings().sequencer_load_spreading_period)) {
+    // Restart the load spreading timer with the new period (or stop it if
+    // load spreading was disabled).
+    load_spreading_timer_.cancel();
+    activateLoadSpreadingTimerIfNeeded();
+  }
+
   bool adjustment_period_changed = upd(
       nodeset_adjustment_period_, Worker::settings().nodeset_adjustment_period);
   // Important to use '|' instead of the short-circuiting '||'!
@@ -239,6 +239,19 @@ class SequencerBackgroundActivator {
   // logs_.
   void activateNodesetAdjustmentTimerIfNeeded(logid_t log_id, LogState& state);
 
+  // Initializes load_spreading_timer_ if sequencer load spreading is enabled
+  // (--sequencer-load-spreading-period is nonzero).
+  void activateLoadSpreadingTimerIfNeeded();
+
+  // Called every sequencer_load_spreading_period. Compares the combined
+  // append throughput of this node's sequencers against
+  // sequencer_load_spreading_threshold; if it's exceeded, picks up to
+  // sequencer_load_spreading_max_logs of the heaviest logs and marks their
+  // sequencers for relocation to the node that the weighted hash picks with
+  // this node excluded. AppenderPrep then redirects those logs' appends,
+  // which makes clients reactivate the sequencers on the target nodes.
+  void checkSequencerLoad();
+
   // deactivates the timer for queue processing
   void deactivateQueueProcessingTimer();
 
@@ -256,6 +269,10 @@ class SequencerBackgroundActivator {
   // timer for retrying processing the queue later in case of failures
   Timer retry_timer_;
 
+  // Fires every sequencer_load_spreading_period to check whether this node
+  // is sequencing too much append throughput. See checkSequencerLoad().
+  Timer load_spreading_timer_;
+
   // limiter on the number of concurrent activations
   ResourceBudget budget_{0};
 
@@ -268,5 +285,6 @@ class SequencerBackgroundActivator {
   std::chrono::milliseconds nodeset_adjustment_period_;
   bool unconditional_nodeset_randomization_enabled_;
   size_t nodeset_max_randomizations_;
+  std::chrono::milliseconds load_spreading_period_;
 };
 }} // namespace facebook::logdevice
@@ -77,6 +77,10 @@ SequencerBatching::SequencerBatching(Processor* processor)
                        processor_->stats_) {
   buffered_writer_.prependChecksums();
   buffered_writer_.setCallbackInternal(this);
+  // One instance per Processor, so use the shared log-to-Worker affinity
+  // instead of a salted hash; incoming appends that already run on the log's
+  // target Worker can then be batched without a cross-Worker hop.
+  buffered_writer_.useLogWorkerAffinity();
 }
 
 SequencerBatching::~SequencerBatching() {
@@ -0,0 +1,163 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/SequencerHintsCache.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include <folly/FileUtil.h>
+
+#include "logdevice/common/configuration/nodes/NodesConfiguration.h"
+#include "logdevice/common/debug.h"
+
+namespace facebook { namespace logdevice {
+
+namespace {
+
+// header of the snapshot blob produced by toSnapshotBlob()
+constexpr uint32_t SNAPSHOT_MAGIC = 0x53514843; // "SQHC"
+constexpr uint32_t SNAPSHOT_FORMAT_VERSION = 1;
+
+template <typename T>
+void appendRaw(std::string& out, const T& val) {
+  out.append(reinterpret_cast<const char*>(&val), sizeof(val));
+}
+
+template <typename T>
+bool readRaw(const std::string& blob, size_t& offset, T* val_out) {
+  if (blob.size() - offset < sizeof(T)) {
+    return false;
+  }
+  memcpy(val_out, blob.data() + offset, sizeof(T));
+  offset += sizeof(T);
+  return true;
+}
+
+uint64_t currentTimeMs() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+} // namespace
+
+void SequencerHintsCache::setHint(logid_t log_id,
+                                  NodeID node,
+                                  lsn_t tail_lsn) {
+  ld_check(node.isNodeID());
+  folly::SharedMutex::WriteHolder write_guard(mutex_);
+  hints_[log_id] = Hint{node, tail_lsn, currentTimeMs()};
+}
+
+bool SequencerHintsCache::getHint(logid_t log_id, Hint* hint_out) const {
+  ld_check(hint_out != nullptr);
+  folly::SharedMutex::ReadHolder read_guard(mutex_);
+  auto it = hints_.find(log_id);
+  if (it == hints_.end()) {
+    return false;
+  }
+  *hint_out = it->second;
+  return true;
+}
+
+std::string SequencerHintsCache::toSnapshotBlob() const {
+  folly::SharedMutex::ReadHolder read_guard(mutex_);
+  std::string blob;
+  appendRaw(blob, SNAPSHOT_MAGIC);
+  appendRaw(blob, SNAPSHOT_FORMAT_VERSION);
+  appendRaw(blob, static_cast<uint64_t>(hints_.size()));
+
+  for (const auto& entry : hints_) {
+    appendRaw(blob, entry.first.val_);
+    appendRaw(blob, entry.second.node.index());
+    appendRaw(blob, entry.second.node.generation());
+    appendRaw(blob, entry.second.tail_lsn);
+    appendRaw(blob, entry.second.saved_at_ms);
+  }
+
+  return blob;
+}
+
+int SequencerHintsCache::restoreFromSnapshotBlob(
+    const std::string& blob,
+    const configuration::nodes::NodesConfiguration& cfg,
+    std::chrono::milliseconds max_age) {
+  size_t offset = 0;
+  uint32_t magic, version;
+  uint64_t num_entries;
+  if (!readRaw(blob, offset, &magic) || magic != SNAPSHOT_MAGIC ||
+      !readRaw(blob, offset, &version) || version != SNAPSHOT_FORMAT_VERSION ||
+      !readRaw(blob, offset, &num_entries)) {
+    err = E::BADMSG;
+    return -1;
+  }
+
+  const uint64_t now_ms = currentTimeMs();
+  int restored = 0;
+  for (uint64_t i = 0; i < num_entries; ++i) {
+    logid_t::raw_type logid_raw;
+    node_index_t node_index;
+    node_gen_t node_generation;
+    lsn_t tail_lsn;
+    uint64_t saved_at_ms;
+    if (!readRaw(blob, offset, &logid_raw) ||
+        !readRaw(blob, offset, &node_index) ||
+        !readRaw(blob, offset, &node_generation) ||
+        !readRaw(blob, offset, &tail_lsn) ||
+        !readRaw(blob, offset, &saved_at_ms)) {
+      err = E::BADMSG;
+      return -1;
+    }
+
+    if (saved_at_ms > now_ms ||
+        now_ms - saved_at_ms > static_cast<uint64_t>(max_age.count())) {
+      // too old (or from a clock that ran ahead of ours); a hint this stale
+      // is more likely to cost a redirect than to save one
+      continue;
+    }
+    if (!cfg.isNodeInServiceDiscoveryConfig(node_index)) {
+      // node left the cluster since the snapshot was taken
+      continue;
+    }
+
+    folly::SharedMutex::WriteHolder write_guard(mutex_);
+    hints_[logid_t(logid_raw)] =
+        Hint{NodeID(node_index, node_generation), tail_lsn, saved_at_ms};
+    ++restored;
+  }
+
+  return restored;
+}
+
+int SequencerHintsCache::persistToFile(const std::string& path) const {
+  const std::string blob = toSnapshotBlob();
+  const std::string tmp_path = path + ".tmp";
+  if (!folly::writeFile(blob, tmp_path.c_str())) {
+    err = E::FAILED;
+    return -1;
+  }
+  if (rename(tmp_path.c_str(), path.c_str()) != 0) {
+    err = E::FAILED;
+    return -1;
+  }
+  return 0;
+}
+
+int SequencerHintsCache::restoreFromFile(
+    const std::string& path,
+    const configuration::nodes::NodesConfiguration& cfg,
+    std::chrono::milliseconds max_age) {
+  std::string blob;
+  if (!folly::readFile(path.c_str(), blob)) {
+    err = E::NOTFOUND;
+    return -1;
+  }
+  return restoreFromSnapshotBlob(blob, cfg, max_age);
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,108 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+
+#include <boost/noncopyable.hpp>
+#include <folly/SharedMutex.h>
+
+#include "logdevice/common/NodeID.h"
+#include "logdevice/common/types_internal.h"
+
+namespace facebook { namespace logdevice {
+
+namespace configuration { namespace nodes {
+class NodesConfiguration;
+}} // namespace configuration::nodes
+
+/**
+ * @file  SequencerHintsCache remembers, per log, which node was last seen
+ *        running the sequencer and what the last released LSN was at that
+ *        time. The cache can be persisted to a local file and restored on
+ *        the next client start, letting short-lived clients (e.g. periodic
+ *        batch jobs) send their first GET_SEQ_STATE or APPEND directly to
+ *        the right node instead of going through sequencer placement and,
+ *        possibly, a redirect.
+ *
+ *        Everything in here is a hint, never an authoritative answer:
+ *          - a stale node hint is corrected by the regular redirect /
+ *            rehashing machinery in SequencerRouter;
+ *          - the tail LSN only tells callers roughly where the log ended
+ *            when the snapshot was taken and must not be used for gap
+ *            detection or any correctness decision.
+ *
+ *        The cache is shared among all worker threads and protected by a
+ *        lock, same as EpochMetaDataCache.
+ */
+
+class SequencerHintsCache : boost::noncopyable {
+ public:
+  struct Hint {
+    // node that ran the sequencer for the log when the hint was recorded
+    NodeID node;
+    // last released LSN reported by that sequencer; approximate, hint-only
+    lsn_t tail_lsn{LSN_INVALID};
+    // system clock time when the hint was recorded, used to age out stale
+    // entries on restore
+    uint64_t saved_at_ms{0};
+  };
+
+  SequencerHintsCache() {}
+
+  // Record (or overwrite) the hint for a log. `saved_at_ms' is stamped with
+  // the current system time.
+  void setHint(logid_t log_id, NodeID node, lsn_t tail_lsn);
+
+  // Look up the hint for a log.
+  // @return  true and fills @param hint_out on a hit, false on a miss
+  bool getHint(logid_t log_id, Hint* hint_out) const;
+
+  /**
+   * Serializes the current contents of the cache into a binary snapshot
+   * (versioned header followed by one record per entry) that can later be
+   * restored with restoreFromSnapshotBlob().
+   */
+  std::string toSnapshotBlob() const;
+
+  /**
+   * Re-populates the cache from a snapshot produced by toSnapshotBlob().
+   * Entries older than @param max_age or whose node is no longer in the
+   * given nodes configuration are skipped rather than failing the restore.
+   *
+   * @return  number of entries restored, or -1 with err set to E::BADMSG if
+   *          the blob is malformed or has an unknown format version.
+   */
+  int restoreFromSnapshotBlob(
+      const std::string& blob,
+      const configuration::nodes::NodesConfiguration& cfg,
+      std::chrono::milliseconds max_age);
+
+  /**
+   * Convenience wrappers around the snapshot blob that write to / read from
+   * a file on local disk, mirroring EpochMetaDataCache::persistToFile().
+   * persistToFile() writes to a temporary file first and renames it into
+   * place. Both return 0 on success and -1 on failure (with err set;
+   * persistToFile sets E::FAILED on I/O errors, restoreFromFile sets
+   * E::NOTFOUND if the file can not be read).
+   */
+  int persistToFile(const std::string& path) const;
+  int restoreFromFile(const std::string& path,
+                      const configuration::nodes::NodesConfiguration& cfg,
+                      std::chrono::milliseconds max_age);
+
+ private:
+  std::unordered_map<logid_t, Hint, logid_t::Hash> hints_;
+
+  // protects hints_
+  mutable folly::SharedMutex mutex_;
+};
+
+}} // namespace facebook::logdevice
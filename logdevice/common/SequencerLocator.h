@@ -26,6 +26,9 @@ enum class SequencerOptions : uint8_t {
   NONE = 0, // don't run any sequencers
   ALL,      // run sequencers for all logs in the config
   LAZY,     // bring up sequencers as needed
+  // bring up sequencers at startup for logs this node is the primary or
+  // secondary sequencer node for, lazily for everything else
+  WARM_STANDBY,
 };
 
 class SequencerLocator {
@@ -9,6 +9,7 @@
 
 #include "logdevice/common/MetaDataLog.h"
 #include "logdevice/common/Processor.h"
+#include "logdevice/common/SequencerHintsCache.h"
 #include "logdevice/common/SequencerLocator.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/configuration/Configuration.h"
@@ -32,6 +33,31 @@ void SequencerRouter::start() {
     sendTo(force_sequencer_choice, REDIRECT_CYCLE);
     return;
   }
+
+  // On the very first attempt, try the node that ran the sequencer for this
+  // log the last time this client talked to it, if a persisted hints cache
+  // is enabled. A stale hint is harmless: the node will either redirect us
+  // or onNodeUnavailable() will bring us back here with hint_attempted_ set,
+  // falling through to the regular SequencerLocator path below.
+  if (!hint_attempted_) {
+    hint_attempted_ = true;
+    SequencerHintsCache* hints = getSequencerHints();
+    if (hints != nullptr) {
+      SequencerHintsCache::Hint hint;
+      if (hints->getHint(MetaDataLog::dataLogID(log_id_), &hint)) {
+        ClusterState* cs = getClusterState();
+        if (cs == nullptr || cs->isNodeAlive(hint.node.index())) {
+          ld_debug("Sending to %s for log:%lu based on a persisted sequencer "
+                   "hint",
+                   hint.node.toString().c_str(),
+                   log_id_.val_);
+          sendTo(hint.node, flags_t(0));
+          return;
+        }
+      }
+    }
+  }
+
   // If this SequencerRouter object gets destroyed before the callback is
   // called, trying to access its variables will cause a crash. Using
   // WeakRefHolder to prevent that.
@@ -554,6 +580,10 @@ SequencerLocator& SequencerRouter::getSequencerLocator() const {
   return *Worker::onThisThread()->processor_->sequencer_locator_;
 }
 
+SequencerHintsCache* SequencerRouter::getSequencerHints() const {
+  return Worker::onThisThread()->processor_->sequencer_hints_cache_;
+}
+
 ClusterState* SequencerRouter::getClusterState() const {
   return Worker::getClusterState();
 }
@@ -39,6 +39,7 @@ namespace facebook { namespace logdevice {
  *        thread.
  */
 
+class SequencerHintsCache;
 class SequencerLocator;
 struct Settings;
 
@@ -136,6 +137,10 @@ class SequencerRouter {
   // sequencer nodes.
   virtual SequencerLocator& getSequencerLocator() const;
 
+  // Returns a pointer to the cache of sequencer hints persisted across
+  // client restarts, or nullptr if the feature is off (the default).
+  virtual SequencerHintsCache* getSequencerHints() const;
+
   // Returns a pointer to the ClusterState object to check cluster/nodes health
   virtual ClusterState* getClusterState() const;
 
@@ -161,6 +166,11 @@ class SequencerRouter {
   // which attempt at sending this is
   int attempts_{0};
 
+  // whether start() already consulted the persisted sequencer hints cache;
+  // only the very first attempt uses a hint, all retries go through the
+  // regular SequencerLocator path
+  bool hint_attempted_{false};
+
   // Keeps track of the most recent node that replied, as well as the status and
   // flags that were used to send a message to it.
   struct {
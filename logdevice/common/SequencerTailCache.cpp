@@ -0,0 +1,104 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/SequencerTailCache.h"
+
+#include <algorithm>
+
+#include "logdevice/common/debug.h"
+
+namespace facebook { namespace logdevice {
+
+SequencerTailCache::SequencerTailCache(size_t max_bytes)
+    : max_bytes_(max_bytes) {
+  ld_check(max_bytes_ > 0);
+}
+
+void SequencerTailCache::push(const TailRecord& record) {
+  ld_check(record.isValid());
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (!record.hasPayload()) {
+    // A record we cannot serve would poison the ring: readers rely on every
+    // LSN in [front, back] being present. Start over from the next record.
+    bytes_ = 0;
+    records_.clear();
+    return;
+  }
+
+  const size_t payload_size = record.getPayloadSlice().size;
+  if (payload_size > max_bytes_) {
+    // the record alone blows the budget; treat it like an eviction of
+    // everything, including itself
+    bytes_ = 0;
+    records_.clear();
+    return;
+  }
+
+  const lsn_t lsn = record.header.lsn;
+  if (records_.empty() || lsn > records_.back().header.lsn) {
+    records_.push_back(record);
+  } else {
+    // Reaps of a draining epoch can interleave with reaps of the current
+    // one; keep the ring sorted by LSN. Duplicates cannot happen since an
+    // LSN is only reaped once.
+    auto it = std::lower_bound(
+        records_.begin(),
+        records_.end(),
+        lsn,
+        [](const TailRecord& r, lsn_t l) { return r.header.lsn < l; });
+    ld_assert(it == records_.end() || it->header.lsn != lsn);
+    records_.insert(it, record);
+  }
+  bytes_ += payload_size;
+
+  while (bytes_ > max_bytes_ && records_.size() > 1) {
+    bytes_ -= records_.front().getPayloadSlice().size;
+    records_.pop_front();
+  }
+}
+
+Status SequencerTailCache::getRecords(lsn_t start_lsn,
+                                      lsn_t through_lsn,
+                                      size_t max_records,
+                                      std::vector<TailRecord>* out) const {
+  ld_check(out != nullptr);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (records_.empty() || start_lsn < records_.front().header.lsn) {
+    // records below the front of the ring may have been evicted (or never
+    // inserted); the caller has to read them from storage nodes
+    return E::STALE;
+  }
+
+  auto it = std::lower_bound(
+      records_.begin(),
+      records_.end(),
+      start_lsn,
+      [](const TailRecord& r, lsn_t l) { return r.header.lsn < l; });
+  for (; it != records_.end() && it->header.lsn <= through_lsn &&
+       out->size() < max_records;
+       ++it) {
+    out->push_back(*it);
+  }
+  return E::OK;
+}
+
+void SequencerTailCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  bytes_ = 0;
+  records_.clear();
+}
+
+size_t SequencerTailCache::payloadBytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return bytes_;
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,97 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include "logdevice/common/TailRecord.h"
+#include "logdevice/include/Err.h"
+#include "logdevice/include/types.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file A small byte-bounded ring of the most recently appended records of a
+ * log, kept on the node running the log's sequencer. Records are inserted as
+ * their Appenders are reaped (i.e. when they become fully replicated and the
+ * epoch's LNG advances), with the payload the sequencer already holds, so a
+ * tailing reader polling the sequencer with GET_TAIL_RECORDS can be served
+ * straight from memory without a storage-node round trip.
+ *
+ * Because Appenders are reaped in LSN order by the epoch's sliding window,
+ * and reaping an aborted Appender stops the LNG (and thus insertion) for the
+ * rest of the epoch, the cache holds *every* replicated record whose LSN
+ * falls in [front, back] of the ring -- an LSN missing from that range is a
+ * genuine gap (e.g. a bridge gap across an epoch bump), not an eviction.
+ * Readers asking for LSNs below the front of the ring get E::STALE and are
+ * expected to fall back to regular storage-node reads.
+ *
+ * All methods are thread safe: insertion happens on the Worker reaping the
+ * Appender while reads are driven by GET_TAIL_RECORDS messages arriving on
+ * arbitrary Workers.
+ */
+
+class SequencerTailCache {
+ public:
+  /**
+   * @param max_bytes  budget for cached payloads; once exceeded, records are
+   *                   evicted from the front of the ring. Must be > 0.
+   */
+  explicit SequencerTailCache(size_t max_bytes);
+
+  /**
+   * Insert a record into the cache. Called on the Appender reap path, under
+   * the same ordering guarantees as LNG updates. A record without a payload
+   * (e.g. appended while tail records were built without one) clears the
+   * cache instead, preserving the invariant that everything in the ring can
+   * be served to a reader.
+   */
+  void push(const TailRecord& record);
+
+  /**
+   * Copy into `out' up to `max_records' cached records with LSNs in
+   * [start_lsn, through_lsn].
+   *
+   * @return  E::OK     `out' is populated (possibly empty if nothing has
+   *                    been released in the range yet);
+   *          E::STALE  start_lsn precedes the front of the ring; the caller
+   *                    cannot tell whether records were evicted and must
+   *                    fall back to reading from storage nodes.
+   */
+  Status getRecords(lsn_t start_lsn,
+                    lsn_t through_lsn,
+                    size_t max_records,
+                    std::vector<TailRecord>* out) const;
+
+  /**
+   * Drop all cached records.
+   */
+  void clear();
+
+  /**
+   * @return  total payload bytes currently cached. Used by tests and
+   *          introspection.
+   */
+  size_t payloadBytes() const;
+
+ private:
+  mutable std::mutex mutex_;
+
+  // eviction threshold, fixed at construction
+  const size_t max_bytes_;
+
+  // sum of payload sizes of records in records_
+  size_t bytes_{0};
+
+  // cached records in strictly increasing LSN order
+  std::deque<TailRecord> records_;
+};
+
+}} // namespace facebook::logdevice
@@ -21,17 +21,21 @@ namespace facebook { namespace logdevice {
  */
 
 /**
- * Currently only two types.
+ * Currently three types.
  * 1) EQUALITY means exact match. It describes string equality filter based for
  *    now.
  * 2) RANGE means filter by upper and lower bounds. It describes string
  *    based range filter for now.
+ * 3) EXPRESSION means a compiled filter expression: a small bytecode
+ *    program built by RecordFilterExpressionBuilder and evaluated against
+ *    the record key per record. See RecordFilterExpression.h.
  */
 
 enum class ServerRecordFilterType : uint8_t {
   NOFILTER = 0,
   EQUALITY = 1,
   RANGE = 2,
+  EXPRESSION = 3,
   MAX
 };
 
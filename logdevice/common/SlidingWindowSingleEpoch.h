@@ -149,6 +149,16 @@ class SlidingWindowSingleEpoch {
       return LSN_INVALID;
     }
 
+    // Fast-fail without dirtying the size_ cache line when the window is
+    // full. Under overload every failed grow() would otherwise do a
+    // fetch_add/fetch_sub pair, doubling contention exactly when the
+    // window is most contended. The subsequent fetch_add re-checks
+    // authoritatively, so this load can afford to be relaxed.
+    if (size_.load(std::memory_order_relaxed) >= capacity_) {
+      err = E::NOBUFS;
+      return LSN_INVALID;
+    }
+
     // impossible to overflow uint64_t in practice
     size_t token = size_.fetch_add(1);
 
@@ -481,7 +491,13 @@ class SlidingWindowSingleEpoch {
   // token in the range [0..capacity_). Tokens are put back when
   // retire() shrinks the window and when grow() gets a token that's
   // too large. The value may temporarily exceed capacity_.
-  std::atomic<size_t> size_;
+  //
+  // size_ and right_ are the two hottest atomics on the append path:
+  // every grow() hits both and every reaping retire() hits size_. Keep
+  // each on its own cache line (128 = 2 lines, to also defeat adjacent
+  // line prefetching) so LSN issue and Appender retirement running on
+  // different Workers don't ping-pong one line between cores.
+  alignas(128) std::atomic<size_t> size_;
 
   // Max ESN to issue, inclusive (typically ESN_MAX - 1)
   const esn_t esn_max_;
@@ -491,8 +507,8 @@ class SlidingWindowSingleEpoch {
 
   // right edge of the window (max LSN in window plus one), or LSN_DISABLED if
   // the window is disabled. Next successful call to grow() will return this
-  // LSN.
-  std::atomic<lsn_t> right_;
+  // LSN. See the comment on size_ for why this is cache-line-aligned.
+  alignas(128) std::atomic<lsn_t> right_;
 
   // tail lsn of the previous epoch, used for validating conditional insert
   // in the case that it's the first insert of the window.
@@ -371,21 +371,36 @@ int SocketSender::sendMessageImpl(std::unique_ptr<Message>&& msg,
   }
 
   auto peer_type = conn.getInfo().getPeerType();
-  if (!isHandshakeMessage(msg->type_) &&
-      // Return ENOBUFS error Sender's outbuf limit and the Connection's
-      // minimum out buf limit is reached.
-      bytesPendingLimitReached(peer_type) && conn.minOutBufLimitReached()) {
-    RATELIMIT_WARNING(std::chrono::seconds(1),
-                      10,
-                      "ENOBUFS for SocketSender. Peer type: %s. "
-                      "Current SocketSender outbuf usage: %zu. "
-                      "Current SocketSender peer outbuf usage : %zu",
-                      peerTypeToString(peer_type),
-                      getBytesPending(),
-                      getBytesPending(peer_type));
-    err = E::NOBUFS;
-    STAT_INCR(Worker::stats(), send_failed_nobufs);
-    return -1;
+  if (!isHandshakeMessage(msg->type_)) {
+    // Return ENOBUFS error Sender's outbuf limit and the Connection's
+    // minimum out buf limit is reached, or if this one peer already holds
+    // more than its allowed share of the budget. The per-peer quota makes
+    // the NOBUFS destination-specific: upper layers (CatchupQueue, Appender)
+    // get it only for the congested peer and can back off that stream while
+    // sends to healthy peers keep going.
+    const bool global_limit_reached =
+        bytesPendingLimitReached(peer_type) && conn.minOutBufLimitReached();
+    const bool peer_quota_reached = peerOutBufQuotaReached(conn);
+    if (global_limit_reached || peer_quota_reached) {
+      RATELIMIT_WARNING(std::chrono::seconds(1),
+                        10,
+                        "ENOBUFS for SocketSender%s. Peer: %s, type: %s. "
+                        "Current SocketSender outbuf usage: %zu. "
+                        "Current SocketSender peer outbuf usage : %zu. "
+                        "Connection outbuf usage: %zu",
+                        peer_quota_reached ? " (per-peer quota)" : "",
+                        describeConnection(conn.getInfo().peer_name).c_str(),
+                        peerTypeToString(peer_type),
+                        getBytesPending(),
+                        getBytesPending(peer_type),
+                        conn.getBytesPending());
+      err = E::NOBUFS;
+      STAT_INCR(Worker::stats(), send_failed_nobufs);
+      if (peer_quota_reached) {
+        STAT_INCR(Worker::stats(), send_failed_nobufs_peer_quota);
+      }
+      return -1;
+    }
   }
 
   auto envelope = conn.registerMessage(std::move(msg));
@@ -1125,6 +1140,19 @@ bool SocketSender::bytesPendingLimitReached(const PeerType peer_type) const {
   return limit_reached;
 }
 
+bool SocketSender::peerOutBufQuotaReached(const Connection& conn) const {
+  auto& settings = Worker::settings();
+  const double percent = settings.outbuf_socket_max_percent;
+  if (percent == 0) {
+    return false;
+  }
+  const size_t limit = settings.outbufs_mb_max_per_thread * 1024 * 1024;
+  const size_t quota = static_cast<size_t>(limit * percent / 100);
+  // Like the global limit, the quota never takes a connection below its
+  // guaranteed minimum budget (--outbuf-socket-min-kb).
+  return conn.getBytesPending() > quota && conn.minOutBufLimitReached();
+}
+
 void SocketSender::queueMessageCompletion(std::unique_ptr<Message> msg,
                                           const Address& to,
                                           Status s,
@@ -1251,11 +1279,21 @@ void SocketSender::cleanupConnections() {
           entry.first);
     }
   }
+  bool close_idle_incoming = settings_->server &&
+      settings_->close_idle_incoming_connections;
   for (auto& entry : impl_->client_conns_) {
     Connection* conn = entry.second.get();
     if (conn) {
       ++num_sockets;
       close_if_slow(*conn);
+      // Optionally reap idle incoming connections too; with tens of
+      // thousands of mostly-idle clients per server this is what keeps the
+      // server-side connection count bounded. The client reconnects
+      // transparently when it needs the connection again.
+      if (close_idle_incoming && idle_connections_closed < max_idle_closures &&
+          !conn->isClosed()) {
+        close_if_idle(*conn);
+      }
     } else {
       RATELIMIT_CRITICAL(
           std::chrono::seconds(10),
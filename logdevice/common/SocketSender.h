@@ -211,6 +211,13 @@ class SocketSender : public Sender {
    */
   bool bytesPendingLimitReached(PeerType peer_type) const;
 
+  /**
+   * @return true iff the given Connection alone holds more than its allowed
+   *              share of the outbufs budget (--outbuf-socket-max-percent).
+   *              Always false when the per-connection cap is disabled.
+   */
+  bool peerOutBufQuotaReached(const Connection& conn) const;
+
   /**
    * Queue a message for a deferred completion. Used from contexts that
    * must be protected from re-entrance into Sender.
@@ -10,6 +10,7 @@
 #include <folly/Optional.h>
 
 #include "logdevice/common/ThreadID.h"
+#include "logdevice/common/config.h"
 #include "logdevice/common/configuration/ServerConfig.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/common/plugin/PluginRegistry.h"
@@ -18,6 +19,14 @@
 #include "logdevice/common/settings/UpdateableSettings.h"
 #include "logdevice/common/stats/Stats.h"
 
+#ifdef LOGDEVICE_USING_JEMALLOC
+// The binary may not actually be linked with jemalloc; declaring mallctl as a
+// weak symbol lets us check at runtime (the pointer is null if jemalloc is
+// absent). Same approach as admincommands/StatsJemalloc.h.
+extern "C" int mallctl(const char*, void*, size_t*, void*, size_t)
+    __attribute__((__nothrow__, __weak__));
+#endif
+
 namespace facebook { namespace logdevice {
 
 StatsCollectionThread::StatsCollectionThread(
@@ -41,6 +50,37 @@ struct StatsSnapshots {
   std::vector<Stats> stats;
   std::chrono::steady_clock::time_point when;
 };
+
+// Overwrites the allocator gauges in the aggregated snapshot with fresh
+// numbers from jemalloc, so publishers export allocator-level memory usage
+// next to the per-subsystem byte gauges. No-op when the binary is not linked
+// with jemalloc.
+void setJemallocStats(Stats& stats) {
+#ifdef LOGDEVICE_USING_JEMALLOC
+  if (mallctl == nullptr) {
+    return;
+  }
+  // Bump the epoch to flush jemalloc's internal stats caches.
+  uint64_t epoch = 1;
+  size_t sz = sizeof(epoch);
+  mallctl("epoch", &epoch, &sz, &epoch, sz);
+
+  auto get = [](const char* name, StatsCounter& out) {
+    size_t val = 0;
+    size_t val_sz = sizeof(val);
+    if (mallctl(name, &val, &val_sz, nullptr, 0) == 0) {
+      out = val;
+    }
+  };
+  get("stats.allocated", stats.jemalloc_allocated_bytes);
+  get("stats.active", stats.jemalloc_active_bytes);
+  get("stats.metadata", stats.jemalloc_metadata_bytes);
+  get("stats.resident", stats.jemalloc_resident_bytes);
+  get("stats.mapped", stats.jemalloc_mapped_bytes);
+#else
+  (void)stats;
+#endif
+}
 } // namespace
 
 void StatsCollectionThread::addStatsSource(const StatsHolder* source) {
@@ -68,6 +108,12 @@ void StatsCollectionThread::mainLoop() {
       }
     }
 
+    if (!current_snapshots.stats.empty()) {
+      // The gauges are process-wide; attach them to the first source only so
+      // publishers merging multiple sources don't double count.
+      setJemallocStats(current_snapshots.stats[0]);
+    }
+
     ld_debug("Publishing Stats...");
     if (!previous_snapshots.stats.empty()) {
       ld_check_gt(previous_snapshots.stats.size(), 0);
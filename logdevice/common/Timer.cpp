@@ -196,7 +196,15 @@ TimerInterface& Timer::getTimerImpl() const {
     // This is called from tests and ldbench workers. Caller cannot assume
     // Worker interface to be available in those cases.
     auto worker = Worker::onThisThread(false /* enforce_worker */);
-    if (worker && worker->updateable_settings_->enable_hh_wheel_backed_timers) {
+    if (worker &&
+        worker->updateable_settings_->enable_worker_local_timer_wheel) {
+      // LibEventTimerImpl schedules an EvTimerWithFolly on this Worker's own
+      // event base, which keeps timeouts in the base's HHWheelTimer: O(1)
+      // schedule/cancel with no cross-thread dispatch. Preferred for the
+      // high-volume store/retry timers over the shared wheel thread below.
+      impl_ = std::make_unique<LibEventTimerImpl>();
+    } else if (worker &&
+               worker->updateable_settings_->enable_hh_wheel_backed_timers) {
       impl_ = std::make_unique<WheelTimerDispatchImpl>();
     } else {
       impl_ = std::make_unique<LibEventTimerImpl>();
@@ -135,6 +135,16 @@ void TrafficShaper::mainLoop() {
     // other threads in a heavily utilized systems.
     std::unique_lock<std::mutex> cv_lock(mainLoopWaitMutex_);
     while (in_a_row < kMaxDispatchesInARow && !mainLoopStop_.load()) {
+      // Pick up dynamic changes to the dispatch interval. Credit amounts are
+      // normalized to the interval on every dispatch, so changing it does
+      // not change the configured bandwidth limits. The new value takes
+      // effect after at most one sleep on the old interval.
+      auto configured_interval =
+          processor_->settings()->traffic_shaper_update_interval;
+      if (configured_interval.count() > 0 &&
+          configured_interval != updateInterval_) {
+        updateInterval_ = configured_interval;
+      }
       HISTOGRAM_ADD(stats_, traffic_shaper_bw_dispatch, usec_since(next_run));
       bool timed_sleep_nw = dispatchUpdateNw();
       bool timed_sleep_readio = dispatchUpdateReadIO();
@@ -175,6 +185,38 @@ bool TrafficShaper::dispatchUpdateCommon(
     FlowGroupsUpdate& update,
     FlowGroupDependencies* deps) {
   bool future_updates_required = false;
+
+  // Work-conserving credit sharing across scopes: priority queue credit that
+  // a broader scope could not place in its buckets during the last quantum
+  // (and that the loop below would otherwise discard) is donated to the next
+  // narrower enabled scope, e.g. unused RACK budget becomes available to the
+  // NODE flow group. The donated credit is deposited via the receiving
+  // scope's priority queue bucket, so its per-priority guarantees, burst
+  // capacities and deposit budgets still apply.
+  if (processor_->settings()->traffic_shaping_cross_scope_sharing) {
+    int64_t donation = 0;
+    for (auto scope = NodeLocationScope::ROOT;
+         scope != NodeLocationScope::INVALID;
+         scope = NodeLocation::nextSmallerScope(scope)) {
+      auto entry_it = update.group_entries.find(scope);
+      auto policy_it = shaping_config.flowGroupPolicies.find(scope);
+      if (entry_it == update.group_entries.end() ||
+          policy_it == shaping_config.flowGroupPolicies.end() ||
+          !policy_it->second.enabled()) {
+        continue;
+      }
+      auto& pq_entry = entry_it->second.priorityQEntry();
+      if (donation > 0) {
+        deps->statsAdd(&PerFlowGroupStats::bwshared, scope, donation);
+        pq_entry.cur_overflow += donation;
+      }
+      donation = pq_entry.last_overflow;
+      pq_entry.last_overflow = 0;
+    }
+    // Any donation left after the narrowest scope is discarded, as it would
+    // have been without sharing.
+  }
+
   for (auto& policy_it : shaping_config.flowGroupPolicies) {
     auto scope = policy_it.first;
     auto entry_it = update.group_entries.find(scope);
@@ -8,7 +8,9 @@
 #include "logdevice/common/WeightedCopySetSelector.h"
 
 #include "logdevice/common/CopySet.h"
+#include "logdevice/common/CopySetHierarchyCache.h"
 #include "logdevice/common/HashBasedSequencerLocator.h"
+#include "logdevice/common/Worker.h"
 #include "logdevice/common/configuration/nodes/NodesConfiguration.h"
 #include "logdevice/common/stats/Stats.h"
 #include "logdevice/common/util.h"
@@ -20,6 +22,13 @@ using NodeStatus = NodeAvailabilityChecker::NodeStatus;
 // See select() for explanation.
 static constexpr int MAX_BLACKLISTING_ITERATIONS = 100;
 
+// How many times a cached hierarchy may be incrementally re-weighted before
+// we force a full rebuild. Each re-weight shifts prefix sums in place
+// (ProbabilityDistribution::updateWeight()), so numerical error can slowly
+// accumulate in the ancestor domains' weights; this bounds it, similar to
+// DomainAdjustment::correctAccumulatedNumericalError().
+static constexpr int MAX_INCREMENTAL_REWEIGHTS = 50;
+
 // Returns either floor(x) or ceil(x), so that, on average, the return value
 // is equal to x. In particular, if x is integer returns x.
 static copyset_size_t randomRound(double x, RNG& rng) {
@@ -108,106 +117,171 @@ WeightedCopySetSelector::WeightedCopySetSelector(
             epoch_metadata, *nodes_configuration, log_attrs)
       : epoch_metadata.weights;
 
-  // Build the hierarchy. It'll always have these three levels:
-  // 1. Root.
-  // 2. Domains of scope secondary_replication_scope.
-  // 3. Domains of scope replication_scope.
-  //    They're leaves, i.e. nodes are attached directly to them.
-  // For simplicity, there'll be all 3 levels even if
-  // secondary_replication_scope == replication_scope or
-  // replication_scope == NODE. There's no special treatment of these cases.
+  // During a config-change storm a new selector is created for every affected
+  // log, and building the hierarchy from scratch each time is O(nodeset size)
+  // per log. The Worker keeps a cache of the hierarchy each log's previous
+  // selector was built with: if nothing relevant changed we share it, and if
+  // only some weights changed we derive a new version from it by adjusting
+  // just the changed nodes' domain paths. Off-Worker (tests, tools) there's
+  // no cache and we always do the full build below.
+  Worker* worker = Worker::onThisThread(false /* enforce_worker */);
+  CopySetHierarchyCache* cache =
+      worker != nullptr ? &worker->copySetHierarchyCache() : nullptr;
+  std::string topology;
+  if (cache != nullptr) {
+    topology = topologyFingerprint(epoch_metadata, *nodes_configuration);
+    CopySetHierarchyCache::Entry* entry = cache->find(logid);
+    if (entry != nullptr && entry->topology == topology) {
+      auto base = std::static_pointer_cast<const Hierarchy>(entry->hierarchy);
+      if (entry->weights == weights) {
+        hierarchy_ = std::move(base);
+        STAT_INCR(stats_, copyset_hierarchy_shared);
+      } else if (entry->reweights < MAX_INCREMENTAL_REWEIGHTS) {
+        hierarchy_ = reweightHierarchy(
+            *base, epoch_metadata.shards, entry->weights, weights);
+        entry->hierarchy = hierarchy_;
+        entry->weights = weights;
+        ++entry->reweights;
+        STAT_INCR(stats_, copyset_hierarchy_reweighted);
+      }
+      // Otherwise the entry went through too many incremental re-weights;
+      // fall through to a full rebuild to shed the numerical error.
+    }
+  }
 
-  std::unordered_map<std::string, size_t> secondary_domain_idx;
-  std::unordered_map<std::string, size_t> domain_idx;
+  if (hierarchy_ == nullptr) {
+    // Build the hierarchy. It'll always have these three levels:
+    // 1. Root.
+    // 2. Domains of scope secondary_replication_scope.
+    // 3. Domains of scope replication_scope.
+    //    They're leaves, i.e. nodes are attached directly to them.
+    // For simplicity, there'll be all 3 levels even if
+    // secondary_replication_scope == replication_scope or
+    // replication_scope == NODE. There's no special treatment of these cases.
+
+    Hierarchy hierarchy;
+    std::unordered_map<std::string, size_t> secondary_domain_idx;
+    std::unordered_map<std::string, size_t> domain_idx;
+
+    // Shuffle the nodeset before building hierarchy. This randomizes the order
+    // of domains in the tree, increasing scatter width for rebuilding.
+    //
+    // Example: there are 4 racks of the same weight, and we're replicating to
+    // 2 racks; if all WeightedCopySetSelectors have the 4 racks in the same
+    // order in their Hierarchies, say [a, b, c, d], then, most of the time,
+    // none of the copysets containing nodes from rack a would contain nodes
+    // from racks b or d (because of systematic sampling). So if we were to
+    // rebuild rack a, rack c would have to do all of the rebuilding work.
+    std::vector<size_t> nodeset_permutation(epoch_metadata.shards.size());
+    std::iota(nodeset_permutation.begin(), nodeset_permutation.end(), 0);
+    simple_shuffle(
+        nodeset_permutation.begin(), nodeset_permutation.end(), init_rng);
+
+    for (size_t i : nodeset_permutation) {
+      ShardID shard = epoch_metadata.shards[i];
+      double weight = weights[i];
+
+      const auto* node_sd =
+          nodes_configuration->getNodeServiceDiscovery(shard.node());
+      if (node_sd == nullptr) {
+        continue;
+      }
 
-  // Shuffle the nodeset before building hierarchy. This randomizes the order
-  // of domains in the tree, increasing scatter width for rebuilding.
-  //
-  // Example: there are 4 racks of the same weight, and we're replicating to
-  // 2 racks; if all WeightedCopySetSelectors have the 4 racks in the same
-  // order in their Hierarchies, say [a, b, c, d], then, most of the time,
-  // none of the copysets containing nodes from rack a would contain nodes from
-  // racks b or d (because of systematic sampling). So if we were to
-  // rebuild rack a, rack c would have to do all of the rebuilding work.
-  std::vector<size_t> nodeset_permutation(epoch_metadata.shards.size());
-  std::iota(nodeset_permutation.begin(), nodeset_permutation.end(), 0);
-  simple_shuffle(
-      nodeset_permutation.begin(), nodeset_permutation.end(), init_rng);
-
-  for (size_t i : nodeset_permutation) {
-    ShardID shard = epoch_metadata.shards[i];
-    double weight = weights[i];
+      const auto& storage_membership =
+          nodes_configuration->getStorageMembership();
+      if (!storage_membership->shouldReadFromShard(shard)) {
+        // storage membership now has more granular view of per-shard storage
+        // state. exclude shards that are not readable (e.g., in NONE storage
+        // state).
+        continue;
+      }
 
-    const auto* node_sd =
-        nodes_configuration->getNodeServiceDiscovery(shard.node());
-    if (node_sd == nullptr) {
-      continue;
-    }
+      NodeLocation location = node_sd->location.value_or(NodeLocation());
+      std::string domain = location.getDomain(replication_scope_, shard.node());
+      std::string secondary_domain =
+          location.getDomain(secondary_replication_scope_, shard.node());
 
-    const auto& storage_membership =
-        nodes_configuration->getStorageMembership();
-    if (!storage_membership->shouldReadFromShard(shard)) {
-      // storage membership now has more granular view of per-shard storage
-      // state. exclude shards that are not readable (e.g., in NONE storage
-      // state).
-      continue;
-    }
+      // Add node to the tree even if node has zero weight (and so will never
+      // be picked).
+      // It's needed for augment() in case some existing copyset contains it.
 
-    NodeLocation location = node_sd->location.value_or(NodeLocation());
-    std::string domain = location.getDomain(replication_scope_, shard.node());
-    std::string secondary_domain =
-        location.getDomain(secondary_replication_scope_, shard.node());
+      // Insert or get secondary domain.
+      size_t secondary_idx;
+      if (secondary_domain_idx.count(secondary_domain)) {
+        secondary_idx = secondary_domain_idx[secondary_domain];
+      } else {
+        secondary_idx = hierarchy.root.subdomains.size();
+        hierarchy.root.subdomains.emplace_back();
+        secondary_domain_idx[secondary_domain] = secondary_idx;
+      }
+      Domain* secondary = &hierarchy.root.subdomains[secondary_idx];
 
-    // Add node to the tree even if node has zero weight (and so will never
-    // be picked).
-    // It's needed for augment() in case some existing copyset contains it.
+      // Insert or get leaf domain.
+      size_t idx;
+      if (domain_idx.count(domain)) {
+        idx = domain_idx[domain];
+      } else {
+        idx = secondary->subdomains.size();
+        secondary->subdomains.emplace_back();
+        domain_idx[domain] = idx;
+      }
+      Domain* leaf = &secondary->subdomains[idx];
 
-    // Insert or get secondary domain.
-    size_t secondary_idx;
-    if (secondary_domain_idx.count(secondary_domain)) {
-      secondary_idx = secondary_domain_idx[secondary_domain];
-    } else {
-      secondary_idx = hierarchy_.root.subdomains.size();
-      hierarchy_.root.subdomains.emplace_back();
-      secondary_domain_idx[secondary_domain] = secondary_idx;
-    }
-    Domain* secondary = &hierarchy_.root.subdomains[secondary_idx];
+      // Add node to the leaf.
+      size_t node_idx_in_leaf = leaf->node_ids.size();
+      leaf->node_ids.push_back(shard);
+      leaf->weights.push_back(weight);
 
-    // Insert or get leaf domain.
-    size_t idx;
-    if (domain_idx.count(domain)) {
-      idx = domain_idx[domain];
-    } else {
-      idx = secondary->subdomains.size();
-      secondary->subdomains.emplace_back();
-      domain_idx[domain] = idx;
+      // Remember where this node lives.
+      hierarchy.node_paths[shard] = {secondary_idx, idx, node_idx_in_leaf};
     }
-    Domain* leaf = &secondary->subdomains[idx];
-
-    // Add node to the leaf.
-    size_t node_idx_in_leaf = leaf->node_ids.size();
-    leaf->node_ids.push_back(shard);
-    leaf->weights.push_back(weight);
 
-    // Remember where this node lives.
-    hierarchy_.node_paths[shard] = {secondary_idx, idx, node_idx_in_leaf};
-  }
+    // Calculate weights of secondary domains.
+    for (size_t secondary_idx = 0;
+         secondary_idx < hierarchy.root.subdomains.size();
+         ++secondary_idx) {
+      Domain* secondary = &hierarchy.root.subdomains[secondary_idx];
+      for (size_t idx = 0; idx < secondary->subdomains.size(); ++idx) {
+        secondary->weights.push_back(
+            secondary->subdomains[idx].weights.totalWeight());
+      }
+      hierarchy.root.weights.push_back(secondary->weights.totalWeight());
+    }
 
-  // Calculate weights of secondary domains.
-  for (size_t secondary_idx = 0;
-       secondary_idx < hierarchy_.root.subdomains.size();
-       ++secondary_idx) {
-    Domain* secondary = &hierarchy_.root.subdomains[secondary_idx];
-    for (size_t idx = 0; idx < secondary->subdomains.size(); ++idx) {
-      secondary->weights.push_back(
-          secondary->subdomains[idx].weights.totalWeight());
+    // Find my node's domain.
+    if (my_domain.has_value() &&
+        secondary_domain_idx.count(my_domain.value())) {
+      my_domain_idx_ = secondary_domain_idx[my_domain.value()];
     }
-    hierarchy_.root.weights.push_back(secondary->weights.totalWeight());
-  }
 
-  // Find my node's domain.
-  if (my_domain.has_value() && secondary_domain_idx.count(my_domain.value())) {
-    my_domain_idx_ = secondary_domain_idx[my_domain.value()];
+    hierarchy_ = std::make_shared<const Hierarchy>(std::move(hierarchy));
+    if (cache != nullptr) {
+      STAT_INCR(stats_, copyset_hierarchy_rebuilt);
+      cache->put(logid,
+                 CopySetHierarchyCache::Entry{
+                     hierarchy_, std::move(topology), weights, 0});
+    }
+  } else {
+    // Find my node's domain in the shared hierarchy. The domain names aren't
+    // stored in the tree, but any nodeset shard from the same
+    // secondary-scope domain gives us the index.
+    if (my_domain.has_value()) {
+      for (ShardID shard : epoch_metadata.shards) {
+        auto it = hierarchy_->node_paths.find(shard);
+        if (it == hierarchy_->node_paths.end()) {
+          continue;
+        }
+        const auto* node_sd =
+            nodes_configuration->getNodeServiceDiscovery(shard.node());
+        ld_check(node_sd != nullptr);
+        NodeLocation location = node_sd->location.value_or(NodeLocation());
+        if (location.getDomain(secondary_replication_scope_, shard.node()) ==
+            my_domain.value()) {
+          my_domain_idx_ = it->second[0];
+          break;
+        }
+      }
+    }
   }
 
   ld_debug("Created WeightedCopySetSelector for log %lu. Nodeset: %s, "
@@ -217,7 +291,68 @@ WeightedCopySetSelector::WeightedCopySetSelector(
            logdevice::toString(weights).c_str(),
            (int)replication_,
            (int)secondary_replication_,
-           hierarchy_.toString().c_str());
+           hierarchy_->toString().c_str());
+}
+
+std::string WeightedCopySetSelector::topologyFingerprint(
+    const EpochMetaData& epoch_metadata,
+    const configuration::nodes::NodesConfiguration& nodes_configuration)
+    const {
+  std::string out;
+  out += std::to_string((int)secondary_replication_scope_) + ',' +
+      std::to_string(secondary_replication_) + ',' +
+      std::to_string((int)replication_scope_) + ',' +
+      std::to_string(replication_) + ';';
+  for (ShardID shard : epoch_metadata.shards) {
+    const auto* node_sd =
+        nodes_configuration.getNodeServiceDiscovery(shard.node());
+    const auto& storage_membership = nodes_configuration.getStorageMembership();
+    if (node_sd == nullptr || !storage_membership->shouldReadFromShard(shard)) {
+      // Excluded from the tree; distinct from any real pair of domains.
+      out += shard.toString() + "|;";
+      continue;
+    }
+    NodeLocation location = node_sd->location.value_or(NodeLocation());
+    out += shard.toString() + '|' +
+        location.getDomain(secondary_replication_scope_, shard.node()) + '|' +
+        location.getDomain(replication_scope_, shard.node()) + ';';
+  }
+  return out;
+}
+
+std::shared_ptr<const WeightedCopySetSelector::Hierarchy>
+WeightedCopySetSelector::reweightHierarchy(
+    const Hierarchy& base,
+    const StorageSet& shards,
+    const std::vector<double>& old_weights,
+    const std::vector<double>& new_weights) const {
+  ld_check(old_weights.size() == shards.size());
+  ld_check(new_weights.size() == shards.size());
+  auto hierarchy = std::make_shared<Hierarchy>(base);
+  for (size_t i = 0; i < shards.size(); ++i) {
+    if (old_weights[i] == new_weights[i]) {
+      continue;
+    }
+    auto it = hierarchy->node_paths.find(shards[i]);
+    if (it == hierarchy->node_paths.end()) {
+      // Not in the tree; the matching fingerprint guarantees a full build
+      // would exclude this shard too.
+      continue;
+    }
+    const Hierarchy::Path& path = it->second;
+    ld_check(path.size() == 3);
+    Domain& secondary = hierarchy->root.subdomains[path[0]];
+    Domain& leaf = secondary.subdomains[path[1]];
+    const double delta = new_weights[i] - old_weights[i];
+    leaf.weights.updateWeight(path[2], new_weights[i]);
+    // Clamp to zero in case rounding takes an emptied domain slightly
+    // negative.
+    secondary.weights.updateWeight(
+        path[1], std::max(0., secondary.weights.weight(path[1]) + delta));
+    hierarchy->root.weights.updateWeight(
+        path[0], std::max(0., hierarchy->root.weights.weight(path[0]) + delta));
+  }
+  return hierarchy;
 }
 
 std::vector<double> WeightedCopySetSelector::calculateWeightsBasedOnConfig(
@@ -613,7 +748,7 @@ WeightedCopySetSelector::prepareCachedNodeAvailability() const {
   NodeAvailabilityCache& cache = *node_availability_cache_.get();
   if (!cache.adjusted_hierarchy.has_value()) {
     ld_check(cache.unavailable_nodes.empty());
-    cache.adjusted_hierarchy.emplace(&hierarchy_);
+    cache.adjusted_hierarchy.emplace(hierarchy_.get());
   }
   // Re-check all the nodes that were unavailable last time.
   for (int i = (int)cache.unavailable_nodes.size() - 1; i >= 0; --i) {
@@ -705,7 +840,7 @@ WeightedCopySetSelector::select(StoreChainLink copyset_out[],
   // Need to make a copy in case we'll detach local domain - don't want to
   // cache that.
   AdjustedHierarchy hierarchy = cache.adjusted_hierarchy.value();
-  const double total_weight = hierarchy_.root.weights.totalWeight();
+  const double total_weight = hierarchy_->root.weights.totalWeight();
 
   bool biased = false;
   copyset_chain_t copyset_chain(replication_);
@@ -967,8 +1102,8 @@ void WeightedCopySetSelector::splitExistingCopySet(
 
   // Updates hierarchy. Returns true if the node is useful, false if redundant.
   auto process_node = [&](ShardID node) {
-    auto it = hierarchy_.node_paths.find(node);
-    if (it == hierarchy_.node_paths.end()) {
+    auto it = hierarchy_->node_paths.find(node);
+    if (it == hierarchy_->node_paths.end()) {
       RATELIMIT_ERROR(
           std::chrono::seconds(10),
           2,
@@ -1451,7 +1586,7 @@ size_t WeightedCopySetSelector::selectCrossDomain(size_t num_domains,
       continue;
     }
     if (domain.getWeights().weight(subdomain_idx) <
-        Sampling::EPSILON * hierarchy_.root.weights.totalWeight()) {
+        Sampling::EPSILON * hierarchy_->root.weights.totalWeight()) {
       // Nothing pickable here.
       continue;
     }
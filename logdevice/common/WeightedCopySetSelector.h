@@ -7,6 +7,8 @@
  */
 #pragma once
 
+#include <memory>
+
 #include "logdevice/common/CopySetSelector.h"
 #include "logdevice/common/CopySetSelectorDependencies.h"
 #include "logdevice/common/EpochMetaData.h"
@@ -305,9 +307,14 @@ class WeightedCopySetSelector : public CopySetSelector {
 
   StorageSet nodeset_indices_;
 
-  Hierarchy hierarchy_;
+  // Immutable once built. Shared, via the Worker's CopySetHierarchyCache,
+  // with past and future selectors for the same log that were built with the
+  // same topology and weights; per-selector adjustments (blacklisting,
+  // detaching the local domain) go through AdjustedHierarchy instead of
+  // modifying the tree. Re-weighting publishes a new copy (copy-on-write).
+  std::shared_ptr<const Hierarchy> hierarchy_;
 
-  // Index of the local domain in `hierarchy_.root.subdomains`.
+  // Index of the local domain in `hierarchy_->root.subdomains`.
   // folly::none if my domain doesn't intersect the nodeset.
   folly::Optional<size_t> my_domain_idx_;
 
@@ -337,6 +344,26 @@ class WeightedCopySetSelector : public CopySetSelector {
       const logsconfig::LogAttributes* log_attrs,
       std::unordered_map<std::string, double>& domain_target_weight);
 
+  // Serializes everything apart from the weights that determines the shape
+  // of the hierarchy: replication scopes and factors, and each nodeset
+  // shard's domains (or its exclusion from the tree). Used as the validation
+  // key for CopySetHierarchyCache entries; a cached hierarchy is only reused
+  // if its fingerprint matches.
+  std::string topologyFingerprint(
+      const EpochMetaData& epoch_metadata,
+      const configuration::nodes::NodesConfiguration& nodes_configuration)
+      const;
+
+  // Makes a copy of `base` with the weights of the nodes whose weight changed
+  // (old_weights[i] != new_weights[i]) updated along their domain paths,
+  // leaving the topology and the order of domains intact. O(changed nodes),
+  // as opposed to rebuilding the whole tree.
+  std::shared_ptr<const Hierarchy>
+  reweightHierarchy(const Hierarchy& base,
+                    const StorageSet& shards,
+                    const std::vector<double>& old_weights,
+                    const std::vector<double>& new_weights) const;
+
   // Returns the thread-local instance of NodeAvailabilityCache, after
   // initializing it if needed and re-checking the cached blacklist of nodes.
   NodeAvailabilityCache& prepareCachedNodeAvailability() const;
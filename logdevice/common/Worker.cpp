@@ -42,8 +42,12 @@
 #include "logdevice/common/GetHeadAttributesRequest.h"
 #include "logdevice/common/GetLogInfoRequest.h"
 #include "logdevice/common/GetRsmSnapshotRequest.h"
+#include "logdevice/common/GetTailRecordsRequest.h"
 #include "logdevice/common/GetTrimPointRequest.h"
 #include "logdevice/common/GraylistingTracker.h"
+#include "logdevice/common/CopySetHierarchyCache.h"
+#include "logdevice/common/LogGroupAppendThrottle.h"
+#include "logdevice/common/PrincipalThrottle.h"
 #include "logdevice/common/LogIDUniqueQueue.h"
 #include "logdevice/common/LogRecoveryRequest.h"
 #include "logdevice/common/LogsConfigApiRequest.h"
@@ -51,7 +55,10 @@
 #include "logdevice/common/MetaDataLogWriter.h"
 #include "logdevice/common/NodesConfigurationUpdatedRequest.h"
 #include "logdevice/common/PermissionChecker.h"
+#include "logdevice/common/AppendBatcher.h"
+#include "logdevice/common/AppendedCoalescer.h"
 #include "logdevice/common/Processor.h"
+#include "logdevice/common/ReleaseCoalescer.h"
 #include "logdevice/common/SSLFetcher.h"
 #include "logdevice/common/SequencerBackgroundActivator.h"
 #include "logdevice/common/ServerConfigUpdatedRequest.h"
@@ -62,6 +69,7 @@
 #include "logdevice/common/TrimRequest.h"
 #include "logdevice/common/WorkerTimeoutStats.h"
 #include "logdevice/common/WriteMetaDataRecord.h"
+#include "logdevice/common/configuration/LocalLogsConfig.h"
 #include "logdevice/common/configuration/ServerConfig.h"
 #include "logdevice/common/configuration/UpdateableConfig.h"
 #include "logdevice/common/configuration/logs/LogsConfigManager.h"
@@ -141,6 +149,7 @@ class WorkerImpl {
                         w->immutable_settings_->num_workers),
         // TODO: Make this configurable
         previously_redirected_appends_(1024),
+        releaseCoalescer_(w->immutable_settings_->release_coalescing_window),
         graylistingTracker_(std::make_unique<GraylistingTracker>()),
         clientReadStreamDebugHandler_{
             w->processor_->csid_,
@@ -150,6 +159,8 @@ class WorkerImpl {
             w->processor_->updateableSettings()
                 ->all_read_streams_debug_config_path,
             clientReadStreams_} {
+    runningAppends_.map.reserve(
+        w->immutable_settings_->worker_map_reserved_capacity);
     const auto& read_shaping_cfg =
         config->get()->serverConfig()->getReadIOShapingConfig();
     read_shaping_container_ = std::make_unique<ShapingContainer>(
@@ -168,6 +179,7 @@ class WorkerImpl {
   TrimRequestMap runningTrimRequests_;
   GetRsmSnapshotRequestMap runningGetRsmSnapshotRequests_;
   GetTrimPointRequestMap runningGetTrimPoint_;
+  GetTailRecordsRequestMap runningGetTailRecords_;
   DataSizeRequestMap runningDataSize_;
   GetHeadAttributesRequestMap runningGetHeadAttributes_;
   GetClusterStateRequestMap runningGetClusterState_;
@@ -187,6 +199,9 @@ class WorkerImpl {
   SyncSequencerRequestList runningSyncSequencerRequests_;
   AppenderBuffer appenderBuffer_;
   AppenderBuffer previously_redirected_appends_;
+  ReleaseCoalescer releaseCoalescer_;
+  AppendedCoalescer appendedCoalescer_;
+  AppendBatcher appendBatcher_;
   LogIDUniqueQueue recoveryQueueDataLog_;
   LogIDUniqueQueue recoveryQueueMetaDataLog_;
   WriteMetaDataRecordMap runningWriteMetaDataRecords_;
@@ -241,7 +256,9 @@ Worker::Worker(WorkContext::KeepAlive event_loop,
       worker_stall_inj_ms_(
           processor->updateableSettings()->health_monitor_max_stalls_avg_ms),
       worker_queue_inj_ms_(processor->updateableSettings()
-                               ->health_monitor_max_queue_stalls_avg_ms) {}
+                               ->health_monitor_max_queue_stalls_avg_ms) {
+  log_group_cache_.reserve(immutable_settings_->worker_map_reserved_capacity);
+}
 
 Worker::~Worker() {
   shutting_down_ = true;
@@ -295,9 +312,15 @@ std::string Worker::getName(WorkerType type, worker_id_t idx) {
   return std::string("W") + workerTypeChar(type) + std::to_string(idx.val_);
 }
 
-std::shared_ptr<Configuration> Worker::getConfiguration() const {
+const std::shared_ptr<Configuration>& Worker::getConfiguration() const {
   ld_check((bool)config_);
-  return config_->get();
+  if (!cached_config_) {
+    // Assembling a Configuration touches four FastUpdateableSharedPtrs and
+    // allocates; pin the snapshot until the next config update callback.
+    // A nullptr result (no ServerConfig yet) is not cached.
+    cached_config_ = config_->get();
+  }
+  return cached_config_;
 }
 
 std::shared_ptr<ServerConfig> Worker::getServerConfig() const {
@@ -305,9 +328,12 @@ std::shared_ptr<ServerConfig> Worker::getServerConfig() const {
   return config_->getServerConfig();
 }
 
-std::shared_ptr<const configuration::nodes::NodesConfiguration>
+const std::shared_ptr<const configuration::nodes::NodesConfiguration>&
 Worker::getNodesConfiguration() const {
-  return config_->getNodesConfiguration();
+  if (!cached_nodes_configuration_) {
+    cached_nodes_configuration_ = config_->getNodesConfiguration();
+  }
+  return cached_nodes_configuration_;
 }
 
 std::shared_ptr<LogsConfig> Worker::getLogsConfig() const {
@@ -327,6 +353,15 @@ std::shared_ptr<UpdateableConfig> Worker::getUpdateableConfig() {
 }
 
 void Worker::onLogsConfigUpdated() {
+  // Invalidate the log group lookup cache; the raw pointers in it point
+  // into the snapshot that is being replaced.
+  log_group_cache_.clear();
+  log_group_cache_config_.reset();
+  cached_config_.reset();
+  if (log_group_append_throttle_) {
+    log_group_append_throttle_->noteLogsConfigUpdated();
+  }
+
   clientReadStreams().noteConfigurationChanged();
   if (rebuilding_coordinator_) {
     rebuilding_coordinator_->noteConfigurationChanged();
@@ -346,12 +381,19 @@ void Worker::onLogsConfigUpdated() {
 
 void Worker::onServerConfigUpdated() {
   ld_check(Worker::onThisThread() == this);
+  cached_config_.reset();
+  cached_nodes_configuration_.reset();
 
   dbg::thisThreadClusterName() =
-      config_->get()->serverConfig()->getClusterName();
+      getConfiguration()->serverConfig()->getClusterName();
 
   sender().noteConfigurationChanged(getNodesConfiguration());
 
+  if (principal_throttle_) {
+    // Principal throughput ceilings come from the server config.
+    principal_throttle_->noteConfigUpdated();
+  }
+
   if (logsconfig_manager_) {
     logsconfig_manager_->onServerConfigUpdated();
   }
@@ -437,6 +479,8 @@ void Worker::onSettingsUpdated() {
       {immutable_settings_->hi_requests_per_iteration,
        immutable_settings_->mid_requests_per_iteration,
        immutable_settings_->lo_requests_per_iteration});
+  event_loop->getTaskQueue().setIterationBudget(
+      immutable_settings_->worker_iteration_overrun_threshold);
   clientReadStreams().noteSettingsUpdated();
   if (logsconfig_manager_) {
     // LogsConfigManager might want to start or stop the underlying RSM if
@@ -548,6 +592,7 @@ void Worker::initSSLFetcher() {
                                     setting.ssl_key_path,
                                     setting.ssl_ca_path,
                                     setting.ssl_load_client_cert,
+                                    setting.ssl_enable_ktls,
                                     stats());
 }
 
@@ -640,6 +685,13 @@ void Worker::finishWorkAndCloseSockets() {
     ld_info("Aborted %lu get-trim-point requests", c);
   }
 
+  // abort get-tail-records requests
+  if (!runningGetTailRecords().map.empty()) {
+    c = runningGetTailRecords().map.size();
+    runningGetTailRecords().map.clear();
+    ld_info("Aborted %lu get-tail-records requests", c);
+  }
+
   // abort get-rsm-snapshot requests
   if (!runningGetRsmSnapshotRequests().map.empty()) {
     c = runningGetRsmSnapshotRequests().map.size();
@@ -814,6 +866,7 @@ bool Worker::requestsPending() const {
   PROCESS(runningFireAndForgets().map, "fire and forgets");
   PROCESS(runningGetLogInfo().gli_map, "get log infos");
   PROCESS(runningGetLogInfo().per_node_map, "per-node get log infos");
+  PROCESS(runningGetTailRecords().map, "get tail records requests");
   PROCESS(runningGetTrimPoint().map, "get log trim points");
   PROCESS(runningTrimRequests().map, "trim requests");
   PROCESS(runningSyncSequencerRequests().getList(), "sync sequencer requests");
@@ -1010,6 +1063,12 @@ void Worker::onStoppedRunning(RunContext prev_context) {
 
   auto usec =
       std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+
+  if (currently_running_log_ != LOGID_INVALID) {
+    WORKER_LOG_STAT_ADD(currently_running_log_, worker_cpu_usec, usec);
+    currently_running_log_ = LOGID_INVALID;
+  }
+
   switch (prev_context.type_) {
     case RunContext::MESSAGE: {
       auto msg_type = static_cast<int>(prev_context.subtype_.message);
@@ -1048,9 +1107,100 @@ void Worker::onStoppedRunning(RunContext prev_context) {
 }
 
 void Worker::onStartedRunning(RunContext new_context) {
+  currently_running_log_ = LOGID_INVALID;
   setCurrentlyRunningContext(new_context, RunContext());
 }
 
+void Worker::attributeActiveCpuToLog(logid_t log_id) {
+  Worker* w = Worker::onThisThread(false /* enforce_worker */);
+  if (w != nullptr) {
+    w->currently_running_log_ = log_id;
+  }
+}
+
+Worker::CachedLogGroup& Worker::getLogGroupCacheEntry(logid_t log_id) {
+  auto it = log_group_cache_.find(log_id);
+  if (it != log_group_cache_.end()) {
+    return it->second;
+  }
+
+  CachedLogGroup entry{nullptr, ""};
+  if (!log_group_cache_config_) {
+    // Pin the current snapshot; raw pointers into its tree stay valid until
+    // onLogsConfigUpdated() drops it.
+    auto logs_config = config_->getLogsConfig();
+    if (logs_config && logs_config->isLocal()) {
+      log_group_cache_config_ =
+          checked_downcast<std::shared_ptr<configuration::LocalLogsConfig>>(
+              std::move(logs_config));
+    }
+  }
+  // Metadata logs don't live in the tree; cache the negative entry like
+  // any other miss.
+  if (log_group_cache_config_ && !MetaDataLog::isMetaDataLog(log_id)) {
+    entry.group =
+        log_group_cache_config_->getLogGroupInDirectoryByIDRaw(log_id);
+    if (entry.group != nullptr) {
+      entry.path = entry.group->getFullyQualifiedName();
+    }
+  }
+  return log_group_cache_.emplace(log_id, std::move(entry)).first->second;
+}
+
+const logsconfig::LogGroupInDirectory* FOLLY_NULLABLE
+Worker::getLogGroupByIDCached(logid_t log_id) {
+  return getLogGroupCacheEntry(log_id).group;
+}
+
+const std::string* FOLLY_NULLABLE
+Worker::getLogGroupPathCached(logid_t log_id) {
+  const CachedLogGroup& entry = getLogGroupCacheEntry(log_id);
+  return entry.group != nullptr ? &entry.path : nullptr;
+}
+
+PerLogStats* FOLLY_NULLABLE Worker::getPerLogStatsCached(logid_t log_id) {
+  CachedLogGroup& entry = getLogGroupCacheEntry(log_id);
+  if (!entry.stats && entry.group != nullptr && stats_ != nullptr) {
+    // Resolve the handle once; same upgrade-lock emplace dance as
+    // LOG_GROUP_STAT_ADD's rare path. per_log_stats entries are never
+    // erased, so the handle stays valid for the lifetime of this thread's
+    // Stats; the cached copy is dropped together with log_group_cache_ on
+    // logs config updates in case the log group was renamed.
+    auto stats_ulock = stats_->get().per_log_stats.ulock();
+    auto stats_it = stats_ulock->find(entry.path);
+    if (stats_it != stats_ulock->end()) {
+      entry.stats = stats_it->second;
+    } else {
+      auto stats_ptr = std::make_shared<PerLogStats>();
+      entry.stats = stats_ptr;
+      stats_ulock.moveFromUpgradeToWrite()->emplace(
+          entry.path, std::move(stats_ptr));
+    }
+  }
+  return entry.stats.get();
+}
+
+LogGroupAppendThrottle& Worker::logGroupAppendThrottle() {
+  if (!log_group_append_throttle_) {
+    log_group_append_throttle_ = std::make_unique<LogGroupAppendThrottle>();
+  }
+  return *log_group_append_throttle_;
+}
+
+PrincipalThrottle& Worker::principalThrottle() {
+  if (!principal_throttle_) {
+    principal_throttle_ = std::make_unique<PrincipalThrottle>();
+  }
+  return *principal_throttle_;
+}
+
+CopySetHierarchyCache& Worker::copySetHierarchyCache() {
+  if (!copyset_hierarchy_cache_) {
+    copyset_hierarchy_cache_ = std::make_unique<CopySetHierarchyCache>();
+  }
+  return *copyset_hierarchy_cache_;
+}
+
 void Worker::activateIsolationTimer() {
   isolation_timer_->activate(immutable_settings_->isolated_sequencer_ttl);
 }
@@ -1144,6 +1294,10 @@ GetTrimPointRequestMap& Worker::runningGetTrimPoint() const {
   return impl_->runningGetTrimPoint_;
 }
 
+GetTailRecordsRequestMap& Worker::runningGetTailRecords() const {
+  return impl_->runningGetTailRecords_;
+}
+
 GetRsmSnapshotRequestMap& Worker::runningGetRsmSnapshotRequests() const {
   return impl_->runningGetRsmSnapshotRequests_;
 }
@@ -1184,6 +1338,20 @@ AppendRequestMap& Worker::runningAppends() const {
   return impl_->runningAppends_;
 }
 
+std::vector<Worker::MapStats> Worker::getMapStats() const {
+  return {
+      {"running_appends",
+       impl_->runningAppends_.map.size(),
+       impl_->runningAppends_.map.bucket_count()},
+      {"get_seq_state",
+       impl_->runningGetSeqState_.size(),
+       impl_->runningGetSeqState_.bucketCount()},
+      {"log_group_cache",
+       log_group_cache_.size(),
+       log_group_cache_.bucket_count()},
+  };
+}
+
 CheckSealRequestMap& Worker::runningCheckSeals() const {
   return impl_->runningCheckSeals_;
 }
@@ -1212,6 +1380,18 @@ AppenderBuffer& Worker::appenderBuffer() const {
   return impl_->appenderBuffer_;
 }
 
+ReleaseCoalescer& Worker::releaseCoalescer() const {
+  return impl_->releaseCoalescer_;
+}
+
+AppendedCoalescer& Worker::appendedCoalescer() const {
+  return impl_->appendedCoalescer_;
+}
+
+AppendBatcher& Worker::appendBatcher() const {
+  return impl_->appendBatcher_;
+}
+
 AppenderBuffer& Worker::previouslyRedirectedAppends() const {
   return impl_->previously_redirected_appends_;
 }
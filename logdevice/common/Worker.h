@@ -84,8 +84,22 @@ struct SocketConnectRequest;
 #define LOG_STAT_DECR(stats, cluster_config, log_id, name) \
   LOG_STAT_SUB(stats, cluster_config, log_id, name, 1)
 
-#define WORKER_LOG_STAT_ADD(log_id, name, val) \
-  LOG_STAT_ADD(Worker::stats(), Worker::getConfig(false), log_id, name, val)
+// On worker threads per-log counters are bumped through a cached
+// PerLogStats handle (see Worker::getPerLogStatsCached()): the logs config
+// tree walk, the log group path hash and the per_log_stats map lock all
+// happen once per (config, log id) instead of on every bump, leaving only
+// the atomic counter increment on the hot path.
+#define WORKER_LOG_STAT_ADD(log_id, name, val)                            \
+  do {                                                                    \
+    Worker* stat_worker_ = Worker::onThisThread(false);                   \
+    if (stat_worker_) {                                                   \
+      PerLogStats* log_stats_ =                                           \
+          stat_worker_->getPerLogStatsCached(log_id);                     \
+      if (log_stats_) {                                                   \
+        log_stats_->name += (val);                                        \
+      }                                                                   \
+    }                                                                     \
+  } while (0)
 #define WORKER_LOG_STAT_SUB(log_id, name, val) \
   WORKER_LOG_STAT_ADD(log_id, name, -(val))
 #define WORKER_LOG_STAT_INCR(log_id, name) WORKER_LOG_STAT_ADD(log_id, name, 1)
@@ -111,13 +125,19 @@ namespace facebook { namespace logdevice {
  *       pass the requests to a Worker.
  */
 
+class AppendBatcher;
+class AppendedCoalescer;
 class AppenderBuffer;
+class ReleaseCoalescer;
 class BufferedWriterShard;
 class ClusterState;
 class Configuration;
 class EpochRecovery;
 class EventLogStateMachine;
 class GetSeqStateRequestMap;
+class CopySetHierarchyCache;
+class LogGroupAppendThrottle;
+class PrincipalThrottle;
 class LogStorageState;
 class LogsConfig;
 class LogsConfigManager;
@@ -164,6 +184,7 @@ struct GetEpochRecoveryMetadataRequestMap;
 struct GetHeadAttributesRequestMap;
 struct GetLogInfoRequestMaps;
 struct GetRsmSnapshotRequestMap;
+struct GetTailRecordsRequestMap;
 struct GetTrimPointRequestMap;
 struct LogIDUniqueQueue;
 struct LogRecoveryRequestMap;
@@ -171,6 +192,7 @@ struct LogsConfigApiRequestMap;
 struct LogsConfigManagerReplyMap;
 struct LogsConfigManagerRequestMap;
 struct MUTATED_Header;
+struct PerLogStats;
 struct TrimRequestMap;
 struct WriteMetaDataRecordMap;
 struct SettingOverrideTTLRequestMap {
@@ -178,12 +200,17 @@ struct SettingOverrideTTLRequestMap {
 };
 
 namespace configuration {
+class LocalLogsConfig;
 class ZookeeperConfig;
 namespace nodes {
 class NodesConfiguration;
 }
 } // namespace configuration
 
+namespace logsconfig {
+struct LogGroupInDirectory;
+} // namespace logsconfig
+
 template <typename Duration>
 class ChronoExponentialBackoffAdaptiveVariable;
 
@@ -258,9 +285,11 @@ class Worker : public WorkContext {
 
   /**
    * @return cluster configuration object cached on this Worker and
-   *         auto updated
+   *         auto updated. Returned by reference so that callers that only
+   *         inspect the snapshot don't pay any refcount traffic; the
+   *         reference stays valid until control returns to the event loop.
    */
-  std::shared_ptr<Configuration> getConfiguration() const;
+  const std::shared_ptr<Configuration>& getConfiguration() const;
 
   /**
    * @return server configuration object cached on this Worker and
@@ -269,9 +298,10 @@ class Worker : public WorkContext {
   std::shared_ptr<ServerConfig> getServerConfig() const;
 
   /**
-   * @return  NodesConfiguraton object cached on this worker.
+   * @return  NodesConfiguraton object cached on this worker. Same lifetime
+   *          rules as getConfiguration().
    */
-  std::shared_ptr<const configuration::nodes::NodesConfiguration>
+  const std::shared_ptr<const configuration::nodes::NodesConfiguration>&
   getNodesConfiguration() const;
 
   /**
@@ -421,6 +451,9 @@ class Worker : public WorkContext {
   // a map of all currently running GetTrimPointRequest
   GetTrimPointRequestMap& runningGetTrimPoint() const;
 
+  // a map of all currently running GetTailRecordsRequest
+  GetTailRecordsRequestMap& runningGetTailRecords() const;
+
   GetRsmSnapshotRequestMap& runningGetRsmSnapshotRequests() const;
 
   // a map of all currently running dataSizeRequests
@@ -454,6 +487,14 @@ class Worker : public WorkContext {
   // a map of all currently running AppendRequests
   AppendRequestMap& runningAppends() const;
 
+  // Occupancy of the hot per-Worker maps, for "info worker_maps".
+  struct MapStats {
+    const char* name;
+    size_t entries;
+    size_t buckets;
+  };
+  std::vector<MapStats> getMapStats() const;
+
   // a map of all currently running CheckSealRequest
   CheckSealRequestMap& runningCheckSeals() const;
   ShapingContainer& readShapingContainer() const;
@@ -497,6 +538,18 @@ class Worker : public WorkContext {
   // appends during recovery.
   AppenderBuffer& previouslyRedirectedAppends() const;
 
+  // Per-Worker batcher of RELEASE fan-out; used by Appenders when
+  // --release-coalescing-window is non-zero
+  ReleaseCoalescer& releaseCoalescer() const;
+
+  // Per-Worker batcher of APPENDED replies; used by Appenders when
+  // --appended-reply-coalescing-enabled is set
+  AppendedCoalescer& appendedCoalescer() const;
+
+  // Per-Worker batcher of client appends into APPEND_BATCH messages; used
+  // by AppendRequests when --append-batch-max-records is nonzero
+  AppendBatcher& appendBatcher() const;
+
   // a map of all LogRecoveryRequests currently running (active) on this Worker
   LogRecoveryRequestMap& runningLogRecoveries() const;
 
@@ -702,6 +755,75 @@ class Worker : public WorkContext {
   // Time when currentlyRunning_ was set
   std::chrono::steady_clock::time_point currentlyRunningStart_;
 
+  /**
+   * Attribute the CPU time of the currently running dispatch (request,
+   * message callback or storage task response) to the given log. When the
+   * dispatch finishes, its wall-clock time on this Worker is added to the
+   * worker_cpu_usec per-log-group stat, answering "which log group is
+   * burning this Worker". Call it from handlers that know which log they are
+   * working for; if called multiple times in one dispatch, the last call
+   * wins, so the accounting is approximate for dispatches spanning logs.
+   * No-op when not called on a worker thread.
+   */
+  static void attributeActiveCpuToLog(logid_t log_id);
+
+  /**
+   * Fast-path lookup of the log group a log id belongs to: a plain pointer
+   * into the logs config snapshot this Worker has pinned, backed by a
+   * per-Worker cache so repeated lookups for the same log don't re-walk the
+   * interval map or touch cross-thread reference counts. The pointer stays
+   * valid until this Worker processes the next logs config update, so it
+   * must not be stashed across Worker dispatches. Returns nullptr if the
+   * log is not in the config, is a metadata log, or the logs config is not
+   * local (clients fetching logs config on demand).
+   */
+  const logsconfig::LogGroupInDirectory* FOLLY_NULLABLE
+  getLogGroupByIDCached(logid_t log_id);
+
+  /**
+   * Like getLogGroupByIDCached() but returns the fully qualified path of the
+   * log group, resolved once per (config, log id) instead of being
+   * re-concatenated on every call. Same lifetime rules. Used by the per-log
+   * stats macros on the append/read hot paths.
+   */
+  const std::string* FOLLY_NULLABLE getLogGroupPathCached(logid_t log_id);
+
+  /**
+   * Per-log stats handle for log_id, resolved once per (config, log id)
+   * and cached alongside the log group lookup: the first call hashes the
+   * log group path into this thread's per_log_stats map (creating the
+   * entry if needed, like LOG_GROUP_STAT_ADD's rare path); subsequent
+   * calls return the cached pointer. Same lifetime rules as
+   * getLogGroupByIDCached(). Used by WORKER_LOG_STAT_ADD so that per-log
+   * counter bumps are a single atomic increment. Returns nullptr if the
+   * log has no group in the local config or stats are disabled.
+   */
+  PerLogStats* FOLLY_NULLABLE getPerLogStatsCached(logid_t log_id);
+
+  /**
+   * Per-Worker append throughput throttle for log groups with a
+   * "max-append-rate" extras attribute; see LogGroupAppendThrottle.h.
+   * Consulted by AppenderPrep before starting an Appender. Created lazily;
+   * invalidated together with the log group lookup cache on logs config
+   * updates.
+   */
+  LogGroupAppendThrottle& logGroupAppendThrottle();
+
+  /**
+   * Per-Worker enforcement of per-principal read/append throughput
+   * ceilings from the "principals" config section; see PrincipalThrottle.h.
+   * Consulted by AppenderPrep and CatchupQueue. Created lazily; invalidated
+   * on server config updates.
+   */
+  PrincipalThrottle& principalThrottle();
+
+  /**
+   * Per-Worker cache letting WeightedCopySetSelectors rebuilt for the same
+   * log share or incrementally re-weight their failure domain hierarchy
+   * instead of rebuilding it; see CopySetHierarchyCache.h. Created lazily.
+   */
+  CopySetHierarchyCache& copySetHierarchyCache();
+
   // This should be called whenever the ServerConfig  has been updated.
   // Has to be called from the worker thread
   virtual void onServerConfigUpdated();
@@ -789,6 +911,15 @@ class Worker : public WorkContext {
    */
   int forcePost(std::unique_ptr<Request>& req);
 
+  /**
+   * @return  number of requests currently enqueued for this worker and not
+   *          yet executed. Used for queue-depth-aware request routing, see
+   *          Processor::selectWorkerQueueAware().
+   */
+  size_t getNumRequestsEnqueued() const {
+    return num_requests_enqueued_.load(std::memory_order_relaxed);
+  }
+
   virtual void setupWorker();
   // Callback functions that register worker id and duration of slow/delayed
   // action.
@@ -828,6 +959,46 @@ class Worker : public WorkContext {
   // Helper used by onStartedRunning() and onStoppedRunning()
   void setCurrentlyRunningContext(RunContext new_context,
                                   RunContext prev_context);
+
+  // Log the currently running dispatch is working for, as reported via
+  // attributeActiveCpuToLog(). LOGID_INVALID if no log was attributed.
+  // Consumed and reset by onStoppedRunning().
+  logid_t currently_running_log_{LOGID_INVALID};
+
+  struct CachedLogGroup {
+    // nullptr for negative entries (log not in config); misses are as hot
+    // as hits when traffic keeps arriving for logs that were just removed.
+    const logsconfig::LogGroupInDirectory* group;
+    // Fully qualified log group path; empty when group is nullptr.
+    std::string path;
+    // Handle into this thread's per_log_stats map, resolved lazily by
+    // getPerLogStatsCached(); nullptr until then and for negative entries.
+    std::shared_ptr<PerLogStats> stats;
+  };
+
+  // Per-Worker log group lookup cache; see getLogGroupByIDCached(). Bounded
+  // by the number of distinct logs this Worker sees between config updates.
+  // Cleared by onLogsConfigUpdated(). Node map so that the pointers handed
+  // out by getLogGroupPathByIDCached() survive rehashing.
+  folly::F14NodeMap<logid_t, CachedLogGroup, logid_t::Hash> log_group_cache_;
+
+  // Logs config snapshot the raw pointers in log_group_cache_ point into.
+  std::shared_ptr<configuration::LocalLogsConfig> log_group_cache_config_;
+
+  // See logGroupAppendThrottle(). unique_ptr so that Worker.h doesn't need
+  // to include the header.
+  std::unique_ptr<LogGroupAppendThrottle> log_group_append_throttle_;
+
+  // See principalThrottle(). Same lifetime rules as
+  // log_group_append_throttle_.
+  std::unique_ptr<PrincipalThrottle> principal_throttle_;
+
+  // See copySetHierarchyCache(). Same lifetime rules as
+  // log_group_append_throttle_.
+  std::unique_ptr<CopySetHierarchyCache> copyset_hierarchy_cache_;
+
+  // Looks up log_id in log_group_cache_, populating the entry on miss.
+  CachedLogGroup& getLogGroupCacheEntry(logid_t log_id);
   // Helper used to generate error injection if the conditions are correct. Used
   // to test HealthMonitor functionalities.
   void generateErrorInjection(double error_chance,
@@ -843,6 +1014,17 @@ class Worker : public WorkContext {
   std::shared_ptr<UpdateableConfig> config_; // cluster config to use for
   // all ops on this thread
 
+  // Per-Worker snapshot of the cluster Configuration, assembled lazily by
+  // getConfiguration() and dropped by the config update callbacks. Without
+  // it every getConfiguration() call allocates a fresh Configuration and
+  // bumps refcounts on cachelines shared by all Workers.
+  mutable std::shared_ptr<Configuration> cached_config_;
+
+  // Same idea for the NodesConfiguration snapshot; dropped by
+  // onNodesConfigurationUpdated() and onServerConfigUpdated().
+  mutable std::shared_ptr<const configuration::nodes::NodesConfiguration>
+      cached_nodes_configuration_;
+
   // Handles for our subscriptions to config updates, used in destructor to
   // unsubscribe
   ConfigSubscriptionHandle server_config_update_sub_;
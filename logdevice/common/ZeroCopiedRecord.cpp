@@ -35,7 +35,22 @@ ZeroCopiedRecord::ZeroCopiedRecord(lsn_t lsn,
       copyset(copyset),
       offsets_within_epoch(std::move(offsets_within_epoch)),
       keys(std::move(keys)),
-      payload(payload_holder) {}
+      payload(payload_holder) {
+  materializeSmallPayload();
+}
+
+void ZeroCopiedRecord::materializeSmallPayload() {
+  const size_t size = payload.size();
+  if (size == 0 || size > kSmallPayloadThreshold) {
+    return;
+  }
+  const folly::IOBuf& buf = payload.iobuf();
+  if (!buf.isShared() && buf.capacity() <= 2 * size) {
+    // Already a tight private buffer; nothing to gain from copying.
+    return;
+  }
+  payload = PayloadHolder::copyPayload(payload.getPayload());
+}
 
 /*static*/
 size_t ZeroCopiedRecord::getBytesEstimate(Payload payload_raw) {
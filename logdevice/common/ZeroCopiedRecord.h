@@ -61,6 +61,13 @@ class ZeroCopiedRecord {
    */
   static size_t getBytesEstimate(Payload payload_raw);
 
+  /**
+   * Payloads of at most this many bytes that still share a larger buffer
+   * (typically the message receive buffer) are copied into a tight private
+   * buffer on construction; see materializeSmallPayload().
+   */
+  static constexpr size_t kSmallPayloadThreshold = 128;
+
   ZeroCopiedRecord(const ZeroCopiedRecord&) = delete;
   ZeroCopiedRecord& operator=(const ZeroCopiedRecord&) = delete;
 
@@ -74,5 +81,21 @@ class ZeroCopiedRecord {
                    OffsetMap offsets_within_epoch,
                    std::map<KeyType, std::string>&& keys,
                    const PayloadHolder& payload_holder);
+
+ protected:
+  /**
+   * Called on construction. If the payload is small but its IOBuf pins a
+   * shared or much larger buffer, replaces it with a tight private copy so
+   * that cached records neither hold message receive buffers alive nor
+   * chase into them, and the payload bytes sit in a right-sized
+   * allocation.
+   *
+   * The copy stays a managed (refcounted) IOBuf rather than bytes inlined
+   * in the record object itself: payload holders are cloned into socket
+   * send chains on zero-copy serialization (PayloadHolder::serialize())
+   * and can outlive the record, so the record's own storage must not back
+   * them.
+   */
+  void materializeSmallPayload();
 };
 }} // namespace facebook::logdevice
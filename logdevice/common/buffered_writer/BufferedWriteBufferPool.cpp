@@ -0,0 +1,74 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/buffered_writer/BufferedWriteBufferPool.h"
+
+#include <mutex>
+#include <vector>
+
+namespace facebook { namespace logdevice {
+
+namespace {
+
+// Buffers smaller than this are cheap to allocate and not worth pooling.
+constexpr size_t kMinPooledCapacity = 1 << 14; // 16KiB
+
+// Never hand out a pooled buffer more than this many times bigger than the
+// requested capacity; a tiny batch should not pin a huge buffer.
+constexpr size_t kMaxOversizeFactor = 4;
+
+// Upper bound on pooled buffers, to cap the memory the pool can hold onto.
+// Two buffers per concurrently constructed batch (staging + compression
+// output) is plenty for steady state.
+constexpr size_t kMaxPooledBuffers = 8;
+
+struct Pool {
+  std::mutex mutex;
+  std::vector<std::unique_ptr<folly::IOBuf>> buffers;
+};
+
+Pool& pool() {
+  static Pool p;
+  return p;
+}
+
+} // namespace
+
+folly::IOBuf BufferedWriteBufferPool::allocate(size_t capacity) {
+  if (capacity >= kMinPooledCapacity) {
+    Pool& p = pool();
+    std::lock_guard<std::mutex> guard(p.mutex);
+    for (auto it = p.buffers.begin(); it != p.buffers.end(); ++it) {
+      const size_t pooled_capacity = (*it)->capacity();
+      if (pooled_capacity >= capacity &&
+          pooled_capacity / kMaxOversizeFactor <= capacity) {
+        folly::IOBuf buf = std::move(**it);
+        p.buffers.erase(it);
+        return buf;
+      }
+    }
+  }
+  return folly::IOBuf(folly::IOBuf::CREATE, capacity);
+}
+
+bool BufferedWriteBufferPool::recycle(folly::IOBuf&& buf) {
+  if (buf.isChained() || !buf.isManaged() || buf.isSharedOne() ||
+      buf.capacity() < kMinPooledCapacity) {
+    return false;
+  }
+  // Rewind any headroom and data so the next user sees a fresh buffer.
+  buf.clear();
+  Pool& p = pool();
+  std::lock_guard<std::mutex> guard(p.mutex);
+  if (p.buffers.size() >= kMaxPooledBuffers) {
+    return false;
+  }
+  p.buffers.push_back(std::make_unique<folly::IOBuf>(std::move(buf)));
+  return true;
+}
+
+}} // namespace facebook::logdevice
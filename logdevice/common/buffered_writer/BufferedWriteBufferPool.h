@@ -0,0 +1,47 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <cstddef>
+
+#include <folly/io/IOBuf.h>
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Process-wide pool of large buffers used by BufferedWriter to stage
+ * batch blobs.  Every batch allocates at least one blob-sized buffer (and
+ * a second one when compressing), and on write-heavy clients these
+ * short-lived multi-megabyte allocations are a top malloc site.  The pool
+ * keeps a handful of retired buffers around so that steady-state batch
+ * construction reuses them instead of going to the allocator.
+ *
+ * Thread safe; buffers are allocated on Workers and background threads and
+ * recycled on Workers.
+ */
+
+class BufferedWriteBufferPool {
+ public:
+  /**
+   * Returns an unshared buffer with at least `capacity' bytes of tailroom,
+   * reusing a pooled buffer when one of a suitable size is available.
+   */
+  static folly::IOBuf allocate(size_t capacity);
+
+  /**
+   * Offers a no longer needed buffer back to the pool.  The buffer is only
+   * kept if it is unchained, owns its memory, is not shared with anyone
+   * else, is large enough to be worth pooling and the pool is not full;
+   * otherwise it is freed as usual.
+   *
+   * @return true if the buffer was taken by the pool.
+   */
+  static bool recycle(folly::IOBuf&& buf);
+};
+
+}} // namespace facebook::logdevice
@@ -16,6 +16,7 @@
 #include <folly/io/Cursor.h>
 
 #include "logdevice/common/Checksum.h"
+#include "logdevice/common/buffered_writer/BufferedWriteBufferPool.h"
 #include "logdevice/common/buffered_writer/BufferedWriteDecoderImpl.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/include/types.h"
@@ -24,7 +25,7 @@ namespace facebook { namespace logdevice {
 
 BufferedWriteSinglePayloadsCodec::Encoder::Encoder(size_t capacity,
                                                    size_t headroom)
-    : blob_(folly::IOBuf::CREATE, headroom + capacity),
+    : blob_(BufferedWriteBufferPool::allocate(headroom + capacity)),
       appender_(&blob_, /* growth */ 0) {
   blob_.advance(headroom);
 }
@@ -44,10 +45,12 @@ void BufferedWriteSinglePayloadsCodec::Encoder::append(
   }
 }
 
-void BufferedWriteSinglePayloadsCodec::Encoder::encode(folly::IOBufQueue& out,
-                                                       Compression& compression,
-                                                       int zstd_level) {
-  bool compressed = compress(compression, zstd_level);
+void BufferedWriteSinglePayloadsCodec::Encoder::encode(
+    folly::IOBufQueue& out,
+    Compression& compression,
+    int zstd_level,
+    const std::string* zstd_dictionary) {
+  bool compressed = compress(compression, zstd_level, zstd_dictionary);
   if (!compressed) {
     compression = Compression::NONE;
   }
@@ -56,7 +59,8 @@ void BufferedWriteSinglePayloadsCodec::Encoder::encode(folly::IOBufQueue& out,
 
 bool BufferedWriteSinglePayloadsCodec::Encoder::compress(
     Compression compression,
-    int zstd_level) {
+    int zstd_level,
+    const std::string* zstd_dictionary) {
   if (compression == Compression::NONE) {
     // Nothing to do.
     return true;
@@ -76,7 +80,8 @@ bool BufferedWriteSinglePayloadsCodec::Encoder::compress(
       folly::kMaxVarintLength64 +                       // uncompressed length
       compressed_data_bound                             // compressed bytes
       ;
-  folly::IOBuf compress_buf(folly::IOBuf::CREATE, compressed_buf_size);
+  folly::IOBuf compress_buf = BufferedWriteBufferPool::allocate(
+      compressed_buf_size);
   compress_buf.advance(blob_.headroom());
   uint8_t* out = compress_buf.writableTail();
   uint8_t* const end = out + compressed_buf_size - blob_.headroom();
@@ -88,11 +93,26 @@ bool BufferedWriteSinglePayloadsCodec::Encoder::compress(
   size_t compressed_size;
   if (compression == Compression::ZSTD) {
     ld_check(zstd_level > 0);
-    compressed_size = ZSTD_compress(out,              // dst
-                                    end - out,        // dstCapacity
-                                    to_compress.data, // src
-                                    to_compress.size, // srcSize
-                                    zstd_level);      // level
+    if (zstd_dictionary != nullptr) {
+      ZSTD_CCtx* cctx = ZSTD_createCCtx();
+      ld_check(cctx != nullptr);
+      compressed_size =
+          ZSTD_compress_usingDict(cctx,                     // context
+                                  out,                      // dst
+                                  end - out,                // dstCapacity
+                                  to_compress.data,         // src
+                                  to_compress.size,         // srcSize
+                                  zstd_dictionary->data(),  // dict
+                                  zstd_dictionary->size(),  // dictSize
+                                  zstd_level);              // level
+      ZSTD_freeCCtx(cctx);
+    } else {
+      compressed_size = ZSTD_compress(out,              // dst
+                                      end - out,        // dstCapacity
+                                      to_compress.data, // src
+                                      to_compress.size, // srcSize
+                                      zstd_level);      // level
+    }
     if (ZSTD_isError(compressed_size)) {
       ld_critical(
           "ZSTD_compress() failed: %s", ZSTD_getErrorName(compressed_size));
@@ -125,18 +145,22 @@ bool BufferedWriteSinglePayloadsCodec::Encoder::compress(
   ld_spew(
       "original size is %zu, compressed %zu", blob_.length(), compressed_len);
   if (compressed_len < blob_.length()) {
-    // Compression was a win.  Replace the uncompressed blob.
+    // Compression was a win.  Replace the uncompressed blob, letting the
+    // staging buffer go back to the pool; it never escaped this encoder.
     compress_buf.append(compressed_len);
+    BufferedWriteBufferPool::recycle(std::move(blob_));
     blob_ = std::move(compress_buf);
     return true;
   } else {
+    BufferedWriteBufferPool::recycle(std::move(compress_buf));
     return false;
   }
 }
 
 namespace {
 folly::Optional<folly::IOBuf> uncompress(const Slice& slice,
-                                         const Compression compression) {
+                                         const Compression compression,
+                                         const std::string* zstd_dictionary) {
   if (compression == Compression::NONE) {
     return folly::IOBuf::wrapBufferAsValue(slice.data, slice.size);
   }
@@ -172,10 +196,25 @@ folly::Optional<folly::IOBuf> uncompress(const Slice& slice,
       ld_check(false);
       return folly::none;
     case Compression::ZSTD: {
-      size_t rv = ZSTD_decompress(out.writableTail(), // dst
-                                  uncompressed_size,  // dstCapacity
-                                  ptr,                // src
-                                  end - ptr);         // compressedSize
+      size_t rv;
+      if (zstd_dictionary != nullptr) {
+        ZSTD_DCtx* dctx = ZSTD_createDCtx();
+        ld_check(dctx != nullptr);
+        rv = ZSTD_decompress_usingDict(dctx,                    // context
+                                       out.writableTail(),      // dst
+                                       uncompressed_size,       // dstCapacity
+                                       ptr,                     // src
+                                       end - ptr,               // srcSize
+                                       zstd_dictionary->data(), // dict
+                                       zstd_dictionary->size()  // dictSize
+        );
+        ZSTD_freeDCtx(dctx);
+      } else {
+        rv = ZSTD_decompress(out.writableTail(), // dst
+                             uncompressed_size,  // dstCapacity
+                             ptr,                // src
+                             end - ptr);         // compressedSize
+      }
       if (ZSTD_isError(rv)) {
         RATELIMIT_ERROR(std::chrono::seconds(1),
                         1,
@@ -246,14 +285,57 @@ decodeVarint(folly::io::Cursor& cursor) {
   return result;
 }
 
+// Scans all payload length varints in the contiguous range [begin, end) in
+// one pass, recording the (offset, length) of every payload. The one- and
+// two-byte varint cases (payloads up to 16KiB) are decoded inline so the
+// hot loop is a couple of compares per record instead of a folly::io::Cursor
+// round trip; longer varints fall back to folly::tryDecodeVarint.
+// @return false if the range is malformed.
+bool scanPayloadOffsets(const uint8_t* begin,
+                        const uint8_t* end,
+                        std::vector<std::pair<size_t, uint64_t>>& offsets_out) {
+  const uint8_t* p = begin;
+  while (p != end) {
+    uint64_t len;
+    if (LIKELY(*p < 0x80)) {
+      len = *p++;
+    } else if (end - p >= 2 && LIKELY(p[1] < 0x80)) {
+      len = (uint64_t(p[0]) & 0x7f) | (uint64_t(p[1]) << 7);
+      p += 2;
+    } else {
+      folly::ByteRange range(p, end);
+      auto result = folly::tryDecodeVarint(range);
+      if (!result) {
+        RATELIMIT_ERROR(std::chrono::seconds(1), 1, "Failed to decode varint");
+        return false;
+      }
+      len = *result;
+      p = range.begin();
+    }
+    if (len > static_cast<uint64_t>(end - p)) {
+      RATELIMIT_ERROR(std::chrono::seconds(1),
+                      1,
+                      "Expected %lu more bytes based on length varint but "
+                      "there are only %zu left",
+                      len,
+                      static_cast<size_t>(end - p));
+      return false;
+    }
+    offsets_out.emplace_back(p - begin, len);
+    p += len;
+  }
+  return true;
+}
+
 } // namespace
 
 size_t BufferedWriteSinglePayloadsCodec::decode(
     const Slice& binary,
     Compression compression,
     std::vector<folly::IOBuf>& payloads_out,
-    bool allow_buffer_sharing) {
-  auto uncompressed = uncompress(binary, compression);
+    bool allow_buffer_sharing,
+    const std::string* zstd_dictionary) {
+  auto uncompressed = uncompress(binary, compression, zstd_dictionary);
   if (!uncompressed) {
     return 0;
   }
@@ -264,33 +346,38 @@ size_t BufferedWriteSinglePayloadsCodec::decode(
     uncompressed->makeManaged();
   }
 
+  // The payload section is a single contiguous buffer, so rather than
+  // walking it with a folly::io::Cursor per record, scan all length varints
+  // up front into an offset table and then materialize the payloads as
+  // shared slices. Readers decode batches with very large record counts,
+  // where the per-record cursor bookkeeping dominated the decode cost; the
+  // offset table also lets us size the output vector exactly before
+  // touching it.
+  if (uncompressed->isChained()) {
+    // uncompress() always produces a single buffer; this is just belt and
+    // suspenders in case that ever changes.
+    uncompressed->coalesce();
+  }
+  const uint8_t* data = uncompressed->data();
+  std::vector<std::pair<size_t, uint64_t>> offsets;
+  offsets.reserve(payloads_out.capacity() - payloads_out.size());
+  if (!scanPayloadOffsets(data, data + uncompressed->length(), offsets)) {
+    return 0;
+  }
+
   std::vector<folly::IOBuf> payloads;
-  payloads.reserve(payloads_out.capacity() - payloads_out.size());
-  folly::io::Cursor cursor{uncompressed.get_pointer()};
-  while (!cursor.isAtEnd()) {
-    auto len = decodeVarint(cursor);
-    if (!len) {
-      RATELIMIT_ERROR(std::chrono::seconds(1), 1, "Failed to decode varint");
-      return 0;
-    }
-    folly::IOBuf payload;
-    size_t available = cursor.cloneAtMost(payload, *len);
-    if (available != *len) {
-      RATELIMIT_ERROR(std::chrono::seconds(1),
-                      1,
-                      "Expected %lu more bytes based on length varint but "
-                      "there are only %zu left",
-                      *len,
-                      available);
-      return 0;
-    }
+  payloads.reserve(offsets.size());
+  for (const auto& [offset, len] : offsets) {
+    folly::IOBuf payload = uncompressed->cloneOneAsValue();
+    payload.trimStart(offset);
+    payload.trimEnd(payload.length() - len);
     payloads.push_back(std::move(payload));
   }
 
   payloads_out.insert(payloads_out.end(),
                       std::make_move_iterator(payloads.begin()),
                       std::make_move_iterator(payloads.end()));
-  return cursor.getCurrentPosition();
+  return uncompressed->length();
 }
 
 void BufferedWriteSinglePayloadsCodec::Estimator::append(
@@ -305,7 +392,9 @@ size_t BufferedWriteSinglePayloadsCodec::Estimator::calculateSize() const {
 
 namespace {
 
-size_t calculateHeaderSize(int checksum_bits, size_t appends_count) {
+size_t calculateHeaderSize(int checksum_bits,
+                           size_t appends_count,
+                           uint32_t dictionary_id = 0) {
   size_t header_size =
       // Any bytes for the checksum.  This goes first since it gets stripped
       // first on the read path.
@@ -314,19 +403,35 @@ size_t calculateHeaderSize(int checksum_bits, size_t appends_count) {
       2 +
       // The batch size.
       folly::encodeVarintSize(appends_count);
+  if (dictionary_id != 0) {
+    // The id of the zstd dictionary the batch is compressed with.
+    header_size += folly::encodeVarintSize(dictionary_id);
+  }
   return header_size;
 }
 
 } // namespace
 
+template <typename PayloadsEncoder>
+BufferedWriteCodec::Encoder<PayloadsEncoder>::Encoder(int checksum_bits,
+                                                      size_t appends_count,
+                                                      size_t capacity)
+    : Encoder(checksum_bits, appends_count, capacity, nullptr) {}
+
 template <>
 BufferedWriteCodec::Encoder<BufferedWriteSinglePayloadsCodec::Encoder>::Encoder(
     int checksum_bits,
     size_t appends_count,
-    size_t capacity)
+    size_t capacity,
+    std::shared_ptr<const BufferedWriteDictionaryRegistry::Dictionary>
+        zstd_dictionary)
     : checksum_bits_(checksum_bits),
       appends_count_(appends_count),
-      header_size_(calculateHeaderSize(checksum_bits_, appends_count_)),
+      zstd_dictionary_(std::move(zstd_dictionary)),
+      header_size_(
+          calculateHeaderSize(checksum_bits_,
+                              appends_count_,
+                              zstd_dictionary_ ? zstd_dictionary_->id : 0)),
       payloads_encoder_(capacity - header_size_, header_size_) {}
 
 template <>
@@ -334,11 +439,16 @@ BufferedWriteCodec::Encoder<PayloadGroupCodec::Encoder>::Encoder(
     int checksum_bits,
     size_t appends_count,
     // not used by PayloadGroupCodec::Encoder
-    size_t /* capacity */)
+    size_t /* capacity */,
+    std::shared_ptr<const BufferedWriteDictionaryRegistry::Dictionary>
+        zstd_dictionary)
     : checksum_bits_(checksum_bits),
       appends_count_(appends_count),
       header_size_(calculateHeaderSize(checksum_bits_, appends_count_)),
-      payloads_encoder_(appends_count_) {}
+      payloads_encoder_(appends_count_) {
+  // Dictionary compression is only supported for SINGLE_PAYLOADS batches.
+  ld_check(zstd_dictionary == nullptr);
+}
 
 template <typename PayloadsEncoder>
 void BufferedWriteCodec::Encoder<PayloadsEncoder>::append(
@@ -375,7 +485,16 @@ void BufferedWriteCodec::Encoder<PayloadsEncoder>::encode(
     queue.append(std::move(iobuf));
   }
 
-  payloads_encoder_.encode(queue, compression, zstd_level);
+  if constexpr (std::is_same_v<PayloadsEncoder,
+                               BufferedWriteSinglePayloadsCodec::Encoder>) {
+    payloads_encoder_.encode(
+        queue,
+        compression,
+        zstd_level,
+        zstd_dictionary_ ? &zstd_dictionary_->data : nullptr);
+  } else {
+    payloads_encoder_.encode(queue, compression, zstd_level);
+  }
 
   auto blob = queue.move();
   if constexpr (std::is_same_v<PayloadsEncoder, PayloadGroupCodec::Encoder>) {
@@ -414,47 +533,203 @@ BufferedWriteCodec::Format getFormat<PayloadGroupCodec::Encoder>() {
 
 } // namespace
 
+namespace {
 // Format of the header:
 // * 0-8 bytes reserved for checksum -- this is not really part of the
 //   BufferedWriter format, see BufferedWriterImpl::prependChecksums()
 // * 1 magic marker byte
 // * 1 flags byte
 // * 0-9 bytes varint batch size
-template <typename PayloadsEncoder>
-void BufferedWriteCodec::Encoder<PayloadsEncoder>::encodeHeader(
-    folly::IOBuf& blob,
-    Compression compression) {
+// * 0-5 bytes varint zstd dictionary id (only if the DICTIONARY flag is set)
+void encodeHeaderImpl(folly::IOBuf& blob,
+                      int checksum_bits,
+                      size_t appends_count,
+                      BufferedWriteCodec::Format format,
+                      Compression compression,
+                      uint32_t dictionary_id) {
   using batch_flags_t = BufferedWriteDecoderImpl::flags_t;
 
-  const batch_flags_t flags = BufferedWriteDecoderImpl::Flags::SIZE_INCLUDED |
+  batch_flags_t flags = BufferedWriteDecoderImpl::Flags::SIZE_INCLUDED |
       static_cast<batch_flags_t>(compression);
+  if (dictionary_id != 0) {
+    flags |= BufferedWriteDecoderImpl::Flags::DICTIONARY;
+  }
+
+  const size_t header_size =
+      calculateHeaderSize(checksum_bits, appends_count, dictionary_id);
 
   uint8_t* out = blob.writableData();
   // Skip checksum
-  out += checksum_bits_ / 8;
+  out += checksum_bits / 8;
   // Magic marker & flags
-  *out++ = static_cast<uint8_t>(getFormat<PayloadsEncoder>());
+  *out++ = static_cast<uint8_t>(format);
   *out++ = flags;
 
-  size_t len = folly::encodeVarint(appends_count_, out);
+  size_t len = folly::encodeVarint(appends_count, out);
   out += len;
-  ld_check(blob.writableData() + header_size_ == out);
+  if (dictionary_id != 0) {
+    // The id is written even if compression fell back to NONE: the header
+    // size was fixed when the encoder was created.  The read side only
+    // consults the dictionary when the compression bits say ZSTD.
+    out += folly::encodeVarint(dictionary_id, out);
+  }
+  ld_check(blob.writableData() + header_size == out);
 
-  if (checksum_bits_ > 0) {
+  if (checksum_bits > 0) {
     // Update checksum
-    size_t nbytes = checksum_bits_ / 8;
+    size_t nbytes = checksum_bits / 8;
     Slice checksummed(blob.writableData() + nbytes, blob.length() - nbytes);
     checksum_bytes(checksummed,
-                   checksum_bits_,
+                   checksum_bits,
                    reinterpret_cast<char*>(blob.writableData()));
   }
 }
+} // namespace
+
+template <typename PayloadsEncoder>
+void BufferedWriteCodec::Encoder<PayloadsEncoder>::encodeHeader(
+    folly::IOBuf& blob,
+    Compression compression) {
+  encodeHeaderImpl(blob,
+                   checksum_bits_,
+                   appends_count_,
+                   getFormat<PayloadsEncoder>(),
+                   compression,
+                   zstd_dictionary_ ? zstd_dictionary_->id : 0);
+}
 
 // Instantiate Encoder with all supported variants of payload encoders
 template class BufferedWriteCodec::Encoder<
     BufferedWriteSinglePayloadsCodec::Encoder>;
 template class BufferedWriteCodec::Encoder<PayloadGroupCodec::Encoder>;
 
+struct BufferedWriteCodec::StreamingEncoder::Stream {
+  Stream(int zstd_level, const std::string* zstd_dictionary)
+      : cstream(ZSTD_createCStream()) {
+    ld_check(cstream != nullptr);
+    const size_t rv = zstd_dictionary != nullptr
+        ? ZSTD_initCStream_usingDict(cstream,
+                                     zstd_dictionary->data(),
+                                     zstd_dictionary->size(),
+                                     zstd_level)
+        : ZSTD_initCStream(cstream, zstd_level);
+    ld_check(!ZSTD_isError(rv));
+  }
+  ~Stream() {
+    ZSTD_freeCStream(cstream);
+  }
+  ZSTD_CStream* const cstream;
+};
+
+BufferedWriteCodec::StreamingEncoder::StreamingEncoder(
+    int checksum_bits,
+    int zstd_level,
+    std::shared_ptr<const BufferedWriteDictionaryRegistry::Dictionary>
+        zstd_dictionary)
+    : checksum_bits_(checksum_bits),
+      zstd_dictionary_(std::move(zstd_dictionary)),
+      stream_(std::make_unique<Stream>(
+          zstd_level,
+          zstd_dictionary_ ? &zstd_dictionary_->data : nullptr)) {
+  ld_check(zstd_level > 0);
+}
+
+BufferedWriteCodec::StreamingEncoder::~StreamingEncoder() = default;
+
+void BufferedWriteCodec::StreamingEncoder::compressChunk(const void* data,
+                                                         size_t size) {
+  ZSTD_inBuffer in = {data, size, 0};
+  while (in.pos < in.size) {
+    auto space = compressed_.preallocate(4096, 65536);
+    ZSTD_outBuffer out = {space.first, space.second, 0};
+    const size_t rv = ZSTD_compressStream(stream_->cstream, &out, &in);
+    if (ZSTD_isError(rv)) {
+      ld_critical("ZSTD_compressStream() failed: %s", ZSTD_getErrorName(rv));
+      ld_check(false);
+      return;
+    }
+    compressed_.postallocate(out.pos);
+  }
+}
+
+void BufferedWriteCodec::StreamingEncoder::append(
+    const folly::IOBuf& payload) {
+  // Same wire format as BufferedWriteSinglePayloadsCodec::Encoder::append():
+  // varint payload length followed by payload bytes.
+  const size_t payload_len = payload.computeChainDataLength();
+  uint8_t varint_buf[folly::kMaxVarintLength64];
+  const size_t varint_len = folly::encodeVarint(payload_len, varint_buf);
+  compressChunk(varint_buf, varint_len);
+  for (const auto& bytes : payload) {
+    if (!bytes.empty()) {
+      compressChunk(bytes.data(), bytes.size());
+    }
+  }
+  uncompressed_bytes_ += varint_len + payload_len;
+  ++appends_count_;
+}
+
+void BufferedWriteCodec::StreamingEncoder::encode(folly::IOBufQueue& out,
+                                                  Compression& compression) {
+  ld_check(compression == Compression::ZSTD);
+
+  // Write the frame epilogue.
+  for (;;) {
+    auto space = compressed_.preallocate(1024, 65536);
+    ZSTD_outBuffer zstd_out = {space.first, space.second, 0};
+    const size_t remaining = ZSTD_endStream(stream_->cstream, &zstd_out);
+    if (ZSTD_isError(remaining)) {
+      ld_critical("ZSTD_endStream() failed: %s", ZSTD_getErrorName(remaining));
+      ld_check(false);
+      compression = Compression::NONE;
+      return;
+    }
+    compressed_.postallocate(zstd_out.pos);
+    if (remaining == 0) {
+      break;
+    }
+  }
+
+  const size_t compressed_size = compressed_.chainLength();
+  const size_t size_varint_len = folly::encodeVarintSize(uncompressed_bytes_);
+  ld_spew("original size is %zu, compressed %zu",
+          uncompressed_bytes_,
+          size_varint_len + compressed_size);
+  if (size_varint_len + compressed_size >= uncompressed_bytes_) {
+    // Compression was not a win; signal the caller to store the batch
+    // uncompressed, matching the behavior of the non-streaming encoder.
+    compression = Compression::NONE;
+    return;
+  }
+
+  const uint32_t dictionary_id = zstd_dictionary_ ? zstd_dictionary_->id : 0;
+  const size_t header_size =
+      calculateHeaderSize(checksum_bits_, appends_count_, dictionary_id);
+  auto blob = folly::IOBuf::create(
+      header_size + size_varint_len + compressed_size);
+  blob->advance(header_size);
+  uint8_t* tail = blob->writableTail();
+  // Append uncompressed size so that the decoding path knows how much memory
+  // to allocate
+  tail += folly::encodeVarint(uncompressed_bytes_, tail);
+  // The compressed frame is small by now; stitching it into the contiguous
+  // blob costs one memcpy of the compressed bytes, not a pass over the
+  // uncompressed batch.
+  for (auto range : *compressed_.front()) {
+    memcpy(tail, range.data(), range.size());
+    tail += range.size();
+  }
+  blob->append(size_varint_len + compressed_size);
+  blob->prepend(header_size);
+  encodeHeaderImpl(*blob,
+                   checksum_bits_,
+                   appends_count_,
+                   Format::SINGLE_PAYLOADS,
+                   Compression::ZSTD,
+                   dictionary_id);
+  out.append(std::move(blob));
+}
+
 void BufferedWriteCodec::Estimator::append(const folly::IOBuf& payload) {
   // For single payloads format we should update payload groups format too
   // in case payload group is appended. However once format is switched to
@@ -478,8 +753,11 @@ void BufferedWriteCodec::Estimator::append(const PayloadGroup& payload_group) {
   appends_count_++;
 }
 
-size_t BufferedWriteCodec::Estimator::calculateSize(int checksum_bits) const {
-  size_t size = calculateHeaderSize(checksum_bits, appends_count_);
+size_t
+BufferedWriteCodec::Estimator::calculateSize(int checksum_bits,
+                                             uint32_t zstd_dictionary_id) const {
+  size_t size =
+      calculateHeaderSize(checksum_bits, appends_count_, zstd_dictionary_id);
   switch (format_) {
     case Format::SINGLE_PAYLOADS:
       size += single_payloads_estimator_.calculateSize();
@@ -497,7 +775,8 @@ namespace {
 size_t decodeHeader(folly::IOBuf& blob,
                     BufferedWriteDecoderImpl::flags_t* flags_out,
                     BufferedWriteCodec::Format* format_out,
-                    size_t* size_out) {
+                    size_t* size_out,
+                    uint32_t* dictionary_id_out) {
   folly::io::Cursor cursor{&blob};
   if (cursor.isAtEnd()) {
     RATELIMIT_ERROR(
@@ -541,6 +820,22 @@ size_t decodeHeader(folly::IOBuf& blob,
     batch_size = 1;
   }
 
+  uint32_t dictionary_id = 0;
+  if (flags & BufferedWriteDecoderImpl::Flags::DICTIONARY) {
+    if (cursor.isAtEnd()) {
+      RATELIMIT_ERROR(std::chrono::seconds(1),
+                      1,
+                      "Reached end looking for the dictionary id");
+      return 0;
+    }
+    auto decoded_dictionary_id = decodeVarint(cursor);
+    if (!decoded_dictionary_id) {
+      RATELIMIT_ERROR(std::chrono::seconds(1), 1, "Failed to decode varint");
+      return 0;
+    }
+    dictionary_id = *decoded_dictionary_id;
+  }
+
   const size_t header_size = cursor.getCurrentPosition();
   blob.trimStart(header_size);
 
@@ -553,32 +848,63 @@ size_t decodeHeader(folly::IOBuf& blob,
   if (size_out != nullptr) {
     *size_out = batch_size;
   }
+  if (dictionary_id_out != nullptr) {
+    *dictionary_id_out = dictionary_id;
+  }
   return header_size;
 }
 
 size_t decodeHeader(Slice& blob,
                     BufferedWriteDecoderImpl::flags_t* flags_out,
                     BufferedWriteCodec::Format* format_out,
-                    size_t* size_out) {
+                    size_t* size_out,
+                    uint32_t* dictionary_id_out) {
   auto iobuf = folly::IOBuf::wrapBufferAsValue(blob.data, blob.size);
-  size_t header_size = decodeHeader(iobuf, flags_out, format_out, size_out);
+  size_t header_size =
+      decodeHeader(iobuf, flags_out, format_out, size_out, dictionary_id_out);
   blob = Slice(reinterpret_cast<const uint8_t*>(blob.data) + header_size,
                blob.size - header_size);
   return header_size;
 }
 
+// Resolves the dictionary a batch was compressed with, if any.  Returns
+// false if the batch needs a dictionary that is not registered in this
+// process.
+bool resolveDictionary(
+    uint32_t dictionary_id,
+    Compression compression,
+    std::shared_ptr<const BufferedWriteDictionaryRegistry::Dictionary>&
+        dictionary_out) {
+  if (dictionary_id == 0 || compression != Compression::ZSTD) {
+    // Either no dictionary was in use, or compression fell back to NONE at
+    // encoding time, leaving the id in the header unused.
+    return true;
+  }
+  dictionary_out = BufferedWriteDictionaryRegistry::lookup(dictionary_id);
+  if (dictionary_out == nullptr) {
+    RATELIMIT_ERROR(std::chrono::seconds(1),
+                    1,
+                    "Batch is compressed with zstd dictionary %u, which is "
+                    "not registered in this process",
+                    dictionary_id);
+    return false;
+  }
+  return true;
+}
+
 } // namespace
 
 FOLLY_NODISCARD
 bool BufferedWriteCodec::decodeBatchSize(Slice binary, size_t* size_out) {
-  return decodeHeader(binary, nullptr, nullptr, size_out) != 0;
+  return decodeHeader(binary, nullptr, nullptr, size_out, nullptr) != 0;
 }
 
 FOLLY_NODISCARD
 bool BufferedWriteCodec::decodeCompression(Slice binary,
                                            Compression* compression_out) {
   BufferedWriteDecoderImpl::flags_t flags;
-  const size_t header_size = decodeHeader(binary, &flags, nullptr, nullptr);
+  const size_t header_size =
+      decodeHeader(binary, &flags, nullptr, nullptr, nullptr);
   if (header_size == 0) {
     return false;
   }
@@ -591,7 +917,7 @@ bool BufferedWriteCodec::decodeCompression(Slice binary,
 
 FOLLY_NODISCARD
 bool BufferedWriteCodec::decodeFormat(Slice binary, Format* format_out) {
-  return decodeHeader(binary, nullptr, format_out, nullptr) != 0;
+  return decodeHeader(binary, nullptr, format_out, nullptr, nullptr) != 0;
 }
 
 FOLLY_NODISCARD
@@ -601,7 +927,9 @@ size_t BufferedWriteCodec::decode(Slice binary,
   BufferedWriteDecoderImpl::flags_t flags;
   Format format;
   size_t batch_size;
-  const size_t header_size = decodeHeader(binary, &flags, &format, &batch_size);
+  uint32_t dictionary_id;
+  const size_t header_size =
+      decodeHeader(binary, &flags, &format, &batch_size, &dictionary_id);
   if (header_size == 0) {
     return 0;
   }
@@ -611,10 +939,19 @@ size_t BufferedWriteCodec::decode(Slice binary,
   }
   const Compression compression = static_cast<Compression>(
       flags & BufferedWriteDecoderImpl::Flags::COMPRESSION_MASK);
+  std::shared_ptr<const BufferedWriteDictionaryRegistry::Dictionary>
+      dictionary;
+  if (!resolveDictionary(dictionary_id, compression, dictionary)) {
+    return 0;
+  }
   switch (format) {
     case Format::SINGLE_PAYLOADS: {
       size_t bytes_decoded = BufferedWriteSinglePayloadsCodec::decode(
-          binary, compression, payloads_out, allow_buffer_sharing);
+          binary,
+          compression,
+          payloads_out,
+          allow_buffer_sharing,
+          dictionary ? &dictionary->data : nullptr);
       if (bytes_decoded == 0) {
         return 0;
       }
@@ -649,12 +986,19 @@ size_t BufferedWriteCodec::decode(Slice binary,
   BufferedWriteDecoderImpl::flags_t flags;
   Format format;
   size_t batch_size;
-  const size_t header_size = decodeHeader(binary, &flags, &format, &batch_size);
+  uint32_t dictionary_id;
+  const size_t header_size =
+      decodeHeader(binary, &flags, &format, &batch_size, &dictionary_id);
   if (header_size == 0) {
     return 0;
   }
   const Compression compression = static_cast<Compression>(
       flags & BufferedWriteDecoderImpl::Flags::COMPRESSION_MASK);
+  std::shared_ptr<const BufferedWriteDictionaryRegistry::Dictionary>
+      dictionary;
+  if (!resolveDictionary(dictionary_id, compression, dictionary)) {
+    return 0;
+  }
   switch (format) {
     case Format::SINGLE_PAYLOADS: {
       if (binary.size == 0) {
@@ -663,7 +1007,11 @@ size_t BufferedWriteCodec::decode(Slice binary,
       }
       std::vector<folly::IOBuf> payloads;
       const size_t bytes_decoded = BufferedWriteSinglePayloadsCodec::decode(
-          binary, compression, payloads, allow_buffer_sharing);
+          binary,
+          compression,
+          payloads,
+          allow_buffer_sharing,
+          dictionary ? &dictionary->data : nullptr);
       if (bytes_decoded == 0) {
         return 0;
       }
@@ -690,7 +1038,8 @@ size_t BufferedWriteCodec::decode(
     bool allow_buffer_sharing) {
   Format format;
   folly::IOBuf iobuf = blob;
-  const size_t bytes_decoded = decodeHeader(iobuf, nullptr, &format, nullptr);
+  const size_t bytes_decoded =
+      decodeHeader(iobuf, nullptr, &format, nullptr, nullptr);
   if (bytes_decoded == 0) {
     return 0;
   }
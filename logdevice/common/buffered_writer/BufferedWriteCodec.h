@@ -7,12 +7,15 @@
  */
 #pragma once
 
+#include <memory>
 #include <string>
 
 #include <folly/io/Cursor.h>
 #include <folly/io/IOBuf.h>
+#include <folly/io/IOBufQueue.h>
 
 #include "logdevice/common/PayloadGroupCodec.h"
+#include "logdevice/common/buffered_writer/BufferedWriteDictionaryRegistry.h"
 #include "logdevice/include/types.h"
 
 namespace facebook { namespace logdevice {
@@ -36,17 +39,22 @@ class BufferedWriteSinglePayloadsCodec {
      * Encodes and compressess payloads. If compressing payloads with requested
      * compresssion doesn't improve required space, then it can be left
      * uncompressed. compression parameter is updated accordingly.
+     * If zstd_dictionary is provided and ZSTD compression is requested,
+     * payloads are compressed using the dictionary.
      */
     void encode(folly::IOBufQueue& out,
                 Compression& compression,
-                int zstd_level = 0);
+                int zstd_level = 0,
+                const std::string* zstd_dictionary = nullptr);
 
    private:
     /**
      * Replaces blob with compressed blob if compression saves some space and
      * returns true. Otherwise leaves blob as is and returns false.
      */
-    bool compress(Compression compression, int zstd_level);
+    bool compress(Compression compression,
+                  int zstd_level,
+                  const std::string* zstd_dictionary);
 
     // Payloads are appended to the blob_ using appender_ */
     folly::IOBuf blob_;
@@ -76,7 +84,8 @@ class BufferedWriteSinglePayloadsCodec {
   static size_t decode(const Slice& binary,
                        Compression compression,
                        std::vector<folly::IOBuf>& payloads_out,
-                       bool allow_buffer_sharing);
+                       bool allow_buffer_sharing,
+                       const std::string* zstd_dictionary = nullptr);
 };
 
 /**
@@ -98,6 +107,18 @@ class BufferedWriteCodec {
      */
     Encoder(int checksum_bits, size_t appends_count, size_t capacity);
 
+    /**
+     * Same, additionally specifying a trained zstd dictionary to compress
+     * the batch with. The dictionary id is recorded in the batch header; the
+     * read side resolves it through BufferedWriteDictionaryRegistry. Only
+     * supported for SINGLE_PAYLOADS batches with ZSTD compression.
+     */
+    Encoder(int checksum_bits,
+            size_t appends_count,
+            size_t capacity,
+            std::shared_ptr<const BufferedWriteDictionaryRegistry::Dictionary>
+                zstd_dictionary);
+
     /** Appends single payload to the batch. */
     void append(folly::IOBuf&& payload);
     /** Appends payload group to the batch. */
@@ -120,11 +141,70 @@ class BufferedWriteCodec {
 
     int checksum_bits_;
     size_t appends_count_;
+    // Dictionary to compress the batch with; nullptr if not in use.
+    // Declared before header_size_ since the header includes the varint
+    // dictionary id when a dictionary is set.
+    std::shared_ptr<const BufferedWriteDictionaryRegistry::Dictionary>
+        zstd_dictionary_;
     size_t header_size_;
 
     PayloadsEncoder payloads_encoder_;
   };
 
+  /**
+   * Incremental alternative to Encoder for SINGLE_PAYLOADS batches
+   * compressed with zstd. Payloads are fed into a zstd streaming context as
+   * they are appended, so the compression work is spread over the lifetime
+   * of the batch and encode() only finalizes the frame, instead of
+   * compressing the whole batch in one burst at flush time.
+   *
+   * Produces the same blob layout as Encoder with Compression::ZSTD: batch
+   * header, varint uncompressed size, zstd frame. Like Encoder, it declines
+   * to compress when compression does not reduce the size; since the
+   * original bytes have not been retained here, the caller re-encodes the
+   * batch through the regular Encoder in that (rare) case.
+   */
+  class StreamingEncoder {
+   public:
+    StreamingEncoder(
+        int checksum_bits,
+        int zstd_level,
+        std::shared_ptr<const BufferedWriteDictionaryRegistry::Dictionary>
+            zstd_dictionary = nullptr);
+    ~StreamingEncoder();
+
+    /** Appends single payload to the batch, compressing it right away. */
+    void append(const folly::IOBuf& payload);
+
+    /**
+     * Finalizes the frame and appends the complete blob (header included)
+     * to out as a single contiguous IOBuf. If the compressed batch would
+     * not be smaller than the uncompressed encoding, emits nothing and
+     * sets compression to NONE instead; the caller must then encode the
+     * retained payloads through Encoder.
+     * StreamingEncoder must not be re-used after calling this.
+     */
+    void encode(folly::IOBufQueue& out, Compression& compression);
+
+   private:
+    /** Runs a piece of input through the zstd stream. */
+    void compressChunk(const void* data, size_t size);
+
+    int checksum_bits_;
+    // Dictionary the stream was initialized with; nullptr if not in use.
+    std::shared_ptr<const BufferedWriteDictionaryRegistry::Dictionary>
+        zstd_dictionary_;
+    size_t appends_count_ = 0;
+    // Size of the uncompressed SINGLE_PAYLOADS encoding so far.
+    size_t uncompressed_bytes_ = 0;
+    // Compressed frame accumulated so far.
+    folly::IOBufQueue compressed_{folly::IOBufQueue::cacheChainLength()};
+    // Owns the ZSTD_CStream; defined in the .cpp to keep zstd.h out of
+    // this header.
+    struct Stream;
+    std::unique_ptr<Stream> stream_;
+  };
+
   /**
    * Supports estimation of encoded buffered writes batch size.
    */
@@ -143,8 +223,12 @@ class BufferedWriteCodec {
      * the header. Result of this call can be used to specify capacity for the
      * Encoder. Passing same sequence of appends to encoder is guaranteed to fit
      * into a buffer of size calculated by this function.
+     * zstd_dictionary_id must match the id passed to the Encoder (0 if the
+     * batch is not compressed with a dictionary), since the header includes
+     * the id when one is in use.
      */
-    size_t calculateSize(int checksum_bits) const;
+    size_t calculateSize(int checksum_bits,
+                         uint32_t zstd_dictionary_id = 0) const;
 
     /**
      * Returns format required for the batch encoding. Format is updated
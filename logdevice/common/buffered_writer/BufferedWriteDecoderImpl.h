@@ -32,6 +32,10 @@ class BufferedWriteDecoderImpl : public BufferedWriteDecoder {
     // A flag bit which indicates that the blob composed by BufferedWriter
     // contains the size of the batch before individual payloads.
     static constexpr flags_t SIZE_INCLUDED = 1 << 3;
+    // A flag bit which indicates that a varint zstd dictionary id follows
+    // the batch size.  The dictionary is only consulted when the compression
+    // bits say ZSTD; see BufferedWriteDictionaryRegistry.
+    static constexpr flags_t DICTIONARY = 1 << 4;
   };
 
   int decode(std::vector<std::unique_ptr<DataRecord>>&& records,
@@ -0,0 +1,68 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/buffered_writer/BufferedWriteDictionaryRegistry.h"
+
+#include <unordered_map>
+
+#include <folly/Synchronized.h>
+
+#include "logdevice/include/BufferedWriter.h"
+#include "logdevice/include/Err.h"
+
+namespace facebook { namespace logdevice {
+
+namespace {
+
+using DictionaryMap = std::unordered_map<
+    uint32_t,
+    std::shared_ptr<const BufferedWriteDictionaryRegistry::Dictionary>>;
+
+folly::Synchronized<DictionaryMap>& registry() {
+  static folly::Synchronized<DictionaryMap> map;
+  return map;
+}
+
+} // namespace
+
+int BufferedWriteDictionaryRegistry::registerDictionary(uint32_t id,
+                                                        std::string data) {
+  if (id == 0) {
+    err = E::INVALID_PARAM;
+    return -1;
+  }
+  auto map = registry().wlock();
+  auto it = map->find(id);
+  if (it != map->end()) {
+    if (it->second->data == data) {
+      // Re-registering an identical dictionary is a no-op.
+      return 0;
+    }
+    err = E::EXISTS;
+    return -1;
+  }
+  auto dictionary = std::make_shared<Dictionary>();
+  dictionary->id = id;
+  dictionary->data = std::move(data);
+  map->emplace(id, std::move(dictionary));
+  return 0;
+}
+
+std::shared_ptr<const BufferedWriteDictionaryRegistry::Dictionary>
+BufferedWriteDictionaryRegistry::lookup(uint32_t id) {
+  auto map = registry().rlock();
+  auto it = map->find(id);
+  return it != map->end() ? it->second : nullptr;
+}
+
+int BufferedWriter::registerCompressionDictionary(uint32_t id,
+                                                  std::string data) {
+  return BufferedWriteDictionaryRegistry::registerDictionary(
+      id, std::move(data));
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,55 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Process-wide registry of trained zstd dictionaries used by
+ * BufferedWriter to compress batches.  Small records compress poorly in
+ * isolation; a dictionary trained on representative payloads recovers most
+ * of the ratio even at small batch sizes.  A batch compressed with a
+ * dictionary records the dictionary id in its header, and the read side
+ * looks the dictionary up here when decoding.  Training dictionaries and
+ * distributing them to writer and reader processes is up to the
+ * application; see BufferedWriter::registerCompressionDictionary().
+ */
+
+class BufferedWriteDictionaryRegistry {
+ public:
+  struct Dictionary {
+    // Nonzero id stored in batch headers; 0 is reserved for "no dictionary".
+    uint32_t id = 0;
+    // Raw dictionary contents, as produced by zstd dictionary training.
+    std::string data;
+  };
+
+  /**
+   * Registers a dictionary under the given id.  Registering the same
+   * (id, data) pair again is a no-op.  Dictionaries are never unregistered:
+   * already written batches reference them by id indefinitely, so
+   * applications should mint a new id when retraining.
+   *
+   * @return 0 on success, or -1 with err set to
+   *         INVALID_PARAM  id is 0
+   *         EXISTS         a different dictionary is registered under the id
+   */
+  static int registerDictionary(uint32_t id, std::string data);
+
+  /**
+   * Returns the dictionary registered under the given id, or nullptr if
+   * there isn't one.
+   */
+  static std::shared_ptr<const Dictionary> lookup(uint32_t id);
+};
+
+}} // namespace facebook::logdevice
@@ -452,6 +452,18 @@ int BufferedWriterImpl::appendImpl(logid_t log_id,
   BufferedWriterShard::AppendChunk chunk;
   chunk.emplace_back(
       log_id, std::move(payload), std::move(cb_context), std::move(attrs));
+
+  if (BufferedWriterShard* local_shard = findLocalShard(shard_idx)) {
+    // Already on the target Worker; hand the chunk to the shard directly
+    // instead of taking a round trip through the request queue.
+    STAT_INCR(stats_, buffered_appends_same_worker);
+    append_sink_->onBytesSentToWorker(payload_mem_bytes);
+    local_shard->append(std::move(chunk), /* atomic */ false);
+    // BufferedWriterSingleLog will release memory budget after append is done.
+    release_memory_on_fail.dismiss();
+    return 0;
+  }
+
   std::unique_ptr<Request> req =
       std::make_unique<BufferedAppendRequest>(worker_id_t(shard_idx),
                                               shards_[shard_idx],
@@ -542,6 +554,15 @@ int BufferedWriterImpl::appendAtomic(logid_t log_id,
     chunks.emplace_back(std::move(append));
   }
 
+  if (BufferedWriterShard* local_shard = findLocalShard(shard)) {
+    // Already on the target Worker; skip the request queue round trip.
+    STAT_ADD(stats_, buffered_appends_same_worker, chunks.size());
+    append_sink_->onBytesSentToWorker(append_mem_sizes);
+    local_shard->append(std::move(chunks), /* atomic */ true);
+    release_memory_on_fail.dismiss();
+    return 0;
+  }
+
   std::unique_ptr<Request> req = std::make_unique<BufferedAppendRequest>(
       worker_id_t(shard), shards_[shard], std::move(chunks), /* atomic */ true);
   append_sink_->onBytesSentToWorker(append_mem_sizes);
@@ -634,6 +655,15 @@ BufferedWriterImpl::append(std::vector<Append>&& input_appends) {
       continue;
     }
 
+    if (BufferedWriterShard* local_shard = findLocalShard(i)) {
+      // Already on the target Worker; skip the request queue round trip.
+      STAT_ADD(stats_, buffered_appends_same_worker, num_appends_in_chunk);
+      append_sink_->onBytesSentToWorker(shard_bytes);
+      local_shard->append(std::move(chunks[i]), /* atomic */ false);
+      chunk_status[i] = E::OK;
+      continue;
+    }
+
     // Post a BufferedAppendRequest to process this shard's chunk on the
     // appropriate Worker.
     std::unique_ptr<Request> req = std::make_unique<BufferedAppendRequest>(
@@ -718,7 +748,23 @@ int BufferedWriterImpl::flushAll() {
 }
 
 int BufferedWriterImpl::mapLogToShardIndex(logid_t log_id) const {
+  if (use_log_worker_affinity_) {
+    // Map through the processor-wide log-to-Worker affinity so this log's
+    // batching lands on the same Worker as other components pinning per-log
+    // work (e.g. log recovery).
+    return Processor::selectWorkerIdForLog(log_id, shards_.size()).val_;
+  }
   return folly::hash::hash_128_to_64(hash_salt_, log_id.val_) % shards_.size();
 }
 
+BufferedWriterShard* BufferedWriterImpl::findLocalShard(int shard_idx) const {
+  Worker* w = Worker::onThisThread(false);
+  if (w == nullptr || w->worker_type_ != WorkerType::GENERAL ||
+      w->idx_.val_ != shard_idx) {
+    return nullptr;
+  }
+  auto it = w->active_buffered_writers_.find(shards_[shard_idx]);
+  return it != w->active_buffered_writers_.end() ? it->second : nullptr;
+}
+
 }} // namespace facebook::logdevice
@@ -22,6 +22,7 @@ class StreamWriterTest;
 
 namespace facebook { namespace logdevice {
 
+class BufferedWriterShard;
 class Client;
 class PayloadHolder;
 class Processor;
@@ -325,6 +326,18 @@ class BufferedWriterImpl : public BufferedWriter {
     prepend_checksums_ = true;
   }
 
+  /**
+   * If called, logs are mapped to Workers through
+   * Processor::selectWorkerIdForLog() instead of a per-instance salted hash.
+   * Meant for SequencerBatching, whose single per-Processor instance wants
+   * per-log work pinned to the same Worker other per-log components use; the
+   * salted hash only pays off when several BufferedWriter instances share a
+   * Processor.  Call right after construction, before any appends.
+   */
+  void useLogWorkerAffinity() {
+    use_log_worker_affinity_ = true;
+  }
+
   /*
    * If called, the BufferedWriterImpl will own append_sink_. So, when
    * BufferedWriterImpl is destroyed, append_sink_ will also be destroyed.
@@ -359,6 +372,12 @@ class BufferedWriterImpl : public BufferedWriter {
 
   int mapLogToShardIndex(logid_t) const;
 
+  // If the calling thread is the Worker that owns shard `shard_idx', returns
+  // the BufferedWriterShard so the caller can hand it the chunk directly
+  // instead of posting a Request back to the current thread.  Returns nullptr
+  // otherwise (different thread, different Worker, or shard already gone).
+  BufferedWriterShard* findLocalShard(int shard_idx) const;
+
   int64_t memoryForPayloadBytes(int64_t payload_bytes) const {
     // Budget 2x the payload size; 1x for the original std::string which we
     // keep around, and another 1x in the blob sent to LogDevice (which we
@@ -387,6 +406,7 @@ class BufferedWriterImpl : public BufferedWriter {
   WaitableCounter num_background_tasks_;
   uint64_t hash_salt_;
   bool prepend_checksums_ = false;
+  bool use_log_worker_affinity_ = false;
   // This will have exactly one entry for each Worker in the Processor's
   // thread pool.
   std::vector<buffered_writer_id_t> shards_;
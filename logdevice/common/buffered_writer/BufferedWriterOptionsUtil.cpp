@@ -18,7 +18,7 @@ namespace facebook { namespace logdevice {
 void describeBufferedWriterOptions(options_description& po,
                                    BufferedWriter::Options* opts,
                                    std::string prefix) {
-  static_assert(sizeof(BufferedWriter::Options) == 7 * 8,
+  static_assert(sizeof(BufferedWriter::Options) == 9 * 8,
                 "If you added fields to BufferedWriter::Options, you may want "
                 "to add them here as well.");
 
@@ -27,6 +27,20 @@ void describeBufferedWriterOptions(options_description& po,
       chrono_value(&opts->time_trigger),
       "Flush buffered writes for a log when the oldest has been buffered this "
       "long (negative for no trigger).");
+  po.add_options()(
+      (prefix + "time-trigger-jitter").c_str(),
+      value<double>(&opts->time_trigger_jitter)
+          ->default_value(opts->time_trigger_jitter)
+          ->notifier([prefix](double val) {
+            if (val < 0 || val > 1) {
+              throw boost::program_options::error(
+                  "Invalid " + prefix + "time-trigger-jitter: " +
+                  std::to_string(val) + ", must be in [0, 1]");
+            }
+          }),
+      "Fraction of time-trigger to randomize each flush delay by, in [0, 1]. "
+      "Spreads flushes of logs sharing the same trigger across the window "
+      "instead of convoying them into the same tick. 0 disables jitter.");
   po.add_options()(
       (prefix + "size-trigger").c_str(),
       value<std::string>()
@@ -86,6 +100,14 @@ void describeBufferedWriterOptions(options_description& po,
           }),
       "Algorithm to use for client-side compression in Buffered writer. 'none' "
       "for no compression. Supported values: 'zstd', 'lz4', 'lz4_hc'.");
+  po.add_options()(
+      (prefix + "zstd-dictionary-id").c_str(),
+      value<uint32_t>(&opts->zstd_dictionary_id)
+          ->default_value(opts->zstd_dictionary_id),
+      "Id of a trained zstd dictionary, previously registered via "
+      "BufferedWriter::registerCompressionDictionary(), to compress batches "
+      "with. Only used with zstd compression. 0 disables dictionary "
+      "compression.");
   po.add_options()((prefix + "memory-limit-mb").c_str(),
                    value<int32_t>(&opts->memory_limit_mb)
                        ->default_value(opts->memory_limit_mb),
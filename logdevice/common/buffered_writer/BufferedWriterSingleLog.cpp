@@ -7,7 +7,9 @@
  */
 #include "logdevice/common/buffered_writer/BufferedWriterSingleLog.h"
 
+#include <array>
 #include <chrono>
+#include <cmath>
 #include <lz4.h>
 #include <lz4hc.h>
 #include <zstd.h>
@@ -24,7 +26,9 @@
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/SimpleEnumMap.h"
 #include "logdevice/common/Timer.h"
+#include "logdevice/common/Timestamp.h"
 #include "logdevice/common/Worker.h"
+#include "logdevice/common/buffered_writer/BufferedWriteBufferPool.h"
 #include "logdevice/common/buffered_writer/BufferedWriteCodec.h"
 #include "logdevice/common/buffered_writer/BufferedWriteDecoderImpl.h"
 #include "logdevice/common/buffered_writer/BufferedWriterImpl.h"
@@ -53,6 +57,47 @@ using batch_flags_t = BufferedWriteDecoderImpl::flags_t;
 using Compression = BufferedWriter::Options::Compression;
 using Flags = BufferedWriteDecoderImpl::Flags;
 
+namespace {
+
+// Crude entropy estimate used to spot payloads that are already compressed
+// or encrypted: Shannon entropy of a byte histogram over a bounded prefix.
+// Cheap compared to running the real compressor over the payload.
+bool isLikelyIncompressible(const std::string& payload) {
+  // Below this size the histogram is too noisy, and compressing tiny
+  // payloads is cheap anyway.
+  static constexpr size_t kMinPayloadSize = 64;
+  static constexpr size_t kSampleSize = 1024;
+  // Compressed and encrypted data sits close to the 8 bits/byte maximum,
+  // while text and serialized structs are typically well below.
+  static constexpr double kEntropyThreshold = 7.4;
+
+  if (payload.size() < kMinPayloadSize) {
+    return false;
+  }
+  const size_t sample_size = std::min(payload.size(), kSampleSize);
+  std::array<uint32_t, 256> counts{};
+  for (size_t i = 0; i < sample_size; ++i) {
+    ++counts[static_cast<uint8_t>(payload[i])];
+  }
+  double entropy = 0;
+  for (uint32_t count : counts) {
+    if (count > 0) {
+      const double p = static_cast<double>(count) / sample_size;
+      entropy -= p * std::log2(p);
+    }
+  }
+  return entropy > kEntropyThreshold;
+}
+
+// Returns true if enough of the batch's payload bytes are incompressible
+// that compressing the batch is a waste of CPU.
+bool shouldBypassCompression(const BufferedWriterSingleLog::Batch& batch) {
+  return batch.incompressible_payload_bytes * 2 >
+      batch.payload_memory_bytes_total;
+}
+
+} // namespace
+
 BufferedWriterSingleLog::BufferedWriterSingleLog(BufferedWriterShard* parent,
                                                  logid_t log_id,
                                                  GetLogOptionsFunc get_options)
@@ -112,7 +157,9 @@ int BufferedWriterSingleLog::appendImpl(AppendChunk& chunk,
                  append.payload);
     }
     const size_t new_blob_bytes_total =
-        batch->blob_size_estimator.calculateSize(checksumBits());
+        batch->blob_size_estimator.calculateSize(
+            checksumBits(),
+            batch->zstd_dictionary ? batch->zstd_dictionary->id : 0);
     if (new_blob_bytes_total > max_payload_size) {
       // These records would take us over the payload size limit. Flush the
       // already buffered records first, then we will create a new batch for
@@ -124,6 +171,11 @@ int BufferedWriterSingleLog::appendImpl(AppendChunk& chunk,
     } else {
       batch->blob_bytes_total = new_blob_bytes_total;
       batch->blob_format = batch->blob_size_estimator.getFormat();
+      if (batch->blob_format !=
+          BufferedWriteCodec::Format::SINGLE_PAYLOADS) {
+        // Payload groups are never dictionary-compressed.
+        batch->zstd_dictionary.reset();
+      }
     }
   }
 
@@ -141,6 +193,32 @@ int BufferedWriterSingleLog::appendImpl(AppendChunk& chunk,
 
     auto batch = std::make_unique<Batch>(next_batch_num_++);
 
+    if (options_.compression == Compression::ZSTD &&
+        options_.zstd_dictionary_id != 0) {
+      batch->zstd_dictionary =
+          BufferedWriteDictionaryRegistry::lookup(options_.zstd_dictionary_id);
+      if (!batch->zstd_dictionary) {
+        RATELIMIT_WARNING(10s,
+                          1,
+                          "zstd dictionary %u configured for log %s is not "
+                          "registered; writing batches without a dictionary",
+                          options_.zstd_dictionary_id,
+                          toString(log_id_).c_str());
+      }
+    }
+
+    if (options_.compression == Compression::ZSTD) {
+      // Compress payloads as they arrive, so that flushing this batch only
+      // finalizes the zstd frame instead of compressing everything at once,
+      // which showed up as flush-time latency spikes proportional to the
+      // batch size.
+      batch->streaming_encoder =
+          std::make_unique<BufferedWriteCodec::StreamingEncoder>(
+              checksumBits(),
+              Worker::settings().buffered_writer_zstd_level,
+              batch->zstd_dictionary);
+    }
+
     // Calculate how many bytes these records will take up in the blob
     for (const BufferedWriter::Append& append : chunk) {
       std::visit(folly::overload(
@@ -154,9 +232,14 @@ int BufferedWriterSingleLog::appendImpl(AppendChunk& chunk,
                      }),
                  append.payload);
     }
-    batch->blob_bytes_total =
-        batch->blob_size_estimator.calculateSize(checksumBits());
     batch->blob_format = batch->blob_size_estimator.getFormat();
+    if (batch->blob_format != BufferedWriteCodec::Format::SINGLE_PAYLOADS) {
+      // Payload groups are never dictionary-compressed.
+      batch->zstd_dictionary.reset();
+    }
+    batch->blob_bytes_total = batch->blob_size_estimator.calculateSize(
+        checksumBits(),
+        batch->zstd_dictionary ? batch->zstd_dictionary->id : 0);
     batches_->push_back(std::move(batch));
     // Intentionally setting state after pushing to make sure is_flushable_
     // becomes true *during* the setBatchState() call
@@ -175,6 +258,35 @@ int BufferedWriterSingleLog::appendImpl(AppendChunk& chunk,
     BufferedWriter::AppendCallback::Context& context = append.context;
     batch.appends.emplace_back(std::move(context), std::move(payload));
 
+    std::visit(folly::overload(
+                   [&](const std::string& stored_payload) {
+                     if (append.payload_precompressed ||
+                         isLikelyIncompressible(stored_payload)) {
+                       batch.incompressible_payload_bytes +=
+                           stored_payload.size();
+                     }
+                   },
+                   [](const PayloadGroup&) {
+                     // Payload groups are compressed by their own codec.
+                   }),
+               batch.appends.back().second);
+
+    if (batch.streaming_encoder) {
+      std::visit(folly::overload(
+                     [&](const std::string& stored_payload) {
+                       batch.streaming_encoder->append(
+                           folly::IOBuf::wrapBufferAsValue(
+                               stored_payload.data(), stored_payload.size()));
+                     },
+                     [&](const PayloadGroup&) {
+                       // Payload groups switch the batch to the
+                       // PAYLOAD_GROUPS format, which has no streaming
+                       // support; encode the batch at flush time instead.
+                       batch.streaming_encoder.reset();
+                     }),
+                 batch.appends.back().second);
+    }
+
     if (append.attrs.optional_keys.find(KeyType::FINDKEY) !=
         append.attrs.optional_keys.end()) {
       const std::string& key = append.attrs.optional_keys[KeyType::FINDKEY];
@@ -203,6 +315,12 @@ int BufferedWriterSingleLog::appendImpl(AppendChunk& chunk,
     }
   }
 
+  if (batch.streaming_encoder && shouldBypassCompression(batch)) {
+    // Most of the batch is incompressible; stop feeding the streaming
+    // compressor.  The flush path will skip compression for the batch.
+    batch.streaming_encoder.reset();
+  }
+
   // Check if we hit the size trigger and should flush
   flushMeMaybe(defer_client_size_trigger);
   return 0;
@@ -304,9 +422,19 @@ void BufferedWriterSingleLog::sendBatch(Batch& batch) {
   if (batch.state == Batch::State::BUILDING) {
     ld_check_eq(batch.blob.length(), 0);
 
+    Compression compression = options_.compression;
+    if (compression != Compression::NONE && shouldBypassCompression(batch)) {
+      // Most of the batch's payload bytes are pre-compressed or
+      // high-entropy; compressing them again costs CPU for no size win.
+      StatsHolder* stats{parent_->parent_->processor()->stats_};
+      STAT_INCR(stats, buffered_writer_compression_bypassed);
+      ld_check(!batch.streaming_encoder);
+      compression = Compression::NONE;
+    }
+
     setBatchState(batch, Batch::State::CONSTRUCTING_BLOB);
     construct_blob(
-        batch, checksumBits(), options_.compression, options_.destroy_payloads);
+        batch, checksumBits(), compression, options_.destroy_payloads);
   } else {
     // This is a retry, so we must have already sent it, so we can skip the
     // purgatory of READY_TO_SEND.
@@ -524,7 +652,20 @@ void BufferedWriterSingleLog::activateTimeTrigger() {
     });
   }
   if (!time_trigger_timer_->isActive()) {
-    time_trigger_timer_->activate(options_.time_trigger);
+    auto delay = options_.time_trigger;
+    const double jitter =
+        std::min(std::max(options_.time_trigger_jitter, 0.0), 1.0);
+    if (jitter > 0) {
+      // Many logs typically share the same trigger and start buffering in
+      // the same burst of appends, so without jitter their timers all fire
+      // in the same tick and the flushes convoy.  Spread them across the
+      // window instead.
+      const double factor =
+          1.0 + jitter * (2 * folly::Random::randDouble01() - 1);
+      delay = std::chrono::duration_cast<std::chrono::milliseconds>(
+          delay * factor);
+    }
+    time_trigger_timer_->activate(delay);
   }
 }
 
@@ -603,7 +744,12 @@ void BufferedWriterSingleLog::finishBatch(Batch& batch) {
   // them back to the application
   ld_check(batch.appends.empty());
   batch.appends.shrink_to_fit();
-  // Free/unlink the buffer.
+  // Free/unlink the buffer, keeping it for reuse by future batches when
+  // nothing else still references it (the append sink got a refcounted
+  // clone, so a shared buffer is left alone).
+  if (BufferedWriteBufferPool::recycle(std::move(batch.blob))) {
+    WORKER_STAT_INCR(buffered_writer_blob_buffers_recycled);
+  }
   batch.blob = folly::IOBuf();
   // Return the memory budget
   parent_->parent_->releaseMemory(batch.payload_memory_bytes_total);
@@ -629,8 +775,10 @@ void encode_batch(BufferedWriterSingleLog::Batch& batch,
                   bool destroy_payloads) {
   ld_check(batch.total_size_freed == 0);
 
-  BufferedWriteCodec::Encoder<PayloadsEncoder> encoder(
-      checksum_bits, batch.appends.size(), batch.blob_bytes_total);
+  BufferedWriteCodec::Encoder<PayloadsEncoder> encoder(checksum_bits,
+                                                       batch.appends.size(),
+                                                       batch.blob_bytes_total,
+                                                       batch.zstd_dictionary);
   for (auto& append : batch.appends) {
     if (destroy_payloads) {
       batch.total_size_freed +=
@@ -727,6 +875,42 @@ void BufferedWriterSingleLog::construct_blob(
     return;
   }
 
+  if (batch.streaming_encoder) {
+    // The payloads were already compressed as they were appended; all that
+    // is left is finalizing the frame, which is cheap enough to always run
+    // inline instead of on a background thread.
+    ld_check(batch.blob_format ==
+             BufferedWriteCodec::Format::SINGLE_PAYLOADS);
+    Compression used = Compression::ZSTD;
+    folly::IOBufQueue encoded;
+    batch.streaming_encoder->encode(encoded, used);
+    batch.streaming_encoder.reset();
+    if (used == Compression::ZSTD) {
+      batch.blob = encoded.moveAsValue();
+      ld_check(batch.total_size_freed == 0);
+      if (destroy_payloads) {
+        for (auto& append : batch.appends) {
+          batch.total_size_freed +=
+              BufferedWriterPayloadMeter::memorySize(append.second);
+          std::visit(folly::overload(
+                         [](std::string& payload) {
+                           payload.clear();
+                           payload.shrink_to_fit();
+                         },
+                         [](PayloadGroup& payload_group) {
+                           payload_group.clear();
+                         }),
+                     append.second);
+        }
+      }
+      readyToSend(batch);
+      return;
+    }
+    // Compression did not reduce the size of this batch; re-encode the
+    // retained payloads uncompressed through the regular path below.
+    compression = Compression::NONE;
+  }
+
   const int zstd_level = Worker::settings().buffered_writer_zstd_level;
 
   // We need to call construct_blob_long_running(), then callback().  If the
@@ -741,6 +925,7 @@ void BufferedWriterSingleLog::construct_blob(
     readyToSend(batch);
   } else {
     ProcessorProxy* processor_proxy = parent_->parent_->processorProxy();
+    StatsHolder* stats = processor_proxy->processor()->stats_;
     ld_spew("Enqueueing batch %lu for log %s to background thread.  Batches "
             "outstanding for this log: %lu Background tasks: %lu",
             batch.num,
@@ -748,6 +933,7 @@ void BufferedWriterSingleLog::construct_blob(
             batches_->size(),
             parent_->parent_->recentNumBackground());
 
+    const auto enqueue_time = SteadyTimestamp::now();
     processor_proxy->processor()->enqueueToBackgroundBlocking(
         [&batch,
          checksum_bits,
@@ -757,9 +943,16 @@ void BufferedWriterSingleLog::construct_blob(
          thread_affinity = Worker::onThisThread()->idx_.val(),
          compression,
          zstd_level,
+         stats,
+         enqueue_time,
          this]() mutable {
+          // How long the batch sat in the queue behind other tasks before a
+          // background thread picked it up.
+          STAT_ADD(
+              stats, buffered_writer_bg_queue_stall_usec, usec_since(enqueue_time));
           BufferedWriterSingleLog::Impl::construct_blob_long_running(
               batch, checksum_bits, compression, zstd_level, destroy_payloads);
+          STAT_INCR(stats, buffered_writer_bg_tasks_completed);
           std::unique_ptr<Request> request =
               std::make_unique<ContinueBlobSendRequest>(
                   this, batch, thread_affinity);
@@ -776,6 +969,11 @@ void BufferedWriterSingleLog::construct_blob(
             ld_error("Processor::postWithRetrying() failed: %d", rc);
           }
         });
+    STAT_INCR(stats, buffered_writer_bg_tasks_enqueued);
+    // Non-zero when the hand-off itself blocked the Worker because the
+    // background queue was full.
+    STAT_ADD(
+        stats, buffered_writer_bg_enqueue_stall_usec, usec_since(enqueue_time));
   }
 }
 
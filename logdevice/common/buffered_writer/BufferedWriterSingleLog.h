@@ -23,6 +23,7 @@
 #include "logdevice/common/SimpleEnumMap.h"
 #include "logdevice/common/buffered_writer/BufferedWriteCodec.h"
 #include "logdevice/common/buffered_writer/BufferedWriteDecoderImpl.h"
+#include "logdevice/common/buffered_writer/BufferedWriteDictionaryRegistry.h"
 #include "logdevice/common/types_internal.h"
 #include "logdevice/include/BufferedWriter.h"
 
@@ -103,6 +104,11 @@ class BufferedWriterSingleLog {
     AppendAttributes attrs;
     // Sum of payload sizes in `appends'
     size_t payload_memory_bytes_total = 0;
+    // Payload bytes that are pre-compressed (per the append hint) or were
+    // sniffed as high-entropy.  When these make up most of the batch, the
+    // batch compressor is bypassed; recompressing entropy costs CPU for no
+    // size win.
+    size_t incompressible_payload_bytes = 0;
     // Projection of how big the uncompressed blob will be.  Updated while the
     // batch is BUILDING so that we can early-flush when a large append would
     // take us over the max payload size.
@@ -115,6 +121,20 @@ class BufferedWriterSingleLog {
     // Encoding format which must be used to allow encoding of all appends.
     BufferedWriteCodec::Format blob_format =
         BufferedWriteCodec::Format::SINGLE_PAYLOADS;
+    // Trained zstd dictionary the batch will be compressed with, resolved
+    // from LogOptions::zstd_dictionary_id when the batch is created.
+    // nullptr if dictionary compression is not in use.  Reset if a payload
+    // group append switches the batch to the PAYLOAD_GROUPS format, which
+    // has no dictionary support.
+    std::shared_ptr<const BufferedWriteDictionaryRegistry::Dictionary>
+        zstd_dictionary;
+    // When the batch is eligible (zstd compression, SINGLE_PAYLOADS
+    // format), payloads are fed into this streaming compressor as they are
+    // appended, so that flushing only finalizes the frame instead of
+    // compressing the whole batch in one burst on the Worker.  Reset if a
+    // payload group append switches the batch to a format that has no
+    // streaming support.
+    std::unique_ptr<BufferedWriteCodec::StreamingEncoder> streaming_encoder;
     // Blob to send to LogDevice, with the entire batch serialized.
     // Constructed the first time the batch transitions from BUILDING to
     // INFLIGHT.
@@ -85,6 +85,22 @@ void AllClientReadStreams::onGap(ShardID shard, const GAP_Message& msg) {
   }
 }
 
+void AllClientReadStreams::onEsnDigest(ShardID shard,
+                                       const ESN_DIGEST_Message& msg) {
+  auto ptr = getStream(msg.getHeader().read_stream_id);
+  if (ptr) {
+    ptr->onEsnDigest(shard, msg);
+  }
+}
+
+void AllClientReadStreams::onEsnDigestRequestFailed(read_stream_id_t id,
+                                                    ShardID shard) {
+  auto ptr = getStream(id);
+  if (ptr) {
+    ptr->onEsnDigestRequestFailed(shard);
+  }
+}
+
 void AllClientReadStreams::onReaderProgress(read_stream_id_t id) {
   auto ptr = getStream(id);
   if (ptr) {
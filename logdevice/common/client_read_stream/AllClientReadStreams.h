@@ -14,6 +14,7 @@
 #include "logdevice/common/AdminCommandTable-fwd.h"
 #include "logdevice/common/ShardAuthoritativeStatusMap.h"
 #include "logdevice/common/client_read_stream/ClientReadStream.h"
+#include "logdevice/common/protocol/ESN_DIGEST_Message.h"
 #include "logdevice/common/protocol/GAP_Message.h"
 #include "logdevice/common/protocol/STARTED_Message.h"
 #include "logdevice/common/types_internal.h"
@@ -84,6 +85,18 @@ class AllClientReadStreams : public ShardAuthoritativeStatusSubscriber {
    */
   void onGap(ShardID shard, const GAP_Message& msg);
 
+  /**
+   * Delivers an ESN_DIGEST message to the correct read stream. Called by
+   * ESN_DIGEST_Message::onReceived().
+   */
+  void onEsnDigest(ShardID shard, const ESN_DIGEST_Message& msg);
+
+  /**
+   * Informs the appropriate ClientReadStream that a GET_ESN_DIGEST message
+   * could not be sent to a shard.
+   */
+  void onEsnDigestRequestFailed(read_stream_id_t id, ShardID shard);
+
   /**
    * Delivers a ReaderProgressRequest to the correct read stream.
    */
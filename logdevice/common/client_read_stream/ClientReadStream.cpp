@@ -37,6 +37,7 @@
 #include "logdevice/common/SocketCallback.h"
 #include "logdevice/common/Timestamp.h"
 #include "logdevice/common/Worker.h"
+#include "logdevice/common/chrono_util.h"
 #include "logdevice/common/client_read_stream/AllClientReadStreams.h"
 #include "logdevice/common/client_read_stream/ClientReadStreamBuffer.h"
 #include "logdevice/common/client_read_stream/ClientReadStreamBufferFactory.h"
@@ -96,6 +97,7 @@ void ClientReadStreamRecordState::reset() {
   record.reset();
   gap = false;
   filtered_out = false;
+  delivered = false;
 }
 
 ClientReadStream::ClientReadStream(
@@ -1171,6 +1173,13 @@ void ClientReadStream::onDataRecord(ShardID shard,
     // we already checked that lsn can fit into the buffer
     ld_check(rstate != nullptr);
 
+    if (deliver_out_of_order_ && !rstate->delivered &&
+        ooo_delivered_lsns_.count(lsn)) {
+      // This record was delivered out of order before a rewind cleared the
+      // buffer; restore the marker so it is not delivered again.
+      rstate->delivered = true;
+    }
+
     read_tracer_->traceRecordDelivery(record->logid,
                                       record->attrs.lsn,
                                       deps_->getReadStreamID(),
@@ -1187,9 +1196,10 @@ void ClientReadStream::onDataRecord(ShardID shard,
                                       trim_point_,
                                       readSetSize());
 
-    if (!rstate->record || rstate->record_corrupted) {
+    if (!rstate->delivered && (!rstate->record || rstate->record_corrupted)) {
       // Updating info reg. buffer usage.
       bytes_buffered_ += record->payload.size();
+      WORKER_STAT_ADD(read_streams_bytes_buffered, record->payload.size());
       std::unique_ptr<DataRecordOwnsPayload> data_record;
       std::visit(folly::overload(
                      [&](auto& payload) {
@@ -1213,9 +1223,18 @@ void ClientReadStream::onDataRecord(ShardID shard,
                  decoded_payload);
       rstate->record = std::move(data_record);
     }
+
+    if (deliver_out_of_order_ && lsn > next_lsn_to_deliver_ &&
+        rstate->record != nullptr) {
+      deliverRecordOutOfOrder(lsn, *rstate);
+    }
+
     // This shard won't send us anything before `lsn'+1.
     // Use that information for gap detection.
     updateGapState(lsn < LSN_MAX ? lsn + 1 : LSN_MAX, sender_state);
+    // The record moved this sender's position; if an ESN digest from the
+    // shard says the following ESNs are absent there, account for them now.
+    applyEsnDigest(sender_state);
     findGapsAndRecords();
   }
 
@@ -1372,6 +1391,145 @@ void ClientReadStream::onGap(ShardID shard, const GAP_Message& msg) {
   disposeIfDone();
 }
 
+void ClientReadStream::maybeRequestEsnDigests() {
+  if (!deps_->getSettings().read_stream_esn_digests) {
+    return;
+  }
+
+  const epoch_t epoch = lsn_to_epoch(next_lsn_to_deliver_);
+  const esn_t esn_start = lsn_to_esn(next_lsn_to_deliver_);
+  // Cover the rest of the window, or the rest of the epoch if the window
+  // extends past it.
+  const esn_t esn_end =
+      lsn_to_epoch(window_high_) == epoch ? lsn_to_esn(window_high_) : ESN_MAX;
+  if (esn_start == ESN_INVALID || esn_start > esn_end) {
+    return;
+  }
+
+  for (auto& it : storage_set_states_) {
+    SenderState& state = it.second;
+    if (state.getGapState() != GapState::NONE) {
+      // This shard already chimed in at next_lsn_to_deliver_.
+      continue;
+    }
+    if (state.esn_digest_pending || !state.isHealthy()) {
+      continue;
+    }
+    if (state.digest_epoch == epoch &&
+        state.digest_start_esn <= esn_start &&
+        esn_start.val_ - state.digest_start_esn.val_ <
+            state.digest_num_esns) {
+      // The digest we already have covers the gap candidate; the shard must
+      // have an entry at or before next_lsn_to_deliver_ (otherwise
+      // applyEsnDigest() would have moved it to GapState::GAP), so a new
+      // digest for the same range wouldn't tell us anything new.
+      continue;
+    }
+
+    GET_ESN_DIGEST_Header header;
+    // log_id and read_stream_id are filled by sendEsnDigestRequest().
+    header.shard = state.getShardID().shard();
+    header.filter_version = filter_version_;
+    header.epoch = epoch;
+    header.esn_start = esn_start;
+    header.esn_end = esn_end;
+    if (deps_->sendEsnDigestRequest(state.getShardID(), header) == 0) {
+      state.esn_digest_pending = true;
+      WORKER_STAT_INCR(esn_digest_requests_sent);
+    }
+  }
+}
+
+void ClientReadStream::onEsnDigest(ShardID shard,
+                                   const ESN_DIGEST_Message& msg) {
+  ld_check(!done());
+  const ESN_DIGEST_Header& header = msg.getHeader();
+
+  auto it = storage_set_states_.find(shard);
+  if (it == storage_set_states_.end()) {
+    return;
+  }
+  SenderState& state = it->second;
+  state.esn_digest_pending = false;
+
+  if (permission_denied_) {
+    return;
+  }
+  if (header.filter_version != filter_version_) {
+    // Reply to a request sent before a rewind; positions have changed, drop.
+    return;
+  }
+  if (header.status != E::OK || header.num_esns == 0) {
+    // E::AGAIN et al.; if we're still stuck, the next gap candidate will
+    // trigger another request.
+    ld_debug("ESN_DIGEST from %s for log %lu, epoch %u: %s",
+             shard.toString().c_str(),
+             log_id_.val_,
+             header.epoch.val_,
+             error_name(header.status));
+    return;
+  }
+
+  state.digest_epoch = header.epoch;
+  state.digest_start_esn = header.esn_start;
+  state.digest_num_esns = header.num_esns;
+  state.digest_bitmap = msg.getBitmap();
+  WORKER_STAT_INCR(esn_digests_received);
+
+  applyEsnDigest(state);
+  findGapsAndRecords();
+
+  // This function should leave everything in a consistent state.
+  checkConsistency();
+
+  disposeIfDone();
+}
+
+void ClientReadStream::onEsnDigestRequestFailed(ShardID shard) {
+  auto it = storage_set_states_.find(shard);
+  if (it != storage_set_states_.end()) {
+    it->second.esn_digest_pending = false;
+  }
+}
+
+void ClientReadStream::applyEsnDigest(SenderState& state) {
+  if (state.digest_bitmap.empty()) {
+    return;
+  }
+
+  // The digest can only speak for LSNs the shard hasn't already reported on.
+  const lsn_t from = std::max(state.getNextLsn(), next_lsn_to_deliver_);
+  if (lsn_to_epoch(from) != state.digest_epoch) {
+    return;
+  }
+  const uint32_t e = lsn_to_esn(from).val_;
+  const uint32_t start = state.digest_start_esn.val_;
+  if (e < start || e - start >= state.digest_num_esns) {
+    return;
+  }
+  const uint64_t end = uint64_t(start) + state.digest_num_esns;
+
+  // Find the first ESN >= e whose presence bit is set.
+  uint64_t p = e;
+  while (p < end &&
+         !(state.digest_bitmap[(p - start) / 8] & (1u << ((p - start) % 8)))) {
+    ++p;
+  }
+  if (p == e) {
+    // The shard has an entry right at the current position; wait for it to
+    // deliver the record or a gap normally.
+    return;
+  }
+
+  // The shard has nothing to send in [e, p); advance its gap state as if it
+  // had sent a gap ending at ESN p - 1. (The p - 1/+ 1 formulation avoids
+  // composing an LSN with ESN_MAX + 1 when the whole tail of the digest is
+  // absent.)
+  WORKER_STAT_ADD(esn_digest_esns_resolved, p - e);
+  updateGapState(
+      compose_lsn(state.digest_epoch, esn_t(uint32_t(p - 1))) + 1, state);
+}
+
 void ClientReadStream::updateGapState(lsn_t next_lsn, SenderState& state) {
   if (next_lsn < state.getNextLsn()) {
     // Storage shard already sent a record/gap for this LSN.
@@ -1528,6 +1686,10 @@ void ClientReadStream::findGapsAndRecords(bool grace_period_expired,
   // we must have constructed failure domain information at this point
   ld_check(gap_failure_domain_ != nullptr);
 
+  // Used to detect that the low watermark moved so the application can be
+  // notified when out-of-order delivery is enabled.
+  const lsn_t initial_next_lsn_to_deliver = next_lsn_to_deliver_;
+
   // Look at front of the buffer and see what we should do.
   // Returns true if some progress was made.
   auto try_make_progress = [&] {
@@ -1573,6 +1735,23 @@ void ClientReadStream::findGapsAndRecords(bool grace_period_expired,
             0) {
           return false;
         }
+      } else if (rstate->delivered) {
+        // The record here was already delivered to the application out of
+        // order. Account for it in gap detection state and move past it
+        // without delivering it again.
+        unlinkRecordState(next_lsn_to_deliver_, *rstate);
+        ooo_delivered_lsns_.erase(next_lsn_to_deliver_);
+        ++next_lsn_to_deliver_;
+        rstate->reset();
+        buffer_->popFront();
+        buffer_->advanceBufferHead();
+        ld_check(next_lsn_to_deliver_ == buffer_->getBufferHead());
+        if (next_lsn_to_deliver_ > until_lsn_) {
+          // The record with until_lsn_ was delivered out of order;
+          // deliverRecord() and deliverGap() never got a chance to report
+          // completion.
+          deps_->doneCallback(log_id_);
+        }
       } else {
         // No record - must be a gap marker.
         ld_check(rstate->gap);
@@ -1634,6 +1813,18 @@ void ClientReadStream::findGapsAndRecords(bool grace_period_expired,
   if (scd_->isActive()) {
     scd_->checkNeedsRewindIfEveryoneSentGapOrIsFilteredOut();
   }
+
+  if (deliver_out_of_order_ &&
+      next_lsn_to_deliver_ > initial_next_lsn_to_deliver) {
+    // Records below the buffer head can never be delivered again; the
+    // corresponding suppression entries are no longer needed.
+    ooo_delivered_lsns_.erase(
+        ooo_delivered_lsns_.begin(),
+        ooo_delivered_lsns_.lower_bound(next_lsn_to_deliver_));
+    if (low_watermark_cb_) {
+      low_watermark_cb_(log_id_, next_lsn_to_deliver_ - 1);
+    }
+  }
 }
 
 lsn_t ClientReadStream::checkEpochBegin() const {
@@ -1911,6 +2102,7 @@ int ClientReadStream::detectGap(bool grace_period_expired) {
     // underreplicated data.
     // NOTE: Not waiting for BRIDGE gaps may skip under-replicated records at
     // the end or beginning of an epoch. See T12057764.
+    maybeRequestEsnDigests();
     grace_period_->activate();
     return -1;
   }
@@ -2848,6 +3040,7 @@ void ClientReadStream::updateCurrentReadSet() {
   // find nodes from storage_set_states_ that are:
   // (1) no longer in the nodeset of epoch metadata
   // (2) no longer in the current cluster configuration
+  size_t num_shards_removed = 0;
   for (auto it = storage_set_states_.begin();
        it != storage_set_states_.end();) {
     const ShardID shard = it->first;
@@ -2875,6 +3068,7 @@ void ClientReadStream::updateCurrentReadSet() {
 
       // Remove it from the map of states
       it = storage_set_states_.erase(it);
+      ++num_shards_removed;
     } else {
       ++it;
     }
@@ -2970,6 +3164,15 @@ void ClientReadStream::updateCurrentReadSet() {
     return;
   }
 
+  if (any_start_sent_ && (num_shards_removed > 0 || !added_shards.empty())) {
+    // The read set changed while reading and we reconciled it incrementally:
+    // only the delta shards get a START/STOP and the buffer is kept. Track
+    // how much buffered data a full rewind would have discarded and
+    // re-fetched.
+    WORKER_STAT_INCR(rewind_avoided);
+    WORKER_STAT_ADD(rewind_avoided_bytes, bytes_buffered_);
+  }
+
   // Send START to the new shards.
   for (SenderState& state : added_shards) {
     sendStart(state.getShardID(), state);
@@ -3339,6 +3542,19 @@ int ClientReadStream::deliverRecord(
   last_received_ts_ = std::chrono::duration_cast<std::chrono::milliseconds>(
       std::chrono::system_clock::now().time_since_epoch());
 
+  // If we're delivering at the release tail (rather than catching up on
+  // backlog), now minus the sequencer's stamp is the end-to-end
+  // write-visibility latency of this record. Clock skew between the
+  // sequencer and this client can make the difference negative.
+  if (lsn >= last_released_ && last_in_record_ts_.count() > 0) {
+    const int64_t visibility_usec =
+        (last_received_ts_.count() - last_in_record_ts_.count()) * 1000;
+    if (visibility_usec >= 0) {
+      CLIENT_HISTOGRAM_ADD(
+          Worker::stats(), write_to_deliver_latency, visibility_usec);
+    }
+  }
+
   OffsetMap current_offsets = OffsetMap::fromRecord(record->attrs.offsets);
   OffsetMap payload_size_map;
   // TODO(T33977412) Add record counter offset based on settings
@@ -3430,6 +3646,14 @@ int ClientReadStream::deliverRecord(
       // lsn appropriately in that case.
       last_delivered_lsn_ = lsn;
     }
+    if (last_rewind_at_.has_value()) {
+      // First record delivered since the last rewind; record how long the
+      // rewind stalled delivery.
+      CLIENT_HISTOGRAM_ADD(Worker::stats(),
+                           read_stream_rewind_stall,
+                           usec_since(last_rewind_at_.value()));
+      last_rewind_at_.reset();
+    }
     if (MetaDataLog::isMetaDataLog(log_id_)) {
       if (wait_for_all_copies_) {
         WORKER_STAT_INCR(metadata_log_records_delivered_wait_for_all);
@@ -3457,6 +3681,8 @@ int ClientReadStream::deliverRecord(
     num_bytes_delivered_ += payload_size_map.getCounter(BYTE_OFFSET);
     // Updating info reg. buffer usage.
     bytes_buffered_ -= payload_size_map.getCounter(BYTE_OFFSET);
+    WORKER_STAT_SUB(
+        read_streams_bytes_buffered, payload_size_map.getCounter(BYTE_OFFSET));
     if (current_offsets.isValid()) {
       accumulated_offsets_ = std::move(current_offsets);
     }
@@ -3469,6 +3695,64 @@ int ClientReadStream::deliverRecord(
   return success ? 0 : -1;
 }
 
+void ClientReadStream::deliverRecordOutOfOrder(lsn_t lsn, RecordState& rstate) {
+  ld_check(deliver_out_of_order_);
+  ld_check(!reader_);
+  ld_check(lsn > next_lsn_to_deliver_);
+  ld_check(rstate.record != nullptr);
+
+  if (rstate.record_corrupted ||
+      (rstate.record->flags_ &
+       (RECORD_Header::HOLE | RECORD_Header::BRIDGE))) {
+    // Hole plugs and bridge records are reported as gaps, in LSN order, and
+    // a corrupted record may yet be replaced by a healthy copy from another
+    // shard. Leave these for the ordered delivery path.
+    return;
+  }
+
+  const size_t payload_size = rstate.record->payload.size();
+
+  inside_callback_ = true;
+  // See the comment in deliverRecord() about this upcast.
+  std::unique_ptr<DataRecord> record_upcast(std::move(rstate.record));
+  bool success = deps_->recordCallback(record_upcast);
+  inside_callback_ = false;
+
+  if (!success) {
+    // The application rejected the record; keep it buffered. It will be
+    // delivered again, in LSN order, once the front of the buffer reaches
+    // it. Don't activate the redelivery timer: the ordered delivery path is
+    // not blocked on this record and should keep making progress.
+    ld_check(record_upcast != nullptr);
+    rstate.record = std::unique_ptr<DataRecordOwnsPayload>(
+        static_cast<DataRecordOwnsPayload*>(record_upcast.release()));
+    if (!MetaDataLog::isMetaDataLog(log_id_)) {
+      WORKER_STAT_INCR(records_redelivery_attempted);
+    }
+    return;
+  }
+
+  rstate.delivered = true;
+  ooo_delivered_lsns_.insert(lsn);
+
+  if (!MetaDataLog::isMetaDataLog(log_id_)) {
+    WORKER_STAT_INCR(records_delivered);
+    WORKER_STAT_INCR(durability_total);
+    if (scd_ && scd_->isActive()) {
+      WORKER_STAT_INCR(records_delivered_scd);
+    } else {
+      WORKER_STAT_INCR(records_delivered_noscd);
+    }
+    WORKER_STAT_ADD(bytes_delivered, payload_size);
+  }
+  num_records_delivered_++;
+  num_bytes_delivered_ += payload_size;
+  // The payload was handed off to the application; it no longer counts
+  // towards this read stream's buffer usage.
+  bytes_buffered_ -= payload_size;
+  WORKER_STAT_SUB(read_streams_bytes_buffered, payload_size);
+}
+
 int ClientReadStream::deliverGap(GapType type, lsn_t lo, lsn_t hi) {
   ld_check(hi <= until_lsn_);
   ld_check(lo <= hi);
@@ -3756,6 +4040,12 @@ void ClientReadStream::updateWindowSize() {
   if (deps_->hasMemoryPressure()) {
     // cut the window size in half
     window_size_ = std::max(size_t(1), window_size_ / 2);
+  } else if (deps_->getSettings().client_adaptive_read_window &&
+             readers_flow_tracer_ != nullptr) {
+    // size the window from observed delivery rate, record sizes and
+    // redelivery activity
+    window_size_ = readers_flow_tracer_->suggestWindowSize(
+        window_size_, buffer_->capacity());
   } else {
     // increment window size but not more than what the buffer can hold
     window_size_ = std::min(buffer_->capacity(), window_size_ + 1);
@@ -3952,6 +4242,8 @@ ClientReadStream::~ClientReadStream() {
   if (started_) {
     TAGGED_STAT_DECR(Worker::stats(), monitoring_tags_, num_read_streams);
   }
+  // Whatever is still buffered dies with the stream.
+  WORKER_STAT_SUB(read_streams_bytes_buffered, bytes_buffered_);
 
   // Not safe to destroy while executing a callback
   ld_check(!inside_callback_);
@@ -4127,7 +4419,11 @@ void ClientReadStream::handleStartPROTONOSUPPORT(ShardID shard_id) {
 void ClientReadStream::scheduleRewind(RewindReason reason,
                                       std::string reason_str) {
   ld_check(!reason_str.empty());
+  const bool was_scheduled = rewind_scheduler_->isScheduled();
   rewind_scheduler_->schedule(std::move(reason_str));
+  if (!was_scheduled && !rewind_imminent_) {
+    rewind_scheduled_at_ = std::chrono::steady_clock::now();
+  }
 
   if (!rewind_imminent_) {
     WORKER_STAT_INCR(rewind_scheduled);
@@ -4225,6 +4521,16 @@ void ClientReadStream::rewind(std::string reason) {
     SenderState& state = it.second;
     state.blacklist_state = SenderState::BlacklistState::NONE;
 
+    // ESN digests describe positions from before the rewind; drop them.
+    // Replies to in-flight requests will be rejected by the filter version
+    // check in onEsnDigest().
+    state.digest_epoch = EPOCH_INVALID;
+    state.digest_start_esn = ESN_INVALID;
+    state.digest_num_esns = 0;
+    state.digest_bitmap.clear();
+    state.digest_bitmap.shrink_to_fit();
+    state.esn_digest_pending = false;
+
     if (scd_ && was_in_all_send_all && scd_->isActive()) {
       // Rewinding from all send all to scd. Known down list was cleared.
       // Let's repopulate it before rewinding, to avoid having to rewind again
@@ -4313,6 +4619,15 @@ void ClientReadStream::rewind(std::string reason) {
 
   WORKER_STAT_INCR(rewind_done);
 
+  if (rewind_scheduled_at_.has_value()) {
+    CLIENT_HISTOGRAM_ADD(Worker::stats(),
+                         read_stream_rewind_delay,
+                         usec_since(rewind_scheduled_at_.value()));
+    rewind_scheduled_at_.reset();
+  }
+  // Start measuring how long it takes for delivery to resume.
+  last_rewind_at_ = std::chrono::steady_clock::now();
+
   if (scd_ && scd_->isActive()) {
     RATELIMIT_INFO(
         std::chrono::seconds(1),
@@ -4710,6 +5025,19 @@ int ClientReadStreamDependencies::sendWindowMessage(ShardID shard,
   return w->sender().sendMessage(std::move(msg), shard.asNodeID());
 }
 
+int ClientReadStreamDependencies::sendEsnDigestRequest(
+    ShardID shard,
+    GET_ESN_DIGEST_Header header) {
+  auto w = Worker::onThisThread();
+  ld_check(w);
+
+  header.log_id = log_id_;
+  header.read_stream_id = read_stream_id_;
+
+  auto msg = std::make_unique<GET_ESN_DIGEST_Message>(header);
+  return w->sender().sendMessage(std::move(msg), shard.asNodeID());
+}
+
 void ClientReadStreamDependencies::dispose() {
   Worker::onThisThread()->clientReadStreams().erase(read_stream_id_);
 }
@@ -29,7 +29,9 @@
 #include "logdevice/common/Timer.h"
 #include "logdevice/common/client_read_stream/ClientReadStreamSenderState.h"
 #include "logdevice/common/client_read_stream/RewindScheduler.h"
+#include "logdevice/common/protocol/ESN_DIGEST_Message.h"
 #include "logdevice/common/protocol/GAP_Message.h"
+#include "logdevice/common/protocol/GET_ESN_DIGEST_Message.h"
 #include "logdevice/common/protocol/START_Message.h"
 #include "logdevice/common/protocol/WINDOW_Message.h"
 #include "logdevice/common/settings/Settings.h"
@@ -219,6 +221,14 @@ class ClientReadStreamDependencies {
                                 lsn_t window_low,
                                 lsn_t window_high);
 
+  /**
+   * Sends a message to a storage shard requesting an ESN presence digest;
+   * log ID and read stream ID will be filled in. The reply, if any, comes
+   * back through ClientReadStream::onEsnDigest().
+   */
+  virtual int sendEsnDigestRequest(ShardID shard,
+                                   GET_ESN_DIGEST_Header header);
+
   /**
    * Call the application-supplied callback to deliver a record.
    */
@@ -421,6 +431,15 @@ struct ClientReadStreamRecordState {
    */
   bool filtered_out{false};
 
+  /**
+   * True if the record with this LSN was already delivered to the application
+   * out of order (@see ClientReadStream::deliverRecordsOutOfOrder()). The
+   * marker is kept, with the payload released, so that gap detection does not
+   * report the LSN as lost and the record is not delivered again when the
+   * front of the buffer reaches it.
+   */
+  bool delivered{false};
+
   void reset();
 };
 
@@ -506,6 +525,18 @@ class ClientReadStream : boost::noncopyable {
    */
   void onGap(ShardID shard, const GAP_Message& msg);
 
+  /**
+   * Called by a worker thread when an ESN_DIGEST message is received from a
+   * server, in response to an earlier GET_ESN_DIGEST request.
+   */
+  void onEsnDigest(ShardID shard, const ESN_DIGEST_Message& msg);
+
+  /**
+   * Called when a GET_ESN_DIGEST message could not be sent to a shard, so a
+   * new request may be issued later.
+   */
+  void onEsnDigestRequestFailed(ShardID shard);
+
   /**
    * Helper method, sends a WINDOW message to a single storage shard.  This is
    * called as part of a window update (when the update is broadcast to all
@@ -576,6 +607,31 @@ class ClientReadStream : boost::noncopyable {
     do_not_skip_partially_trimmed_sections_ = true;
   }
 
+  /**
+   * Deliver data records to recordCallback() as soon as they are received
+   * from storage shards instead of buffering them until all records with
+   * smaller LSNs have been delivered. Gaps are still reported in LSN order
+   * and no record is delivered twice, but records may be delivered out of
+   * LSN order, so this is only suitable for applications that consume
+   * records commutatively. Memory usage stays bounded because payloads are
+   * released at delivery time even when one slow shard prevents the buffer
+   * head from advancing.
+   *
+   * `low_watermark_cb', if provided, is invoked (on the same thread as
+   * recordCallback()) when the read stream determines that all records and
+   * gaps up to and including a given LSN have been delivered; applications
+   * should use that LSN when saving their read position.
+   *
+   * Only supported with callback-based delivery. Must not be called after
+   * start().
+   */
+  void deliverRecordsOutOfOrder(std::function<void(logid_t, lsn_t)> cb) {
+    ld_check(!started_);
+    ld_check(!reader_);
+    deliver_out_of_order_ = true;
+    low_watermark_cb_ = std::move(cb);
+  }
+
   /**
    * Ship records even if their contents do not match their checksum.
    * If the user is interested in receiving all copies that have a bad checksum,
@@ -933,6 +989,16 @@ class ClientReadStream : boost::noncopyable {
    */
   int deliverRecord(std::unique_ptr<DataRecordOwnsPayload>& record);
 
+  /**
+   * Attempts to deliver a record above next_lsn_to_deliver_ to the
+   * application right away (@see deliverRecordsOutOfOrder()). On success the
+   * payload is released and the buffer slot is marked `delivered' so that
+   * the record is not shipped again when the front of the buffer reaches it.
+   * If the application rejects the record, it stays buffered and will be
+   * delivered in LSN order later.
+   */
+  void deliverRecordOutOfOrder(lsn_t lsn, RecordState& rstate);
+
   /**
    * Attempts to delivers parameter gap record.
    *
@@ -1067,6 +1133,27 @@ class ClientReadStream : boost::noncopyable {
    */
   void updateGapState(lsn_t next_lsn, SenderState& state);
 
+  /**
+   * If the read-stream-esn-digests setting is on, sends GET_ESN_DIGEST
+   * requests to shards that haven't chimed in at next_lsn_to_deliver_ yet
+   * (GapState::NONE), so that their absent ESNs can be accounted for in bulk
+   * instead of waiting for individual GAP messages. Called when gap detection
+   * finds a gap candidate but no f-majority yet, right before arming the
+   * grace period. At most one request per shard is kept in flight, and shards
+   * whose stored digest already covers next_lsn_to_deliver_ are skipped.
+   */
+  void maybeRequestEsnDigests();
+
+  /**
+   * Consults state's stored ESN digest (if any) at the sender's current
+   * position: if the digest says the shard has no entries for a run of ESNs
+   * starting there, advances the shard's gap state past the run via
+   * updateGapState(), as if a GAP message for the run had been received.
+   * Called when a digest arrives and after each record delivered by the
+   * sender, since each delivery moves the sender's position.
+   */
+  void applyEsnDigest(SenderState& state);
+
   /**
    * Called whe we found a DATALOSS gap. Returns true if we should rewind
    * because when SCD is in use, there is a possible race condition that causes
@@ -1534,6 +1621,20 @@ class ClientReadStream : boost::noncopyable {
   // @see shipCorruptedRecords
   bool ship_corrupted_records_ = false;
 
+  // @see deliverRecordsOutOfOrder
+  bool deliver_out_of_order_ = false;
+
+  // Invoked when next_lsn_to_deliver_ advances while out-of-order delivery
+  // is enabled. @see deliverRecordsOutOfOrder
+  std::function<void(logid_t, lsn_t)> low_watermark_cb_;
+
+  // LSNs >= next_lsn_to_deliver_ of records that were delivered out of
+  // order. Used to suppress duplicate deliveries of copies that arrive after
+  // a rewind cleared the buffer (and with it the `delivered' markers).
+  // Entries are erased as next_lsn_to_deliver_ moves past them, so the size
+  // is bounded by the buffer capacity.
+  std::set<lsn_t> ooo_delivered_lsns_;
+
   folly::small_vector<std::string> monitoring_tags_;
 
   // Reader object to deliver to when not using callbacks.  Null if using
@@ -1618,6 +1719,16 @@ class ClientReadStream : boost::noncopyable {
   // is used to avoid updating rewind-scheduling stats in this situation.
   bool rewind_imminent_ = false;
 
+  // Time at which the currently scheduled rewind was first requested, if any.
+  // Used to measure how long rewinds stay scheduled before they execute
+  // (includes the adaptive delay applied by RewindScheduler).
+  folly::Optional<std::chrono::steady_clock::time_point> rewind_scheduled_at_;
+
+  // Time at which the last rewind executed, if no record has been delivered
+  // since. Used to measure how long the stream stalls after a rewind before
+  // delivery resumes with the new filtered out list.
+  folly::Optional<std::chrono::steady_clock::time_point> last_rewind_at_;
+
   // When the clientReadStream receives a STARTED_Message with an E::ACCESS
   // error from any storage shard in the current readset, permission_denied_ is
   // set to true indicating that all outgoing data/gap records (if any) will
@@ -22,7 +22,10 @@ RecordState* ClientReadStreamCircularBuffer::createOrGet(lsn_t lsn) {
   if (!LSNInBuffer(lsn)) {
     return nullptr;
   }
-  return &buffer_[getIndex(lsn)];
+  const size_t index = getIndex(lsn);
+  // The caller may place a marker in the slot; it is no longer known empty.
+  first_marker_hint_ = std::min(first_marker_hint_, index);
+  return &buffer_[index];
 }
 
 RecordState* ClientReadStreamCircularBuffer::find(lsn_t lsn) {
@@ -31,7 +34,7 @@ RecordState* ClientReadStreamCircularBuffer::find(lsn_t lsn) {
   }
 
   RecordState& state = buffer_[getIndex(lsn)];
-  if (!state.record && !state.gap && !state.filtered_out) {
+  if (!state.record && !state.gap && !state.filtered_out && !state.delivered) {
     // this is an empty placeholder RecordState, treat it as not
     // exist
     ld_check(state.list.empty());
@@ -48,8 +51,11 @@ ClientReadStreamCircularBuffer::findFirstMarker() {
   size_t limit =
       std::min(capacity(), LSN_MAX - std::max(buffer_head_, 1lu) + 1);
 
-  for (size_t i = 0; i < limit; ++i) {
-    if (buffer_[i].gap || buffer_[i].record || buffer_[i].filtered_out) {
+  // slots below first_marker_hint_ are known to be empty, start there
+  for (size_t i = std::min(first_marker_hint_, limit); i < limit; ++i) {
+    if (buffer_[i].gap || buffer_[i].record || buffer_[i].filtered_out ||
+        buffer_[i].delivered) {
+      first_marker_hint_ = i;
       return std::make_pair(&buffer_[i], getLSN(i));
     }
     // for slot that is not a record/gap marker, its list must be
@@ -58,12 +64,13 @@ ClientReadStreamCircularBuffer::findFirstMarker() {
   }
 
   // no gap/record marker in buffer
+  first_marker_hint_ = limit;
   return std::make_pair(nullptr, LSN_INVALID);
 }
 
 ClientReadStreamRecordState* ClientReadStreamCircularBuffer::front() {
   if (buffer_.front().record || buffer_.front().gap ||
-      buffer_.front().filtered_out) {
+      buffer_.front().filtered_out || buffer_.front().delivered) {
     return &buffer_.front();
   }
 
@@ -77,6 +84,8 @@ void ClientReadStreamCircularBuffer::popFront() {
   ld_check(!buffer_.front().record && !buffer_.front().filtered_out);
   ld_check(buffer_.front().list.empty());
   buffer_.front().reset();
+  // the front slot is now empty
+  first_marker_hint_ = std::max(first_marker_hint_, 1ul);
 }
 
 void ClientReadStreamCircularBuffer::advanceBufferHead(size_t offset) {
@@ -88,19 +97,21 @@ void ClientReadStreamCircularBuffer::advanceBufferHead(size_t offset) {
         std::min(std::min(offset, capacity()), LSN_MAX - buffer_head_ + 1);
     for (size_t i = 0; i < limit; ++i) {
       ld_check(!buffer_[i].gap && !buffer_[i].record &&
-               !buffer_[i].filtered_out);
+               !buffer_[i].filtered_out && !buffer_[i].delivered);
       ld_check(buffer_[i].list.empty());
     }
   }
 
   buffer_.rotate(offset);
   buffer_head_ += offset;
+  first_marker_hint_ -= std::min(first_marker_hint_, offset);
 }
 
 void ClientReadStreamCircularBuffer::clear() {
   for (size_t i = 0; i < buffer_.size(); ++i) {
     buffer_[i].reset();
   }
+  first_marker_hint_ = 0;
 }
 
 void ClientReadStreamCircularBuffer::forEachUpto(
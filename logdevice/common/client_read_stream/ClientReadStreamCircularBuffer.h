@@ -34,7 +34,10 @@ class ClientReadStreamCircularBuffer : public ClientReadStreamBuffer {
   ClientReadStreamRecordState* find(lsn_t lsn) override;
 
   // see ClientReadStreamBuffer::findFirstMarker()
-  // complexity O(n) in which n is the number of descriptor slots in the buffer
+  // complexity O(n) in which n is the number of descriptor slots in the
+  // buffer; amortized O(1) while records arrive in LSN order (e.g., reading
+  // with single-copy delivery from a single storage shard), as the scan
+  // resumes from first_marker_hint_ instead of rescanning the empty prefix
   std::pair<ClientReadStreamRecordState*, lsn_t> findFirstMarker() override;
 
   // see ClientReadStreamBuffer::front()
@@ -96,6 +99,12 @@ class ClientReadStreamCircularBuffer : public ClientReadStreamBuffer {
   CircularBuffer<ClientReadStreamRecordState> buffer_;
   // tracks the buffer head
   lsn_t buffer_head_;
+  // Lower bound on the index of the first slot that may hold a marker: every
+  // slot below it was observed empty by a previous findFirstMarker() scan and
+  // no descriptor for it has been handed out since (createOrGet() lowers the
+  // bound). Keeps findFirstMarker() from rescanning the empty prefix of the
+  // buffer on every call when records arrive in LSN order.
+  size_t first_marker_hint_{0};
 };
 
 }} // namespace facebook::logdevice
@@ -196,6 +196,33 @@ void ClientReadStreamFailureDetector::onWindowSlid(
 
 void ClientReadStreamFailureDetector::onShardNextLsnChanged(ShardID shard,
                                                             lsn_t next) {
+  // This is called for every record and gap received. In steady state (long
+  // runs of records coming from one shard, e.g. with sticky copysets) the
+  // shard almost never crosses a window boundary, so avoid reading the clock
+  // and doing the full bookkeeping unless it did.
+  SCOPE_EXIT_CHECK_CONSISTENCY();
+  auto it_m = shards_.find(shard);
+  if (it_m == shards_.end()) {
+    // This shard is not in the tracking set.
+    return;
+  }
+
+  // be robust against ClientReadStream decreasing next_lsn.
+  if (next <= it_m->second.next_lsn) {
+    return;
+  }
+
+  const lsn_t prev_next = it_m->second.next_lsn;
+  bool completed_window = false;
+  windowForEach([&](WindowState& window) {
+    completed_window |= prev_next <= window.hi && next > window.hi;
+  });
+
+  if (!completed_window) {
+    it_m->second.next_lsn = next;
+    return;
+  }
+
   onShardNextLsnChanged(shard, next, TS::now());
 }
 
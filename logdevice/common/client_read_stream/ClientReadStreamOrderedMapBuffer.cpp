@@ -129,7 +129,8 @@ void ClientReadStreamOrderedMapBuffer::forEach(
     }
 
     done = !cb(cur->first, cur->second);
-    if (!cur->second.record && !cur->second.gap && !cur->second.filtered_out) {
+    if (!cur->second.record && !cur->second.gap && !cur->second.filtered_out &&
+        !cur->second.delivered) {
       ld_check(cur->second.list.empty());
       map_.erase(cur);
     }
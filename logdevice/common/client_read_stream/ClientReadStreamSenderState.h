@@ -9,6 +9,7 @@
 
 #include <chrono>
 #include <memory>
+#include <vector>
 
 #include <boost/noncopyable.hpp>
 #include <folly/IntrusiveList.h>
@@ -155,6 +156,27 @@ class ClientReadStreamSenderState : boost::noncopyable {
    */
   lsn_t under_replicated_until = LSN_INVALID;
 
+  /**
+   * The most recent ESN presence digest received from this shard, covering
+   * ESNs [digest_start_esn, digest_start_esn + digest_num_esns) of epoch
+   * digest_epoch. Bit i of digest_bitmap (bit (i % 8) of byte i / 8) is set
+   * iff the shard had a copyset index entry for ESN digest_start_esn + i.
+   * A clear bit means the shard has nothing to send for that ESN, which
+   * counts towards the f-majority for gap detection just like an explicit
+   * GAP message would. Cleared on rewind.
+   */
+  epoch_t digest_epoch = EPOCH_INVALID;
+  esn_t digest_start_esn = ESN_INVALID;
+  uint32_t digest_num_esns = 0;
+  std::vector<uint8_t> digest_bitmap;
+
+  /**
+   * True if a GET_ESN_DIGEST request to this shard is in flight. At most one
+   * request per shard is outstanding; cleared when the reply arrives or the
+   * request fails to send.
+   */
+  bool esn_digest_pending = false;
+
   // Pointer to owner
   ClientReadStream* client_read_stream_;
 
@@ -562,6 +562,32 @@ bool parsePrincipals(const folly::dynamic& clusterMap,
       return false;
     }
 
+    // "max_read_rate" and "max_append_rate" are optional throughput
+    // ceilings; see PrincipalThrottle.h.
+    for (const auto& field :
+         {std::make_pair("max_read_rate", &map_entry->max_read_rate),
+          std::make_pair("max_append_rate", &map_entry->max_append_rate)}) {
+      std::string rate_str;
+      successful = getStringFromMap(principal, field.first, rate_str);
+      if (successful) {
+        if (parse_rate_limit(rate_str.c_str(), field.second) != 0) {
+          ld_error("Invalid \"%s\" entry \"%s\" for principal \"%s\". "
+                   "Expected \"<count>/<duration>\", e.g. \"100M/1s\".",
+                   field.first,
+                   rate_str.c_str(),
+                   name.c_str());
+          err = E::INVALID_CONFIG;
+          return false;
+        }
+      } else if (err != E::NOTFOUND) {
+        ld_error("\"%s\" must be a string entry within principal \"%s\".",
+                 field.first,
+                 name.c_str());
+        err = E::INVALID_CONFIG;
+        return false;
+      }
+    }
+
     principals_map.insert({name, map_entry});
   }
 
@@ -93,6 +93,10 @@ void LogsConfigManager::onSettingsUpdated() {
   auto previous_grace_period = publish_grace_period_;
   publish_grace_period_ =
       Worker::onThisThread(true)->settings().logsconfig_manager_grace_period;
+  // Picked up by the next publish; an already-armed cooldown timer keeps its
+  // old duration.
+  publish_cooldown_ =
+      Worker::onThisThread(true)->settings().logsconfig_manager_publish_cooldown;
 
   if (isEnabledInSettings()) {
     if (is_running_) {
@@ -214,12 +218,22 @@ void LogsConfigManager::cancelPublishTimer() {
 }
 
 void LogsConfigManager::activatePublishTimer() {
-  // If grace period is zero we publish the update immediately. We will also
-  // publish immediately if this is the first update.
+  // If grace period is zero we publish the update immediately, unless we
+  // published less than publish_cooldown_ ago. We will also publish
+  // immediately if this is the first update.
   if (publish_grace_period_ == std::chrono::milliseconds::zero() ||
       !is_fully_loaded_) {
     ld_check(!publish_timer_.isActive());
-    updateLogsConfig(getStateMachine()->getState());
+    if (publish_cooldown_timer_.isActive()) {
+      // We are inside the cooldown window that follows a publish. Every
+      // publish clones the whole tree, so during a burst of deltas we fold
+      // all updates into a single publish when the window expires instead of
+      // cloning once per delta.
+      publish_pending_ = true;
+      STAT_INCR(getStats(), logsconfig_manager_publish_coalesced);
+      return;
+    }
+    publishAndArmCooldown();
     return;
   }
 
@@ -245,6 +259,26 @@ void LogsConfigManager::activatePublishTimer() {
   }
 }
 
+void LogsConfigManager::publishAndArmCooldown() {
+  publish_pending_ = false;
+  updateLogsConfig(getStateMachine()->getState());
+  if (publish_cooldown_ == std::chrono::milliseconds::zero()) {
+    // Coalescing is disabled, every update is published as it arrives.
+    return;
+  }
+  if (!publish_cooldown_timer_.isAssigned()) {
+    publish_cooldown_timer_.assign([this] {
+      if (publish_pending_) {
+        // More deltas were applied during the cooldown window. Publish the
+        // current tree and re-arm so that a sustained burst keeps being
+        // coalesced at one publish per window.
+        publishAndArmCooldown();
+      }
+    });
+  }
+  publish_cooldown_timer_.activate(publish_cooldown_);
+}
+
 void LogsConfigManager::stop() {
   if (!is_running_) {
     return;
@@ -252,6 +286,8 @@ void LogsConfigManager::stop() {
   ld_info("Stopping LogsConfig Manager");
   config_updates_handle_.reset();
   cancelPublishTimer();
+  publish_cooldown_timer_.cancel();
+  publish_pending_ = false;
   state_machine_->stop();
   STAT_SET(getStats(), logsconfig_manager_started, 0);
   STAT_SET(getStats(), logsconfig_manager_tree_version, 0);
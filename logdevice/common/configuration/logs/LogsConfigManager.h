@@ -142,6 +142,16 @@ class LogsConfigManager {
   void activatePublishTimer();
   void updateLogsConfig(const logsconfig::LogsConfigTree& tree);
 
+  /**
+   * Publishes the current tree of the state machine and arms the publish
+   * cooldown timer. Updates received while the cooldown timer is active are
+   * coalesced into a single publish when it expires, so that a burst of
+   * deltas (e.g. bulk provisioning of log groups) does not clone the whole
+   * tree once per delta. Only used when the grace period is zero; a non-zero
+   * grace period already batches publishes via publish_timer_.
+   */
+  void publishAndArmCooldown();
+
   /**
    * This is a timer that is used to delay publishing the LogsConfig into the
    * UpdateableLogsConfig. This is configurable via the
@@ -149,6 +159,12 @@ class LogsConfigManager {
    * then we publish the config on every change.
    */
   Timer publish_timer_;
+  /**
+   * Armed after every publish done on the zero-grace-period path, for the
+   * duration of the logsconfig-manager-publish-cooldown setting. While it is
+   * active, further updates only set publish_pending_.
+   */
+  Timer publish_cooldown_timer_;
   UpdateableSettings<Settings> settings_;
   std::shared_ptr<UpdateableConfig> updateable_config_;
   std::unique_ptr<LogsConfigStateMachine> state_machine_;
@@ -160,7 +176,11 @@ class LogsConfigManager {
   // Is the RSM running? Only updated and checked in Worker thread.
   bool is_running_ = false;
   bool is_fully_loaded_ = false;
+  // An update arrived while publish_cooldown_timer_ was active; publish it
+  // when the timer fires.
+  bool publish_pending_ = false;
   std::chrono::milliseconds publish_grace_period_{0};
+  std::chrono::milliseconds publish_cooldown_{0};
 
   UpdateableSettings<Settings>::SubscriptionHandle settings_update_handle_;
 };
@@ -1253,6 +1253,7 @@ void LogsConfigTree::updateLookupIndex(const DirectoryNode* parent,
   logs_index_.insert(
       logs_index_.end(),
       std::make_pair(interval, LogGroupInDirectory{log_group, parent}));
+  invalidateCompiledIndex();
 }
 
 bool LogsConfigTree::deleteLogGroupFromLookupIndex(const logid_range_t& range) {
@@ -1270,6 +1271,7 @@ bool LogsConfigTree::deleteLogGroupFromLookupIndex(const logid_range_t& range) {
   }
   // clears that interval from the index
   logs_index_.erase(iter->first);
+  invalidateCompiledIndex();
   return true;
 }
 
@@ -1297,9 +1299,57 @@ void LogsConfigTree::rebuildIndexForDir(const DirectoryNode* dir,
 
 void LogsConfigTree::rebuildIndex() {
   logs_index_.clear();
+  invalidateCompiledIndex();
   rebuildIndexForDir(root_.get(), false);
 }
 
+void LogsConfigTree::compileLogRangeIndex() const {
+  std::lock_guard<std::mutex> guard(compile_mutex_);
+  if (compiled_ranges_valid_.load(std::memory_order_relaxed)) {
+    // another thread compiled the index while we were waiting for the lock
+    return;
+  }
+  std::vector<CompiledLogRange> compiled;
+  compiled.reserve(logs_index_.iterative_size());
+  // interval_map iterates its segments in increasing interval order, so the
+  // resulting array is already sorted by lower bound.
+  for (const auto& entry : logs_index_) {
+    compiled.push_back(
+        CompiledLogRange{entry.first.lower(), entry.first.upper(),
+                         &entry.second});
+  }
+  compiled_ranges_ = std::move(compiled);
+  compiled_ranges_valid_.store(true, std::memory_order_release);
+}
+
+const LogGroupInDirectory*
+LogsConfigTree::getLogGroupByID(const logid_t& logid) const {
+  if (!compiled_ranges_valid_.load(std::memory_order_acquire)) {
+    compileLogRangeIndex();
+  }
+  const logid_t::raw_type id = logid.val();
+  size_t len = compiled_ranges_.size();
+  if (len == 0) {
+    err = E::NOTFOUND;
+    return nullptr;
+  }
+  // Binary search for the last range whose lower bound is <= id. The step
+  // is written so the compiler emits a conditional move rather than a
+  // branch; with ranges scattered across 100k+ logs the branch would be
+  // unpredictable and dominate the lookup.
+  const CompiledLogRange* base = compiled_ranges_.data();
+  while (len > 1) {
+    const size_t half = len / 2;
+    base += (base[half].lower <= id) ? half : 0;
+    len -= half;
+  }
+  if (id >= base->lower && id < base->upper) {
+    return base->group;
+  }
+  err = E::NOTFOUND;
+  return nullptr;
+}
+
 ReplicationProperty LogsConfigTree::getNarrowestReplication() const {
   return root_->getNarrowestReplication();
 }
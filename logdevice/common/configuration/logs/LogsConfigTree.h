@@ -7,10 +7,13 @@
  */
 #pragma once
 
+#include <atomic>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include <boost/icl/interval_map.hpp>
 #include <boost/icl/map.hpp>
@@ -698,28 +701,22 @@ class LogsConfigTree {
   // returns the LogGroupNode that has this logid in its range.
   // The returned structure `LogGroupInDirectory` contains pointer to the log
   // group and its parent directory
-  // this returns nullptr if the logid was not found.
+  // this returns nullptr if the logid was not found (and sets err to
+  // E::NOTFOUND).
   //
-  const LogGroupInDirectory* getLogGroupByID(const logid_t& logid) const {
-    auto iter = logs_index_.find(logid.val());
-    if (iter == logs_index_.end()) {
-      err = E::NOTFOUND;
-      return nullptr;
-    }
-    return &iter->second;
-  }
+  // This goes through a flat sorted copy of the interval index that is
+  // compiled lazily after the tree is mutated, so the per-lookup cost is a
+  // cache-friendly binary search over a contiguous array instead of a walk
+  // of the interval map.
+  const LogGroupInDirectory* getLogGroupByID(const logid_t& logid) const;
 
   std::pair<DirectoryNode*, LogGroupNodePtr>
   getLogGroupAndParent(const std::string& path) const;
 
   // returns true if the logid exists in the tree
   bool logExists(logid_t logid) const {
-    auto iter = logs_index_.find(logid.val());
-    if (iter == logs_index_.end()) {
-      err = E::NOTFOUND;
-      return false;
-    }
-    return true;
+    // getLogGroupByID() sets err to E::NOTFOUND on a miss
+    return getLogGroupByID(logid) != nullptr;
   }
 
   const LogMap& getLogMap() const {
@@ -859,6 +856,24 @@ class LogsConfigTree {
   // same as rebuildIndexForDir except that this rebuilds the whole tree
   void rebuildIndex();
 
+  // One entry of the compiled lookup index: a right-open logid range and a
+  // pointer to the value stored for it in logs_index_.
+  struct CompiledLogRange {
+    logid_t::raw_type lower; // inclusive
+    logid_t::raw_type upper; // exclusive
+    const LogGroupInDirectory* group;
+  };
+
+  // (Re)builds compiled_ranges_ from logs_index_. Called lazily from
+  // getLogGroupByID() after a mutation invalidated the compiled copy.
+  void compileLogRangeIndex() const;
+
+  // Drops the compiled lookup index. Must be called by every mutation of
+  // logs_index_; the array is rebuilt on the next lookup.
+  void invalidateCompiledIndex() {
+    compiled_ranges_valid_.store(false, std::memory_order_release);
+  }
+
   std::string normalize_path(const std::string& path) const;
   /*
    * Used by print() to print a specific directory level
@@ -895,6 +910,13 @@ class LogsConfigTree {
   // maximum finite backlog duration of a log
   std::chrono::seconds max_backlog_duration_{0};
   LogMap logs_index_;
+  // Flattened, sorted copy of logs_index_ used for logid lookups. Mutations
+  // of the tree only flip compiled_ranges_valid_; the first lookup after a
+  // mutation recompiles the array (under compile_mutex_, since snapshots are
+  // read from many threads). The pointers in it point into logs_index_.
+  mutable std::vector<CompiledLogRange> compiled_ranges_;
+  mutable std::atomic<bool> compiled_ranges_valid_{false};
+  mutable std::mutex compile_mutex_;
   // Max version seen, this is meant to be used if this tree is not backed by
   // LogsConfigManager.
   static std::atomic<uint64_t> max_version;
@@ -462,6 +462,42 @@ std::shared_ptr<const NodesConfiguration> NodesConfiguration::withVersion(
   return config;
 }
 
+std::shared_ptr<const NodesConfiguration>
+NodesConfiguration::shareSubConfigsFrom(
+    std::shared_ptr<const NodesConfiguration> config,
+    const NodesConfiguration& base) {
+  ld_check(config != nullptr);
+  // Membership and attribute versions make the deep comparisons fail fast
+  // for the components that did change.
+  const bool share_svd =
+      config->service_discovery_ != base.service_discovery_ &&
+      compare_obj_ptrs(config->service_discovery_, base.service_discovery_);
+  const bool share_seq = config->sequencer_config_ != base.sequencer_config_ &&
+      compare_obj_ptrs(config->sequencer_config_, base.sequencer_config_);
+  const bool share_sto = config->storage_config_ != base.storage_config_ &&
+      compare_obj_ptrs(config->storage_config_, base.storage_config_);
+  const bool share_meta =
+      config->metadata_logs_rep_ != base.metadata_logs_rep_ &&
+      compare_obj_ptrs(config->metadata_logs_rep_, base.metadata_logs_rep_);
+  if (!share_svd && !share_seq && !share_sto && !share_meta) {
+    return config;
+  }
+  auto shared = std::make_shared<NodesConfiguration>(*config);
+  if (share_svd) {
+    shared->service_discovery_ = base.service_discovery_;
+  }
+  if (share_seq) {
+    shared->sequencer_config_ = base.sequencer_config_;
+  }
+  if (share_sto) {
+    shared->storage_config_ = base.storage_config_;
+  }
+  if (share_meta) {
+    shared->metadata_logs_rep_ = base.metadata_logs_rep_;
+  }
+  return shared;
+}
+
 bool NodesConfiguration::operator==(const NodesConfiguration& rhs) const {
   return equalWithTimestampIgnored(rhs) &&
       last_change_timestamp_ == rhs.last_change_timestamp_;
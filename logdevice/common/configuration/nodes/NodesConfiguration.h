@@ -232,6 +232,20 @@ class NodesConfiguration {
   std::shared_ptr<const NodesConfiguration>
   withVersion(membership::MembershipVersion::Type version) const;
 
+  /**
+   * Returns a config equivalent to `config` that shares the
+   * sub-configuration objects of `base` wherever their contents are equal.
+   * Used after deserializing a freshly propagated config: most updates only
+   * touch one component, so re-pointing the unchanged components at the
+   * currently published objects frees the duplicates built by
+   * deserialization right away and lets consumers holding shared_ptr's
+   * detect "nothing changed for me" with a pointer comparison instead of a
+   * deep one. Returns `config` itself if there is nothing to share.
+   */
+  static std::shared_ptr<const NodesConfiguration>
+  shareSubConfigsFrom(std::shared_ptr<const NodesConfiguration> config,
+                      const NodesConfiguration& base);
+
   bool operator==(const NodesConfiguration& rhs) const;
 
   // same as == operator but with config timestamp ignored
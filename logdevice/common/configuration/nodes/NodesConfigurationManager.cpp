@@ -263,6 +263,26 @@ void NodesConfigurationManager::onNewConfig(std::string new_config) {
         deps()->getStats(), nodes_configuration_manager_serialization_errors);
     return;
   }
+  if (auto current = getConfig()) {
+    // Most config bumps only touch one component. Re-point the unchanged
+    // sub-configurations at the currently published objects so the
+    // duplicates built by deserialization are freed right away and
+    // consumers can recognize unchanged components by pointer.
+    parsed_config_ptr = NodesConfiguration::shareSubConfigsFrom(
+        std::move(parsed_config_ptr), *current);
+    size_t num_shared =
+        (parsed_config_ptr->getServiceDiscovery() ==
+         current->getServiceDiscovery()) +
+        (parsed_config_ptr->getSequencerConfig() ==
+         current->getSequencerConfig()) +
+        (parsed_config_ptr->getStorageConfig() ==
+         current->getStorageConfig()) +
+        (parsed_config_ptr->getMetaDataLogsReplication() ==
+         current->getMetaDataLogsReplication());
+    STAT_ADD(deps_->getStats(),
+             nodes_configuration_manager_subconfigs_shared,
+             num_shared);
+  }
   deps_->reportPropagationLatency(parsed_config_ptr);
   onNewConfig(std::move(parsed_config_ptr));
 }
@@ -954,7 +954,7 @@ void EventLogRebuildingSet::recomputeShardAuthoritativeStatus(
     node_index_t nidx,
     std::chrono::milliseconds timestamp,
     NodeInfo& node_info,
-    std::unordered_set<node_index_t> potential_donors,
+    const std::unordered_set<node_index_t>& storage_nodes,
     std::string* out_comment) const {
   ld_check(out_comment);
   node_info.donors_remaining.clear();
@@ -991,10 +991,16 @@ void EventLogRebuildingSet::recomputeShardAuthoritativeStatus(
     }
   }
 
+  // Nodes that cannot be donors. This function is called for every node of
+  // the shard after every delta, so we collect the exclusions in a side set
+  // (usually small: it only contains members of the rebuilding set) instead
+  // of copying and mutating the cluster-wide set of storage nodes each time.
+  std::unordered_set<node_index_t> excluded_donors;
+
   // Exclude authoritatively completed donors.
   for (auto& n : node_info.donors_complete_authoritatively) {
     if (n.second >= min_auth_complete_version) {
-      potential_donors.erase(n.first);
+      excluded_donors.insert(n.first);
     }
   }
 
@@ -1009,7 +1015,7 @@ void EventLogRebuildingSet::recomputeShardAuthoritativeStatus(
          (!n.second.acked || n.second.ack_lsn > node_info.version)) ||
         (n.second.mode == RebuildingMode::RELOCATE &&
          n.second.auth_status == AuthoritativeStatus::AUTHORITATIVE_EMPTY)) {
-      potential_donors.erase(n.first);
+      excluded_donors.insert(n.first);
     }
   }
 
@@ -1017,14 +1023,20 @@ void EventLogRebuildingSet::recomputeShardAuthoritativeStatus(
   // This excludes nodes restoring a time-range that would otherwise be
   // missed by the loop above.
   if (node_info.mode == RebuildingMode::RESTORE) {
-    ld_check(potential_donors.count(nidx) == 0 ||
+    ld_check(storage_nodes.count(nidx) == 0 ||
+             excluded_donors.count(nidx) != 0 ||
              !node_info.dc_dirty_ranges.empty());
-    potential_donors.erase(nidx);
+    excluded_donors.insert(nidx);
   }
 
   // Find all nodes that still have not rebuilt authoritatively and also have
   // not rebuilt for the current version.
-  for (node_index_t n : potential_donors) {
+  size_t num_potential_donors = 0;
+  for (node_index_t n : storage_nodes) {
+    if (excluded_donors.count(n)) {
+      continue;
+    }
+    ++num_potential_donors;
     auto it = node_info.donors_complete.find(n);
     if (it == node_info.donors_complete.end() ||
         it->second < shard_info.version) {
@@ -1044,7 +1056,7 @@ void EventLogRebuildingSet::recomputeShardAuthoritativeStatus(
     return;
   }
 
-  if (potential_donors.empty()) {
+  if (num_potential_donors == 0) {
     node_info.rebuilding_completed_ts = timestamp;
     node_info.auth_status = AuthoritativeStatus::AUTHORITATIVE_EMPTY;
     *out_comment = "all donors completed authoritatively";
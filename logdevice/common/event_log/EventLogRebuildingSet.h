@@ -384,7 +384,7 @@ class EventLogRebuildingSet {
       node_index_t nidx,
       std::chrono::milliseconds timestamp,
       NodeInfo& node_info,
-      std::unordered_set<node_index_t> storage_nodes,
+      const std::unordered_set<node_index_t>& storage_nodes,
       std::string* out_comment) const;
 
   int onShardNeedsRebuild(
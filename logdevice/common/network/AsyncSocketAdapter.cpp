@@ -140,6 +140,14 @@ void AsyncSocketAdapter::writeChain(WriteCallback* callback,
   transport_->writeChain(callback, std::move(buf), flags);
 }
 
+bool AsyncSocketAdapter::setZeroCopy(bool enable) {
+  return transport_->setZeroCopy(enable);
+}
+
+void AsyncSocketAdapter::setZeroCopyEnableFunc(ZeroCopyEnableFunc func) {
+  transport_->setZeroCopyEnableFunc(std::move(func));
+}
+
 int AsyncSocketAdapter::setSendBufSize(size_t bufsize) {
   return transport_->setSendBufSize(bufsize);
 }
@@ -237,6 +237,20 @@ class AsyncSocketAdapter : public SocketAdapter {
                   std::unique_ptr<folly::IOBuf>&& buf,
                   folly::WriteFlags flags = folly::WriteFlags::NONE) override;
 
+  /**
+   * Enable MSG_ZEROCOPY sends on the underlying AsyncSocket. AsyncSocket
+   * keeps a reference to every chain written zero-copy until the kernel's
+   * SO_EE_ORIGIN_ZEROCOPY completion for it arrives, so callers may drop
+   * their reference as usual once writeChain() returns.
+   */
+  bool setZeroCopy(bool enable) override;
+
+  /**
+   * Set the per-chain predicate AsyncSocket consults to decide whether a
+   * given write goes out zero-copy.
+   */
+  void setZeroCopyEnableFunc(ZeroCopyEnableFunc func) override;
+
   /**
    * Set the send bufsize
    */
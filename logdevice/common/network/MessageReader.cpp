@@ -16,10 +16,7 @@
 
 namespace facebook { namespace logdevice {
 MessageReader::MessageReader(IProtocolHandler& proto_handler, uint16_t proto)
-    : next_buffer_allocation_size_(sizeof(ProtocolHeader)),
-      read_buf_(folly::IOBuf::create(next_buffer_allocation_size_)),
-      proto_handler_(proto_handler),
-      proto_(proto) {}
+    : proto_handler_(proto_handler), proto_(proto) {}
 
 void MessageReader::getReadBuffer(void** bufReturn, size_t* lenReturn) {
   if (!proto_handler_.good()) {
@@ -27,47 +24,118 @@ void MessageReader::getReadBuffer(void** bufReturn, size_t* lenReturn) {
     *lenReturn = 0;
     return;
   }
-  if (expecting_protocol_header_) {
-    ld_check_le(next_buffer_allocation_size_, sizeof(recv_message_ph_));
-    auto offset = sizeof(recv_message_ph_) - next_buffer_allocation_size_;
-    void* ptr =
-        static_cast<uint8_t*>(static_cast<void*>(&recv_message_ph_)) + offset;
-    *bufReturn = ptr;
-    *lenReturn = next_buffer_allocation_size_;
-  } else {
+  if (!expecting_protocol_header_) {
     *bufReturn = read_buf_->writableTail();
     *lenReturn = std::min(read_buf_->tailroom(), next_buffer_allocation_size_);
+    return;
+  }
+  if (!chunk_ || chunk_->tailroom() < sizeof(ProtocolHeader)) {
+    // Start a new chunk. Any bytes left in the old chunk are a partial
+    // protocol header that straddles the chunk boundary; carry them over.
+    // The old chunk itself stays alive for as long as message slices
+    // dispatched out of it do.
+    auto chunk = folly::IOBuf::create(kReadChunkSize);
+    if (chunk_ && chunk_->length() > 0) {
+      ld_check_lt(chunk_->length(), sizeof(ProtocolHeader));
+      memcpy(chunk->writableTail(), chunk_->data(), chunk_->length());
+      chunk->append(chunk_->length());
+    }
+    chunk_ = std::move(chunk);
+  }
+  *bufReturn = chunk_->writableTail();
+  *lenReturn = chunk_->tailroom();
+}
+
+void MessageReader::processChunk() {
+  // Phase 1: parse. Slice every complete message out of the chunk into the
+  // batch without running any handler code in between, so this loop stays
+  // tight and the per-message handler code paths run back to back in phase
+  // 2 instead of evicting each other from the instruction cache.
+  while (proto_handler_.good()) {
+    if (chunk_->length() < sizeof(ProtocolHeader)) {
+      // Partial protocol header, wait for more data.
+      break;
+    }
+    // The chunk data is not guaranteed to be aligned for the packed header.
+    memcpy(&recv_message_ph_, chunk_->data(), sizeof(recv_message_ph_));
+    if (!validateHeader()) {
+      break;
+    }
+    const size_t header_bytes =
+        ProtocolHeader::bytesNeeded(recv_message_ph_.type, proto_);
+    if (recv_message_ph_.len < header_bytes) {
+      folly::AsyncSocketException ex(
+          folly::AsyncSocketException::CORRUPTED_DATA,
+          "Message length in protocol header is smaller than the header.",
+          -1);
+      proto_handler_.notifyErrorOnSocket(ex);
+      break;
+    }
+    if (!ProtocolHeader::needChecksumInHeader(recv_message_ph_.type, proto_)) {
+      // The checksum is absent from the header: those 8 bytes belong to the
+      // message body and immediately precede the rest of it in the chunk.
+      recv_message_ph_.cksum = 0;
+    }
+    const size_t message_len = recv_message_ph_.len - header_bytes;
+    if (chunk_->length() < recv_message_ph_.len) {
+      // The rest of the body hasn't been received yet; consume the header
+      // and switch to reading into a dedicated buffer.
+      chunk_->trimStart(header_bytes);
+      prepareMessageBody(message_len);
+      break;
+    }
+    // The whole message is in the chunk. Queue a slice that shares the
+    // chunk's storage instead of copying the body out.
+    auto body = chunk_->cloneOne();
+    body->trimStart(header_bytes);
+    body->trimEnd(body->length() - message_len);
+    chunk_->trimStart(recv_message_ph_.len);
+    batch_.emplace_back(recv_message_ph_, std::move(body));
+    recv_message_ph_ = ProtocolHeader();
+  }
+  // Phase 2: dispatch everything parsed above, in arrival order.
+  drainPendingMessages();
+}
+
+int MessageReader::drainPendingMessages() {
+  while (!batch_.empty() && proto_handler_.good()) {
+    ProtocolHeader hdr = batch_.front().first;
+    auto body = std::move(batch_.front().second);
+    batch_.pop_front();
+    if (proto_handler_.dispatchMessageBody(hdr, std::move(body)) != 0) {
+      // On NOBUFS the Connection has taken ownership of this message for a
+      // deferred retry and uninstalled the read callback; it calls back into
+      // drainPendingMessages() once the retry succeeds. On other errors the
+      // connection is closing. Either way, stop dispatching so messages
+      // parsed behind the failed one are not delivered out of order.
+      return -1;
+    }
   }
+  return batch_.empty() ? 0 : -1;
 }
 
-void MessageReader::prepareMessageBody() {
-  // Allocate the next read buffer to include current
-  // message's body. If checksum is not present in header,those 8 bytes in
-  // header belong to the message body. Copy the 8 bytes read earlier as part
-  // of ProtocolHeader if necessary, into this newly allocated buffer.
+void MessageReader::prepareMessageBody(size_t message_len) {
+  // Allocate a buffer sized exactly for the rest of the current message's
+  // body and copy in the body bytes already received, which at this point
+  // are all that is left in the chunk. Reading the remainder directly into
+  // this buffer avoids an extra copy for bodies larger than a chunk and
+  // keeps a single huge message from pinning chunk storage.
   expecting_protocol_header_ = false;
-  auto payload_size = recv_message_ph_.len -
-      ProtocolHeader::bytesNeeded(recv_message_ph_.type, proto_);
-  next_buffer_allocation_size_ = payload_size;
-  read_buf_ = folly::IOBuf::create(next_buffer_allocation_size_);
-  // Add the 8 byte of message read if cksum is absent into the read_buf and
-  // move the writableTail().
-  if (!ProtocolHeader::needChecksumInHeader(recv_message_ph_.type, proto_)) {
-    memcpy(read_buf_->writableTail(),
-           &recv_message_ph_.cksum,
-           sizeof(recv_message_ph_.cksum));
-    read_buf_->append(sizeof(recv_message_ph_.cksum));
-    next_buffer_allocation_size_ -= read_buf_->length();
-    recv_message_ph_.cksum = 0;
+  read_buf_ = folly::IOBuf::create(message_len);
+  const size_t prefix = chunk_->length();
+  ld_check_lt(prefix, message_len);
+  if (prefix > 0) {
+    memcpy(read_buf_->writableTail(), chunk_->data(), prefix);
+    read_buf_->append(prefix);
+    chunk_->trimStart(prefix);
   }
-  ld_check_le(next_buffer_allocation_size_, read_buf_->capacity());
+  next_buffer_allocation_size_ = message_len - prefix;
 }
 
 bool MessageReader::validateHeader() {
   // Validate the read header.
   auto retval = proto_handler_.validateProtocolHeader(recv_message_ph_);
   if (!retval) {
-    next_buffer_allocation_size_ = 0;
     folly::AsyncSocketException ex(folly::AsyncSocketException::CORRUPTED_DATA,
                                    "Invalid Protocol Header received.",
                                    -1);
@@ -80,27 +148,23 @@ bool MessageReader::validateHeader() {
 
 void MessageReader::readDataAvailable(size_t len) noexcept {
   ld_check(proto_handler_.good());
-  ld_check_ge(next_buffer_allocation_size_, len);
-  next_buffer_allocation_size_ -= len;
   if (!expecting_protocol_header_) {
+    ld_check_ge(next_buffer_allocation_size_, len);
+    next_buffer_allocation_size_ -= len;
     read_buf_->append(len);
     if (next_buffer_allocation_size_ > 0) {
       return;
     }
     auto message_len = recv_message_ph_.len -
         ProtocolHeader::bytesNeeded(recv_message_ph_.type, proto_);
-    // read_buf_ capacity can be greater than message len but that capacity
-    // should not be used.
-    ld_check_le(message_len, read_buf_->capacity());
     ld_check(read_buf_->length() == message_len);
     proto_handler_.dispatchMessageBody(recv_message_ph_, std::move(read_buf_));
     expecting_protocol_header_ = true;
-    next_buffer_allocation_size_ = sizeof(ProtocolHeader);
     recv_message_ph_ = ProtocolHeader();
-  } else {
-    if (next_buffer_allocation_size_ == 0 && validateHeader()) {
-      prepareMessageBody();
-    }
+    return;
   }
+  ld_check_le(len, chunk_->tailroom());
+  chunk_->append(len);
+  processChunk();
 }
 }} // namespace facebook::logdevice
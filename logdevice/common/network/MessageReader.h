@@ -7,6 +7,9 @@
  */
 
 #pragma once
+#include <deque>
+#include <utility>
+
 #include <folly/io/IOBuf.h>
 #include <folly/io/async/AsyncSocket.h>
 #include <folly/io/async/AsyncSocketException.h>
@@ -19,24 +22,32 @@ namespace facebook { namespace logdevice {
  * MessageReader is installed in AsyncSocket to receive data read from
  * socket and forward it to Connection for further processing.
  *
- * Reader is in two states it's receiving protocol header or receiving a
- * message body. First thing received on the socket is the protocol header,
- * followed by message body and so on and so forth.
+ * Data is read from the socket in large chunks so that a single recv()
+ * typically pulls in many messages, instead of issuing one syscall for
+ * every protocol header and another for every message body. Each chunk is
+ * a refcounted IOBuf; every complete message body found in a chunk is
+ * dispatched as a slice that shares the chunk's storage, so no
+ * per-message copy is made. The chunk stays alive until all messages
+ * dispatched out of it have been destroyed.
  *
- * Reader maintains a buffer which it shares with AsyncSocket and all the
- * data is read into this buffer. The size of this buffer allocation depends on
- * the state we are in currently. The first buffer allocated has size equal to
- * the protocol header size. Once a protocol header is read, we save it in the
- * member variable and allocate a buffer to read in the message payload.
+ * Two cases fall back to dedicated buffers. A message body that extends
+ * past the bytes received so far is read directly into an exactly-sized
+ * buffer: this avoids an extra copy for bodies larger than a chunk and
+ * keeps a single huge message from pinning chunk storage. A protocol
+ * header that straddles a chunk boundary is carried over into the next
+ * chunk.
  *
- * On invoking getReadBuffer,  based on the state whether we are reading the
- * header or the tail , return the right buffer and remaining message
- * length or protocol header length to be read into the buffer to asyncsocket.
+ * On invoking getReadBuffer, based on the state, return either the tail
+ * of the current chunk or the remainder of the dedicated body buffer to
+ * asyncsocket.
  *
- * On invoking readDataAvailable, check if the header or message body was read
- * completely. If we were expecting header and it was read completely allocate a
- * new buffer using the message len in header. If the message was read
- * completely, dispatch the message forward for processing.
+ * On invoking readDataAvailable, parse as many complete messages out of
+ * the chunk as possible, collecting them into a batch, and then dispatch
+ * the batch forward for processing. Parsing and dispatch run as separate
+ * phases so that the header-parsing loop and the per-message handler code
+ * each stay hot in the instruction cache instead of evicting one another
+ * on every message. Messages are dispatched strictly in arrival order:
+ * the protocol is order-sensitive, so the batch is never regrouped.
  */
 class MessageReader : public folly::AsyncSocket::ReadCallback {
  public:
@@ -65,15 +76,40 @@ class MessageReader : public folly::AsyncSocket::ReadCallback {
     proto_handler_.notifyErrorOnSocket(ex);
   }
 
+  /**
+   * Dispatches parsed messages in arrival order, stopping at the first
+   * dispatch that fails. Called after parsing a chunk, and by Connection
+   * after a message whose dispatch hit NOBUFS has been retried, to deliver
+   * the messages that were parsed behind it.
+   *
+   * @return 0 if the batch was fully dispatched, -1 if a dispatch failed
+   *         (the failed message is owned by Connection's retry machinery
+   *         at that point; the rest stay queued).
+   */
+  int drainPendingMessages();
+
  private:
-  void expectProtocolHeader();
-  void expectMessageBody();
+  void processChunk();
   bool validateHeader();
-  void prepareMessageBody();
+  void prepareMessageBody(size_t message_len);
+
+  // Size of the chunks that socket data is read into. Large enough that a
+  // single read typically drains the socket buffer and covers many messages.
+  static constexpr size_t kReadChunkSize = 64 * 1024;
 
   bool expecting_protocol_header_{true};
-  size_t next_buffer_allocation_size_;
+  // Bytes of the current message body still to be read into read_buf_.
+  // Meaningful only when expecting_protocol_header_ is false.
+  size_t next_buffer_allocation_size_{0};
+  // Chunk that socket data is read into while parsing headers. Message
+  // slices dispatched out of it share its storage.
+  std::unique_ptr<folly::IOBuf> chunk_;
+  // Dedicated buffer for a message body that extends past the current chunk.
   std::unique_ptr<folly::IOBuf> read_buf_;
+  // Messages parsed out of the chunk but not yet dispatched. Non-empty
+  // between the parse and dispatch phases, and across a NOBUFS-triggered
+  // dispatch pause.
+  std::deque<std::pair<ProtocolHeader, std::unique_ptr<folly::IOBuf>>> batch_;
   ProtocolHeader recv_message_ph_;
   IProtocolHandler& proto_handler_;
   uint16_t proto_;
@@ -26,6 +26,7 @@ class SocketAdapter {
   using ReadCallback = folly::AsyncSocket::ReadCallback;
   using WriteCallback = folly::AsyncSocket::WriteCallback;
   using ConnectCallback = folly::AsyncSocket::ConnectCallback;
+  using ZeroCopyEnableFunc = folly::AsyncSocket::ZeroCopyEnableFunc;
   SocketAdapter() {}
 
   virtual ~SocketAdapter() {}
@@ -178,6 +179,28 @@ class SocketAdapter {
              std::unique_ptr<folly::IOBuf>&& buf,
              folly::WriteFlags flags = folly::WriteFlags::NONE) = 0;
 
+  /**
+   * Request zero-copy (MSG_ZEROCOPY) sends on this transport. Qualifying
+   * write chains are then handed to the kernel by reference and their
+   * buffers released only once the NIC reports the transmit complete,
+   * instead of being copied into socket memory. Transports that cannot do
+   * zero-copy sends ignore the request and keep copying.
+   *
+   * @return true iff zero-copy is enabled on the underlying socket. May
+   *         return false for sockets that are not connected yet even when
+   *         the request is remembered and applied at connect time.
+   */
+  virtual bool setZeroCopy(bool /* enable */) {
+    // By default copy - leave it to implementers to override.
+    return false;
+  }
+
+  /**
+   * Set the function deciding per write chain whether it is sent zero-copy.
+   * Only consulted after a successful setZeroCopy(true).
+   */
+  virtual void setZeroCopyEnableFunc(ZeroCopyEnableFunc /* func */) {}
+
   /**
    * Set the send bufsize
    */
@@ -18,6 +18,81 @@
 
 namespace facebook { namespace logdevice {
 
+folly::Synchronized<
+    std::shared_ptr<const WeightAwareNodeSetSelector::CandidateList>>&
+WeightAwareNodeSetSelector::candidatesCache() {
+  static folly::Synchronized<std::shared_ptr<const CandidateList>> cache;
+  return cache;
+}
+
+std::shared_ptr<const WeightAwareNodeSetSelector::CandidateList>
+WeightAwareNodeSetSelector::getCandidates(
+    const configuration::nodes::NodesConfiguration& nodes_configuration,
+    NodeLocationScope replication_scope) {
+  const auto version = nodes_configuration.getVersion();
+  const uint64_t storage_nodes_hash = nodes_configuration.getStorageNodesHash();
+  {
+    auto cached = candidatesCache().rlock();
+    if (*cached != nullptr && (*cached)->version == version &&
+        (*cached)->storage_nodes_hash == storage_nodes_hash &&
+        (*cached)->replication_scope == replication_scope) {
+      return *cached;
+    }
+  }
+
+  auto list = std::make_shared<CandidateList>();
+  list->version = version;
+  list->storage_nodes_hash = storage_nodes_hash;
+  list->replication_scope = replication_scope;
+
+  const auto& membership = nodes_configuration.getStorageMembership();
+  for (const auto node : *membership) {
+    // Filter nodes that opted out of nodesets entirely; per-shard filters
+    // are applied per log, once the log's shard index is known.
+    if (nodes_configuration.getNodeStorageAttribute(node)
+            ->exclude_from_nodesets) {
+      continue;
+    }
+
+    const auto num_shards = nodes_configuration.getNumShards(node);
+    ld_check(num_shards > 0);
+
+    const auto* sd = nodes_configuration.getNodeServiceDiscovery(node);
+    ld_check(sd != nullptr);
+
+    std::string location_str;
+    if (replication_scope == NodeLocationScope::ROOT) {
+      // All nodes are in the same replication domain.
+    } else {
+      if (!sd->location.has_value()) {
+        ld_error("Can't select nodeset because node %d (%s) does not have "
+                 "location information",
+                 node,
+                 sd->default_client_data_address.toString().c_str());
+        return nullptr;
+      }
+
+      const NodeLocation& location = sd->location.value();
+      assert(!location.isEmpty());
+      if (!location.scopeSpecified(replication_scope)) {
+        ld_error("Can't select nodeset because location %s of node %d (%s) "
+                 "doesn't have location for scope %s.",
+                 location.toString().c_str(),
+                 node,
+                 sd->default_client_data_address.toString().c_str(),
+                 NodeLocation::scopeNames()[replication_scope].c_str());
+        return nullptr;
+      }
+      location_str = location.getDomain(replication_scope, node);
+    }
+
+    list->nodes.push_back(Candidate{node, num_shards, std::move(location_str)});
+  }
+
+  *candidatesCache().wlock() = list;
+  return list;
+}
+
 NodeSetSelector::Result WeightAwareNodeSetSelector::getStorageSet(
     logid_t log_id,
     const Configuration* cfg,
@@ -101,53 +176,30 @@ NodeSetSelector::Result WeightAwareNodeSetSelector::getStorageSet(
   };
   std::map<std::string, Domain> domains;
 
+  // The log-independent part of the scan (locations, exclude flags) is
+  // shared across logs via the candidate cache; see CandidateList.
+  auto candidates = getCandidates(nodes_configuration, replication_scope);
+  if (candidates == nullptr) {
+    return res;
+  }
+
   const auto& membership = nodes_configuration.getStorageMembership();
-  for (const auto node : *membership) {
+  for (const Candidate& candidate : candidates->nodes) {
+    const node_index_t node = candidate.node;
     // Filter nodes excluded from `options`.
     if (options.exclude_nodes.count(node)) {
       continue;
     }
 
-    const auto num_shards = nodes_configuration.getNumShards(node);
-    ld_check(num_shards > 0);
-    shard_index_t shard_idx = mapLogToShard_(log_id, num_shards);
+    shard_index_t shard_idx = mapLogToShard_(log_id, candidate.num_shards);
     ShardID shard = ShardID(node, shard_idx);
 
-    // Filter nodes that shouldn't be included in nodesets
-    if (!configuration::nodes::shouldIncludeInNodesetSelection(
-            nodes_configuration, shard)) {
+    // The exclude_from_nodesets part of shouldIncludeInNodesetSelection()
+    // is already applied by getCandidates().
+    if (!membership->hasShard(shard)) {
       continue;
     }
 
-    const auto* sd = nodes_configuration.getNodeServiceDiscovery(node);
-    ld_check(sd != nullptr);
-
-    std::string location_str;
-    if (replication_scope == NodeLocationScope::ROOT) {
-      // All nodes are in the same replication domain.
-    } else {
-      if (!sd->location.has_value()) {
-        ld_error("Can't select nodeset because node %d (%s) does not have "
-                 "location information",
-                 node,
-                 sd->default_client_data_address.toString().c_str());
-        return res;
-      }
-
-      const NodeLocation& location = sd->location.value();
-      assert(!location.isEmpty());
-      if (!location.scopeSpecified(replication_scope)) {
-        ld_error("Can't select nodeset because location %s of node %d (%s) "
-                 "doesn't have location for scope %s.",
-                 location.toString().c_str(),
-                 node,
-                 sd->default_client_data_address.toString().c_str(),
-                 NodeLocation::scopeNames()[replication_scope].c_str());
-        return res;
-      }
-      location_str = location.getDomain(replication_scope, node);
-    }
-
     CandidateNode n;
     n.shard_id = shard;
     n.is_writable = membership->canWriteToShard(shard);
@@ -163,7 +215,7 @@ NodeSetSelector::Result WeightAwareNodeSetSelector::getStorageSet(
     } else {
       n.shard_id_hash = folly::Random::rand64();
     }
-    domains[location_str].nodes.push_back(n);
+    domains[candidate.location_str].nodes.push_back(n);
   }
 
   for (auto& kv : domains) {
@@ -7,6 +7,13 @@
  */
 #pragma once
 
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <folly/Synchronized.h>
+
+#include "logdevice/common/membership/types.h"
 #include "logdevice/common/nodeset_selection/NodeSetSelector.h"
 
 namespace facebook { namespace logdevice {
@@ -48,6 +55,38 @@ class WeightAwareNodeSetSelector : public NodeSetSelector {
       const Options& options) override;
 
  private:
+  // Cluster-wide candidate information that doesn't depend on the log: one
+  // entry per storage node that isn't excluded from nodesets, with the
+  // location domain string precomputed for the replication scope. Building
+  // this is the per-log cost that dominates bulk nodeset transitions (one
+  // pass over the storage membership with service discovery lookups per
+  // node), so the most recent list is cached process-wide and shared by all
+  // logs whose replication scope resolves to the same value, for as long as
+  // the nodes configuration stays the same.
+  struct Candidate {
+    node_index_t node;
+    shard_size_t num_shards;
+    // Domain of the node at the replication scope; empty if the scope is
+    // ROOT (all nodes in one domain).
+    std::string location_str;
+  };
+  struct CandidateList {
+    membership::MembershipVersion::Type version;
+    uint64_t storage_nodes_hash;
+    NodeLocationScope replication_scope;
+    std::vector<Candidate> nodes;
+  };
+
+  // Returns the candidate list for the given scope, from cache if the nodes
+  // configuration hasn't changed. Returns nullptr (after logging) if some
+  // node is missing location information for the scope.
+  static std::shared_ptr<const CandidateList> getCandidates(
+      const configuration::nodes::NodesConfiguration& nodes_configuration,
+      NodeLocationScope replication_scope);
+
+  static folly::Synchronized<std::shared_ptr<const CandidateList>>&
+  candidatesCache();
+
   MapLogToShardFn mapLogToShard_;
   bool consistentHashing_;
 };
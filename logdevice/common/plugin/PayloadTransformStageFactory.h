@@ -0,0 +1,36 @@
+/**
+ * Copyright (c) 2018-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <memory>
+
+#include "logdevice/common/PayloadTransformStage.h"
+#include "logdevice/common/plugin/Plugin.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file `PayloadTransformStageFactory` creates the `PayloadTransformStage`
+ * instance a Processor runs append payloads through.  See
+ * PayloadTransformStage.h.
+ */
+
+class PayloadTransformStageFactory : public Plugin {
+ public:
+  PluginType type() const override {
+    return PluginType::PAYLOAD_TRANSFORM_STAGE_FACTORY;
+  }
+
+  /**
+   * @return  the stage to run append payloads through, or nullptr to leave
+   *          payloads untouched.
+   */
+  virtual std::shared_ptr<PayloadTransformStage> operator()() = 0;
+};
+
+}} // namespace facebook::logdevice
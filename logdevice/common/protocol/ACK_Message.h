@@ -26,6 +26,12 @@ struct ACK_Header {
   // messages (e.g., using a certain compression algorithm)
   uint64_t options;
 
+  // Both ends agreed to wrap large messages in zstd-compressed
+  // MessageType::COMPRESSED frames. Set only if the client offered
+  // HELLO_Header::ZSTD_COMPRESSION and this server has
+  // --protocol-compression-enabled. See Connection::maybeCompressMessage().
+  static constexpr uint64_t OPT_ZSTD_COMPRESSION = 1ul << 0;
+
   // request id copied from the coresponding HELLO, see HELLO_Message.h
   request_id_t rqid;
 
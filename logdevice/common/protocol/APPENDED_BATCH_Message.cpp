@@ -0,0 +1,83 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/protocol/APPENDED_BATCH_Message.h"
+
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/Compatibility.h"
+#include "logdevice/common/protocol/ProtocolReader.h"
+#include "logdevice/common/protocol/ProtocolWriter.h"
+
+namespace facebook { namespace logdevice {
+
+uint16_t APPENDED_BATCH_Message::getMinProtocolVersion() const {
+  return Compatibility::APPENDED_BATCH_MESSAGE_SUPPORT;
+}
+
+void APPENDED_BATCH_Message::serialize(ProtocolWriter& writer) const {
+  ld_check(replies_.size() == header_.reply_count);
+
+  writer.write(header_);
+  for (const APPENDED_Header& reply : replies_) {
+    // Replies with a sequencer batching offset have a variable-size trailer
+    // and must have been sent as plain APPENDED by the caller.
+    ld_check(
+        !(reply.flags & APPENDED_Header::INCLUDES_SEQ_BATCHING_OFFSET));
+    writer.write(reply);
+  }
+}
+
+MessageReadResult APPENDED_BATCH_Message::deserialize(ProtocolReader& reader) {
+  APPENDED_BATCH_Header header;
+  header.reply_count = 0;
+  reader.read(&header);
+
+  std::vector<APPENDED_Header> replies;
+  replies.reserve(header.reply_count);
+  for (uint16_t i = 0; i < header.reply_count && reader.ok(); ++i) {
+    APPENDED_Header reply;
+    reply.flags = 0;
+    reader.read(&reply);
+    if (!reader.ok() ||
+        (reply.flags & APPENDED_Header::INCLUDES_SEQ_BATCHING_OFFSET)) {
+      return reader.errorResult(E::BADMSG);
+    }
+    replies.push_back(reply);
+  }
+
+  return reader.result(
+      [&] { return new APPENDED_BATCH_Message(header, std::move(replies)); });
+}
+
+Message::Disposition APPENDED_BATCH_Message::onReceived(const Address& from) {
+  if (from.isClientAddress()) {
+    RATELIMIT_ERROR(std::chrono::seconds(1),
+                    10,
+                    "PROTOCOL ERROR: got APPENDED_BATCH message from client %s",
+                    Sender::describeConnection(from).c_str());
+    err = E::PROTO;
+    return Disposition::ERROR;
+  }
+
+  // Unpack the batch into the standalone APPENDED path: each reply goes
+  // through the same validation and AppendRequest::onReplyReceived() routing
+  // as if it had arrived in its own frame.
+  for (const APPENDED_Header& hdr : replies_) {
+    APPENDED_Message reply(hdr);
+    Disposition disp = reply.onReceived(from);
+    if (disp == Disposition::ERROR) {
+      return disp;
+    }
+    ld_check(disp == Disposition::NORMAL);
+  }
+  replies_.clear();
+
+  return Disposition::NORMAL;
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,78 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "logdevice/common/protocol/APPENDED_Message.h"
+#include "logdevice/common/protocol/Message.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file APPENDED_BATCH is a vectored APPENDED: one frame carrying the
+ *       replies to many appends from the same client connection. A client
+ *       pipelining tens of thousands of appends per second over one
+ *       connection otherwise receives one APPENDED message per append, so
+ *       reply framing makes up half the reverse-path packets. Sequencers
+ *       coalesce replies in AppendedCoalescer (one per Worker) and flush a
+ *       batch per client per event loop iteration when
+ *       --appended-reply-coalescing-enabled is set.
+ *
+ *       Wire format: APPENDED_BATCH_Header, then reply_count APPENDED_Header
+ *       entries, each exactly the bytes a standalone APPENDED would carry.
+ *       Replies with a sequencer batching offset (the
+ *       INCLUDES_SEQ_BATCHING_OFFSET flag) have a variable-size trailer and
+ *       are not batchable; SequencerBatching keeps sending those as plain
+ *       APPENDED.
+ *
+ *       The receiver unpacks the batch into individual APPENDED_Message
+ *       instances and runs each through the regular APPENDED onReceived()
+ *       path, so AppendRequest::onReplyReceived() and its bookkeeping need
+ *       no changes. APPENDED has no onSent() bookkeeping, so neither does
+ *       the batch.
+ *
+ *       Requires Compatibility::APPENDED_BATCH_MESSAGE_SUPPORT on the
+ *       connection.
+ */
+
+struct APPENDED_BATCH_Header {
+  uint16_t reply_count;
+} __attribute__((__packed__));
+
+class APPENDED_BATCH_Message : public Message {
+ public:
+  APPENDED_BATCH_Message(const APPENDED_BATCH_Header& header,
+                         std::vector<APPENDED_Header> replies)
+      : Message(MessageType::APPENDED_BATCH, TrafficClass::APPEND),
+        header_(header),
+        replies_(std::move(replies)) {}
+
+  APPENDED_BATCH_Message(APPENDED_BATCH_Message&&) = delete;
+  APPENDED_BATCH_Message(const APPENDED_BATCH_Message&) = delete;
+  APPENDED_BATCH_Message& operator=(const APPENDED_BATCH_Message&) = delete;
+  APPENDED_BATCH_Message& operator=(APPENDED_BATCH_Message&&) = delete;
+
+  // see Message.h
+  void serialize(ProtocolWriter& writer) const override;
+  Disposition onReceived(const Address& from) override;
+
+  uint16_t getMinProtocolVersion() const override;
+
+  static Message::deserializer_t deserialize;
+
+  int8_t getExecutorPriority() const override {
+    return folly::Executor::HI_PRI;
+  }
+
+  const APPENDED_BATCH_Header header_;
+  std::vector<APPENDED_Header> replies_;
+};
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,152 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/protocol/APPEND_BATCH_Message.h"
+
+#include "logdevice/common/AppendRequest.h"
+#include "logdevice/common/AppenderPrep.h"
+#include "logdevice/common/Checksum.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/protocol/Compatibility.h"
+#include "logdevice/common/protocol/ProtocolReader.h"
+#include "logdevice/common/protocol/ProtocolWriter.h"
+#include "logdevice/common/stats/Stats.h"
+
+namespace facebook { namespace logdevice {
+
+uint16_t APPEND_BATCH_Message::getMinProtocolVersion() const {
+  return Compatibility::APPEND_BATCH_MESSAGE_SUPPORT;
+}
+
+void APPEND_BATCH_Message::serialize(ProtocolWriter& writer) const {
+  ld_check(records_.size() == header_.record_count);
+  // Per-record attributes are not representable in a batch; callers must
+  // fall back to plain APPEND for those.
+  ld_check(!(header_.flags &
+             (APPEND_Header::CUSTOM_KEY | APPEND_Header::CUSTOM_COUNTERS |
+              APPEND_Header::WRITE_STREAM_REQUEST |
+              APPEND_Header::LSN_BEFORE_REDIRECT)));
+
+  writer.write(header_);
+  const int csum_bytes = (header_.flags & APPEND_Header::CHECKSUM)
+      ? ((header_.flags & APPEND_Header::CHECKSUM_64BIT) ? 8 : 4)
+      : 0;
+  for (const BatchedRecord& rec : records_) {
+    writer.write(rec.rqid);
+    const uint32_t payload_size = rec.payload.size() + csum_bytes;
+    writer.write(payload_size);
+    // Same as APPEND_Message: the checksum over the payload is injected
+    // right before the payload bytes and counted in payload_size.
+    if (csum_bytes > 0) {
+      if (writer.isBlackHole()) {
+        writer.write(nullptr, csum_bytes);
+      } else {
+        Payload payload = rec.payload.getPayload();
+        char buf[8];
+        Slice chkblob = checksum_bytes(Slice(payload), csum_bytes * 8, buf);
+        writer.write(chkblob.data, chkblob.size);
+      }
+    }
+    rec.payload.serialize(writer);
+  }
+}
+
+MessageReadResult APPEND_BATCH_Message::deserialize(ProtocolReader& reader) {
+  APPEND_BATCH_Header header;
+  header.flags = 0;
+  header.record_count = 0;
+  reader.read(&header);
+
+  std::vector<BatchedRecord> records;
+  records.reserve(header.record_count);
+  for (uint16_t i = 0; i < header.record_count && reader.ok(); ++i) {
+    request_id_t rqid = REQUEST_ID_INVALID;
+    uint32_t payload_size = 0;
+    reader.read(&rqid);
+    reader.read(&payload_size);
+    if (!reader.ok() || payload_size > reader.bytesRemaining()) {
+      return reader.errorResult(E::BADMSG);
+    }
+    records.push_back(
+        BatchedRecord{rqid, PayloadHolder::deserialize(reader, payload_size)});
+  }
+
+  return reader.result([&] {
+    return new APPEND_BATCH_Message(header, std::move(records));
+  });
+}
+
+Message::Disposition APPEND_BATCH_Message::onReceived(const Address& from) {
+  const int checksum_bytes = (header_.flags & APPEND_Header::CHECKSUM)
+      ? ((header_.flags & APPEND_Header::CHECKSUM_64BIT) ? 8 : 4)
+      : 0;
+
+  StatsHolder* stats = Worker::stats();
+  auto log_path = Worker::getConfig()->getLogGroupPath(header_.logid);
+
+  // Per-record APPEND_Header shared by all records in the batch.
+  APPEND_Header append_header;
+  append_header.rqid = REQUEST_ID_INVALID;
+  append_header.logid = header_.logid;
+  append_header.seen = header_.seen;
+  append_header.timeout_ms = header_.timeout_ms;
+  append_header.flags = header_.flags;
+
+  // Fan the batch out into one AppenderPrep per record. Each record goes
+  // through the exact same admission, redirect and sequencing path as a
+  // standalone APPEND and produces its own APPENDED reply; the batching
+  // only saved wire framing and per-message dispatch.
+  for (BatchedRecord& rec : records_) {
+    const ssize_t payload_size = rec.payload.size() - checksum_bytes;
+    STAT_INCR(stats, append_received);
+    STAT_ADD(stats, append_payload_bytes, payload_size);
+    if (log_path) {
+      LOG_GROUP_TIME_SERIES_ADD(
+          stats, append_in_bytes, log_path.value(), payload_size);
+    }
+    WORKER_LOG_STAT_ADD(header_.logid, append_payload_bytes, payload_size);
+
+    append_header.rqid = rec.rqid;
+    std::shared_ptr<AppenderPrep> append_prep =
+        std::make_shared<AppenderPrep>(std::move(rec.payload));
+    append_prep->setAppendMessage(append_header,
+                                  LSN_INVALID,
+                                  from.asClientID(),
+                                  AppendAttributes());
+    append_prep->execute();
+  }
+  records_.clear();
+
+  return Disposition::NORMAL;
+}
+
+void APPEND_BATCH_Message::onSent(Status st, const Address& to) const {
+  Message::onSent(st, to);
+  if (st == E::OK) {
+    return;
+  }
+
+  // Notify every sub-append's AppendRequest of the failure so the client
+  // unblocks quickly, same as APPEND_Message::onSent() does for one record.
+  Worker* w = Worker::onThisThread();
+  ld_check(w);
+  for (const BatchedRecord& rec : records_) {
+    auto pos = w->runningAppends().map.find(rec.rqid);
+    if (pos != w->runningAppends().map.end()) {
+      ld_check(pos->second);
+      checked_downcast<AppendRequest*>(pos->second.get())
+          ->noReply(st, to, /*request_sent=*/false);
+    } else {
+      ld_debug("Request id %" PRIu64 " not found in the map of running "
+               "Append requests. Send status was %s.",
+               uint64_t(rec.rqid),
+               error_description(st));
+    }
+  }
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,84 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "logdevice/common/PayloadHolder.h"
+#include "logdevice/common/protocol/APPEND_Message.h"
+#include "logdevice/common/protocol/Message.h"
+#include "logdevice/include/types.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file APPEND_BATCH is a vectored APPEND: one message carrying multiple
+ *       independent records for the same log. Unlike BufferedWriter batches,
+ *       the records are not merged into one stored record -- each gets its
+ *       own Appender, its own LSN and its own APPENDED reply, so readers pay
+ *       no batch-decode cost. The point is purely to amortize protocol
+ *       framing and Worker dispatch for writers that issue many small
+ *       appends to one log but need per-record LSNs.
+ *
+ *       Wire format: APPEND_BATCH_Header, then record_count records, each
+ *       being { request_id_t rqid, uint32_t payload_size, payload bytes }.
+ *       The header-level flags apply to every record in the batch; per-batch
+ *       flags are limited to the checksum bits and NO_REDIRECT (records
+ *       needing custom keys, counters or write streams must use plain
+ *       APPEND).
+ *
+ *       Emitted by the client-side AppendBatcher (see AppendBatcher.h) when
+ *       --append-batch-max-records is nonzero. Requires
+ *       Compatibility::APPEND_BATCH_MESSAGE_SUPPORT on the connection.
+ */
+
+struct APPEND_BATCH_Header {
+  logid_t logid;        // log all records in the batch are appended to
+  epoch_t seen;         // highest epoch seen by the client, see APPEND_Header
+  uint32_t timeout_ms;  // client timeout shared by all records in the batch
+  APPEND_flags_t flags; // applies to every record; see class docblock
+  uint16_t record_count;
+} __attribute__((__packed__));
+
+class APPEND_BATCH_Message : public Message {
+ public:
+  struct BatchedRecord {
+    request_id_t rqid; // id of the AppendRequest to deliver the reply to
+    PayloadHolder payload;
+  };
+
+  APPEND_BATCH_Message(const APPEND_BATCH_Header& header,
+                       std::vector<BatchedRecord> records)
+      : Message(MessageType::APPEND_BATCH, TrafficClass::APPEND),
+        header_(header),
+        records_(std::move(records)) {}
+
+  APPEND_BATCH_Message(APPEND_BATCH_Message&&) = delete;
+  APPEND_BATCH_Message(const APPEND_BATCH_Message&) = delete;
+  APPEND_BATCH_Message& operator=(const APPEND_BATCH_Message&) = delete;
+  APPEND_BATCH_Message& operator=(APPEND_BATCH_Message&&) = delete;
+
+  // see Message.h
+  void serialize(ProtocolWriter& writer) const override;
+  void onSent(Status st, const Address& to) const override;
+  Disposition onReceived(const Address& from) override;
+
+  uint16_t getMinProtocolVersion() const override;
+
+  static Message::deserializer_t deserialize;
+
+  int8_t getExecutorPriority() const override {
+    return folly::Executor::HI_PRI;
+  }
+
+  const APPEND_BATCH_Header header_;
+  std::vector<BatchedRecord> records_;
+};
+
+}} // namespace facebook::logdevice
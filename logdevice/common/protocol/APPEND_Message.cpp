@@ -196,6 +196,8 @@ MessageReadResult APPEND_Message::deserialize(ProtocolReader& reader) {
 }
 
 Message::Disposition APPEND_Message::onReceived(const Address& from) {
+  Worker::attributeActiveCpuToLog(header_.logid);
+
   // Track the client-supplied payload size in a stat
   ssize_t payload_size = payload_.size();
   if (header_.flags & APPEND_Header::CHECKSUM) {
@@ -205,12 +207,11 @@ Message::Disposition APPEND_Message::onReceived(const Address& from) {
   STAT_INCR(stats, append_received);
   STAT_ADD(stats, append_payload_bytes, payload_size);
   // Bump the per-log-group stats
-  if (auto log_path = Worker::getConfig()->getLogGroupPath(header_.logid)) {
-    LOG_GROUP_TIME_SERIES_ADD(
-        stats, append_in_bytes, log_path.value(), payload_size);
+  if (const std::string* log_path =
+          Worker::onThisThread()->getLogGroupPathCached(header_.logid)) {
+    LOG_GROUP_TIME_SERIES_ADD(stats, append_in_bytes, *log_path, payload_size);
     if (attrs_.counters.has_value()) {
-      LOG_GROUP_CUSTOM_COUNTERS_ADD(
-          stats, log_path.value(), attrs_.counters.value());
+      LOG_GROUP_CUSTOM_COUNTERS_ADD(stats, *log_path, attrs_.counters.value());
     }
   }
   WORKER_LOG_STAT_ADD(header_.logid, append_payload_bytes, payload_size);
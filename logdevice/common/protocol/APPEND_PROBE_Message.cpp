@@ -8,6 +8,7 @@
 #include "logdevice/common/protocol/APPEND_PROBE_Message.h"
 
 #include <folly/Memory.h>
+#include <folly/Random.h>
 
 #include "logdevice/common/AllSequencers.h"
 #include "logdevice/common/AppendRequestBase.h"
@@ -78,6 +79,22 @@ static Status calculate_response(const Address& from,
                      sequencer->getMaxWindowSize());
       return E::SEQNOBUFS;
     }
+
+    // If part of the log's nodeset is graylisted as overloaded, shed the
+    // same fraction of probes that AppenderPrep would shed of appends. This
+    // is the cheap fast-fail: the client never sends the payload.
+    if (Worker::settings().append_overload_shedding) {
+      const double fraction = sequencer->getOverloadedHeadroomFraction();
+      if (fraction > 0 && folly::Random::randDouble01() < fraction) {
+        RATELIMIT_INFO(std::chrono::seconds(10),
+                       2,
+                       "Denying APPEND_PROBE from %s for log %lu because "
+                       "part of the nodeset is overloaded",
+                       Sender::describeConnection(from).c_str(),
+                       header.logid.val());
+        return E::OVERLOADED;
+      }
+    }
   } else {
     // We do not have a sequencer for this log.  The append may activate it;
     // don't deny the append because of this.
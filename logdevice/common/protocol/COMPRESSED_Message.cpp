@@ -0,0 +1,39 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/protocol/COMPRESSED_Message.h"
+
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/ProtocolReader.h"
+
+namespace facebook { namespace logdevice {
+
+void COMPRESSED_Message::serialize(ProtocolWriter&) const {
+  // COMPRESSED frames are emitted directly by
+  // Connection::maybeCompressMessage() from an already serialized message;
+  // they never go through the regular Message send pipeline.
+  ld_check(false);
+}
+
+MessageReadResult COMPRESSED_Message::deserialize(ProtocolReader& reader) {
+  // Connection::dispatchMessageBody() unwraps COMPRESSED frames before the
+  // deserializer table is consulted. Getting here means the peer nested
+  // wrappers or sent one where it's not allowed.
+  RATELIMIT_ERROR(std::chrono::seconds(1),
+                  2,
+                  "PROTOCOL ERROR: COMPRESSED wrapper reached the message "
+                  "deserializer");
+  return reader.errorResult(E::BADMSG);
+}
+
+Message::Disposition COMPRESSED_Message::onReceived(const Address&) {
+  // Unreachable, see deserialize().
+  err = E::PROTO;
+  return Disposition::ERROR;
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,40 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include "logdevice/common/protocol/Message.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file COMPRESSED is a transport-level wrapper: its body is a single zstd
+ *       frame holding one complete serialized message, inner ProtocolHeader
+ *       included. Connections that negotiated compression during handshake
+ *       (HELLO_Header::ZSTD_COMPRESSION offered by the client,
+ *       ACK_Header::OPT_ZSTD_COMPRESSION granted by the server) may wrap any
+ *       non-handshake message in it.
+ *
+ *       Wrappers are produced and consumed directly by Connection
+ *       (see Connection::maybeCompressMessage() and
+ *       Connection::dispatchCompressedMessage()), bypassing the regular
+ *       message (de)serialization machinery. This class only exists to give
+ *       the type a slot in the message tables; its methods must never be
+ *       reached.
+ */
+
+class COMPRESSED_Message : public Message {
+ public:
+  COMPRESSED_Message()
+      : Message(MessageType::COMPRESSED, TrafficClass::HANDSHAKE) {}
+
+  void serialize(ProtocolWriter&) const override;
+  static Message::deserializer_t deserialize;
+  Disposition onReceived(const Address& from) override;
+};
+
+}} // namespace facebook::logdevice
@@ -53,6 +53,29 @@ enum ProtocolVersion : uint16_t {
 
   GET_RSM_SNAPSHOT_MESSAGE_SUPPORT, // = 103
 
+  // Vectored APPEND_BATCH message carrying multiple records for one log
+  APPEND_BATCH_MESSAGE_SUPPORT, // = 104
+
+  // Vectored RECORD_BATCH message carrying one read burst for a stream
+  RECORD_BATCH_MESSAGE_SUPPORT, // = 105
+
+  // Vectored APPENDED_BATCH message coalescing append replies per connection
+  APPENDED_BATCH_MESSAGE_SUPPORT, // = 106
+
+  // COMPRESSED wrapper carrying a zstd-compressed serialized message
+  COMPRESSED_MESSAGE_SUPPORT, // = 107
+
+  // GET_ESN_DIGEST/ESN_DIGEST messages serving per-epoch ESN presence
+  // bitmaps to readers for bulk gap resolution
+  ESN_DIGEST_MESSAGE_SUPPORT, // = 108
+
+  // GOSSIP_Message includes per-shard storage QoS scores of nodes
+  SHARD_QOS_IN_GOSSIP, // = 109
+
+  // GET_TAIL_RECORDS/TAIL_RECORDS_REPLY messages serving recently appended
+  // records to tailing readers directly from the sequencer
+  TAIL_RECORDS_SUPPORT, // = 110
+
   // NOTE: insert new protocol versions here
 
   // Maximum version number of the protocol this version of LogDevice
@@ -77,6 +100,13 @@ static_assert(HEALTH_MONITOR_SUPPORT_IN_GOSSIP == 100, "");
 static_assert(NODE_STATUS_AND_HASHMAP_SUPPORT_IN_CLUSTER_STATE == 101, "");
 static_assert(INCLUDE_VERSIONS_IN_GOSSIP == 102, "");
 static_assert(GET_RSM_SNAPSHOT_MESSAGE_SUPPORT == 103, "");
+static_assert(APPEND_BATCH_MESSAGE_SUPPORT == 104, "");
+static_assert(RECORD_BATCH_MESSAGE_SUPPORT == 105, "");
+static_assert(APPENDED_BATCH_MESSAGE_SUPPORT == 106, "");
+static_assert(COMPRESSED_MESSAGE_SUPPORT == 107, "");
+static_assert(ESN_DIGEST_MESSAGE_SUPPORT == 108, "");
+static_assert(SHARD_QOS_IN_GOSSIP == 109, "");
+static_assert(TAIL_RECORDS_SUPPORT == 110, "");
 
 constexpr uint16_t MIN_PROTOCOL_SUPPORTED = PROTOCOL_VERSION_LOWER_BOUND + 1;
 constexpr uint16_t MAX_PROTOCOL_SUPPORTED = PROTOCOL_VERSION_UPPER_BOUND - 1;
@@ -0,0 +1,76 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/protocol/ESN_DIGEST_Message.h"
+
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/client_read_stream/AllClientReadStreams.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/Compatibility.h"
+#include "logdevice/common/protocol/ProtocolReader.h"
+#include "logdevice/common/protocol/ProtocolWriter.h"
+
+namespace facebook { namespace logdevice {
+
+ESN_DIGEST_Message::ESN_DIGEST_Message(const ESN_DIGEST_Header& header,
+                                       std::vector<uint8_t> bitmap)
+    : Message(MessageType::ESN_DIGEST, TrafficClass::READ_BACKLOG),
+      header_(header),
+      bitmap_(std::move(bitmap)) {
+  ld_check(bitmap_.size() == (size_t(header_.num_esns) + 7) / 8);
+}
+
+void ESN_DIGEST_Message::serialize(ProtocolWriter& writer) const {
+  writer.write(header_);
+  writer.writeVector(bitmap_);
+}
+
+MessageReadResult ESN_DIGEST_Message::deserialize(ProtocolReader& reader) {
+  ESN_DIGEST_Header hdr;
+  reader.read(&hdr);
+  std::vector<uint8_t> bitmap;
+  reader.readVector(&bitmap, (size_t(hdr.num_esns) + 7) / 8);
+  return reader.result(
+      [&] { return new ESN_DIGEST_Message(hdr, std::move(bitmap)); });
+}
+
+uint16_t ESN_DIGEST_Message::getMinProtocolVersion() const {
+  return Compatibility::ESN_DIGEST_MESSAGE_SUPPORT;
+}
+
+Message::Disposition ESN_DIGEST_Message::onReceived(const Address& from) {
+  if (from.isClientAddress()) {
+    RATELIMIT_ERROR(std::chrono::seconds(1),
+                    10,
+                    "Received ESN_DIGEST message from client %s",
+                    Sender::describeConnection(from).c_str());
+    err = E::PROTO;
+    return Disposition::ERROR;
+  }
+
+  if (header_.read_stream_id == READ_STREAM_ID_INVALID) {
+    RATELIMIT_ERROR(std::chrono::seconds(1),
+                    10,
+                    "Invalid read stream id 0 in ESN_DIGEST message from %s.",
+                    Sender::describeConnection(from).c_str());
+    err = E::PROTO;
+    return Disposition::ERROR;
+  }
+
+  ShardID shard(from.id_.node_.index(), header_.shard);
+  Worker::onThisThread()->clientReadStreams().onEsnDigest(shard, *this);
+  return Disposition::NORMAL;
+}
+
+void ESN_DIGEST_Message::onSent(Status status, const Address& to) const {
+  ld_debug(": message=ESN_DIGEST st=%s to=%s",
+           error_name(status),
+           Sender::describeConnection(to).c_str());
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,73 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <vector>
+
+#include "logdevice/common/protocol/Message.h"
+#include "logdevice/common/types_internal.h"
+#include "logdevice/include/types.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Reply to GET_ESN_DIGEST, sent by a storage node to a client read
+ * stream. Carries a bitmap with one bit per ESN in
+ * [esn_start, esn_start + num_esns - 1]: the bit is set iff the shard's
+ * copyset index has an entry (record or hole plug) for that ESN. A clear bit
+ * means the shard definitely has nothing to send for that ESN, which the
+ * read stream counts towards gap detection the same way as a NO_RECORDS gap.
+ * The covered range may be smaller than requested: it never extends past the
+ * node's view of the last released LSN, so absence of an entry is
+ * authoritative.
+ */
+
+struct ESN_DIGEST_Header {
+  logid_t log_id;
+  read_stream_id_t read_stream_id;
+  shard_index_t shard;
+  Status status; // OK, AGAIN, REBUILDING, NOTSTORAGE, FAILED, SHUTDOWN,
+                 // INVALID_PARAM
+  // Echo of the filter version from the request.
+  filter_version_t filter_version;
+  // Range the digest actually covers; num_esns is 0 unless status is OK.
+  epoch_t epoch;
+  esn_t esn_start;
+  uint32_t num_esns;
+} __attribute__((__packed__));
+
+class ESN_DIGEST_Message : public Message {
+ public:
+  ESN_DIGEST_Message(const ESN_DIGEST_Header& header,
+                     std::vector<uint8_t> bitmap);
+
+  ESN_DIGEST_Message(ESN_DIGEST_Message&&) noexcept = delete;
+  ESN_DIGEST_Message& operator=(const ESN_DIGEST_Message&) = delete;
+  ESN_DIGEST_Message& operator=(ESN_DIGEST_Message&&) = delete;
+
+  const ESN_DIGEST_Header& getHeader() const {
+    return header_;
+  }
+
+  // Bit (e - esn_start) set <=> the shard has a copyset index entry for ESN e.
+  const std::vector<uint8_t>& getBitmap() const {
+    return bitmap_;
+  }
+
+  // see Message.h
+  void serialize(ProtocolWriter&) const override;
+  void onSent(Status st, const Address& to) const override;
+  Disposition onReceived(const Address&) override;
+  uint16_t getMinProtocolVersion() const override;
+  static Message::deserializer_t deserialize;
+
+  ESN_DIGEST_Header header_;
+  std::vector<uint8_t> bitmap_;
+};
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,59 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/protocol/GET_ESN_DIGEST_Message.h"
+
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/client_read_stream/AllClientReadStreams.h"
+#include "logdevice/common/protocol/Compatibility.h"
+#include "logdevice/common/protocol/ProtocolReader.h"
+#include "logdevice/common/protocol/ProtocolWriter.h"
+
+namespace facebook { namespace logdevice {
+
+GET_ESN_DIGEST_Message::GET_ESN_DIGEST_Message(
+    const GET_ESN_DIGEST_Header& header)
+    : Message(MessageType::GET_ESN_DIGEST, TrafficClass::READ_BACKLOG),
+      header_(header) {}
+
+void GET_ESN_DIGEST_Message::serialize(ProtocolWriter& writer) const {
+  writer.write(header_);
+}
+
+MessageReadResult GET_ESN_DIGEST_Message::deserialize(ProtocolReader& reader) {
+  GET_ESN_DIGEST_Header hdr;
+  reader.read(&hdr);
+  return reader.result([&] { return new GET_ESN_DIGEST_Message(hdr); });
+}
+
+uint16_t GET_ESN_DIGEST_Message::getMinProtocolVersion() const {
+  return Compatibility::ESN_DIGEST_MESSAGE_SUPPORT;
+}
+
+Message::Disposition
+GET_ESN_DIGEST_Message::onReceived(const Address& /*from*/) {
+  // Receipt handler lives in server/message_handlers/
+  // GET_ESN_DIGEST_onReceived.cpp; this should never get called.
+  std::abort();
+}
+
+void GET_ESN_DIGEST_Message::onSent(Status status, const Address& to) const {
+  if (status == E::OK) {
+    return;
+  }
+  ld_debug("GET_ESN_DIGEST message for log %lu could not be sent to %s: %s",
+           header_.log_id.val_,
+           Sender::describeConnection(to).c_str(),
+           error_name(status));
+  // Let the read stream clear its in-flight flag so it can try again (or give
+  // up on this shard, e.g. if the node runs an old protocol version).
+  Worker::onThisThread()->clientReadStreams().onEsnDigestRequestFailed(
+      header_.read_stream_id, ShardID(to.id_.node_.index(), header_.shard));
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,61 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include "logdevice/common/protocol/Message.h"
+#include "logdevice/common/types_internal.h"
+#include "logdevice/include/types.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Message sent by a client read stream to a storage node to request a
+ * per-epoch ESN presence digest: a bitmap, built from the copyset index,
+ * saying which ESNs in [esn_start, esn_end] the shard has entries for. The
+ * read stream uses the absent ESNs to resolve gap candidates in bulk instead
+ * of waiting for individual gap messages. The reply is ESN_DIGEST.
+ */
+
+struct GET_ESN_DIGEST_Header {
+  logid_t log_id;
+  read_stream_id_t read_stream_id;
+  shard_index_t shard;
+  // The read stream's filter version at the time of the request; echoed in
+  // the reply so stale replies from before a rewind can be discarded.
+  filter_version_t filter_version;
+  // Epoch and inclusive ESN range the digest should cover. The node may
+  // shrink the range (e.g. to its last released LSN); the reply says what
+  // range it actually covers.
+  epoch_t epoch;
+  esn_t esn_start;
+  esn_t esn_end;
+} __attribute__((__packed__));
+
+class GET_ESN_DIGEST_Message : public Message {
+ public:
+  explicit GET_ESN_DIGEST_Message(const GET_ESN_DIGEST_Header& header);
+
+  GET_ESN_DIGEST_Message(GET_ESN_DIGEST_Message&&) noexcept = delete;
+  GET_ESN_DIGEST_Message& operator=(const GET_ESN_DIGEST_Message&) = delete;
+  GET_ESN_DIGEST_Message& operator=(GET_ESN_DIGEST_Message&&) = delete;
+
+  const GET_ESN_DIGEST_Header& getHeader() const {
+    return header_;
+  }
+
+  // see Message.h
+  void serialize(ProtocolWriter&) const override;
+  void onSent(Status st, const Address& to) const override;
+  Disposition onReceived(const Address&) override;
+  uint16_t getMinProtocolVersion() const override;
+  static Message::deserializer_t deserialize;
+
+  GET_ESN_DIGEST_Header header_;
+};
+
+}} // namespace facebook::logdevice
@@ -507,6 +507,14 @@ void GET_SEQ_STATE_Message::onSequencerNodeFound(Status status,
           // figureout the latest sequencer to send more accurate redirects
           /* BOOST_FALLTHROUGH */
         case Sequencer::State::ACTIVE:
+          if (sequencer->checkSealsCheckedUntil()) {
+            // A recent check-seal round for this log came back without a
+            // preemptor; answer from local sequencer state instead of
+            // repeating the CHECK_SEAL fan-out. Coalesces the GSS storms
+            // that client reconnect waves produce after failover.
+            WORKER_STAT_INCR(get_seq_state_check_seal_cache_hit);
+            break;
+          }
           if (checkSeals(from, sequencer) == Disposition::KEEP) {
             // ownership is transferred to CheckSealsRequest
             msg.release();
@@ -0,0 +1,60 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/protocol/GET_TAIL_RECORDS_Message.h"
+
+#include "logdevice/common/GetTailRecordsRequest.h"
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/protocol/Compatibility.h"
+#include "logdevice/common/protocol/ProtocolReader.h"
+#include "logdevice/common/protocol/ProtocolWriter.h"
+
+namespace facebook { namespace logdevice {
+
+GET_TAIL_RECORDS_Message::GET_TAIL_RECORDS_Message(
+    const GET_TAIL_RECORDS_Header& header)
+    : Message(MessageType::GET_TAIL_RECORDS, TrafficClass::READ_TAIL),
+      header_(header) {}
+
+void GET_TAIL_RECORDS_Message::serialize(ProtocolWriter& writer) const {
+  writer.write(header_);
+}
+
+MessageReadResult
+GET_TAIL_RECORDS_Message::deserialize(ProtocolReader& reader) {
+  GET_TAIL_RECORDS_Header hdr;
+  reader.read(&hdr);
+  return reader.result([&] { return new GET_TAIL_RECORDS_Message(hdr); });
+}
+
+uint16_t GET_TAIL_RECORDS_Message::getMinProtocolVersion() const {
+  return Compatibility::TAIL_RECORDS_SUPPORT;
+}
+
+Message::Disposition
+GET_TAIL_RECORDS_Message::onReceived(const Address& /*from*/) {
+  // Receipt handler lives in server/message_handlers/
+  // GET_TAIL_RECORDS_onReceived.cpp; this should never get called.
+  std::abort();
+}
+
+void GET_TAIL_RECORDS_Message::onSent(Status status, const Address& to) const {
+  ld_debug("GET_TAIL_RECORDS message for log %lu %s to %s",
+           header_.log_id.val_,
+           status == E::OK ? "sent" : "could not be sent",
+           Sender::describeConnection(to).c_str());
+
+  ld_check(!to.isClientAddress());
+  auto& rqmap = Worker::onThisThread()->runningGetTailRecords().map;
+  auto it = rqmap.find(header_.client_rqid);
+  if (it != rqmap.end()) {
+    it->second->onMessageSent(to.id_.node_, status);
+  }
+}
+
+}} // namespace facebook::logdevice
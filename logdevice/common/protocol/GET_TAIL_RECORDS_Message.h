@@ -0,0 +1,59 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include "logdevice/common/protocol/Message.h"
+#include "logdevice/common/types_internal.h"
+#include "logdevice/include/types.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Message sent by a tailing client to the node running a log's
+ * sequencer, asking for recently appended records straight from the
+ * sequencer's in-memory ring (see SequencerTailCache) instead of from
+ * storage nodes. The reply is TAIL_RECORDS_REPLY. If the requested range
+ * starts below the ring, the reply carries E::STALE and the client falls
+ * back to a regular read from storage nodes.
+ */
+
+struct GET_TAIL_RECORDS_Header {
+  request_id_t client_rqid;
+  logid_t log_id;
+  // First LSN the client is interested in. Records below it are never
+  // included in the reply.
+  lsn_t start_lsn;
+  // Upper bound on the number of records in the reply.
+  uint32_t max_records;
+  // A bitset of flags; there are currently none defined, must be 0.
+  uint32_t flags;
+} __attribute__((__packed__));
+
+class GET_TAIL_RECORDS_Message : public Message {
+ public:
+  explicit GET_TAIL_RECORDS_Message(const GET_TAIL_RECORDS_Header& header);
+
+  GET_TAIL_RECORDS_Message(GET_TAIL_RECORDS_Message&&) noexcept = delete;
+  GET_TAIL_RECORDS_Message& operator=(const GET_TAIL_RECORDS_Message&) = delete;
+  GET_TAIL_RECORDS_Message& operator=(GET_TAIL_RECORDS_Message&&) = delete;
+
+  const GET_TAIL_RECORDS_Header& getHeader() const {
+    return header_;
+  }
+
+  // see Message.h
+  void serialize(ProtocolWriter&) const override;
+  void onSent(Status st, const Address& to) const override;
+  Disposition onReceived(const Address&) override;
+  uint16_t getMinProtocolVersion() const override;
+  static Message::deserializer_t deserialize;
+
+  GET_TAIL_RECORDS_Header header_;
+};
+
+}} // namespace facebook::logdevice
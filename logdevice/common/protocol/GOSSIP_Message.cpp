@@ -30,7 +30,8 @@ GOSSIP_Message::GOSSIP_Message(NodeID this_node,
                                GOSSIP_Message::GOSSIP_flags_t flags,
                                uint64_t msg_id,
                                GOSSIP_Message::rsmtype_list_t rsm_types,
-                               GOSSIP_Message::versions_node_list_t versions)
+                               GOSSIP_Message::versions_node_list_t versions,
+                               GOSSIP_Message::shard_qos_list_t shard_qos)
     : Message(MessageType::GOSSIP, TrafficClass::FAILURE_DETECTOR),
       node_list_(std::move(node_list)),
       gossip_node_(this_node),
@@ -42,7 +43,8 @@ GOSSIP_Message::GOSSIP_Message(NodeID this_node,
       boycott_durations_list_(std::move(boycott_durations)),
       msg_id_(msg_id),
       rsm_types_(rsm_types),
-      versions_(versions) {}
+      versions_(versions),
+      shard_qos_list_(std::move(shard_qos)) {}
 
 Message::Disposition GOSSIP_Message::onReceived(const Address& /*from*/) {
   // Receipt handler lives in server/GOSSIP_onReceived.cpp; this should
@@ -75,6 +77,9 @@ void GOSSIP_Message::serialize(ProtocolWriter& writer) const {
     if (flags & HAS_IN_MEM_VERSIONS || flags & HAS_DURABLE_SNAPSHOT_VERSIONS) {
       writeVersions(writer);
     }
+    if (writer.proto() >= Compatibility::ProtocolVersion::SHARD_QOS_IN_GOSSIP) {
+      writeShardQoS(writer);
+    }
   }
 }
 
@@ -113,6 +118,9 @@ MessageReadResult GOSSIP_Message::deserialize(ProtocolReader& reader) {
       // in future iteration(once Local snapshot store is implemented)
       msg->readVersions(reader, num_nodes);
     }
+    if (reader.proto() >= Compatibility::ProtocolVersion::SHARD_QOS_IN_GOSSIP) {
+      msg->readShardQoS(reader, num_nodes);
+    }
   }
   return reader.resultMsg(std::move(msg));
 }
@@ -238,4 +246,34 @@ void GOSSIP_Message::readVersions(ProtocolReader& reader, uint16_t num_nodes) {
   }
 }
 
+void GOSSIP_Message::writeShardQoS(ProtocolWriter& writer) const {
+  // Either the sender filled in one entry per node or it didn't publish
+  // scores at all; pad with empty entries in the latter case so that the
+  // list on the wire always matches node_list_.
+  ld_check(shard_qos_list_.empty() ||
+           shard_qos_list_.size() == node_list_.size());
+  for (size_t i = 0; i < node_list_.size(); ++i) {
+    const std::vector<uint8_t>* scores =
+        i < shard_qos_list_.size() ? &shard_qos_list_[i] : nullptr;
+    size_t num_shards = scores ? scores->size() : 0;
+    ld_check(num_shards <= UINT8_MAX);
+    writer.write(static_cast<uint8_t>(num_shards));
+    for (size_t j = 0; j < num_shards; ++j) {
+      writer.write((*scores)[j]);
+    }
+  }
+}
+
+void GOSSIP_Message::readShardQoS(ProtocolReader& reader, uint16_t num_nodes) {
+  shard_qos_list_.resize(num_nodes);
+  for (size_t i = 0; i < num_nodes; ++i) {
+    uint8_t num_shards = 0;
+    reader.read(&num_shards);
+    shard_qos_list_[i].resize(num_shards);
+    for (size_t j = 0; j < num_shards; ++j) {
+      reader.read(&shard_qos_list_[i][j]);
+    }
+  }
+}
+
 }} // namespace facebook::logdevice
@@ -81,6 +81,10 @@ class GOSSIP_Message : public Message {
   using GOSSIP_flags_t = uint8_t;
   using rsmtype_list_t = std::vector<logid_t>; // delta log of RSM
   using versions_node_list_t = std::vector<Versions_Node>;
+  // Per-shard storage QoS scores (0-100, 100 = fully healthy), one inner
+  // vector per entry of node_list_, in the same order. An empty inner vector
+  // means the node hasn't published scores (probing disabled or unknown).
+  using shard_qos_list_t = std::vector<std::vector<uint8_t>>;
 
   GOSSIP_Message()
       : Message(MessageType::GOSSIP, TrafficClass::FAILURE_DETECTOR),
@@ -95,7 +99,8 @@ class GOSSIP_Message : public Message {
                  GOSSIP_Message::GOSSIP_flags_t flags,
                  uint64_t msg_id,
                  GOSSIP_Message::rsmtype_list_t rsm_types,
-                 GOSSIP_Message::versions_node_list_t versions);
+                 GOSSIP_Message::versions_node_list_t versions,
+                 GOSSIP_Message::shard_qos_list_t shard_qos = {});
 
   void serialize(ProtocolWriter&) const override;
   static Message::deserializer_t deserialize;
@@ -128,6 +133,11 @@ class GOSSIP_Message : public Message {
   // RSM and NCM versions
   versions_node_list_t versions_;
 
+  // Per-shard storage QoS scores, aligned with node_list_. Only present on
+  // the wire in protocol >= SHARD_QOS_IN_GOSSIP; GOSSIP_Node is serialized
+  // as a trivially copyable struct, so the scores travel in a parallel list.
+  shard_qos_list_t shard_qos_list_;
+
   // When set in flags_, indicates that the message includes the failover list.
   static const GOSSIP_flags_t HAS_FAILOVER_LIST_FLAG = 1 << 0;
 
@@ -187,5 +197,9 @@ class GOSSIP_Message : public Message {
   // Read and Write RSM and NCM versions
   void readVersions(ProtocolReader& reader, uint16_t num_nodes);
   void writeVersions(ProtocolWriter& writer) const;
+
+  // Read and Write per-shard storage QoS scores
+  void readShardQoS(ProtocolReader& reader, uint16_t num_nodes);
+  void writeShardQoS(ProtocolWriter& writer) const;
 };
 }} // namespace facebook::logdevice
@@ -418,6 +418,15 @@ Message::Disposition HELLO_Message::onReceived(const Address& from) {
     ackhdr.status = E::PROTONOSUPPORT;
   }
 
+  if (r == 0 && (header_.flags & HELLO_Header::ZSTD_COMPRESSION) &&
+      Worker::settings().protocol_compression_enabled &&
+      proto >= Compatibility::COMPRESSED_MESSAGE_SUPPORT) {
+    // The client offered transparent zstd compression and we have it enabled
+    // too; either direction of this connection may now wrap large messages
+    // in COMPRESSED frames.
+    ackhdr.options |= ACK_Header::OPT_ZSTD_COMPRESSION;
+  }
+
   const auto* info = Worker::onThisThread()->sender().getConnectionInfo(from);
   if (!info) {
     ld_error("Could not get connectiom info when processing HELLO Message "
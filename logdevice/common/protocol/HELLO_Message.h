@@ -66,6 +66,11 @@ struct HELLO_Header {
 
   // If set, HELLO message will include the client location
   static constexpr HELLO_flags_t CLIENT_LOCATION = 1ul << 5;
+
+  // If set, the sender offers transparent zstd compression of protocol
+  // messages (MessageType::COMPRESSED wrappers). The server grants it by
+  // setting ACK_Header::OPT_ZSTD_COMPRESSION in the ACK.
+  static constexpr HELLO_flags_t ZSTD_COMPRESSION = 1ul << 6;
 } __attribute__((__packed__));
 
 /**
@@ -12,10 +12,10 @@
 
 namespace facebook { namespace logdevice {
 
-// This message is currently unused. It's left here because it may be useful for
-// a reimplementation of rebuilding without WAL.
 // Sent by storage node to rebuilding donor node to notify it that a memtable
-// was flushed.
+// was flushed. Donors rebuilding with rebuild-store-durability=memory use
+// these notifications to decide when their stores became durable on the
+// recipients (see ChunkRebuilding).
 
 struct MEMTABLE_FLUSHED_Header {
   explicit MEMTABLE_FLUSHED_Header(FlushToken memtable_id,
@@ -15,6 +15,7 @@
 #include "logdevice/common/debug.h"
 #include "logdevice/common/protocol/MessageTypeNames.h"
 #include "logdevice/common/protocol/ProtocolWriter.h"
+#include "logdevice/common/protocol/SerializationBufferPool.h"
 
 namespace facebook { namespace logdevice {
 
@@ -47,7 +48,7 @@ std::unique_ptr<folly::IOBuf> Message::serialize(uint16_t protocol,
       ProtocolHeader::needChecksumInHeader(type_, protocol) && checksum_enabled;
 
   const size_t protohdr_bytes = ProtocolHeader::bytesNeeded(type_, protocol);
-  auto io_buf = folly::IOBuf::create(IOBUF_ALLOCATION_UNIT);
+  auto io_buf = SerializationBufferPool::allocate();
   if (protohdr_bytes > IOBUF_ALLOCATION_UNIT) {
     ld_check(0);
     err = E::INTERNAL;
@@ -8,8 +8,10 @@
 #include "logdevice/common/protocol/MessageDeserializers.h"
 
 #include "logdevice/common/protocol/ACK_Message.h"
+#include "logdevice/common/protocol/APPENDED_BATCH_Message.h"
 #include "logdevice/common/protocol/APPENDED_Message.h"
 #include "logdevice/common/protocol/APPEND_Message.h"
+#include "logdevice/common/protocol/APPEND_BATCH_Message.h"
 #include "logdevice/common/protocol/APPEND_PROBE_Message.h"
 #include "logdevice/common/protocol/APPEND_PROBE_REPLY_Message.h"
 #include "logdevice/common/protocol/CHECK_NODE_HEALTH_Message.h"
@@ -18,6 +20,7 @@
 #include "logdevice/common/protocol/CHECK_SEAL_REPLY_Message.h"
 #include "logdevice/common/protocol/CLEANED_Message.h"
 #include "logdevice/common/protocol/CLEAN_Message.h"
+#include "logdevice/common/protocol/COMPRESSED_Message.h"
 #include "logdevice/common/protocol/CONFIG_CHANGED_Message.h"
 #include "logdevice/common/protocol/CONFIG_FETCH_Message.h"
 #include "logdevice/common/protocol/DATA_SIZE_Message.h"
@@ -25,6 +28,7 @@
 #include "logdevice/common/protocol/DELETE_LOG_METADATA_Message.h"
 #include "logdevice/common/protocol/DELETE_LOG_METADATA_REPLY_Message.h"
 #include "logdevice/common/protocol/DELETE_Message.h"
+#include "logdevice/common/protocol/ESN_DIGEST_Message.h"
 #include "logdevice/common/protocol/FINDKEY_Message.h"
 #include "logdevice/common/protocol/FINDKEY_REPLY_Message.h"
 #include "logdevice/common/protocol/GAP_Message.h"
@@ -32,12 +36,14 @@
 #include "logdevice/common/protocol/GET_CLUSTER_STATE_REPLY_Message.h"
 #include "logdevice/common/protocol/GET_EPOCH_RECOVERY_METADATA_Message.h"
 #include "logdevice/common/protocol/GET_EPOCH_RECOVERY_METADATA_REPLY_Message.h"
+#include "logdevice/common/protocol/GET_ESN_DIGEST_Message.h"
 #include "logdevice/common/protocol/GET_HEAD_ATTRIBUTES_Message.h"
 #include "logdevice/common/protocol/GET_HEAD_ATTRIBUTES_REPLY_Message.h"
 #include "logdevice/common/protocol/GET_RSM_SNAPSHOT_Message.h"
 #include "logdevice/common/protocol/GET_RSM_SNAPSHOT_REPLY_Message.h"
 #include "logdevice/common/protocol/GET_SEQ_STATE_Message.h"
 #include "logdevice/common/protocol/GET_SEQ_STATE_REPLY_Message.h"
+#include "logdevice/common/protocol/GET_TAIL_RECORDS_Message.h"
 #include "logdevice/common/protocol/GET_TRIM_POINT_Message.h"
 #include "logdevice/common/protocol/GET_TRIM_POINT_REPLY_Message.h"
 #include "logdevice/common/protocol/GOSSIP_Message.h"
@@ -50,6 +56,7 @@
 #include "logdevice/common/protocol/NODE_STATS_AGGREGATE_REPLY_Message.h"
 #include "logdevice/common/protocol/NODE_STATS_Message.h"
 #include "logdevice/common/protocol/NODE_STATS_REPLY_Message.h"
+#include "logdevice/common/protocol/RECORD_BATCH_Message.h"
 #include "logdevice/common/protocol/RECORD_Message.h"
 #include "logdevice/common/protocol/RELEASE_Message.h"
 #include "logdevice/common/protocol/SEALED_Message.h"
@@ -61,6 +68,7 @@
 #include "logdevice/common/protocol/STOP_Message.h"
 #include "logdevice/common/protocol/STORED_Message.h"
 #include "logdevice/common/protocol/STORE_Message.h"
+#include "logdevice/common/protocol/TAIL_RECORDS_REPLY_Message.h"
 #include "logdevice/common/protocol/TEST_Message.h"
 #include "logdevice/common/protocol/TRIMMED_Message.h"
 #include "logdevice/common/protocol/TRIM_Message.h"
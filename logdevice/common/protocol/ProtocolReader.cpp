@@ -8,6 +8,7 @@
 #include "logdevice/common/protocol/ProtocolReader.h"
 
 #include "logdevice/common/Checksum.h"
+#include "logdevice/common/Worker.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/common/protocol/MessageTypeNames.h"
 #include "logdevice/common/util.h"
@@ -31,6 +32,12 @@ class LinearBufferSource : public ProtocolReader::Source {
     return 0;
   }
 
+  std::pair<const uint8_t*, size_t>
+  readableRange(size_t nread) const override {
+    ld_check(nread <= src_.size);
+    return {(const uint8_t*)src_.data + nread, src_.size - nread};
+  }
+
   size_t getLength() const override {
     return src_.size;
   }
@@ -59,6 +66,10 @@ class LinearBufferSource : public ProtocolReader::Source {
 
 class IOBufSource : public ProtocolReader::Source {
  public:
+  // Reads of at least this size share the source IOBuf instead of copying,
+  // even if that pins a much larger receive buffer. See readIOBuf().
+  static constexpr size_t ZERO_COPY_MIN_BYTES = 16 * 1024;
+
   int read(void* dest, size_t to_read, size_t /* nread */) override {
     if (to_read == 0) {
       return to_read;
@@ -73,10 +84,19 @@ class IOBufSource : public ProtocolReader::Source {
 
   int readIOBuf(folly::IOBuf* dest, size_t to_read, size_t nread) override {
     ld_check(to_read <= io_buf_->length());
-    if (to_read * 3 < io_buf_->capacity()) {
+    if (!prefer_zero_copy_ && to_read < ZERO_COPY_MIN_BYTES &&
+        to_read * 3 < io_buf_->capacity()) {
       // The allocated size of io_buf_ is more than 3x greater than what we're
       // reading. Let's avoid pinning the whole buffer and fall back to just
       // making a copy.
+      //
+      // For large reads the trade-off flips: copying a big append payload
+      // out of the receive buffer costs more memory bandwidth than briefly
+      // pinning the rest of the buffer, and the resulting IOBuf is shared
+      // by reference all the way through Appender fan-out into STORE
+      // serialization (PayloadHolder::serialize uses writeWithoutCopy).
+      // So reads of at least ZERO_COPY_MIN_BYTES always take the
+      // zero-copy branch regardless of the capacity ratio.
       return Source::readIOBuf(dest, to_read, nread);
     } else {
       *dest = io_buf_->cloneAsValue();
@@ -94,6 +114,11 @@ class IOBufSource : public ProtocolReader::Source {
     return 0;
   }
 
+  std::pair<const uint8_t*, size_t>
+  readableRange(size_t /* nread */) const override {
+    return {io_buf_->data(), io_buf_->length()};
+  }
+
   size_t getLength() const override {
     return io_buf_->length();
   }
@@ -122,15 +147,32 @@ class IOBufSource : public ProtocolReader::Source {
     return "N/A";
   }
 
-  explicit IOBufSource(std::unique_ptr<folly::IOBuf> iobuf)
-      : io_buf_(std::move(iobuf)) {
+  explicit IOBufSource(std::unique_ptr<folly::IOBuf> iobuf,
+                       bool prefer_zero_copy = false)
+      : io_buf_(std::move(iobuf)), prefer_zero_copy_(prefer_zero_copy) {
     // source must be valid
     ld_check(io_buf_ != nullptr);
   }
 
  private:
   std::unique_ptr<folly::IOBuf> io_buf_;
+  // If true, readIOBuf() always shares the source buffer instead of copying,
+  // regardless of the read size. See zero-copy-record-delivery.
+  const bool prefer_zero_copy_;
 };
+
+// Whether payloads of a message of the given type should share the receive
+// buffer even when they are small enough that we'd normally copy them out to
+// avoid pinning it.
+bool preferZeroCopy(MessageType type) {
+  if (type != MessageType::RECORD) {
+    return false;
+  }
+  // Deserialization happens on a Worker; be defensive about other contexts
+  // (e.g. tests constructing readers directly).
+  Worker* w = Worker::onThisThread(false);
+  return w != nullptr && Worker::settings().zero_copy_record_delivery;
+}
 } // anonymous namespace
 
 ProtocolReader::ProtocolReader(Source* src,
@@ -159,7 +201,7 @@ ProtocolReader::ProtocolReader(MessageType type,
                                std::unique_ptr<folly::IOBuf> src,
                                folly::Optional<uint16_t> proto)
     : src_owned_(true),
-      src_(new (src_space_) IOBufSource(std::move(src))),
+      src_(new (src_space_) IOBufSource(std::move(src), preferZeroCopy(type))),
       context_(messageTypeNames()[type].c_str()),
       proto_(proto),
       src_left_(src_->getLength()) {
@@ -198,7 +240,44 @@ void ProtocolReader::readImplCb(size_t to_read, Fn&& fn) {
   src_left_ -= nread;
 }
 
+void ProtocolReader::flushStagedReads() {
+  if (staged_drain_ > 0) {
+    // nread_ already includes the staged bytes; the source has not seen
+    // them yet, so report the pre-staging offset.
+    int rv = src_->drain(staged_drain_, nread_ - staged_drain_);
+    if (rv != 0) {
+      ld_check(err != E::OK);
+      status_ = err;
+    }
+    staged_drain_ = 0;
+  }
+  src_ptr_ = nullptr;
+  src_avail_ = 0;
+}
+
 void ProtocolReader::readImpl(void* out, size_t to_read) {
+  checkReadableBytes(to_read);
+  if (error()) {
+    return;
+  }
+  flushStagedReads();
+  // Re-acquire the source's readable region so that this field and the
+  // ones following it are served with inline memcpys. The common case is a
+  // header of small fixed-size fields that all fit in the region.
+  auto range = src_->readableRange(nread_);
+  src_ptr_ = range.first;
+  src_avail_ = std::min(range.second, src_left_);
+  if (to_read <= src_avail_) {
+    memcpy(out, src_ptr_, to_read);
+    src_ptr_ += to_read;
+    src_avail_ -= to_read;
+    staged_drain_ += to_read;
+    nread_ += to_read;
+    src_left_ -= to_read;
+    return;
+  }
+  src_ptr_ = nullptr;
+  src_avail_ = 0;
   readImplCb(to_read, [&] { return src_->read(out, to_read, nread_); });
 }
 
@@ -206,6 +285,9 @@ void ProtocolReader::readIOBuf(folly::IOBuf* out, size_t to_read) {
   ld_check(out);
   ld_check(!out->isChained());
   if (ok() && isProtoVersionAllowed()) {
+    // readIOBuf() consumes from the source directly; drain staged bytes
+    // first to preserve ordering.
+    flushStagedReads();
     readImplCb(to_read, [&] { return src_->readIOBuf(out, to_read, nread_); });
   }
 }
@@ -226,6 +308,7 @@ void ProtocolReader::checkReadableBytes(size_t bytes_to_read) {
 }
 
 void ProtocolReader::handleTrailingBytes(size_t bytes_trailing) {
+  flushStagedReads();
   checkReadableBytes(bytes_trailing);
   if (error() || bytes_trailing == 0) {
     return;
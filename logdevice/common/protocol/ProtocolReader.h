@@ -9,6 +9,7 @@
 
 #include <string>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 #include <folly/io/IOBuf.h>
@@ -89,6 +90,21 @@ class ProtocolReader {
      */
     virtual int drain(size_t to_drain, size_t nread) = 0;
 
+    /**
+     * Expose the source's current contiguous readable region, if any.
+     * ProtocolReader copies consecutive small fixed-size fields straight
+     * out of it and drains the consumed bytes in bulk, so a message header
+     * deserializes with one virtual call instead of one per field. Sources
+     * that cannot expose a region return {nullptr, 0} and serve every
+     * field through read().
+     *
+     * @param nread  bytes read from the source so far
+     */
+    virtual std::pair<const uint8_t*, size_t>
+    readableRange(size_t /* nread */) const {
+      return {nullptr, 0};
+    }
+
     /**
      * @return   the total length in bytes for the source buffer. Used by
      *           ProtocolReader to determine if there are enough bytes.
@@ -169,6 +185,16 @@ class ProtocolReader {
       //   reader.read(&n);  // may fail
       //   vector<int> v(n); // how much are we allocating?
       memset(out, 0, to_read);
+    } else if (to_read <= src_avail_) {
+      // Fast path: the field is available in the cached readable region of
+      // the source (see readImpl() for how it is acquired); the consumed
+      // bytes are drained in bulk by the next flushStagedReads().
+      memcpy(out, src_ptr_, to_read);
+      src_ptr_ += to_read;
+      src_avail_ -= to_read;
+      staged_drain_ += to_read;
+      nread_ += to_read;
+      src_left_ -= to_read;
     } else {
       readImpl(out, to_read);
       if (error()) {
@@ -180,6 +206,7 @@ class ProtocolReader {
   void readIOBuf(folly::IOBuf* out, size_t to_read);
 
   uint64_t computeChecksum(size_t msglen) {
+    flushStagedReads();
     return src_ ? src_->computeChecksum(msglen) : 0;
   }
 
@@ -429,6 +456,18 @@ class ProtocolReader {
   Status status_ = E::OK;
   bool allow_trailing_bytes_ = false;
 
+  // Cached contiguous readable region of src_ (see
+  // Source::readableRange()); fields are copied straight out of it.
+  // staged_drain_ counts consumed bytes not yet drained from the source.
+  const uint8_t* src_ptr_ = nullptr;
+  size_t src_avail_ = 0;
+  size_t staged_drain_ = 0;
+
+  // Drains the bytes consumed through the cached readable region and drops
+  // the region. Must be called before any operation that reads the source
+  // behind ProtocolReader's back.
+  void flushStagedReads();
+
   void readImpl(void* out, size_t to_read);
   template <typename Fn>
   void readImplCb(size_t to_read, Fn&& fn);
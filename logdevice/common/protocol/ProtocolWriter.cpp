@@ -12,6 +12,7 @@
 #include "logdevice/common/Checksum.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/common/protocol/MessageTypeNames.h"
+#include "logdevice/common/protocol/SerializationBufferPool.h"
 
 namespace facebook { namespace logdevice {
 
@@ -43,8 +44,9 @@ class IOBufDestination : public ProtocolWriter::Destination {
     auto avail = iobuf_->prev()->tailroom();
     auto nadd = std::min(nbytes, avail);
     if (avail == 0) {
-      auto new_iobuf =
-          folly::IOBuf::create(std::max(nbytes, IOBUF_ALLOCATION_UNIT));
+      auto new_iobuf = nbytes <= IOBUF_ALLOCATION_UNIT
+          ? SerializationBufferPool::allocate()
+          : folly::IOBuf::create(nbytes);
       // IOBuf chain is circular. Add the newly created IOBuf to the tail of
       // IOBuf chain by prepending it to the first IOBuf.
       iobuf_->prependChain(std::move(new_iobuf));
@@ -56,8 +58,9 @@ class IOBufDestination : public ProtocolWriter::Destination {
     nbytes -= nadd;
 
     if (nbytes > 0) {
-      auto new_iobuf =
-          folly::IOBuf::create(std::max(nbytes, IOBUF_ALLOCATION_UNIT));
+      auto new_iobuf = nbytes <= IOBUF_ALLOCATION_UNIT
+          ? SerializationBufferPool::allocate()
+          : folly::IOBuf::create(nbytes);
       // IOBuf chain is circular. Add the newly created IOBuf to the tail of
       // IOBuf chain by prepending it to the first IOBuf.
       iobuf_->prependChain(std::move(new_iobuf));
@@ -92,18 +95,22 @@ class IOBufDestination : public ProtocolWriter::Destination {
     return 0;
   }
 
+  std::pair<uint8_t*, size_t> writableRange(size_t /* nwritten */) override {
+    // The tail of the circular chain is the current active buffer.
+    auto prev_buf = iobuf_->prev();
+    return {prev_buf->writableTail(), prev_buf->tailroom()};
+  }
+
+  void advance(size_t nbytes) override {
+    auto prev_buf = iobuf_->prev();
+    ld_check(prev_buf->tailroom() >= nbytes);
+    prev_buf->append(nbytes);
+  }
+
   uint64_t computeChecksum() override {
-    uint64_t checksum = 0;
-    const size_t len = iobuf_->computeChainDataLength();
-    std::string data(len, 0);
-    auto it = data.begin();
-    for (auto& buf : *iobuf_) {
-      std::copy(buf.begin(), buf.end(), it);
-      it += buf.size();
-    }
-    Slice slice(&data[0], len);
-    checksum_bytes(slice, 64, (char*)&checksum);
-    return checksum;
+    // Walks the chain directly; no need to linearize it into a temporary
+    // buffer first.
+    return checksum_64bit(*iobuf_);
   }
   const char* identify() const override {
     return "iobuf destination";
@@ -173,6 +180,16 @@ class LinearBufferDestination : public LinearBufferDestinationBase {
     return writeBuffer(src, nbytes, nwritten, dest_);
   }
 
+  std::pair<uint8_t*, size_t> writableRange(size_t nwritten) override {
+    if (isNull() || nwritten > dest_.size) {
+      return {nullptr, 0};
+    }
+    return {(uint8_t*)dest_.data + nwritten, dest_.size - nwritten};
+  }
+
+  // advance() is a no-op (the base class default): the buffer is
+  // caller-owned and the write offset is tracked by ProtocolWriter.
+
   const char* identify() const override {
     return "linear buffer destination";
   }
@@ -264,6 +281,9 @@ ProtocolWriter::ProtocolWriter(std::string* dest,
 }
 
 ProtocolWriter::~ProtocolWriter() {
+  // Normally result() has already committed staged bytes; this covers
+  // writers that are abandoned without calling it.
+  flushStaged();
   if (dest_owned_) {
     dest_->~Destination();
   }
@@ -288,6 +308,22 @@ void ProtocolWriter::writeImplCb(Fn&& fn) {
 }
 
 void ProtocolWriter::writeImpl(const void* data, size_t nbytes) {
+  flushStaged();
+  // Try to stage into the destination's writable region so that this field
+  // and the ones following it batch into a single advance(). The common
+  // case is a header of small fixed-size fields that all fit.
+  auto range = dest_->writableRange(nwritten_);
+  staged_ptr_ = range.first;
+  staged_avail_ = range.second;
+  if (nbytes <= staged_avail_) {
+    memcpy(staged_ptr_, data, nbytes);
+    staged_ptr_ += nbytes;
+    staged_avail_ -= nbytes;
+    staged_ += nbytes;
+    return;
+  }
+  staged_ptr_ = nullptr;
+  staged_avail_ = 0;
   writeImplCb([&] { return dest_->write(data, nbytes, nwritten_); });
 }
 
@@ -296,6 +332,10 @@ void ProtocolWriter::writeWithoutCopy(const void* data, size_t nbytes) {
     return;
   }
   if (!dest_->isNull() && ok()) {
+    // Zero-copy writes append to the destination directly; commit staged
+    // fields first to preserve ordering, and drop the cached region since
+    // the destination's tail changes.
+    flushStaged();
     writeImplCb(
         [&] { return dest_->writeWithoutCopy(data, nbytes, nwritten_); });
   }
@@ -307,6 +347,7 @@ void ProtocolWriter::writeWithoutCopy(const folly::IOBuf* buffer) {
     return;
   }
   if (!dest_->isNull() && ok()) {
+    flushStaged();
     writeImplCb([&] { return dest_->writeWithoutCopy(buffer, nwritten_); });
   }
   nwritten_ += buffer->length();
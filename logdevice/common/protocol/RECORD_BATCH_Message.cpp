@@ -0,0 +1,132 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/protocol/RECORD_BATCH_Message.h"
+
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/Compatibility.h"
+#include "logdevice/common/protocol/ProtocolReader.h"
+#include "logdevice/common/protocol/ProtocolWriter.h"
+
+namespace facebook { namespace logdevice {
+
+uint16_t RECORD_BATCH_Message::getMinProtocolVersion() const {
+  return Compatibility::RECORD_BATCH_MESSAGE_SUPPORT;
+}
+
+void RECORD_BATCH_Message::serialize(ProtocolWriter& writer) const {
+  ld_check(records_.size() == header_.record_count);
+
+  writer.write(header_);
+  for (const auto& rec : records_) {
+    // Per-record attributes that don't fit the batch encoding must have
+    // been filtered out by the sender.
+    ld_check(rec->header_.log_id == header_.log_id);
+    ld_check(rec->header_.read_stream_id == header_.read_stream_id);
+    ld_check(rec->header_.shard == header_.shard);
+    ld_check(!rec->extra_metadata_);
+    ld_check(!(rec->header_.flags &
+               (RECORD_Header::INCLUDES_EXTRA_METADATA |
+                RECORD_Header::INCLUDE_BYTE_OFFSET | RECORD_Header::DIGEST)));
+
+    writer.write(rec->header_.lsn);
+    writer.write(rec->header_.timestamp);
+    writer.write(rec->header_.flags);
+    const uint32_t size = rec->payload_.size();
+    writer.write(size);
+    rec->payload_.serialize(writer);
+  }
+}
+
+MessageReadResult RECORD_BATCH_Message::deserialize(ProtocolReader& reader) {
+  RECORD_BATCH_Header header;
+  header.record_count = 0;
+  reader.read(&header);
+
+  std::vector<std::unique_ptr<RECORD_Message>> records;
+  records.reserve(header.record_count);
+  for (uint16_t i = 0; i < header.record_count && reader.ok(); ++i) {
+    RECORD_Header rec_header;
+    rec_header.log_id = header.log_id;
+    rec_header.read_stream_id = header.read_stream_id;
+    rec_header.shard = header.shard;
+    rec_header.flags = 0;
+    uint32_t size = 0;
+    reader.read(&rec_header.lsn);
+    reader.read(&rec_header.timestamp);
+    reader.read(&rec_header.flags);
+    reader.read(&size);
+    if (!reader.ok() || size > reader.bytesRemaining()) {
+      return reader.errorResult(E::BADMSG);
+    }
+
+    // Strip the checksum prefix from the payload bytes, the same way
+    // RECORD_Message::deserialize() does for a standalone record.
+    uint64_t expected_checksum = 0;
+    if (rec_header.flags & RECORD_Header::CHECKSUM) {
+      union {
+        uint64_t c64;
+        uint32_t c32;
+      } u;
+      const size_t checksum_size =
+          (rec_header.flags & RECORD_Header::CHECKSUM_64BIT) ? sizeof u.c64
+                                                             : sizeof u.c32;
+      if (size < checksum_size) {
+        return reader.errorResult(E::BADMSG);
+      }
+      if (rec_header.flags & RECORD_Header::CHECKSUM_64BIT) {
+        reader.read(&u.c64);
+        expected_checksum = u.c64;
+      } else {
+        reader.read(&u.c32);
+        expected_checksum = u.c32;
+      }
+      size -= checksum_size;
+    }
+
+    PayloadHolder payload = PayloadHolder::deserialize(reader, size);
+    auto rec = std::make_unique<RECORD_Message>(rec_header,
+                                                TrafficClass::READ_TAIL,
+                                                std::move(payload),
+                                                nullptr /* extra_metadata */);
+    rec->expected_checksum_ = expected_checksum;
+    records.push_back(std::move(rec));
+  }
+
+  return reader.result([&] {
+    return new RECORD_BATCH_Message(
+        header, TrafficClass::READ_TAIL, std::move(records));
+  });
+}
+
+Message::Disposition RECORD_BATCH_Message::onReceived(const Address& from) {
+  if (from.isClientAddress()) {
+    RATELIMIT_ERROR(std::chrono::seconds(1),
+                    10,
+                    "Received RECORD_BATCH message from client %s",
+                    Sender::describeConnection(from).c_str());
+    err = E::PROTO;
+    return Disposition::ERROR;
+  }
+
+  // Unpack the batch into the standalone RECORD path: each sub-record goes
+  // through the same checksum verification and ClientReadStream routing as
+  // if it had arrived in its own frame.
+  for (auto& rec : records_) {
+    Disposition disp = rec->onReceived(from);
+    if (disp == Disposition::ERROR) {
+      return disp;
+    }
+    ld_check(disp == Disposition::NORMAL);
+  }
+  records_.clear();
+
+  return Disposition::NORMAL;
+}
+
+}} // namespace facebook::logdevice
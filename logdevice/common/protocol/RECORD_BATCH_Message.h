@@ -0,0 +1,89 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "logdevice/common/protocol/Message.h"
+#include "logdevice/common/protocol/RECORD_Message.h"
+#include "logdevice/include/types.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file RECORD_BATCH is a vectored RECORD: one protocol frame carrying all
+ *       records of one read burst for a single read stream. Each record in
+ *       a burst otherwise pays its own RECORD_Header with the log id, read
+ *       stream id and shard repeated, plus per-message framing -- a 30%+
+ *       tax for small records. The batch hoists the per-stream fields into
+ *       one header and serializes only {lsn, timestamp, flags, size,
+ *       payload} per record, all in one socket write.
+ *
+ *       On the receiving end the batch is unpacked into individual
+ *       RECORD_Message instances which go through the exact same
+ *       onReceived() path as standalone RECORDs, so ClientReadStream needs
+ *       no changes; client code is order-tolerant by design (it already
+ *       merges unordered streams from multiple storage nodes).
+ *
+ *       Records with extra metadata (digests, rebuilding) or byte offsets
+ *       are not batchable; senders must ship those as plain RECORDs.
+ *
+ *       Emitted by CatchupOneStream (one frame per read burst) when
+ *       --record-batch-max-records is greater than 1. Requires
+ *       Compatibility::RECORD_BATCH_MESSAGE_SUPPORT on the connection.
+ */
+
+struct RECORD_BATCH_Header {
+  logid_t log_id;                  // log all records in the batch belong to
+  read_stream_id_t read_stream_id; // client-issued identifier for the stream
+  shard_index_t shard;             // shard all records were read from
+  uint16_t record_count;
+
+  // Header is followed by record_count entries, each being
+  // { lsn_t lsn, uint64_t timestamp, RECORD_flags_t flags, uint32_t size }
+  // followed by size bytes -- the same bytes a plain RECORD message would
+  // carry after its header (checksum prefix included, per the flags).
+} __attribute__((__packed__));
+
+class RECORD_BATCH_Message : public Message {
+ public:
+  /**
+   * @param header   per-stream fields shared by all records in the batch
+   * @param tc       traffic class of the read stream
+   * @param records  sub-records; every one must match the header's log id,
+   *                 read stream id and shard, and must not carry extra
+   *                 metadata or byte offsets
+   */
+  RECORD_BATCH_Message(const RECORD_BATCH_Header& header,
+                       TrafficClass tc,
+                       std::vector<std::unique_ptr<RECORD_Message>> records)
+      : Message(MessageType::RECORD_BATCH, tc),
+        header_(header),
+        records_(std::move(records)) {}
+
+  RECORD_BATCH_Message(RECORD_BATCH_Message&&) = delete;
+  RECORD_BATCH_Message(const RECORD_BATCH_Message&) = delete;
+  RECORD_BATCH_Message& operator=(const RECORD_BATCH_Message&) = delete;
+  RECORD_BATCH_Message& operator=(RECORD_BATCH_Message&&) = delete;
+
+  // see Message.h
+  void serialize(ProtocolWriter& writer) const override;
+  Disposition onReceived(const Address& from) override;
+  // onSent() fan-out lives in ServerMessageDispatch::onSentImpl()
+
+  uint16_t getMinProtocolVersion() const override;
+
+  static Message::deserializer_t deserialize;
+
+  const RECORD_BATCH_Header header_;
+  std::vector<std::unique_ptr<RECORD_Message>> records_;
+};
+
+}} // namespace facebook::logdevice
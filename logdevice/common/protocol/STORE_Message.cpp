@@ -215,12 +215,13 @@ MessageReadResult STORE_Message::deserialize(ProtocolReader& reader) {
     return reader.errorResult(E::BADMSG);
   }
 
-  folly::small_vector<StoreChainLink, 6> copyset;
+  copyset_chain_t copyset;
   reader.readVector(&copyset, hdr.copyset_size);
   ld_check(!reader.ok() || copyset.size() == hdr.copyset_size);
 
   lsn_t block_starting_lsn = LSN_INVALID;
   std::map<KeyType, std::string> optional_keys;
+  std::string optional_keys_serialized;
   if (hdr.flags & STORE_Header::STICKY_COPYSET) {
     reader.read(&block_starting_lsn);
   }
@@ -228,6 +229,15 @@ MessageReadResult STORE_Message::deserialize(ProtocolReader& reader) {
   if (hdr.flags & STORE_Header::CUSTOM_KEY) {
     uint8_t optional_keys_length;
     reader.read(&optional_keys_length);
+    if (reader.ok()) {
+      // Lay the keys out in LocalLogStoreRecordFormat's serialized form as
+      // they come off the wire, so the write path can append this blob to the
+      // record header as-is instead of re-serializing the map (the formats
+      // only differ in the width of the count field).
+      const uint16_t count = optional_keys_length;
+      optional_keys_serialized.append(
+          reinterpret_cast<const char*>(&count), sizeof(count));
+    }
     for (uint8_t i = 0; i < optional_keys_length; ++i) {
       if (!reader.ok()) {
         break;
@@ -238,8 +248,15 @@ MessageReadResult STORE_Message::deserialize(ProtocolReader& reader) {
       reader.read(&type);
       reader.read(&length);
       reader.readVector(&str, length);
+      if (reader.ok()) {
+        optional_keys_serialized.append(
+            reinterpret_cast<const char*>(&type), sizeof(type));
+        optional_keys_serialized.append(
+            reinterpret_cast<const char*>(&length), sizeof(length));
+        optional_keys_serialized.append(str);
+      }
       auto keytype = static_cast<KeyType>(type);
-      optional_keys.insert(std::make_pair(keytype, str));
+      optional_keys.insert(std::make_pair(keytype, std::move(str)));
     }
   }
 
@@ -254,6 +271,7 @@ MessageReadResult STORE_Message::deserialize(ProtocolReader& reader) {
     m->block_starting_lsn_ = block_starting_lsn;
     m->extra_ = std::move(extra);
     m->optional_keys_ = std::move(optional_keys);
+    m->optional_keys_serialized_ = std::move(optional_keys_serialized);
     return m;
   });
 }
@@ -363,7 +363,7 @@ class STORE_Message : public Message {
     return extra_;
   }
 
-  const folly::small_vector<StoreChainLink, 6>& getCopyset() const {
+  const copyset_chain_t& getCopyset() const {
     return copyset_;
   }
 
@@ -418,7 +418,7 @@ class STORE_Message : public Message {
   PayloadHolder payload_;
 
   // identities of all nodes on which this record is stored
-  folly::small_vector<StoreChainLink, 6> copyset_;
+  copyset_chain_t copyset_;
 
   // The starting LSN of the block to which the record belongs (issued by the
   // sticky copyset selector), or LSN_INVALID if this is a single record.
@@ -429,6 +429,14 @@ class STORE_Message : public Message {
   // See @Record.h for details
   std::map<KeyType, std::string> optional_keys_;
 
+  // The optional keys as they will appear in the local log store record
+  // header (LocalLogStoreRecordFormat::serializeOptionalKeys() layout).
+  // Built by deserialize() in the same pass that parses the keys off the
+  // wire so that formRecordHeader() on the write path doesn't have to
+  // serialize optional_keys_ again.  Empty for messages created locally by
+  // an Appender.
+  std::string optional_keys_serialized_;
+
   // This field is used only if the message was received from the
   // wire. StoreStateMachine::onReceived() sets this to the offset in
   // copyset_[] of the node that received the message (and may need to forward
@@ -0,0 +1,65 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/protocol/SerializationBufferPool.h"
+
+#include <cstdlib>
+#include <vector>
+
+#include <folly/Memory.h>
+
+#include "logdevice/common/types_internal.h"
+
+namespace facebook { namespace logdevice {
+
+namespace {
+
+// Cap on pooled buffers per thread. At IOBUF_ALLOCATION_UNIT bytes each this
+// bounds a pool to 256KB; anything beyond what a thread keeps in flight at
+// once is handed back to the allocator.
+constexpr size_t kMaxPooledBuffers = 256;
+
+struct Pool {
+  std::vector<void*> buffers;
+  // Cleared by the destructor so that buffers released while the thread is
+  // shutting down are freed instead of pushed into a dead pool.
+  bool alive = true;
+
+  ~Pool() {
+    alive = false;
+    for (void* buf : buffers) {
+      free(buf);
+    }
+    buffers.clear();
+  }
+};
+
+thread_local Pool t_pool;
+
+void recycle(void* buf, void* /* userData */) {
+  if (t_pool.alive && t_pool.buffers.size() < kMaxPooledBuffers) {
+    t_pool.buffers.push_back(buf);
+  } else {
+    free(buf);
+  }
+}
+
+} // namespace
+
+std::unique_ptr<folly::IOBuf> SerializationBufferPool::allocate() {
+  void* buf;
+  if (t_pool.buffers.empty()) {
+    buf = folly::checkedMalloc(IOBUF_ALLOCATION_UNIT);
+  } else {
+    buf = t_pool.buffers.back();
+    t_pool.buffers.pop_back();
+  }
+  return folly::IOBuf::takeOwnership(
+      buf, IOBUF_ALLOCATION_UNIT, 0 /* length */, recycle);
+}
+
+}} // namespace facebook::logdevice
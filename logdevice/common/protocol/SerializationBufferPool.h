@@ -0,0 +1,38 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <memory>
+
+#include <folly/io/IOBuf.h>
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Thread-local pool of the fixed-size buffers backing message
+ *       serialization. Every message sent costs at least one
+ *       IOBUF_ALLOCATION_UNIT-sized heap allocation in Message::serialize(),
+ *       and small control messages (APPENDED, STORED, RELEASE) are sent by
+ *       the thousands per event loop iteration. A serialized buffer only
+ *       lives until the socket flushes it, typically within the same
+ *       iteration, so recycling the buffers through a free list makes the
+ *       send path allocation-free in steady state. A released buffer goes
+ *       back to the pool of whichever thread releases it; on the send path
+ *       that is the Worker thread that allocated it.
+ */
+class SerializationBufferPool {
+ public:
+  /**
+   * Returns an empty IOBuf with IOBUF_ALLOCATION_UNIT bytes of tailroom,
+   * reusing a pooled buffer if one is available. The underlying buffer is
+   * returned to the releasing thread's pool when the IOBuf is destroyed.
+   */
+  static std::unique_ptr<folly::IOBuf> allocate();
+};
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,85 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/protocol/TAIL_RECORDS_REPLY_Message.h"
+
+#include "logdevice/common/GetTailRecordsRequest.h"
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/protocol/Compatibility.h"
+#include "logdevice/common/protocol/ProtocolReader.h"
+#include "logdevice/common/protocol/ProtocolWriter.h"
+
+namespace facebook { namespace logdevice {
+
+TAIL_RECORDS_REPLY_Message::TAIL_RECORDS_REPLY_Message(
+    const TAIL_RECORDS_REPLY_Header& header)
+    : Message(MessageType::TAIL_RECORDS_REPLY, TrafficClass::READ_TAIL),
+      header_(header) {}
+
+void TAIL_RECORDS_REPLY_Message::serialize(ProtocolWriter& writer) const {
+  writer.write(header_);
+  writer.write(status_);
+  writer.write(redirect_);
+
+  ld_check(records_.size() == header_.num_records);
+  for (const TailRecord& record : records_) {
+    record.serialize(writer);
+  }
+}
+
+MessageReadResult
+TAIL_RECORDS_REPLY_Message::deserialize(ProtocolReader& reader) {
+  TAIL_RECORDS_REPLY_Header header;
+  reader.read(&header);
+
+  auto msg = std::make_unique<TAIL_RECORDS_REPLY_Message>(header);
+  reader.read(&msg->status_);
+  reader.read(&msg->redirect_);
+
+  for (uint32_t i = 0; i < header.num_records && reader.ok(); ++i) {
+    msg->records_.emplace_back();
+    msg->records_.back().deserialize(reader, /*zero_copy*/ true);
+  }
+
+  return reader.resultMsg(std::move(msg));
+}
+
+uint16_t TAIL_RECORDS_REPLY_Message::getMinProtocolVersion() const {
+  return Compatibility::TAIL_RECORDS_SUPPORT;
+}
+
+Message::Disposition
+TAIL_RECORDS_REPLY_Message::onReceived(const Address& from) {
+  ld_debug("TAIL_RECORDS_REPLY received from %s with status %s, "
+           "%u record(s)",
+           Sender::describeConnection(from).c_str(),
+           error_description(status_),
+           header_.num_records);
+
+  auto& rqmap = Worker::onThisThread()->runningGetTailRecords().map;
+  auto it = rqmap.find(header_.client_rqid);
+  if (it != rqmap.end()) {
+    it->second->onReply(from.id_.node_, *this);
+  }
+
+  return Disposition::NORMAL;
+}
+
+void TAIL_RECORDS_REPLY_Message::onSent(Status status,
+                                        const Address& to) const {
+  if (status != E::OK) {
+    RATELIMIT_INFO(std::chrono::seconds(10),
+                   10,
+                   "Failed to send TAIL_RECORDS_REPLY for log %lu to %s: %s",
+                   header_.log_id.val_,
+                   Sender::describeConnection(to).c_str(),
+                   error_name(status));
+  }
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,89 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <vector>
+
+#include "logdevice/common/NodeID.h"
+#include "logdevice/common/TailRecord.h"
+#include "logdevice/common/protocol/Message.h"
+#include "logdevice/common/types_internal.h"
+#include "logdevice/include/Err.h"
+#include "logdevice/include/types.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Reply to GET_TAIL_RECORDS, sent by the node running a log's
+ * sequencer. Carries up to max_records recently appended records (with
+ * payloads) from the sequencer's in-memory ring, clamped to the sequencer's
+ * last released LSN so that everything in the reply is safe to deliver to
+ * readers. Since GET_TAIL_RECORDS may be sent to the wrong node, the reply
+ * also includes the status and an optional redirect.
+ */
+
+struct TAIL_RECORDS_REPLY_Header {
+  request_id_t client_rqid;
+  logid_t log_id;
+  // the sequencer's last released LSN; LSN_INVALID unless status is OK
+  lsn_t tail_lsn;
+  // number of records that follow the fixed-size part of the message;
+  // 0 unless status is OK
+  uint32_t num_records;
+  // A bitset of flags; there are currently none defined.
+  uint32_t flags;
+} __attribute__((__packed__));
+
+class TAIL_RECORDS_REPLY_Message : public Message {
+ public:
+  explicit TAIL_RECORDS_REPLY_Message(const TAIL_RECORDS_REPLY_Header& header);
+
+  TAIL_RECORDS_REPLY_Message(TAIL_RECORDS_REPLY_Message&&) noexcept = delete;
+  TAIL_RECORDS_REPLY_Message&
+  operator=(const TAIL_RECORDS_REPLY_Message&) = delete;
+  TAIL_RECORDS_REPLY_Message&
+  operator=(TAIL_RECORDS_REPLY_Message&&) = delete;
+
+  const TAIL_RECORDS_REPLY_Header& getHeader() const {
+    return header_;
+  }
+
+  // see Message.h
+  void serialize(ProtocolWriter&) const override;
+  void onSent(Status st, const Address& to) const override;
+  Disposition onReceived(const Address&) override;
+  uint16_t getMinProtocolVersion() const override;
+  static Message::deserializer_t deserialize;
+
+  TAIL_RECORDS_REPLY_Header header_;
+
+  // Status of the operation. Possible values are:
+  //    OK            records (possibly none) are included in the reply
+  //    STALE         start_lsn precedes the sequencer's ring of recent
+  //                  records; the client must read from storage nodes
+  //    NOTSUPPORTED  the node does not cache recent records
+  //                  (--sequencer-recent-records-cache-bytes is 0)
+  //    AGAIN         the sequencer exists but cannot serve yet (e.g. log
+  //                  recovery is not complete)
+  //    NOSEQUENCER   this node does not run a sequencer for the log
+  //    REDIRECTED    a different node runs the sequencer for this log
+  //    PREEMPTED     the sequencer was preempted by some other node
+  //    NOTREADY      the node is not ready (e.g. still coming up)
+  //    SHUTDOWN      the node is shutting down
+  Status status_{E::UNKNOWN};
+
+  // Points to the node that is believed to run the sequencer for the log;
+  // valid if status_ is REDIRECTED or PREEMPTED.
+  NodeID redirect_;
+
+  // header_.num_records records from the sequencer's ring, in increasing
+  // LSN order, all with payloads.
+  std::vector<TailRecord> records_;
+};
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,146 @@
+/**
+ * Copyright (c) 2019-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "logdevice/common/replicated_state_machine/FileCachedRSMSnapshotStore.h"
+
+#include <cstring>
+
+#include <folly/FileUtil.h>
+#include <folly/Format.h>
+#include <folly/system/MemoryMapping.h>
+
+#include "logdevice/common/debug.h"
+#include "logdevice/common/util.h"
+
+namespace facebook { namespace logdevice {
+
+FileCachedRSMSnapshotStore::FileCachedRSMSnapshotStore(
+    std::string key,
+    std::string cache_dir,
+    std::unique_ptr<RSMSnapshotStore> underlying)
+    : RSMSnapshotStore(key, false /* writable */),
+      cache_dir_(std::move(cache_dir)),
+      underlying_(std::move(underlying)) {
+  ld_check(underlying_ != nullptr);
+}
+
+std::string FileCachedRSMSnapshotStore::getCacheFilePath() const {
+  return folly::sformat("{}/rsm_snapshot_{}", cache_dir_, key_);
+}
+
+bool FileCachedRSMSnapshotStore::readCache(
+    std::string* blob_out,
+    SnapshotAttributes* attrs_out) const {
+  const std::string path = getCacheFilePath();
+  std::unique_ptr<folly::MemoryMapping> mapping;
+  try {
+    mapping = std::make_unique<folly::MemoryMapping>(path.c_str(), 0, -1);
+  } catch (const std::exception& e) {
+    // Most likely the file simply doesn't exist (cold start).
+    ld_debug("Could not mmap RSM snapshot cache file %s: %s",
+             path.c_str(),
+             e.what());
+    return false;
+  }
+
+  folly::ByteRange data = mapping->range();
+  if (data.size() < sizeof(CacheFileHeader)) {
+    ld_warning("RSM snapshot cache file %s is too small (%zu bytes), ignoring",
+               path.c_str(),
+               data.size());
+    return false;
+  }
+
+  CacheFileHeader header;
+  memcpy(&header, data.data(), sizeof(header));
+  if (header.magic != kMagic || header.format_version != kFormatVersion ||
+      data.size() < sizeof(header) + header.blob_size) {
+    ld_warning("RSM snapshot cache file %s is malformed or from an "
+               "incompatible version, ignoring",
+               path.c_str());
+    return false;
+  }
+
+  blob_out->assign(
+      reinterpret_cast<const char*>(data.data()) + sizeof(header),
+      header.blob_size);
+  *attrs_out = SnapshotAttributes(
+      header.base_version, std::chrono::milliseconds(header.timestamp_ms));
+  return true;
+}
+
+void FileCachedRSMSnapshotStore::writeCache(lsn_t base_version,
+                                            std::chrono::milliseconds timestamp,
+                                            const std::string& blob) const {
+  CacheFileHeader header;
+  header.magic = kMagic;
+  header.format_version = kFormatVersion;
+  header.base_version = base_version;
+  header.timestamp_ms = timestamp.count();
+  header.blob_size = blob.size();
+
+  std::string data;
+  data.reserve(sizeof(header) + blob.size());
+  data.append(reinterpret_cast<const char*>(&header), sizeof(header));
+  data.append(blob);
+
+  const std::string path = getCacheFilePath();
+  try {
+    folly::writeFileAtomic(path, data);
+  } catch (const std::exception& e) {
+    RATELIMIT_WARNING(std::chrono::minutes(1),
+                      1,
+                      "Failed to write RSM snapshot cache file %s: %s",
+                      path.c_str(),
+                      e.what());
+  }
+}
+
+void FileCachedRSMSnapshotStore::getSnapshot(lsn_t min_ver, snapshot_cb_t cb) {
+  std::string blob;
+  SnapshotAttributes attrs(LSN_INVALID, std::chrono::milliseconds(0));
+  if (readCache(&blob, &attrs) && attrs.base_version >= min_ver) {
+    ld_info("Serving snapshot for key %s from local cache, base_ver:%s",
+            key_.c_str(),
+            lsn_to_string(attrs.base_version).c_str());
+    cb(E::OK, std::move(blob), attrs);
+    return;
+  }
+
+  // Cache miss or the cached snapshot is older than what the caller needs;
+  // fetch from the underlying store and write the result through.
+  underlying_->getSnapshot(
+      min_ver,
+      [this, cb = std::move(cb)](Status st,
+                                 std::string snapshot_blob_out,
+                                 SnapshotAttributes snapshot_attrs_out) {
+        if (st == E::OK) {
+          writeCache(snapshot_attrs_out.base_version,
+                     snapshot_attrs_out.timestamp,
+                     snapshot_blob_out);
+        }
+        cb(st, std::move(snapshot_blob_out), snapshot_attrs_out);
+      });
+}
+
+void FileCachedRSMSnapshotStore::writeSnapshot(lsn_t snapshot_ver,
+                                               std::string snapshot_blob,
+                                               completion_cb_t cb) {
+  underlying_->writeSnapshot(
+      snapshot_ver, std::move(snapshot_blob), std::move(cb));
+}
+
+void FileCachedRSMSnapshotStore::getVersion(snapshot_ver_cb_t cb) {
+  underlying_->getVersion(std::move(cb));
+}
+
+void FileCachedRSMSnapshotStore::getDurableVersion(snapshot_ver_cb_t cb) {
+  underlying_->getDurableVersion(std::move(cb));
+}
+
+}} // namespace facebook::logdevice
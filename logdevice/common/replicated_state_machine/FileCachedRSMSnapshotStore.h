@@ -0,0 +1,84 @@
+/**
+ * Copyright (c) 2019-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "logdevice/common/replicated_state_machine/RSMSnapshotStore.h"
+
+/**
+ * @file RSMSnapshotStore wrapper that caches the last fetched snapshot in a
+ * local file. getSnapshot() is served from the cache when the cached version
+ * satisfies the requested minimum version, so a restarting client can
+ * bootstrap its state machines (most importantly LogsConfig) from disk and
+ * only read the delta log tail, instead of waiting for a snapshot fetch from
+ * the cluster. Snapshots fetched from the underlying store are written
+ * through to the cache file.
+ *
+ * The cache file is a fixed header followed by the raw snapshot blob, and is
+ * replaced atomically, so a concurrently restarting process never sees a
+ * partially written cache.
+ */
+
+namespace facebook { namespace logdevice {
+
+class FileCachedRSMSnapshotStore : public RSMSnapshotStore {
+ public:
+  // On-disk layout of the cache file: header immediately followed by
+  // `blob_size` bytes of snapshot blob.
+  struct CacheFileHeader {
+    uint64_t magic;
+    uint64_t format_version;
+    lsn_t base_version;
+    uint64_t timestamp_ms;
+    uint64_t blob_size;
+  };
+
+  static constexpr uint64_t kMagic = 0x74707368736d7372; // "rsmshspt"
+  static constexpr uint64_t kFormatVersion = 1;
+
+  /**
+   * @param key        see RSMSnapshotStore; also part of the cache file name.
+   * @param cache_dir  directory holding the cache files. Must exist.
+   * @param underlying store used on cache misses and for everything that is
+   *                   not getSnapshot().
+   */
+  FileCachedRSMSnapshotStore(std::string key,
+                             std::string cache_dir,
+                             std::unique_ptr<RSMSnapshotStore> underlying);
+
+  void getSnapshot(lsn_t min_ver, snapshot_cb_t cb) override;
+
+  void writeSnapshot(lsn_t snapshot_ver,
+                     std::string snapshot_blob,
+                     completion_cb_t cb) override;
+
+  void getVersion(snapshot_ver_cb_t cb) override;
+
+  void getDurableVersion(snapshot_ver_cb_t cb) override;
+
+  std::string getCacheFilePath() const;
+
+ private:
+  // Reads and validates the cache file. Returns true and fills the outputs
+  // on success, false if the file is missing, malformed or from a different
+  // format version.
+  bool readCache(std::string* blob_out, SnapshotAttributes* attrs_out) const;
+
+  // Atomically replaces the cache file. Failures are logged and ignored: the
+  // cache is an optimization, the authoritative copy lives in the cluster.
+  void writeCache(lsn_t base_version,
+                  std::chrono::milliseconds timestamp,
+                  const std::string& blob) const;
+
+  const std::string cache_dir_;
+  std::unique_ptr<RSMSnapshotStore> underlying_;
+};
+
+}} // namespace facebook::logdevice
@@ -8,6 +8,8 @@
 
 #include "logdevice/common/replicated_state_machine/LogBasedRSMSnapshotStore.h"
 
+#include <algorithm>
+#include <cstring>
 #include <string>
 #include <zstd.h>
 
@@ -157,7 +159,128 @@ bool LogBasedRSMSnapshotStore::isWritable() const {
 void LogBasedRSMSnapshotStore::writeSnapshot(lsn_t snapshot_ver,
                                              std::string snapshot_blob,
                                              completion_cb_t cb) {
-  postAppendRequest(snapshot_ver, std::move(snapshot_blob), std::move(cb));
+  const size_t chunk_size = processor_->settings()->rsm_snapshot_chunk_size;
+  if (chunk_size == 0 || snapshot_blob.size() <= chunk_size) {
+    postAppendRequest(snapshot_ver, std::move(snapshot_blob), std::move(cb));
+    return;
+  }
+  writeSnapshotChunks(
+      snapshot_ver, std::move(snapshot_blob), chunk_size, std::move(cb));
+}
+
+void LogBasedRSMSnapshotStore::postChunkAppend(
+    std::string payload,
+    std::function<void(Status, lsn_t)> cb) {
+  auto append_cb = [cb](Status st, const DataRecord& r) {
+    cb(st, r.attrs.lsn);
+  };
+  std::unique_ptr<AppendRequest> req = std::make_unique<AppendRequest>(
+      nullptr,
+      snapshot_log_id_,
+      AppendAttributes(),
+      PayloadHolder::copyBuffer(payload.data(), payload.size()),
+      snapshot_append_timeout_,
+      append_cb);
+  req->bypassWriteTokenCheck();
+  std::unique_ptr<Request> base_req = std::move(req);
+  if (postRequestWithRetrying(base_req)) {
+    ld_error("Failed with err:%s, while writing snapshot chunk for log:%lu",
+             error_name(err),
+             snapshot_log_id_.val_);
+    cb(E::FAILED, LSN_INVALID);
+  }
+}
+
+void LogBasedRSMSnapshotStore::writeSnapshotChunks(lsn_t snapshot_ver,
+                                                   std::string snapshot_blob,
+                                                   size_t chunk_size,
+                                                   completion_cb_t cb) {
+  auto state = std::make_shared<ChunkedWriteState>();
+  const int rv = RSMSnapshotHeader::deserialize(
+      Payload(snapshot_blob.data(), snapshot_blob.size()),
+      state->chunk_header);
+  if (rv < 0) {
+    ld_error("Cannot chunk snapshot with base ver:%s for log:%lu: failed to "
+             "deserialize its header, err:%s",
+             lsn_to_string(snapshot_ver).c_str(),
+             snapshot_log_id_.val_,
+             error_name(err));
+    cb(E::BADMSG, LSN_INVALID);
+    return;
+  }
+  state->snapshot_ver = snapshot_ver;
+  state->chunk_size = chunk_size;
+  state->num_chunks = (snapshot_blob.size() + chunk_size - 1) / chunk_size;
+  state->blob = std::move(snapshot_blob);
+  state->chunk_header.flags |= RSMSnapshotHeader::SNAPSHOT_CHUNK;
+  state->cb = std::move(cb);
+  ld_info("Writing snapshot with base ver:%s as %lu chunks of at most %lu "
+          "bytes (%lu bytes total) in snapshot log:%lu",
+          lsn_to_string(snapshot_ver).c_str(),
+          state->num_chunks,
+          chunk_size,
+          state->blob.size(),
+          snapshot_log_id_.val_);
+  appendNextChunk(state);
+}
+
+void LogBasedRSMSnapshotStore::appendNextChunk(
+    std::shared_ptr<ChunkedWriteState> state) {
+  const size_t offset = state->next_chunk * state->chunk_size;
+  ld_check(offset < state->blob.size());
+  const size_t slice_size =
+      std::min(state->chunk_size, state->blob.size() - offset);
+
+  const int header_sz =
+      RSMSnapshotHeader::computeLengthInBytes(state->chunk_header);
+  ld_check(header_sz > 0);
+  std::string payload;
+  payload.resize(header_sz + sizeof(SnapshotChunkHeader) + slice_size);
+  int rv =
+      RSMSnapshotHeader::serialize(state->chunk_header, &payload[0], header_sz);
+  ld_check(rv == header_sz);
+  SnapshotChunkHeader chunk_header{
+      static_cast<uint32_t>(state->next_chunk),
+      static_cast<uint32_t>(state->num_chunks),
+      state->blob.size(),
+      state->first_chunk_lsn};
+  memcpy(&payload[header_sz], &chunk_header, sizeof(chunk_header));
+  memcpy(&payload[header_sz + sizeof(chunk_header)],
+         state->blob.data() + offset,
+         slice_size);
+
+  postChunkAppend(std::move(payload), [this, state](Status st, lsn_t lsn) {
+    if (st != E::OK) {
+      // Chunks already appended will never be at the log's tail with a final
+      // chunk pointing at them, so readers ignore them; they are reclaimed
+      // when the snapshot log gets trimmed.
+      ld_error("Failed to write chunk %lu/%lu of snapshot with base ver:%s "
+               "for log:%lu, st:%s",
+               state->next_chunk + 1,
+               state->num_chunks,
+               lsn_to_string(state->snapshot_ver).c_str(),
+               snapshot_log_id_.val_,
+               error_name(st));
+      state->cb(st, LSN_INVALID);
+      return;
+    }
+    if (state->next_chunk == 0) {
+      state->first_chunk_lsn = lsn;
+    }
+    ++state->next_chunk;
+    if (state->next_chunk == state->num_chunks) {
+      ld_info("Wrote snapshot with base ver:%s as %lu chunks "
+              "[%s, %s] in snapshot log:%lu",
+              lsn_to_string(state->snapshot_ver).c_str(),
+              state->num_chunks,
+              lsn_to_string(state->first_chunk_lsn).c_str(),
+              lsn_to_string(lsn).c_str(),
+              snapshot_log_id_.val_);
+      state->cb(E::OK, state->snapshot_ver);
+      return;
+    }
+    appendNextChunk(state);
+  });
 }
 
 int LogBasedRSMSnapshotStore::getLastReleasedLsn(
@@ -247,6 +370,165 @@ void LogBasedRSMSnapshotStore::getDurableVersion(snapshot_ver_cb_t cb) {
   getVersion(std::move(cb));
 }
 
+int LogBasedRSMSnapshotStore::parseSnapshotChunk(
+    const std::string& payload,
+    RSMSnapshotHeader& header_out,
+    SnapshotChunkHeader& chunk_out,
+    size_t* data_offset_out) {
+  const int header_sz = RSMSnapshotHeader::deserialize(
+      Payload(payload.data(), payload.size()), header_out);
+  if (header_sz < 0 ||
+      !(header_out.flags & RSMSnapshotHeader::SNAPSHOT_CHUNK) ||
+      payload.size() - header_sz < sizeof(SnapshotChunkHeader)) {
+    err = E::BADMSG;
+    return -1;
+  }
+  memcpy(&chunk_out, payload.data() + header_sz, sizeof(chunk_out));
+  if (chunk_out.num_chunks == 0 ||
+      chunk_out.chunk_index >= chunk_out.num_chunks) {
+    err = E::BADMSG;
+    return -1;
+  }
+  *data_offset_out = header_sz + sizeof(SnapshotChunkHeader);
+  return 0;
+}
+
+void LogBasedRSMSnapshotStore::onChunkedSnapshotTail(
+    lsn_t min_ver,
+    snapshot_cb_t cb,
+    lsn_t tail_lsn,
+    const std::string& tail_payload,
+    std::chrono::milliseconds timestamp) {
+  RSMSnapshotHeader header;
+  SnapshotChunkHeader chunk_header;
+  size_t data_offset;
+  if (parseSnapshotChunk(tail_payload, header, chunk_header, &data_offset) !=
+          0 ||
+      chunk_header.chunk_index + 1 != chunk_header.num_chunks) {
+    // Either the chunk record is malformed, or the record at the tail is not
+    // the final chunk, which means the writer crashed in the middle of a
+    // chunked write. In both cases we cannot serve this snapshot.
+    RATELIMIT_ERROR(std::chrono::seconds(1),
+                    1,
+                    "Record at the tail (lsn:%s) of snapshot log:%lu is not "
+                    "the final chunk of a chunked snapshot",
+                    lsn_to_string(tail_lsn).c_str(),
+                    snapshot_log_id_.val_);
+    cb(E::BADMSG,
+       "",
+       SnapshotAttributes(LSN_INVALID, std::chrono::milliseconds(0)));
+    return;
+  }
+
+  if (chunk_header.num_chunks == 1) {
+    deliverSnapshotBlob(min_ver,
+                        cb,
+                        E::OK,
+                        tail_lsn,
+                        tail_payload.substr(data_offset),
+                        timestamp);
+    return;
+  }
+
+  auto state = std::make_shared<ChunkedReadState>();
+  state->base_version = header.base_version;
+  state->num_chunks = chunk_header.num_chunks;
+  state->total_size = chunk_header.total_size;
+  state->timestamp = timestamp;
+  state->assembled.reserve(chunk_header.total_size);
+  logid_t snapshot_log_id = snapshot_log_id_;
+  createBasicReadStream(
+      chunk_header.first_chunk_lsn, // start
+      tail_lsn,                     // end
+      [this, state, min_ver, cb, tail_lsn](
+          std::unique_ptr<DataRecord>& record) {
+        return onSnapshotChunk(state, min_ver, cb, tail_lsn, record);
+      },
+      [state, cb, snapshot_log_id](const GapRecord& gap) {
+        if (!state->done) {
+          state->done = true;
+          ld_error("Received GAP(type:%s, lo:%s, hi:%s) while reading "
+                   "snapshot chunks of log:%lu",
+                   gapTypeToString(gap.type).c_str(),
+                   lsn_to_string(gap.lo).c_str(),
+                   lsn_to_string(gap.hi).c_str(),
+                   snapshot_log_id.val_);
+          cb(E::NOTFOUND,
+             "",
+             SnapshotAttributes(LSN_INVALID, std::chrono::milliseconds(0)));
+        }
+        return true;
+      },
+      nullptr /* on health cb */);
+}
+
+bool LogBasedRSMSnapshotStore::onSnapshotChunk(
+    std::shared_ptr<ChunkedReadState> state,
+    lsn_t min_ver,
+    snapshot_cb_t cb,
+    lsn_t tail_lsn,
+    const std::unique_ptr<DataRecord>& record) {
+  if (state->done) {
+    return true;
+  }
+  const Payload& p = record->payload;
+  std::string payload((const char*)p.data(), p.size());
+  RSMSnapshotHeader header;
+  SnapshotChunkHeader chunk_header;
+  size_t data_offset;
+  const int rv =
+      parseSnapshotChunk(payload, header, chunk_header, &data_offset);
+  if (rv != 0 || header.base_version != state->base_version ||
+      chunk_header.num_chunks != state->num_chunks ||
+      chunk_header.chunk_index != state->next_chunk) {
+    // The snapshot log is only written by one node at a time (see
+    // isWritable()), so chunks of one snapshot are expected to be contiguous.
+    state->done = true;
+    RATELIMIT_ERROR(std::chrono::seconds(1),
+                    1,
+                    "Unexpected record at lsn:%s while re-assembling chunked "
+                    "snapshot of log:%lu (expected chunk %lu/%lu of base "
+                    "ver:%s)",
+                    lsn_to_string(record->attrs.lsn).c_str(),
+                    snapshot_log_id_.val_,
+                    state->next_chunk,
+                    state->num_chunks,
+                    lsn_to_string(state->base_version).c_str());
+    cb(E::BADMSG,
+       "",
+       SnapshotAttributes(LSN_INVALID, std::chrono::milliseconds(0)));
+    return true;
+  }
+
+  state->assembled.append(payload, data_offset, std::string::npos);
+  ++state->next_chunk;
+  if (state->next_chunk < state->num_chunks) {
+    return true;
+  }
+
+  state->done = true;
+  if (state->assembled.size() != state->total_size) {
+    RATELIMIT_ERROR(std::chrono::seconds(1),
+                    1,
+                    "Re-assembled snapshot of log:%lu has %lu bytes, "
+                    "expected %lu",
+                    snapshot_log_id_.val_,
+                    state->assembled.size(),
+                    state->total_size);
+    cb(E::BADMSG,
+       "",
+       SnapshotAttributes(LSN_INVALID, std::chrono::milliseconds(0)));
+    return true;
+  }
+  deliverSnapshotBlob(min_ver,
+                      cb,
+                      E::OK,
+                      tail_lsn,
+                      std::move(state->assembled),
+                      state->timestamp);
+  return true;
+}
+
 bool LogBasedRSMSnapshotStore::onSnapshotRecord(
     lsn_t min_ver,
     snapshot_cb_t cb,
@@ -255,10 +537,38 @@ bool LogBasedRSMSnapshotStore::onSnapshotRecord(
     const std::unique_ptr<DataRecord>& record) {
   Payload& p = record->payload;
   std::string snapshot_blob((char*)p.data(), p.size());
+  RSMSnapshotHeader chunk_check_hdr;
+  if (st == E::OK &&
+      RSMSnapshotHeader::deserialize(
+          Payload(snapshot_blob.data(), snapshot_blob.size()),
+          chunk_check_hdr) >= 0 &&
+      (chunk_check_hdr.flags & RSMSnapshotHeader::SNAPSHOT_CHUNK)) {
+    onChunkedSnapshotTail(min_ver,
+                          std::move(cb),
+                          last_released_real_lsn,
+                          snapshot_blob,
+                          record->attrs.timestamp);
+    return true;
+  }
+  deliverSnapshotBlob(min_ver,
+                      std::move(cb),
+                      st,
+                      last_released_real_lsn,
+                      std::move(snapshot_blob),
+                      record->attrs.timestamp);
+  return true;
+}
+
+void LogBasedRSMSnapshotStore::deliverSnapshotBlob(
+    lsn_t min_ver,
+    snapshot_cb_t cb,
+    Status st,
+    lsn_t last_released_real_lsn,
+    std::string snapshot_blob,
+    std::chrono::milliseconds timestamp) {
   RSMSnapshotHeader header_out;
   int rv = extractVersion(snapshot_blob, header_out);
-  SnapshotAttributes snapshot_attrs(
-      header_out.base_version, record->attrs.timestamp);
+  SnapshotAttributes snapshot_attrs(header_out.base_version, timestamp);
   if (!rv && st == E::OK) {
     if (last_released_real_lsn_ < last_released_real_lsn) {
       setCachedItems(last_released_real_lsn, snapshot_blob, snapshot_attrs);
@@ -272,7 +582,7 @@ bool LogBasedRSMSnapshotStore::onSnapshotRecord(
            lsn_to_string(last_released_real_lsn).c_str(),
            lsn_to_string(header_out.base_version).c_str(),
            snapshot_attrs.timestamp.count(),
-           p.size(),
+           snapshot_blob.size(),
            rv);
   Status st_to_forward = st;
   if (rv) {
@@ -281,7 +591,6 @@ bool LogBasedRSMSnapshotStore::onSnapshotRecord(
     st_to_forward = E::STALE;
   }
   cb(st_to_forward, std::move(snapshot_blob), std::move(snapshot_attrs));
-  return true;
 }
 
 void LogBasedRSMSnapshotStore::onGotLastReleased(Status st,
@@ -19,6 +19,21 @@
  */
 
 namespace facebook { namespace logdevice {
+
+// Fixed-size header that follows the RSMSnapshotHeader in every record of a
+// chunked snapshot (see RSMSnapshotHeader::SNAPSHOT_CHUNK). Chunks of one
+// snapshot are appended as consecutive records of the snapshot log; the last
+// chunk is the one at the log's tail and points back at the first one so that
+// readers can fetch the whole range and re-assemble the original blob.
+struct SnapshotChunkHeader {
+  uint32_t chunk_index; // 0-based index of this chunk
+  uint32_t num_chunks;  // total number of chunks of this snapshot
+  uint64_t total_size;  // size of the re-assembled snapshot blob, in bytes
+  lsn_t first_chunk_lsn; // lsn of the first chunk record. LSN_INVALID in the
+                         // first chunk, whose lsn is not known yet when it is
+                         // appended.
+} __attribute__((__packed__));
+
 class LogBasedRSMSnapshotStore : public RSMSnapshotStore {
  public:
   explicit LogBasedRSMSnapshotStore(std::string key,
@@ -42,6 +57,31 @@ class LogBasedRSMSnapshotStore : public RSMSnapshotStore {
   void getSnapshot(lsn_t min_ver, snapshot_cb_t) override;
 
  private:
+  // State of a chunked snapshot write in progress. Chunks are appended one at
+  // a time so that every chunk past the first one can embed the lsn of the
+  // first chunk record in its SnapshotChunkHeader.
+  struct ChunkedWriteState {
+    lsn_t snapshot_ver;
+    std::string blob;
+    size_t chunk_size;
+    size_t num_chunks;
+    size_t next_chunk{0};
+    lsn_t first_chunk_lsn{LSN_INVALID};
+    RSMSnapshotHeader chunk_header;
+    completion_cb_t cb;
+  };
+
+  // State of a chunked snapshot read in progress.
+  struct ChunkedReadState {
+    lsn_t base_version;
+    size_t num_chunks;
+    uint64_t total_size;
+    std::chrono::milliseconds timestamp;
+    size_t next_chunk{0};
+    std::string assembled;
+    bool done{false};
+  };
+
   Processor* processor_{nullptr};
   const logid_t snapshot_log_id_;
   lsn_t last_released_real_lsn_{LSN_INVALID};
@@ -72,12 +112,57 @@ class LogBasedRSMSnapshotStore : public RSMSnapshotStore {
                                  std::string payload,
                                  completion_cb_t cb);
 
+  // Like postAppendRequest() but reports the lsn the record was written at,
+  // which chunked writes need to link chunks together.
+  virtual void postChunkAppend(std::string payload,
+                               std::function<void(Status, lsn_t)> cb);
+
+  // Splits `snapshot_blob` into chunks of at most `chunk_size` bytes and
+  // appends them as consecutive records of the snapshot log.
+  void writeSnapshotChunks(lsn_t snapshot_ver,
+                           std::string snapshot_blob,
+                           size_t chunk_size,
+                           completion_cb_t cb);
+
+  void appendNextChunk(std::shared_ptr<ChunkedWriteState> state);
+
+  // Parse a chunk record into its RSMSnapshotHeader and SnapshotChunkHeader.
+  // @return 0 on success and populates `data_offset_out` with the offset of
+  //         the chunk data, or -1 with err set to E::BADMSG.
+  static int parseSnapshotChunk(const std::string& payload,
+                                RSMSnapshotHeader& header_out,
+                                SnapshotChunkHeader& chunk_out,
+                                size_t* data_offset_out);
+
+  // Called when the record at the snapshot log's tail is the final chunk of a
+  // chunked snapshot; reads the whole chunk range and re-assembles the blob.
+  void onChunkedSnapshotTail(lsn_t min_ver,
+                             snapshot_cb_t cb,
+                             lsn_t tail_lsn,
+                             const std::string& tail_payload,
+                             std::chrono::milliseconds timestamp);
+
+  bool onSnapshotChunk(std::shared_ptr<ChunkedReadState> state,
+                       lsn_t min_ver,
+                       snapshot_cb_t cb,
+                       lsn_t tail_lsn,
+                       const std::unique_ptr<DataRecord>& record);
+
   bool onSnapshotRecord(lsn_t min_ver,
                         snapshot_cb_t cb,
                         Status st,
                         lsn_t read_upto,
                         const std::unique_ptr<DataRecord>& record);
 
+  // Common tail of getSnapshot(): extract the version from a (re-assembled)
+  // snapshot blob, update the cache and invoke the callback.
+  void deliverSnapshotBlob(lsn_t min_ver,
+                           snapshot_cb_t cb,
+                           Status st,
+                           lsn_t last_released_real_lsn,
+                           std::string snapshot_blob,
+                           std::chrono::milliseconds timestamp);
+
   void setCachedItems(lsn_t last_released_real_lsn,
                       std::string snapshot_blob,
                       SnapshotAttributes snapshot_attrs);
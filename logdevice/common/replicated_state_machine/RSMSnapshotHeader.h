@@ -57,6 +57,13 @@ struct RSMSnapshotHeader : public SerializableData {
   // payload.
   static const uint32_t ZSTD_COMPRESSION = 1 << 0; //=1
 
+  // If this flag is set, this record holds one chunk of a snapshot that was
+  // split across several consecutive records of the snapshot log because it
+  // exceeded the maximum payload size. The header is followed by a
+  // SnapshotChunkHeader (see LogBasedRSMSnapshotStore.h) and a slice of the
+  // original snapshot blob.
+  static const uint32_t SNAPSHOT_CHUNK = 1 << 1; //=2
+
   /**
    * Deserialize a RSMSnapshotHeader from a payload.
    *
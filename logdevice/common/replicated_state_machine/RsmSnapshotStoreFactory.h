@@ -11,6 +11,7 @@
 
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/debug.h"
+#include "logdevice/common/replicated_state_machine/FileCachedRSMSnapshotStore.h"
 #include "logdevice/common/replicated_state_machine/LogBasedRSMSnapshotStore.h"
 #include "logdevice/common/replicated_state_machine/MessageBasedRSMSnapshotStore.h"
 #include "logdevice/common/replicated_state_machine/RSMSnapshotStore.h"
@@ -61,10 +62,23 @@ class RsmSnapshotStoreFactory {
             key, snapshot_log, processor, is_server /* allow snapshotting */);
       } break;
 
-      case SnapshotStoreType::LOCAL_STORE:
+      case SnapshotStoreType::LOCAL_STORE: {
         ld_check(!is_server);
-        // Intentional fall through for cases when client settings
-        // doesn't have store type as Message.
+        const std::string& cache_dir =
+            processor->settings()->rsm_snapshot_cache_dir;
+        if (!cache_dir.empty()) {
+          ld_info("Creating MessageBasedRSMSnapshotStore with a local file "
+                  "cache in %s",
+                  cache_dir.c_str());
+          STAT_INCR(processor->stats_, rsm_msg_snapshot_store_init);
+          return std::make_unique<FileCachedRSMSnapshotStore>(
+              key,
+              cache_dir,
+              std::make_unique<MessageBasedRSMSnapshotStore>(key));
+        }
+        // No cache directory configured; intentional fall through to a plain
+        // message based store.
+      }
       case SnapshotStoreType::MESSAGE:
         STAT_INCR(processor->stats_, rsm_msg_snapshot_store_init);
         ld_info("Creating MessageBasedRSMSnapshotStore");
@@ -169,6 +169,26 @@ void GossipSettings::defineSettings(SettingEasyInit& init) {
        "1/10th of the GOSSIP_Messages.",
        SERVER,
        SettingsCategory::FailureDetector);
+  init("gossip-delta-encoding",
+       &gossip_delta_encoding,
+       "false",
+       nullptr,
+       "If true, regular GOSSIP messages only carry nodes whose state changed "
+       "since the last gossip this node successfully sent to the destination, "
+       "with a full node list sent periodically as a safety net (see "
+       "gossip-full-sync-period). Cuts gossip CPU and network cost on large "
+       "clusters. The wire format is unchanged, so nodes with and without "
+       "this setting can be mixed freely.",
+       SERVER,
+       SettingsCategory::FailureDetector);
+  init("gossip-full-sync-period",
+       &gossip_full_sync_period,
+       "10",
+       parse_positive<int32_t>(),
+       "When gossip-delta-encoding is enabled, send the full node list "
+       "instead of a delta every this many gossips to a given peer.",
+       SERVER,
+       SettingsCategory::FailureDetector);
 };
 
 }} // namespace facebook::logdevice
@@ -50,6 +50,10 @@ struct GossipSettings : public SettingsBundle {
   // See .cpp for documentation
   int32_t gossip_include_rsm_versions_frequency;
 
+  // See .cpp for documentation
+  bool gossip_delta_encoding;
+  int32_t gossip_full_sync_period;
+
   const char* getName() const override {
     return "GossipSettings";
   }
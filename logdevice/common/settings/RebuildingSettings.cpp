@@ -129,6 +129,18 @@ void RebuildingSettings::defineSettings(SettingEasyInit& init) {
        "Max amount of time rebuilding read storage task is allowed to "
        "take before yielding to other storage tasks. \"max\" for unlimited.",
        SERVER);
+  init("rebuilding-read-streams",
+       &read_streams,
+       "1",
+       parse_positive<size_t>(),
+       "Number of concurrent read storage tasks that rebuilding of a shard "
+       "uses. The logs of the shard are hashed across the streams, and each "
+       "stream reads its subset of logs with its own iterator. Values above "
+       "one let reading use more than one storage thread per shard, at the "
+       "cost of less sequential disk access. Applied when a shard rebuilding "
+       "starts; doesn't affect rebuildings already in progress.",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::Rebuilding);
   init("rebuilding-max-records-in-flight",
        &max_records_in_flight,
        "200",
@@ -430,6 +442,31 @@ void RebuildingSettings::defineSettings(SettingEasyInit& init) {
        "batch every 10 seconds.",
        SERVER,
        SettingsCategory::Rebuilding);
+  init("rebuilding-rate-limit-while-overloaded",
+       &rate_limit_while_overloaded,
+       "unlimited",
+       [](const std::string& val) -> rate_limit_t {
+         rate_limit_t res;
+         int rv = parse_rate_limit(val.c_str(), &res);
+         if (rv != 0) {
+           throw boost::program_options::error(
+               "Invalid value(" + val +
+               ") for --rebuilding-rate-limit-while-overloaded."
+               "Expected format is <count>/<duration><unit>, e.g. 5M/1s, or "
+               "'unlimited'");
+         }
+         return res;
+       },
+       "Rate limit to apply to rebuilding reads, instead of "
+       "--rebuilding-rate-limit, while the health monitor reports this node "
+       "overloaded or unhealthy. Same format as --rebuilding-rate-limit. "
+       "This lets a donor back off when it's struggling to serve client "
+       "traffic, while idle donors keep rebuilding at full speed. 'unlimited' "
+       "disables the backoff. Requires --enable-health-monitor; otherwise the "
+       "node's status is never reported as overloaded and this setting has no "
+       "effect.",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::Rebuilding);
   init("filter-relocate-shards",
        &filter_relocate_shards,
        "true",
@@ -42,6 +42,7 @@ struct RebuildingSettings : public SettingsBundle {
   std::chrono::milliseconds planner_scheduling_delay;
   size_t max_batch_bytes;
   std::chrono::milliseconds max_batch_time;
+  size_t read_streams;
   size_t max_records_in_flight;
   size_t max_record_bytes_in_flight;
   bool use_rocksdb_cache;
@@ -66,6 +67,7 @@ struct RebuildingSettings : public SettingsBundle {
   chrono_expbackoff_t<std::chrono::milliseconds> wait_purges_backoff_time;
   uint64_t max_malformed_records_to_tolerate;
   rate_limit_t rate_limit;
+  rate_limit_t rate_limit_while_overloaded;
   bool filter_relocate_shards;
   bool new_to_old;
 
@@ -520,6 +520,17 @@ void Settings::defineSettings(SettingEasyInit& init) {
        " otherwise FBTraceLogger is used",
        SERVER | CLIENT | REQUIRES_RESTART /* init'ed at startup */,
        SettingsCategory::Monitoring);
+  init("trace-logger-queue-size",
+       &trace_logger_queue_size,
+       "0",
+       nullptr, // no validation
+       "If nonzero, push trace samples through a bounded queue of this many "
+       "entries drained by a dedicated thread, instead of delivering them to "
+       "the trace logger plugin synchronously on the thread that produced "
+       "them. Samples are dropped when the queue is full. Allows much higher "
+       "trace sampling rates. 0 means synchronous delivery.",
+       SERVER | REQUIRES_RESTART /* init'ed at startup */,
+       SettingsCategory::Monitoring);
   init("outbytes-mb",
        &outbufs_mb_max_per_thread,
        "512",
@@ -555,6 +566,19 @@ void Settings::defineSettings(SettingEasyInit& init) {
       "ones",
       SERVER | CLIENT,
       SettingsCategory::Network);
+  init("tcp-zero-copy-threshold",
+       &tcp_zero_copy_threshold,
+       "0",
+       parse_nonnegative<ssize_t>(),
+       "If nonzero, send write chains of at least this many bytes with "
+       "MSG_ZEROCOPY on non-SSL TCP sockets: the kernel transmits the record "
+       "payloads directly from the message buffers and releases them on "
+       "transmit completion, instead of copying them into socket memory. "
+       "Smaller writes keep using the regular copying path. 0 disables "
+       "zero-copy sends. Changing this setting on-the-fly will not apply it "
+       "to existing sockets, only to newly created ones",
+       SERVER | CLIENT | EXPERIMENTAL,
+       SettingsCategory::Network);
   init(
       "outbuf-kb",
       &outbuf_overflow_kb,
@@ -586,6 +610,17 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "sockets, only to newly created ones", // TODO (t13429319): fix this
        SERVER,
        SettingsCategory::Network);
+  init("outbuf-socket-max-percent",
+       &outbuf_socket_max_percent,
+       "0",
+       validate_range<double>(0, 100),
+       "Maximum share of outbufs-mb a single connection may occupy, in "
+       "percent. Sends to a peer whose pending bytes exceed this share fail "
+       "with NOBUFS even if the global budget is not exhausted, so one slow "
+       "peer cannot absorb the whole budget and stall sends to healthy "
+       "peers. 0 disables the per-connection cap.",
+       SERVER,
+       SettingsCategory::Network);
   init("output-max-records-kb",
        &output_max_records_kb,
        "1024",
@@ -593,6 +628,39 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "amount of RECORD data to push to the client at once",
        SERVER | CLIENT,
        SettingsCategory::ReadPath);
+  init("catchup-readahead",
+       &catchup_readahead,
+       "false",
+       nullptr,
+       "if true, a catching-up read stream starts its next storage read once "
+       "the RECORD output buffer has drained halfway, instead of waiting for "
+       "it to drain completely. Keeps both the disk and the connection busy "
+       "for far-behind readers, at the cost of up to 50% more buffered "
+       "record data per client",
+       SERVER,
+       SettingsCategory::ReadPath);
+  init("adaptive-catchup-batches",
+       &adaptive_catchup_batches,
+       "false",
+       nullptr,
+       "if true, size each read stream's batches from the client's observed "
+       "socket drain rate, so slow or stalled clients trigger small storage "
+       "reads and fast clients keep getting maximal batches. Avoids reading "
+       "records that sit in the output buffer for seconds and may be dropped "
+       "on a stream rewind",
+       SERVER,
+       SettingsCategory::ReadPath);
+  init("prefetch-epoch-offsets",
+       &prefetch_epoch_offsets,
+       "false",
+       nullptr,
+       "if true, when a read stream that includes byte offsets delivers a "
+       "bridge record, the offsets of the following epoch are fetched from "
+       "per-epoch metadata ahead of need, so the first records of the new "
+       "epoch don't ship without offsets while the metadata read makes its "
+       "round trip",
+       SERVER,
+       SettingsCategory::ReadPath);
   init("max-time-to-allow-socket-drain",
        &max_time_to_allow_socket_drain,
        "3min",
@@ -651,8 +719,9 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "5min",
        validate_positive<ssize_t>(),
        "How long inactive client-to-server connection will stay open before "
-       "being shut down automatically.",
-       CLIENT,
+       "being shut down automatically. Also applies to incoming connections "
+       "on servers when close-idle-incoming-connections is set.",
+       SERVER | CLIENT,
        SettingsCategory::Network);
   init("rate-limit-idle-connection-closed",
        &rate_limit_idle_connection_closed,
@@ -660,7 +729,18 @@ void Settings::defineSettings(SettingEasyInit& init) {
        validate_nonnegative<ssize_t>(),
        "Max number of idle connections closed in single round of socket healh "
        "check. Set to 0 to disable closing of idle connections completely.",
-       CLIENT,
+       SERVER | CLIENT,
+       SettingsCategory::Network);
+  init("close-idle-incoming-connections",
+       &close_idle_incoming_connections,
+       "false",
+       nullptr,
+       "If enabled, servers close incoming connections that have been "
+       "inactive for idle-connection-keep-alive, subject to "
+       "rate-limit-idle-connection-closed. Peers transparently reconnect "
+       "when they need the connection again. Helps keep connection counts "
+       "bounded on servers with many mostly-idle clients.",
+       SERVER,
        SettingsCategory::Network);
   init("max-cached-digest-record-queued-kb",
        &max_cached_digest_record_queued_kb,
@@ -686,6 +766,39 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "amount of RECORD data to read from local log store at once",
        SERVER,
        SettingsCategory::ReadPath);
+  init("read-point-lookups-max-lsn-span",
+       &read_point_lookups_max_lsn_span,
+       "16",
+       parse_nonnegative<ssize_t>(),
+       "if nonzero, read storage tasks whose remaining LSN span is at most "
+       "this many LSNs are served with per-LSN point lookups instead of an "
+       "iterator. Benefits short re-reads near the tail, e.g. after a gap or "
+       "a record cache miss, where seeking an iterator reads whole blocks for "
+       "a handful of records; 0 disables point lookups",
+       SERVER,
+       SettingsCategory::ReadPath);
+  init("read-iterator-readahead-bytes",
+       &read_iterator_readahead_bytes,
+       "0",
+       parse_nonnegative<ssize_t>(),
+       "if nonzero, read iterators used by catching-up read streams prefetch "
+       "this many bytes of data blocks ahead of their position when moving "
+       "forward sequentially. Helps lagging readers that otherwise pay a "
+       "synchronous block read per batch; 0 disables readahead",
+       SERVER,
+       SettingsCategory::ReadPath);
+  init("record-batch-max-records",
+       &record_batch_max_records,
+       "0",
+       parse_nonnegative<ssize_t>(),
+       "if greater than 1, records of one read burst for a read stream are "
+       "shipped in RECORD_BATCH frames of up to this many records instead of "
+       "one RECORD message each, amortizing per-message framing for small "
+       "records. Only applies to clients that support RECORD_BATCH; streams "
+       "reading digests, extra metadata or byte offsets keep using plain "
+       "RECORD messages. 0 or 1 disables batching",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::ReadPath);
   init("max-record-read-execution-time",
        &max_record_read_execution_time,
        "1s",
@@ -693,6 +806,16 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "Maximum execution time for reading records. 'max' means no limit.",
        SERVER | EXPERIMENTAL,
        SettingsCategory::ResourceManagement);
+  init("read-storage-task-deadline",
+       &read_storage_task_deadline,
+       "1min",
+       validate_positive<ssize_t>(),
+       "How long a queued read storage task stays worth executing. Tasks that "
+       "wait longer than this on the storage task queue are sent back "
+       "unexecuted through the dropped path, since their consumer will have "
+       "given up on the result. 'max' means no deadline.",
+       SERVER,
+       SettingsCategory::ReadPath);
   init("read-requests",
        &requests_from_pipe,
        "128",
@@ -720,6 +843,15 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "number of LO_PRI requests to process per worker event loop iteration",
        SERVER | CLIENT,
        SettingsCategory::Execution);
+  init("worker-iteration-overrun-threshold",
+       &worker_iteration_overrun_threshold,
+       "10ms",
+       validate_positive<ssize_t>(),
+       "event loop task batches on a worker that run longer than this are "
+       "counted in the event_loop_iteration_overruns stat together with the "
+       "time spent over budget",
+       SERVER | CLIENT,
+       SettingsCategory::Execution);
   init("worker-request-pipe-capacity",
        &worker_request_pipe_capacity,
        "524288",
@@ -729,6 +861,26 @@ void Settings::defineSettings(SettingEasyInit& init) {
            debt as an MPSCQ-based request queue can be resized at any time. */
        ,
        SettingsCategory::Execution);
+  init("worker-queue-aware-routing",
+       &worker_queue_aware_routing,
+       "false",
+       nullptr,
+       "route requests that don't care which worker they run on to the less "
+       "loaded of two randomly chosen workers (by current request queue "
+       "depth) instead of a uniformly random worker",
+       SERVER | CLIENT,
+       SettingsCategory::Execution);
+  init("worker-map-reserved-capacity",
+       &worker_map_reserved_capacity,
+       "4096",
+       parse_positive<ssize_t>(),
+       "number of entries to reserve up front in each per-worker request "
+       "tracking map (running appends, log group cache, ...) to avoid "
+       "rehashing while the maps warm up",
+       SERVER | CLIENT | REQUIRES_RESTART /* applied when Workers are
+           created */
+       ,
+       SettingsCategory::Execution);
   init("prioritized-task-execution",
        &enable_executor_priority_queues,
        "true",
@@ -828,6 +980,17 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "(max_record_cache_snapshot_bytes / num_shards).",
        SERVER,
        SettingsCategory::Recovery);
+  init("record-cache-compressed-tier-size",
+       &record_cache_compressed_tier_size,
+       "0", // disabled
+       parse_nonnegative<ssize_t>(),
+       "If positive, keep records around for a while longer after they're "
+       "released and evicted from the record cache, LZ4-compressed, up to "
+       "this many bytes per shard. Readers that are slightly behind the tail "
+       "can then be served from memory instead of the local log store. 0 "
+       "disables the tier. Has no effect unless enable-record-cache is set.",
+       SERVER | REQUIRES_RESTART /* used in LogStorageStateMap ctor */,
+       SettingsCategory::ReadPath);
   init("record-cache-monitor-interval",
        &record_cache_monitor_interval,
        // use 2s by default since we can only receive 2.5GB in 2 sec over a
@@ -991,6 +1154,29 @@ void Settings::defineSettings(SettingEasyInit& init) {
        SERVER | REQUIRES_RESTART /* used in ServerProcessor init */,
        SettingsCategory::Monitoring);
 
+  init("health-monitor-shard-probe-interval",
+       &health_monitor_shard_probe_interval_ms,
+       "0s",
+       validate_nonnegative<ssize_t>(),
+       "Interval between rounds of active per-shard disk QoS probes (timed "
+       "writes and reads against each shard's database directory) issued by "
+       "the health monitor. The resulting per-shard scores are disseminated "
+       "through gossip and can be used to steer copysets away from degraded "
+       "disks (see --gray-shard-qos-threshold). 0 disables probing.",
+       SERVER | REQUIRES_RESTART /* used in Server init */,
+       SettingsCategory::Monitoring);
+
+  init("health-monitor-shard-probe-target-latency",
+       &health_monitor_shard_probe_target_latency_ms,
+       "50ms",
+       validate_positive<ssize_t>(),
+       "Latency at or below which the small (4KiB) shard QoS probe scores as "
+       "fully healthy (100). Scores degrade inversely with how far the worst "
+       "probe measurement overshoots its target. The large (1MiB) probe's "
+       "target is a fixed multiple of this.",
+       SERVER | REQUIRES_RESTART /* used in Server init */,
+       SettingsCategory::Monitoring);
+
   init("worker-stall-error-injection-chance",
        &worker_stall_error_injection_chance,
        "0",
@@ -1186,6 +1372,17 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "too long).",
        SERVER,
        SettingsCategory::WritePath);
+  init("append-overload-shedding",
+       &append_overload_shedding,
+       "false",
+       nullptr,
+       "If true, sequencers shed a fraction of incoming appends and append "
+       "probes proportional to the fraction of the log's nodeset write "
+       "headroom occupied by storage nodes that reported themselves "
+       "overloaded, failing fast with OVERLOADED instead of letting appends "
+       "time out once too few healthy nodes remain.",
+       SERVER,
+       SettingsCategory::WritePath);
   init("disabled-retry-interval",
        &disabled_retry_interval,
        "30s",
@@ -1303,6 +1500,21 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "Don't graylist nodes that have p95 store latency less than this.",
        SERVER,
        SettingsCategory::WritePath);
+
+  init("gray-shard-qos-threshold",
+       &gray_shard_qos_threshold,
+       "0",
+       validate_range<int>(0, 100),
+       "Minimum per-shard storage QoS score (0-100, measured by the shard's "
+       "node with active disk probes, see "
+       "--health-monitor-shard-probe-interval, and disseminated through "
+       "gossip) for a shard to be picked into copysets. Lets sequencers "
+       "steer appends away from disks that are degrading but not yet dead. "
+       "Keep this conservative (e.g. 20): if too many shards of a nodeset "
+       "score below the threshold, appends may fail to pick a copyset. "
+       "0 disables the check.",
+       SERVER,
+       SettingsCategory::WritePath);
   init("enable-read-throttling",
        &enable_read_throttling,
        "false",
@@ -1310,6 +1522,30 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "Throttle Disk I/O due to log read streams",
        SERVER,
        SettingsCategory::ReadPath);
+  init("traffic-shaping-cross-scope-sharing",
+       &traffic_shaping_cross_scope_sharing,
+       "false",
+       nullptr, // no validation
+       "If true, traffic shaping priority queue credit that a broader scope "
+       "(e.g. RACK) could not place in its buckets during the last quantum is "
+       "donated to the next narrower enabled scope (e.g. NODE) instead of "
+       "being discarded, making the shaper work-conserving across scopes. "
+       "Per-priority guarantees, burst capacities and deposit budgets of the "
+       "receiving scope still apply to the donated credit.",
+       SERVER | CLIENT,
+       SettingsCategory::Network);
+  init("traffic-shaper-update-interval",
+       &traffic_shaper_update_interval,
+       "1ms",
+       validate_positive<ssize_t>(),
+       "Interval between traffic shaper bandwidth credit dispatches to the "
+       "Senders' flow groups. A bandwidth-limited message waits up to one "
+       "interval for the next refill, so lowering this (e.g. to 250us) cuts "
+       "shaping-induced latency jitter at the cost of more frequent update "
+       "runs. Credit amounts are normalized to the interval, so configured "
+       "bandwidth limits are unaffected.",
+       SERVER,
+       SettingsCategory::Network);
   init("enable-adaptive-store-timeout",
        &enable_adaptive_store_timeout,
        "false",
@@ -1383,6 +1619,19 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "before the queue is considered overloaded",
        SERVER,
        SettingsCategory::ResourceManagement);
+  init("storage-queue-sojourn-overload-threshold",
+       &storage_queue_sojourn_overload_threshold,
+       "0ms",
+       validate_nonnegative<ssize_t>(),
+       "if positive, a worker's storage task queue is considered overloaded "
+       "while tasks spend more than this long in the queue on average before "
+       "a storage thread picks them up (with hysteresis: the state is left "
+       "once the average falls below half the threshold). Replaces the "
+       "queue-length based --queue-size-overload-percentage check, which "
+       "needs per-fleet tuning on heterogeneous disks. 0 keeps the "
+       "queue-length check.",
+       SERVER,
+       SettingsCategory::ResourceManagement);
   init("concurrent-log-recoveries",
        &concurrent_log_recoveries,
        "400",
@@ -1439,6 +1688,36 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "apply to new reader instances",
        SERVER | CLIENT,
        SettingsCategory::ReadPath);
+  init("client-adaptive-read-window",
+       &client_adaptive_read_window,
+       "false",
+       nullptr,
+       "if true, the client adapts each read stream's flow-control window to "
+       "the observed delivery rate, record sizes and redelivery activity "
+       "instead of always opening it to the full read buffer. "
+       "client-read-buffer-size remains the upper bound",
+       CLIENT | EXPERIMENTAL,
+       SettingsCategory::ReadPath);
+  init("client-read-window-max-bytes",
+       &client_read_window_max_bytes,
+       "33554432", // 32MB
+       parse_positive<ssize_t>(),
+       "rough cap on the amount of record payload a single read stream keeps "
+       "in flight when client-adaptive-read-window is enabled; converted into "
+       "a record count using the observed average record size",
+       CLIENT | EXPERIMENTAL,
+       SettingsCategory::ReadPath);
+  init("zero-copy-record-delivery",
+       &zero_copy_record_delivery,
+       "false",
+       nullptr,
+       "if true, RECORD payloads of any size are delivered as refcounted "
+       "slices of the socket receive buffer instead of being copied out of "
+       "it. Saves a memcpy per record for high-throughput readers, at the "
+       "cost of pinning receive buffers for as long as the application holds "
+       "on to delivered records",
+       SERVER | CLIENT | EXPERIMENTAL,
+       SettingsCategory::ReadPath);
   init("client-read-flow-control-threshold",
        &client_read_flow_control_threshold,
        "0.7",
@@ -1455,6 +1734,39 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "Set it to 0 to disable the epoch metadata cache.",
        CLIENT | REQUIRES_RESTART,
        SettingsCategory::ReadPath);
+  init("epoch-metadata-cache-path",
+       &epoch_metadata_cache_path,
+       "",
+       nullptr, // no validation
+       "if non-empty, path of a file used to persist the client-side epoch "
+       "metadata cache across restarts. The cache is written out on clean "
+       "client shutdown and restored on startup; restored entries are "
+       "treated as unconfirmed and re-verified against the metadata log "
+       "before being used for anything that requires consistency.",
+       CLIENT | REQUIRES_RESTART,
+       SettingsCategory::ReadPath);
+  init("sequencer-hints-path",
+       &sequencer_hints_path,
+       "",
+       nullptr, // no validation
+       "if non-empty, path of a file used to persist which node ran the "
+       "sequencer for each log this client talked to (along with the last "
+       "released LSN it reported) across restarts. On the next run the first "
+       "message for a log is sent straight to the remembered node instead of "
+       "going through sequencer placement; stale hints are corrected by the "
+       "normal redirect machinery. Useful for short-lived clients such as "
+       "periodic batch jobs.",
+       CLIENT | REQUIRES_RESTART,
+       SettingsCategory::WritePath);
+  init("sequencer-hints-max-age",
+       &sequencer_hints_max_age,
+       "24h",
+       validate_positive<ssize_t>(),
+       "sequencer hints restored from --sequencer-hints-path that are older "
+       "than this are discarded on startup; hints this stale are more likely "
+       "to cost a redirect than to save one.",
+       CLIENT | REQUIRES_RESTART,
+       SettingsCategory::WritePath);
   init("client-readers-flow-tracer-period",
        &client_readers_flow_tracer_period,
        "0s",
@@ -1622,6 +1934,16 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "When non-zero, replaces gap-grace-period for metadata logs.",
        SERVER | CLIENT,
        SettingsCategory::ReadPath);
+  init("metadata-log-cache-max-logs",
+       &metadata_log_cache_max_logs,
+       "10000",
+       parse_nonnegative<ssize_t>(),
+       "Maximum number of logs whose metadata log contents are cached in "
+       "memory, so that requests for historical epoch metadata strictly below "
+       "the last record's epoch can be answered without reading from the "
+       "metadata nodeset. 0 disables the cache.",
+       SERVER | CLIENT,
+       SettingsCategory::ReadPath);
   init("reader-stalled-grace-period",
        &reader_stalled_grace_period,
        "30s",
@@ -1811,6 +2133,52 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "accept",
        SERVER | CLIENT,
        SettingsCategory::Network);
+  init("release-coalescing-window",
+       &release_coalescing_window,
+       "0us",
+       validate_nonnegative<ssize_t>(),
+       "Micro-window over which RELEASE messages triggered by Appender "
+       "reaping are coalesced: within the window only the highest released "
+       "LSN per (storage shard, log) is kept and one RELEASE is sent when "
+       "the window closes. 0 sends RELEASEs immediately. Periodic release "
+       "broadcasting is unaffected.",
+       SERVER | REQUIRES_RESTART /* sized into per-Worker state */,
+       SettingsCategory::WritePath);
+  init("appended-reply-coalescing-enabled",
+       &appended_reply_coalescing_enabled,
+       "false",
+       nullptr,
+       "If true, APPENDED replies to the same client connection are "
+       "coalesced and sent as one APPENDED_BATCH message per event loop "
+       "iteration instead of one message per append. Only takes effect for "
+       "clients whose connection speaks protocol version "
+       "APPENDED_BATCH_MESSAGE_SUPPORT or newer; older clients keep "
+       "receiving plain APPENDED.",
+       SERVER,
+       SettingsCategory::WritePath);
+  init("append-batch-max-records",
+       &append_batch_max_records,
+       "0",
+       parse_nonnegative<ssize_t>(),
+       "If nonzero, appends to the same log and sequencer node issued "
+       "within one client event loop iteration are coalesced into a single "
+       "APPEND_BATCH message of up to this many records. Each record still "
+       "gets its own LSN and its own APPENDED reply; only protocol framing "
+       "and per-message dispatch are amortized. Appends with custom keys, "
+       "custom counters, write streams or payload groups, and appends to "
+       "nodes whose connection predates protocol version "
+       "APPEND_BATCH_MESSAGE_SUPPORT, are sent as plain APPEND. 0 disables "
+       "batching.",
+       CLIENT,
+       SettingsCategory::WritePath);
+  init("append-batch-max-payload-bytes",
+       &append_batch_max_payload_bytes,
+       "1048576", // 1MB
+       parse_positive<ssize_t>(),
+       "An APPEND_BATCH message under construction is flushed early once "
+       "the total size of its payloads reaches this many bytes.",
+       CLIENT,
+       SettingsCategory::WritePath);
   init("max-total-appenders-size-soft",
        &max_total_appenders_size_soft,
        "524288000", // 500MB
@@ -1866,6 +2234,18 @@ void Settings::defineSettings(SettingEasyInit& init) {
       "appends will fail.",
       SERVER | REQUIRES_RESTART /* Passed to Sequencer ctor */,
       SettingsCategory::Sequencer);
+  init("sequencer-recent-records-cache-bytes",
+       &sequencer_recent_records_cache_bytes,
+       "0",
+       validate_nonnegative<ssize_t>(),
+       "If positive, sequencers keep an in-memory ring of the most recently "
+       "appended records, up to this many payload bytes per log, and serve "
+       "them to tailing readers through the GET_TAIL_RECORDS API without a "
+       "storage node round trip. 0 (default) disables the cache. Readers that "
+       "fall behind the ring get E::STALE and must fall back to reading from "
+       "storage nodes.",
+       SERVER | REQUIRES_RESTART /* Passed to Sequencer ctor */,
+       SettingsCategory::Sequencer);
   init("epoch-draining-timeout",
        &epoch_draining_timeout,
        "2s",
@@ -2008,6 +2388,16 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "format to the parent znode",
        SERVER,
        SettingsCategory::EpochStore);
+  init("epoch-store-batch-zk-writes",
+       &epoch_store_batch_zk_writes,
+       "false",
+       nullptr, // no validation
+       "If set, znode writes of concurrent Zookeeper epoch store requests "
+       "are batched into Zookeeper multi-ops while a previous write is in "
+       "flight. Each write stays conditional on the znode version it read; "
+       "a conflict aborting a batch makes its members retry individually",
+       SERVER,
+       SettingsCategory::EpochStore);
   init("ssl-load-client-cert",
        &ssl_load_client_cert,
        "false",
@@ -2051,6 +2441,16 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "cached sessions.",
        SERVER | CLIENT,
        SettingsCategory::Security);
+  init("ssl-enable-ktls",
+       &ssl_enable_ktls,
+       "false",
+       nullptr,
+       "If enabled, symmetric encryption of established SSL connections is "
+       "offloaded to the kernel (kTLS) when the OpenSSL build, the negotiated "
+       "cipher and the running kernel support it. Connections fall back to "
+       "userspace encryption otherwise.",
+       SERVER | CLIENT | REQUIRES_RESTART /* used in Worker ctor */,
+       SettingsCategory::Security);
   init("ssl-boundary",
        &ssl_boundary,
        "none",
@@ -2107,6 +2507,30 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "\"any\" or \"\" to keep the default.",
        SERVER | REQUIRES_RESTART /* used once when ExecStorageThread starts */,
        SettingsCategory::ResourceManagement);
+  init(
+      "storage-pool-cpu-affinity",
+      &storage_pool_cpu_affinity,
+      "",
+      [](const std::string& val)
+          -> folly::Optional<std::unordered_map<int, std::vector<int>>> {
+        folly::Optional<std::unordered_map<int, std::vector<int>>> res;
+        if (parse_shard_cpu_affinity(val, &res) != 0) {
+          throw boost::program_options::error(
+              "value of --storage-pool-cpu-affinity must be of the form "
+              "<shard>:<cpu-list>[;<shard>:<cpu-list>;...], where <cpu-list> "
+              "is a comma-separated list of CPUs and inclusive CPU ranges, "
+              "e.g. 0:0-15;1:16-31; " +
+              val + " given.");
+        }
+        return res;
+      },
+      "Per-shard CPU affinity for storage threads, e.g. 0:0-15;1:16-31. "
+      "Restricts each shard's storage thread pool to the given CPUs so that "
+      "on multi-socket hosts a shard's threads stay on the NUMA node that "
+      "holds the shard's memory, avoiding cross-socket traffic on reads. "
+      "\"any\" or \"\" to not pin.",
+      SERVER | REQUIRES_RESTART /* used once when ExecStorageThread starts */,
+      SettingsCategory::ResourceManagement);
 
   init("checksumming-enabled",
        &checksumming_enabled,
@@ -2138,6 +2562,53 @@ void Settings::defineSettings(SettingEasyInit& init) {
       SERVER | CLIENT | REQUIRES_RESTART | EXPERIMENTAL,
       SettingsCategory::Network);
 
+  init("checksumming-skip-ssl",
+       &checksumming_skip_ssl,
+       "false",
+       nullptr, // no validation
+       "If true, protocol-layer checksums are neither generated nor verified "
+       "on SSL connections, whose TLS record MACs already guarantee hop "
+       "integrity. The end-to-end payload checksum carried in records is "
+       "still verified at append ingress and record delivery. Only consulted "
+       "when checksumming-enabled is true.",
+       SERVER | CLIENT | EXPERIMENTAL,
+       SettingsCategory::Network);
+
+  init("protocol-compression-enabled",
+       &protocol_compression_enabled,
+       "false",
+       nullptr, // no validation
+       "If true, offer transparent zstd compression of protocol messages "
+       "during handshake. A message is compressed only when both connection "
+       "ends have this enabled, the negotiated protocol version supports it, "
+       "and compressing actually shrinks the serialized message. Trades CPU "
+       "for wire bytes; most useful on bandwidth-constrained (e.g. "
+       "cross-datacenter) connections.",
+       SERVER | CLIENT | EXPERIMENTAL,
+       SettingsCategory::Network);
+
+  init("protocol-compression-threshold",
+       &protocol_compression_threshold,
+       "4096",
+       parse_positive<ssize_t>(),
+       "Serialized messages smaller than this many bytes are never "
+       "compressed: small messages rarely shrink enough to pay for the "
+       "per-message zstd overhead. Only consulted when "
+       "protocol-compression-enabled is true.",
+       SERVER | CLIENT | EXPERIMENTAL,
+       SettingsCategory::Network);
+
+  init("protocol-compression-zstd-level",
+       &protocol_compression_zstd_level,
+       "1",
+       parse_validate_range<int>(1, ZSTD_maxCLevel()),
+       "zstd compression level for protocol messages. Level 1 already "
+       "shrinks typical record payloads substantially and sits on the hot "
+       "send path; higher levels cost disproportionally more CPU. Only "
+       "consulted when protocol-compression-enabled is true.",
+       SERVER | CLIENT | EXPERIMENTAL,
+       SettingsCategory::Network);
+
   init("scd-timeout",
        &scd_timeout,
        "300s",
@@ -2313,6 +2784,17 @@ void Settings::defineSettings(SettingEasyInit& init) {
                                              StatsCollectionThread */
        ,
        SettingsCategory::Monitoring);
+  init("stats-background-aggregation-interval",
+       &stats_background_aggregation_interval,
+       "0ms", // disabled
+       validate_nonnegative<ssize_t>(),
+       "If positive, aggregate stats across all threads on a background "
+       "thread at this interval, and serve the 'stats2 --cached' admin "
+       "command from the resulting snapshot instead of walking all "
+       "thread-local stats instances on every scrape. 0 disables background "
+       "aggregation.",
+       SERVER | REQUIRES_RESTART /* enabled during server startup */,
+       SettingsCategory::Monitoring);
   init(
       "esn-bits",
       &esn_bits,
@@ -2442,6 +2924,19 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "thread.",
        SERVER | CLIENT,
        SettingsCategory::Batching);
+  init("reader-bg-decode-bytes-threshold",
+       &reader_bg_decode_bytes_threshold,
+       "0",
+       parse_nonnegative<ssize_t>(),
+       "If positive, buffered-write batches of at least this many bytes are "
+       "decoded on the client Processor's background threads instead of "
+       "inline.  For AsyncReader this means the Worker delivering a large "
+       "batch doesn't block record delivery for other logs; for Reader it "
+       "means queued batches decompress in parallel instead of one at a time "
+       "in the application's read() loop.  If 0 (default), all batches are "
+       "decoded inline.",
+       CLIENT | EXPERIMENTAL,
+       SettingsCategory::ReadPath);
   init("buffered-writer-zstd-level",
        &buffered_writer_zstd_level,
        "1",
@@ -2495,6 +2990,20 @@ void Settings::defineSettings(SettingEasyInit& init) {
       "use in production emergencies only.",
       SERVER,
       SettingsCategory::Performance);
+  init(
+      "check-seal-cache-ttl",
+      &check_seal_cache_ttl,
+      "0ms",
+      validate_nonnegative<ssize_t>(),
+      "if positive, a successful 'check seal' round triggered by a 'get "
+      "sequencer state' request is remembered on the sequencer for this long, "
+      "and further 'get sequencer state' requests for the same log arriving "
+      "within the TTL are answered from local sequencer state without "
+      "repeating the storage node fan-out. Caps the CHECK_SEAL load at one "
+      "round per log per TTL during client reconnect waves, at the cost of "
+      "results being up to the TTL stale. 0 disables the cache.",
+      SERVER,
+      SettingsCategory::Performance);
   init("recovery-seq-metadata-timeout",
        &recovery_seq_metadata_timeout,
        "2s..60s",
@@ -2567,6 +3076,21 @@ void Settings::defineSettings(SettingEasyInit& init) {
       "server.",
       SERVER | CLIENT,
       SettingsCategory::Configuration);
+  init(
+      "logsconfig-manager-publish-cooldown",
+      &logsconfig_manager_publish_cooldown,
+      "100ms",
+      validate_nonnegative<ssize_t>(),
+      "Minimum interval between two successive publishes of the logs config "
+      "when logsconfig-manager-grace-period is zero. The first update of a "
+      "burst is published immediately; updates applied within the cooldown "
+      "window are coalesced into a single publish when it expires. Every "
+      "publish clones the whole logs config tree, so this bounds the cloning "
+      "cost of a burst of deltas (e.g. bulk provisioning of log groups) "
+      "without delaying isolated updates. Set to 0 to publish every update "
+      "immediately.",
+      SERVER | CLIENT,
+      SettingsCategory::Configuration);
   init("logsconfig-snapshotting",
        &logsconfig_snapshotting,
        "true",
@@ -2931,6 +3455,18 @@ void Settings::defineSettings(SettingEasyInit& init) {
        SERVER | DEPRECATED,
        SettingsCategory::WritePath);
 
+  init("copyset-cache-size",
+       &copyset_cache_size,
+       "0",
+       parse_nonnegative<ssize_t>(),
+       "Number of precomputed copysets that a sequencer reuses round-robin "
+       "per epoch instead of running the copyset selector on every append. "
+       "The cache is invalidated whenever any shard in the nodeset changes "
+       "availability state (out of space, slow, probing). 0 disables "
+       "caching. Has no effect on logs with sticky copysets.",
+       SERVER,
+       SettingsCategory::WritePath);
+
   init("copyset-locality-min-scope",
        &copyset_locality_min_scope,
        "rack",
@@ -3086,6 +3622,18 @@ void Settings::defineSettings(SettingEasyInit& init) {
        SERVER | EXPERIMENTAL,
        SettingsCategory::ReadPath);
 
+  init("real-time-fast-delivery",
+       &real_time_fast_delivery,
+       "false", // default
+       nullptr, // no custom validation necessary
+       "If true, a read stream woken up by a release whose records are "
+       "already in the real-time record buffer is processed immediately "
+       "instead of being held for the log's delivery-latency batching "
+       "window; delivery is a pure in-memory push on the worker. Only "
+       "effective with real-time-reads-enabled.",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::ReadPath);
+
   init("reject-stores-based-on-copyset",
        &reject_stores_based_on_copyset,
        "true",
@@ -3108,6 +3656,19 @@ void Settings::defineSettings(SettingEasyInit& init) {
        CLIENT | DEPRECATED,
        SettingsCategory::ReaderFailover);
 
+  init("read-stream-esn-digests",
+       &read_stream_esn_digests,
+       "false",
+       nullptr, // no validation
+       "If true, when gap detection finds a gap candidate, readers ask the "
+       "storage nodes that haven't chimed in for a compact per-epoch digest "
+       "of which ESNs they have (built from the copyset index), and use the "
+       "absent ESNs for gap detection in bulk instead of waiting for "
+       "individual gap messages from each node. Requires all storage nodes "
+       "to run a protocol version that supports GET_ESN_DIGEST.",
+       CLIENT | EXPERIMENTAL,
+       SettingsCategory::ReaderFailover);
+
   init("read-streams-use-metadata-log-only",
        &read_streams_use_metadata_log_only,
        "true",
@@ -3419,6 +3980,21 @@ void Settings::defineSettings(SettingEasyInit& init) {
       SERVER | CLIENT | REQUIRES_RESTART,
       SettingsCategory::Core);
 
+  init("rsm-snapshot-cache-dir",
+       &rsm_snapshot_cache_dir,
+       "",
+       nullptr,
+       "if set on a client, directory where RSM snapshots (most importantly "
+       "LogsConfig) fetched from the cluster are cached in local files. On "
+       "startup, a state machine whose cached snapshot satisfies the "
+       "requested version is bootstrapped from the cache and only tails the "
+       "delta log, instead of waiting for a snapshot fetch from the cluster. "
+       "This makes warm restarts of short-lived clients much faster on "
+       "clusters with a large LogsConfig. The directory must exist. Only "
+       "used when rsm-snapshot-store-type is local-store",
+       CLIENT | REQUIRES_RESTART,
+       SettingsCategory::Core);
+
   init("rsm-snapshot-enable-dual-writes",
        &rsm_snapshot_enable_dual_writes,
        "true",
@@ -3428,6 +4004,20 @@ void Settings::defineSettings(SettingEasyInit& init) {
        SERVER,
        SettingsCategory::Core);
 
+  init("rsm-snapshot-chunk-size",
+       &rsm_snapshot_chunk_size,
+       "0",
+       parse_nonnegative<ssize_t>(),
+       "if non-zero, RSM snapshots bigger than this many bytes are written "
+       "to the snapshot log as several chunk records of at most this size "
+       "instead of one record, so that snapshots are not limited by "
+       "max-payload-size. Readers re-assemble the chunks transparently. Only "
+       "enable this once all nodes and clients that read the snapshot log "
+       "run a version that understands chunked snapshots, and only with "
+       "rsm-snapshot-store-type log or local-store. 0 disables chunking.",
+       SERVER,
+       SettingsCategory::Core);
+
   init("eventlog-snapshotting-period",
        &eventlog_snapshotting_period,
        "1h",
@@ -3522,6 +4112,18 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "and use HHWheelTimer backend.",
        SERVER | CLIENT | REQUIRES_RESTART,
        SettingsCategory::Core);
+  init("enable-worker-local-timer-wheel",
+       &enable_worker_local_timer_wheel,
+       "false",
+       nullptr, // no validation
+       "Fire timers from the HHWheelTimer embedded in each worker's own "
+       "event base instead of the shared wheel thread. Schedule and cancel "
+       "are O(1) and stay on the worker, avoiding a cross-thread hop and an "
+       "allocation per activation; useful on nodes with a large number of "
+       "in-flight store/retry timers. Takes precedence over "
+       "enable-hh-wheel-backed-timers.",
+       SERVER | CLIENT | REQUIRES_RESTART,
+       SettingsCategory::Core);
   init("enable-store-histograms-calculations",
        &enable_store_histogram_calculations,
        "false",
@@ -3631,6 +4233,41 @@ void Settings::defineSettings(SettingEasyInit& init) {
        SERVER,
        SettingsCategory::Sequencer);
 
+  init("sequencer-load-spreading-period",
+       &sequencer_load_spreading_period,
+       "0s",
+       validate_nonnegative<ssize_t>(),
+       "If not zero, how often each sequencer node compares the combined "
+       "append throughput of its sequencers against "
+       "--sequencer-load-spreading-threshold. When the threshold is "
+       "exceeded, the heaviest logs' sequencers are relocated to other "
+       "nodes: new appends for those logs are redirected to a node picked "
+       "with the same weighted hash that clients use, excluding this node. "
+       "Zero disables load spreading.",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::Sequencer);
+
+  init("sequencer-load-spreading-threshold",
+       &sequencer_load_spreading_threshold,
+       "100M",
+       parse_nonnegative<size_t>(),
+       "Combined append throughput (in bytes per second) of the sequencers "
+       "on a node above which the node starts relocating its heaviest logs' "
+       "sequencers to other nodes. Only used if "
+       "--sequencer-load-spreading-period is nonzero.",
+       SERVER,
+       SettingsCategory::Sequencer);
+
+  init("sequencer-load-spreading-max-logs",
+       &sequencer_load_spreading_max_logs,
+       "1",
+       parse_positive<ssize_t>(),
+       "Maximum number of logs whose sequencers are relocated away per "
+       "--sequencer-load-spreading-period. Keeps the relocations gradual: "
+       "each relocation reactivates the log's sequencer on another node.",
+       SERVER,
+       SettingsCategory::Sequencer);
+
   sequencer_boycotting.defineSettings(init);
 
   init("require-permission-message-types",
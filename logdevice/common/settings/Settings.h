@@ -126,6 +126,16 @@ struct Settings : public SettingsBundle {
   // transitions into an UNHEALTHY state in the HM.
   double health_monitor_max_stalled_worker_percentage;
 
+  // Interval between rounds of active per-shard disk QoS probes (timed
+  // writes and reads against each shard's database directory) issued by the
+  // health monitor. Zero disables probing.
+  std::chrono::milliseconds health_monitor_shard_probe_interval_ms;
+
+  // Latency at or below which the small (4KiB) shard QoS probe scores as
+  // fully healthy; the large (1MiB) probe's target is a fixed multiple of
+  // this.
+  std::chrono::milliseconds health_monitor_shard_probe_target_latency_ms;
+
   // Used to simulate delayed request execution in a worker thread by adding a
   // fixed value onto the real execution time. Expressed as a percentage: 100 =
   // 100%.
@@ -148,6 +158,11 @@ struct Settings : public SettingsBundle {
   // If true, turn off TraceLogger by using NoopTraceLogger implementation
   bool trace_logger_disabled;
 
+  // If nonzero, wrap the TraceLogger in a BufferedTraceLogger with a queue
+  // of this many samples, delivering samples to the underlying plugin from
+  // a dedicated thread instead of the thread that produced them.
+  size_t trace_logger_queue_size;
+
   // If false: no checksumming is done at the Protocol Layer
   // If true: 'checksumming_blacklisted_messages' is consulted
   bool checksumming_enabled;
@@ -157,6 +172,26 @@ struct Settings : public SettingsBundle {
   // see .cpp for examples
   std::set<char> checksumming_blacklisted_messages;
 
+  // If true, protocol-layer checksums are neither generated nor verified
+  // on SSL connections: TLS record MACs already protect the hop, and the
+  // end-to-end payload checksum carried in the record (see
+  // Appender::verifyChecksum() and LocalLogStoreRecordFormat checksum
+  // flags) is still verified at append ingress and record delivery.
+  bool checksumming_skip_ssl;
+
+  // If true, handshakes offer transparent zstd compression of protocol
+  // messages. Messages whose serialized size is at least
+  // protocol_compression_threshold are sent as COMPRESSED wrappers when both
+  // connection ends enabled this setting and the negotiated protocol
+  // supports it. See Connection::maybeCompressMessage().
+  bool protocol_compression_enabled;
+
+  // Serialized messages smaller than this many bytes are never compressed
+  size_t protocol_compression_threshold;
+
+  // zstd compression level used for COMPRESSED protocol frames
+  int protocol_compression_zstd_level;
+
   // maximum number of megabytes we can have pending in all output
   // evbuffers of all Sockets on each EventLoop managed by this
   // Processor. The total number of pending output bytes per Processor
@@ -185,6 +220,15 @@ struct Settings : public SettingsBundle {
   // setsockopt(TCP_NODELAY).
   bool nagle;
 
+  // If nonzero, enable MSG_ZEROCOPY on new non-SSL TCP sockets and send
+  // write chains of at least this many bytes by reference: the NIC DMAs
+  // the record payloads straight out of the message buffers and the kernel
+  // releases them on its transmit completion, instead of copying them into
+  // socket memory. Writes below the threshold use the regular copying path
+  // since the completion machinery costs more than the memcpy it saves.
+  // 0 (default) disables zero-copy sends.
+  size_t tcp_zero_copy_threshold;
+
   // Forces no scd mode for read streams associated with RSM.
   bool rsm_force_all_send_all;
 
@@ -226,18 +270,54 @@ struct Settings : public SettingsBundle {
   std::chrono::milliseconds idle_connection_keep_alive;
   // Limits the number of idle connections closed during single check
   size_t rate_limit_idle_connection_closed;
+  // If enabled, servers also close incoming connections that have been
+  // inactive for idle_connection_keep_alive. The peer transparently
+  // reconnects when it needs the connection again.
+  bool close_idle_incoming_connections;
 
   // How many kilobytes of RECORD messages the delivery code tries to push
   // to the client at once.  If -1, use the TCP sendbuf size.
   int output_max_records_kb;
 
+  // If true, a catching-up read stream issues its next storage read once
+  // the output buffer has drained halfway instead of waiting for it to
+  // drain completely, overlapping disk reads with network sends.
+  bool catchup_readahead;
+
+  // If true, size each read stream's batches from the client's observed
+  // socket drain rate instead of always using the full byte budget.
+  bool adaptive_catchup_batches;
+
+  // If true, when a read stream that includes byte offsets delivers a bridge
+  // record, prefetch the next epoch's offsets from per-epoch metadata so the
+  // first records of the new epoch don't ship without offsets.
+  bool prefetch_epoch_offsets;
+
   // How many bytes of records to read in a single StorageTask.
   // Similar to output_max_records_kb but is applied *before* filtering records.
   int64_t max_record_bytes_read_at_once;
 
+  // If nonzero, read storage tasks whose remaining LSN span is at most this
+  // many LSNs are served with per-LSN point lookups
+  // (LocalLogStoreReader::readPointLookups()) instead of an iterator.
+  size_t read_point_lookups_max_lsn_span;
+
+  // If nonzero, read iterators used by catching-up read streams prefetch
+  // this many bytes of data blocks ahead of their position.
+  size_t read_iterator_readahead_bytes;
+
+  // If greater than 1, records of one read burst for a read stream are
+  // shipped to capable clients in RECORD_BATCH frames of up to this many
+  // records instead of one RECORD message each.
+  size_t record_batch_max_records;
+
   // Maximum execution time for reading records
   std::chrono::milliseconds max_record_read_execution_time;
 
+  // How long a queued ReadStorageTask stays worth executing. Tasks that wait
+  // longer than this on the storage task queue are sent back unexecuted.
+  std::chrono::milliseconds read_storage_task_deadline;
+
   // @deprecated
   unsigned requests_from_pipe;
 
@@ -249,6 +329,11 @@ struct Settings : public SettingsBundle {
   uint32_t mid_requests_per_iteration;
   uint32_t lo_requests_per_iteration;
 
+  // Event loop task batches that run longer than this are counted in the
+  // event_loop_iteration_overruns stat; observability for worker-induced
+  // latency variance, nothing is preempted.
+  std::chrono::milliseconds worker_iteration_overrun_threshold;
+
   // Size worker request pipe to hold this many requests.
   //
   // NOTE: This currently translates to a fcntl(F_SETPIPE_SZ) call which is
@@ -257,6 +342,18 @@ struct Settings : public SettingsBundle {
   // limit on Linux.
   size_t worker_request_pipe_capacity;
 
+  // If true, requests without a thread affinity are routed to the less
+  // loaded of two randomly chosen workers, by current request queue depth,
+  // instead of a uniformly random worker. Evens out per-worker utilization
+  // when the log-to-worker hashing leaves some workers much hotter than
+  // others.
+  bool worker_queue_aware_routing;
+
+  // Number of entries to reserve up front in each per-worker request
+  // tracking map (running appends, log group cache, ...) so that the maps
+  // don't rehash while warming up.
+  size_t worker_map_reserved_capacity;
+
   // Indicates whether prioritized queues are used with the CPU Threadpool.
   // Request and message processing priorities are honored when this is set to
   // true. Otherwise, all requests and messages are considered same priority.
@@ -295,6 +392,16 @@ struct Settings : public SettingsBundle {
   // Setting to control read I/O bandwidth throttling.
   bool enable_read_throttling;
 
+  // If true, traffic shaping bandwidth credit that a broader scope (e.g.
+  // RACK) could not place in its buckets is donated to the next narrower
+  // enabled scope (e.g. NODE) instead of being discarded.
+  bool traffic_shaping_cross_scope_sharing;
+
+  // Interval between bandwidth credit dispatches to the Senders' flow
+  // groups. Bounds the latency a bandwidth-limited message can spend queued
+  // waiting for the next refill.
+  std::chrono::microseconds traffic_shaper_update_interval;
+
   // A way to turn off putting nodes in graylist, to be able to revert
   // to normal copyset selection behavior.
   bool disable_graylisting;
@@ -316,6 +423,11 @@ struct Settings : public SettingsBundle {
   // See .cpp
   std::chrono::milliseconds graylisting_min_latency;
 
+  // Minimum per-shard storage QoS score (0-100, as published through gossip
+  // by the shard's node) for a shard to be picked into copysets. 0 disables
+  // the check.
+  int gray_shard_qos_threshold;
+
   // Enable adaptive store timeouts. Which will use per worker histograms to
   // estimate first wave timeout.
   bool enable_adaptive_store_timeout;
@@ -336,6 +448,11 @@ struct Settings : public SettingsBundle {
   // in record cache snapshots
   size_t record_cache_max_size;
 
+  // if positive, size in bytes (per shard) of the compressed second tier of
+  // the record cache, holding recently released-and-evicted records so that
+  // slightly-behind readers can be served from memory. 0 disables the tier
+  size_t record_cache_compressed_tier_size;
+
   // polling interval for the record cache eviction thread for monitoring the
   // size of the record cache
   std::chrono::seconds record_cache_monitor_interval;
@@ -451,6 +568,13 @@ struct Settings : public SettingsBundle {
   // temporarily disabled in the NodeSetState.
   std::chrono::seconds overloaded_retry_interval;
 
+  // If true, sequencers shed a fraction of incoming appends (and append
+  // probes) proportional to the fraction of the log's nodeset write headroom
+  // occupied by shards graylisted as overloaded, failing fast with
+  // E::OVERLOADED instead of letting appends time out once the nodeset can
+  // no longer absorb the load.
+  bool append_overload_shedding;
+
   // Time interval that Appenders would retry sending STOREs to a storage node
   // after it reported persistent error or rebuilding
   // (DISABLED status in STORED message) and
@@ -521,6 +645,12 @@ struct Settings : public SettingsBundle {
   // before the queue is treated as being overloaded.
   int queue_size_overload_percentage;
 
+  // If positive, judge storage task queue overload by how long tasks spend
+  // queued before a storage thread picks them up instead of by the static
+  // queue-length thresholds above. See
+  // PerWorkerStorageTaskQueue::noteTaskSojournTime().
+  std::chrono::milliseconds storage_queue_sojourn_overload_threshold;
+
   // How long to wait before retrying to send RELEASE messages to storage nodes.
   chrono_expbackoff_t<std::chrono::milliseconds> release_retry_interval;
 
@@ -611,6 +741,10 @@ struct Settings : public SettingsBundle {
   std::chrono::milliseconds data_log_gap_grace_period;
   std::chrono::milliseconds metadata_log_gap_grace_period;
 
+  // maximum number of logs whose metadata log contents are cached
+  // process-wide by MetaDataLogReader; 0 disables the cache
+  size_t metadata_log_cache_max_logs;
+
   // @see Settings.cpp
   std::chrono::milliseconds reader_stalled_grace_period;
 
@@ -663,6 +797,24 @@ struct Settings : public SettingsBundle {
   // Client::createReader()
   size_t client_read_buffer_size;
 
+  // (client-only setting) If true, ClientReadStream adapts its flow-control
+  // window size from the delivery rate, record sizes and redelivery activity
+  // observed by ClientReadersFlowTracer, instead of always opening the window
+  // to the full read buffer. client-read-buffer-size remains the upper bound.
+  bool client_adaptive_read_window;
+
+  // (client-only setting) Rough cap, in bytes, on the record payload a single
+  // read stream keeps in flight when client-adaptive-read-window is enabled.
+  // Converted to a record count using the observed average record size.
+  size_t client_read_window_max_bytes;
+
+  // If true, RECORD payloads of any size are delivered as refcounted slices
+  // of the socket receive buffer instead of being copied out of it. Saves a
+  // memcpy per record at the cost of pinning receive buffers for as long as
+  // delivered records are held. Applies wherever RECORD messages are received
+  // (clients, and servers during rebuilding reads).
+  bool zero_copy_record_delivery;
+
   // (client-only setting) Threshold (relative to buffer size) at which
   // ClientReadStream broadcasts WINDOW messages to storage nodes.  Smaller
   // values mean more frequent broadcasting, possibly increasing throughput
@@ -673,6 +825,18 @@ struct Settings : public SettingsBundle {
   // the client. Set it to 0 to disable epoch metadata caching
   size_t client_epoch_metadata_cache_size;
 
+  // (client-only setting) if non-empty, path of a file used to persist the
+  // epoch metadata cache across client restarts
+  std::string epoch_metadata_cache_path;
+
+  // (client-only setting) if non-empty, path of a file used to persist
+  // per-log sequencer routing hints across client restarts
+  std::string sequencer_hints_path;
+
+  // (client-only setting) restored sequencer hints older than this are
+  // discarded on startup
+  std::chrono::milliseconds sequencer_hints_max_age;
+
   // (client-only setting) Period for logging in logdevice_readers_flow scuba
   // table. Set it to 0 to disable feature.
   std::chrono::milliseconds client_readers_flow_tracer_period;
@@ -761,6 +925,26 @@ struct Settings : public SettingsBundle {
   // See @file in Appender for more details.
   int scd_sync_leaders_max_waves;
 
+  // (sequencer-only setting) micro-window over which RELEASE messages
+  // triggered by Appender reaping are coalesced per storage shard;
+  // 0 disables coalescing and sends RELEASEs immediately.
+  std::chrono::microseconds release_coalescing_window;
+
+  // (sequencer-only setting) if true, APPENDED replies to the same client
+  // connection are coalesced into one APPENDED_BATCH message per event loop
+  // iteration instead of being sent individually.
+  bool appended_reply_coalescing_enabled;
+
+  // (client-only setting) if nonzero, eligible appends to the same log and
+  // sequencer node issued within one event loop iteration are coalesced
+  // into one APPEND_BATCH message of up to this many records. 0 disables
+  // batching. See AppendBatcher.h.
+  size_t append_batch_max_records;
+
+  // (client-only setting) an APPEND_BATCH under construction is flushed
+  // early once its payloads reach this many bytes.
+  size_t append_batch_max_payload_bytes;
+
   // Total size in bytes of running Appenders across all workers after which
   // we start taking measures to reduce the Appender residency time.
   size_t max_total_appenders_size_soft;
@@ -782,6 +966,12 @@ struct Settings : public SettingsBundle {
   // sequencer nodes.
   rate_limit_t reactivation_limit;
 
+  // (sequencer-only setting) if positive, each sequencer keeps a ring of the
+  // most recently appended records, up to this many payload bytes per log,
+  // and serves them to tailing readers via GET_TAIL_RECORDS. 0 disables the
+  // cache.
+  size_t sequencer_recent_records_cache_bytes;
+
   // (sequencer-only setting) maximum time allowed for a sequencer to drain one
   // epoch
   std::chrono::milliseconds epoch_draining_timeout;
@@ -852,6 +1042,11 @@ struct Settings : public SettingsBundle {
   // format to the parent znode.
   bool epoch_store_double_write_new_serialization_format;
 
+  // If set, version-conditional znode writes of concurrent epoch store
+  // requests are group-committed into Zookeeper multi-ops, amortizing round
+  // trips during mass sequencer activation.
+  bool epoch_store_batch_zk_writes;
+
   // Maximum amount of memory that can be allocated by read storage tasks.
   size_t read_storage_tasks_max_mem_bytes;
 
@@ -876,6 +1071,11 @@ struct Settings : public SettingsBundle {
   // sessions.
   bool ssl_use_session_resumption;
 
+  // If enabled, offload symmetric encryption of established SSL connections
+  // to the kernel (kTLS) when the OpenSSL build, the negotiated cipher and
+  // the running kernel support it.
+  bool ssl_enable_ktls;
+
   // Sets the boundary which triggers enabling SSL. Communication that crosses
   // this boundary will be encrypted; communication that doesn't will not.
   // For instance, if set to NodeLocationScope::RACK, all cross-rack traffic
@@ -894,6 +1094,13 @@ struct Settings : public SettingsBundle {
   // See man ioprio_set for possible values.
   folly::Optional<std::pair<int, int>> slow_ioprio;
 
+  // (server-only setting) Per-shard CPU affinity for storage threads. Maps
+  // shard index to the set of CPUs its storage thread pool may run on, so a
+  // shard's threads can be kept on the NUMA node that holds the shard's
+  // memory and the workers reading from it. folly::none to not pin.
+  folly::Optional<std::unordered_map<int, std::vector<int>>>
+      storage_pool_cpu_affinity;
+
   // (client-only setting) Timeout after which ClientReadStream considers a
   // storage node down if it does not send any data for some time but the socket
   // to it remains open. This can happen if:
@@ -996,6 +1203,12 @@ struct Settings : public SettingsBundle {
   // Set to <=0 to disable collection of stats.
   std::chrono::seconds stats_collection_interval;
 
+  // If positive, aggregate stats across all threads on a background thread
+  // at this interval and serve readers (admin commands, ldquery) from the
+  // resulting snapshot instead of walking the thread-local instances on
+  // every scrape. 0 disables background aggregation.
+  std::chrono::milliseconds stats_background_aggregation_interval;
+
   // How long should we wait before disabling isolated sequencers.
   std::chrono::seconds isolated_sequencer_ttl;
 
@@ -1057,6 +1270,14 @@ struct Settings : public SettingsBundle {
   // larger, it will be enqueued to a helper thread.
   size_t buffered_writer_bg_thread_bytes_threshold;
 
+  // The read-side counterpart of the above.  Buffered-write batches of at
+  // least this many bytes are decoded on a background thread instead of
+  // inline: for AsyncReader this keeps a large batch from blocking record
+  // delivery for other logs on its Worker, for Reader it lets queued
+  // batches decompress in parallel instead of one at a time in the
+  // application's read() loop.  0 (the default) decodes everything inline.
+  size_t reader_bg_decode_bytes_threshold;
+
   // Zstd compression level to use in BufferedWriter
   size_t buffered_writer_zstd_level;
 
@@ -1069,6 +1290,11 @@ struct Settings : public SettingsBundle {
   // This option prevents GET_SEQ_STATE from sending CHECK_SEAL messages.
   bool disable_check_seals;
 
+  // If positive, a successful check-seal round is remembered on the sequencer
+  // for this long and GET_SEQ_STATE messages arriving within the TTL skip the
+  // CHECK_SEAL fan-out. 0 disables the cache.
+  std::chrono::milliseconds check_seal_cache_ttl;
+
   // GetClusterStateRequest will use these value to setup wave timer and
   // overall request timer.
   // TODO (t13314297): these settings are not modified anywhere
@@ -1104,6 +1330,11 @@ struct Settings : public SettingsBundle {
   // and use HHWheelTimer backend.
   bool enable_hh_wheel_backed_timers;
 
+  // If true, Timers fire from the HHWheelTimer embedded in the Worker's own
+  // event base instead of the shared wheel thread. Takes precedence over
+  // enable_hh_wheel_backed_timers.
+  bool enable_worker_local_timer_wheel;
+
   // If true, use the new version of timers which run on a different thread
   // and use HHWheelTimer backend.
   bool enable_store_histogram_calculations;
@@ -1257,6 +1488,9 @@ struct Settings : public SettingsBundle {
   bool enable_logsconfig_manager;
   // Grace period before populating new LogsConfigTree upon receiving RSM delta
   std::chrono::milliseconds logsconfig_manager_grace_period;
+  // Minimum interval between two publishes of the logs config when the grace
+  // period is zero; updates applied within the window are coalesced
+  std::chrono::milliseconds logsconfig_manager_publish_cooldown;
 
   // Enable automatic snapshotting of LogsConfig in the replicated state machine
   bool logsconfig_snapshotting;
@@ -1288,6 +1522,12 @@ struct Settings : public SettingsBundle {
   // RebuildingSupervisor to know that timestamp.
   bool read_stream_guaranteed_delivery_efficiency;
 
+  // If true, readers resolve gap candidates in bulk by fetching per-epoch ESN
+  // presence digests (bitmaps built from the copyset index) from storage
+  // nodes that haven't chimed in, instead of waiting for individual gap
+  // messages from each of them.
+  bool read_stream_esn_digests;
+
   // Max number of concurrent background sequencer activations running
   size_t max_sequencer_background_activations_in_flight;
 
@@ -1305,6 +1545,10 @@ struct Settings : public SettingsBundle {
 
   NodeLocationScope copyset_locality_min_scope;
 
+  // Number of precomputed copysets that CachingCopySetManager keeps per
+  // epoch; 0 disables caching and runs the copyset selector on every append.
+  size_t copyset_cache_size;
+
   // Defaults to false, allows clients to opt-in to traffic shadowing
   bool traffic_shadow_enabled;
 
@@ -1369,6 +1613,11 @@ struct Settings : public SettingsBundle {
   // Enable / disable real time reads.
   bool real_time_reads_enabled;
 
+  // (server-only setting) If true, wakeups triggered by a release whose
+  // records are already in the real-time record buffer skip the artificial
+  // delivery-latency batching delay and deliver from memory right away.
+  bool real_time_fast_delivery;
+
   // (server-only setting) Max size in bytes of released records that we'll keep
   // around to use for real time reads.  Includes some cache overhead, so for
   // small records, you'll store less record data than this.
@@ -1415,7 +1664,15 @@ struct Settings : public SettingsBundle {
   dbg::Level message_tracing_log_level;
   bool rsm_include_read_pointer_in_snapshot;
   SnapshotStoreType rsm_snapshot_store_type;
+  // (client-only setting) Directory where fetched RSM snapshots are cached
+  // so that restarting clients can bootstrap state machines from disk.
+  // Empty disables the cache.
+  std::string rsm_snapshot_cache_dir;
   bool rsm_snapshot_enable_dual_writes;
+  // If non-zero, snapshots bigger than this many bytes are split across
+  // several records of the snapshot log instead of being appended as one
+  // record. 0 disables chunking.
+  size_t rsm_snapshot_chunk_size;
   std::chrono::milliseconds eventlog_snapshotting_period;
   std::chrono::milliseconds logsconfig_snapshotting_period;
 
@@ -1445,6 +1702,15 @@ struct Settings : public SettingsBundle {
   std::chrono::milliseconds nodeset_adjustment_min_window;
   size_t nodeset_max_randomizations;
 
+  // Sequencer load spreading: if the combined append throughput of the
+  // sequencers on this node exceeds sequencer_load_spreading_threshold, the
+  // heaviest logs' sequencers are relocated to other nodes by redirecting
+  // their appends. Zero period disables the checks.
+  // See SequencerBackgroundActivator::checkSequencerLoad().
+  std::chrono::milliseconds sequencer_load_spreading_period;
+  size_t sequencer_load_spreading_threshold;
+  size_t sequencer_load_spreading_max_logs;
+
   // Use metadata logs in NodeSetFinder if true, otherwise use sequencers
   // (metadata logs v2) and fallback to metadata logs if needed.
   // TODO: set default to false (or remove option) when 2.35 is deployed
@@ -1494,6 +1760,10 @@ struct Settings : public SettingsBundle {
   //  outbuf_min_kb per Connection.
   size_t outbuf_socket_min_kb;
 
+  // Cap on the share of the outbufs_mb_max_per_thread budget a single
+  //  Connection may occupy, in percent. 0 disables the cap.
+  double outbuf_socket_max_percent;
+
   std::vector<node_index_t> logsconfig_api_blacklist_nodes;
 
   // loglevel to publish to scribe and logview
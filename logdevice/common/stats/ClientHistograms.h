@@ -29,6 +29,9 @@ struct ClientHistograms : public HistogramBundle {
         {"trim_latency", &trim_latency},
         {"nodes_configuration_manager_propagation_latency",
          &nodes_configuration_manager_propagation_latency},
+        {"read_stream_rewind_delay", &read_stream_rewind_delay},
+        {"read_stream_rewind_stall", &read_stream_rewind_stall},
+        {"write_to_deliver_latency", &write_to_deliver_latency},
     };
   }
   CompactLatencyHistogram append_latency{
@@ -45,6 +48,19 @@ struct ClientHistograms : public HistogramBundle {
   // How long did it take between when the config is published and when it
   // was received on the client in msec.
   LatencyHistogram nodes_configuration_manager_propagation_latency;
+  // How long a read stream rewind stayed scheduled before executing,
+  // including the adaptive delay applied by RewindScheduler.
+  LatencyHistogram read_stream_rewind_delay;
+  // How long record delivery on a read stream stalled after a rewind, i.e.
+  // time from the rewind executing to the next record delivered.
+  LatencyHistogram read_stream_rewind_stall;
+  // Time from the sequencer stamping a record to this client delivering it to
+  // the application, measured only while the read stream is caught up with
+  // the release tail (so backlog reads don't pollute it). Together with the
+  // server-side write_to_durable_latency and write_to_read_latency histograms
+  // this makes up the end-to-end write-visibility chain. Subject to clock
+  // skew between the sequencer and the client.
+  LatencyHistogram write_to_deliver_latency;
 };
 
 }} // namespace facebook::logdevice
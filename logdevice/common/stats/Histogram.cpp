@@ -660,11 +660,15 @@ void MultiScaleHistogram::mergeStagedValues() {
 }
 
 void CompactHistogram::add(int64_t value) {
+  add(value, 1);
+}
+
+void CompactHistogram::add(int64_t value, uint64_t weight) {
   unsigned int bucket = value <= 0
       ? 0
       : value >= (1ul << (buckets_.size() - 2)) ? buckets_.size() - 1
                                                 : folly::findLastSet(value);
-  buckets_.at(bucket).fetch_add(1, std::memory_order_relaxed);
+  buckets_.at(bucket).fetch_add(weight, std::memory_order_relaxed);
 }
 
 void CompactHistogram::clear() {
@@ -433,6 +433,9 @@ class CompactHistogram : public HistogramInterface {
   CompactHistogram& operator=(const CompactHistogram& rhs);
 
   void add(int64_t value) override;
+  // Like add(), but counts the value `weight` times, with a single bucket
+  // increment. Used by SampledHistogram to reweight 1-in-N sampled values.
+  void add(int64_t value, uint64_t weight);
   void clear() override;
   void assign(const HistogramInterface& other) override;
   void merge(const HistogramInterface& other) override;
@@ -502,4 +505,54 @@ class CompactNoUnitHistogram : public CompactHistogram {
   CompactNoUnitHistogram();
 };
 
+// Wraps a CompactHistogram subclass so that only one in every SampleRate
+// values is recorded, with weight SampleRate, keeping counts and percentile
+// estimates approximately unbiased. Use on paths hot enough that even the
+// relaxed bucket increment in CompactHistogram::add() - or, more commonly,
+// the clock reads producing the value - would show up in profiles, e.g.
+// per-record loops. The trade-off is that the histogram needs on the order
+// of SampleRate times more events before percentiles become meaningful.
+//
+// For timed sections, make the sampling decision *before* taking the start
+// timestamp so that unsampled iterations skip the clock reads entirely:
+//
+//   const uint64_t start = hist->shouldRecord() ? cycle_timestamp() : 0;
+//   ... work ...
+//   if (start != 0) {
+//     hist->addSampled(cycles_to_usec(cycle_timestamp() - start));
+//   }
+template <typename CompactHistogramType, uint32_t SampleRate = 64>
+class SampledHistogram final : public CompactHistogramType {
+  static_assert(SampleRate > 0, "sample rate must be positive");
+
+ public:
+  using CompactHistogramType::CompactHistogramType;
+
+  // Advances the per-thread sampling counter and returns true for one in
+  // every SampleRate calls. The counter is shared by all instances of the
+  // same instantiation on a thread; each event is still recorded with
+  // probability 1/SampleRate, which is all the reweighting relies on.
+  static bool shouldRecord() {
+    static thread_local uint32_t counter = 0;
+    if (++counter >= SampleRate) {
+      counter = 0;
+      return true;
+    }
+    return false;
+  }
+
+  // Record a value for which shouldRecord() returned true.
+  void addSampled(int64_t value) {
+    CompactHistogramType::add(value, SampleRate);
+  }
+
+  // add() samples too, so generic code (e.g. HISTOGRAM_ADD) stays unbiased
+  // when pointed at a sampled histogram.
+  void add(int64_t value) override {
+    if (shouldRecord()) {
+      addSampled(value);
+    }
+  }
+};
+
 }} // namespace facebook::logdevice
@@ -35,6 +35,7 @@ struct PerShardHistograms : public PerShardHistogramBundle {
     return {
         {"store_latency", &store_latency},
         {"store_latency_rebuilding", &store_latency_rebuilding},
+        {"write_to_durable_latency", &write_to_durable_latency},
         {"rocks_wal", &rocks_wal},
         {"rocks_memtable", &rocks_memtable},
         {"rocks_memtable_age", &rocks_memtable_age},
@@ -82,6 +83,13 @@ struct PerShardHistograms : public PerShardHistogramBundle {
   // Same as store_latency but for rebuilding-related stores
   latency_histogram_t store_latency_rebuilding;
 
+  // Time from the sequencer stamping a record (STORE_Header::timestamp) to
+  // the copy being durably written on this shard; doesn't count rebuilding
+  // or recovery stores. Unlike store_latency this includes sequencer-side
+  // queueing and the network hop, so it's the write half of end-to-end
+  // write visibility. Subject to clock skew between sequencer and storage.
+  latency_histogram_t write_to_durable_latency;
+
   // Time spent by RocksDB writing to WAL.
   latency_histogram_t rocks_wal;
 
@@ -24,6 +24,8 @@ struct ServerHistograms : public HistogramBundle {
   HistogramBundle::MapType getMap() override {
     return {
         {"append_latency", &append_latency},
+        {"appender_wave_send_latency", &appender_wave_send_latency},
+        {"catchup_record_ship_latency", &catchup_record_ship_latency},
         {"store_bw_wait_latency", &store_bw_wait_latency},
         {"write_to_read_latency", &write_to_read_latency},
         {"store_timeouts", &store_timeouts},
@@ -71,6 +73,15 @@ struct ServerHistograms : public HistogramBundle {
   // Latency of appends as seen by the sequencer
   LatencyHistogram append_latency;
 
+  // Time spent picking a copyset and sending one wave of STOREs for an
+  // append. This is on the sequencer hot path, so only one in every 64
+  // calls is timed and recorded (reweighted; see SampledHistogram).
+  SampledHistogram<CompactLatencyHistogram> appender_wave_send_latency;
+
+  // Time to parse and ship one record to a reader in CatchupOneStream.
+  // Sampled like appender_wave_send_latency.
+  SampledHistogram<CompactLatencyHistogram> catchup_record_ship_latency;
+
   LatencyHistogram write_to_read_latency;
 
   LatencyHistogram store_bw_wait_latency;
@@ -9,6 +9,8 @@
 
 #include <algorithm>
 #include <cmath>
+#include <condition_variable>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -18,6 +20,7 @@
 #include <folly/stats/BucketedTimeSeries.h>
 #include <folly/stats/MultiLevelTimeSeries.h>
 
+#include "logdevice/common/ThreadID.h"
 #include "logdevice/common/stats/ClientHistograms.h"
 #include "logdevice/common/stats/Histogram.h"
 #include "logdevice/common/stats/PerMonitoringTagHistograms.h"
@@ -970,6 +973,72 @@ Stats StatsHolder::aggregate() const {
   return result;
 }
 
+struct StatsHolder::BackgroundAggregator {
+  StatsHolder* owner;
+  std::chrono::milliseconds interval;
+  bool stop{false};
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::thread thread;
+
+  BackgroundAggregator(StatsHolder* owner, std::chrono::milliseconds interval)
+      : owner(owner), interval(interval) {
+    thread = std::thread([this] { loop(); });
+  }
+
+  ~BackgroundAggregator() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stop = true;
+    }
+    cv.notify_one();
+    thread.join();
+  }
+
+  void loop() {
+    ThreadID::set(ThreadID::Type::UTILITY, "ld:stats-agg");
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stop) {
+      auto cur_interval = interval;
+      lock.unlock();
+      // The expensive walk over all thread-local instances happens here,
+      // instead of on whichever thread wants to read stats.
+      owner->snapshot_.update(
+          std::make_shared<const Stats>(owner->aggregate()));
+      lock.lock();
+      cv.wait_for(lock, cur_interval, [this] { return stop; });
+    }
+  }
+};
+
+std::shared_ptr<const Stats> StatsHolder::aggregateCached() const {
+  std::shared_ptr<const Stats> snapshot = snapshot_.get();
+  if (snapshot == nullptr) {
+    // Background aggregation is not running, or hasn't finished its first
+    // pass yet; aggregate synchronously.
+    snapshot = std::make_shared<const Stats>(aggregate());
+  }
+  return snapshot;
+}
+
+void StatsHolder::enableBackgroundAggregation(
+    std::chrono::milliseconds interval) {
+  ld_check(interval.count() > 0);
+  if (background_aggregator_ != nullptr) {
+    std::lock_guard<std::mutex> lock(background_aggregator_->mutex);
+    background_aggregator_->interval = interval;
+    return;
+  }
+  background_aggregator_ =
+      std::make_unique<BackgroundAggregator>(this, interval);
+}
+
+void StatsHolder::disableBackgroundAggregation() {
+  background_aggregator_.reset();
+  // Don't keep serving a snapshot that will never be refreshed again.
+  snapshot_.update(nullptr);
+}
+
 void StatsHolder::reset() {
   auto accessor = thread_stats_.accessAllThreads();
   dead_stats_.reset();
@@ -979,6 +1048,9 @@ void StatsHolder::reset() {
 }
 
 StatsHolder::~StatsHolder() {
+  // Stop the background aggregation thread before anything it reads is
+  // destroyed.
+  disableBackgroundAggregation();
   // No need to update dead_stats_ when StatsHolder is being destroyed.
   for (auto& x : thread_stats_.accessAllThreads()) {
     x.owner = nullptr;
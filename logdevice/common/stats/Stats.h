@@ -869,6 +869,31 @@ class StatsHolder {
    */
   Stats aggregate() const;
 
+  /**
+   * Like aggregate(), but served from the snapshot maintained by the
+   * background aggregation thread, so it never iterates the thread-local
+   * Stats instances (and therefore doesn't contend with threads being
+   * created or destroyed). The snapshot is at most one aggregation interval
+   * old. Falls back to a synchronous aggregate() if background aggregation
+   * is not running or hasn't finished its first pass yet.
+   */
+  std::shared_ptr<const Stats> aggregateCached() const;
+
+  /**
+   * Starts a background thread that re-aggregates all thread-local Stats
+   * instances every `interval' and publishes the result as the snapshot
+   * served by aggregateCached(). If the thread is already running, just
+   * updates the interval (picked up on the next tick).
+   */
+  void enableBackgroundAggregation(std::chrono::milliseconds interval);
+
+  /**
+   * Stops and joins the background aggregation thread; aggregateCached()
+   * reverts to aggregating synchronously. Also called by the destructor.
+   * Must not be called concurrently with enableBackgroundAggregation().
+   */
+  void disableBackgroundAggregation();
+
   /**
    * Reset stats on all threads.
    */
@@ -895,6 +920,16 @@ class StatsHolder {
   // Stats aggregated for all destroyed threads.
   Stats dead_stats_;
 
+  // Snapshot served by aggregateCached(): the background aggregation thread
+  // builds a fresh Stats instance off the reader's path and swaps it in
+  // atomically, so readers always see a complete aggregate. nullptr until
+  // the first background pass completes.
+  FastUpdateableSharedPtr<const Stats> snapshot_;
+
+  // Thread state of the background aggregation; see Stats.cpp.
+  struct BackgroundAggregator;
+  std::unique_ptr<BackgroundAggregator> background_aggregator_;
+
   // Stats for running threads.
   //
   // We use AccessModeStrict to prevent race conditions around dead_stats_;
@@ -0,0 +1,70 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/AdminCommandTable.h"
+
+#include <folly/json.h>
+#include <gtest/gtest.h>
+
+#include "logdevice/common/types_internal.h"
+
+namespace facebook { namespace logdevice {
+
+using TestTable =
+    AdminCommandTable<logid_t, admin_command_table::LSN, std::string>;
+
+namespace {
+std::string chunkedJson(const TestTable& header_table,
+                        const std::vector<TestTable*>& chunks) {
+  folly::IOBuf buffer;
+  folly::io::Appender out(&buffer, 1024);
+  header_table.printJsonHeader(out);
+  bool first_row = true;
+  for (auto* chunk : chunks) {
+    first_row = chunk->printJsonRows(out, first_row);
+  }
+  TestTable::printJsonFooter(out);
+  return buffer.coalesce().toString();
+}
+} // namespace
+
+// Printing a table as header + per-chunk rows + footer must produce the same
+// json document as merging the chunks and calling printJson().
+TEST(AdminCommandTableTest, ChunkedJsonMatchesPrintJson) {
+  TestTable table(false, "log id", "lsn", "status");
+
+  TestTable chunk1(table);
+  chunk1.next().set<0>(logid_t(1)).set<1>(lsn_t(42)).set<2>("a");
+  chunk1.next().set<0>(logid_t(2)).set<1>(LSN_MAX); // column 2 left unset
+
+  TestTable chunk2(table);
+  chunk2.next().set<0>(logid_t(3)).set<1>(lsn_t(7)).set<2>("b");
+
+  TestTable empty_chunk(table);
+
+  std::string chunked =
+      chunkedJson(table, {&chunk1, &empty_chunk, &chunk2});
+
+  TestTable merged(table);
+  merged.mergeWith(std::move(chunk1));
+  merged.mergeWith(std::move(empty_chunk));
+  merged.mergeWith(std::move(chunk2));
+
+  // Compare parsed documents rather than bytes; folly does not guarantee
+  // object key order when serializing.
+  EXPECT_EQ(folly::parseJson(merged.toString(/*json=*/true)),
+            folly::parseJson(chunked));
+}
+
+// A streamed table with no rows at all is still a valid, empty document.
+TEST(AdminCommandTableTest, ChunkedJsonEmpty) {
+  TestTable table(false, "log id", "lsn", "status");
+  EXPECT_EQ(folly::parseJson(table.toString(/*json=*/true)),
+            folly::parseJson(chunkedJson(table, {})));
+}
+
+}} // namespace facebook::logdevice
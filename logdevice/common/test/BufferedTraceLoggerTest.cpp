@@ -0,0 +1,48 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/BufferedTraceLogger.h"
+
+#include <gtest/gtest.h>
+
+#include "logdevice/common/test/MockTraceLogger.h"
+
+namespace facebook { namespace logdevice {
+
+// Samples pushed into the buffer must all reach the underlying logger, in
+// order, before the destructor returns.
+TEST(BufferedTraceLoggerTest, DeliversQueuedSamples) {
+  auto config = std::make_shared<UpdateableConfig>();
+  auto mock = std::make_shared<MockTraceLogger>(config);
+  {
+    BufferedTraceLogger logger(mock, config, folly::none, /*queue_size=*/128);
+    for (int i = 0; i < 10; ++i) {
+      auto sample = std::make_unique<TraceSample>();
+      sample->addIntValue("i", i);
+      logger.pushSample("test_table", 1, std::move(sample));
+    }
+    // Destructor joins the draining thread after it has delivered everything
+    // queued so far.
+  }
+  auto& samples = mock->pushed_samples["test_table"];
+  ASSERT_EQ(10, samples.size());
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(i, samples[i]->getIntValue("i"));
+  }
+}
+
+// Sampling configuration queries are forwarded to the wrapped logger.
+TEST(BufferedTraceLoggerTest, ForwardsSamplePercentages) {
+  auto config = std::make_shared<UpdateableConfig>();
+  auto mock = std::make_shared<MockTraceLogger>(config);
+  BufferedTraceLogger logger(mock, config, folly::none, /*queue_size=*/16);
+  EXPECT_EQ(mock->getDefaultSamplePercentage(),
+            logger.getDefaultSamplePercentage());
+  EXPECT_EQ(folly::none, logger.getSamplePercentageForTracer("appender"));
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,48 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "logdevice/common/buffered_writer/BufferedWriteBufferPool.h"
+
+#include <gtest/gtest.h>
+
+namespace facebook { namespace logdevice {
+
+// Use a size no other test in the binary allocates, so that the
+// process-wide pool cannot hand us a buffer recycled elsewhere.
+static constexpr size_t kTestCapacity = 3 << 20;
+
+TEST(BufferedWriteBufferPoolTest, RecycleAndReuse) {
+  folly::IOBuf buf = BufferedWriteBufferPool::allocate(kTestCapacity);
+  ASSERT_GE(buf.capacity(), kTestCapacity);
+  const void* data = buf.buffer();
+
+  // Simulate use, including headroom like the encoder reserves.
+  buf.advance(64);
+  buf.append(1024);
+
+  EXPECT_TRUE(BufferedWriteBufferPool::recycle(std::move(buf)));
+
+  folly::IOBuf reused = BufferedWriteBufferPool::allocate(kTestCapacity);
+  EXPECT_EQ(data, reused.buffer());
+  // The buffer must come back rewound and empty.
+  EXPECT_EQ(0, reused.length());
+  EXPECT_EQ(0, reused.headroom());
+}
+
+TEST(BufferedWriteBufferPoolTest, RejectsSmallAndSharedBuffers) {
+  // Small buffers are not worth pooling.
+  folly::IOBuf small(folly::IOBuf::CREATE, 128);
+  EXPECT_FALSE(BufferedWriteBufferPool::recycle(std::move(small)));
+
+  // A buffer someone else still references must not be reused.
+  folly::IOBuf buf = BufferedWriteBufferPool::allocate(kTestCapacity);
+  folly::IOBuf clone = buf.cloneAsValue();
+  EXPECT_FALSE(BufferedWriteBufferPool::recycle(std::move(buf)));
+}
+
+}} // namespace facebook::logdevice
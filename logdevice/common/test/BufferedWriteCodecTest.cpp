@@ -262,6 +262,11 @@ INSTANTIATE_TEST_CASE_P(EncodeDecodeMatch,
                             std::vector<std::string>(1000, "p1000"),
                             std::vector<std::string>(10000, "p10000"),
                             std::vector<std::string>(100000, "p100000"),
+                            // Payloads needing two- and three-byte length
+                            // varints
+                            {std::string(500, 'x'), "short",
+                             std::string(200, 'y')},
+                            {std::string(20000, 'z'), ""},
                         }));
 
 TEST(BufferedWriteEstimatorTest, FormatChange) {
@@ -374,4 +379,228 @@ INSTANTIATE_TEST_CASE_P(EncodeDecodeMatch,
                         ::testing::ValuesIn(payloads));
 } // namespace
 
+TEST(BufferedWriteStreamingEncoderTest, EncodeDecodeMatch) {
+  const std::vector<std::string> payloads_in(100, std::string(100, 'x'));
+
+  BufferedWriteCodec::StreamingEncoder encoder(/* checksum_bits */ 0,
+                                               /* zstd_level */ 5);
+  for (const auto& payload : payloads_in) {
+    encoder.append(
+        folly::IOBuf::wrapBufferAsValue(payload.data(), payload.size()));
+  }
+  folly::IOBufQueue queue;
+  Compression compression = Compression::ZSTD;
+  encoder.encode(queue, compression);
+  ASSERT_EQ(compression, Compression::ZSTD);
+  auto encoded = queue.moveAsValue();
+  ASSERT_FALSE(encoded.isChained());
+
+  // Blob must be readable by the regular decoding path
+  size_t batch_size = 0;
+  EXPECT_TRUE(BufferedWriteCodec::decodeBatchSize(
+      Slice(encoded.data(), encoded.length()), &batch_size));
+  EXPECT_EQ(batch_size, payloads_in.size());
+  Compression decoded_compression;
+  EXPECT_TRUE(BufferedWriteCodec::decodeCompression(
+      Slice(encoded.data(), encoded.length()), &decoded_compression));
+  EXPECT_EQ(decoded_compression, Compression::ZSTD);
+
+  std::vector<folly::IOBuf> decoded;
+  size_t consumed =
+      BufferedWriteCodec::decode(Slice(encoded.data(), encoded.length()),
+                                 decoded,
+                                 /* allow_buffer_sharing */ true);
+  EXPECT_EQ(consumed, encoded.length());
+
+  std::vector<std::string> payloads_out;
+  for (auto& payload : decoded) {
+    payloads_out.push_back(payload.moveToFbString().toStdString());
+  }
+  EXPECT_EQ(payloads_in, payloads_out);
+}
+
+TEST(BufferedWriteStreamingEncoderTest, IncompressibleFallsBackToNone) {
+  // A short payload of pseudo-random bytes cannot be shrunk by zstd, so the
+  // encoder must decline to compress, like the non-streaming encoder does.
+  std::string payload(64, '\0');
+  uint32_t state = 0x5bd1e995;
+  for (auto& c : payload) {
+    state = state * 1664525 + 1013904223;
+    c = static_cast<char>(state >> 24);
+  }
+
+  BufferedWriteCodec::StreamingEncoder encoder(/* checksum_bits */ 0,
+                                               /* zstd_level */ 5);
+  encoder.append(
+      folly::IOBuf::wrapBufferAsValue(payload.data(), payload.size()));
+  folly::IOBufQueue queue;
+  Compression compression = Compression::ZSTD;
+  encoder.encode(queue, compression);
+  EXPECT_EQ(compression, Compression::NONE);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(BufferedWriteDictionaryTest, EncodeDecodeMatch) {
+  const uint32_t dictionary_id = 101;
+  const std::string dictionary_data =
+      R"({"type":"click","user_id":0000000,"flags":[],"ts":0000000000})";
+  ASSERT_EQ(0,
+            BufferedWriteDictionaryRegistry::registerDictionary(
+                dictionary_id, dictionary_data));
+  // Registering the same dictionary again is a no-op, but a different
+  // dictionary under the same id (or id 0) must be rejected.
+  EXPECT_EQ(0,
+            BufferedWriteDictionaryRegistry::registerDictionary(
+                dictionary_id, dictionary_data));
+  EXPECT_EQ(-1,
+            BufferedWriteDictionaryRegistry::registerDictionary(
+                dictionary_id, "something else"));
+  EXPECT_EQ(
+      -1, BufferedWriteDictionaryRegistry::registerDictionary(0, "data"));
+
+  auto dictionary = BufferedWriteDictionaryRegistry::lookup(dictionary_id);
+  ASSERT_NE(dictionary, nullptr);
+
+  std::vector<std::string> payloads_in;
+  for (int i = 0; i < 10; i++) {
+    payloads_in.push_back(R"({"type":"click","user_id":)" +
+                          std::to_string(1000000 + i) +
+                          R"(,"flags":[],"ts":16180339)" + std::to_string(i) +
+                          "0}");
+  }
+
+  BufferedWriteCodec::Estimator estimator;
+  for (const auto& payload : payloads_in) {
+    estimator.append(
+        folly::IOBuf::wrapBufferAsValue(payload.data(), payload.size()));
+  }
+  BufferedWriteCodec::Encoder<BufferedWriteSinglePayloadsCodec::Encoder>
+      encoder(/* checksum_bits */ 0,
+              payloads_in.size(),
+              estimator.calculateSize(/* checksum_bits */ 0, dictionary_id),
+              dictionary);
+  for (const auto& payload : payloads_in) {
+    encoder.append(
+        folly::IOBuf::wrapBufferAsValue(payload.data(), payload.size()));
+  }
+  folly::IOBufQueue queue;
+  encoder.encode(queue, Compression::ZSTD, /* zstd_level */ 5);
+  auto encoded = queue.moveAsValue();
+  ASSERT_FALSE(encoded.isChained());
+
+  Compression compression;
+  ASSERT_TRUE(BufferedWriteCodec::decodeCompression(
+      Slice(encoded.data(), encoded.length()), &compression));
+  ASSERT_EQ(compression, Compression::ZSTD);
+  size_t batch_size = 0;
+  EXPECT_TRUE(BufferedWriteCodec::decodeBatchSize(
+      Slice(encoded.data(), encoded.length()), &batch_size));
+  EXPECT_EQ(batch_size, payloads_in.size());
+
+  std::vector<folly::IOBuf> decoded;
+  size_t consumed =
+      BufferedWriteCodec::decode(Slice(encoded.data(), encoded.length()),
+                                 decoded,
+                                 /* allow_buffer_sharing */ true);
+  EXPECT_EQ(consumed, encoded.length());
+
+  std::vector<std::string> payloads_out;
+  for (auto& payload : decoded) {
+    payloads_out.push_back(payload.moveToFbString().toStdString());
+  }
+  EXPECT_EQ(payloads_in, payloads_out);
+}
+
+TEST(BufferedWriteDictionaryTest, UnregisteredDictionaryFailsDecode) {
+  // Encode with a dictionary that is not in the registry: decoding must
+  // fail cleanly instead of feeding zstd a frame it cannot decompress.
+  auto dictionary =
+      std::make_shared<BufferedWriteDictionaryRegistry::Dictionary>();
+  dictionary->id = 102; // intentionally never registered
+  dictionary->data = std::string(64, 'x');
+
+  const std::vector<std::string> payloads_in(20, std::string(100, 'x'));
+  BufferedWriteCodec::Estimator estimator;
+  for (const auto& payload : payloads_in) {
+    estimator.append(
+        folly::IOBuf::wrapBufferAsValue(payload.data(), payload.size()));
+  }
+  BufferedWriteCodec::Encoder<BufferedWriteSinglePayloadsCodec::Encoder>
+      encoder(/* checksum_bits */ 0,
+              payloads_in.size(),
+              estimator.calculateSize(/* checksum_bits */ 0, dictionary->id),
+              dictionary);
+  for (const auto& payload : payloads_in) {
+    encoder.append(
+        folly::IOBuf::wrapBufferAsValue(payload.data(), payload.size()));
+  }
+  folly::IOBufQueue queue;
+  encoder.encode(queue, Compression::ZSTD, /* zstd_level */ 5);
+  auto encoded = queue.moveAsValue();
+
+  Compression compression;
+  ASSERT_TRUE(BufferedWriteCodec::decodeCompression(
+      Slice(encoded.data(), encoded.length()), &compression));
+  ASSERT_EQ(compression, Compression::ZSTD);
+
+  std::vector<folly::IOBuf> decoded;
+  size_t consumed =
+      BufferedWriteCodec::decode(Slice(encoded.data(), encoded.length()),
+                                 decoded,
+                                 /* allow_buffer_sharing */ true);
+  EXPECT_EQ(consumed, 0);
+  EXPECT_TRUE(decoded.empty());
+
+  // Header-only queries don't need the dictionary.
+  size_t batch_size = 0;
+  EXPECT_TRUE(BufferedWriteCodec::decodeBatchSize(
+      Slice(encoded.data(), encoded.length()), &batch_size));
+  EXPECT_EQ(batch_size, payloads_in.size());
+}
+
+TEST(BufferedWriteDictionaryTest, StreamingEncodeDecodeMatch) {
+  const uint32_t dictionary_id = 103;
+  const std::string dictionary_data =
+      R"({"type":"view","user_id":0000000,"flags":[],"ts":0000000000})";
+  ASSERT_EQ(0,
+            BufferedWriteDictionaryRegistry::registerDictionary(
+                dictionary_id, dictionary_data));
+  auto dictionary = BufferedWriteDictionaryRegistry::lookup(dictionary_id);
+  ASSERT_NE(dictionary, nullptr);
+
+  std::vector<std::string> payloads_in;
+  for (int i = 0; i < 10; i++) {
+    payloads_in.push_back(R"({"type":"view","user_id":)" +
+                          std::to_string(2000000 + i) +
+                          R"(,"flags":[],"ts":27182818)" + std::to_string(i) +
+                          "0}");
+  }
+
+  BufferedWriteCodec::StreamingEncoder encoder(
+      /* checksum_bits */ 0, /* zstd_level */ 5, dictionary);
+  for (const auto& payload : payloads_in) {
+    encoder.append(
+        folly::IOBuf::wrapBufferAsValue(payload.data(), payload.size()));
+  }
+  folly::IOBufQueue queue;
+  Compression compression = Compression::ZSTD;
+  encoder.encode(queue, compression);
+  ASSERT_EQ(compression, Compression::ZSTD);
+  auto encoded = queue.moveAsValue();
+  ASSERT_FALSE(encoded.isChained());
+
+  std::vector<folly::IOBuf> decoded;
+  size_t consumed =
+      BufferedWriteCodec::decode(Slice(encoded.data(), encoded.length()),
+                                 decoded,
+                                 /* allow_buffer_sharing */ true);
+  EXPECT_EQ(consumed, encoded.length());
+
+  std::vector<std::string> payloads_out;
+  for (auto& payload : decoded) {
+    payloads_out.push_back(payload.moveToFbString().toStdString());
+  }
+  EXPECT_EQ(payloads_in, payloads_out);
+}
+
 }} // namespace facebook::logdevice
@@ -199,4 +199,25 @@ TEST_F(ChecksumTest, RoundTripNoChecksumFlagsZeroed) {
   ASSERT_EQ(-1, verifyChecksum(*recv));
 }
 
+// The IOBuf chain overloads must produce the same values as the Slice
+// versions over the concatenated bytes, regardless of how the bytes are
+// split across the chain.
+TEST_F(ChecksumTest, ChainMatchesContiguous) {
+  std::string data(1000, '\0');
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<char>(i * 31 + 7);
+  }
+  Slice slice(data.data(), data.size());
+
+  for (size_t split : {1ul, 13ul, 500ul, 999ul}) {
+    auto chain = folly::IOBuf::copyBuffer(data.data(), split);
+    chain->prependChain(
+        folly::IOBuf::copyBuffer(data.data() + split, data.size() - split));
+    // Toss in an empty buffer too; it must not affect the result.
+    chain->prependChain(folly::IOBuf::create(16));
+    EXPECT_EQ(checksum_32bit(slice), checksum_32bit(*chain));
+    EXPECT_EQ(checksum_64bit(slice), checksum_64bit(*chain));
+  }
+}
+
 }} // namespace facebook::logdevice
@@ -145,6 +145,49 @@ TEST_P(ClientReadStreamBufferTest, ForEachBackwardEmpty) {
   ASSERT_TRUE(true);
 }
 
+// Exercises the first-marker scan through in-order delivery, reordering
+// (a marker showing up below a previously found one) and head advances.
+TEST_P(ClientReadStreamBufferTest, FindFirstMarker) {
+  auto put_marker = [&](lsn_t lsn) {
+    ClientReadStreamRecordState* rstate = buf->createOrGet(lsn);
+    ASSERT_NE(nullptr, rstate);
+    rstate->filtered_out = true;
+  };
+  auto consume_front = [&]() {
+    ClientReadStreamRecordState* front = buf->front();
+    ASSERT_NE(nullptr, front);
+    front->filtered_out = false;
+    buf->popFront();
+    buf->advanceBufferHead();
+  };
+
+  ASSERT_EQ(nullptr, buf->findFirstMarker().first);
+
+  // in-order run delivered from the front
+  put_marker(lsn_t{100});
+  put_marker(lsn_t{101});
+  ASSERT_EQ(lsn_t{100}, buf->findFirstMarker().second);
+  consume_front();
+  ASSERT_EQ(lsn_t{101}, buf->findFirstMarker().second);
+  consume_front();
+  ASSERT_EQ(nullptr, buf->findFirstMarker().first);
+
+  // record arrives out of order ahead of the buffer head ...
+  put_marker(lsn_t{105});
+  ASSERT_EQ(lsn_t{105}, buf->findFirstMarker().second);
+  // ... and then a lower one fills part of the hole
+  put_marker(lsn_t{103});
+  ASSERT_EQ(lsn_t{103}, buf->findFirstMarker().second);
+
+  // skip the gap up to the first marker, then drain
+  buf->advanceBufferHead(lsn_t{103} - buf->getBufferHead());
+  consume_front();
+  ASSERT_EQ(lsn_t{105}, buf->findFirstMarker().second);
+  buf->advanceBufferHead(lsn_t{105} - buf->getBufferHead());
+  consume_front();
+  ASSERT_EQ(nullptr, buf->findFirstMarker().first);
+}
+
 INSTANTIATE_TEST_CASE_P(
     ClientReadStreamBufferTest,
     ClientReadStreamBufferTest,
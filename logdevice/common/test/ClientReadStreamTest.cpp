@@ -502,6 +502,10 @@ class ClientReadStreamTest
     if (wait_for_all_copies_) {
       read_stream_->waitForAllCopies();
     }
+    if (deliver_out_of_order_) {
+      read_stream_->deliverRecordsOutOfOrder(
+          [this](logid_t, lsn_t lsn) { low_watermarks_.push_back(lsn); });
+    }
 
     read_stream_->start();
     // Simulate storage nodes having replied STARTED already
@@ -760,8 +764,12 @@ class ClientReadStreamTest
   bool do_not_skip_partially_trimmed_sections_ = false;
   bool ship_corrupted_records_ = false;
   bool wait_for_all_copies_ = false;
+  bool deliver_out_of_order_ = false;
   std::unordered_map<node_index_t, std::string> node_locations_;
 
+  // Low watermark LSNs reported while deliver_out_of_order_ is in effect
+  std::vector<lsn_t> low_watermarks_;
+
   TestState state_;
 
   std::unique_ptr<ClientReadStream> read_stream_;
@@ -965,6 +973,49 @@ TEST_P(ClientReadStreamTest, Deduplication) {
   ASSERT_RECV(lsn(1, 2), lsn(1, 3));
 }
 
+TEST_P(ClientReadStreamTest, OutOfOrderDelivery) {
+  state_.shards.resize(2);
+  buffer_size_ = 1024;
+  deliver_out_of_order_ = true;
+  start();
+
+  // The record at next_lsn_to_deliver_ goes through the ordered path and
+  // moves the low watermark.
+  onDataRecord(N0, mockRecord(lsn(1, 1)));
+  ASSERT_RECV(lsn(1, 1));
+  ASSERT_EQ(std::vector<lsn_t>({lsn(1, 1)}), low_watermarks_);
+
+  // A record past the buffer head is delivered as soon as it arrives; the
+  // low watermark does not move.
+  onDataRecord(N1, mockRecord(lsn(1, 3)));
+  ASSERT_RECV(lsn(1, 3));
+  ASSERT_EQ(std::vector<lsn_t>({lsn(1, 1)}), low_watermarks_);
+
+  // A duplicate copy is not delivered again, but it advances N0's gap state:
+  // lsn 2 is now known lost and the low watermark jumps past the record that
+  // was delivered out of order.
+  onDataRecord(N0, mockRecord(lsn(1, 3)));
+  ASSERT_RECV();
+  ASSERT_GAP_MESSAGES(GapMessage{GapType::DATALOSS, lsn(1, 2), lsn(1, 2)});
+  ASSERT_EQ(std::vector<lsn_t>({lsn(1, 1), lsn(1, 3)}), low_watermarks_);
+
+  // A record rejected by the application stays buffered...
+  state_.callbacks_accepting = false;
+  onDataRecord(N0, mockRecord(lsn(1, 5)));
+  ASSERT_RECV(lsn(1, 5));
+  ASSERT_EQ(std::vector<lsn_t>({lsn(1, 1), lsn(1, 3)}), low_watermarks_);
+
+  // ... and is redelivered in LSN order once the front of the buffer reaches
+  // it. Record 6 is delivered at arrival, then the gap detection kicks in:
+  // DATALOSS for lsn 4, redelivery of record 5, and the low watermark jumps
+  // to 6.
+  state_.callbacks_accepting = true;
+  onDataRecord(N1, mockRecord(lsn(1, 6)));
+  ASSERT_GAP_MESSAGES(GapMessage{GapType::DATALOSS, lsn(1, 4), lsn(1, 4)});
+  ASSERT_RECV(lsn(1, 6), lsn(1, 5));
+  ASSERT_EQ(lsn(1, 6), low_watermarks_.back());
+}
+
 TEST_P(ClientReadStreamTest, CorruptedRegularRecord) {
   state_.shards.resize(2);
   start();
@@ -82,6 +82,26 @@ TEST_F(ClusterStateTest, GetFirstNodeAliveReturnsNoneIfAllNodesAreDead) {
   ASSERT_FALSE(cs->getFirstNodeAlive().has_value());
 }
 
+TEST_F(ClusterStateTest, NodeStateAndStatusAreIndependent) {
+  using namespace NodesConfigurationTestUtil;
+  const ssize_t nnodes = 3;
+  std::vector<node_index_t> node_idxs(nnodes);
+  std::iota(node_idxs.begin(), node_idxs.end(), 0);
+
+  auto config = provisionNodes(node_idxs);
+  ASSERT_TRUE(config->validate());
+
+  // state and status share one packed word per node; updating one field
+  // must not clobber the other.
+  auto cs = makeOne(*config);
+  cs->setNodeStatus(1, NodeHealthStatus::UNHEALTHY);
+  cs->setNodeState(1, ClusterState::NodeState::DEAD);
+  ASSERT_EQ(cs->getNodeStatus(1), NodeHealthStatus::UNHEALTHY);
+  ASSERT_EQ(cs->getNodeState(1), ClusterStateNodeState::DEAD);
+  cs->setNodeState(1, ClusterState::NodeState::FULLY_STARTED);
+  ASSERT_EQ(cs->getNodeStatus(1), NodeHealthStatus::UNHEALTHY);
+}
+
 TEST_F(ClusterStateTest, IsAnyNodeAliveCanReturnTrue) {
   using namespace NodesConfigurationTestUtil;
   std::vector<node_index_t> node_idxs(1);
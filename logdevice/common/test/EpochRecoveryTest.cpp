@@ -989,6 +989,57 @@ TEST_F(EpochRecoveryTest, UnexpectedHolePlugBelowLNG) {
   ASSERT_TRUE(lce_tail_.sameContent(result_.tail));
 }
 
+// digest entries that fall below the consensus LNG as it advances during
+// the digest phase are trimmed eagerly, and records arriving below the LNG
+// are discarded instead of being buffered until mutations start
+TEST_F(EpochRecoveryTest, DigestTrimmedAsLngAdvances) {
+  setUp();
+  OffsetMap om;
+  om.setCounter(BYTE_OFFSET, 19);
+  // neither node reports an LNG in its SEALED reply, so the digest starts
+  // at ESN_MIN
+  erm_->onSealed(N1, ESN_INVALID, esn_t(3), om, folly::none);
+  erm_->activate(prev_tail_);
+  erm_->onSealed(N2, ESN_INVALID, esn_t(3), om, folly::none);
+  checkRecoveryState(ERMState::DIGEST);
+  ASSERT_EQ(ESN_MIN, erm_->getDigestStart());
+
+  erm_->onMessageSent(N1, MessageType::START, E::OK, read_stream_id_t(1));
+  erm_->onMessageSent(N2, MessageType::START, E::OK, read_stream_id_t(2));
+  erm_->onDigestStreamStarted(N1, read_stream_id_t(1), LSN_INVALID, E::OK);
+  SEND_RECORD(1, 1);
+  SEND_RECORD(1, 2);
+  SEND_RECORD(1, 3);
+  ASSERT_EQ(3, erm_->getDigest().size());
+
+  // N2's STARTED reply advances the consensus LNG to 2. The digest entry at
+  // esn 1 should be trimmed right away; the entry at the LNG is kept since
+  // it may be needed for the tail record of the epoch.
+  erm_->onDigestStreamStarted(N2, read_stream_id_t(2), lsn(epoch_, 2), E::OK);
+  ASSERT_EQ(esn_t(2), erm_->getLastKnownGood());
+  ASSERT_EQ(2, erm_->getDigest().size());
+  ASSERT_EQ(esn_t(2), erm_->getDigest().getFirstEsn());
+
+  // records below the LNG are discarded on arrival
+  SEND_RECORD(2, 1);
+  ASSERT_EQ(2, erm_->getDigest().size());
+
+  SEND_RECORD(2, 2);
+  SEND_RECORD(2, 3);
+  SEND_RECORD_GAP(1, 4, ESN_MAX);
+  SEND_RECORD_GAP(2, 4, ESN_MAX);
+  ASSERT_NODE_STATE(NState::MUTATABLE, N1, N2);
+  ASSERT_NODE_STATE(NState::SEALING, N3);
+  ASSERT_TRUE(erm_->getGracePeriodTimer()->isActive());
+  static_cast<MockTimer*>(erm_->getGracePeriodTimer())->trigger();
+  checkRecoveryState(ERMState::MUTATION);
+
+  // esn 3 is fully replicated on the mutation set, so the only mutation is
+  // the bridge record at esn 4
+  ASSERT_EQ(1, erm_->getMutators().size());
+  ASSERT_EQ(1, erm_->getMutators().count(esn_t(4)));
+}
+
 TEST_F(EpochRecoveryTest, MutationSetShouldNotContainDrainingNodes) {
   // N2 is READ_ONLY and cannot store copies, but is able to participate
   // in digest
@@ -0,0 +1,148 @@
+/**
+ * Copyright (c) 2019-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "logdevice/common/replicated_state_machine/FileCachedRSMSnapshotStore.h"
+
+#include <folly/FileUtil.h>
+#include <gtest/gtest.h>
+
+#include "logdevice/common/debug.h"
+#include "logdevice/common/test/TestUtil.h"
+
+namespace facebook { namespace logdevice {
+
+namespace {
+
+// In-memory underlying store that counts how many times it was hit.
+class FakeUnderlyingStore : public RSMSnapshotStore {
+ public:
+  explicit FakeUnderlyingStore(std::string key)
+      : RSMSnapshotStore(std::move(key), false /* writable */) {}
+
+  void getSnapshot(lsn_t min_ver, snapshot_cb_t cb) override {
+    ++num_get_snapshot_calls_;
+    if (version_ == LSN_INVALID || version_ < min_ver) {
+      cb(E::STALE,
+         "",
+         SnapshotAttributes(LSN_INVALID, std::chrono::milliseconds(0)));
+      return;
+    }
+    cb(E::OK, blob_, SnapshotAttributes(version_, timestamp_));
+  }
+
+  void writeSnapshot(lsn_t /* unused */,
+                     std::string /* unused */,
+                     completion_cb_t cb) override {
+    cb(E::NOTSUPPORTED, LSN_INVALID);
+  }
+
+  void getVersion(snapshot_ver_cb_t cb) override {
+    cb(E::NOTSUPPORTED, LSN_INVALID);
+  }
+
+  void getDurableVersion(snapshot_ver_cb_t cb) override {
+    getVersion(std::move(cb));
+  }
+
+  void setSnapshot(lsn_t version, std::string blob) {
+    version_ = version;
+    blob_ = std::move(blob);
+  }
+
+  int num_get_snapshot_calls_{0};
+
+ private:
+  lsn_t version_{LSN_INVALID};
+  std::string blob_;
+  std::chrono::milliseconds timestamp_{42};
+};
+
+std::unique_ptr<FileCachedRSMSnapshotStore>
+createStore(const std::string& dir, FakeUnderlyingStore** underlying_out) {
+  auto underlying = std::make_unique<FakeUnderlyingStore>("1");
+  *underlying_out = underlying.get();
+  return std::make_unique<FileCachedRSMSnapshotStore>(
+      "1", dir, std::move(underlying));
+}
+
+} // namespace
+
+TEST(FileCachedRSMSnapshotStoreTest, WriteThroughAndServeFromCache) {
+  TemporaryDirectory dir("FileCachedRSMSnapshotStoreTest");
+
+  // Cold start: the cache is empty, the fetch goes to the underlying store
+  // and the result is written through to the cache file.
+  FakeUnderlyingStore* underlying;
+  auto store = createStore(dir.path().string(), &underlying);
+  underlying->setSnapshot(lsn_t(100), "snapshot-blob");
+
+  Status status = E::UNKNOWN;
+  std::string blob;
+  lsn_t version = LSN_INVALID;
+  auto cb = [&](Status st,
+                std::string blob_out,
+                RSMSnapshotStore::SnapshotAttributes attrs) {
+    status = st;
+    blob = std::move(blob_out);
+    version = attrs.base_version;
+  };
+  store->getSnapshot(lsn_t(1), cb);
+  EXPECT_EQ(E::OK, status);
+  EXPECT_EQ("snapshot-blob", blob);
+  EXPECT_EQ(lsn_t(100), version);
+  EXPECT_EQ(1, underlying->num_get_snapshot_calls_);
+
+  // Warm restart: a fresh store over the same directory serves the snapshot
+  // from the cache without hitting the underlying store.
+  store = createStore(dir.path().string(), &underlying);
+  status = E::UNKNOWN;
+  store->getSnapshot(lsn_t(1), cb);
+  EXPECT_EQ(E::OK, status);
+  EXPECT_EQ("snapshot-blob", blob);
+  EXPECT_EQ(lsn_t(100), version);
+  EXPECT_EQ(0, underlying->num_get_snapshot_calls_);
+
+  // A request for a newer version than what is cached goes to the underlying
+  // store, and the fresher snapshot replaces the cached one.
+  underlying->setSnapshot(lsn_t(200), "newer-blob");
+  status = E::UNKNOWN;
+  store->getSnapshot(lsn_t(150), cb);
+  EXPECT_EQ(E::OK, status);
+  EXPECT_EQ("newer-blob", blob);
+  EXPECT_EQ(lsn_t(200), version);
+  EXPECT_EQ(1, underlying->num_get_snapshot_calls_);
+
+  store = createStore(dir.path().string(), &underlying);
+  status = E::UNKNOWN;
+  store->getSnapshot(lsn_t(150), cb);
+  EXPECT_EQ(E::OK, status);
+  EXPECT_EQ("newer-blob", blob);
+  EXPECT_EQ(lsn_t(200), version);
+  EXPECT_EQ(0, underlying->num_get_snapshot_calls_);
+}
+
+TEST(FileCachedRSMSnapshotStoreTest, MalformedCacheIsIgnored) {
+  TemporaryDirectory dir("FileCachedRSMSnapshotStoreTest");
+
+  FakeUnderlyingStore* underlying;
+  auto store = createStore(dir.path().string(), &underlying);
+  ASSERT_TRUE(folly::writeFile(
+      std::string("garbage"), store->getCacheFilePath().c_str()));
+  underlying->setSnapshot(lsn_t(10), "blob");
+
+  Status status = E::UNKNOWN;
+  store->getSnapshot(
+      lsn_t(1),
+      [&](Status st,
+          std::string,
+          RSMSnapshotStore::SnapshotAttributes) { status = st; });
+  EXPECT_EQ(E::OK, status);
+  EXPECT_EQ(1, underlying->num_get_snapshot_calls_);
+}
+
+}} // namespace facebook::logdevice
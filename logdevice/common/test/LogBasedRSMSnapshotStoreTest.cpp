@@ -35,11 +35,18 @@ class MockLogBasedStore : public LogBasedRSMSnapshotStore {
   }
 
   read_stream_id_t createBasicReadStream(
-      lsn_t /* unused */,
-      lsn_t /* unused */,
+      lsn_t start_lsn,
+      lsn_t until_lsn,
       ClientReadStreamDependencies::record_cb_t on_record,
       ClientReadStreamDependencies::gap_cb_t on_gap,
       ClientReadStreamDependencies::health_cb_t /* unused */) override {
+    if (!fake_chunk_records_.empty() && start_lsn != until_lsn) {
+      // range read issued to re-assemble a chunked snapshot
+      for (auto& record : fake_chunk_records_) {
+        on_record(record);
+      }
+      return (read_stream_id_t)0;
+    }
     if (is_record_) {
       on_record(fake_record_);
     } else {
@@ -48,6 +55,12 @@ class MockLogBasedStore : public LogBasedRSMSnapshotStore {
     return (read_stream_id_t)0;
   }
 
+  void postChunkAppend(std::string payload,
+                       std::function<void(Status, lsn_t)> cb) override {
+    appended_chunks_.push_back(std::move(payload));
+    cb(chunk_append_status_, next_chunk_lsn_++);
+  }
+
   void setFakeRecord(std::unique_ptr<DataRecord> record) {
     is_record_ = true;
     fake_record_ = std::move(record);
@@ -74,10 +87,27 @@ class MockLogBasedStore : public LogBasedRSMSnapshotStore {
     fake_get_last_released_lsn_ = lsn;
   }
 
+  void setFakeChunkRecords(std::vector<std::unique_ptr<DataRecord>> records) {
+    fake_chunk_records_ = std::move(records);
+  }
+
+  void setChunkAppendParams(Status st, lsn_t first_lsn) {
+    chunk_append_status_ = st;
+    next_chunk_lsn_ = first_lsn;
+  }
+
+  const std::vector<std::string>& getAppendedChunks() const {
+    return appended_chunks_;
+  }
+
  private:
   Status fake_get_last_released_status_{E::FAILED};
   lsn_t fake_get_last_released_lsn_{LSN_INVALID};
   std::unique_ptr<DataRecord> fake_record_;
+  std::vector<std::unique_ptr<DataRecord>> fake_chunk_records_;
+  std::vector<std::string> appended_chunks_;
+  Status chunk_append_status_{E::OK};
+  lsn_t next_chunk_lsn_{LSN_OLDEST};
   GapRecord fake_gap_;
   RSMSnapshotHeader fake_hdr_;
   bool is_record_{
@@ -99,8 +129,9 @@ static std::unique_ptr<DataRecordOwnsPayload> make_record(logid_t log_id,
 
 class LogBasedRsmTest : public ::testing::Test {
  public:
-  void init(logid_t snapshot_log, logid_t delta_log) {
+  void init(logid_t snapshot_log, logid_t delta_log, size_t chunk_size = 0) {
     Settings settings = create_default_settings<Settings>();
+    settings.rsm_snapshot_chunk_size = chunk_size;
     test_processor_ = make_test_processor(settings, nullptr);
     snapshot_store_ = std::make_unique<MockLogBasedStore>(
         folly::to<std::string>(delta_log.val_),
@@ -257,4 +288,120 @@ TEST_F(LogBasedRsmTest, StaleReply) {
   sem.wait();
 }
 
+static std::string make_snapshot_blob(lsn_t base_ver, size_t data_size) {
+  RSMSnapshotHeader hdr(RSMSnapshotHeader::CONTAINS_NODE_METADATA,
+                        0 /* flags */,
+                        0 /* byte_offset */,
+                        0 /* offset */,
+                        base_ver);
+  const int header_sz = RSMSnapshotHeader::computeLengthInBytes(hdr);
+  std::string blob;
+  blob.resize(header_sz);
+  EXPECT_EQ(header_sz, RSMSnapshotHeader::serialize(hdr, &blob[0], header_sz));
+  for (size_t i = 0; i < data_size; ++i) {
+    blob += static_cast<char>('a' + (i % 26));
+  }
+  return blob;
+}
+
+TEST_F(LogBasedRsmTest, ChunkedSnapshotWriteAndReadBack) {
+  const size_t chunk_size = 64;
+  init(logid_t(1), logid_t(2), chunk_size);
+  lsn_t base_ver = compose_lsn(epoch_t(10), esn_t(5));
+  Semaphore sem;
+
+  std::string blob = make_snapshot_blob(base_ver, 300);
+  ASSERT_GT(blob.size(), chunk_size);
+
+  lsn_t first_chunk_lsn = compose_lsn(epoch_t(2), esn_t(10));
+  snapshot_store_->setChunkAppendParams(E::OK, first_chunk_lsn);
+  snapshot_store_->writeSnapshot(base_ver, blob, [&](Status st, lsn_t ver) {
+    ASSERT_EQ(E::OK, st);
+    ASSERT_EQ(base_ver, ver);
+    sem.post();
+  });
+  sem.wait();
+
+  const auto& chunks = snapshot_store_->getAppendedChunks();
+  ASSERT_EQ((blob.size() + chunk_size - 1) / chunk_size, chunks.size());
+
+  // Feed the chunk records back through getSnapshot() and verify that the
+  // original blob is re-assembled.
+  lsn_t tail_lsn = first_chunk_lsn + chunks.size() - 1;
+  std::vector<std::unique_ptr<DataRecord>> records;
+  for (size_t i = 0; i < chunks.size(); ++i) {
+    records.push_back(make_record(logid_t(1), first_chunk_lsn + i, chunks[i]));
+  }
+  snapshot_store_->setFakeRecord(
+      make_record(logid_t(1), tail_lsn, chunks.back()));
+  snapshot_store_->setFakeChunkRecords(std::move(records));
+  RSMSnapshotHeader fake_hdr;
+  fake_hdr.base_version = base_ver;
+  snapshot_store_->setFakeSnapshotHeader(std::move(fake_hdr));
+  snapshot_store_->setFakeGetLastReleasedLsnParams(E::OK, tail_lsn);
+
+  auto snapshot_cb = [&](Status st,
+                         std::string snapshot_blob_out,
+                         RSMSnapshotStore::SnapshotAttributes attrs) {
+    ASSERT_EQ(E::OK, st);
+    ASSERT_EQ(blob, snapshot_blob_out);
+    ASSERT_EQ(base_ver, attrs.base_version);
+    sem.post();
+  };
+  snapshot_store_->getSnapshot(LSN_OLDEST, std::move(snapshot_cb));
+  sem.wait();
+}
+
+TEST_F(LogBasedRsmTest, ChunkedSnapshotIncompleteWriteAtTail) {
+  const size_t chunk_size = 64;
+  init(logid_t(1), logid_t(2), chunk_size);
+  lsn_t base_ver = compose_lsn(epoch_t(10), esn_t(5));
+  Semaphore sem;
+
+  std::string blob = make_snapshot_blob(base_ver, 300);
+  lsn_t first_chunk_lsn = compose_lsn(epoch_t(2), esn_t(10));
+  snapshot_store_->setChunkAppendParams(E::OK, first_chunk_lsn);
+  snapshot_store_->writeSnapshot(
+      base_ver, blob, [&](Status st, lsn_t /* unused */) {
+        ASSERT_EQ(E::OK, st);
+        sem.post();
+      });
+  sem.wait();
+
+  // If the writer crashed in the middle of a chunked write, the record at the
+  // tail is not the final chunk; getSnapshot() must fail with E::BADMSG
+  // rather than serve a partial snapshot.
+  const auto& chunks = snapshot_store_->getAppendedChunks();
+  ASSERT_GT(chunks.size(), 1);
+  snapshot_store_->setFakeRecord(
+      make_record(logid_t(1), first_chunk_lsn, chunks.front()));
+  snapshot_store_->setFakeGetLastReleasedLsnParams(E::OK, first_chunk_lsn);
+
+  auto snapshot_cb = [&](Status st,
+                         std::string /* unused */,
+                         RSMSnapshotStore::SnapshotAttributes attrs) {
+    ASSERT_EQ(E::BADMSG, st);
+    ASSERT_EQ(LSN_INVALID, attrs.base_version);
+    sem.post();
+  };
+  snapshot_store_->getSnapshot(LSN_OLDEST, std::move(snapshot_cb));
+  sem.wait();
+}
+
+TEST_F(LogBasedRsmTest, ChunkedSnapshotWriteFailure) {
+  const size_t chunk_size = 64;
+  init(logid_t(1), logid_t(2), chunk_size);
+  lsn_t base_ver = compose_lsn(epoch_t(10), esn_t(5));
+  Semaphore sem;
+
+  std::string blob = make_snapshot_blob(base_ver, 300);
+  snapshot_store_->setChunkAppendParams(E::SEQNOBUFS, LSN_OLDEST);
+  snapshot_store_->writeSnapshot(base_ver, blob, [&](Status st, lsn_t lsn) {
+    ASSERT_EQ(E::SEQNOBUFS, st);
+    ASSERT_EQ(LSN_INVALID, lsn);
+    sem.post();
+  });
+  sem.wait();
+}
+
 }} // namespace facebook::logdevice
@@ -470,6 +470,42 @@ TEST(LogsConfigTreeTest, TestFindLogByID) {
   ASSERT_FALSE(not_found);
 }
 
+// Exercises the compiled (flattened) lookup index over many ranges,
+// including range boundaries, gaps between ranges and lookups interleaved
+// with mutations that force a recompile.
+TEST(LogsConfigTreeTest, TestFindLogByIDManyRanges) {
+  std::unique_ptr<LogsConfigTree> tree = LogsConfigTree::create();
+  auto dir1 = tree->addDirectory(tree->root(), "logs", LogAttributes());
+  std::vector<LogGroupNodePtr> groups;
+  // ranges [10*i, 10*i + 4] with a gap of 5 logids between them
+  for (int i = 1; i <= 100; i++) {
+    auto lg = tree->addLogGroup(
+        dir1,
+        "lg" + std::to_string(i),
+        logid_range_t{logid_t(10 * i), logid_t(10 * i + 4)});
+    ASSERT_TRUE(lg);
+    groups.push_back(lg);
+  }
+  for (int i = 1; i <= 100; i++) {
+    // both boundaries and the middle of the range resolve to the group
+    for (uint64_t id : {10 * i, 10 * i + 2, 10 * i + 4}) {
+      auto found = tree->getLogGroupByID(logid_t(id));
+      ASSERT_TRUE(found != nullptr);
+      ASSERT_EQ(groups[i - 1], found->log_group);
+    }
+    // the gap right after the range doesn't
+    ASSERT_EQ(nullptr, tree->getLogGroupByID(logid_t(10 * i + 5)));
+  }
+  // below the first range and above the last range
+  ASSERT_EQ(nullptr, tree->getLogGroupByID(logid_t(1)));
+  ASSERT_EQ(nullptr, tree->getLogGroupByID(logid_t(5000)));
+  // deleting a group in the middle is visible to subsequent lookups
+  ASSERT_EQ(0, tree->deleteLogGroup("/logs/lg50"));
+  ASSERT_EQ(nullptr, tree->getLogGroupByID(logid_t(500)));
+  ASSERT_TRUE(tree->getLogGroupByID(logid_t(490)));
+  ASSERT_TRUE(tree->getLogGroupByID(logid_t(510)));
+}
+
 TEST(LogsConfigTreeTest, TestMetadataLogAddFail) {
   std::unique_ptr<LogsConfigTree> tree = LogsConfigTree::create();
   LogAttributes base_attrs = LogAttributes().with_replicationFactor(2);
@@ -8,6 +8,8 @@
 
 #include "logdevice/common/network/MessageReader.h"
 
+#include <cstring>
+
 #include <gtest/gtest.h>
 
 #include "logdevice/common/protocol/Compatibility.h"
@@ -15,54 +17,54 @@
 
 using namespace ::testing;
 using ::testing::_;
+using ::testing::Invoke;
 using ::testing::Return;
 using namespace facebook::logdevice;
 
+namespace {
+// Writes a header for a STORE message with a body of body_size bytes at buf
+// and returns the total wire size of the message.
+size_t writeStoreHeader(void* buf, size_t body_size) {
+  ProtocolHeader hdr;
+  hdr.type = MessageType::STORE;
+  hdr.len = body_size + sizeof(ProtocolHeader);
+  hdr.cksum = 0;
+  memcpy(buf, &hdr, sizeof(hdr));
+  return hdr.len;
+}
+} // namespace
+
 TEST(MessageReaderTest, EntireMessageReceivedTest) {
   MockProtocolHandler mock_conn;
   MessageReader read_cb(mock_conn, Compatibility::MAX_PROTOCOL_SUPPORTED);
+  const size_t store_msg_size = 100;
   EXPECT_CALL(mock_conn, validateProtocolHeader(_))
       .Times(2)
       .WillRepeatedly(Return(true));
-  EXPECT_CALL(mock_conn, dispatchMessageBody(_, _)).Times(1);
+  EXPECT_CALL(mock_conn, dispatchMessageBody(_, _))
+      .Times(2)
+      .WillRepeatedly(Invoke(
+          [&](const ProtocolHeader& hdr, std::unique_ptr<folly::IOBuf> body) {
+            EXPECT_EQ(MessageType::STORE, hdr.type);
+            EXPECT_EQ(store_msg_size, body->length());
+            return 0;
+          }));
   ON_CALL(mock_conn, good()).WillByDefault(Return(true));
   void* bufReturn = nullptr;
   size_t lenReturn = 0;
   read_cb.getReadBuffer(&bufReturn, &lenReturn);
   ASSERT_NE(nullptr, bufReturn);
-  ASSERT_EQ(sizeof(ProtocolHeader), lenReturn);
-  ProtocolHeader* hdr = (ProtocolHeader*)bufReturn;
-  const size_t store_msg_size = 100;
-  hdr->type = MessageType::STORE;
-  hdr->len = store_msg_size + sizeof(ProtocolHeader);
-  hdr->cksum = 0;
-  read_cb.readDataAvailable(lenReturn);
+  ASSERT_GE(lenReturn, 2 * (sizeof(ProtocolHeader) + store_msg_size));
+  // Two complete messages arriving in a single socket read should both get
+  // dispatched from one readDataAvailable() call.
+  uint8_t* buf = static_cast<uint8_t*>(bufReturn);
+  buf += writeStoreHeader(buf, store_msg_size);
+  buf += writeStoreHeader(buf, store_msg_size);
+  read_cb.readDataAvailable(buf - static_cast<uint8_t*>(bufReturn));
+  // The next read continues in the same chunk, right after the consumed
+  // bytes.
   read_cb.getReadBuffer(&bufReturn, &lenReturn);
-  ASSERT_NE(nullptr, bufReturn);
-  ASSERT_EQ(store_msg_size, lenReturn);
-  read_cb.readDataAvailable(store_msg_size);
-  // This test knowns something about the implementation and would need to
-  // change once implementation changes. Don't like it but it's ok I guess.
-  void* prev_buf_ptr = bufReturn;
-  read_cb.getReadBuffer(&bufReturn, &lenReturn);
-  ASSERT_NE(nullptr, bufReturn);
-  ASSERT_EQ(sizeof(ProtocolHeader), lenReturn);
-  // Calling it again should get the same buffer.
-  prev_buf_ptr = bufReturn;
-  read_cb.getReadBuffer(&bufReturn, &lenReturn);
-  ASSERT_EQ(bufReturn, prev_buf_ptr);
-  ASSERT_EQ(sizeof(ProtocolHeader), lenReturn);
-  // Add another store message header of store_msg_size
-  hdr = (ProtocolHeader*)bufReturn;
-  hdr->type = MessageType::STORE;
-  hdr->len = store_msg_size + sizeof(ProtocolHeader);
-  hdr->cksum = 0;
-  read_cb.readDataAvailable(lenReturn);
-  // Calling getReadBuffer again should get buffer of  msg_size +
-  // sizeof(ProtocolHeader).
-  read_cb.getReadBuffer(&bufReturn, &lenReturn);
-  ASSERT_NE(nullptr, bufReturn);
-  ASSERT_EQ(store_msg_size, lenReturn);
+  ASSERT_EQ(buf, bufReturn);
 }
 
 TEST(MessageReaderTest, PartialHeaderReceived) {
@@ -72,31 +74,30 @@ TEST(MessageReaderTest, PartialHeaderReceived) {
       .Times(1)
       .WillRepeatedly(Return(true));
   ON_CALL(mock_conn, good()).WillByDefault(Return(true));
+  const size_t store_msg_size = 100;
+  ProtocolHeader hdr;
+  hdr.type = MessageType::STORE;
+  hdr.len = store_msg_size + sizeof(ProtocolHeader);
+  hdr.cksum = 0;
+  const uint8_t* src = reinterpret_cast<const uint8_t*>(&hdr);
   void* bufReturn = nullptr;
   size_t lenReturn = 0;
-  void* prev_buf_ptr = bufReturn;
-  for (size_t total_buffer_size = sizeof(ProtocolHeader); total_buffer_size > 1;
-       total_buffer_size--) {
+  void* prev_buf_ptr = nullptr;
+  // Trickle the header in one byte at a time; nothing should be dispatched
+  // and the bytes should accumulate in the same chunk.
+  for (size_t i = 0; i < sizeof(ProtocolHeader); ++i) {
     read_cb.getReadBuffer(&bufReturn, &lenReturn);
+    ASSERT_NE(nullptr, bufReturn);
+    ASSERT_GT(lenReturn, 0);
     if (prev_buf_ptr != nullptr) {
       ASSERT_EQ((uint8_t*)prev_buf_ptr + 1, (uint8_t*)bufReturn);
     }
-    ASSERT_EQ(lenReturn, total_buffer_size);
+    *static_cast<uint8_t*>(bufReturn) = src[i];
     read_cb.readDataAvailable(1);
     prev_buf_ptr = bufReturn;
   }
-  // Get the last byte so that we can write the header contents.
-  read_cb.getReadBuffer(&bufReturn, &lenReturn);
-  ASSERT_EQ((uint8_t*)prev_buf_ptr + 1, (uint8_t*)bufReturn);
-  ASSERT_EQ(lenReturn, 1);
-  ProtocolHeader* hdr =
-      (ProtocolHeader*)((uint8_t*)bufReturn - sizeof(ProtocolHeader) + 1);
-  const size_t store_msg_size = 100;
-  hdr->type = MessageType::STORE;
-  hdr->len = store_msg_size + sizeof(ProtocolHeader);
-  hdr->cksum = 0;
-  read_cb.readDataAvailable(1);
-
+  // Header complete; the body is now read into a dedicated buffer sized
+  // exactly for it.
   read_cb.getReadBuffer(&bufReturn, &lenReturn);
   ASSERT_NE(nullptr, bufReturn);
   ASSERT_EQ(store_msg_size, lenReturn);
@@ -109,20 +110,18 @@ TEST(MessageReaderTest, PartialMessageReceived) {
       .Times(2)
       .WillRepeatedly(Return(true));
   ON_CALL(mock_conn, good()).WillByDefault(Return(true));
+  const size_t store_msg_size = 100;
   void* bufReturn = nullptr;
   size_t lenReturn = 0;
   read_cb.getReadBuffer(&bufReturn, &lenReturn);
   ASSERT_NE(nullptr, bufReturn);
-  ASSERT_EQ(sizeof(ProtocolHeader), lenReturn);
-  ProtocolHeader* hdr = (ProtocolHeader*)bufReturn;
-  const size_t store_msg_size = 100;
-  hdr->type = MessageType::STORE;
-  hdr->len = store_msg_size + sizeof(ProtocolHeader);
-  hdr->cksum = 0;
-  read_cb.readDataAvailable(lenReturn);
+  writeStoreHeader(bufReturn, store_msg_size);
+  read_cb.readDataAvailable(sizeof(ProtocolHeader));
   bufReturn = nullptr;
   void* prev_buf_ptr = bufReturn;
   EXPECT_CALL(mock_conn, dispatchMessageBody(_, _)).Times(1);
+  // The body arrives one byte at a time and goes into the dedicated body
+  // buffer; the message is dispatched once the last byte is in.
   for (size_t total_buffer_size = store_msg_size; total_buffer_size > 0;
        total_buffer_size--) {
     read_cb.getReadBuffer(&bufReturn, &lenReturn);
@@ -133,18 +132,62 @@ TEST(MessageReaderTest, PartialMessageReceived) {
     read_cb.readDataAvailable(1);
     prev_buf_ptr = bufReturn;
   }
-  // Get the last byte so that we can write the header contents.
+  // Back to reading into a chunk; a complete message written there should be
+  // dispatched in one go.
+  EXPECT_CALL(mock_conn, dispatchMessageBody(_, _)).Times(1);
   read_cb.getReadBuffer(&bufReturn, &lenReturn);
   ASSERT_NE(nullptr, bufReturn);
-  ASSERT_EQ(lenReturn, sizeof(ProtocolHeader));
-  hdr = (ProtocolHeader*)bufReturn;
-  hdr->type = MessageType::STORE;
-  hdr->len = store_msg_size + sizeof(ProtocolHeader);
-  hdr->cksum = 0;
-  read_cb.readDataAvailable(sizeof(ProtocolHeader));
+  ASSERT_GE(lenReturn, sizeof(ProtocolHeader) + store_msg_size);
+  read_cb.readDataAvailable(writeStoreHeader(bufReturn, store_msg_size));
+}
+
+TEST(MessageReaderTest, ChunkBoundaryHeaderCarryOver) {
+  MockProtocolHandler mock_conn;
+  MessageReader read_cb(mock_conn, Compatibility::MAX_PROTOCOL_SUPPORTED);
+  EXPECT_CALL(mock_conn, validateProtocolHeader(_))
+      .Times(2)
+      .WillRepeatedly(Return(true));
+  ON_CALL(mock_conn, good()).WillByDefault(Return(true));
+  void* bufReturn = nullptr;
+  size_t lenReturn = 0;
   read_cb.getReadBuffer(&bufReturn, &lenReturn);
   ASSERT_NE(nullptr, bufReturn);
-  ASSERT_EQ(store_msg_size, lenReturn);
+  const size_t chunk_size = lenReturn;
+  // Fill the chunk with one message whose total size leaves only 5 bytes of
+  // tailroom, followed by the first 5 bytes of the next message's header.
+  const size_t carry_over = 5;
+  const size_t first_msg_wire_size = chunk_size - 2 * carry_over;
+  uint8_t* buf = static_cast<uint8_t*>(bufReturn);
+  writeStoreHeader(buf, first_msg_wire_size - sizeof(ProtocolHeader));
+  buf += first_msg_wire_size;
+  const size_t store_msg_size = 100;
+  ProtocolHeader hdr;
+  hdr.type = MessageType::STORE;
+  hdr.len = store_msg_size + sizeof(ProtocolHeader);
+  hdr.cksum = 0;
+  memcpy(buf, &hdr, carry_over);
+  EXPECT_CALL(mock_conn, dispatchMessageBody(_, _)).Times(1);
+  read_cb.readDataAvailable(first_msg_wire_size + carry_over);
+  // The chunk has too little tailroom left for a header, so the next
+  // getReadBuffer() starts a fresh chunk with the 5 partial header bytes
+  // carried over.
+  read_cb.getReadBuffer(&bufReturn, &lenReturn);
+  ASSERT_NE(nullptr, bufReturn);
+  ASSERT_GE(lenReturn, chunk_size - carry_over);
+  memcpy(bufReturn,
+         reinterpret_cast<const uint8_t*>(&hdr) + carry_over,
+         sizeof(ProtocolHeader) - carry_over);
+  EXPECT_CALL(mock_conn, dispatchMessageBody(_, _))
+      .Times(1)
+      .WillOnce(Invoke(
+          [&](const ProtocolHeader& dispatched_hdr,
+              std::unique_ptr<folly::IOBuf> body) {
+            EXPECT_EQ(hdr.len, dispatched_hdr.len);
+            EXPECT_EQ(store_msg_size, body->length());
+            return 0;
+          }));
+  read_cb.readDataAvailable(sizeof(ProtocolHeader) - carry_over +
+                            store_msg_size);
 }
 
 TEST(MessageReaderTest, HitErrorWhenProcessingMessageOrHeader) {
@@ -153,24 +196,20 @@ TEST(MessageReaderTest, HitErrorWhenProcessingMessageOrHeader) {
   EXPECT_CALL(mock_conn, validateProtocolHeader(_))
       .Times(1)
       .WillRepeatedly(Return(true));
-  // Will return valid buffer once.
+  // Goes bad after the header is processed.
   EXPECT_CALL(mock_conn, good())
-      .Times(3)
       .WillOnce(Return(true))
       .WillOnce(Return(true))
-      .WillOnce(Return(false));
+      .WillOnce(Return(true))
+      .WillRepeatedly(Return(false));
 
   void* bufReturn = nullptr;
   size_t lenReturn = 0;
   read_cb.getReadBuffer(&bufReturn, &lenReturn);
   ASSERT_NE(nullptr, bufReturn);
-  ASSERT_EQ(sizeof(ProtocolHeader), lenReturn);
-  ProtocolHeader* hdr = (ProtocolHeader*)bufReturn;
   const size_t store_msg_size = 100;
-  hdr->type = MessageType::STORE;
-  hdr->len = store_msg_size + sizeof(ProtocolHeader);
-  hdr->cksum = 0;
-  read_cb.readDataAvailable(lenReturn);
+  writeStoreHeader(bufReturn, store_msg_size);
+  read_cb.readDataAvailable(sizeof(ProtocolHeader));
   read_cb.getReadBuffer(&bufReturn, &lenReturn);
   ASSERT_EQ(nullptr, bufReturn);
   ASSERT_EQ(0, lenReturn);
@@ -183,23 +222,57 @@ TEST(MessageReaderTest, FailProtocolHeaderValidation) {
       .Times(1)
       .WillRepeatedly(Return(false));
   EXPECT_CALL(mock_conn, good())
-      .Times(3)
       .WillOnce(Return(true))
       .WillOnce(Return(true))
-      .WillOnce(Return(false));
+      .WillOnce(Return(true))
+      .WillRepeatedly(Return(false));
   EXPECT_CALL(mock_conn, notifyErrorOnSocket(_)).Times(1);
   void* bufReturn = nullptr;
   size_t lenReturn = 0;
   read_cb.getReadBuffer(&bufReturn, &lenReturn);
   ASSERT_NE(nullptr, bufReturn);
-  ASSERT_EQ(sizeof(ProtocolHeader), lenReturn);
-  ProtocolHeader* hdr = (ProtocolHeader*)bufReturn;
   const size_t store_msg_size = 100;
-  hdr->type = MessageType::STORE;
-  hdr->len = store_msg_size + sizeof(ProtocolHeader);
-  hdr->cksum = 0;
-  read_cb.readDataAvailable(lenReturn);
+  writeStoreHeader(bufReturn, store_msg_size);
+  read_cb.readDataAvailable(sizeof(ProtocolHeader));
   read_cb.getReadBuffer(&bufReturn, &lenReturn);
   ASSERT_EQ(nullptr, bufReturn);
   ASSERT_EQ(0, lenReturn);
 }
+
+TEST(MessageReaderTest, DispatchPausesAfterFailure) {
+  MockProtocolHandler mock_conn;
+  MessageReader read_cb(mock_conn, Compatibility::MAX_PROTOCOL_SUPPORTED);
+  ON_CALL(mock_conn, good()).WillByDefault(Return(true));
+  EXPECT_CALL(mock_conn, validateProtocolHeader(_))
+      .Times(3)
+      .WillRepeatedly(Return(true));
+  // Make the second dispatch fail, as it would on NOBUFS when the Worker is
+  // overloaded. The Connection would take ownership of that message for a
+  // deferred retry, so the reader must hold back the third one.
+  const size_t body_sizes[] = {10, 20, 30};
+  int dispatched = 0;
+  EXPECT_CALL(mock_conn, dispatchMessageBody(_, _))
+      .Times(3)
+      .WillRepeatedly(Invoke(
+          [&](const ProtocolHeader& hdr, std::unique_ptr<folly::IOBuf> body) {
+            // Arrival order must be preserved across the pause.
+            EXPECT_EQ(body_sizes[dispatched], body->length());
+            EXPECT_EQ(body_sizes[dispatched] + sizeof(ProtocolHeader), hdr.len);
+            ++dispatched;
+            return dispatched == 2 ? -1 : 0;
+          }));
+  void* bufReturn = nullptr;
+  size_t lenReturn = 0;
+  read_cb.getReadBuffer(&bufReturn, &lenReturn);
+  ASSERT_NE(nullptr, bufReturn);
+  uint8_t* buf = static_cast<uint8_t*>(bufReturn);
+  for (size_t body_size : body_sizes) {
+    buf += writeStoreHeader(buf, body_size);
+  }
+  read_cb.readDataAvailable(buf - static_cast<uint8_t*>(bufReturn));
+  // The second dispatch failed; the third message stays queued.
+  EXPECT_EQ(2, dispatched);
+  // Once the failed message has been retried, Connection drains the rest.
+  EXPECT_EQ(0, read_cb.drainPendingMessages());
+  EXPECT_EQ(3, dispatched);
+}
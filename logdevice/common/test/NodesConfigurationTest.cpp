@@ -161,6 +161,43 @@ TEST_F(NodesConfigurationTest, TestMembershipVersionConsistencyValidation) {
   EXPECT_FALSE(c->validate());
 }
 
+TEST_F(NodesConfigurationTest, ShareSubConfigsFrom) {
+  auto config = provisionNodes();
+  ASSERT_TRUE(config->validate());
+
+  // a codec round trip produces equal but distinct sub-config objects
+  auto deserialized = NodesConfigurationCodec::deserialize(
+      NodesConfigurationCodec::serialize(*config));
+  ASSERT_NE(nullptr, deserialized);
+  ASSERT_NE(config->getServiceDiscovery(), deserialized->getServiceDiscovery());
+
+  auto shared = NodesConfiguration::shareSubConfigsFrom(deserialized, *config);
+  ASSERT_NE(nullptr, shared);
+  EXPECT_TRUE(shared->equalWithTimestampIgnored(*deserialized));
+  // all four components are re-pointed at the base config's objects
+  EXPECT_EQ(config->getServiceDiscovery(), shared->getServiceDiscovery());
+  EXPECT_EQ(config->getSequencerConfig(), shared->getSequencerConfig());
+  EXPECT_EQ(config->getStorageConfig(), shared->getStorageConfig());
+  EXPECT_EQ(config->getMetaDataLogsReplication(),
+            shared->getMetaDataLogsReplication());
+
+  // after adding a node only the untouched components are shared
+  auto updated = config->applyUpdate(addNewNodeUpdate(*config, 17));
+  ASSERT_NE(nullptr, updated);
+  auto round_trip = NodesConfigurationCodec::deserialize(
+      NodesConfigurationCodec::serialize(*updated));
+  ASSERT_NE(nullptr, round_trip);
+  auto shared2 = NodesConfiguration::shareSubConfigsFrom(round_trip, *config);
+  ASSERT_NE(nullptr, shared2);
+  EXPECT_TRUE(shared2->equalWithTimestampIgnored(*round_trip));
+  // the new node changed service discovery and the memberships
+  EXPECT_NE(config->getServiceDiscovery(), shared2->getServiceDiscovery());
+  EXPECT_NE(config->getStorageConfig(), shared2->getStorageConfig());
+  // metadata logs replication was not touched by the update
+  EXPECT_EQ(config->getMetaDataLogsReplication(),
+            shared2->getMetaDataLogsReplication());
+}
+
 TEST_F(NodesConfigurationTest, TestGossipDefaultingToDataAddress) {
   auto config = provisionNodes();
   ASSERT_TRUE(config->validate());
@@ -74,9 +74,8 @@ TEST(OffsetMapTest, Operators) {
 TEST(OffsetMapTest, AtomicTest) {
   AtomicOffsetMap atomic_offset_map;
   OffsetMap offset_map_1, offset_map_2;
-  offset_map_1.setCounter(1, 10);
-  offset_map_1.setCounter(2, 20);
-  offset_map_2.setCounter(3, 30);
+  offset_map_1.setCounter(BYTE_OFFSET, 10);
+  offset_map_2.setCounter(BYTE_OFFSET, 30);
 
   int n_loop = 10;
 
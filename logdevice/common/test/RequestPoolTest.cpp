@@ -0,0 +1,88 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/RequestPool.h"
+
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "logdevice/common/Request.h"
+#include "logdevice/common/RequestType.h"
+
+namespace facebook { namespace logdevice {
+
+namespace {
+
+class PooledTestRequest : public Request,
+                          public PooledRequest<PooledTestRequest> {
+ public:
+  PooledTestRequest() : Request(RequestType::TEST_REQUEST) {}
+  Execution execute() override {
+    return Execution::COMPLETE;
+  }
+  uint64_t payload_[4] = {};
+};
+
+// A further subclass that did NOT opt into pooling itself; must fall
+// through to the global allocator via the size check.
+class DerivedTestRequest : public PooledTestRequest {
+ public:
+  uint64_t more_payload_[8] = {};
+};
+
+} // namespace
+
+TEST(RequestPoolTest, RecyclesMemoryOnSameThread) {
+  auto* first = new PooledTestRequest();
+  void* addr = first;
+  delete first;
+  // The freed object goes on this thread's freelist and is handed right
+  // back for the next allocation of the same type.
+  auto* second = new PooledTestRequest();
+  EXPECT_EQ(addr, static_cast<void*>(second));
+  delete second;
+}
+
+TEST(RequestPoolTest, SubclassFallsBackToGlobalAllocator) {
+  // No assertion beyond not crashing: sizeof(DerivedTestRequest) doesn't
+  // match the pooled type, so both new and delete must bypass the pool
+  // (mixing them up would corrupt the freelist and trip ASAN).
+  for (int i = 0; i < 100; ++i) {
+    auto* req = new DerivedTestRequest();
+    delete req;
+  }
+}
+
+TEST(RequestPoolTest, CrossThreadFree) {
+  // Allocate on this thread, destroy on another; the object lands on the
+  // destroying thread's freelist and is reused there.
+  auto* req = new PooledTestRequest();
+  std::thread t([req]() {
+    void* addr = req;
+    delete req;
+    auto* reused = new PooledTestRequest();
+    EXPECT_EQ(addr, static_cast<void*>(reused));
+    delete reused;
+  });
+  t.join();
+}
+
+TEST(RequestPoolTest, FreelistIsBounded) {
+  // Churn well past the per-thread cap; surplus frees must go back to the
+  // global allocator without leaking (verified by ASAN in sanitized runs).
+  std::vector<PooledTestRequest*> reqs;
+  for (int i = 0; i < 1000; ++i) {
+    reqs.push_back(new PooledTestRequest());
+  }
+  for (auto* req : reqs) {
+    delete req;
+  }
+}
+
+}} // namespace facebook::logdevice
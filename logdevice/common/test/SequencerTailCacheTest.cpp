@@ -0,0 +1,144 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/SequencerTailCache.h"
+
+#include <gtest/gtest.h>
+
+#include "logdevice/common/OffsetMap.h"
+
+namespace {
+
+using namespace facebook::logdevice;
+
+constexpr logid_t LOG_ID(777);
+
+TailRecord genRecord(lsn_t lsn, size_t payload_size, bool payload = true) {
+  TailRecordHeader::flags_t flags = TailRecordHeader::CHECKSUM_PARITY |
+      TailRecordHeader::OFFSET_WITHIN_EPOCH | TailRecordHeader::OFFSET_MAP |
+      (payload ? TailRecordHeader::HAS_PAYLOAD : 0);
+  return TailRecord(
+      TailRecordHeader{
+          LOG_ID,
+          lsn,
+          1502502135,
+          {BYTE_OFFSET_INVALID /* deprecated, OffsetMap used instead */},
+          flags,
+          {}},
+      OffsetMap({{BYTE_OFFSET, 1024}}),
+      PayloadHolder::copyString(std::string(payload ? payload_size : 0, 'x')));
+}
+
+lsn_t lsn(uint32_t epoch, uint32_t esn) {
+  return compose_lsn(epoch_t(epoch), esn_t(esn));
+}
+
+TEST(SequencerTailCacheTest, BasicRange) {
+  SequencerTailCache cache(1024 * 1024);
+  for (uint32_t e = 1; e <= 10; ++e) {
+    cache.push(genRecord(lsn(1, e), 10));
+  }
+
+  std::vector<TailRecord> out;
+  ASSERT_EQ(E::OK, cache.getRecords(lsn(1, 3), lsn(1, 7), 100, &out));
+  ASSERT_EQ(5, out.size());
+  EXPECT_EQ(lsn(1, 3), out.front().header.lsn);
+  EXPECT_EQ(lsn(1, 7), out.back().header.lsn);
+  for (const TailRecord& r : out) {
+    EXPECT_TRUE(r.hasPayload());
+  }
+
+  // max_records caps the result
+  out.clear();
+  ASSERT_EQ(E::OK, cache.getRecords(lsn(1, 1), lsn(1, 10), 4, &out));
+  ASSERT_EQ(4, out.size());
+  EXPECT_EQ(lsn(1, 4), out.back().header.lsn);
+
+  // range above everything released so far: OK but empty
+  out.clear();
+  ASSERT_EQ(E::OK, cache.getRecords(lsn(1, 10), lsn(2, 5), 100, &out));
+  ASSERT_EQ(1, out.size());
+  out.clear();
+  ASSERT_EQ(E::OK, cache.getRecords(lsn(2, 1), lsn(2, 5), 100, &out));
+  ASSERT_TRUE(out.empty());
+}
+
+TEST(SequencerTailCacheTest, StaleBelowFront) {
+  SequencerTailCache cache(1024 * 1024);
+  cache.push(genRecord(lsn(5, 10), 10));
+  cache.push(genRecord(lsn(5, 11), 10));
+
+  // records before the first insertion may exist on storage nodes but are
+  // not covered by the ring
+  std::vector<TailRecord> out;
+  ASSERT_EQ(E::STALE, cache.getRecords(lsn(5, 9), lsn(5, 11), 100, &out));
+  ASSERT_EQ(E::STALE, cache.getRecords(lsn(1, 1), lsn(5, 11), 100, &out));
+  ASSERT_TRUE(out.empty());
+
+  // empty cache is always stale
+  cache.clear();
+  ASSERT_EQ(E::STALE, cache.getRecords(lsn(5, 10), lsn(5, 11), 100, &out));
+}
+
+TEST(SequencerTailCacheTest, ByteBudgetEviction) {
+  // budget fits roughly 10 records of 100 bytes
+  SequencerTailCache cache(1000);
+  for (uint32_t e = 1; e <= 20; ++e) {
+    cache.push(genRecord(lsn(1, e), 100));
+  }
+  EXPECT_LE(cache.payloadBytes(), 1000);
+
+  // the front of the ring moved; old LSNs are stale, recent ones served
+  std::vector<TailRecord> out;
+  ASSERT_EQ(E::STALE, cache.getRecords(lsn(1, 1), lsn(1, 20), 100, &out));
+  ASSERT_EQ(E::OK, cache.getRecords(lsn(1, 15), lsn(1, 20), 100, &out));
+  ASSERT_EQ(6, out.size());
+
+  // a record bigger than the whole budget clears the cache
+  cache.push(genRecord(lsn(1, 21), 2000));
+  EXPECT_EQ(0, cache.payloadBytes());
+  out.clear();
+  ASSERT_EQ(E::STALE, cache.getRecords(lsn(1, 21), lsn(1, 21), 100, &out));
+}
+
+TEST(SequencerTailCacheTest, PayloadlessRecordClears) {
+  SequencerTailCache cache(1024 * 1024);
+  cache.push(genRecord(lsn(1, 1), 10));
+  cache.push(genRecord(lsn(1, 2), 10));
+  EXPECT_GT(cache.payloadBytes(), 0);
+
+  // a record without a payload cannot be served; the ring restarts so that
+  // readers are never handed a range with a hole in it
+  cache.push(genRecord(lsn(1, 3), 0, /*payload=*/false));
+  EXPECT_EQ(0, cache.payloadBytes());
+
+  std::vector<TailRecord> out;
+  ASSERT_EQ(E::STALE, cache.getRecords(lsn(1, 1), lsn(1, 3), 100, &out));
+
+  cache.push(genRecord(lsn(1, 4), 10));
+  ASSERT_EQ(E::OK, cache.getRecords(lsn(1, 4), lsn(1, 4), 100, &out));
+  ASSERT_EQ(1, out.size());
+}
+
+TEST(SequencerTailCacheTest, OutOfOrderInsert) {
+  SequencerTailCache cache(1024 * 1024);
+  // reaps of a draining epoch may interleave with reaps of the current one
+  cache.push(genRecord(lsn(1, 8), 10));
+  cache.push(genRecord(lsn(2, 1), 10));
+  cache.push(genRecord(lsn(1, 9), 10));
+  cache.push(genRecord(lsn(2, 2), 10));
+
+  std::vector<TailRecord> out;
+  ASSERT_EQ(E::OK, cache.getRecords(lsn(1, 8), lsn(2, 2), 100, &out));
+  ASSERT_EQ(4, out.size());
+  EXPECT_EQ(lsn(1, 8), out[0].header.lsn);
+  EXPECT_EQ(lsn(1, 9), out[1].header.lsn);
+  EXPECT_EQ(lsn(2, 1), out[2].header.lsn);
+  EXPECT_EQ(lsn(2, 2), out[3].header.lsn);
+}
+
+} // namespace
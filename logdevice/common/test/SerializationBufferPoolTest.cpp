@@ -0,0 +1,40 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "logdevice/common/protocol/SerializationBufferPool.h"
+
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+#include "logdevice/common/types_internal.h"
+
+using namespace facebook::logdevice;
+
+TEST(SerializationBufferPoolTest, ReusesReleasedBuffers) {
+  auto buf = SerializationBufferPool::allocate();
+  ASSERT_NE(nullptr, buf);
+  EXPECT_EQ(0, buf->length());
+  EXPECT_GE(buf->tailroom(), IOBUF_ALLOCATION_UNIT);
+  const void* data = buf->data();
+  // Releasing the IOBuf returns the underlying buffer to this thread's pool,
+  // so the next allocation reuses it.
+  buf.reset();
+  auto buf2 = SerializationBufferPool::allocate();
+  EXPECT_EQ(data, buf2->data());
+}
+
+TEST(SerializationBufferPoolTest, LiveBuffersAreIndependent) {
+  auto a = SerializationBufferPool::allocate();
+  auto b = SerializationBufferPool::allocate();
+  EXPECT_NE(a->data(), b->data());
+  memset(a->writableTail(), 0xaa, IOBUF_ALLOCATION_UNIT);
+  a->append(IOBUF_ALLOCATION_UNIT);
+  EXPECT_EQ(IOBUF_ALLOCATION_UNIT, a->length());
+  EXPECT_EQ(0, b->length());
+}
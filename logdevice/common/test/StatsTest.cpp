@@ -116,6 +116,47 @@ TEST(StatsTest, MultipleThreadsTest) {
   EXPECT_EQ(nthreads, total.store_synced);
 }
 
+// Tests that aggregateCached() falls back to a synchronous aggregation when
+// background aggregation is disabled, and that the background thread
+// eventually publishes updated snapshots when it is enabled.
+TEST(StatsTest, BackgroundAggregationTest) {
+  StatsHolder holder(StatsParams().setIsServer(true));
+
+  ++holder.get().store_synced;
+
+  // No background thread: aggregateCached() aggregates synchronously.
+  EXPECT_EQ(1, holder.aggregateCached()->store_synced);
+
+  holder.enableBackgroundAggregation(std::chrono::milliseconds(1));
+
+  ++holder.get().store_synced;
+  auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (holder.aggregateCached()->store_synced < 2) {
+    ASSERT_LT(std::chrono::steady_clock::now(), deadline);
+    /* sleep override */
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  holder.disableBackgroundAggregation();
+  EXPECT_EQ(2, holder.aggregateCached()->store_synced);
+}
+
+// Tests that 1-in-N sampling reweights recorded values so that counts stay
+// unbiased, and that percentile estimates land in the right bucket.
+TEST(StatsTest, SampledHistogramTest) {
+  SampledHistogram<CompactLatencyHistogram, 8> h;
+  for (int i = 0; i < 8000; ++i) {
+    h.add(1000); // 1ms
+  }
+  // The per-thread counter triggers exactly once per 8 adds, each recorded
+  // with weight 8, regardless of the counter's starting phase.
+  EXPECT_EQ(8000, h.getCountAndSum().first);
+  int64_t p = h.estimatePercentile(.5);
+  EXPECT_GE(p, 512);
+  EXPECT_LE(p, 1024);
+}
+
 TEST(StatsTest, LatencyPercentileTest) {
   FastUpdateableSharedPtr<StatsParams> params(std::make_shared<StatsParams>());
   Stats s(&params);
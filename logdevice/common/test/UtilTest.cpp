@@ -87,3 +87,32 @@ TEST(UtilTest, SetIfNotNull) {
     EXPECT_EQ(456, **p_ptr);
   }
 }
+
+TEST(UtilTest, ParseShardCpuAffinity) {
+  folly::Optional<std::unordered_map<int, std::vector<int>>> map;
+
+  // Empty and "any" mean no pinning.
+  EXPECT_EQ(0, parse_shard_cpu_affinity("", &map));
+  EXPECT_FALSE(map.has_value());
+  EXPECT_EQ(0, parse_shard_cpu_affinity("any", &map));
+  EXPECT_FALSE(map.has_value());
+
+  EXPECT_EQ(0, parse_shard_cpu_affinity("0:0-3,8;1:16-17", &map));
+  ASSERT_TRUE(map.has_value());
+  EXPECT_EQ(std::vector<int>({0, 1, 2, 3, 8}), map->at(0));
+  EXPECT_EQ(std::vector<int>({16, 17}), map->at(1));
+
+  EXPECT_EQ(0, parse_shard_cpu_affinity("2:5", &map));
+  ASSERT_TRUE(map.has_value());
+  EXPECT_EQ(std::vector<int>({5}), map->at(2));
+
+  // Malformed inputs.
+  EXPECT_EQ(-1, parse_shard_cpu_affinity("0", &map));
+  EXPECT_EQ(-1, parse_shard_cpu_affinity("0:", &map));
+  EXPECT_EQ(-1, parse_shard_cpu_affinity("x:1", &map));
+  EXPECT_EQ(-1, parse_shard_cpu_affinity("0:1-x", &map));
+  EXPECT_EQ(-1, parse_shard_cpu_affinity("0:3-1", &map));
+  EXPECT_EQ(-1, parse_shard_cpu_affinity("-1:1", &map));
+  // Duplicate shard.
+  EXPECT_EQ(-1, parse_shard_cpu_affinity("0:1;0:2", &map));
+}
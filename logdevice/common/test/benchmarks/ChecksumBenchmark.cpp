@@ -0,0 +1,76 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <vector>
+
+#include <folly/Benchmark.h>
+#include <folly/Random.h>
+#include <folly/Singleton.h>
+#include <gflags/gflags.h>
+
+#include "logdevice/common/Checksum.h"
+
+namespace facebook { namespace logdevice {
+
+// Run with --bm_min_usec=1000000.
+// Pass --bm_json for machine-readable output suitable for comparing runs.
+
+namespace {
+
+std::vector<uint8_t> makePayload(size_t size) {
+  std::vector<uint8_t> buf(size);
+  for (auto& b : buf) {
+    b = folly::Random::rand32() & 0xff;
+  }
+  return buf;
+}
+
+void checksum32Benchmark(unsigned iters, size_t size) {
+  std::vector<uint8_t> buf;
+  BENCHMARK_SUSPEND {
+    buf = makePayload(size);
+  }
+  for (unsigned i = 0; i < iters; ++i) {
+    folly::doNotOptimizeAway(checksum_32bit(Slice(buf.data(), buf.size())));
+  }
+}
+
+void checksum64Benchmark(unsigned iters, size_t size) {
+  std::vector<uint8_t> buf;
+  BENCHMARK_SUSPEND {
+    buf = makePayload(size);
+  }
+  for (unsigned i = 0; i < iters; ++i) {
+    folly::doNotOptimizeAway(checksum_64bit(Slice(buf.data(), buf.size())));
+  }
+}
+
+} // namespace
+
+BENCHMARK_PARAM(checksum32Benchmark, 16)
+BENCHMARK_PARAM(checksum32Benchmark, 512)
+BENCHMARK_PARAM(checksum32Benchmark, 4096)
+BENCHMARK_PARAM(checksum32Benchmark, 1048576)
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_PARAM(checksum64Benchmark, 16)
+BENCHMARK_PARAM(checksum64Benchmark, 512)
+BENCHMARK_PARAM(checksum64Benchmark, 4096)
+BENCHMARK_PARAM(checksum64Benchmark, 1048576)
+
+}} // namespace facebook::logdevice
+
+#ifndef BENCHMARK_BUNDLE
+int main(int argc, char** argv) {
+  folly::SingletonVault::singleton()->registrationComplete();
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+
+  return 0;
+}
+#endif
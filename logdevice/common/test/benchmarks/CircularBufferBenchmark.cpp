@@ -0,0 +1,63 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <folly/Benchmark.h>
+#include <folly/Singleton.h>
+#include <gflags/gflags.h>
+
+#include "logdevice/common/CircularBuffer.h"
+
+namespace facebook { namespace logdevice {
+
+// Run with --bm_min_usec=1000000.
+// Pass --bm_json for machine-readable output suitable for comparing runs.
+
+DEFINE_int32(buffer_size, 16384, "Number of entries in the circular buffer.");
+
+BENCHMARK(CircularBufferScan, n) {
+  folly::BenchmarkSuspender suspender;
+  CircularBuffer<size_t> buf(FLAGS_buffer_size);
+  for (size_t i = 0; i < buf.size(); ++i) {
+    buf[i] = i;
+  }
+  suspender.dismiss();
+
+  size_t sum = 0;
+  for (unsigned i = 0; i < n; ++i) {
+    sum += buf[i % buf.size()];
+  }
+  folly::doNotOptimizeAway(sum);
+}
+
+BENCHMARK(CircularBufferRotate, n) {
+  folly::BenchmarkSuspender suspender;
+  CircularBuffer<size_t> buf(FLAGS_buffer_size);
+  for (size_t i = 0; i < buf.size(); ++i) {
+    buf[i] = i;
+  }
+  suspender.dismiss();
+
+  size_t sum = 0;
+  for (unsigned i = 0; i < n; ++i) {
+    // Reading the new front makes sure the rotation isn't optimized out.
+    buf.rotate();
+    sum += buf[0];
+  }
+  folly::doNotOptimizeAway(sum);
+}
+
+}} // namespace facebook::logdevice
+
+#ifndef BENCHMARK_BUNDLE
+int main(int argc, char** argv) {
+  folly::SingletonVault::singleton()->registrationComplete();
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+
+  return 0;
+}
+#endif
@@ -0,0 +1,128 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <memory>
+#include <vector>
+
+#include <folly/Benchmark.h>
+#include <folly/Singleton.h>
+#include <gflags/gflags.h>
+
+#include "logdevice/common/NodeSetState.h"
+#include "logdevice/common/WeightedCopySetSelector.h"
+#include "logdevice/common/configuration/logs/DefaultLogAttributes.h"
+#include "logdevice/common/test/CopySetSelectorTestUtil.h"
+#include "logdevice/common/test/NodeSetTestUtil.h"
+
+namespace facebook { namespace logdevice {
+
+// Run with --bm_min_usec=1000000.
+// Pass --bm_json for machine-readable output suitable for comparing runs.
+
+namespace {
+
+const logid_t LOG_ID(42);
+const shard_size_t NUM_SHARDS = 1;
+
+// Everything a WeightedCopySetSelector needs to stay alive while we keep
+// calling select() on it. Mirrors the setup in WeightedCopySetSelectorTest.
+struct SelectorFixture {
+  std::shared_ptr<const NodesConfiguration> nodes_in_config{
+      std::make_shared<const NodesConfiguration>()};
+  StorageSet nodeset;
+  ReplicationProperty replication;
+  std::shared_ptr<NodeSetState> nodeset_state;
+  EpochMetaData epoch_metadata;
+  logsconfig::DefaultLogAttributes log_attrs;
+  TestCopySetSelectorDeps deps;
+  XorShift128PRNG rng;
+  std::unique_ptr<WeightedCopySetSelector> selector;
+
+  // Adds `num_nodes` nodes of the given weight to config and nodeset.
+  void addNodes(std::string location, size_t num_nodes, double weight) {
+    for (size_t i = 0; i < num_nodes; ++i) {
+      nodeset.push_back(
+          ShardID((node_index_t)nodes_in_config->clusterSize(), 0));
+      NodeSetTestUtil::addNodes(
+          nodes_in_config, 1, NUM_SHARDS, location, weight, weight);
+    }
+  }
+
+  void init(ReplicationProperty rep) {
+    replication = std::move(rep);
+    rng.seed(5982775905867530240ull, 9936607027721666560ull);
+    nodeset_state = std::make_shared<NodeSetState>(
+        nodeset, LOG_ID, NodeSetState::HealthCheck::DISABLED);
+    epoch_metadata = EpochMetaData(nodeset, replication);
+    selector =
+        std::make_unique<WeightedCopySetSelector>(LOG_ID,
+                                                  epoch_metadata,
+                                                  nodeset_state,
+                                                  nodes_in_config,
+                                                  NodeID(0, 1),
+                                                  &log_attrs,
+                                                  /* locality_enabled */ false,
+                                                  /* stats */ nullptr,
+                                                  rng,
+                                                  /* print_bias_warnings */
+                                                  false,
+                                                  &deps);
+  }
+};
+
+void selectBenchmark(unsigned iters, SelectorFixture& fixture) {
+  std::vector<StoreChainLink> copyset(
+      fixture.replication.getReplicationFactor());
+  copyset_size_t copyset_size;
+  for (unsigned i = 0; i < iters; ++i) {
+    auto result = fixture.selector->select(
+        copyset.data(), &copyset_size, nullptr, nullptr, fixture.rng);
+    ld_check(result == CopySetSelector::Result::SUCCESS);
+    folly::doNotOptimizeAway(copyset.data());
+  }
+}
+
+} // namespace
+
+// Single rack, uniform weights, replication {node: 3}.
+BENCHMARK(WeightedCopySetSelectorFlat, n) {
+  folly::BenchmarkSuspender suspender;
+  SelectorFixture fixture;
+  fixture.addNodes("rg.dc.cl.ro.rk", 20, 1.0);
+  fixture.init(ReplicationProperty({{NodeLocationScope::NODE, 3}}));
+  suspender.dismiss();
+
+  selectBenchmark(n, fixture);
+}
+
+// Four racks with mixed weights, replication {rack: 2, node: 3}. Exercises
+// the hierarchical part of the selector.
+BENCHMARK(WeightedCopySetSelectorCrossRack, n) {
+  folly::BenchmarkSuspender suspender;
+  SelectorFixture fixture;
+  fixture.addNodes("rg.dc.cl.ro.rk0", 5, 2.0);
+  fixture.addNodes("rg.dc.cl.ro.rk1", 5, 1.0);
+  fixture.addNodes("rg.dc.cl.ro.rk2", 5, 1.0);
+  fixture.addNodes("rg.dc.cl.ro.rk3", 5, 1.0);
+  fixture.init(ReplicationProperty(
+      {{NodeLocationScope::RACK, 2}, {NodeLocationScope::NODE, 3}}));
+  suspender.dismiss();
+
+  selectBenchmark(n, fixture);
+}
+
+}} // namespace facebook::logdevice
+
+#ifndef BENCHMARK_BUNDLE
+int main(int argc, char** argv) {
+  folly::SingletonVault::singleton()->registrationComplete();
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+
+  return 0;
+}
+#endif
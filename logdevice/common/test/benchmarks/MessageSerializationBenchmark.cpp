@@ -0,0 +1,150 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <string>
+#include <vector>
+
+#include <folly/Benchmark.h>
+#include <folly/Singleton.h>
+#include <gflags/gflags.h>
+
+#include "logdevice/common/protocol/Compatibility.h"
+#include "logdevice/common/protocol/MessageDeserializers.h"
+#include "logdevice/common/protocol/ProtocolReader.h"
+#include "logdevice/common/protocol/ProtocolWriter.h"
+#include "logdevice/common/protocol/RECORD_Message.h"
+#include "logdevice/common/protocol/STORE_Message.h"
+
+namespace facebook { namespace logdevice {
+
+// Run with --bm_min_usec=1000000.
+// Pass --bm_json for machine-readable output suitable for comparing runs.
+
+namespace {
+
+STORE_Message makeStoreMessage(size_t payload_size) {
+  STORE_Header header{
+      RecordID(0xc5e58b03be6504ce, logid_t(0x0fbc3a81c75251e2)),
+      0xeb4925bfde9dec8e, // timestamp
+      esn_t(0xebecb8bb),  // last known good
+      1,                  // wave
+      0,                  // flags
+      1,                  // nsync
+      0,                  // copyset offset
+      3,                  // copyset size
+      0xb9b421a5,         // timeout_ms
+      NodeID(0x508b, 0xa554),
+  };
+  std::vector<StoreChainLink> copyset{{ShardID(1, 0), ClientID(4)},
+                                      {ShardID(2, 0), ClientID(5)},
+                                      {ShardID(3, 0), ClientID(6)}};
+  return STORE_Message(header,
+                       copyset.data(),
+                       header.copyset_offset,
+                       0,
+                       STORE_Extra(),
+                       std::map<KeyType, std::string>(),
+                       PayloadHolder::copyString(
+                           std::string(payload_size, 'x')),
+                       false);
+}
+
+RECORD_Message makeRecordMessage(size_t payload_size) {
+  RECORD_Header header{logid_t(0x0fbc3a81c75251e2),
+                       read_stream_id_t(0xdeadbeef),
+                       compose_lsn(epoch_t(1), esn_t(42)),
+                       0xeb4925bfde9dec8e, // timestamp
+                       0,                  // flags
+                       0 /* shard */};
+  return RECORD_Message(header,
+                        TrafficClass::READ_TAIL,
+                        PayloadHolder::copyString(
+                            std::string(payload_size, 'x')),
+                        nullptr);
+}
+
+template <typename SomeMessage>
+void serializeBenchmark(unsigned iters, const SomeMessage& msg) {
+  const uint16_t proto = Compatibility::MAX_PROTOCOL_SUPPORTED;
+  for (unsigned i = 0; i < iters; ++i) {
+    auto iobuf = folly::IOBuf::create(IOBUF_ALLOCATION_UNIT);
+    ProtocolWriter writer(msg.type_, iobuf.get(), proto);
+    msg.serialize(writer);
+    folly::doNotOptimizeAway(writer.result());
+  }
+}
+
+template <typename SomeMessage>
+void deserializeBenchmark(unsigned iters, const SomeMessage& msg) {
+  const uint16_t proto = Compatibility::MAX_PROTOCOL_SUPPORTED;
+  std::unique_ptr<folly::IOBuf> serialized;
+  BENCHMARK_SUSPEND {
+    serialized = folly::IOBuf::create(IOBUF_ALLOCATION_UNIT);
+    ProtocolWriter writer(msg.type_, serialized.get(), proto);
+    msg.serialize(writer);
+    ld_check(writer.result() > 0);
+  }
+  for (unsigned i = 0; i < iters; ++i) {
+    ProtocolReader reader(msg.type_, serialized->clone(), proto);
+    auto result = messageDeserializers[msg.type_](reader);
+    folly::doNotOptimizeAway(result.msg.get());
+  }
+}
+
+void storeSerialize(unsigned iters, size_t payload_size) {
+  folly::BenchmarkSuspender suspender;
+  STORE_Message msg = makeStoreMessage(payload_size);
+  suspender.dismiss();
+  serializeBenchmark(iters, msg);
+}
+
+void storeDeserialize(unsigned iters, size_t payload_size) {
+  folly::BenchmarkSuspender suspender;
+  STORE_Message msg = makeStoreMessage(payload_size);
+  suspender.dismiss();
+  deserializeBenchmark(iters, msg);
+}
+
+void recordSerialize(unsigned iters, size_t payload_size) {
+  folly::BenchmarkSuspender suspender;
+  RECORD_Message msg = makeRecordMessage(payload_size);
+  suspender.dismiss();
+  serializeBenchmark(iters, msg);
+}
+
+void recordDeserialize(unsigned iters, size_t payload_size) {
+  folly::BenchmarkSuspender suspender;
+  RECORD_Message msg = makeRecordMessage(payload_size);
+  suspender.dismiss();
+  deserializeBenchmark(iters, msg);
+}
+
+} // namespace
+
+BENCHMARK_PARAM(storeSerialize, 16)
+BENCHMARK_PARAM(storeSerialize, 4096)
+BENCHMARK_PARAM(storeDeserialize, 16)
+BENCHMARK_PARAM(storeDeserialize, 4096)
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_PARAM(recordSerialize, 16)
+BENCHMARK_PARAM(recordSerialize, 4096)
+BENCHMARK_PARAM(recordDeserialize, 16)
+BENCHMARK_PARAM(recordDeserialize, 4096)
+
+}} // namespace facebook::logdevice
+
+#ifndef BENCHMARK_BUNDLE
+int main(int argc, char** argv) {
+  folly::SingletonVault::singleton()->registrationComplete();
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+
+  return 0;
+}
+#endif
@@ -0,0 +1,90 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <array>
+#include <vector>
+
+#include <folly/Benchmark.h>
+#include <folly/Singleton.h>
+#include <gflags/gflags.h>
+
+#include "logdevice/common/SlidingWindow.h"
+
+namespace facebook { namespace logdevice {
+
+// Run with --bm_min_usec=1000000.
+// Pass --bm_json for machine-readable output suitable for comparing runs.
+
+namespace {
+
+class Item {
+ public:
+  uint32_t payload;
+} __attribute__((__aligned__(4)));
+
+struct Deleter {
+  void operator()(Item* item) {
+    folly::doNotOptimizeAway(item);
+  }
+};
+
+} // namespace
+
+// grow() immediately followed by retire() of the same slot. This is the
+// fast path where the retired entry is at the left edge of the window and
+// gets reaped right away.
+BENCHMARK(SlidingWindowGrowRetireInOrder, n) {
+  folly::BenchmarkSuspender suspender;
+  SlidingWindow<Item, Deleter> window(16384);
+  Deleter deleter;
+  Item item;
+  suspender.dismiss();
+
+  for (unsigned i = 0; i < n; ++i) {
+    lsn_t lsn = window.grow(&item);
+    ld_check(lsn != LSN_INVALID);
+    window.retire(lsn, deleter);
+  }
+}
+
+// Fill a batch of slots, then retire them right-to-left. All entries stay
+// buffered until the left edge retires, at which point the whole batch is
+// reaped in one sweep. This is the path taken when appends complete out of
+// order.
+BENCHMARK(SlidingWindowGrowRetireOutOfOrder, n) {
+  constexpr size_t kBatch = 128;
+
+  folly::BenchmarkSuspender suspender;
+  SlidingWindow<Item, Deleter> window(kBatch);
+  Deleter deleter;
+  std::array<Item, kBatch> items;
+  std::array<lsn_t, kBatch> lsns;
+  suspender.dismiss();
+
+  for (unsigned i = 0; i < n; i += kBatch) {
+    size_t m = std::min<size_t>(kBatch, n - i);
+    for (size_t j = 0; j < m; ++j) {
+      lsns[j] = window.grow(&items[j]);
+      ld_check(lsns[j] != LSN_INVALID);
+    }
+    for (size_t j = m; j-- > 0;) {
+      window.retire(lsns[j], deleter);
+    }
+  }
+}
+
+}} // namespace facebook::logdevice
+
+#ifndef BENCHMARK_BUNDLE
+int main(int argc, char** argv) {
+  folly::SingletonVault::singleton()->registrationComplete();
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+
+  return 0;
+}
+#endif
@@ -14,6 +14,7 @@
 #include <errno.h>
 #include <limits.h>
 #include <pwd.h>
+#include <sched.h>
 #include <signal.h>
 
 #include <folly/Format.h>
@@ -198,6 +199,65 @@ int parse_ioprio(const std::string& val,
   return 0;
 }
 
+int parse_shard_cpu_affinity(
+    const std::string& val,
+    folly::Optional<std::unordered_map<int, std::vector<int>>>* out_map) {
+  ld_check(out_map);
+  if (val == "" || val == "any") {
+    out_map->reset();
+    return 0;
+  }
+
+  std::unordered_map<int, std::vector<int>> res;
+
+  std::vector<std::string> entries;
+  folly::split(';', val, entries, true /* ignoreEmpty */);
+  if (entries.empty()) {
+    return -1;
+  }
+  for (const auto& entry : entries) {
+    std::string shard_str, cpus_str;
+    if (!folly::split(':', entry, shard_str, cpus_str)) {
+      return -1;
+    }
+    int shard;
+    try {
+      shard = folly::to<int>(shard_str);
+    } catch (std::range_error&) {
+      return -1;
+    }
+    if (shard < 0 || res.count(shard)) {
+      return -1;
+    }
+    std::vector<int>& cpus = res[shard];
+    std::vector<std::string> tokens;
+    folly::split(',', cpus_str, tokens, true /* ignoreEmpty */);
+    if (tokens.empty()) {
+      return -1;
+    }
+    for (const auto& token : tokens) {
+      int lo, hi;
+      try {
+        if (folly::split('-', token, lo, hi)) {
+          // fall through
+        } else {
+          lo = hi = folly::to<int>(token);
+        }
+      } catch (std::range_error&) {
+        return -1;
+      }
+      if (lo < 0 || hi < lo) {
+        return -1;
+      }
+      for (int cpu = lo; cpu <= hi; ++cpu) {
+        cpus.push_back(cpu);
+      }
+    }
+  }
+  *out_map = std::move(res);
+  return 0;
+}
+
 int parse_compaction_schedule(
     const std::string& val,
     folly::Optional<std::vector<std::chrono::seconds>>& out) {
@@ -528,6 +588,23 @@ int set_io_priority_of_this_thread(std::pair<int, int> prio) {
   return rv;
 }
 
+int set_cpu_affinity_of_this_thread(const std::vector<int>& cpus) {
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (int cpu : cpus) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+      ld_error("invalid CPU %d in affinity set", cpu);
+      return -1;
+    }
+    CPU_SET(cpu, &cpu_set);
+  }
+  int rv = sched_setaffinity(0 /* current thread */, sizeof(cpu_set), &cpu_set);
+  if (rv != 0) {
+    ld_error("sched_setaffinity() failed: %s", strerror(errno));
+  }
+  return rv;
+}
+
 int get_io_priority_of_this_thread(std::pair<int, int>* out_prio) {
   int rv = syscall(SYS_ioprio_get,
                    1, // IOPRIO_WHO_PROCESS
@@ -20,6 +20,7 @@
 #include <string>
 #include <thread>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -189,6 +190,18 @@ int parse_rate_limit(const char* s, rate_limit_t* r);
 int parse_ioprio(const std::string& val,
                  folly::Optional<std::pair<int, int>>* out_prio);
 
+/**
+ * Parse a per-shard CPU affinity map of the form
+ * "<shard>:<cpu-list>[;<shard>:<cpu-list>;...]" where <cpu-list> is a
+ * comma-separated list of CPUs and inclusive CPU ranges,
+ * e.g. "0:0-3,8;1:16-31". Empty string or "any" parses to folly::none.
+ *
+ * @return 0 on success, -1 if the string is not in a correct format
+ */
+int parse_shard_cpu_affinity(
+    const std::string& val,
+    folly::Optional<std::unordered_map<int, std::vector<int>>>* out_map);
+
 /**
  * Parse a compaction schedule, which isa list of durations, e.g. "3d,7d".
  *
@@ -531,6 +544,14 @@ static bool compare_obj_ptrs(Ptr l, Ptr r) {
 int set_io_priority_of_this_thread(std::pair<int, int> prio);
 int get_io_priority_of_this_thread(std::pair<int, int>* out_prio);
 
+/**
+ * Restrict the calling thread to the given set of CPUs with
+ * sched_setaffinity(). Used to keep a shard's storage threads on the NUMA
+ * node that holds the shard's memory.
+ * @return 0 on success, -1 on error
+ */
+int set_cpu_affinity_of_this_thread(const std::vector<int>& cpus);
+
 /* Template to remove duplicates from vector of objects */
 template <typename T>
 void removeDuplicates(std::vector<T>* out_objects) {
@@ -221,6 +221,34 @@ class AsyncReader {
    */
   virtual void forceNoSingleCopyDelivery() = 0;
 
+  /**
+   * If called, data records are delivered to the record callback as soon as
+   * they are received from storage nodes, which may be out of LSN order.
+   *
+   * Without this option a record can only be delivered once all records with
+   * smaller LSNs have been delivered, so a single slow or unavailable storage
+   * node can force the client to buffer a large number of records. With it,
+   * payloads are handed to the application (and their memory released) at
+   * arrival time; the read stream keeps only small per-LSN markers to
+   * guarantee that no record is delivered twice and that gaps are still
+   * reported in LSN order.
+   *
+   * `low_watermark_callback', if non-null, is invoked on the same thread as
+   * the record callback whenever the reader determines that every record and
+   * gap up to and including the given LSN has been delivered. Applications
+   * should use that LSN -- not the LSNs of individual out-of-order records --
+   * when saving their read position.
+   *
+   * This mode is only suitable for applications that can process records
+   * commutatively. Records rejected by the record callback are redelivered
+   * later, in LSN order. Must be used together with
+   * doNotDecodeBufferedWrites().
+   *
+   * Only affects subsequent startReading() calls.
+   */
+  virtual void deliverRecordsOutOfOrder(
+      std::function<void(logid_t, lsn_t)> low_watermark_callback) = 0;
+
   /**
    * If called, data records read by this AsyncReader will start including
    * approximate amount of data written to given log up to current record
@@ -134,11 +134,13 @@ class BufferedWriter {
     Append(logid_t log_id,
            std::string payload,
            AppendCallback::Context context,
-           AppendAttributes attrs = AppendAttributes())
+           AppendAttributes attrs = AppendAttributes(),
+           bool payload_precompressed = false)
         : log_id(log_id),
           payload(std::move(payload)),
           context(context),
-          attrs(std::move(attrs)) {}
+          attrs(std::move(attrs)),
+          payload_precompressed(payload_precompressed) {}
 
     Append(logid_t log_id,
            PayloadGroup&& payload,
@@ -156,6 +158,12 @@ class BufferedWriter {
     PayloadVariant payload;
     AppendCallback::Context context;
     AppendAttributes attrs;
+    // Hint that the payload is already compressed (or otherwise high
+    // entropy).  When such payloads make up most of a batch, BufferedWriter
+    // skips the batch compressor instead of burning CPU recompressing
+    // entropy.  Purely an optimization hint; the batch format and read path
+    // are unaffected.
+    bool payload_precompressed = false;
   };
   struct LogOptions {
     // TODO: Remove it from this struct.
@@ -167,6 +175,14 @@ class BufferedWriter {
     // long (negative for no trigger)
     std::chrono::milliseconds time_trigger{-1};
 
+    // Fraction of `time_trigger' to randomize each flush delay by, in
+    // [0, 1].  When the flush timer is armed, the delay is drawn uniformly
+    // from [time_trigger * (1 - jitter), time_trigger * (1 + jitter)].
+    // Without jitter, logs sharing the same trigger tend to flush in the
+    // same tick, producing bursts of appends; jitter spreads the flushes
+    // across the window.  0 (the default) disables jitter.
+    double time_trigger_jitter = 0;
+
     // Flush buffered writes for a log as soon there are this many payload
     // bytes buffered (negative for no trigger)
     ssize_t size_trigger = -1;
@@ -227,6 +243,13 @@ class BufferedWriter {
     // Compression codec.
     Compression compression = Compression::LZ4;
 
+    // Id of a trained zstd dictionary to compress batches with, previously
+    // registered via registerCompressionDictionary().  Only used when
+    // `compression' is Compression::ZSTD.  The id is recorded in the batch
+    // header, so readers must register the same dictionary before they can
+    // decode the batch.  0 (the default) disables dictionary compression.
+    uint32_t zstd_dictionary_id = 0;
+
     // If set to true, will destroy individual payloads immediately after they
     // are batched together. onSuccess(), onFailure() and onRetry() callbacks
     // will not contain payloads.
@@ -272,6 +295,21 @@ class BufferedWriter {
                                                 AppendCallback* callback,
                                                 Options options = Options());
 
+  /**
+   * Registers a trained zstd compression dictionary under the given id,
+   * process-wide.  Batches written with LogOptions::zstd_dictionary_id set
+   * record the id in their header; any process decoding such batches (see
+   * BufferedWriteDecoder) must register the same (id, data) pair first.
+   * Training dictionaries and distributing them to writers and readers is
+   * up to the application.  Id 0 is reserved to mean "no dictionary".
+   *
+   * @return 0 on success (re-registering an identical dictionary is a
+   *         no-op), or -1 with err set to E::INVALID_PARAM if id is 0, or
+   *         E::EXISTS if a different dictionary is already registered under
+   *         this id.
+   */
+  static int registerCompressionDictionary(uint32_t id, std::string data);
+
   /**
    * Same as Client::append() except the append may get buffered. If the call
    * succeeds it is added into a buffer, and finally appended to the log as a
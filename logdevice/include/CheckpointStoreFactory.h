@@ -44,11 +44,19 @@ class CheckpointStoreFactory {
    *   checkpoints.
    * @param log_id: the id of the log, where the checkpoints will be stored.
    * @param stop_timeout: timeout for the RSM to stop after calling shutdown.
+   * @param coalesce_interval: if positive, asynchronous checkpoint updates
+   *   are buffered and written as one record per customer id every
+   *   coalesce_interval instead of one record per update. This bounds the
+   *   write rate on the checkpoint log when many readers checkpoint
+   *   frequently. The callback of every buffered update is invoked with the
+   *   status of the coalesced write. Zero keeps one write per update.
    */
-  std::unique_ptr<CheckpointStore>
-  createRSMBasedCheckpointStore(std::shared_ptr<Client>& client,
-                                logid_t log_id,
-                                std::chrono::milliseconds stop_timeout);
+  std::unique_ptr<CheckpointStore> createRSMBasedCheckpointStore(
+      std::shared_ptr<Client>& client,
+      logid_t log_id,
+      std::chrono::milliseconds stop_timeout,
+      std::chrono::milliseconds coalesce_interval =
+          std::chrono::milliseconds::zero());
 };
 
 }} // namespace facebook::logdevice
@@ -13,6 +13,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "logdevice/include/AsyncReader.h"
 #include "logdevice/include/ClientFactory.h"
@@ -75,6 +76,17 @@ typedef std::function<void(Status st, const DataRecord& r)> append_callback_t;
  */
 typedef std::function<void(Status, lsn_t result)> find_time_callback_t;
 
+/**
+ * Type of callback that is called when a non-blocking findTimeBatch() request
+ * completes. Each entry of `results` corresponds to the log at the same index
+ * in the vector passed to findTimeBatch(); Status and LSN have the same
+ * meaning as in find_time_callback_t.
+ *
+ * See findTimeBatch() for docs.
+ */
+typedef std::function<void(std::vector<std::pair<Status, lsn_t>> results)>
+    find_time_batch_callback_t;
+
 /**
  * Type of callback that is called when a non-blocking findKey() request
  * completes.
@@ -661,6 +673,32 @@ class Client {
            find_time_callback_t cb,
            FindKeyAccuracy accuracy = FindKeyAccuracy::STRICT) noexcept = 0;
 
+  /**
+   * Runs findTime() for several logs at the same timestamp, e.g. to restore
+   * a checkpoint spanning many logs. The per-log lookups are issued
+   * concurrently and the callback is called exactly once, after the last of
+   * them completes; equivalent to, but much faster than, waiting for
+   * findTime() on one log at a time. Failures of individual lookups
+   * (including E::NOBUFS if too many requests are in flight) are reported
+   * through the per-log Status in the callback.
+   *
+   * @param logids      IDs of logs to query; must not be empty.
+   * @param timestamp   same as in findTime().
+   * @param cb          called with one result per log, in the order of
+   *                    `logids`. Note: if every lookup fails to be submitted,
+   *                    the callback is called before this method returns.
+   * @param accuracy    same as in findTime().
+   *
+   * @return 0 if the batch was accepted; the callback is then guaranteed to
+   * be called. Returns -1 with err set to E::INVALID_PARAM if `logids` is
+   * empty or `cb` is not callable; the callback is not called in that case.
+   */
+  virtual int
+  findTimeBatch(const std::vector<logid_t>& logids,
+                std::chrono::milliseconds timestamp,
+                find_time_batch_callback_t cb,
+                FindKeyAccuracy accuracy = FindKeyAccuracy::STRICT) noexcept = 0;
+
   /**
    * A non-blocking version of findKeySync().
    *
@@ -26,6 +26,7 @@
 #include "logdevice/common/configuration/UpdateableConfig.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/common/protocol/RECORD_Message.h"
+#include "logdevice/common/request_util.h"
 #include "logdevice/common/settings/Settings.h"
 #include "logdevice/include/Err.h"
 
@@ -37,9 +38,18 @@ AsyncReaderImpl::AsyncReaderImpl(std::shared_ptr<ClientImpl> client,
       processor_(&client_->getProcessor()),
       read_buffer_size_(buffer_size < 0
                             ? processor_->settings()->client_read_buffer_size
-                            : static_cast<size_t>(buffer_size)) {}
+                            : static_cast<size_t>(buffer_size)) {
+  async_decode_state_->owner = this;
+}
 
 AsyncReaderImpl::~AsyncReaderImpl() {
+  // Cut off background decode completions first; any still in flight will
+  // find a null owner and drop their results.
+  {
+    std::lock_guard<std::mutex> lock(async_decode_state_->mutex);
+    async_decode_state_->owner = nullptr;
+  }
+
   // The destructor should ensure that all reading is stopped.
   folly::SharedMutex::WriteHolder guard(log_state_mutex_);
 
@@ -122,6 +132,12 @@ void AsyncReaderImpl::forceNoSingleCopyDelivery() {
   force_no_scd_ = true;
 }
 
+void AsyncReaderImpl::deliverRecordsOutOfOrder(
+    std::function<void(logid_t, lsn_t)> low_watermark_callback) {
+  deliver_out_of_order_ = true;
+  low_watermark_callback_ = std::move(low_watermark_callback);
+}
+
 void AsyncReaderImpl::doNotDecodeBufferedWrites() {
   decode_buffered_writes_ = false;
 }
@@ -349,6 +365,13 @@ int AsyncReaderImpl::startReading(logid_t log_id,
     read_stream->forceNoSingleCopyDelivery();
   }
 
+  if (deliver_out_of_order_) {
+    // Out-of-order delivery cannot redeliver a partially consumed
+    // BufferedWriter batch in order, so transparent decoding must be off.
+    ld_check(!decode_buffered_writes_);
+    read_stream->deliverRecordsOutOfOrder(low_watermark_callback_);
+  }
+
   if (do_not_skip_partially_trimmed_sections_) {
     read_stream->doNotSkipPartiallyTrimmedSections();
   }
@@ -461,6 +484,16 @@ bool AsyncReaderImpl::handleBufferedWrite(std::unique_ptr<DataRecord>& record) {
   const logid_t log_id = record_with_attributes->logid;
   const DataRecordAttributes attrs = record_with_attributes->attrs;
   const RECORD_flags_t flags = record_with_attributes->flags_;
+
+  const size_t bg_threshold =
+      processor_->settings()->reader_bg_decode_bytes_threshold;
+  if (bg_threshold > 0 && record->payload.size() >= bg_threshold &&
+      tryAsyncDecode(log_id, attrs, flags, record->payload) == 0) {
+    // A background decode is in flight.  Leave the batch with
+    // ClientReadStream; the decode completion pokes it to redeliver and
+    // drainBufferedRecords() then delivers the decoded records.
+    return false;
+  }
   record_with_attributes = nullptr; // no longer safe
 
   auto decoder = std::make_shared<BufferedWriteDecoderImpl>();
@@ -538,6 +571,146 @@ bool AsyncReaderImpl::handleBufferedWrite(std::unique_ptr<DataRecord>& record) {
   return !buffer_rest;
 }
 
+int AsyncReaderImpl::tryAsyncDecode(logid_t log_id,
+                                    const DataRecordAttributes& attrs,
+                                    RECORD_flags_t flags,
+                                    const Payload& payload) {
+  folly::SharedMutex::ReadHolder guard(log_state_mutex_);
+  auto it = log_states_.find(log_id);
+  if (it == log_states_.end() ||
+      it->second.handle.worker_id != Worker::onThisThread()->idx_) {
+    // Must have stopped reading the log but word hasn't reached
+    // ClientReadStream yet.  Let the synchronous path deal with it.
+    return -1;
+  }
+  LogState& state = it->second;
+
+  if (state.async_decode_lsn == attrs.lsn) {
+    if (state.async_decode_failed) {
+      // The background decode came back with nothing deliverable (corrupt
+      // batch, or a batch with no records).  Redo the decode inline, which
+      // either consumes the batch or takes the DATALOSS route.
+      state.async_decode_lsn = LSN_INVALID;
+      state.async_decode_failed = false;
+      return -1;
+    }
+    // Still in flight; ClientReadStream will redeliver when poked.
+    return 0;
+  }
+  ld_check(state.async_decode_lsn == LSN_INVALID);
+
+  const ReadingHandle handle = state.handle;
+  // The background job gets its own copy of the blob: ClientReadStream may
+  // destroy the original (e.g. on stopReading()) while the decode runs.
+  std::string blob(static_cast<const char*>(payload.data()), payload.size());
+  // Keeps the Client, and with it the Processor, alive for the duration of
+  // the job.
+  std::shared_ptr<ClientImpl> client = client_;
+  Processor* processor = processor_;
+  std::weak_ptr<AsyncDecodeState> weak(async_decode_state_);
+
+  auto job = [=, blob = std::move(blob)]() mutable {
+    auto decoder = std::make_shared<BufferedWriteDecoderImpl>();
+    std::vector<PayloadGroup> payload_groups;
+    // Non-owning overload with buffer sharing disabled: all decoded payloads
+    // end up in buffers owned by `decoder' or the PayloadGroups, so the blob
+    // copy can die as soon as we're done here.
+    DataRecord blob_record(
+        log_id, Payload(blob.data(), blob.size()), attrs.lsn, attrs.timestamp);
+    int rv = decoder->decodeOne(blob_record, payload_groups);
+
+    std::unique_ptr<Request> req = FuncRequest::make(
+        handle.worker_id,
+        WorkerType::GENERAL,
+        RequestType::ASYNC_READER_DECODED,
+        [=,
+         decoder = std::move(decoder),
+         payload_groups = std::move(payload_groups)]() mutable {
+          std::shared_ptr<AsyncDecodeState> decode_state = weak.lock();
+          if (!decode_state) {
+            return;
+          }
+          std::lock_guard<std::mutex> lock(decode_state->mutex);
+          if (decode_state->owner == nullptr) {
+            // AsyncReaderImpl was destroyed while we were decoding.
+            return;
+          }
+          decode_state->owner->onAsyncDecodeDone(log_id,
+                                                 handle,
+                                                 attrs,
+                                                 flags,
+                                                 rv,
+                                                 std::move(decoder),
+                                                 std::move(payload_groups));
+        });
+    // postImportant() can only fail during Client shutdown, which also tears
+    // down the read stream waiting for these results.
+    processor->postImportant(req);
+  };
+
+  if (!processor_->enqueueToBackgroundIfNotFull(std::move(job))) {
+    // Background queue is full; decoding inline beats stalling the stream.
+    return -1;
+  }
+  state.async_decode_lsn = attrs.lsn;
+  return 0;
+}
+
+void AsyncReaderImpl::onAsyncDecodeDone(
+    logid_t log_id,
+    ReadingHandle handle,
+    const DataRecordAttributes& attrs,
+    RECORD_flags_t flags,
+    int rv,
+    std::shared_ptr<BufferedWriteDecoderImpl> decoder,
+    std::vector<PayloadGroup> payload_groups) {
+  {
+    folly::SharedMutex::ReadHolder guard(log_state_mutex_);
+    auto it = log_states_.find(log_id);
+    if (it == log_states_.end() ||
+        it->second.handle.worker_id != handle.worker_id ||
+        it->second.handle.read_stream_id != handle.read_stream_id) {
+      // Stopped (and possibly restarted) reading the log while the decode
+      // was in flight; drop the results.
+      return;
+    }
+    LogState& state = it->second;
+    if (state.async_decode_lsn != attrs.lsn) {
+      // Stale completion; a newer decode owns the stream now.
+      return;
+    }
+
+    if (rv != 0 || payload_groups.empty()) {
+      // Nothing to queue for delivery.  Have the batch re-decoded inline on
+      // redelivery: an empty batch is consumed for free and a corrupt one
+      // takes the DATALOSS route of handleBufferedWrite().
+      state.async_decode_failed = true;
+    } else {
+      state.async_decode_lsn = LSN_INVALID;
+      int batch_offset = 0;
+      for (PayloadGroup& payload_group : payload_groups) {
+        state.pre_queue.push_back(std::make_unique<DataRecordOwnsPayload>(
+            log_id,
+            std::move(payload_group),
+            decoder, // shared ownership of the decoder
+            attrs.lsn,
+            attrs.timestamp,
+            flags & ~RECORD_Header::BUFFERED_WRITER_BLOB,
+            // Report the same offsets for all subrecords, as the synchronous
+            // decode path does.
+            attrs.offsets,
+            nullptr, // no rebuilding metadata
+            batch_offset++));
+      }
+      buffered_delivery_failed_.store(true);
+    }
+  }
+  // Poke the read stream to redeliver the batch now.  We're on the Worker
+  // that owns it, so the request can execute inline.
+  ResumeReadingRequest req(handle);
+  req.execute();
+}
+
 int AsyncReaderImpl::drainBufferedRecords(logid_t log_id,
                                           const DataRecord& batch) {
   // This is a bit inefficient; we keep reacquiring the lock and repeating
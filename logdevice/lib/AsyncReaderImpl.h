@@ -16,12 +16,14 @@
 
 #include "logdevice/common/ReadStreamAttributes.h"
 #include "logdevice/common/client_read_stream/ClientReadStreamBufferFactory.h"
+#include "logdevice/common/protocol/RECORD_Message.h"
 #include "logdevice/common/types_internal.h"
 #include "logdevice/include/AsyncReader.h"
 #include "logdevice/lib/ClientImpl.h"
 
 namespace facebook { namespace logdevice {
 
+class BufferedWriteDecoderImpl;
 class Semaphore;
 class Processor;
 
@@ -44,6 +46,8 @@ class AsyncReaderImpl : public AsyncReader {
   void withoutPayload() override;
   void payloadHashOnly();
   void forceNoSingleCopyDelivery() override;
+  void deliverRecordsOutOfOrder(
+      std::function<void(logid_t, lsn_t)> low_watermark_callback) override;
   int isConnectionHealthy(logid_t) const override;
   void doNotDecodeBufferedWrites() override;
   void includeByteOffset() override;
@@ -76,6 +80,31 @@ class AsyncReaderImpl : public AsyncReader {
   // Handles a record that is a buffered write and needs automatic decoding
   bool handleBufferedWrite(std::unique_ptr<DataRecord>& record);
 
+  // Tries to offload decoding of a batch to the Processor's background
+  // threads (enabled by the reader-bg-decode-bytes-threshold setting).
+  // Called on the Worker delivering the batch.
+  //
+  // Returns 0 if a background decode was started or is already in flight; in
+  // that case the batch is left with ClientReadStream for redelivery, which
+  // the decode completion triggers.  Returns -1 if the batch should be
+  // decoded inline by handleBufferedWrite() instead.
+  int tryAsyncDecode(logid_t log_id,
+                     const DataRecordAttributes& attrs,
+                     RECORD_flags_t flags,
+                     const Payload& payload);
+
+  // Runs on the Worker that owns the read stream once a background decode
+  // finishes.  Queues the decoded records for delivery (or arranges for an
+  // inline re-decode on failure) and pokes the read stream to redeliver the
+  // batch.
+  void onAsyncDecodeDone(logid_t log_id,
+                         ReadingHandle handle,
+                         const DataRecordAttributes& attrs,
+                         RECORD_flags_t flags,
+                         int rv,
+                         std::shared_ptr<BufferedWriteDecoderImpl> decoder,
+                         std::vector<PayloadGroup> payload_groups);
+
   // Drains any BufferedWriter-originated records that were decoded by
   // handleBufferedWrite() but not successfully delivered to the application.
   // If there are such records, `batch' is expected to be the full batch
@@ -107,6 +136,12 @@ class AsyncReaderImpl : public AsyncReader {
   // Indicates forceNoSingleCopyDelivery() was called
   bool force_no_scd_ = false;
 
+  // Indicates deliverRecordsOutOfOrder() was called
+  bool deliver_out_of_order_ = false;
+
+  // Low watermark callback passed to deliverRecordsOutOfOrder(); may be null
+  std::function<void(logid_t, lsn_t)> low_watermark_callback_;
+
   // Indicates whether records that come with the BUFFERED_WRITER_BLOB flag set
   // should be transparently decoded
   bool decode_buffered_writes_ = true;
@@ -137,6 +172,13 @@ class AsyncReaderImpl : public AsyncReader {
     // Records that were decoded from a buffered write but could not be
     // immediately delivered (application callback rejected them).
     std::deque<std::unique_ptr<DataRecord>> pre_queue;
+    // LSN of the batch currently being decoded on a background thread, or
+    // LSN_INVALID.  Only accessed on the Worker that owns the read stream.
+    lsn_t async_decode_lsn{LSN_INVALID};
+    // Set when the background decode for `async_decode_lsn' came back with
+    // nothing to queue for delivery; the batch is then decoded inline on
+    // redelivery instead.
+    bool async_decode_failed{false};
   };
   // Logs currently being read from
   std::unordered_map<logid_t, LogState, logid_t::Hash> log_states_;
@@ -159,6 +201,16 @@ class AsyncReaderImpl : public AsyncReader {
   std::shared_ptr<PendingStops> pending_stops_ =
       std::make_shared<PendingStops>();
 
+  // Lets background decode completions find out whether this AsyncReaderImpl
+  // still exists.  The destructor clears `owner' under the mutex; completions
+  // lock it and bail out if the owner is gone.
+  struct AsyncDecodeState {
+    std::mutex mutex;
+    AsyncReaderImpl* owner{nullptr};
+  };
+  std::shared_ptr<AsyncDecodeState> async_decode_state_ =
+      std::make_shared<AsyncDecodeState>();
+
   // Use to gather info for a pending stats Request.
   // Trigger callback once there are no more leftover requests.
   struct RequestAcc {
@@ -7,6 +7,7 @@
  */
 #include "logdevice/lib/ClientImpl.h"
 
+#include <atomic>
 #include <chrono>
 #include <unordered_map>
 
@@ -24,12 +25,15 @@
 #include "logdevice/common/EpochMetaDataMap.h"
 #include "logdevice/common/FindKeyRequest.h"
 #include "logdevice/common/GetHeadAttributesRequest.h"
+#include "logdevice/common/GetTailRecordsRequest.h"
 #include "logdevice/common/LogsConfigApiRequest.h"
 #include "logdevice/common/NoopTraceLogger.h"
 #include "logdevice/common/PayloadGroupCodec.h"
+#include "logdevice/common/PayloadTransformStage.h"
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/ReaderImpl.h"
 #include "logdevice/common/Semaphore.h"
+#include "logdevice/common/SequencerHintsCache.h"
 #include "logdevice/common/SnapshotStoreTypes.h"
 #include "logdevice/common/StatsCollectionThread.h"
 #include "logdevice/common/SyncSequencerRequest.h"
@@ -118,6 +122,40 @@ ClientImpl::ClientImpl(std::string cluster_name,
   if (metadata_cache_size > 0) {
     epoch_metadata_cache_ =
         std::make_unique<EpochMetaDataCache>(metadata_cache_size);
+    const std::string cache_path = settings->epoch_metadata_cache_path;
+    if (!cache_path.empty()) {
+      auto nodes_configuration = config_->getNodesConfiguration();
+      ld_check(nodes_configuration != nullptr);
+      int restored = epoch_metadata_cache_->restoreFromFile(
+          cache_path, *nodes_configuration);
+      if (restored >= 0) {
+        ld_info("Restored %d epoch metadata cache entries from %s",
+                restored,
+                cache_path.c_str());
+      } else if (err != E::NOTFOUND) {
+        ld_warning("Failed to restore epoch metadata cache from %s: %s",
+                   cache_path.c_str(),
+                   error_description(err));
+      }
+    }
+  }
+
+  const std::string hints_path = settings->sequencer_hints_path;
+  if (!hints_path.empty()) {
+    sequencer_hints_cache_ = std::make_unique<SequencerHintsCache>();
+    auto nodes_configuration = config_->getNodesConfiguration();
+    ld_check(nodes_configuration != nullptr);
+    int restored = sequencer_hints_cache_->restoreFromFile(
+        hints_path, *nodes_configuration, settings->sequencer_hints_max_age);
+    if (restored >= 0) {
+      ld_info("Restored %d sequencer hints from %s",
+              restored,
+              hints_path.c_str());
+    } else if (err != E::NOTFOUND) {
+      ld_warning("Failed to restore sequencer hints from %s: %s",
+                 hints_path.c_str(),
+                 error_description(err));
+    }
   }
 
   if (settings->stats_collection_interval.count() > 0 ||
@@ -155,6 +193,7 @@ ClientImpl::ClientImpl(std::string cluster_name,
                                        plugin_registry_,
                                        credentials_,
                                        csid_);
+  processor_->sequencer_hints_cache_ = sequencer_hints_cache_.get();
 
   if (settings->enable_nodes_configuration_manager) {
     // create and initialize NodesConfigurationManager (NCM) and attach it to
@@ -296,6 +335,29 @@ ClientImpl::~ClientImpl() {
   server_config_hook_handles_.clear();
   processor_->shutdown();
 
+  if (epoch_metadata_cache_) {
+    const std::string cache_path =
+        settings_->getSettings()->epoch_metadata_cache_path;
+    if (!cache_path.empty()) {
+      if (epoch_metadata_cache_->persistToFile(cache_path) != 0) {
+        ld_warning("Failed to persist epoch metadata cache to %s: %s",
+                   cache_path.c_str(),
+                   error_description(err));
+      }
+    }
+  }
+
+  if (sequencer_hints_cache_) {
+    const std::string hints_path =
+        settings_->getSettings()->sequencer_hints_path;
+    ld_check(!hints_path.empty());
+    if (sequencer_hints_cache_->persistToFile(hints_path) != 0) {
+      ld_warning("Failed to persist sequencer hints to %s: %s",
+                 hints_path.c_str(),
+                 error_description(err));
+    }
+  }
+
   auto end_time = std::chrono::steady_clock::now();
   ld_info("Destroyed Client in %.3f seconds. Cluster name: %s",
           std::chrono::duration_cast<std::chrono::duration<double>>(end_time -
@@ -1645,6 +1707,44 @@ int ClientImpl::findTime(logid_t logid,
   return processor_->postRequest(req);
 }
 
+int ClientImpl::findTimeBatch(const std::vector<logid_t>& logids,
+                              std::chrono::milliseconds timestamp,
+                              find_time_batch_callback_t cb,
+                              FindKeyAccuracy accuracy) noexcept {
+  if (logids.empty() || !cb) {
+    err = E::INVALID_PARAM;
+    return -1;
+  }
+
+  // Per-log results are written into disjoint slots from whichever worker
+  // thread completes the lookup; the last one to finish fires the combined
+  // callback.
+  struct BatchState {
+    explicit BatchState(size_t n)
+        : results(n, std::make_pair(E::FAILED, LSN_INVALID)), outstanding(n) {}
+    std::vector<std::pair<Status, lsn_t>> results;
+    std::atomic<size_t> outstanding;
+    find_time_batch_callback_t cb;
+  };
+  auto state = std::make_shared<BatchState>(logids.size());
+  state->cb = std::move(cb);
+
+  for (size_t i = 0; i < logids.size(); ++i) {
+    auto on_result = [state, i](Status st, lsn_t result) {
+      state->results[i] = std::make_pair(st, result);
+      if (state->outstanding.fetch_sub(1) == 1) {
+        state->cb(std::move(state->results));
+      }
+    };
+    if (findTime(logids[i], timestamp, on_result, accuracy) != 0) {
+      // Couldn't submit this lookup (e.g. E::NOBUFS); report it through the
+      // per-log status like any other failure.
+      on_result(err, LSN_INVALID);
+    }
+  }
+  return 0;
+}
+
 FindKeyResult ClientImpl::findKeySync(logid_t logid,
                                       std::string key,
                                       FindKeyAccuracy accuracy) noexcept {
@@ -2061,6 +2161,75 @@ int ClientImpl::getTailRecord(logid_t logid,
   return processor_->postRequest(req);
 }
 
+std::vector<std::unique_ptr<DataRecord>>
+ClientImpl::getTailRecordsSync(logid_t logid,
+                               lsn_t start_lsn,
+                               size_t max_records,
+                               lsn_t* tail_lsn_out) noexcept {
+  std::vector<std::unique_ptr<DataRecord>> records;
+  lsn_t tail_lsn = LSN_INVALID;
+  Status status = E::UNKNOWN;
+  Semaphore sem;
+  auto cb = [&](Status st,
+                lsn_t tail,
+                std::vector<std::unique_ptr<DataRecord>> recs) {
+    records = std::move(recs);
+    tail_lsn = tail;
+    status = st;
+    sem.post();
+  };
+
+  int rv = getTailRecords(logid, start_lsn, max_records, cb);
+  if (rv != 0) {
+    // err set by getTailRecords.
+    return {};
+  }
+
+  sem.wait();
+  if (status != E::OK) {
+    err = status;
+    return {};
+  }
+  if (tail_lsn_out != nullptr) {
+    *tail_lsn_out = tail_lsn;
+  }
+  return records;
+}
+
+int ClientImpl::getTailRecords(logid_t logid,
+                               lsn_t start_lsn,
+                               size_t max_records,
+                               tail_records_callback_t cb) noexcept {
+  auto cb_wrapper =
+      [cb](Status st, lsn_t tail_lsn, std::vector<TailRecord> tails) {
+        std::vector<std::unique_ptr<DataRecord>> records;
+        if (st == E::OK) {
+          records.reserve(tails.size());
+          for (TailRecord& tail : tails) {
+            if (!tail.isValid() || !tail.hasPayload()) {
+              st = E::MALFORMED_RECORD;
+              records.clear();
+              break;
+            }
+            auto data_record = DataRecordFromTailRecord::create(
+                std::make_shared<TailRecord>(std::move(tail)));
+            ld_check(data_record != nullptr);
+            if (data_record->checksumFailed()) {
+              st = E::CHECKSUM_MISMATCH;
+              records.clear();
+              break;
+            }
+            records.push_back(std::move(data_record));
+          }
+        }
+        cb(st, st == E::OK ? tail_lsn : LSN_INVALID, std::move(records));
+      };
+
+  std::unique_ptr<Request> req = std::make_unique<GetTailRecordsRequest>(
+      logid, start_lsn, max_records, timeout_, std::move(cb_wrapper));
+  return processor_->postRequest(req);
+}
+
 std::unique_ptr<DataRecord>
 ClientImpl::readLogTailSync(logid_t logid) noexcept {
   std::unique_ptr<DataRecord> record;
@@ -2257,6 +2426,19 @@ ClientImpl::prepareRequest(logid_t logid,
     return nullptr;
   }
 
+  // Run the pluggable payload transform stage, if one is loaded.  This
+  // happens on the caller's thread, before the request is posted to a
+  // Worker, so CPU-heavy transforms don't stall event loops.
+  auto transform_stage = processor_->payloadTransformStage();
+  if (transform_stage != nullptr) {
+    Status st = transform_stage->transform(
+        logid, folly::Range<PayloadHolder*>(&payload, 1));
+    if (st != E::OK) {
+      err = st;
+      return nullptr;
+    }
+  }
+
   return createRequest(logid,
                        std::move(payload),
                        std::move(cb),
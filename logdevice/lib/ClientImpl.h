@@ -52,6 +52,7 @@ class EpochMetaDataMap;
 class PayloadHolder;
 class PluginRegistry;
 class Processor;
+class SequencerHintsCache;
 struct Settings;
 class Shadow;
 class StatsCollectionThread;
@@ -200,6 +201,11 @@ class ClientImpl : public Client,
                find_time_callback_t cb,
                FindKeyAccuracy accuracy) noexcept override;
 
+  int findTimeBatch(const std::vector<logid_t>& logids,
+                    std::chrono::milliseconds timestamp,
+                    find_time_batch_callback_t cb,
+                    FindKeyAccuracy accuracy) noexcept override;
+
   FindKeyResult findKeySync(logid_t logid,
                             std::string key,
                             FindKeyAccuracy accuracy) noexcept override;
@@ -367,6 +373,12 @@ class ClientImpl : public Client,
   using read_tail_callback_t =
       std::function<void(Status status, std::unique_ptr<DataRecord>)>;
 
+  // see getTailRecords() below
+  using tail_records_callback_t =
+      std::function<void(Status status,
+                         lsn_t tail_lsn,
+                         std::vector<std::unique_ptr<DataRecord>>)>;
+
   std::shared_ptr<const EpochMetaDataMap>
   getHistoricalMetaDataSync(logid_t logid) noexcept;
 
@@ -381,6 +393,26 @@ class ClientImpl : public Client,
 
   int readLogTail(logid_t logid, read_tail_callback_t cb) noexcept;
 
+  /**
+   * Fetch up to `max_records' records with LSNs in [start_lsn, tail] straight
+   * from the node running the log's sequencer, skipping the storage-node
+   * round trip a regular reader would take. Only works against clusters with
+   * --sequencer-recent-records-cache-bytes set; E::STALE means start_lsn
+   * precedes the sequencer's ring of recent records and the caller should
+   * fall back to a regular read. Tailers are expected to poll this with
+   * start_lsn one past the last record they got.
+   */
+  int getTailRecords(logid_t logid,
+                     lsn_t start_lsn,
+                     size_t max_records,
+                     tail_records_callback_t cb) noexcept;
+
+  std::vector<std::unique_ptr<DataRecord>>
+  getTailRecordsSync(logid_t logid,
+                     lsn_t start_lsn,
+                     size_t max_records,
+                     lsn_t* tail_lsn_out = nullptr) noexcept;
+
   ClientSettings& settings() override;
 
   std::string getAllReadStreamsDebugInfo() noexcept override;
@@ -434,6 +466,12 @@ class ClientImpl : public Client,
     return epoch_metadata_cache_.get();
   }
 
+  // return a raw pointer to the persisted sequencer hints cache, or nullptr
+  // if --sequencer-hints-path is not set
+  SequencerHintsCache* getSequencerHintsCache() {
+    return sequencer_hints_cache_.get();
+  }
+
   // verifies that arguments to append() are valid; sets err
   bool checkAppendImpl(logid_t logid,
                        size_t payload_size,
@@ -537,6 +575,10 @@ class ClientImpl : public Client,
   // cache epoch metadata entries read from the metadata log
   std::unique_ptr<EpochMetaDataCache> epoch_metadata_cache_;
 
+  // per-log sequencer routing hints persisted across client restarts;
+  // nullptr unless --sequencer-hints-path is set
+  std::unique_ptr<SequencerHintsCache> sequencer_hints_cache_;
+
   std::shared_ptr<UpdateableConfig> config_;
 
   std::unique_ptr<StatsHolder> stats_;
@@ -35,6 +35,7 @@ ClientMessageDispatch::onReceivedImpl(Message* msg,
     case MessageType::GET_EPOCH_RECOVERY_METADATA:
     case MessageType::GET_EPOCH_RECOVERY_METADATA_REPLY:
     case MessageType::GET_HEAD_ATTRIBUTES:
+    case MessageType::GET_TAIL_RECORDS:
     case MessageType::NODE_STATS:
     case MessageType::NODE_STATS_AGGREGATE:
     case MessageType::NODE_STATS_AGGREGATE_REPLY:
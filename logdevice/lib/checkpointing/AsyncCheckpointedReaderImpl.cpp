@@ -108,6 +108,11 @@ void AsyncCheckpointedReaderImpl::forceNoSingleCopyDelivery() {
   reader_->forceNoSingleCopyDelivery();
 }
 
+void AsyncCheckpointedReaderImpl::deliverRecordsOutOfOrder(
+    std::function<void(logid_t, lsn_t)> low_watermark_callback) {
+  reader_->deliverRecordsOutOfOrder(std::move(low_watermark_callback));
+}
+
 void AsyncCheckpointedReaderImpl::includeByteOffset() {
   reader_->includeByteOffset();
 }
@@ -54,6 +54,9 @@ class AsyncCheckpointedReaderImpl : public AsyncCheckpointedReader {
 
   void forceNoSingleCopyDelivery() override;
 
+  void deliverRecordsOutOfOrder(
+      std::function<void(logid_t, lsn_t)> low_watermark_callback) override;
+
   void includeByteOffset() override;
 
   void doNotSkipPartiallyTrimmedSections() override;
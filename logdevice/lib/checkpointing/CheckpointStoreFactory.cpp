@@ -60,7 +60,8 @@ std::unique_ptr<CheckpointStore>
 CheckpointStoreFactory::createRSMBasedCheckpointStore(
     std::shared_ptr<Client>& client,
     logid_t log_id,
-    std::chrono::milliseconds stop_timeout) {
+    std::chrono::milliseconds stop_timeout,
+    std::chrono::milliseconds coalesce_interval) {
   ClientImpl* client_impl = dynamic_cast<ClientImpl*>(client.get());
   ld_check(client_impl);
   auto versioned_config_store = std::make_unique<RSMBasedVersionedConfigStore>(
@@ -69,7 +70,7 @@ CheckpointStoreFactory::createRSMBasedCheckpointStore(
       &client_impl->getProcessor(),
       stop_timeout);
   return std::make_unique<CheckpointStoreImpl>(
-      std::move(versioned_config_store));
+      std::move(versioned_config_store), "", coalesce_interval);
 }
 
 }} // namespace facebook::logdevice
@@ -39,9 +39,11 @@ statusCallbackPostingBaton(Status* return_status, folly::Baton<>& call_baton) {
 
 CheckpointStoreImpl::CheckpointStoreImpl(
     std::unique_ptr<VersionedConfigStore> vcs,
-    const std::string& prefix)
+    const std::string& prefix,
+    std::chrono::milliseconds coalesce_interval)
     : vcs_(std::move(vcs)),
       prefix_(prefix),
+      coalesce_interval_(coalesce_interval),
       event_base_(folly::getEventBase()),
       timer_(folly::HHWheelTimer::newTimer(event_base_)),
       holder_(this) {}
@@ -128,6 +130,44 @@ void CheckpointStoreImpl::updateLSN(const std::string& customer_id,
 void CheckpointStoreImpl::updateLSN(const std::string& customer_id,
                                     const std::map<logid_t, lsn_t>& checkpoints,
                                     StatusCallback cb) {
+  if (coalesce_interval_ > std::chrono::milliseconds::zero()) {
+    bool schedule_flush = false;
+    {
+      std::lock_guard<std::mutex> lock(pending_mutex_);
+      auto& pending = pending_[customer_id];
+      for (auto [log_id, lsn] : checkpoints) {
+        lsn_t& buffered = pending.checkpoints[log_id];
+        // Readers checkpoint monotonically; keep the highest LSN in case
+        // updates for one log got coalesced out of order.
+        buffered = std::max(buffered, lsn);
+      }
+      pending.callbacks.push_back(std::move(cb));
+      if (!pending.flush_scheduled) {
+        pending.flush_scheduled = true;
+        schedule_flush = true;
+      }
+    }
+    if (schedule_flush) {
+      event_base_->runInEventBaseThread(
+          [this, ref = holder_.ref(), customer_id]() mutable {
+            if (!ref) {
+              return;
+            }
+            timer_->scheduleTimeoutFn(
+                [this,
+                 ref = holder_.ref(),
+                 customer_id = std::move(customer_id)] {
+                  if (!ref) {
+                    return;
+                  }
+                  writePendingUpdates(customer_id);
+                },
+                coalesce_interval_);
+          });
+    }
+    return;
+  }
+
   auto modify_checkpoint = [checkpoints](Checkpoint& checkpoint) {
     for (auto [log_id, lsn] : checkpoints) {
       checkpoint.log_lsn_map_ref()[log_id.val()] = lsn;
@@ -136,6 +176,40 @@ void CheckpointStoreImpl::updateLSN(const std::string& customer_id,
   updateCheckpoints(customer_id, std::move(modify_checkpoint), std::move(cb));
 }
 
+void CheckpointStoreImpl::flushUpdates(const std::string& customer_id) {
+  // Any timer already scheduled for this batch will find nothing to write.
+  writePendingUpdates(customer_id);
+}
+
+void CheckpointStoreImpl::writePendingUpdates(const std::string& customer_id) {
+  std::map<logid_t, lsn_t> checkpoints;
+  std::vector<StatusCallback> callbacks;
+  {
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    auto it = pending_.find(customer_id);
+    if (it == pending_.end()) {
+      return;
+    }
+    checkpoints = std::move(it->second.checkpoints);
+    callbacks = std::move(it->second.callbacks);
+    pending_.erase(it);
+  }
+
+  auto modify_checkpoint = [checkpoints = std::move(checkpoints)](
+                               Checkpoint& checkpoint) {
+    for (auto [log_id, lsn] : checkpoints) {
+      checkpoint.log_lsn_map_ref()[log_id.val()] = lsn;
+    }
+  };
+  auto fan_out = [callbacks = std::move(callbacks)](Status status) mutable {
+    for (auto& callback : callbacks) {
+      callback(status);
+    }
+  };
+  updateCheckpoints(
+      customer_id, std::move(modify_checkpoint), std::move(fan_out));
+}
+
 Status CheckpointStoreImpl::updateLSNSync(
     const std::string& customer_id,
     const std::map<logid_t, lsn_t>& checkpoints) {
@@ -151,6 +225,17 @@ void CheckpointStoreImpl::removeCheckpoints(
     const std::string& customer_id,
     const std::vector<logid_t>& checkpoints,
     StatusCallback cb) {
+  {
+    // Drop any buffered updates for the removed logs so a later coalesced
+    // write doesn't resurrect them.
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    auto it = pending_.find(customer_id);
+    if (it != pending_.end()) {
+      for (auto log_id : checkpoints) {
+        it->second.checkpoints.erase(log_id);
+      }
+    }
+  }
   auto modify_checkpoint = [checkpoints](Checkpoint& checkpoint) {
     for (auto log_id : checkpoints) {
       checkpoint.log_lsn_map_ref()->erase(log_id.val());
@@ -161,6 +246,14 @@ void CheckpointStoreImpl::removeCheckpoints(
 
 void CheckpointStoreImpl::removeAllCheckpoints(const std::string& customer_id,
                                                StatusCallback cb) {
+  {
+    // See removeCheckpoints().
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    auto it = pending_.find(customer_id);
+    if (it != pending_.end()) {
+      it->second.checkpoints.clear();
+    }
+  }
   auto modify_checkpoint = [](Checkpoint& checkpoint) {
     checkpoint.log_lsn_map_ref()->clear();
   };
@@ -7,6 +7,11 @@
  */
 #pragma once
 
+#include <chrono>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
 #include <folly/io/async/HHWheelTimer.h>
 
 #include "logdevice/common/VersionedConfigStore.h"
@@ -25,9 +30,18 @@ class CheckpointStoreImpl : public CheckpointStore {
   /**
    * @param prefix: the string which will be added at the beginning of every
    *   key.
+   * @param coalesce_interval: if positive, asynchronous updateLSN() calls are
+   *   buffered and written as a single versioned record per customer_id every
+   *   coalesce_interval, instead of one write per update. The callback of
+   *   every coalesced update is invoked with the status of that one write.
+   *   Zero (the default) keeps the one-write-per-update behavior. Note that
+   *   the synchronous update methods go through the same batching, so with a
+   *   nonzero interval they may block for up to that long.
    */
   explicit CheckpointStoreImpl(std::unique_ptr<VersionedConfigStore> vcs,
-                               const std::string& prefix = "");
+                               const std::string& prefix = "",
+                               std::chrono::milliseconds coalesce_interval =
+                                   std::chrono::milliseconds::zero());
 
   void getLSN(const std::string& customer_id,
               logid_t log_id,
@@ -66,6 +80,14 @@ class CheckpointStoreImpl : public CheckpointStore {
 
   Status removeAllCheckpointsSync(const std::string& customer_id) override;
 
+  /**
+   * Writes any updates buffered for the given customer_id immediately instead
+   * of waiting for the coalescing timer. The callbacks of the buffered
+   * updates serve as acknowledgment. No-op when coalescing is disabled or
+   * nothing is buffered.
+   */
+  void flushUpdates(const std::string& customer_id);
+
   static folly::Optional<CheckpointStore::Version>
       extractVersion(folly::StringPiece);
 
@@ -78,12 +100,30 @@ class CheckpointStoreImpl : public CheckpointStore {
           modify_checkpoint,
       StatusCallback cb);
 
+  // Takes the batch buffered for the given customer_id, if any, and writes it
+  // as one versioned record, fanning the resulting status out to the
+  // callbacks of all coalesced updates.
+  void writePendingUpdates(const std::string& customer_id);
+
   std::string createKey(const std::string& customer_id) const;
 
   std::unique_ptr<VersionedConfigStore> vcs_;
   std::string prefix_;
+  const std::chrono::milliseconds coalesce_interval_;
   folly::EventBase* event_base_;
   folly::HHWheelTimer::UniquePtr timer_;
+
+  // Updates buffered per customer_id while waiting for the coalescing timer.
+  // Guarded by pending_mutex_ since updateLSN() may be called from any thread.
+  struct PendingUpdates {
+    std::map<logid_t, lsn_t> checkpoints;
+    std::vector<StatusCallback> callbacks;
+    // True if a timer to write this batch has already been scheduled.
+    bool flush_scheduled{false};
+  };
+  std::mutex pending_mutex_;
+  std::unordered_map<std::string, PendingUpdates> pending_;
+
   WeakRefHolder<CheckpointStoreImpl> holder_;
 };
 
@@ -275,6 +275,48 @@ TEST_F(CheckpointStoreImplTest, UpdateAndGetWithInMemVersionedConfigStore) {
   ASSERT_EQ(Status::NOTFOUND, status);
 }
 
+TEST_F(CheckpointStoreImplTest, CoalescedUpdatesWrittenAsOneRecord) {
+  EXPECT_CALL(
+      *mock_versioned_config_store_, readModifyWriteConfig("customer", _, _))
+      .Times(1)
+      .WillOnce(Invoke([](auto, auto mcb, auto cb) {
+        auto [status, value] = mcb(folly::none);
+        EXPECT_EQ(Status::OK, status);
+        auto value_thrift =
+            ThriftCodec::deserialize<BinarySerializer, Checkpoint>(
+                Slice::fromString(value));
+        ASSERT_NE(nullptr, value_thrift);
+        Checkpoint correct;
+        *correct.log_lsn_map_ref() = {{1, 5}, {2, 7}};
+        *correct.version_ref() = 1;
+        EXPECT_EQ(correct, *value_thrift);
+        cb(status, CheckpointStore::Version(1), "");
+      }));
+
+  // Long coalescing interval: the test flushes explicitly.
+  auto checkpointStore = std::make_unique<CheckpointStoreImpl>(
+      std::move(mock_versioned_config_store_), "", std::chrono::minutes(10));
+
+  folly::Baton<> first_baton, second_baton;
+  checkpointStore->updateLSN("customer", logid_t(1), 3, [&](Status status) {
+    EXPECT_EQ(Status::OK, status);
+    first_baton.post();
+  });
+  // The second update for log 1 should supersede the first one, and both
+  // callbacks should be invoked with the status of the single write.
+  checkpointStore->updateLSN(
+      "customer",
+      std::map<logid_t, lsn_t>{{logid_t(1), 5}, {logid_t(2), 7}},
+      [&](Status status) {
+        EXPECT_EQ(Status::OK, status);
+        second_baton.post();
+      });
+
+  checkpointStore->flushUpdates("customer");
+  first_baton.wait();
+  second_baton.wait();
+}
+
 TEST_F(CheckpointStoreImplTest, RemoveSomeCheckpoints) {
   Checkpoint correct;
   *correct.log_lsn_map_ref() = {{1, 2}, {2, 5}, {3, 7}, {2, 3}};
@@ -43,6 +43,9 @@ class MockAsyncReader : public AsyncReader {
 
   MOCK_METHOD0(forceNoSingleCopyDelivery, void());
 
+  MOCK_METHOD1(deliverRecordsOutOfOrder,
+               void(std::function<void(logid_t, lsn_t)>));
+
   MOCK_METHOD0(includeByteOffset, void());
 
   MOCK_METHOD0(doNotSkipPartiallyTrimmedSections, void());
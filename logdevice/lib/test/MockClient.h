@@ -40,6 +40,11 @@ class MockClient : public Client {
                    std::chrono::milliseconds,
                    find_time_callback_t,
                    FindKeyAccuracy));
+  MOCK_METHOD4(findTimeBatch,
+               int(const std::vector<logid_t>&,
+                   std::chrono::milliseconds,
+                   find_time_batch_callback_t,
+                   FindKeyAccuracy));
   MOCK_METHOD4(findKey,
                int(logid_t, std::string, find_key_callback_t, FindKeyAccuracy));
   MOCK_METHOD2(isLogEmptySync, int(logid_t logid, bool* empty));
@@ -38,6 +38,7 @@
 #include "tables/LogsDBMetadata.h"
 #include "tables/Nodes.h"
 #include "tables/Partitions.h"
+#include "tables/PrincipalShaping.h"
 #include "tables/Purges.h"
 #include "tables/Readers.h"
 #include "tables/Record.h"
@@ -54,6 +55,8 @@
 #include "tables/StorageTasks.h"
 #include "tables/StoredLogs.h"
 #include "tables/SyncSequencerRequests.h"
+#include "tables/WorkerCpuByLogGroup.h"
+#include "tables/WorkerMaps.h"
 
 namespace facebook { namespace logdevice { namespace ldquery {
 
@@ -164,6 +167,7 @@ LDQuery::LDQuery(std::string config_path,
   table_registry_.registerTable<tables::LogsDBMetadata>(ctx_);
   table_registry_.registerTable<tables::Nodes>(ctx_);
   table_registry_.registerTable<tables::Partitions>(ctx_);
+  table_registry_.registerTable<tables::PrincipalShaping>(ctx_);
   table_registry_.registerTable<tables::Purges>(ctx_);
   table_registry_.registerTable<tables::Readers>(ctx_);
   table_registry_.registerTable<tables::Record<tables::RecordQueryMode::CSI>>(
@@ -188,6 +192,8 @@ LDQuery::LDQuery(std::string config_path,
   table_registry_.registerTable<tables::StorageTasks>(ctx_);
   table_registry_.registerTable<tables::StoredLogs>(ctx_);
   table_registry_.registerTable<tables::SyncSequencerRequests>(ctx_);
+  table_registry_.registerTable<tables::WorkerCpuByLogGroup>(ctx_);
+  table_registry_.registerTable<tables::WorkerMaps>(ctx_);
 
   const int rc = sqlite3_open(":memory:", &db_);
 
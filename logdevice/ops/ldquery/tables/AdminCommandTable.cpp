@@ -7,10 +7,10 @@
  */
 #include "logdevice/ops/ldquery/tables/AdminCommandTable.h"
 
-#include <thread>
-
 #include <folly/Memory.h>
 #include <folly/String.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/futures/Future.h>
 #include <folly/json.h>
 
 #include "external/gason/src/gason.h"
@@ -283,8 +283,47 @@ void AdminCommandTable::refillCache(QueryContext& ctx) {
           requests.size());
 
   steady_clock::time_point tstart = steady_clock::now();
-  auto responses = ld_admin_client.send(requests, command_timeout_);
-  ld_check(requests.size() == responses.size());
+
+  // Fan out to all selected nodes at once and parse each response as soon as
+  // it arrives, instead of waiting for the slowest node before starting to
+  // parse anything. With hundreds of nodes this overlaps nearly all of the
+  // parsing with the network wait.
+  auto futures = ld_admin_client.asyncSend(requests, command_timeout_);
+  ld_check(requests.size() == futures.size());
+
+  std::vector<AdminCommandClient::Response> responses(futures.size());
+  std::vector<TableData> results(futures.size());
+  const size_t num_transform_threads =
+      std::max(1ul, std::min(futures.size(), 32ul));
+  folly::CPUThreadPoolExecutor transform_executor(num_transform_threads);
+  std::vector<folly::SemiFuture<folly::Unit>> transformed;
+  transformed.reserve(futures.size());
+  for (size_t i = 0; i < futures.size(); ++i) {
+    transformed.push_back(
+        std::move(futures[i])
+            .via(&transform_executor)
+            .thenTry([this, &responses, &results, i](
+                         folly::Try<AdminCommandClient::Response> response) {
+              responses[i] = response.hasValue()
+                  ? std::move(response.value())
+                  : AdminCommandClient::Response{
+                        "", false, response.exception().what().toStdString()};
+              if (!responses[i].success) {
+                return;
+              }
+              PartialTableData partial_data =
+                  transformData(std::move(responses[i].response));
+              if (partial_data.success) {
+                results[i] = std::move(*partial_data.data);
+              } else {
+                responses[i].success = false;
+                responses[i].failure_reason = partial_data.failure_reason;
+              }
+            })
+            .semi());
+  }
+  folly::collectAll(std::move(transformed)).get();
+
   steady_clock::time_point tend = steady_clock::now();
   double duration =
       std::chrono::duration_cast<std::chrono::duration<double>>(tend - tstart)
@@ -293,15 +332,12 @@ void AdminCommandTable::refillCache(QueryContext& ctx) {
   for (const auto& r : responses) {
     replies += r.success;
   }
-  ld_info("Receiving data took %.1fs, %lu/%lu nodes replied",
+  ld_info("Receiving and parsing data took %.1fs, %lu/%lu nodes replied",
           duration,
           replies,
           responses.size());
   tstart = tend;
 
-  ld_info("Parsing json data...");
-  std::vector<TableData> results = transformDataParallel(responses);
-  ld_check(results.size() == responses.size());
   for (int i = 0; i < results.size(); ++i) {
     if (!results[i].cols.empty()) {
       size_t rows = results[i].cols.begin()->second.size();
@@ -323,13 +359,6 @@ void AdminCommandTable::refillCache(QueryContext& ctx) {
     }
   }
 
-  tend = steady_clock::now();
-  duration =
-      std::chrono::duration_cast<std::chrono::duration<double>>(tend - tstart)
-          .count();
-  ld_info("Json parsing took %.1fs", duration);
-
-  tstart = tend;
   Data data;
   ld_info("Aggregating data from %lu nodes...", responses.size());
   data.data = std::make_shared<TableData>(aggregate(std::move(results)));
@@ -698,41 +727,4 @@ AdminCommandTable::transformData(std::string response_from_node) const {
   return PartialTableData{folly::none, false, "UNEXPECTED"};
 }
 
-std::vector<TableData> AdminCommandTable::transformDataParallel(
-    std::vector<AdminCommandClient::Response>& responses) {
-  std::vector<TableData> outputs(responses.size());
-
-  auto thread_func = [&](size_t from, size_t to) {
-    for (size_t i = from; i < std::min(to, responses.size()); ++i) {
-      if (responses[i].success) {
-        PartialTableData partial_data =
-            transformData(std::move(responses[i].response));
-        if (partial_data.success) {
-          outputs[i] = std::move(*(partial_data.data));
-        } else {
-          responses[i].success = false;
-          responses[i].failure_reason = partial_data.failure_reason;
-        }
-      }
-    }
-  };
-
-  const size_t num_threads = 32;
-  const size_t num_per_thread = responses.size() / num_threads + 1;
-
-  std::vector<std::thread> threads;
-  for (int i = 0; i < num_threads && i * num_per_thread < responses.size();
-       i++) {
-    const size_t from = i * num_per_thread;
-    const size_t to = from + num_per_thread;
-    threads.push_back(std::thread(thread_func, from, to));
-  }
-
-  for (int i = 0; i < threads.size(); ++i) {
-    threads[i].join();
-  }
-
-  return outputs;
-}
-
 }}} // namespace facebook::logdevice::ldquery
@@ -125,9 +125,6 @@ class AdminCommandTable : public Table {
   // getFetchableColumns().
   std::unordered_map<ColumnName, int> nameToPosMap_;
 
-  std::vector<TableData>
-  transformDataParallel(std::vector<AdminCommandClient::Response>& responses);
-
   std::chrono::milliseconds command_timeout_;
   Type type_;
 
@@ -0,0 +1,66 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <map>
+#include <vector>
+
+#include "../Context.h"
+#include "AdminCommandTable.h"
+
+namespace facebook {
+  namespace logdevice {
+    namespace ldquery {
+      namespace tables {
+
+class PrincipalShaping : public AdminCommandTable {
+ public:
+  explicit PrincipalShaping(std::shared_ptr<Context> ctx)
+      : AdminCommandTable(ctx) {}
+  static std::string getName() {
+    return "principal_shaping";
+  }
+  std::string getDescription() override {
+    return "Per-principal consumption against the read and append "
+           "throughput ceilings configured in the \"principals\" section of "
+           "the config (\"max_read_rate\" and \"max_append_rate\").  One row "
+           "per worker per principal with a configured ceiling; counters are "
+           "cumulative since the last config update.  See "
+           "logdevice/common/PrincipalThrottle.h.";
+  }
+  TableColumns getFetchableColumns() const override {
+    return {
+        {"worker", DataType::INTEGER, "Id of the worker."},
+        {"principal", DataType::TEXT, "Name of the principal."},
+        {"read_limited",
+         DataType::INTEGER,
+         "Whether the principal has a configured read throughput ceiling."},
+        {"read_bytes",
+         DataType::BIGINT,
+         "Record bytes served to clients authenticated as this principal."},
+        {"read_deferrals",
+         DataType::BIGINT,
+         "Number of times catchup for such a client was paused because the "
+         "principal was over its read throughput ceiling."},
+        {"append_limited",
+         DataType::INTEGER,
+         "Whether the principal has a configured append throughput ceiling."},
+        {"append_bytes",
+         DataType::BIGINT,
+         "Append payload bytes admitted from this principal."},
+        {"append_rejections",
+         DataType::BIGINT,
+         "Number of appends rejected because the principal was over its "
+         "append throughput ceiling."}};
+  }
+  std::string getCommandToSend(QueryContext& /*ctx*/) const override {
+    return std::string("info principal_shaping --json\n");
+  }
+};
+
+}}}} // namespace facebook::logdevice::ldquery::tables
@@ -104,6 +104,17 @@ class ShardRebuildings : public AdminCommandTable {
          DataType::REAL,
          "Approximately what fraction of the work is done, between 0 and 1. "
          "-1 if the implementation doesn't support progress estimation."},
+        {"eta",
+         DataType::BIGINT,
+         "Estimated number of milliseconds until this donor finishes "
+         "rebuilding, based on a smoothed rate of progress. Empty if no "
+         "estimate is available (not enough samples yet, progress estimation "
+         "not supported, or rebuilding is stalled)."},
+        {"eta_p95",
+         DataType::BIGINT,
+         "One-sided 95% upper bound on \"eta\" (in milliseconds), derived "
+         "from the observed variance of the progress rate. Empty if the "
+         "rate is too noisy for a finite bound."},
     };
   }
   std::string getCommandToSend(QueryContext& /*ctx*/) const override {
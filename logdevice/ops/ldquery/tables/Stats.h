@@ -34,7 +34,18 @@ class Stats : public AdminCommandTable {
     return {{"name", DataType::TEXT, "Name of the stat counter."},
             {"value", DataType::BIGINT, "Value of the stat counter."}};
   }
-  std::string getCommandToSend(QueryContext& /*ctx*/) const override {
+  std::string getCommandToSend(QueryContext& ctx) const override {
+    // If the query selects a single stat by name, push the name down to the
+    // server so it does not have to print (and we do not have to parse) every
+    // counter. The server matches on the base stat name, which may be a
+    // prefix of the full name (eg "append_success.shard0"), so only send the
+    // part before the first dot; sqlite re-applies the full constraint on the
+    // rows we return.
+    std::string expr;
+    if (columnHasEqualityConstraint(1, ctx, expr)) {
+      return std::string("stats2 --filter ") + expr.substr(0, expr.find('.')) +
+          "\n";
+    }
     return std::string("stats2\n");
   }
 };
@@ -0,0 +1,51 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <map>
+#include <tuple>
+#include <vector>
+
+#include "../Context.h"
+#include "AdminCommandTable.h"
+
+namespace facebook {
+  namespace logdevice {
+    namespace ldquery {
+      namespace tables {
+
+class WorkerCpuByLogGroup : public AdminCommandTable {
+ public:
+  explicit WorkerCpuByLogGroup(std::shared_ptr<Context> ctx)
+      : AdminCommandTable(ctx, AdminCommandTable::Type::STAT) {}
+  static std::string getName() {
+    return "worker_cpu_by_log_group";
+  }
+  std::string getDescription() override {
+    return "For each node, reports the cumulative worker-thread CPU time "
+           "attributed to each log group since the server started.  Message "
+           "and request handlers that know which log they are working for "
+           "report their dispatch time to this table, so it answers which log "
+           "groups are consuming the worker threads of a node.  Attribution "
+           "is approximate; dispatches that do not report a log are not "
+           "counted.";
+  }
+  TableColumns getFetchableColumns() const override {
+    return {
+        {"log_group_name", DataType::TEXT, "The name of the log group."},
+        {"worker_cpu_usec",
+         DataType::BIGINT,
+         "Worker-thread CPU microseconds attributed to the log group."},
+    };
+  }
+  std::string getCommandToSend(QueryContext& /*ctx*/) const override {
+    return std::string("stats worker_cpu\n");
+  }
+};
+
+}}}} // namespace facebook::logdevice::ldquery::tables
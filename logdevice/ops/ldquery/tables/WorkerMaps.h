@@ -0,0 +1,51 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <map>
+#include <vector>
+
+#include "../Context.h"
+#include "AdminCommandTable.h"
+
+namespace facebook {
+  namespace logdevice {
+    namespace ldquery {
+      namespace tables {
+
+class WorkerMaps : public AdminCommandTable {
+ public:
+  explicit WorkerMaps(std::shared_ptr<Context> ctx) : AdminCommandTable(ctx) {}
+  static std::string getName() {
+    return "worker_maps";
+  }
+  std::string getDescription() override {
+    return "Occupancy of the hot per-worker runtime maps (running appends, "
+           "log group cache, ...): entry counts, bucket counts and the "
+           "resulting load factors.";
+  }
+  TableColumns getFetchableColumns() const override {
+    return {
+        {"worker_id",
+         DataType::INTEGER,
+         "The id of the worker running on the node."},
+        {"map", DataType::TEXT, "Name of the map."},
+        {"entries", DataType::BIGINT, "Number of entries in the map."},
+        {"buckets", DataType::BIGINT, "Number of buckets in the map's table."},
+        {"load_factor",
+         DataType::REAL,
+         "Ratio of entries to buckets; high values mean a resize is near."},
+    };
+  }
+
+  std::string getCommandToSend(QueryContext& /*ctx*/) const override {
+    return std::string("info worker_maps --json\n");
+  }
+};
+
+}}}} // namespace facebook::logdevice::ldquery::tables
@@ -28,6 +28,27 @@ void ReplicationCheckerSettings::defineSettings(SettingEasyInit& init) {
        nullptr,
        "Maximum read throughput per log in bytes per seconds",
        CLIENT);
+  init("per-log-record-window",
+       &per_log_record_window,
+       "0",
+       nullptr,
+       "Maximum number of LSNs per log for which to buffer partially received "
+       "record copies. Copies can pile up e.g. when a read stream rewinds "
+       "after a data loss, in which case the buffer can grow to a significant "
+       "part of an epoch. When the window is full, copies of LSNs past the "
+       "window are dropped and the affected records are counted as "
+       "records_skipped_window instead of being checked. 0 means unlimited.",
+       CLIENT);
+  init("checkpoint-path",
+       &checkpoint_path,
+       "",
+       nullptr,
+       "Path to a progress checkpoint file. Every successfully checked log is "
+       "appended to this file, and logs listed in it are skipped on startup, "
+       "so that a restarted checker resumes where the previous run left off "
+       "instead of re-reading everything. Remove the file to force a full "
+       "re-check. Empty means no checkpointing.",
+       CLIENT);
   init("num-logs-to-check",
        &num_logs_to_check,
        "-1",
@@ -6,12 +6,14 @@
  * LICENSE file in the root directory of this source tree.
  */
 #include <signal.h>
+#include <fstream>
 #include <unordered_map>
 #include <unordered_set>
 
 #include <boost/program_options.hpp>
 #include <boost/tokenizer.hpp>
 #include <folly/Bits.h>
+#include <folly/Conv.h>
 #include <folly/Random.h>
 #include <folly/Range.h>
 #include <folly/Singleton.h>
@@ -95,6 +97,14 @@ Processor* processor;
 std::mutex mutex;
 std::vector<LogCheckRequest> logs_to_check;
 
+// Progress checkpoint (--checkpoint-path). Logs listed in the file were fully
+// checked by a previous run and are skipped; logs checked by this run are
+// appended as they finish.
+std::mutex checkpoint_mutex;
+std::ofstream checkpoint_file;
+std::unordered_set<logid_t> checkpointed_logs;
+void mark_log_checkpointed(logid_t log);
+
 std::chrono::steady_clock::time_point start_time;
 size_t logs_to_check_initial_count;
 std::atomic<size_t> num_failures_to_stop{0};
@@ -441,7 +451,8 @@ struct CheckStats {
           field(trimmed_bytes) field(records_above_bridge)                    \
               field(copies_on_authoritative_empty_nodes)                      \
                   field(authoritative_empty_in_copyset)                       \
-                      field(records_rebuilding_pending)
+                      field(records_rebuilding_pending)                       \
+                          field(records_skipped_window)
 
 #define DECLARE_FIELD(name) size_t name = 0;
   FIELDS(DECLARE_FIELD)
@@ -765,6 +776,9 @@ class LogChecker : public std::enable_shared_from_this<LogChecker> {
   ClientReadStream* stream_ = nullptr; // owned by AllClientReadStreams
   std::map<lsn_t, std::map<ShardID, RecordCopy>> records_;
   lsn_t last_seen_bridge_;
+  // Highest LSN whose copies were dropped because the record window
+  // (--per-log-record-window) was full.
+  lsn_t window_skip_upto_ = LSN_INVALID;
   epoch_t current_epoch_ = EPOCH_INVALID;
   std::unique_ptr<FailureDomainNodeSet<uint64_t>> replication_checker_;
   uint64_t replication_check_counter_ = 1;
@@ -882,6 +896,19 @@ class LogChecker : public std::enable_shared_from_this<LogChecker> {
              from.toString().c_str(),
              lsn_to_string(record->attrs.lsn).c_str());
 
+    if (checker_settings->per_log_record_window > 0 &&
+        records_.size() >= checker_settings->per_log_record_window &&
+        !records_.count(lsn)) {
+      // The window of partially received records is full. This can happen
+      // e.g. when the read stream rewinds after a data loss and re-delivers
+      // copies faster than we drain them. Remember that the LSN exists so
+      // that the processing loop stays in sync, but drop the copies;
+      // gotAllCopiesOfRecord() will count the record as skipped.
+      window_skip_upto_ = std::max(window_skip_upto_, lsn);
+      records_[lsn];
+      return;
+    }
+
     if (!record->extra_metadata) {
       ld_error("log %lu: got record without extra metadata from %s with "
                "lsn %s; ignoring",
@@ -989,10 +1016,16 @@ class LogChecker : public std::enable_shared_from_this<LogChecker> {
     const auto& copies = records_.begin()->second;
 
     if (copies.empty()) {
-      ld_error("log %lu: all copies of record %s didn't have extra metadata"
-               "; ignoring",
-               log_id_.val_,
-               lsn_to_string(lsn).c_str());
+      if (lsn <= window_skip_upto_) {
+        // Copies were dropped in gotRecordCopy() because the record window
+        // was full.
+        ++stats_.records_skipped_window;
+      } else {
+        ld_error("log %lu: all copies of record %s didn't have extra metadata"
+                 "; ignoring",
+                 log_id_.val_,
+                 lsn_to_string(lsn).c_str());
+      }
       records_.erase(records_.begin());
       return true;
     }
@@ -1504,6 +1537,8 @@ class PerWorkerCoordinatorRequest : public Request {
              "error: log %lu failed: %s",
              rq.log_id.val_,
              c->getError().c_str());
+    } else {
+      mark_log_checkpointed(rq.log_id);
     }
     auto st = c->getStats();
     folly::dynamic d = folly::dynamic::object();
@@ -1762,6 +1797,53 @@ void setup_dump_state_trigger() {
   ld_check(rv == 0);
 }
 
+// Loads the set of already checked logs from the checkpoint file and opens
+// the file for appending. Exits on failure to open the file for writing.
+// No-op if --checkpoint-path is not set.
+void load_checkpoint() {
+  const std::string& path = checker_settings->checkpoint_path;
+  if (path.empty()) {
+    return;
+  }
+  std::ifstream in(path);
+  if (in) {
+    std::string line;
+    while (std::getline(in, line)) {
+      if (line.empty()) {
+        continue;
+      }
+      auto id = folly::tryTo<uint64_t>(line);
+      if (!id.hasValue()) {
+        ld_error("Malformed line in checkpoint file %s, ignoring: %s",
+                 path.c_str(),
+                 line.c_str());
+        continue;
+      }
+      checkpointed_logs.insert(logid_t(id.value()));
+    }
+    ld_info("Loaded %lu checked logs from checkpoint file %s",
+            checkpointed_logs.size(),
+            path.c_str());
+  }
+  checkpoint_file.open(path, std::ofstream::app);
+  if (!checkpoint_file.is_open()) {
+    ld_error("Failed to open checkpoint file %s for writing", path.c_str());
+    exit(1);
+  }
+}
+
+// Records a fully checked log in the checkpoint file. Called from worker
+// threads.
+void mark_log_checkpointed(logid_t log) {
+  std::lock_guard<std::mutex> lock(checkpoint_mutex);
+  if (!checkpoint_file.is_open()) {
+    return;
+  }
+  // std::endl flushes, so a killed checker loses at most the logs that were
+  // still in flight.
+  checkpoint_file << log.val_ << std::endl;
+}
+
 int main(int argc, const char** argv) {
   // These parameters are used to split the work of checking between multiple
   // checker instances. When the checker process is spawned it is passed the
@@ -1938,6 +2020,7 @@ int main(int argc, const char** argv) {
         RecordLevelError::BAD_REPLICATION_LAST_WAVE;
     errors_to_ignore |= noisy_errors;
   }
+  load_checkpoint();
   start_time = std::chrono::steady_clock::now();
   std::shared_ptr<Client> ldclient =
       ClientFactory()
@@ -1962,6 +2045,12 @@ int main(int argc, const char** argv) {
       if (!logids_to_check_set.empty() && !logids_to_check_set.count(log_id)) {
         return;
       }
+      if (checkpointed_logs.count(log_id)) {
+        ld_debug("Skipping log %lu: already checked according to the "
+                 "checkpoint file",
+                 log_id.val_);
+        return;
+      }
 
       if ((log_id.val_ % numTasks) == taskId) {
         ld_debug("Queueing log %lu for checking", log_id.val_);
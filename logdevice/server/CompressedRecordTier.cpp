@@ -0,0 +1,210 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/CompressedRecordTier.h"
+
+#include <cstring>
+#include <lz4.h>
+#include <vector>
+
+#include "logdevice/common/debug.h"
+#include "logdevice/common/stats/Stats.h"
+#include "logdevice/server/EpochRecordCacheEntry.h"
+#include "logdevice/server/RealTimeRecordBuffer.h"
+
+namespace facebook { namespace logdevice {
+
+CompressedRecordTier::CompressedRecordTier(size_t max_bytes,
+                                           StatsHolder* stats)
+    : max_bytes_(max_bytes), stats_(stats) {
+  ld_check(max_bytes_ > 0);
+}
+
+void CompressedRecordTier::put(logid_t log_id,
+                               lsn_t begin,
+                               lsn_t end,
+                               const ReleasedVector& entries) {
+  if (entries.empty()) {
+    return;
+  }
+
+  size_t uncompressed_size = 0;
+  for (const auto& entry : entries) {
+    uncompressed_size += sizeof(lsn_t) + entry->sizeInLinearBuffer();
+  }
+  if (uncompressed_size > LZ4_MAX_INPUT_SIZE) {
+    STAT_INCR(stats_, record_cache_compressed_tier_ranges_skipped);
+    return;
+  }
+
+  std::string uncompressed(uncompressed_size, '\0');
+  size_t offset = 0;
+  for (const auto& entry : entries) {
+    const lsn_t lsn = entry->lsn;
+    memcpy(&uncompressed[offset], &lsn, sizeof(lsn));
+    offset += sizeof(lsn);
+    ssize_t rv = entry->toLinearBuffer(
+        &uncompressed[offset], uncompressed_size - offset);
+    ld_check(rv >= 0);
+    offset += rv;
+  }
+  ld_check_eq(offset, uncompressed_size);
+
+  Segment segment;
+  segment.end_lsn = end;
+  segment.uncompressed_size = uncompressed_size;
+  segment.blob.resize(LZ4_compressBound(uncompressed_size));
+  int compressed_size = LZ4_compress_default(uncompressed.data(),
+                                             &segment.blob[0],
+                                             uncompressed_size,
+                                             segment.blob.size());
+  ld_check(compressed_size > 0);
+  segment.blob.resize(compressed_size);
+  segment.blob.shrink_to_fit();
+
+  if (segment.blob.size() > max_bytes_) {
+    // A single range bigger than the whole budget; storing it would just
+    // flush everything else out.
+    STAT_INCR(stats_, record_cache_compressed_tier_ranges_skipped);
+    return;
+  }
+
+  const size_t blob_size = segment.blob.size();
+  std::lock_guard<std::mutex> lock(mutex_);
+  Key key(log_id.val_, begin);
+  auto it = segments_.find(key);
+  if (it != segments_.end()) {
+    // The same range was released again (possible with overlapping releases
+    // under memory pressure); keep the newer version in place.
+    bytes_used_ -= it->second.blob.size();
+    STAT_SUB(
+        stats_, record_cache_compressed_tier_bytes, it->second.blob.size());
+    it->second = std::move(segment);
+  } else {
+    insertion_order_.push_back(key);
+    segments_[key] = std::move(segment);
+  }
+  bytes_used_ += blob_size;
+  STAT_ADD(stats_, record_cache_compressed_tier_bytes, blob_size);
+  STAT_INCR(stats_, record_cache_compressed_tier_ranges_stored);
+  evictLocked();
+}
+
+std::shared_ptr<ReleasedRecords>
+CompressedRecordTier::lookup(logid_t log_id, lsn_t lsn) const {
+  Segment segment;
+  lsn_t begin;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = segments_.upper_bound(Key(log_id.val_, lsn));
+    if (it == segments_.begin()) {
+      return nullptr;
+    }
+    --it;
+    if (it->first.first != log_id.val_ || it->second.end_lsn < lsn) {
+      return nullptr;
+    }
+    begin = it->first.second;
+    // Copy the blob out so that decompression happens outside the lock.
+    segment = it->second;
+  }
+
+  std::string uncompressed(segment.uncompressed_size, '\0');
+  int rv = LZ4_decompress_safe(segment.blob.data(),
+                               &uncompressed[0],
+                               segment.blob.size(),
+                               uncompressed.size());
+  if (rv < 0 || static_cast<size_t>(rv) != segment.uncompressed_size) {
+    RATELIMIT_ERROR(std::chrono::seconds(10),
+                    2,
+                    "LZ4 decompression of compressed record tier range for "
+                    "log %lu [%s, %s] failed with %d",
+                    log_id.val_,
+                    lsn_to_string(begin).c_str(),
+                    lsn_to_string(segment.end_lsn).c_str(),
+                    rv);
+    return nullptr;
+  }
+
+  // Reconstruct the entries and chain them in LSN order the way
+  // RecordCacheDisposal::onRecordsReleased() does.
+  std::vector<std::shared_ptr<EpochRecordCacheEntry>> entries;
+  size_t offset = 0;
+  while (offset < uncompressed.size()) {
+    lsn_t entry_lsn;
+    if (offset + sizeof(entry_lsn) > uncompressed.size()) {
+      RATELIMIT_ERROR(std::chrono::seconds(10),
+                      2,
+                      "Malformed compressed record tier range for log %lu "
+                      "[%s, %s]: truncated at offset %lu",
+                      log_id.val_,
+                      lsn_to_string(begin).c_str(),
+                      lsn_to_string(segment.end_lsn).c_str(),
+                      offset);
+      return nullptr;
+    }
+    memcpy(&entry_lsn, &uncompressed[offset], sizeof(entry_lsn));
+    offset += sizeof(entry_lsn);
+
+    size_t used = 0;
+    // Entries reconstructed here never belonged to a record cache, so give
+    // them a disposer that frees them in place.
+    auto entry = EpochRecordCacheEntry::createFromLinearBuffer(
+        entry_lsn,
+        uncompressed.data() + offset,
+        uncompressed.size() - offset,
+        EpochRecordCacheEntry::Disposer(nullptr),
+        &used);
+    if (entry == nullptr) {
+      RATELIMIT_ERROR(std::chrono::seconds(10),
+                      2,
+                      "Malformed entry at offset %lu of compressed record "
+                      "tier range for log %lu [%s, %s]",
+                      offset,
+                      log_id.val_,
+                      lsn_to_string(begin).c_str(),
+                      lsn_to_string(segment.end_lsn).c_str());
+      return nullptr;
+    }
+    offset += used;
+    entries.push_back(std::move(entry));
+  }
+
+  for (size_t i = 1; i < entries.size(); ++i) {
+    entries[i - 1]->next_ = entries[i];
+  }
+  std::shared_ptr<ZeroCopiedRecord> head =
+      entries.empty() ? nullptr : entries.front();
+  return std::make_shared<ReleasedRecords>(
+      log_id,
+      begin,
+      segment.end_lsn,
+      head,
+      ReleasedRecords::computeBytesEstimate(head.get()));
+}
+
+size_t CompressedRecordTier::getBytesUsed() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return bytes_used_;
+}
+
+void CompressedRecordTier::evictLocked() {
+  while (bytes_used_ > max_bytes_ && !insertion_order_.empty()) {
+    auto it = segments_.find(insertion_order_.front());
+    insertion_order_.pop_front();
+    if (it == segments_.end()) {
+      continue;
+    }
+    bytes_used_ -= it->second.blob.size();
+    STAT_SUB(
+        stats_, record_cache_compressed_tier_bytes, it->second.blob.size());
+    STAT_INCR(stats_, record_cache_compressed_tier_ranges_evicted);
+    segments_.erase(it);
+  }
+}
+
+}} // namespace facebook::logdevice
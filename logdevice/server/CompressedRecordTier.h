@@ -0,0 +1,94 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "logdevice/common/types_internal.h"
+#include "logdevice/server/RecordCacheDependencies.h"
+
+namespace facebook { namespace logdevice {
+
+class ReleasedRecords;
+class StatsHolder;
+
+/**
+ * @file An optional second tier of the record cache. RecordCache only keeps
+ *       unclean records: once records are released, EpochRecordCache evicts
+ *       them, and a reader that is just a few seconds behind the tail has to
+ *       go to the local log store for them. CompressedRecordTier holds
+ *       recently released ranges a while longer, LZ4-compressed, in a
+ *       bounded FIFO ring, so that CatchupOneStream can serve such reads
+ *       without issuing a storage task.
+ *
+ *       There is one instance per shard, owned by LogStorageStateMap and
+ *       shared by all storage and worker threads; all methods are
+ *       thread-safe. Ranges are appended as EpochRecordCache evicts released
+ *       records (see RecordCacheDisposal::onRecordsReleased()) and dropped
+ *       in insertion order once the byte budget configured with
+ *       --record-cache-compressed-tier-size is exceeded.
+ */
+
+class CompressedRecordTier {
+ public:
+  CompressedRecordTier(size_t max_bytes, StatsHolder* stats);
+
+  /**
+   * Compress and append one released range [begin, end] of a log. @param
+   * entries must be ordered by increasing LSN and all belong to the epoch of
+   * `begin', as guaranteed by EpochRecordCache. Ranges whose compressed form
+   * alone exceeds the byte budget are not stored.
+   */
+  void put(logid_t log_id,
+           lsn_t begin,
+           lsn_t end,
+           const ReleasedVector& entries);
+
+  /**
+   * Look for a stored range of the given log containing `lsn'. On a hit,
+   * decompresses the range and returns its reconstructed entries in the same
+   * form the real time reads pipeline uses. Returns nullptr if no stored
+   * range contains the LSN, or if the stored blob turned out to be corrupt.
+   */
+  std::shared_ptr<ReleasedRecords> lookup(logid_t log_id, lsn_t lsn) const;
+
+  /**
+   * Current total size of compressed blobs. For tests and introspection.
+   */
+  size_t getBytesUsed() const;
+
+ private:
+  struct Segment {
+    lsn_t end_lsn;
+    size_t uncompressed_size;
+    // LZ4-compressed concatenation of (lsn, serialized entry) pairs.
+    std::string blob;
+  };
+
+  // (log id, begin LSN of the range)
+  using Key = std::pair<logid_t::raw_type, lsn_t>;
+
+  // Drops the oldest ranges until we're within budget. Caller must hold
+  // mutex_.
+  void evictLocked();
+
+  const size_t max_bytes_;
+  StatsHolder* const stats_;
+
+  mutable std::mutex mutex_;
+  std::map<Key, Segment> segments_;
+  std::deque<Key> insertion_order_;
+  size_t bytes_used_{0};
+};
+
+}} // namespace facebook::logdevice
@@ -8,7 +8,10 @@
 #include "logdevice/server/EpochRecordCacheEntry.h"
 
 #include <algorithm>
+#include <cstdlib>
 #include <cstring>
+#include <new>
+#include <vector>
 
 #include "logdevice/common/PayloadHolder.h"
 #include "logdevice/common/Worker.h"
@@ -23,6 +26,52 @@ namespace facebook { namespace logdevice {
 
 using namespace EpochRecordCacheSerializer;
 
+namespace {
+
+// Maximum number of recycled entry blocks kept per thread. Bounds the memory
+// pinned by an idle thread to kEntryMagazineMaxSize *
+// sizeof(EpochRecordCacheEntry) while still absorbing eviction/store bursts.
+constexpr size_t kEntryMagazineMaxSize = 256;
+
+struct EntryMagazine {
+  std::vector<void*> blocks;
+
+  ~EntryMagazine() {
+    for (void* ptr : blocks) {
+      free(ptr);
+    }
+  }
+};
+
+thread_local EntryMagazine entry_magazine;
+
+} // namespace
+
+void* EpochRecordCacheEntry::operator new(size_t size) {
+  // Only recycle blocks of exactly our own size, in case a subclass ever
+  // shows up.
+  if (size == sizeof(EpochRecordCacheEntry) &&
+      !entry_magazine.blocks.empty()) {
+    void* ptr = entry_magazine.blocks.back();
+    entry_magazine.blocks.pop_back();
+    return ptr;
+  }
+  void* ptr = malloc(size);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void EpochRecordCacheEntry::operator delete(void* ptr, size_t size) {
+  if (size == sizeof(EpochRecordCacheEntry) &&
+      entry_magazine.blocks.size() < kEntryMagazineMaxSize) {
+    entry_magazine.blocks.push_back(ptr);
+    return;
+  }
+  free(ptr);
+}
+
 EpochRecordCacheEntry::EpochRecordCacheEntry() : ZeroCopiedRecord() {}
 
 EpochRecordCacheEntry::EpochRecordCacheEntry(
@@ -198,6 +247,12 @@ EpochRecordCacheEntry::createFromLinearBuffer(lsn_t lsn,
 
 void EpochRecordCacheEntry::Disposer::operator()(EpochRecordCacheEntry* e) {
   std::unique_ptr<EpochRecordCacheEntry> entry_ptr(e);
+  if (deps_ == nullptr) {
+    // The entry never belonged to a record cache (e.g. it was reconstructed
+    // from the compressed record tier); there is nothing to account for,
+    // free it in place.
+    return;
+  }
   deps_->disposeOfCacheEntry(std::move(entry_ptr));
 }
 }} // namespace facebook::logdevice
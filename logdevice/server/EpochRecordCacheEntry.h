@@ -62,6 +62,18 @@ class EpochRecordCacheEntry : public ZeroCopiedRecord {
 
   EpochRecordCacheEntry();
 
+  // Entries are allocated and freed at the full write rate of the storage
+  // node, one per STORE, and they're all the same size. Instead of hitting
+  // the heap every time, freed blocks are recycled through a bounded
+  // thread-local magazine: operator delete pushes the block onto the current
+  // thread's magazine and operator new pops from it, falling back to the
+  // heap when the magazine is empty. Eviction (e.g.
+  // EpochRecordCache::advanceLNG()/evictUpTo()) frees entries in batches on
+  // the storage thread that runs it, refilling the magazine that the next
+  // batch of STOREs on that thread consumes.
+  static void* operator new(size_t size);
+  static void operator delete(void* ptr, size_t size);
+
   EpochRecordCacheEntry(lsn_t lsn,
                         STORE_flags_t flags,
                         uint64_t timestamp,
@@ -81,6 +93,8 @@ class EpochRecordCacheEntry : public ZeroCopiedRecord {
 
 class EpochRecordCacheEntry::Disposer {
  public:
+  // @param deps  may be nullptr for entries that don't belong to a record
+  //              cache; such entries are simply deleted in place.
   explicit Disposer(EpochRecordCacheDependencies* deps) : deps_(deps) {}
   void operator()(EpochRecordCacheEntry* e);
 
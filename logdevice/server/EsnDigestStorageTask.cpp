@@ -0,0 +1,108 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/EsnDigestStorageTask.h"
+
+#include <folly/Format.h>
+
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/protocol/ESN_DIGEST_Message.h"
+#include "logdevice/server/storage_tasks/StorageThreadPool.h"
+
+namespace facebook { namespace logdevice {
+
+EsnDigestStorageTask::EsnDigestStorageTask(ClientID reply_to,
+                                           const GET_ESN_DIGEST_Header& request,
+                                           Sockaddr client_address)
+    : StorageTask(StorageTask::Type::ESN_DIGEST),
+      reply_to_(reply_to),
+      request_(request),
+      client_address_(client_address) {
+  ld_check(request_.esn_start <= request_.esn_end);
+}
+
+void EsnDigestStorageTask::execute() {
+  executeImpl(storageThreadPool_->getLocalLogStore());
+}
+
+void EsnDigestStorageTask::executeImpl(const LocalLogStore& store) {
+  const size_t num_esns =
+      size_t(request_.esn_end.val_) - request_.esn_start.val_ + 1;
+  bitmap_.assign((num_esns + 7) / 8, 0);
+
+  LocalLogStore::ReadOptions options("EsnDigestStorageTask");
+  options.allow_blocking_io = true;
+  options.tailing = false;
+  options.allow_copyset_index = true;
+  options.csi_data_only = true;
+
+  std::unique_ptr<LocalLogStore::ReadIterator> it =
+      store.read(request_.log_id, options);
+
+  const lsn_t start_lsn = compose_lsn(request_.epoch, request_.esn_start);
+  const lsn_t end_lsn = compose_lsn(request_.epoch, request_.esn_end);
+
+  for (it->seek(start_lsn);
+       it->state() == IteratorState::AT_RECORD && it->getLSN() <= end_lsn;
+       it->next()) {
+    ld_check_ge(it->getLSN(), start_lsn);
+    const size_t idx = lsn_to_esn(it->getLSN()).val_ - request_.esn_start.val_;
+    bitmap_[idx / 8] |= 1u << (idx % 8);
+  }
+
+  switch (it->state()) {
+    case IteratorState::AT_RECORD: // stopped past end_lsn
+    case IteratorState::AT_END:
+      result_status_ = E::OK;
+      break;
+    default:
+      result_status_ = E::FAILED;
+      break;
+  }
+}
+
+void EsnDigestStorageTask::onDone() {
+  sendReply();
+}
+
+void EsnDigestStorageTask::onDropped() {
+  result_status_ = E::FAILED;
+  sendReply();
+}
+
+void EsnDigestStorageTask::sendReply() {
+  const bool ok = result_status_ == E::OK;
+  const uint32_t num_esns = ok
+      ? uint32_t(request_.esn_end.val_ - request_.esn_start.val_ + 1)
+      : 0;
+  ESN_DIGEST_Header header = {request_.log_id,
+                              request_.read_stream_id,
+                              request_.shard,
+                              result_status_,
+                              request_.filter_version,
+                              request_.epoch,
+                              request_.esn_start,
+                              num_esns};
+  Worker::onThisThread()->sender().sendMessage(
+      std::make_unique<ESN_DIGEST_Message>(
+          header, ok ? std::move(bitmap_) : std::vector<uint8_t>()),
+      reply_to_);
+}
+
+void EsnDigestStorageTask::getDebugInfoDetailed(
+    StorageTaskDebugInfo& info) const {
+  info.log_id = request_.log_id;
+  info.client_id = reply_to_;
+  info.client_address = client_address_;
+  info.extra_info = folly::sformat("epoch: {}, esns: [{}, {}]",
+                                   request_.epoch.val_,
+                                   request_.esn_start.val_,
+                                   request_.esn_end.val_);
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,78 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <vector>
+
+#include "logdevice/common/ClientID.h"
+#include "logdevice/common/protocol/GET_ESN_DIGEST_Message.h"
+#include "logdevice/include/Err.h"
+#include "logdevice/include/types.h"
+#include "logdevice/server/locallogstore/LocalLogStore.h"
+#include "logdevice/server/storage_tasks/StorageTask.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Serves a GET_ESN_DIGEST request on a storage node. Scans the copyset
+ * index (no record payloads are read) over one epoch's ESN range and builds
+ * a presence bitmap with one bit per ESN. The requesting client read stream
+ * uses clear bits to conclude that this shard has nothing to send for those
+ * ESNs, resolving gap candidates in bulk.
+ *
+ * The range is expected to already be clamped by the message handler so it
+ * doesn't extend past this node's view of the last released LSN; past that
+ * point absence of a copyset index entry wouldn't be authoritative (a
+ * released record's copy may still be in flight, e.g. written by recovery or
+ * rebuilding).
+ */
+
+class EsnDigestStorageTask : public StorageTask {
+ public:
+  EsnDigestStorageTask(ClientID reply_to,
+                       const GET_ESN_DIGEST_Header& request,
+                       Sockaddr client_address = Sockaddr());
+
+  void execute() override;
+  void onDone() override;
+  void onDropped() override;
+
+  ThreadType getThreadType() const override {
+    return ThreadType::SLOW;
+  }
+
+  StorageTaskPriority getPriority() const override {
+    // Reads only the copyset index, so it's much cheaper than a regular read
+    // of the same LSN range; prioritize it to unblock stalled readers.
+    return StorageTaskPriority::HIGH;
+  }
+
+  Principal getPrincipal() const override {
+    return Principal::READ_BACKLOG;
+  }
+
+  // Workhorse of execute(), LocalLogStore passed from above for testability
+  void executeImpl(const LocalLogStore& store);
+
+  // The result, public for tests
+  Status result_status_{E::UNKNOWN};
+  std::vector<uint8_t> bitmap_;
+
+ private:
+  const ClientID reply_to_;
+  const GET_ESN_DIGEST_Header request_;
+
+  // used for debugging
+  Sockaddr client_address_;
+
+  void sendReply();
+
+  void getDebugInfoDetailed(StorageTaskDebugInfo&) const override;
+};
+
+}} // namespace facebook::logdevice
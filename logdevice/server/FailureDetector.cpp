@@ -457,6 +457,7 @@ void FailureDetector::gossip() {
       failover_.load() ? instance_id_ : std::chrono::milliseconds::zero();
   node.is_node_starting_ = !isLogsConfigLoaded();
   node.status_ = node_health_status_.load(std::memory_order_relaxed);
+  node.shard_qos_ = *self_shard_qos_.rlock();
   // Don't trigger other nodes' state transition until we receive min number
   // of gossips. The GCS reply is not same as a regular gossip, and therefore
   // doesn't contain Node::gossip_ values. The default values of Node::gossip_
@@ -536,8 +537,31 @@ void FailureDetector::gossip() {
                  std::back_inserter(boycott_durations),
                  [](const auto& entry) { return entry.second; });
 
+  // With delta encoding enabled, only include nodes whose wire-visible state
+  // changed since the last gossip we successfully handed off for this
+  // destination, and send the full list periodically as a safety net against
+  // messages lost on broken connections. The wire format is unchanged: the
+  // receiving side merges entries by node id and simply doesn't touch nodes
+  // that are absent from the list.
+  const bool delta_enabled = settings_->gossip_delta_encoding;
+  bool full_sync = true;
+  uint64_t peer_synced_version = 0;
+  uint64_t version_to_sync = 0;
+  if (delta_enabled) {
+    bumpStateVersions();
+    version_to_sync = gossip_state_version_;
+    auto delta_it = delta_gossip_states_.find(dest.index());
+    if (delta_it != delta_gossip_states_.end() &&
+        delta_it->second.deltas_since_full_sync_ + 1 <
+            static_cast<size_t>(settings_->gossip_full_sync_period)) {
+      full_sync = false;
+      peer_synced_version = delta_it->second.version_synced_;
+    }
+  }
+
   GOSSIP_Message::node_list_t gossip_node_list;
   GOSSIP_Message::versions_node_list_t versions_list;
+  GOSSIP_Message::shard_qos_list_t shard_qos_list;
   if (!skip_sending_versions_) {
     fetchVersions(rsm_version_type_to_send_);
     if (rsm_version_type_to_send_ == RsmVersionType::IN_MEMORY) {
@@ -567,6 +591,13 @@ void FailureDetector::gossip() {
       flags |= GOSSIP_Message::HAS_FAILOVER_LIST_FLAG;
     }
 
+    if (!full_sync && serv_it->first != this_node.index() &&
+        fdnode.state_version_ <= peer_synced_version) {
+      // The peer already got this state from us; leave the node out of the
+      // delta. Its heartbeat counter keeps ticking on the peer on its own.
+      continue;
+    }
+
     GOSSIP_Node gnode;
     gnode.node_id_ = serv_it->first;
     gnode.gossip_ = fdnode.gossip_;
@@ -575,6 +606,7 @@ void FailureDetector::gossip() {
     gnode.is_node_starting_ = fdnode.is_node_starting_;
     gnode.node_status_ = fdnode.status_;
     gossip_node_list.push_back(gnode);
+    shard_qos_list.push_back(fdnode.shard_qos_);
 
     if (flags & GOSSIP_Message::HAS_IN_MEM_VERSIONS ||
         flags & GOSSIP_Message::HAS_DURABLE_SNAPSHOT_VERSIONS) {
@@ -632,7 +664,8 @@ void FailureDetector::gossip() {
                                        flags,
                                        current_msg_id_,
                                        registered_rsms_,
-                                       std::move(versions_list)));
+                                       std::move(versions_list),
+                                       std::move(shard_qos_list)));
 
   if (rv != 0) {
     RATELIMIT_DEBUG(std::chrono::seconds(1),
@@ -640,6 +673,16 @@ void FailureDetector::gossip() {
                     "Failed to send GOSSIP to node %s: %s",
                     Sender::describeConnection(Address(dest)).c_str(),
                     error_description(err));
+  } else if (delta_enabled) {
+    auto& delta_state = delta_gossip_states_[dest.index()];
+    delta_state.version_synced_ = version_to_sync;
+    delta_state.deltas_since_full_sync_ =
+        full_sync ? 0 : delta_state.deltas_since_full_sync_ + 1;
+    if (full_sync) {
+      STAT_INCR(getStats(), gossips_full_sent);
+    } else {
+      STAT_INCR(getStats(), gossips_delta_sent);
+    }
   }
 
   if (shouldDumpState()) {
@@ -827,7 +870,12 @@ void FailureDetector::onGossipReceived(const GOSSIP_Message& msg) {
   bool update_statuses = senderUsingHealthMonitor(sender_idx, msg.node_list_);
   std::unordered_set<size_t> node_ids_to_skip;
   std::unordered_set<size_t> nodes_with_new_instances;
+  // msg.shard_qos_list_ is aligned with msg.node_list_ (and empty when the
+  // sender predates SHARD_QOS_IN_GOSSIP), so keep track of the position of
+  // the current entry.
+  size_t node_pos = 0;
   for (auto node : msg.node_list_) {
+    const size_t pos = node_pos++;
     size_t id = node.node_id_;
 
     // Don't modify this node's state based on gossip message.
@@ -876,6 +924,9 @@ void FailureDetector::onGossipReceived(const GOSSIP_Message& msg) {
         }
         if (update_statuses || id == sender_idx) {
           node_state.status_ = node.node_status_;
+          if (pos < msg.shard_qos_list_.size()) {
+            node_state.shard_qos_ = msg.shard_qos_list_[pos];
+          }
         }
         nodes_[id].status_ = node.node_status_;
         nodes_with_new_instances.insert(id);
@@ -887,6 +938,9 @@ void FailureDetector::onGossipReceived(const GOSSIP_Message& msg) {
       nodes_[id].gossip_ = node.gossip_;
       if (update_statuses || id == sender_idx) {
         nodes_[id].status_ = node.node_status_;
+        if (pos < msg.shard_qos_list_.size()) {
+          nodes_[id].shard_qos_ = msg.shard_qos_list_[pos];
+        }
       }
     }
 
@@ -1308,7 +1362,9 @@ void FailureDetector::updateNodeStatus(node_index_t idx,
                    node.gossip_ts_.count());
   }
   node.status_ = status;
-  getClusterState()->setNodeStatus(idx, status);
+  ClusterState* cs = getClusterState();
+  cs->setNodeStatus(idx, status);
+  cs->setShardQoS(idx, node.shard_qos_);
 }
 
 bool FailureDetector::isValidDestination(node_index_t node_idx) {
@@ -1504,6 +1560,10 @@ void FailureDetector::onGossipMessageSent(Status st,
     if (isAlive(nidx)) {
       STAT_INCR(getStats(), gossips_failed_to_send_to_alive_nodes);
     }
+
+    // We can't tell what the peer actually got; fall back to a full node
+    // list the next time we gossip to it.
+    delta_gossip_states_.erase(nidx);
   }
 
   if (current_msg_id_ != msg_id || msg_id == 0) {
@@ -1546,6 +1606,30 @@ void FailureDetector::onGossipMessageSent(Status st,
   }
 }
 
+void FailureDetector::bumpStateVersions() {
+  for (auto& it : nodes_) {
+    Node& node = it.second;
+    auto& last = node.last_gossiped_;
+    // A higher tick count alone is not worth gossiping about: the peer's own
+    // counter for this node advances at the same rate. A lower one means we
+    // heard from the node (directly or transitively) since the last round.
+    const bool changed = node.gossip_ < last.gossip_ ||
+        node.gossip_ts_ != last.gossip_ts_ ||
+        node.failover_ != last.failover_ ||
+        node.is_node_starting_ != last.is_node_starting_ ||
+        node.status_ != last.status_ || node.shard_qos_ != last.shard_qos_;
+    if (changed) {
+      node.state_version_ = ++gossip_state_version_;
+    }
+    last.gossip_ = node.gossip_;
+    last.gossip_ts_ = node.gossip_ts_;
+    last.failover_ = node.failover_;
+    last.is_node_starting_ = node.is_node_starting_;
+    last.status_ = node.status_;
+    last.shard_qos_ = node.shard_qos_;
+  }
+}
+
 bool FailureDetector::senderUsingHealthMonitor(
     node_index_t sender_idx,
     GOSSIP_Message::node_list_t node_list) {
@@ -15,6 +15,7 @@
 #include <vector>
 
 #include <folly/Optional.h>
+#include <folly/Synchronized.h>
 
 #include "logdevice/common/AdminCommandTable.h"
 #include "logdevice/common/DomainIsolationChecker.h"
@@ -224,6 +225,17 @@ class FailureDetector {
     node_health_status_.store(status, std::memory_order_relaxed);
   }
 
+  /**
+   * Thread safe
+   *
+   * Called by the HealthMonitor with this node's per-shard storage QoS
+   * scores (0-100, 100 = fully healthy), to be disseminated through gossip.
+   * An empty vector means probing is disabled.
+   */
+  void setShardQoS(std::vector<uint8_t> scores) {
+    *self_shard_qos_.wlock() = std::move(scores);
+  }
+
   /** This fetches the new set of nodes and updates nodes_
    *  to reflect the actual nodes configuration.
    */
@@ -318,6 +330,10 @@ class FailureDetector {
     // Health Status of node.
     NodeHealthStatus status_;
 
+    // Per-shard storage QoS scores published by the node through gossip.
+    // Empty if the node doesn't publish any.
+    std::vector<uint8_t> shard_qos_;
+
     // RSM versions for a Node
     std::map<logid_t, lsn_t> rsm_versions_;
     std::map<logid_t, lsn_t> rsm_durable_versions_;
@@ -336,6 +352,22 @@ class FailureDetector {
     // indicated by a setting GOSSIP_Message::LONG_TIME_SINCE_LAST_GOSSIP flag.
     bool stalled_gossip_processor_{false};
 
+    // Version (as per FailureDetector::gossip_state_version_) of the last
+    // meaningful change to this node's wire-visible state. Used to decide
+    // which nodes to include in delta-encoded gossip messages.
+    uint64_t state_version_{0};
+
+    // Snapshot of the wire-visible fields taken when bumpStateVersions()
+    // last examined this node, used to detect changes.
+    struct {
+      uint32_t gossip_{std::numeric_limits<uint32_t>::max()};
+      std::chrono::milliseconds gossip_ts_{std::chrono::milliseconds::zero()};
+      std::chrono::milliseconds failover_{std::chrono::milliseconds::zero()};
+      bool is_node_starting_{false};
+      NodeHealthStatus status_{NodeHealthStatus::UNDEFINED};
+      std::vector<uint8_t> shard_qos_;
+    } last_gossiped_;
+
     Node()
         : state_(NodeState::DEAD),
           blacklisted_(false),
@@ -422,10 +454,30 @@ class FailureDetector {
   std::atomic<NodeHealthStatus> node_health_status_{
       NodeHealthStatus::UNDEFINED};
 
+  // This node's per-shard storage QoS scores, written by the HealthMonitor's
+  // probe thread via setShardQoS() and read on the gossip path.
+  folly::Synchronized<std::vector<uint8_t>> self_shard_qos_;
+
   // keep track of the time of the last gossip tick, which is when
   // the tick counters in Node::gossip_ were last updated
   SteadyTimestamp last_gossip_tick_time_{SteadyTimestamp::min()};
 
+  // Monotonically increasing version of this node's view of the cluster;
+  // bumped by bumpStateVersions() whenever some node's wire-visible state
+  // changes. Only maintained when gossip-delta-encoding is enabled.
+  uint64_t gossip_state_version_{0};
+
+  // Bookkeeping for delta-encoded gossip, per destination node.
+  struct DeltaGossipState {
+    // All state changes up to this version were covered by gossip messages
+    // successfully handed to the messaging layer for this peer.
+    uint64_t version_synced_{0};
+    // Number of delta gossips sent to this peer since the last full node
+    // list; used to schedule periodic full syncs.
+    size_t deltas_since_full_sync_{0};
+  };
+  std::unordered_map<node_index_t, DeltaGossipState> delta_gossip_states_;
+
   // save pointer to the timer so we can explicitly trigger it to force retries
   ExponentialBackoffTimerNode* gossip_timer_node_{nullptr};
 
@@ -525,6 +577,13 @@ class FailureDetector {
   void detectFailures(node_index_t self,
                       const folly::SharedMutex::ReadHolder& nodes_lock);
 
+  // Assigns a fresh version (from gossip_state_version_) to every node whose
+  // wire-visible state changed since the last call. A mere increase of the
+  // heartbeat tick counter doesn't count: the receiving node's own counter
+  // for that node advances at the same rate, so there is nothing to learn.
+  // Called with locked mutex_ when gossip-delta-encoding is enabled.
+  void bumpStateVersions();
+
   // Check if incoming gossip message is more than
   // 'gossip_time_skew_threshold' milli-seconds delayed
   bool checkSkew(const GOSSIP_Message& msg);
@@ -8,11 +8,21 @@
 
 #include "logdevice/server/HealthMonitor.h"
 
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstring>
+
+#include <folly/FileUtil.h>
+#include <folly/Random.h>
 #include <folly/synchronization/Baton.h>
 
+#include "logdevice/common/ThreadID.h"
 #include "logdevice/common/Timestamp.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/chrono_util.h"
+#include "logdevice/common/debug.h"
 #include "logdevice/server/FailureDetector.h"
 
 namespace facebook { namespace logdevice {
@@ -54,6 +64,14 @@ HealthMonitor::HealthMonitor(folly::Executor& executor,
       kNumBuckets, kNumPeriods * sleep_period_};
 }
 
+HealthMonitor::~HealthMonitor() {
+  if (shard_probe_thread_.joinable()) {
+    shutdown_.store(true, std::memory_order_relaxed);
+    shard_probe_cv_.notify_all();
+    shard_probe_thread_.join();
+  }
+}
+
 void HealthMonitor::startUp() {
   auto now = SteadyTimestamp::now();
   folly::Baton baton;
@@ -267,6 +285,7 @@ NodeHealthStats HealthMonitor::getNodeHealthStats() {
 
 folly::SemiFuture<folly::Unit> HealthMonitor::shutdown() {
   shutdown_.exchange(true, std::memory_order_relaxed);
+  shard_probe_cv_.notify_all();
   executor_.add([this]() mutable { sleep_semifuture_.cancel(); });
   return shutdown_promise_.getSemiFuture();
 }
@@ -349,4 +368,149 @@ void HealthMonitor::updateFailureDetectorStatus(NodeHealthStatus status) {
   }
 }
 
+void HealthMonitor::updateFailureDetectorShardQoS(std::vector<uint8_t> scores) {
+  folly::SharedMutex::ReadHolder read_lock(mutex_);
+  if (failure_detector_) {
+    failure_detector_->setShardQoS(std::move(scores));
+  }
+}
+
+void HealthMonitor::startShardProbing(
+    std::vector<std::string> shard_paths,
+    std::chrono::milliseconds probe_period,
+    std::chrono::milliseconds target_latency) {
+  if (shard_paths.empty() || probe_period.count() <= 0) {
+    return;
+  }
+  ld_check(!shard_probe_thread_.joinable());
+  shard_probe_paths_ = std::move(shard_paths);
+  shard_probe_period_ = probe_period;
+  shard_probe_target_latency_ =
+      std::max(target_latency, std::chrono::milliseconds(1));
+  ld_info("Starting shard QoS probing of %lu shard(s), period %lums, "
+          "target latency %lums",
+          shard_probe_paths_.size(),
+          shard_probe_period_.count(),
+          shard_probe_target_latency_.count());
+  shard_probe_thread_ = std::thread([this] { shardProbeLoop(); });
+}
+
+void HealthMonitor::shardProbeLoop() {
+  ThreadID::set(ThreadID::Type::UTILITY, "ld:shard-probe");
+  std::unique_lock<std::mutex> lock(shard_probe_mutex_);
+  while (!shutdown_.load(std::memory_order_relaxed)) {
+    lock.unlock();
+    std::vector<uint8_t> scores(shard_probe_paths_.size(), kShardQoSMax);
+    for (size_t shard = 0; shard < shard_probe_paths_.size(); ++shard) {
+      if (shutdown_.load(std::memory_order_relaxed)) {
+        return;
+      }
+      scores[shard] = probeShard(shard_probe_paths_[shard]);
+      if (scores[shard] < kShardQoSMax) {
+        RATELIMIT_INFO(std::chrono::seconds(10),
+                       1,
+                       "Shard %lu scored %u/%u in QoS probe",
+                       shard,
+                       static_cast<unsigned>(scores[shard]),
+                       static_cast<unsigned>(kShardQoSMax));
+      }
+    }
+    updateFailureDetectorShardQoS(std::move(scores));
+    lock.lock();
+    shard_probe_cv_.wait_for(lock, shard_probe_period_, [this] {
+      return shutdown_.load(std::memory_order_relaxed);
+    });
+  }
+}
+
+uint8_t HealthMonitor::probeShard(const std::string& path) {
+  if (path.empty()) {
+    return kShardQoSMax;
+  }
+  const std::string probe_path = path + "/qos-probe.tmp";
+  // A small probe to capture per-operation (seek/fsync) latency and a larger
+  // one to capture throughput degradation.
+  const std::array<std::pair<size_t, std::chrono::milliseconds>, 2> probes{
+      {{4 * 1024, shard_probe_target_latency_},
+       {1024 * 1024, shard_probe_target_latency_ * kLargeProbeTargetMultiplier}}};
+
+  double worst_ratio = 0;
+  std::string buf;
+  for (const auto& probe : probes) {
+    const size_t size = probe.first;
+    const double target_usec = probe.second.count() * 1000.0;
+
+    // Fill the buffer with pseudo-random bytes so that a compressing or
+    // deduplicating filesystem can't short-circuit the IO.
+    buf.resize(size);
+    uint64_t word = folly::Random::rand64();
+    for (size_t i = 0; i < size; i += sizeof(word)) {
+      memcpy(&buf[i], &word, std::min(sizeof(word), size - i));
+      word = word * 6364136223846793005ULL + 1442695040888963407ULL;
+    }
+
+    int fd = ::open(probe_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+      RATELIMIT_ERROR(std::chrono::seconds(10),
+                      1,
+                      "Failed to create QoS probe file %s: %s",
+                      probe_path.c_str(),
+                      strerror(errno));
+      return 0;
+    }
+    auto start = std::chrono::steady_clock::now();
+    ssize_t written = folly::writeFull(fd, buf.data(), buf.size());
+    int sync_rv = ::fsync(fd);
+    const double write_usec = std::chrono::duration_cast<
+                                  std::chrono::microseconds>(
+                                  std::chrono::steady_clock::now() - start)
+                                  .count();
+    ::close(fd);
+    if (written != static_cast<ssize_t>(size) || sync_rv != 0) {
+      RATELIMIT_ERROR(std::chrono::seconds(10),
+                      1,
+                      "Failed to write QoS probe file %s: %s",
+                      probe_path.c_str(),
+                      strerror(errno));
+      ::unlink(probe_path.c_str());
+      return 0;
+    }
+
+    fd = ::open(probe_path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      ::unlink(probe_path.c_str());
+      return 0;
+    }
+    // Drop the pages we just wrote so that the read actually hits the disk.
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    start = std::chrono::steady_clock::now();
+    ssize_t nread = folly::readFull(fd, &buf[0], size);
+    const double read_usec = std::chrono::duration_cast<
+                                 std::chrono::microseconds>(
+                                 std::chrono::steady_clock::now() - start)
+                                 .count();
+    ::close(fd);
+    if (nread != static_cast<ssize_t>(size)) {
+      RATELIMIT_ERROR(std::chrono::seconds(10),
+                      1,
+                      "Failed to read back QoS probe file %s: %s",
+                      probe_path.c_str(),
+                      strerror(errno));
+      ::unlink(probe_path.c_str());
+      return 0;
+    }
+
+    worst_ratio = std::max(
+        {worst_ratio, write_usec / target_usec, read_usec / target_usec});
+  }
+  ::unlink(probe_path.c_str());
+
+  if (worst_ratio <= 1.0) {
+    return kShardQoSMax;
+  }
+  // Scores degrade inversely with how far the worst measurement overshoots
+  // its target: 2x the target scores 50, 10x scores 10.
+  return static_cast<uint8_t>(kShardQoSMax / worst_ratio);
+}
+
 }} // namespace facebook::logdevice
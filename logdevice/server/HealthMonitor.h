@@ -9,6 +9,10 @@
 
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <vector>
 
 #include <folly/Executor.h>
@@ -35,13 +39,31 @@ class HealthMonitor {
                 std::chrono::milliseconds max_stalls_avg,
                 double max_stalled_worker_percentage,
                 std::chrono::milliseconds max_loop_stall);
-  ~HealthMonitor() {}
+  ~HealthMonitor();
 
   void startUp();
   folly::SemiFuture<folly::Unit> shutdown();
   void setFailureDetector(FailureDetector* failure_detector);
   NodeHealthStats getNodeHealthStats();
 
+  /**
+   * Starts a dedicated thread that periodically issues small timed writes
+   * and reads against each shard's database directory and publishes the
+   * resulting per-shard QoS scores (0-100, 100 = fully healthy) to the
+   * FailureDetector for dissemination through gossip. This catches disks
+   * that are degrading -- long write/fsync latencies, read stalls -- well
+   * before they fail outright. Runs on its own thread because the probes
+   * block on disk IO, which must not delay the monitor loop itself.
+   *
+   * No-op if shard_paths is empty or probe_period is zero. Must be called
+   * at most once. An empty entry in shard_paths (e.g. a shard that failed
+   * to open) is reported as fully healthy; other machinery handles broken
+   * shards.
+   */
+  void startShardProbing(std::vector<std::string> shard_paths,
+                         std::chrono::milliseconds probe_period,
+                         std::chrono::milliseconds target_latency);
+
   // reporter methods
   void reportWatchdogHealth(bool delayed);
   void reportStalledWorkers(int num_stalled);
@@ -72,6 +94,7 @@ class HealthMonitor {
   void updateVariables(TimePoint now);
   void calculateNegativeSignal(TimePoint now, NodeHealthStats& stats);
   void updateFailureDetectorStatus(NodeHealthStatus status);
+  void updateFailureDetectorShardQoS(std::vector<uint8_t> scores);
   NodeHealthStats calculateGlobalNodeHealthStats();
   void updateNodeHealthStats(NodeHealthStats stats);
   WorkerTimeSeriesStats createWorkerTimeSeriesStats(int worker_id,
@@ -103,6 +126,26 @@ class HealthMonitor {
 
   void removeFailureDetector();
 
+  // Fully healthy per-shard QoS score; see ClusterState::SHARD_QOS_MAX.
+  static constexpr uint8_t kShardQoSMax = 100;
+  // The large probe is expected to take proportionally longer than the
+  // small one; its latency target is scaled by this factor.
+  static constexpr int kLargeProbeTargetMultiplier = 4;
+
+  // Body of shard_probe_thread_: probes all shards, publishes the scores
+  // and sleeps for shard_probe_period_, until shutdown.
+  void shardProbeLoop();
+  // Issues one round of timed writes and reads against the shard's
+  // database directory. Returns a score in [0, kShardQoSMax].
+  uint8_t probeShard(const std::string& path);
+
+  std::vector<std::string> shard_probe_paths_;
+  std::chrono::milliseconds shard_probe_period_{0};
+  std::chrono::milliseconds shard_probe_target_latency_{0};
+  std::mutex shard_probe_mutex_;
+  std::condition_variable shard_probe_cv_;
+  std::thread shard_probe_thread_;
+
   using AlertSeries =
       folly::BucketedTimeSeries<uint8_t, std::chrono::steady_clock>;
 
@@ -55,6 +55,14 @@ void RecordCacheDisposal::onRecordsReleased(const EpochRecordCache& cache,
                                             const ReleasedVector& entries) {
   auto processor = owner_->getProcessor();
   ld_check(processor);
+
+  // If the compressed second tier is enabled, stash the evicted range there
+  // so that slightly-behind readers can still be served from memory.
+  if (CompressedRecordTier* tier =
+          owner_->getCompressedRecordTier(cache.getShardIndex())) {
+    tier->put(cache.getLogId(), begin, end, entries);
+  }
+
   if (!processor->settings()->real_time_reads_enabled) {
     return;
   }
@@ -9,6 +9,7 @@
 
 #include "logdevice/common/RecordID.h"
 #include "logdevice/common/Request.h"
+#include "logdevice/common/RequestPool.h"
 #include "logdevice/common/RequestType.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/common/types_internal.h"
@@ -28,7 +29,7 @@ enum class ReleaseType : uint8_t;
  * store and sends it to clients reading from the log.
  */
 
-class ReleaseRequest : public Request {
+class ReleaseRequest : public Request, public PooledRequest<ReleaseRequest> {
  public:
   /**
    * @param target        worker thread that should process this request
@@ -15,6 +15,7 @@
 #include "logdevice/admin/maintenance/ClusterMaintenanceStateMachine.h"
 #include "logdevice/admin/maintenance/MaintenanceManager.h"
 #include "logdevice/admin/settings/AdminServerSettings.h"
+#include "logdevice/common/BufferedTraceLogger.h"
 #include "logdevice/common/ConfigInit.h"
 #include "logdevice/common/ConnectionKind.h"
 #include "logdevice/common/ConstructorFailed.h"
@@ -56,10 +57,12 @@
 #include "logdevice/server/RsmServerSnapshotStoreFactory.h"
 #include "logdevice/server/ServerProcessor.h"
 #include "logdevice/server/UnreleasedRecordDetector.h"
+#include "logdevice/server/WarmStandbySequencerPlacement.h"
 #include "logdevice/server/epoch_store/FileEpochStore.h"
 #include "logdevice/server/epoch_store/ZookeeperEpochStore.h"
 #include "logdevice/server/fatalsignal.h"
 #include "logdevice/server/locallogstore/ClusterMarkerChecker.h"
+#include "logdevice/server/locallogstore/PartitionedRocksDBStore.h"
 #include "logdevice/server/locallogstore/RocksDBMetricsExport.h"
 #include "logdevice/server/locallogstore/ShardedRocksDBLocalLogStore.h"
 #include "logdevice/server/rebuilding/RebuildingCoordinator.h"
@@ -529,6 +532,14 @@ void ServerParameters::init() {
         std::make_shared<NoopTraceLogger>(updateable_config_, my_node_id_);
   } else {
     trace_logger_ = (*trace_logger_factory)(updateable_config_, my_node_id_);
+    if (processor_settings_->trace_logger_queue_size > 0) {
+      trace_logger_ = std::make_shared<BufferedTraceLogger>(
+          std::move(trace_logger_),
+          updateable_config_,
+          my_node_id_,
+          processor_settings_->trace_logger_queue_size,
+          &server_stats_);
+    }
   }
 
   storage_node_ = nodes_configuration->isStorageNode(my_node_id_->index());
@@ -967,6 +978,30 @@ bool Server::initStore() {
       }
       auto& io_fault_injection = IOFaultInjection::instance();
       io_fault_injection.init(sharded_store_->numShards());
+
+      if (params_->getRocksDBSettings()->cache_warmup_enabled_) {
+        // Prime block cache and page cache with the data that was hot before
+        // the restart. This runs before the failure detector starts
+        // gossiping, so by the time the node is reported alive to the rest
+        // of the cluster its caches are warm.
+        std::vector<std::future<void>> futures;
+        for (shard_index_t shard = 0; shard < sharded_store_->numShards();
+             ++shard) {
+          auto store = dynamic_cast<PartitionedRocksDBStore*>(
+              sharded_store_->getByIndex(shard));
+          if (store == nullptr) {
+            continue;
+          }
+          futures.push_back(std::async(std::launch::async, [shard, store] {
+            ThreadID::set(
+                ThreadID::UTILITY, folly::sformat("ld:warmup{}", shard));
+            store->warmUpCaches();
+          }));
+        }
+        for (auto& f : futures) {
+          f.get();
+        }
+      }
     } catch (const ConstructorFailed& ex) {
       ld_critical("Failed to initialize local log store");
       return false;
@@ -1044,6 +1079,7 @@ bool Server::initLogStorageStateMap() {
       nshards,
       params_->getStats(),
       params_->getProcessorSettings()->enable_record_cache,
+      params_->getProcessorSettings()->record_cache_compressed_tier_size,
       params_->getProcessorSettings()->log_state_recovery_interval);
 
   /*
@@ -1182,6 +1218,26 @@ bool Server::initFailureDetector() {
       if (processor_->getHealthMonitor()) {
         processor_->getHealthMonitor()->setFailureDetector(
             processor_->failure_detector_.get());
+        auto settings = params_->getProcessorSettings().get();
+        if (sharded_store_ &&
+            settings->health_monitor_shard_probe_interval_ms.count() > 0) {
+          // Hand the health monitor the filesystem path of every shard so
+          // it can probe the disks and publish per-shard QoS scores through
+          // gossip.
+          std::vector<std::string> shard_paths(sharded_store_->numShards());
+          for (shard_index_t shard = 0; shard < sharded_store_->numShards();
+               ++shard) {
+            auto* store = dynamic_cast<RocksDBLogStoreBase*>(
+                sharded_store_->getByIndex(shard));
+            if (store != nullptr) {
+              shard_paths[shard] = store->getLocalDBPath().value_or("");
+            }
+          }
+          processor_->getHealthMonitor()->startShardProbing(
+              std::move(shard_paths),
+              settings->health_monitor_shard_probe_interval_ms,
+              settings->health_monitor_shard_probe_target_latency_ms);
+        }
       }
     } catch (const ConstructorFailed&) {
       ld_error(
@@ -1400,6 +1456,12 @@ bool Server::initSequencerPlacement() {
               processor_.get(), params_->getGossipSettings());
           break;
 
+        case SequencerOptions::WARM_STANDBY:
+          ld_info("using SequencerOptions::WARM_STANDBY");
+          placement_ptr = std::make_shared<WarmStandbySequencerPlacement>(
+              processor_.get(), params_->getGossipSettings());
+          break;
+
         case SequencerOptions::NONE:
           ld_check(false);
           break;
@@ -13,6 +13,7 @@
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/protocol/CLEAN_Message.h"
 #include "logdevice/common/protocol/MessageTypeNames.h"
+#include "logdevice/common/protocol/RECORD_BATCH_Message.h"
 #include "logdevice/common/protocol/RELEASE_Message.h"
 #include "logdevice/common/protocol/STOP_Message.h"
 #include "logdevice/common/protocol/STORE_Message.h"
@@ -34,8 +35,10 @@
 #include "logdevice/server/message_handlers/FINDKEY_onReceived.h"
 #include "logdevice/server/message_handlers/GET_EPOCH_RECOVERY_METADATA_REPLY_onReceived.h"
 #include "logdevice/server/message_handlers/GET_EPOCH_RECOVERY_METADATA_onReceived.h"
+#include "logdevice/server/message_handlers/GET_ESN_DIGEST_onReceived.h"
 #include "logdevice/server/message_handlers/GET_HEAD_ATTRIBUTES_onReceived.h"
 #include "logdevice/server/message_handlers/GET_RSM_SNAPSHOT_onReceived.h"
+#include "logdevice/server/message_handlers/GET_TAIL_RECORDS_onReceived.h"
 #include "logdevice/server/message_handlers/GET_TRIM_POINT_onReceived.h"
 #include "logdevice/server/message_handlers/GOSSIP_onReceived.h"
 #include "logdevice/server/message_handlers/LOGS_CONFIG_API_onReceived.h"
@@ -158,6 +161,10 @@ Message::Disposition ServerMessageDispatch::onReceivedHandler(
           checked_downcast<GET_EPOCH_RECOVERY_METADATA_REPLY_Message*>(msg),
           from);
 
+    case MessageType::GET_ESN_DIGEST:
+      return GET_ESN_DIGEST_onReceived(
+          checked_downcast<GET_ESN_DIGEST_Message*>(msg), from);
+
     case MessageType::GET_HEAD_ATTRIBUTES:
       return GET_HEAD_ATTRIBUTES_onReceived(
           checked_downcast<GET_HEAD_ATTRIBUTES_Message*>(msg), from);
@@ -166,6 +173,10 @@ Message::Disposition ServerMessageDispatch::onReceivedHandler(
       return GET_RSM_SNAPSHOT_onReceived(
           checked_downcast<GET_RSM_SNAPSHOT_Message*>(msg), from);
 
+    case MessageType::GET_TAIL_RECORDS:
+      return GET_TAIL_RECORDS_onReceived(
+          checked_downcast<GET_TAIL_RECORDS_Message*>(msg), from);
+
     case MessageType::GET_TRIM_POINT:
       return GET_TRIM_POINT_onReceived(
           checked_downcast<GET_TRIM_POINT_Message*>(msg), from);
@@ -275,6 +286,16 @@ void ServerMessageDispatch::onSentImpl(const Message& msg,
       return RECORD_onSent(
           checked_downcast<const RECORD_Message&>(msg), st, to, enqueue_time);
 
+    case MessageType::RECORD_BATCH: {
+      // Fan the batch out so each record gets the same per-record stats and
+      // CatchupQueue accounting as a standalone RECORD.
+      const auto& batch = checked_downcast<const RECORD_BATCH_Message&>(msg);
+      for (const auto& rec : batch.records_) {
+        RECORD_onSent(*rec, st, to, enqueue_time);
+      }
+      return;
+    }
+
     case MessageType::SHARD_STATUS_UPDATE:
       return ServerWorker::onThisThread()
           ->serverReadStreams()
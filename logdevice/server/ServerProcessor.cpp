@@ -42,6 +42,7 @@ void ServerProcessor::fixupLogStorageStateMap() {
         num_shards,
         stats_,
         updateableSettings()->enable_record_cache,
+        updateableSettings()->record_cache_compressed_tier_size,
         updateableSettings()->log_state_recovery_interval);
   }
   log_storage_state_map_->setProcessor(this);
@@ -0,0 +1,183 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <folly/Range.h>
+#include <folly/small_vector.h>
+
+#include "logdevice/common/RecordFilterExpression.h"
+#include "logdevice/common/ServerRecordFilter.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file ServerRecordExpressionFilter evaluates a compiled filter
+ *       expression (see RecordFilterExpression.h) against each record's
+ *       FILTERABLE key during the storage scan, so consumers that discard
+ *       most records by key don't pay network delivery for them. The
+ *       bytecode is decoded once at construction; per-record evaluation
+ *       is a walk over the decoded instructions with a small bool stack.
+ *       It will be created by ServerRecordFilterFactory and owned by
+ *       ServerReadStream. Experimental feature: Use with caution.
+ */
+
+class ServerRecordExpressionFilter final : public ServerRecordFilter {
+ public:
+  /**
+   * @param program   serialized bytecode built by
+   *                  RecordFilterExpressionBuilder. If the program is
+   *                  malformed, valid() returns false and the factory
+   *                  rejects the filter.
+   */
+  explicit ServerRecordExpressionFilter(folly::StringPiece program) {
+    valid_ = decode(program);
+  }
+
+  bool valid() const {
+    return valid_;
+  }
+
+  /**
+   * @param record_key   key of record you wish to be filtered
+   * @return             whether the record passes the expression
+   */
+  bool operator()(folly::StringPiece record_key) override {
+    folly::small_vector<bool, 8> stack;
+    for (const Instruction& insn : instructions_) {
+      switch (insn.op) {
+        case RecordFilterOp::KEY_EQ:
+          stack.push_back(record_key == insn.operand);
+          break;
+        case RecordFilterOp::KEY_LT:
+          stack.push_back(record_key < insn.operand);
+          break;
+        case RecordFilterOp::KEY_LE:
+          stack.push_back(record_key <= insn.operand);
+          break;
+        case RecordFilterOp::KEY_GT:
+          stack.push_back(record_key > insn.operand);
+          break;
+        case RecordFilterOp::KEY_GE:
+          stack.push_back(record_key >= insn.operand);
+          break;
+        case RecordFilterOp::KEY_PREFIX:
+          stack.push_back(record_key.startsWith(insn.operand));
+          break;
+        case RecordFilterOp::BYTE_EQ:
+          stack.push_back(record_key.size() > insn.offset &&
+                          static_cast<uint8_t>(record_key[insn.offset]) ==
+                              insn.value);
+          break;
+        case RecordFilterOp::AND: {
+          bool rhs = stack.back();
+          stack.pop_back();
+          stack.back() = stack.back() && rhs;
+          break;
+        }
+        case RecordFilterOp::OR: {
+          bool rhs = stack.back();
+          stack.pop_back();
+          stack.back() = stack.back() || rhs;
+          break;
+        }
+        case RecordFilterOp::NOT:
+          stack.back() = !stack.back();
+          break;
+        case RecordFilterOp::MAX:
+          break;
+      }
+    }
+    // decode() guarantees a valid program leaves exactly one value.
+    return stack.size() == 1 && stack.back();
+  }
+
+  /**
+   * @return   A human-readable string which describes this server-side
+   *           filter.
+   */
+  std::string toString() const override {
+    std::stringstream ss;
+    ss << "Server-side filter type: EXPRESSION, " << instructions_.size()
+       << " instruction(s)";
+    return ss.str();
+  }
+
+ private:
+  struct Instruction {
+    RecordFilterOp op;
+    std::string operand; // string comparison ops
+    uint16_t offset{0};  // BYTE_EQ
+    uint8_t value{0};    // BYTE_EQ
+  };
+
+  // Decodes and validates the program: every operand must be in bounds
+  // and the stack must end with exactly one value.
+  bool decode(folly::StringPiece program) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(program.data());
+    const uint8_t* end = p + program.size();
+    size_t stack_depth = 0;
+    while (p < end) {
+      Instruction insn;
+      insn.op = static_cast<RecordFilterOp>(*p++);
+      switch (insn.op) {
+        case RecordFilterOp::KEY_EQ:
+        case RecordFilterOp::KEY_LT:
+        case RecordFilterOp::KEY_LE:
+        case RecordFilterOp::KEY_GT:
+        case RecordFilterOp::KEY_GE:
+        case RecordFilterOp::KEY_PREFIX: {
+          if (end - p < 2) {
+            return false;
+          }
+          const uint16_t len = p[0] | (p[1] << 8);
+          p += 2;
+          if (end - p < len) {
+            return false;
+          }
+          insn.operand.assign(reinterpret_cast<const char*>(p), len);
+          p += len;
+          ++stack_depth;
+          break;
+        }
+        case RecordFilterOp::BYTE_EQ:
+          if (end - p < 3) {
+            return false;
+          }
+          insn.offset = p[0] | (p[1] << 8);
+          insn.value = p[2];
+          p += 3;
+          ++stack_depth;
+          break;
+        case RecordFilterOp::AND:
+        case RecordFilterOp::OR:
+          if (stack_depth < 2) {
+            return false;
+          }
+          --stack_depth;
+          break;
+        case RecordFilterOp::NOT:
+          if (stack_depth < 1) {
+            return false;
+          }
+          break;
+        default:
+          return false;
+      }
+      instructions_.push_back(std::move(insn));
+    }
+    return stack_depth == 1;
+  }
+
+  std::vector<Instruction> instructions_;
+  bool valid_{false};
+};
+}} // namespace facebook::logdevice
@@ -16,6 +16,7 @@
 #include "logdevice/common/ServerRecordFilter.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/server/ServerRecordEqualityFilter.h"
+#include "logdevice/server/ServerRecordExpressionFilter.h"
 #include "logdevice/server/ServerRecordRangeFilter.h"
 
 namespace facebook { namespace logdevice {
@@ -52,6 +53,16 @@ class ServerRecordFilterFactory {
           return nullptr;
         }
         return std::make_unique<ServerRecordRangeFilter>(key1, key2);
+      case ServerRecordFilterType::EXPRESSION: {
+        auto filter = std::make_unique<ServerRecordExpressionFilter>(key1);
+        if (!filter->valid()) {
+          ld_error("ServerRecordExpressionFilter failed to construct: "
+                   "malformed filter expression bytecode (%zu bytes)",
+                   key1.size());
+          return nullptr;
+        }
+        return filter;
+      }
       case ServerRecordFilterType::NOFILTER:
         return nullptr;
       default:
@@ -75,12 +75,14 @@ static SequencerOptions validate_sequencers(const std::string& value) {
     return SequencerOptions::ALL;
   } else if (value == "lazy") {
     return SequencerOptions::LAZY;
+  } else if (value == "warm-standby") {
+    return SequencerOptions::WARM_STANDBY;
   } else if (value == "none") {
     return SequencerOptions::NONE;
   } else {
     throw boost::program_options::error("Invalid value for -S: " + value +
                                         ". Expected one of 'all', "
-                                        "'lazy'.");
+                                        "'lazy', 'warm-standby'.");
   }
 }
 
@@ -438,7 +440,9 @@ void ServerSettings::defineSettings(SettingEasyInit& init) {
 
     ("sequencers", &sequencer, "lazy", validate_sequencers,
      "one of the following: all (run sequencers for all logs), "
-     "lazy (bring them up as needed). Deprecated, do not use.",
+     "lazy (bring them up as needed), warm-standby (bring up sequencers at "
+     "startup for logs this node is the primary or secondary sequencer node "
+     "for, lazily for everything else). Deprecated, do not use.",
      SERVER | REQUIRES_RESTART | DEPRECATED)
 
     ("server-id", &server_id, "", nullptr,
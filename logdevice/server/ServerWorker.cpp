@@ -204,6 +204,7 @@ void ServerWorker::initSSLFetcher() {
                                setting.ssl_ca_path,
                                server_settings->use_tls_ticket_seeds,
                                server_settings->tls_ticket_seeds_path,
+                               setting.ssl_enable_ktls,
                                stats());
 }
 
@@ -61,6 +61,8 @@ Message::Disposition StoreStateMachine::onReceived(STORE_Message* msg,
           Sender::describeConnection(from).c_str(),
           STORE_Message::flagsToString(msg->header_.flags).c_str());
 
+  Worker::attributeActiveCpuToLog(msg->header_.rid.logid);
+
   ServerWorker* worker = ServerWorker::onThisThread();
   NodeID my_node_id = worker->processor_->getMyNodeID();
   auto start_time = std::chrono::steady_clock::now();
@@ -651,7 +653,8 @@ void StoreStateMachine::storeAndForward() {
       durability_,
       worker_settings.write_find_time_index,
       merge_mutable_per_epoch_log_metadata,
-      worker_settings.write_shard_id_in_copyset);
+      worker_settings.write_shard_id_in_copyset,
+      &message_->optional_keys_serialized_);
 
   // Forward to next node in chain
   if (header.flags & STORE_Header::CHAIN) {
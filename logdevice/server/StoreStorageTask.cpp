@@ -7,6 +7,7 @@
  */
 #include "logdevice/server/StoreStorageTask.h"
 
+#include <chrono>
 #include <initializer_list>
 
 #include <folly/Format.h>
@@ -43,7 +44,8 @@ StoreStorageTask::StoreStorageTask(
     Durability durability,
     bool write_find_time_index,
     bool merge_mutable_per_epoch_log_metadata,
-    bool write_shard_id_in_copyset)
+    bool write_shard_id_in_copyset,
+    const std::string* optional_keys_serialized)
     : WriteStorageTask(StorageTask::Type::STORE),
       payload_holder_(payload_holder),
       timestamp_(store_header.timestamp),
@@ -67,7 +69,8 @@ StoreStorageTask::StoreStorageTask(
                                                       &record_header_buf_,
                                                       write_shard_id_in_copyset,
                                                       optional_keys,
-                                                      extra_),
+                                                      extra_,
+                                                      optional_keys_serialized),
           Slice(payload_holder_.getPayload()),
           rebuilding_ ? copyset[0].destination.node()
                       : (store_header.sequencer_node_id.isNodeID()
@@ -251,6 +254,23 @@ void StoreStorageTask::onDone() {
   } else {
     PER_SHARD_HISTOGRAM_ADD(
         Worker::stats(), store_latency, getShardIdx(), usec_since(start_time_));
+
+    if (status_ == E::OK && !recovery_) {
+      // Sequencer stamp to durable on this shard; the write half of
+      // end-to-end write visibility. Clock skew can make this negative.
+      const int64_t visibility_usec =
+          (std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+               .count() -
+           int64_t(timestamp_)) *
+          1000;
+      if (visibility_usec >= 0) {
+        PER_SHARD_HISTOGRAM_ADD(Worker::stats(),
+                                write_to_durable_latency,
+                                getShardIdx(),
+                                visibility_usec);
+      }
+    }
   }
 
   sendReply(status_);
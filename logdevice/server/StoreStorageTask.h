@@ -55,7 +55,8 @@ class StoreStorageTask : public WriteStorageTask {
                    Durability durability,
                    bool write_find_time_index,
                    bool merge_mutable_per_epoch_log_metadata,
-                   bool write_shard_id_in_copyset);
+                   bool write_shard_id_in_copyset,
+                   const std::string* optional_keys_serialized = nullptr);
 
   ~StoreStorageTask() override;
 
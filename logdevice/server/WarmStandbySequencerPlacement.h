@@ -0,0 +1,148 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <chrono>
+
+#include "logdevice/common/AllSequencers.h"
+#include "logdevice/common/HashBasedSequencerLocator.h"
+#include "logdevice/common/configuration/LocalLogsConfig.h"
+#include "logdevice/common/settings/GossipSettings.h"
+#include "logdevice/server/FailureDetector.h"
+#include "logdevice/server/ServerProcessor.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file WarmStandbySequencerPlacement is a middle ground between
+ *       StaticSequencerPlacement (every node activates sequencers for every
+ *       log) and LazySequencerPlacement (sequencers are only brought up by
+ *       the first APPEND that reaches them).
+ *
+ *       At startup, this node activates sequencers for all logs for which it
+ *       is the primary or the secondary sequencer node according to
+ *       HashBasedSequencerLocator. When the primary fails, clients rehash to
+ *       the secondary, which already holds an active Sequencer with a
+ *       provisioned epoch; the first append after failover does not have to
+ *       pay the epoch store round trip that lazy placement would incur.
+ *       Epoch store load at startup stays proportional to 2/num-sequencer
+ *       -nodes of the log set instead of the full set as with static
+ *       placement.
+ *
+ *       Logs whose activation fails here simply fall back to lazy,
+ *       append-driven activation.
+ */
+
+class WarmStandbySequencerPlacement : public SequencerPlacement {
+ public:
+  WarmStandbySequencerPlacement(Processor* processor,
+                                UpdateableSettings<GossipSettings> settings)
+      : failure_detector_(checked_downcast<ServerProcessor*>(processor)
+                              ->failure_detector_.get()),
+        settings_(std::move(settings)) {
+    if (failure_detector_ == nullptr) {
+      ld_error("Failure detector not initialized");
+      throw ConstructorFailed();
+    }
+
+    auto start_time = std::chrono::steady_clock::now();
+    const node_index_t my_idx = processor->getMyNodeID().index();
+    const bool use_affinity = processor->settings()->use_sequencer_affinity;
+
+    std::shared_ptr<Configuration> cfg = processor->config_->get();
+    std::shared_ptr<configuration::LocalLogsConfig> logs_config =
+        cfg->localLogsConfig();
+    const auto nodes_configuration = processor->getNodesConfiguration();
+
+    // Mutable copy of the sequencers config used to exclude the primary
+    // node when hashing for the secondary; the documented blacklisting
+    // mechanism is setting a node's weight to zero.
+    auto no_primary = std::make_shared<configuration::SequencersConfig>(
+        nodes_configuration->getSequencersConfig());
+
+    size_t n_activated = 0;
+    size_t n_failed = 0;
+    for (auto it = logs_config->logsBegin(); it != logs_config->logsEnd();
+         ++it) {
+      logid_t logid(it->first);
+      const logsconfig::LogAttributes* log_attrs =
+          use_affinity ? &it->second.log_group->attrs() : nullptr;
+
+      node_index_t primary = HashBasedSequencerLocator::getPrimarySequencerNode(
+          logid, *nodes_configuration, log_attrs);
+
+      bool standby_here = false;
+      if (primary != my_idx && primary < no_primary->weights.size()) {
+        double saved_weight = no_primary->weights[primary];
+        no_primary->weights[primary] = 0;
+        NodeID secondary;
+        int rv = HashBasedSequencerLocator::locateSequencer(
+            logid,
+            nodes_configuration.get(),
+            log_attrs,
+            /* cs */ nullptr,
+            /* use_health_based_hashing */ false,
+            &secondary,
+            no_primary);
+        no_primary->weights[primary] = saved_weight;
+        standby_here = rv == 0 && secondary.index() == my_idx;
+      }
+
+      if (primary != my_idx && !standby_here) {
+        continue;
+      }
+
+      // Can't verify with metadata log since this is done before listeners
+      // are started; allow provisioning log to epoch store if it's found
+      // empty.
+      int rv = processor->allSequencers().activateSequencerIfNotActive(
+          logid,
+          "warm standby placement",
+          /*check_metadata_log_before_provisioning=*/false);
+      if (rv == 0 || err == E::EXISTS || err == E::INPROGRESS) {
+        n_activated++;
+      } else {
+        n_failed++;
+        RATELIMIT_WARNING(std::chrono::seconds(10),
+                          10,
+                          "Failed to pre-activate a sequencer for log %lu: "
+                          "%s. The log will fall back to lazy activation.",
+                          logid.val_,
+                          error_name(err));
+      }
+    }
+
+    auto end_time = std::chrono::steady_clock::now();
+    ld_info("Pre-activated sequencers for %zu logs (%zu failed) where this "
+            "node is the primary or secondary sequencer, in %.3fs.",
+            n_activated,
+            n_failed,
+            std::chrono::duration_cast<std::chrono::duration<double>>(
+                end_time - start_time)
+                .count());
+  }
+
+  void requestFailover() override {
+    // Initiate shard failover and allow the request to be propagated to other
+    // nodes. In the meantime, this node can still process appends that get sent
+    // its way.
+    failure_detector_->failover();
+    auto wait_time = settings_->failover_wait_time;
+    if (wait_time.count() > 0) {
+      ld_info("Failover initiated, waiting %lu ms", wait_time.count());
+      /* sleep override */
+      std::this_thread::sleep_for(wait_time);
+    }
+  }
+
+ private:
+  FailureDetector* failure_detector_;
+  UpdateableSettings<GossipSettings> settings_;
+};
+
+}} // namespace facebook::logdevice
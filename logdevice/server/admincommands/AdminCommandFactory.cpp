@@ -37,6 +37,7 @@
 #include "logdevice/server/admincommands/InfoLogsConfigRsm.h"
 #include "logdevice/server/admincommands/InfoLogsDBMetadata.h"
 #include "logdevice/server/admincommands/InfoPartitions.h"
+#include "logdevice/server/admincommands/InfoPrincipalShaping.h"
 #include "logdevice/server/admincommands/InfoPurges.h"
 #include "logdevice/server/admincommands/InfoReaders.h"
 #include "logdevice/server/admincommands/InfoRebuildings.h"
@@ -54,6 +55,7 @@
 #include "logdevice/server/admincommands/InfoStorageTasks.h"
 #include "logdevice/server/admincommands/InfoStoredLogs.h"
 #include "logdevice/server/admincommands/InfoSyncSequencerRequests.h"
+#include "logdevice/server/admincommands/InfoWorkerMaps.h"
 #include "logdevice/server/admincommands/InfoWriteMetaDataRecord.h"
 #include "logdevice/server/admincommands/InjectShardFault.h"
 #include "logdevice/server/admincommands/ListOrEraseMetadata.h"
@@ -64,6 +66,7 @@
 #include "logdevice/server/admincommands/PrintLogsDBDirectories.h"
 #include "logdevice/server/admincommands/RSMTrim.h"
 #include "logdevice/server/admincommands/RSMWriteSnapshot.h"
+#include "logdevice/server/admincommands/ReadOnlyMode.h"
 #include "logdevice/server/admincommands/Rebuilding.h"
 #include "logdevice/server/admincommands/Record.h"
 #include "logdevice/server/admincommands/Setting.h"
@@ -73,6 +76,7 @@
 #include "logdevice/server/admincommands/StatsJemalloc.h"
 #include "logdevice/server/admincommands/StatsRocks.h"
 #include "logdevice/server/admincommands/StatsThroughput.h"
+#include "logdevice/server/admincommands/StatsWorkerCpu.h"
 #include "logdevice/server/admincommands/Stop.h"
 #include "logdevice/server/admincommands/StoreTimeouts.h"
 #include "logdevice/server/admincommands/TrafficShaping.h"
@@ -117,9 +121,11 @@ AdminCommandFactory::AdminCommandFactory() {
   selector_.add<commands::InfoPurges>("info purges");
   selector_.add<commands::InfoRecord>("info record");
   selector_.add<commands::InfoPartitions>("info partitions");
+  selector_.add<commands::InfoPrincipalShaping>("info principal_shaping");
   selector_.add<commands::InfoLogsDBMetadata>("info logsdb metadata");
   selector_.add<commands::InfoWriteMetaDataRecord>(
       "info write_metadata_record");
+  selector_.add<commands::InfoWorkerMaps>("info worker_maps");
   selector_.add<commands::InfoRsm>("info rsm");
   selector_.add<commands::ListOrEraseMetadata>("info metadata",
                                                /* erase */ false);
@@ -166,6 +172,7 @@ AdminCommandFactory::AdminCommandFactory() {
   selector_.add<commands::StoreTimeoutHistogram>("stats2 store_timeouts");
 
   selector_.add<commands::StatsThroughput>("stats throughput");
+  selector_.add<commands::StatsWorkerCpu>("stats worker_cpu");
   selector_.add<commands::StatsCustomCounters>("stats custom counters");
 
 #ifdef LOGDEVICE_USING_JEMALLOC
@@ -232,6 +239,8 @@ AdminCommandFactory::AdminCommandFactory() {
       "create_checkpoint", Restriction::LOCALHOST_ONLY);
 
   selector_.add<commands::Failsafe>("failsafe", Restriction::LOCALHOST_ONLY);
+  selector_.add<commands::ReadOnlyMode>(
+      "read_only", Restriction::LOCALHOST_ONLY);
 
   selector_.add<commands::SettingSet>("set", Restriction::LOCALHOST_ONLY);
   selector_.add<commands::SettingUnset>("unset", Restriction::LOCALHOST_ONLY);
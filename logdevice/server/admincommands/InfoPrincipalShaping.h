@@ -0,0 +1,83 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include "logdevice/common/AdminCommandTable.h"
+#include "logdevice/common/PrincipalThrottle.h"
+#include "logdevice/common/Processor.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/request_util.h"
+#include "logdevice/server/admincommands/AdminCommand.h"
+
+namespace facebook { namespace logdevice { namespace commands {
+
+class InfoPrincipalShaping : public AdminCommand {
+  using AdminCommand::AdminCommand;
+
+ private:
+  bool json_ = false;
+
+ public:
+  using ShapingTable = AdminCommandTable<int,         /* Worker */
+                                         std::string, /* Principal */
+                                         bool,        /* Read limited */
+                                         uint64_t,    /* Read bytes */
+                                         uint64_t,    /* Read deferrals */
+                                         bool,        /* Append limited */
+                                         uint64_t,    /* Append bytes */
+                                         uint64_t     /* Append rejections */
+                                         >;
+
+  void getOptions(boost::program_options::options_description& opts) override {
+    opts.add_options()("json", boost::program_options::bool_switch(&json_));
+  }
+
+  void getPositionalOptions(
+      boost::program_options::positional_options_description& /*opts*/)
+      override {}
+
+  std::string getUsage() override {
+    return "info principal_shaping [--json]";
+  }
+
+  void run() override {
+    auto get_consumption = []() {
+      return Worker::onThisThread()->principalThrottle().getConsumption();
+    };
+
+    const auto& results = run_on_worker_pool(
+        server_->getProcessor(), WorkerType::GENERAL, get_consumption);
+
+    ShapingTable table(!json_,
+                       "Worker",
+                       "Principal",
+                       "Read Limited",
+                       "Read Bytes",
+                       "Read Deferrals",
+                       "Append Limited",
+                       "Append Bytes",
+                       "Append Rejections");
+    for (int i = 0; i < results.size(); ++i) {
+      for (const auto& c : results[i]) {
+        table.next()
+            .set<0>(i)
+            .set<1>(c.principal)
+            .set<2>(c.read_limited)
+            .set<3>(c.read_bytes)
+            .set<4>(c.read_deferrals)
+            .set<5>(c.append_limited)
+            .set<6>(c.append_bytes)
+            .set<7>(c.append_rejections);
+      }
+    }
+
+    json_ ? table.printJson(out_) : table.print(out_);
+  }
+};
+
+}}} // namespace facebook::logdevice::commands
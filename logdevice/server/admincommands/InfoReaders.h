@@ -116,7 +116,7 @@ class InfoReaders : public AdminCommand {
                            "RSID",
                            "TCP sndbuf");
 
-    auto tables = run_on_all_workers(server_->getProcessor(), [&]() {
+    auto fill = [&]() {
       InfoReadersTable t(table);
       ServerWorker* w = ServerWorker::onThisThread();
       if (type_ == "log") {
@@ -128,13 +128,36 @@ class InfoReaders : public AdminCommand {
         w->serverReadStreams().getReadStreamsDebugInfo(t);
       }
       return t;
-    });
+    };
+
+    if (json_) {
+      // Stream the table one worker at a time: each chunk's rows are printed
+      // and freed before the next worker is queried, so peak memory is
+      // bounded by the largest single worker's chunk instead of all read
+      // streams on the node at once.
+      table.printJsonHeader(out_);
+      bool first_row = true;
+      for (int t = 0; t < numOfWorkerTypes(); ++t) {
+        WorkerType worker_type = workerTypeByIndex(t);
+        const int nworkers =
+            server_->getProcessor()->getWorkerCount(worker_type);
+        for (int i = 0; i < nworkers; ++i) {
+          auto chunk =
+              run_on_worker(server_->getProcessor(), i, worker_type, fill);
+          first_row = chunk.printJsonRows(out_, first_row);
+        }
+      }
+      InfoReadersTable::printJsonFooter(out_);
+      return;
+    }
+
+    auto tables = run_on_all_workers(server_->getProcessor(), fill);
 
     for (int i = 0; i < tables.size(); ++i) {
       table.mergeWith(std::move(tables[i]));
     }
 
-    json_ ? table.printJson(out_) : table.print(out_);
+    table.print(out_);
   }
 };
 
@@ -54,7 +54,9 @@ class InfoRebuildingShards : public AdminCommand {
                                     "Read buffer bytes",         // 12
                                     "Records in flight",         // 13
                                     "Read pointer",              // 14
-                                    "Progress");                 // 15
+                                    "Progress",                  // 15
+                                    "ETA",                       // 16
+                                    "ETA p95");                  // 17
 
     auto workerType = EventLogStateMachine::workerType(server->getProcessor());
     auto workerIdx = EventLogStateMachine::getWorkerIdx(
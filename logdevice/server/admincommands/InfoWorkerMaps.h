@@ -0,0 +1,66 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include "logdevice/common/Worker.h"
+#include "logdevice/server/admincommands/AdminCommand.h"
+
+namespace facebook { namespace logdevice { namespace commands {
+
+class InfoWorkerMaps : public AdminCommand {
+  using AdminCommand::AdminCommand;
+
+ private:
+  bool json_ = false;
+
+ public:
+  using InfoTable = AdminCommandTable<int,         // worker_id
+                                      std::string, // map
+                                      uint64_t,    // entries
+                                      uint64_t,    // buckets
+                                      double       // load_factor
+                                      >;
+  void getOptions(boost::program_options::options_description& opts) override {
+    opts.add_options()("json", boost::program_options::bool_switch(&json_));
+  }
+
+  void getPositionalOptions(
+      boost::program_options::positional_options_description& opts) override {}
+
+  std::string getUsage() override {
+    return "info worker_maps [--json]";
+  }
+
+  void run() override {
+    auto get_stats = []() -> std::vector<Worker::MapStats> {
+      return Worker::onThisThread()->getMapStats();
+    };
+
+    const auto& stats = run_on_worker_pool(
+        server_->getProcessor(), WorkerType::GENERAL, get_stats);
+
+    InfoTable table(
+        !json_, "Worker ID", "Map", "Entries", "Buckets", "Load Factor");
+    for (int i = 0; i < stats.size(); i++) {
+      for (const auto& map : stats[i]) {
+        table.next()
+            .set<0>(i)
+            .set<1>(map.name)
+            .set<2>(map.entries)
+            .set<3>(map.buckets)
+            .set<4>(map.buckets == 0
+                        ? 0.0
+                        : static_cast<double>(map.entries) / map.buckets);
+      }
+    }
+
+    json_ ? table.printJson(out_) : table.print(out_);
+  }
+};
+
+}}} // namespace facebook::logdevice::commands
@@ -0,0 +1,81 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include "logdevice/server/admincommands/AdminCommand.h"
+#include "logdevice/server/locallogstore/ShardedRocksDBLocalLogStore.h"
+
+namespace facebook { namespace logdevice { namespace commands {
+
+class ReadOnlyMode : public AdminCommand {
+  using AdminCommand::AdminCommand; // inherit constructor
+ private:
+  shard_index_t shard_;
+  std::string mode_;
+
+ public:
+  void getOptions(
+      boost::program_options::options_description& out_options) override {
+    out_options.add_options()(
+        "shard",
+        boost::program_options::value<shard_index_t>(&shard_)->required())(
+        "mode", boost::program_options::value<std::string>(&mode_)->required());
+  }
+  void getPositionalOptions(
+      boost::program_options::positional_options_description& out_options)
+      override {
+    out_options.add("shard", 1);
+    out_options.add("mode", 1);
+  }
+  std::string getUsage() override {
+    return "read_only <shard> on|off\r\n\r\n"
+           "Makes the shard reject new stores while continuing to serve "
+           "reads. Appenders route around the shard the same way as when "
+           "it's out of disk space. Unlike 'failsafe' this is reversible "
+           "and doesn't make the shard look failed to rebuilding. Doesn't "
+           "survive a restart of the server.";
+  }
+
+  void run() override {
+    if (!server_->getProcessor()->runningOnStorageNode()) {
+      out_.printf("Error: not storage node\r\n");
+      return;
+    }
+
+    if (mode_ != "on" && mode_ != "off") {
+      out_.printf("Error: mode must be 'on' or 'off'\r\n");
+      return;
+    }
+    bool read_only = mode_ == "on";
+
+    auto sharded_store = server_->getShardedLocalLogStore();
+
+    if (shard_ < 0 || shard_ >= sharded_store->numShards()) {
+      out_.printf("Error: shard index %d out of range [0, %d]\r\n",
+                  shard_,
+                  sharded_store->numShards() - 1);
+      return;
+    }
+
+    auto store = sharded_store->getByIndex(shard_);
+
+    ld_info("%s read-only mode on shard %d, triggered by admin command",
+            read_only ? "Entering" : "Leaving",
+            (int)shard_);
+    bool changed = store->setReadOnlyMode(read_only);
+
+    if (changed) {
+      out_.printf(read_only ? "Entered read-only mode.\r\n"
+                            : "Left read-only mode.\r\n");
+    } else {
+      out_.printf("The shard is already in the requested mode.\r\n");
+    }
+  }
+};
+
+}}} // namespace facebook::logdevice::commands
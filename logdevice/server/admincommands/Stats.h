@@ -19,22 +19,38 @@ namespace facebook { namespace logdevice { namespace commands {
 inline void printStats(const Stats& stats,
                        folly::io::Appender& out,
                        bool include_log_groups,
-                       const char* key_prefix = "") {
+                       const char* key_prefix = "",
+                       const std::string& name_filter = "") {
   class Callbacks : public Stats::EnumerationCallbacks {
    public:
     Callbacks(folly::io::Appender& out,
               const char* key_prefix,
-              bool include_log_groups)
+              bool include_log_groups,
+              const std::string& name_filter)
         : out_(out),
           keyPrefix_(key_prefix),
-          includeLogGroups_(include_log_groups) {}
+          includeLogGroups_(include_log_groups),
+          nameFilter_(name_filter) {}
+
+    // If a filter was given, only print stats whose base name (without
+    // suffixes like ".shard0") contains it as a substring.
+    bool matches(const std::string& name) const {
+      return nameFilter_.empty() ||
+          name.find(nameFilter_) != std::string::npos;
+    }
 
     // Simple stats.
     void stat(const std::string& name, int64_t val) override {
+      if (!matches(name)) {
+        return;
+      }
       out_.printf("STAT %s%s %" PRId64 "\r\n", keyPrefix_, name.c_str(), val);
     }
     // Per-message-type stats.
     void stat(const std::string& name, MessageType msg, int64_t val) override {
+      if (!matches(name)) {
+        return;
+      }
       out_.printf("STAT %s%s.%s %" PRId64 "\r\n",
                   keyPrefix_,
                   name.c_str(),
@@ -45,6 +61,9 @@ inline void printStats(const Stats& stats,
     void stat(const std::string& name,
               shard_index_t shard,
               int64_t val) override {
+      if (!matches(name)) {
+        return;
+      }
       out_.printf("STAT %s%s.shard%u %" PRId64 "\r\n",
                   keyPrefix_,
                   name.c_str(),
@@ -53,6 +72,9 @@ inline void printStats(const Stats& stats,
     }
     // Per-traffic-class stats.
     void stat(const std::string& name, TrafficClass tc, int64_t val) override {
+      if (!matches(name)) {
+        return;
+      }
       out_.printf("STAT %s%s.%s %" PRId64 "\r\n",
                   keyPrefix_,
                   name.c_str(),
@@ -63,6 +85,9 @@ inline void printStats(const Stats& stats,
     void statWithTag(const std::string& name,
                      const std::string& tag,
                      int64_t val) override {
+      if (!matches(name)) {
+        return;
+      }
       out_.printf("STAT %s%s.%s %" PRId64 "\r\n",
                   keyPrefix_,
                   name.c_str(),
@@ -74,6 +99,9 @@ inline void printStats(const Stats& stats,
     void stat(const std::string& name,
               NodeLocationScope flow_group,
               int64_t val) override {
+      if (!matches(name)) {
+        return;
+      }
       out_.printf("STAT %s%s.%s %" PRId64 "\r\n",
                   keyPrefix_,
                   name.c_str(),
@@ -85,6 +113,9 @@ inline void printStats(const Stats& stats,
               NodeLocationScope flow_group,
               Priority pri,
               int64_t val) override {
+      if (!matches(name)) {
+        return;
+      }
       out_.printf("STAT %s%s.%s.%s %" PRId64 "\r\n",
                   keyPrefix_,
                   name.c_str(),
@@ -94,6 +125,9 @@ inline void printStats(const Stats& stats,
     }
     // Per-msg-priority stats (totals of the previous one).
     void stat(const std::string& name, Priority pri, int64_t val) override {
+      if (!matches(name)) {
+        return;
+      }
       out_.printf("STAT %s%s.%s %" PRId64 "\r\n",
                   keyPrefix_,
                   name.c_str(),
@@ -102,6 +136,9 @@ inline void printStats(const Stats& stats,
     }
     // Per-request-type stats.
     void stat(const std::string& name, RequestType rq, int64_t val) override {
+      if (!matches(name)) {
+        return;
+      }
       out_.printf("STAT %s%s.%s %" PRId64 "\r\n",
                   keyPrefix_,
                   name.c_str(),
@@ -112,6 +149,9 @@ inline void printStats(const Stats& stats,
     void stat(const std::string& name,
               StorageTask::Type type,
               int64_t val) override {
+      if (!matches(name)) {
+        return;
+      }
       out_.printf("STAT %s%s.%s %" PRId64 "\r\n",
                   keyPrefix_,
                   name.c_str(),
@@ -122,6 +162,9 @@ inline void printStats(const Stats& stats,
     void stat(const std::string& name,
               worker_id_t worker_id,
               uint64_t load) override {
+      if (!matches(name)) {
+        return;
+      }
       out_.printf("STAT %s%s_%d %" PRIu64 "\r\n",
                   keyPrefix_,
                   name.c_str(),
@@ -132,7 +175,7 @@ inline void printStats(const Stats& stats,
     void stat(const char* name,
               const std::string& log_group0,
               int64_t val) override {
-      if (!includeLogGroups_) {
+      if (!includeLogGroups_ || !matches(name)) {
         return;
       }
       auto log_group = log_group0;
@@ -158,9 +201,10 @@ inline void printStats(const Stats& stats,
     folly::io::Appender& out_;
     const char* keyPrefix_;
     bool includeLogGroups_;
+    const std::string& nameFilter_;
   };
 
-  Callbacks cb(out, key_prefix, include_log_groups);
+  Callbacks cb(out, key_prefix, include_log_groups, name_filter);
   stats.enumerate(&cb, /* list_all */ true);
 }
 
@@ -169,10 +213,12 @@ class Stats : public AdminCommand {
 
  private:
   bool include_log_groups_;
+  bool cached_;
+  std::string filter_;
 
  public:
   std::string getUsage() override {
-    return "stats [--include-log-groups]";
+    return "stats [--include-log-groups] [--cached] [--filter <substring>]";
   }
 
   void getOptions(
@@ -183,15 +229,29 @@ class Stats : public AdminCommand {
       ("full", boost::program_options::bool_switch(&include_log_groups_))
 
       ("include-log-groups",
-        boost::program_options::bool_switch(&include_log_groups_));
+        boost::program_options::bool_switch(&include_log_groups_))
+
+      // Serve the snapshot maintained by the background aggregation thread
+      // (see --stats-background-aggregation-interval) instead of walking all
+      // thread-local Stats instances. Falls back to a synchronous aggregation
+      // if background aggregation is disabled.
+      ("cached", boost::program_options::bool_switch(&cached_))
+
+      // Only print stats whose name contains the given substring.
+      ("filter", boost::program_options::value<std::string>(&filter_));
     // clang-format on
   }
 
   void run() override {
-    if (server_->getParameters()->getStats()) {
-      printStats(server_->getParameters()->getStats()->aggregate(),
-                 out_,
-                 include_log_groups_);
+    StatsHolder* holder = server_->getParameters()->getStats();
+    if (holder) {
+      if (cached_) {
+        printStats(
+            *holder->aggregateCached(), out_, include_log_groups_, "", filter_);
+      } else {
+        printStats(
+            holder->aggregate(), out_, include_log_groups_, "", filter_);
+      }
     }
   }
 };
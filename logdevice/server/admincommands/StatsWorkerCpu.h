@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <boost/program_options/options_description.hpp>
+
+#include "logdevice/common/stats/Stats.h"
+#include "logdevice/server/admincommands/AdminCommand.h"
+
+namespace facebook { namespace logdevice { namespace commands {
+
+class StatsWorkerCpu : public AdminCommand {
+  using AdminCommand::AdminCommand;
+
+ private:
+  // Only include log groups with at least this many attributed microseconds.
+  int64_t threshold_{1};
+
+  // If nonzero, show only this many log groups, hottest first.
+  uint32_t top_{0};
+
+ public:
+  std::string getUsage() override {
+    return "Reports worker-thread CPU microseconds attributed to each log "
+           "group since the server started (the worker_cpu_usec per-log "
+           "stat).  Example usage: stats worker_cpu --top 10";
+  }
+
+  void getOptions(
+      boost::program_options::options_description& out_options) override {
+    out_options.add_options()(
+        "threshold",
+        boost::program_options::value<int64_t>(&threshold_)
+            ->default_value(threshold_),
+        "only include log groups with at least this many microseconds")(
+        "top",
+        boost::program_options::value<uint32_t>(&top_),
+        "show the top N log groups by attributed CPU");
+  }
+
+  void run() override {
+    StatsHolder* holder = server_->getParameters()->getStats();
+    if (!holder) {
+      return;
+    }
+
+    Stats stats = holder->aggregate();
+    std::vector<std::pair<std::string, int64_t>> groups;
+    for (const auto& kv : stats.synchronizedCopy(&Stats::per_log_stats)) {
+      int64_t usec = kv.second->worker_cpu_usec.load();
+      if (usec >= threshold_) {
+        groups.emplace_back(kv.first, usec);
+      }
+    }
+
+    // Hottest group first, ties broken by name so the output is stable.
+    auto cmp = [](const std::pair<std::string, int64_t>& p1,
+                  const std::pair<std::string, int64_t>& p2) {
+      if (p1.second != p2.second) {
+        return p1.second > p2.second;
+      }
+      return p1.first < p2.first;
+    };
+    if (top_ > 0 && top_ < groups.size()) {
+      std::partial_sort(groups.begin(), groups.begin() + top_, groups.end(), cmp);
+      groups.resize(top_);
+    } else {
+      std::sort(groups.begin(), groups.end(), cmp);
+    }
+
+    for (const auto& group : groups) {
+      out_.printf("STAT %s %ld\r\n", group.first.c_str(), group.second);
+    }
+  }
+};
+
+}}} // namespace facebook::logdevice::commands
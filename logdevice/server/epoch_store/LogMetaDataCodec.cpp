@@ -225,6 +225,11 @@ TailRecord LogMetaDataThriftConverter::tailRecordFromThrift(
 
   OffsetMap offset_map;
   for (const auto& [k, v] : thrift_tail_record.get_offset_map()) {
+    if (OffsetMap::counterIndex(k) == -1) {
+      // A counter type this build does not track, presumably written by a
+      // newer version. Drop it, as OffsetMap::deserialize() does.
+      continue;
+    }
     offset_map.setCounter(k, v);
   }
 
@@ -7,6 +7,7 @@
  */
 #include "logdevice/server/epoch_store/ZookeeperEpochStore.h"
 
+#include <algorithm>
 #include <cstring>
 
 #include <boost/filesystem.hpp>
@@ -243,6 +244,19 @@ void ZookeeperEpochStore::writeZnode(
 void ZookeeperEpochStore::legacyWriteZnode(RequestContext&& context,
                                            std::string legacy_znode_value,
                                            zk::version_t legacy_znode_version) {
+  if (settings_->epoch_store_batch_zk_writes) {
+    batchWriteZnode(std::move(context),
+                    std::move(legacy_znode_value),
+                    legacy_znode_version);
+    return;
+  }
+  singleWriteZnode(
+      std::move(context), std::move(legacy_znode_value), legacy_znode_version);
+}
+
+void ZookeeperEpochStore::singleWriteZnode(RequestContext&& context,
+                                           std::string znode_value,
+                                           zk::version_t znode_version) {
   std::string znode_path = context.zrq->getZnodePath(rootPath());
   // setData() below succeeds only if the current version number of
   // znode at znode_path matches the version that the znode had
@@ -255,9 +269,97 @@ void ZookeeperEpochStore::legacyWriteZnode(RequestContext&& context,
     postRequestCompletion(completionStatus(res, logid), std::move(context));
   };
   zkclient_->setData(std::move(znode_path),
-                     std::move(legacy_znode_value),
+                     std::move(znode_value),
                      std::move(cb),
-                     legacy_znode_version);
+                     znode_version);
+}
+
+void ZookeeperEpochStore::batchWriteZnode(RequestContext&& context,
+                                          std::string znode_value,
+                                          zk::version_t znode_version) {
+  {
+    std::lock_guard<std::mutex> lock(pending_writes_mutex_);
+    pending_writes_.push_back(PendingZnodeWrite{
+        std::move(context), std::move(znode_value), znode_version});
+    if (write_batch_in_flight_) {
+      // the completion of the batch on the wire will flush this write
+      return;
+    }
+    write_batch_in_flight_ = true;
+  }
+  flushPendingWrites();
+}
+
+void ZookeeperEpochStore::flushPendingWrites() {
+  std::vector<PendingZnodeWrite> batch;
+  {
+    std::lock_guard<std::mutex> lock(pending_writes_mutex_);
+    ld_check(write_batch_in_flight_);
+    if (pending_writes_.empty()) {
+      write_batch_in_flight_ = false;
+      return;
+    }
+    const size_t n = std::min(pending_writes_.size(), WRITE_BATCH_MAX_OPS);
+    batch.insert(batch.end(),
+                 std::make_move_iterator(pending_writes_.begin()),
+                 std::make_move_iterator(pending_writes_.begin() + n));
+    pending_writes_.erase(
+        pending_writes_.begin(), pending_writes_.begin() + n);
+  }
+
+  std::vector<zk::Op> ops;
+  ops.reserve(batch.size());
+  for (const auto& write : batch) {
+    // Each op is still conditional on the version observed by its own read,
+    // so batching doesn't weaken the read-modify-write atomicity of any
+    // individual request.
+    ops.emplace_back(
+        ZookeeperClientBase::makeSetOp(write.context.zrq->getZnodePath(
+                                           rootPath()),
+                                       write.value,
+                                       write.version));
+  }
+  if (batch.size() > 1) {
+    STAT_INCR(stats_, zookeeper_epoch_store_write_batches);
+    STAT_ADD(stats_, zookeeper_epoch_store_batched_writes, batch.size());
+  }
+
+  auto cb = [this, batch = std::move(batch)](
+                int rc, std::vector<zk::OpResponse> results) mutable {
+    if (rc == ZOK) {
+      ld_check(results.size() == batch.size());
+      for (size_t i = 0; i < batch.size(); ++i) {
+        postRequestCompletion(
+            completionStatus(results[i].rc_, batch[i].context.zrq->logid_),
+            std::move(batch[i].context));
+      }
+    } else if (batch.size() == 1) {
+      postRequestCompletion(
+          completionStatus(rc, batch[0].context.zrq->logid_),
+          std::move(batch[0].context));
+    } else {
+      // A Zookeeper multi-op is transactional: a single conflicting write
+      // (e.g. another sequencer racing us on one of the logs) aborts the
+      // whole batch. Retry every member individually; conflicts are rare
+      // enough that this only costs the round trips we tried to amortize.
+      RATELIMIT_INFO(std::chrono::seconds(10),
+                     2,
+                     "Batched epoch store multi-op of %lu writes failed "
+                     "with %s, retrying the writes individually",
+                     batch.size(),
+                     zerror(rc));
+      STAT_ADD(stats_,
+               zookeeper_epoch_store_batch_conflict_retries,
+               batch.size());
+      for (auto& write : batch) {
+        singleWriteZnode(std::move(write.context),
+                         std::move(write.value),
+                         write.version);
+      }
+    }
+    flushPendingWrites();
+  };
+  zkclient_->multiOp(std::move(ops), std::move(cb));
 }
 
 void ZookeeperEpochStore::doubleWriteZnode(
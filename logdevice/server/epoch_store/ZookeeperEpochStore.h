@@ -9,7 +9,9 @@
 
 #include <chrono>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include <boost/noncopyable.hpp>
 #include <folly/Optional.h>
@@ -201,6 +203,52 @@ class ZookeeperEpochStore : public EpochStore, boost::noncopyable {
                         std::string legacy_znode_value,
                         zk::version_t legacy_znode_version,
                         zk::version_t migration_znode_version);
+
+  /**
+   * Issues a single version-conditional setData() for a znode write. Used
+   * when batching is disabled and as the retry path when a batched multi-op
+   * is aborted by a conflict on one of its members.
+   */
+  void singleWriteZnode(RequestContext&& context,
+                        std::string znode_value,
+                        zk::version_t znode_version);
+
+  // A version-conditional znode write waiting for the next batched
+  // Zookeeper multi-op; see batchWriteZnode().
+  struct PendingZnodeWrite {
+    RequestContext context;
+    std::string value;
+    zk::version_t version;
+  };
+
+  /**
+   * Queues the write and group-commits: the first write of a quiet period is
+   * sent (as a multi-op of one) right away, and everything that queues up
+   * while it is on the wire is flushed as a single multi-op when it
+   * completes. Under a mass sequencer failover this amortizes one Zookeeper
+   * round trip over all epoch bumps that arrive within it.
+   */
+  void batchWriteZnode(RequestContext&& context,
+                       std::string znode_value,
+                       zk::version_t znode_version);
+
+  /**
+   * Sends the next batch of queued writes as a Zookeeper multi-op, or marks
+   * the batcher idle if the queue is empty. Called with
+   * write_batch_in_flight_ set.
+   */
+  void flushPendingWrites();
+
+  // maximum number of setData() ops in one batched multi-op; keeps the
+  // multi request comfortably under the Zookeeper packet size limit even
+  // with maximum-size znode values
+  static constexpr size_t WRITE_BATCH_MAX_OPS = 64;
+
+  // Guards pending_writes_ and write_batch_in_flight_; writes are queued
+  // from worker threads and flushed from Zookeeper completion callbacks.
+  std::mutex pending_writes_mutex_;
+  std::vector<PendingZnodeWrite> pending_writes_;
+  bool write_batch_in_flight_{false};
 };
 
 }} // namespace facebook::logdevice
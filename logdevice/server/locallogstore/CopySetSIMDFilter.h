@@ -0,0 +1,101 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <cstdint>
+
+#include "logdevice/common/ShardID.h"
+#include "logdevice/common/types_internal.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace facebook { namespace logdevice { namespace copyset_simd {
+
+/**
+ * @file Vectorized copyset membership tests for the CSI read filter.
+ *
+ *       LocalLogStoreReadFilter runs a membership test against every
+ *       copyset index entry the iterator touches; on read-heavy storage
+ *       nodes this branchy std::find loop is a top CPU item. These
+ *       helpers pack ShardIDs into 32-bit keys and compare four copyset
+ *       entries per instruction with SSE2, falling back to a scalar loop
+ *       on other platforms. Results are bit-for-bit identical to the
+ *       scalar loop.
+ */
+
+// Packs a ShardID into a single 32-bit comparison key. Distinct shards
+// always produce distinct keys.
+inline uint32_t packShardKey(ShardID shard) {
+  return (static_cast<uint32_t>(static_cast<uint16_t>(shard.node())) << 16) |
+      static_cast<uint16_t>(shard.shard());
+}
+
+// Key that cannot equal packShardKey() of any valid ShardID; used to pad
+// copysets to a multiple of the SIMD width.
+constexpr uint32_t PAD_KEY = 0xffffffffu;
+
+// Packs `size` ShardIDs into `out`, padding up to the next multiple of 4
+// with PAD_KEY. `out` must have room for size rounded up to a multiple
+// of 4 (COPYSET_SIZE_MAX + 3 always suffices).
+// @return number of keys written including padding.
+inline size_t packCopyset(const ShardID* copyset,
+                          copyset_size_t size,
+                          uint32_t* out) {
+  size_t i = 0;
+  for (; i < size; ++i) {
+    out[i] = packShardKey(copyset[i]);
+  }
+  while (i % 4 != 0) {
+    out[i++] = PAD_KEY;
+  }
+  return i;
+}
+
+// True iff `key` appears among `padded_size` packed keys (padding never
+// matches). `padded_size` must be a multiple of 4.
+inline bool containsKey(const uint32_t* keys, size_t padded_size, uint32_t key) {
+#if defined(__SSE2__)
+  const __m128i needle = _mm_set1_epi32(key);
+  for (size_t i = 0; i < padded_size; i += 4) {
+    const __m128i block =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi32(block, needle)) != 0) {
+      return true;
+    }
+  }
+  return false;
+#else
+  for (size_t i = 0; i < padded_size; ++i) {
+    if (keys[i] == key) {
+      return true;
+    }
+  }
+  return false;
+#endif
+}
+
+// True iff the copyset contains any of the given shards. Equivalent to
+// the nested std::find loop in LocalLogStoreReadFilter but branch-free
+// over the copyset.
+inline bool copysetContainsAny(const ShardID* copyset,
+                               copyset_size_t copyset_size,
+                               const ShardID* shards,
+                               size_t num_shards) {
+  uint32_t packed[COPYSET_SIZE_MAX + 3];
+  const size_t padded = packCopyset(copyset, copyset_size, packed);
+  for (size_t i = 0; i < num_shards; ++i) {
+    if (containsKey(packed, padded, packShardKey(shards[i]))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}}} // namespace facebook::logdevice::copyset_simd
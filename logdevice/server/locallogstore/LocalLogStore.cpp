@@ -7,6 +7,8 @@
  */
 #include "logdevice/server/locallogstore/LocalLogStore.h"
 
+#include <algorithm>
+
 #include <folly/hash/SpookyHashV2.h>
 
 #include "logdevice/common/LocalLogStoreRecordFormat.h"
@@ -16,6 +18,7 @@
 #include "logdevice/common/debug.h"
 #include "logdevice/common/protocol/STORE_Message.h"
 #include "logdevice/include/Err.h"
+#include "logdevice/server/locallogstore/CopySetSIMDFilter.h"
 
 namespace facebook { namespace logdevice {
 
@@ -48,6 +51,34 @@ int LocalLogStore::findKey(logid_t /*log_id*/,
   return -1;
 }
 
+int LocalLogStore::readRecords(logid_t log_id,
+                               const std::vector<lsn_t>& lsns,
+                               std::vector<std::string>* blobs_out) const {
+  ld_check(blobs_out != nullptr);
+  ld_assert(std::is_sorted(lsns.begin(), lsns.end()));
+  blobs_out->clear();
+  blobs_out->resize(lsns.size());
+  if (lsns.empty()) {
+    return 0;
+  }
+  ReadOptions options("LocalLogStore::readRecords");
+  std::unique_ptr<ReadIterator> it = read(log_id, options);
+  for (size_t i = 0; i < lsns.size(); ++i) {
+    it->seek(lsns[i]);
+    IteratorState state = it->state();
+    if (state == IteratorState::ERROR) {
+      err = E::LOCAL_LOG_STORE_READ;
+      return -1;
+    }
+    if (state == IteratorState::AT_RECORD && it->getLSN() == lsns[i]) {
+      Slice blob = it->getRecord();
+      (*blobs_out)[i].assign(
+          reinterpret_cast<const char*>(blob.data), blob.size);
+    }
+  }
+  return 0;
+}
+
 void LocalLogStore::normalizeTimeRanges(RecordTimeIntervals&) const {}
 
 int LocalLogStore::registerOnFlushCallback(FlushCallback& cb) {
@@ -108,18 +139,13 @@ bool LocalLogStoreReadFilter::operator()(logid_t,
   // least one rebuilding shard. If that's not the case, we will filter the
   // record.
   if (!required_in_copyset_.empty()) {
-    copyset_off_t i = 0;
-    for (; i < copyset_size; ++i) {
-      // We expect requried_in_copyset_ to be smaller than the size of
-      // the copyset, hence the use of std::find on a  vector instead of
-      // a std::unordered_set() here.
-      if (std::find(required_in_copyset_.begin(),
-                    required_in_copyset_.end(),
-                    copyset_original[i]) != required_in_copyset_.end()) {
-        break;
-      }
-    }
-    if (i == copyset_size) {
+    // required_in_copyset_ is expected to be small (the set of rebuilding
+    // shards), so iterate it and test each shard against the packed
+    // copyset with SIMD compares instead of a nested std::find loop.
+    if (!copyset_simd::copysetContainsAny(copyset_original,
+                                          copyset_size,
+                                          required_in_copyset_.data(),
+                                          required_in_copyset_.size())) {
       // We could not find a recipient in the copyset that's in the
       // required_in_copyset_ list, filter this record.
       return false;
@@ -337,6 +337,11 @@ class LocalLogStore : boost::noncopyable {
     // if blocking I/O is allowed.
     bool inject_latency = false;
 
+    // If nonzero, ask the backing store to read ahead this many bytes when
+    // the iterator moves forward sequentially, so lagging readers don't pay
+    // a synchronous block read per batch. Only useful with blocking I/O.
+    size_t readahead_size = 0;
+
     // Only affects AllLogsIterator. If set to true, iterate over partitions
     // in reverse order. Inside each partition, still go in order of
     // *increasing* pair [log ID, LSN], and metadata+internal logs still go
@@ -522,6 +527,22 @@ class LocalLogStore : boost::noncopyable {
     return false;
   }
 
+  // @return Whether this local log store was put in read-only mode with
+  // setReadOnlyMode().
+  virtual bool inReadOnlyMode() const {
+    return false;
+  }
+
+  // Make the store reject new writes (acceptingWrites() returns E::NOSPC,
+  // so appenders gracefully route around the shard) while continuing to
+  // serve reads. Unlike fail-safe mode this is reversible and doesn't make
+  // the shard look failed to rebuilding. Useful when a disk is overloaded
+  // or close to full and we want to preserve read capacity on it.
+  // @return  false if the store was already in the requested mode.
+  virtual bool setReadOnlyMode(bool /*read_only*/) {
+    return false;
+  }
+
   IOTracing* getIOTracing() const {
     return io_tracing_;
   }
@@ -648,6 +669,47 @@ class LocalLogStore : boost::noncopyable {
   virtual std::unique_ptr<ReadIterator>
   read(logid_t log_id, const ReadOptions& options) const = 0;
 
+  /**
+   * Point-reads the records with the given LSNs of a log. Intended for
+   * scattered lookups -- gap verification, filling small holes in a digest --
+   * where a streaming read would pay a full seek per record.
+   *
+   * @param lsns       LSNs to look up; must be sorted in increasing order.
+   * @param blobs_out  on success, resized to lsns.size(); entry i holds the
+   *                   serialized header+value combo of the record with
+   *                   lsns[i] (to be parsed by LocalLogStoreRecordFormat),
+   *                   or is left empty if no such record exists.
+   *
+   * The default implementation reuses a single ReadIterator across the
+   * sorted LSNs; stores may override with a batched point lookup.
+   *
+   * @return 0 on success, -1 with err set to E::LOCAL_LOG_STORE_READ if
+   *         reading failed.
+   */
+  virtual int readRecords(logid_t log_id,
+                          const std::vector<lsn_t>& lsns,
+                          std::vector<std::string>* blobs_out) const;
+
+  /**
+   * Returns true if any region of the store may be missing records because
+   * of an earlier failure (e.g. partitions marked under-replicated after an
+   * unclean shutdown).  Point lookups cannot tell a clean miss from a
+   * missing copy, so callers that draw conclusions from the absence of a
+   * record (see LocalLogStoreReader::readPointLookups()) must fall back to
+   * iterators -- which report such regions per read via
+   * ReadIterator::accessedUnderReplicatedRegion() -- while this is true.
+   */
+  virtual bool isUnderReplicated() const {
+    return false;
+  }
+
+  /**
+   * Hint that a reader started iterating over the given log. Stores that
+   * support cache warm-up after restart use this to track recently hot
+   * logs; the default implementation ignores the hint.
+   */
+  virtual void noteLogAccessed(logid_t /* log_id */) {}
+
   /**
    * Creates a new AllLogsIterator.
    * May wait for blocking IO; don't call from worker threads.
@@ -1035,6 +1097,15 @@ class LocalLogStore : boost::noncopyable {
     return 0;
   }
 
+  /**
+   * @return true if a compaction or partition drop is currently running
+   * on this shard. Storage threads use this to defer non-latency-critical
+   * reads while the disk is busy compacting.
+   */
+  virtual bool isCompactionInProgress() const {
+    return false;
+  }
+
   /**
    * @return this shard's index. Used for stats.
    */
@@ -11,6 +11,7 @@
 #include "logdevice/common/configuration/Configuration.h"
 #include "logdevice/server/ServerProcessor.h"
 #include "logdevice/server/ServerWorker.h"
+#include "logdevice/server/rebuilding/ChunkRebuilding.h"
 #include "logdevice/server/storage_tasks/ShardedStorageThreadPool.h"
 
 namespace facebook { namespace logdevice {
@@ -51,9 +52,24 @@ void MemtableFlushedRequest::broadcast() {
 }
 
 void MemtableFlushedRequest::applyFlush() {
-  // If you're reimplementing rebuilding without WAL:
-  // This is called on each worker (of type GENERAL) of a rebuilding donor node
-  // when it receives a flush notification from a storage node.
+  // Notify the ChunkRebuildings running on this worker: with
+  // rebuild-store-durability=memory some of them may be waiting for this
+  // node's memtables to be flushed before retiring a chunk.
+  auto& chunks = ServerWorker::onThisThread()->runningChunkRebuildings().map;
+  // onMemtableFlushed() can complete a chunk and unregister it from the map,
+  // so iterate over a snapshot of the ids.
+  std::vector<chunk_rebuilding_id_t> ids;
+  ids.reserve(chunks.size());
+  for (const auto& kv : chunks) {
+    ids.push_back(kv.first);
+  }
+  for (chunk_rebuilding_id_t id : ids) {
+    auto it = chunks.find(id);
+    if (it != chunks.end()) {
+      it->second->onMemtableFlushed(
+          node_index_, server_instance_id_, flushToken_);
+    }
+  }
 }
 
 NodeID MemtableFlushedRequest::getMyNodeID() const {
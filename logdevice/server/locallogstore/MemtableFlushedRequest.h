@@ -19,10 +19,12 @@ namespace facebook { namespace logdevice {
 
 /**
  * @file Created by PartitionedRocksDBStore when it receives a callback on
- *       memtable being flushed to stable storage.
- *
- *       This mechanism is currently unused, see comment in
- *       MEMTABLE_FLUSHED_Message.h
+ *       memtable being flushed to stable storage, and by
+ *       MEMTABLE_FLUSHED_onReceived() for flushes on other nodes. Broadcasts
+ *       local flushes to the other storage nodes and delivers the
+ *       notification to the ChunkRebuildings running on this worker, which
+ *       use it as the durability barrier for rebuilding without WAL
+ *       (rebuild-store-durability=memory).
  */
 
 class MemtableFlushedRequest : public Request {
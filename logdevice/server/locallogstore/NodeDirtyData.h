@@ -12,6 +12,7 @@
 
 #include "logdevice/common/DataClass.h"
 #include "logdevice/common/NodeID.h"
+#include "logdevice/common/Timestamp.h"
 #include "logdevice/common/util.h"
 
 namespace facebook { namespace logdevice {
@@ -29,7 +30,8 @@ class NodeDirtyData {
   NodeDirtyData() = default;
   NodeDirtyData(const NodeDirtyData& src)
       : data_token_(src.data_token_.load(std::memory_order_relaxed)),
-        wal_token_(src.wal_token_.load(std::memory_order_relaxed)) {}
+        wal_token_(src.wal_token_.load(std::memory_order_relaxed)),
+        dirtied_since_(src.dirtied_since_.timePoint()) {}
 
   /**
    * @return  the largest FlushToken that must be retired before all data for
@@ -94,11 +96,38 @@ class NodeDirtyData {
     auto can_mark_clean = [](const auto& cur, const auto& value) {
       return cur != FlushToken_INVALID && cur <= value;
     };
-    return can_mark_clean(atomic_conditional_store(data_token_,
-                                                   FlushToken_INVALID,
-                                                   flushed_up_through,
-                                                   can_mark_clean),
-                          flushed_up_through);
+    bool newly_cleaned =
+        can_mark_clean(atomic_conditional_store(data_token_,
+                                                FlushToken_INVALID,
+                                                flushed_up_through,
+                                                can_mark_clean),
+                       flushed_up_through);
+    if (newly_cleaned) {
+      // All outstanding writes have been retired; forget their timestamps.
+      dirtied_since_.store(RecordTimestamp::max());
+    }
+    return newly_cleaned;
+  }
+
+  /**
+   * Record the timestamp of a write that contributes to the current dirty
+   * state. Keeps the minimum over all such writes since the last
+   * clean->dirty transition.
+   */
+  void noteDirtyingWrite(const RecordTimestamp timestamp) {
+    dirtied_since_.storeMin(timestamp);
+  }
+
+  /**
+   * @return  the timestamp of the earliest write that contributed to the
+   *          current dirty state, or RecordTimestamp::max() if no dirtying
+   *          write has been recorded (e.g. the node is clean, or the dirty
+   *          state was recovered from metadata written by a version that
+   *          didn't persist timestamps). Used to narrow the time range that
+   *          mini-rebuilding needs to scan after an ungraceful shutdown.
+   */
+  RecordTimestamp dirtiedSince() const {
+    return dirtied_since_;
   }
 
   /**
@@ -123,12 +152,14 @@ class NodeDirtyData {
     using namespace std::string_literals;
 
     return "(D:"s + std::to_string(data_token_.load()) + ',' + "W:"s +
-        std::to_string(wal_token_.load()) + ')';
+        std::to_string(wal_token_.load()) + ',' + "S:"s +
+        RecordTimestamp(dirtied_since_.timePoint()).toString() + ')';
   }
 
  private:
   std::atomic<FlushToken> data_token_{FlushToken_INVALID};
   std::atomic<FlushToken> wal_token_{FlushToken_INVALID};
+  AtomicRecordTimestamp dirtied_since_{RecordTimestamp::max()};
 };
 
 using DirtiedByKey = std::pair<node_index_t, DataClass>;
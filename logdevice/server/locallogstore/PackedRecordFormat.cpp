@@ -0,0 +1,449 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/locallogstore/PackedRecordFormat.h"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+#include <folly/Varint.h>
+
+#include "logdevice/common/LocalLogStoreRecordFormat.h"
+#include "logdevice/common/checks.h"
+
+namespace facebook { namespace logdevice { namespace PackedRecordFormat {
+
+namespace {
+
+struct IndexEntry {
+  uint64_t lsn;
+  uint32_t offset; // of the record blob, relative to the end of the index
+} __attribute__((__packed__));
+
+struct Parsed {
+  uint16_t count;
+  const IndexEntry* index;
+  folly::StringPiece blobs;
+};
+
+int parse(folly::StringPiece value, Parsed* out) {
+  if (!isPacked(value) || value.size() < sizeof(uint8_t) + sizeof(uint16_t)) {
+    err = E::MALFORMED_RECORD;
+    return -1;
+  }
+  uint16_t count;
+  memcpy(&count, value.data() + sizeof(uint8_t), sizeof(count));
+  const size_t index_end =
+      sizeof(uint8_t) + sizeof(uint16_t) + count * sizeof(IndexEntry);
+  if (count == 0 || index_end > value.size()) {
+    err = E::MALFORMED_RECORD;
+    return -1;
+  }
+  out->count = count;
+  out->index = reinterpret_cast<const IndexEntry*>(
+      value.data() + sizeof(uint8_t) + sizeof(uint16_t));
+  out->blobs.reset(value.data() + index_end, value.size() - index_end);
+  return 0;
+}
+
+// Byte range of record i, bounded by the next record's offset (or the
+// end of the value for the last record).
+int recordSlice(const Parsed& parsed, size_t i, folly::StringPiece* out) {
+  IndexEntry entry;
+  memcpy(&entry, &parsed.index[i], sizeof(entry));
+  size_t end = parsed.blobs.size();
+  if (i + 1 < parsed.count) {
+    IndexEntry next;
+    memcpy(&next, &parsed.index[i + 1], sizeof(next));
+    end = next.offset;
+  }
+  if (entry.offset > end || end > parsed.blobs.size()) {
+    err = E::MALFORMED_RECORD;
+    return -1;
+  }
+  out->reset(parsed.blobs.data() + entry.offset, end - entry.offset);
+  return 0;
+}
+
+} // namespace
+
+void pack(const std::vector<std::pair<lsn_t, folly::StringPiece>>& records,
+          std::string* out) {
+  ld_check(!records.empty());
+  ld_check(records.size() <= UINT16_MAX);
+
+  const uint8_t marker = MARKER;
+  const uint16_t count = records.size();
+  out->clear();
+  out->append(reinterpret_cast<const char*>(&marker), sizeof(marker));
+  out->append(reinterpret_cast<const char*>(&count), sizeof(count));
+
+  uint32_t offset = 0;
+  lsn_t prev_lsn = LSN_INVALID;
+  for (const auto& rec : records) {
+    ld_check(rec.first > prev_lsn);
+    prev_lsn = rec.first;
+    IndexEntry entry = {rec.first, offset};
+    out->append(reinterpret_cast<const char*>(&entry), sizeof(entry));
+    offset += rec.second.size();
+  }
+  for (const auto& rec : records) {
+    out->append(rec.second.data(), rec.second.size());
+  }
+}
+
+int unpack(folly::StringPiece value,
+           std::function<void(lsn_t, folly::StringPiece)> cb) {
+  Parsed parsed;
+  if (parse(value, &parsed) != 0) {
+    return -1;
+  }
+  for (size_t i = 0; i < parsed.count; ++i) {
+    folly::StringPiece blob;
+    if (recordSlice(parsed, i, &blob) != 0) {
+      return -1;
+    }
+    IndexEntry entry;
+    memcpy(&entry, &parsed.index[i], sizeof(entry));
+    cb(entry.lsn, blob);
+  }
+  return 0;
+}
+
+int findRecord(folly::StringPiece value,
+               lsn_t lsn,
+               lsn_t* lsn_out,
+               folly::StringPiece* blob_out) {
+  Parsed parsed;
+  if (parse(value, &parsed) != 0) {
+    return -1;
+  }
+  // Binary search for the first entry with lsn >= target.
+  size_t lo = 0;
+  size_t hi = parsed.count;
+  while (lo < hi) {
+    const size_t mid = (lo + hi) / 2;
+    IndexEntry entry;
+    memcpy(&entry, &parsed.index[mid], sizeof(entry));
+    if (entry.lsn < lsn) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  if (lo == parsed.count) {
+    err = E::NOTFOUND;
+    return -1;
+  }
+  IndexEntry entry;
+  memcpy(&entry, &parsed.index[lo], sizeof(entry));
+  *lsn_out = entry.lsn;
+  return recordSlice(parsed, lo, blob_out);
+}
+
+lsn_t getMaxLSN(folly::StringPiece value) {
+  Parsed parsed;
+  if (parse(value, &parsed) != 0) {
+    return LSN_INVALID;
+  }
+  IndexEntry entry;
+  memcpy(&entry, &parsed.index[parsed.count - 1], sizeof(entry));
+  return entry.lsn;
+}
+
+// v2 (columnar) layout:
+//   u8  marker = MARKER_V2
+//   u16 count
+//   u64 LSN of the first record
+//   i64 timestamp of the first record, in milliseconds
+//   count-1 varints: LSN deltas (strictly positive)
+//   count-1 varints: zigzag timestamp deltas, each against the previous
+//       record
+//   varint dict_count; dict_count * { varint len, bytes }: distinct
+//       copysets (copyset size byte + copyset entries, verbatim), in
+//       order of first occurrence
+//   count varints: copyset dictionary index per record
+//   count * { varint len, bytes }: the single-record bytes between the
+//       timestamp and the copyset (last_known_good + flags + wave)
+//   count varints: tail lengths; followed by the concatenated tails
+//       (everything after the copyset: offsets, keys, payload)
+namespace {
+
+// One single-record blob cut at the field boundaries v2 encodes
+// separately. All pieces point into the input blob.
+struct SplitRecord {
+  int64_t timestamp;
+  folly::StringPiece mid;     // last_known_good + flags + wave
+  folly::StringPiece copyset; // copyset size byte + copyset entries
+  folly::StringPiece tail;    // offsets, keys, payload
+};
+
+int splitRecord(folly::StringPiece blob, SplitRecord* out) {
+  // See the layout description in LocalLogStoreRecordFormat.h.
+  if (blob.size() < sizeof(int64_t) + sizeof(esn_t) + sizeof(uint8_t)) {
+    err = E::MALFORMED_RECORD;
+    return -1;
+  }
+  memcpy(&out->timestamp, blob.data(), sizeof(out->timestamp));
+  const char* mid_start = blob.data() + sizeof(int64_t);
+  folly::ByteRange range(
+      reinterpret_cast<const uint8_t*>(mid_start) + sizeof(esn_t),
+      reinterpret_cast<const uint8_t*>(blob.end()));
+  uint64_t flags;
+  try {
+    flags = folly::decodeVarint(range);
+  } catch (...) {
+    err = E::MALFORMED_RECORD;
+    return -1;
+  }
+  if (range.size() < sizeof(uint32_t) + sizeof(copyset_size_t)) {
+    err = E::MALFORMED_RECORD;
+    return -1;
+  }
+  range.advance(sizeof(uint32_t)); // wave or recovery epoch
+  const copyset_size_t copyset_size = range.front();
+  const size_t entry_size = flags & LocalLogStoreRecordFormat::FLAG_SHARD_ID
+      ? sizeof(ShardID)
+      : sizeof(node_index_t);
+  const size_t copyset_bytes =
+      sizeof(copyset_size_t) + copyset_size * entry_size;
+  if (range.size() < copyset_bytes) {
+    err = E::MALFORMED_RECORD;
+    return -1;
+  }
+  const char* copyset_start = reinterpret_cast<const char*>(range.begin());
+  out->mid.reset(mid_start, copyset_start - mid_start);
+  out->copyset.reset(copyset_start, copyset_bytes);
+  out->tail.reset(
+      copyset_start + copyset_bytes, blob.end() - copyset_start - copyset_bytes);
+  return 0;
+}
+
+struct ParsedV2 {
+  std::vector<lsn_t> lsns;
+  std::vector<int64_t> timestamps;
+  std::vector<folly::StringPiece> copysets; // point into the dictionary
+  std::vector<folly::StringPiece> mids;
+  std::vector<folly::StringPiece> tails;
+};
+
+int parseV2(folly::StringPiece value, ParsedV2* out) {
+  constexpr size_t kFixedHeader = sizeof(uint8_t) + sizeof(uint16_t) +
+      sizeof(uint64_t) + sizeof(int64_t);
+  if (!isPackedV2(value) || value.size() < kFixedHeader) {
+    err = E::MALFORMED_RECORD;
+    return -1;
+  }
+  uint16_t count;
+  memcpy(&count, value.data() + sizeof(uint8_t), sizeof(count));
+  uint64_t base_lsn;
+  memcpy(&base_lsn,
+         value.data() + sizeof(uint8_t) + sizeof(uint16_t),
+         sizeof(base_lsn));
+  int64_t base_timestamp;
+  memcpy(&base_timestamp,
+         value.data() + sizeof(uint8_t) + sizeof(uint16_t) + sizeof(uint64_t),
+         sizeof(base_timestamp));
+  if (count == 0) {
+    err = E::MALFORMED_RECORD;
+    return -1;
+  }
+
+  folly::ByteRange range(
+      reinterpret_cast<const uint8_t*>(value.data()) + kFixedHeader,
+      reinterpret_cast<const uint8_t*>(value.end()));
+  try {
+    // folly::decodeVarint() throws on truncated input, covering most
+    // out-of-bounds cases; slices still need explicit length checks.
+    out->lsns.reserve(count);
+    out->lsns.push_back(base_lsn);
+    for (size_t i = 1; i < count; ++i) {
+      out->lsns.push_back(out->lsns.back() + folly::decodeVarint(range));
+    }
+    out->timestamps.reserve(count);
+    out->timestamps.push_back(base_timestamp);
+    for (size_t i = 1; i < count; ++i) {
+      out->timestamps.push_back(
+          out->timestamps.back() +
+          folly::decodeZigZag(folly::decodeVarint(range)));
+    }
+    const uint64_t dict_count = folly::decodeVarint(range);
+    std::vector<folly::StringPiece> dict;
+    dict.reserve(dict_count);
+    for (size_t i = 0; i < dict_count; ++i) {
+      const uint64_t len = folly::decodeVarint(range);
+      if (len > range.size()) {
+        err = E::MALFORMED_RECORD;
+        return -1;
+      }
+      dict.emplace_back(
+          reinterpret_cast<const char*>(range.begin()), size_t(len));
+      range.advance(len);
+    }
+    out->copysets.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+      const uint64_t idx = folly::decodeVarint(range);
+      if (idx >= dict.size()) {
+        err = E::MALFORMED_RECORD;
+        return -1;
+      }
+      out->copysets.push_back(dict[idx]);
+    }
+    out->mids.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+      const uint64_t len = folly::decodeVarint(range);
+      if (len > range.size()) {
+        err = E::MALFORMED_RECORD;
+        return -1;
+      }
+      out->mids.emplace_back(
+          reinterpret_cast<const char*>(range.begin()), size_t(len));
+      range.advance(len);
+    }
+    std::vector<uint64_t> tail_lens(count);
+    for (size_t i = 0; i < count; ++i) {
+      tail_lens[i] = folly::decodeVarint(range);
+    }
+    out->tails.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+      if (tail_lens[i] > range.size()) {
+        err = E::MALFORMED_RECORD;
+        return -1;
+      }
+      out->tails.emplace_back(
+          reinterpret_cast<const char*>(range.begin()), size_t(tail_lens[i]));
+      range.advance(tail_lens[i]);
+    }
+  } catch (...) {
+    err = E::MALFORMED_RECORD;
+    return -1;
+  }
+  return 0;
+}
+
+void assembleRecord(const ParsedV2& parsed, size_t i, std::string* out) {
+  out->clear();
+  out->append(
+      reinterpret_cast<const char*>(&parsed.timestamps[i]), sizeof(int64_t));
+  out->append(parsed.mids[i].data(), parsed.mids[i].size());
+  out->append(parsed.copysets[i].data(), parsed.copysets[i].size());
+  out->append(parsed.tails[i].data(), parsed.tails[i].size());
+}
+
+} // namespace
+
+int packV2(const std::vector<std::pair<lsn_t, folly::StringPiece>>& records,
+           std::string* out) {
+  ld_check(!records.empty());
+  ld_check(records.size() <= UINT16_MAX);
+
+  std::vector<SplitRecord> split(records.size());
+  for (size_t i = 0; i < records.size(); ++i) {
+    if (splitRecord(records[i].second, &split[i]) != 0) {
+      return -1;
+    }
+  }
+
+  const uint8_t marker = MARKER_V2;
+  const uint16_t count = records.size();
+  const uint64_t base_lsn = records[0].first;
+  out->clear();
+  out->append(reinterpret_cast<const char*>(&marker), sizeof(marker));
+  out->append(reinterpret_cast<const char*>(&count), sizeof(count));
+  out->append(reinterpret_cast<const char*>(&base_lsn), sizeof(base_lsn));
+  out->append(reinterpret_cast<const char*>(&split[0].timestamp),
+              sizeof(int64_t));
+
+  uint8_t varint_buf[folly::kMaxVarintLength64];
+  auto append_varint = [&](uint64_t v) {
+    const size_t n = folly::encodeVarint(v, varint_buf);
+    out->append(reinterpret_cast<const char*>(varint_buf), n);
+  };
+
+  for (size_t i = 1; i < count; ++i) {
+    ld_check(records[i].first > records[i - 1].first);
+    append_varint(records[i].first - records[i - 1].first);
+  }
+  for (size_t i = 1; i < count; ++i) {
+    append_varint(
+        folly::encodeZigZag(split[i].timestamp - split[i - 1].timestamp));
+  }
+
+  std::vector<folly::StringPiece> dict;
+  std::vector<uint64_t> dict_idx(count);
+  std::map<folly::StringPiece, uint64_t> dict_map;
+  for (size_t i = 0; i < count; ++i) {
+    auto insertion = dict_map.emplace(split[i].copyset, dict.size());
+    if (insertion.second) {
+      dict.push_back(split[i].copyset);
+    }
+    dict_idx[i] = insertion.first->second;
+  }
+  append_varint(dict.size());
+  for (const auto& entry : dict) {
+    append_varint(entry.size());
+    out->append(entry.data(), entry.size());
+  }
+  for (size_t i = 0; i < count; ++i) {
+    append_varint(dict_idx[i]);
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    append_varint(split[i].mid.size());
+    out->append(split[i].mid.data(), split[i].mid.size());
+  }
+  for (size_t i = 0; i < count; ++i) {
+    append_varint(split[i].tail.size());
+  }
+  for (size_t i = 0; i < count; ++i) {
+    out->append(split[i].tail.data(), split[i].tail.size());
+  }
+  return 0;
+}
+
+int unpackV2(folly::StringPiece value,
+             std::function<void(lsn_t, folly::StringPiece)> cb) {
+  ParsedV2 parsed;
+  if (parseV2(value, &parsed) != 0) {
+    return -1;
+  }
+  std::string scratch;
+  for (size_t i = 0; i < parsed.lsns.size(); ++i) {
+    assembleRecord(parsed, i, &scratch);
+    cb(parsed.lsns[i], scratch);
+  }
+  return 0;
+}
+
+int findRecordV2(folly::StringPiece value,
+                 lsn_t lsn,
+                 lsn_t* lsn_out,
+                 std::string* blob_out) {
+  ParsedV2 parsed;
+  if (parseV2(value, &parsed) != 0) {
+    return -1;
+  }
+  auto it = std::lower_bound(parsed.lsns.begin(), parsed.lsns.end(), lsn);
+  if (it == parsed.lsns.end()) {
+    err = E::NOTFOUND;
+    return -1;
+  }
+  *lsn_out = *it;
+  assembleRecord(parsed, it - parsed.lsns.begin(), blob_out);
+  return 0;
+}
+
+lsn_t getMaxLSNV2(folly::StringPiece value) {
+  ParsedV2 parsed;
+  if (parseV2(value, &parsed) != 0) {
+    return LSN_INVALID;
+  }
+  return parsed.lsns.back();
+}
+
+}}} // namespace facebook::logdevice::PackedRecordFormat
@@ -0,0 +1,147 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <folly/Range.h>
+
+#include "logdevice/common/types_internal.h"
+#include "logdevice/include/Err.h"
+
+namespace facebook { namespace logdevice { namespace PackedRecordFormat {
+
+/**
+ * @file Multi-record value format for packing consecutive small records
+ *       of one log into a single logsdb data CF value. For 100-300B
+ *       payloads the per-key overhead in RocksDB (index entry, restart
+ *       points, key bytes) is comparable to the data itself; packing
+ *       amortizes it across a group. A packed value is keyed by the LSN
+ *       of its first record and laid out as:
+ *
+ *         { u8 marker, u16 count, count * { u64 lsn, u32 offset },
+ *           concatenated record blobs }
+ *
+ *       The offset table keeps lookups of one LSN within a group to a
+ *       binary search plus one slice, so iterators can decode packed
+ *       values transparently. The marker byte is outside the value range
+ *       LocalLogStoreRecordFormat uses for its flags byte, so packed and
+ *       plain values can coexist in one column family and be told apart
+ *       by the first byte.
+ */
+
+// First byte of every packed value. LocalLogStoreRecordFormat's
+// first byte is a flags field whose high bits are defined flag bits;
+// 0xff (all flags plus the unused MSB combination) is never produced
+// by the single-record format.
+constexpr uint8_t MARKER = 0xff;
+
+/**
+ * @return true if the data CF value is in the packed format.
+ */
+inline bool isPacked(folly::StringPiece value) {
+  return !value.empty() && static_cast<uint8_t>(value.front()) == MARKER;
+}
+
+/**
+ * Packs records into one value. `records` must be non-empty, sorted by
+ * strictly increasing LSN, and hold at most UINT16_MAX entries; blobs
+ * are single-record values in LocalLogStoreRecordFormat.
+ */
+void pack(const std::vector<std::pair<lsn_t, folly::StringPiece>>& records,
+          std::string* out);
+
+/**
+ * Invokes `cb(lsn, blob)` for each record in the packed value, in LSN
+ * order.
+ * @return 0 on success, -1 with err set to E::MALFORMED_RECORD.
+ */
+int unpack(folly::StringPiece value,
+           std::function<void(lsn_t, folly::StringPiece)> cb);
+
+/**
+ * Finds the record with the smallest LSN >= `lsn` in the packed value.
+ * @return 0 and fills *lsn_out / *blob_out on success; -1 with err set
+ *         to E::NOTFOUND if all records have smaller LSNs, or
+ *         E::MALFORMED_RECORD if the value doesn't parse.
+ */
+int findRecord(folly::StringPiece value,
+               lsn_t lsn,
+               lsn_t* lsn_out,
+               folly::StringPiece* blob_out);
+
+/**
+ * @return LSN of the last record in the packed value, or LSN_INVALID
+ *         with err set to E::MALFORMED_RECORD.
+ */
+lsn_t getMaxLSN(folly::StringPiece value);
+
+// First byte of every v2 (columnar) packed value. Chosen for the same
+// reason as MARKER: the single-record format never produces it, and it
+// differs from MARKER so the two packed formats can coexist and be
+// told apart by the first byte.
+constexpr uint8_t MARKER_V2 = 0xfe;
+
+/**
+ * @return true if the data CF value is in the v2 packed format.
+ */
+inline bool isPackedV2(folly::StringPiece value) {
+  return !value.empty() && static_cast<uint8_t>(value.front()) == MARKER_V2;
+}
+
+/**
+ * Columnar variant of pack(). Instead of concatenating whole
+ * single-record blobs, the packer splits each one into fields and
+ * groups them into columns: LSNs and timestamps are delta-encoded as
+ * varints against the first record, copysets are dictionary-encoded
+ * (consecutive records of a log usually share one copyset, so the
+ * dictionary typically has one entry), and the remaining header bytes
+ * and payloads are concatenated with varint lengths. For ~100B records
+ * this cuts the fixed per-record overhead (12B v1 index entry + 8B
+ * timestamp + 5B+ copyset) down to a few bytes of varints.
+ *
+ * Same preconditions as pack(), plus the blobs must parse as
+ * single-record values in LocalLogStoreRecordFormat.
+ *
+ * @return 0 on success, -1 with err set to E::MALFORMED_RECORD if a
+ *         blob doesn't parse.
+ */
+int packV2(const std::vector<std::pair<lsn_t, folly::StringPiece>>& records,
+           std::string* out);
+
+/**
+ * Invokes `cb(lsn, blob)` for each record in the v2 packed value, in
+ * LSN order. Unlike unpack(), the blob is reassembled into a scratch
+ * buffer and is only valid until cb returns.
+ * @return 0 on success, -1 with err set to E::MALFORMED_RECORD.
+ */
+int unpackV2(folly::StringPiece value,
+             std::function<void(lsn_t, folly::StringPiece)> cb);
+
+/**
+ * Finds the record with the smallest LSN >= `lsn` in the v2 packed
+ * value and reassembles its single-record blob into *blob_out.
+ * @return 0 on success; -1 with err set to E::NOTFOUND if all records
+ *         have smaller LSNs, or E::MALFORMED_RECORD if the value
+ *         doesn't parse.
+ */
+int findRecordV2(folly::StringPiece value,
+                 lsn_t lsn,
+                 lsn_t* lsn_out,
+                 std::string* blob_out);
+
+/**
+ * @return LSN of the last record in the v2 packed value, or LSN_INVALID
+ *         with err set to E::MALFORMED_RECORD.
+ */
+lsn_t getMaxLSNV2(folly::StringPiece value);
+
+}}} // namespace facebook::logdevice::PackedRecordFormat
@@ -16,17 +16,29 @@ namespace facebook { namespace logdevice {
 PartitionDirtyMetadata::PartitionDirtyMetadata(const DirtiedByMap& dbm,
                                                bool under_replicated)
     : under_replicated_(under_replicated) {
+  std::array<std::vector<std::pair<node_index_t, uint64_t>>,
+             (size_t)DataClass::MAX>
+      entries;
   for (const auto& kv : dbm) {
     if (kv.second.dirtyUntil() != FlushToken_INVALID) {
       node_index_t nidx;
       DataClass dc;
       std::tie(nidx, dc) = kv.first;
-      dirtied_by_[(size_t)dc].push_back(nidx);
+      RecordTimestamp since = kv.second.dirtiedSince();
+      entries[(size_t)dc].emplace_back(nidx,
+                                       since == RecordTimestamp::max()
+                                           ? DIRTIED_SINCE_UNKNOWN
+                                           : since.toMilliseconds().count());
     }
   }
   // Sorting isn't necessary, but makes debugging/comparing records easier.
-  for (auto& dv : dirtied_by_) {
-    std::sort(dv.begin(), dv.end());
+  for (size_t dci = 0; dci < entries.size(); ++dci) {
+    auto& ev = entries[dci];
+    std::sort(ev.begin(), ev.end());
+    for (const auto& e : ev) {
+      dirtied_by_[dci].push_back(e.first);
+      dirtied_since_[dci].push_back(e.second);
+    }
   }
 }
 
@@ -41,8 +53,8 @@ Slice PartitionDirtyMetadata::serialize() const {
   for (auto& dv : dirtied_by_) {
     if (!dv.empty()) {
       h.dnc_array_len += sizeof(DirtyNodesForClass);
-      record_size +=
-          sizeof(DirtyNodesForClass) + sizeof(node_index_t) * dv.size();
+      record_size += sizeof(DirtyNodesForClass) +
+          (sizeof(node_index_t) + sizeof(uint64_t)) * dv.size();
     }
   }
   if (h.dnc_array_len != 0) {
@@ -60,10 +72,15 @@ Slice PartitionDirtyMetadata::serialize() const {
     DirtyNodesForClass dnc;
 
     if (!dv.empty()) {
+      const auto& sv = dirtied_since_[dci];
+      ld_check_eq(sv.size(), dv.size());
+
       dnc.len = sizeof(dnc);
       dnc.data_class = dci;
       dnc.nid_array_offset = data_offset;
       dnc.nid_array_len = sizeof(node_index_t) * dv.size();
+      dnc.dirtied_since_array_offset = data_offset + dnc.nid_array_len;
+      dnc.dirtied_since_array_len = sizeof(uint64_t) * sv.size();
 
       memcpy(serialize_buffer_.data() + dnc_offset, &dnc, sizeof(dnc));
       dnc_offset += sizeof(dnc);
@@ -71,6 +88,11 @@ Slice PartitionDirtyMetadata::serialize() const {
       memcpy(
           serialize_buffer_.data() + data_offset, dv.data(), dnc.nid_array_len);
       data_offset += dnc.nid_array_len;
+
+      memcpy(serialize_buffer_.data() + data_offset,
+             sv.data(),
+             dnc.dirtied_since_array_len);
+      data_offset += dnc.dirtied_since_array_len;
     }
     dci++;
   }
@@ -84,6 +106,9 @@ int PartitionDirtyMetadata::deserialize(Slice blob) {
   for (auto& dv : dirtied_by_) {
     dv.clear();
   }
+  for (auto& sv : dirtied_since_) {
+    sv.clear();
+  }
 
   Header h;
   const uint8_t* data = static_cast<const uint8_t*>(blob.data);
@@ -108,15 +133,28 @@ int PartitionDirtyMetadata::deserialize(Slice blob) {
   uint32_t data_offset = dnc_offset + h.dnc_array_len;
   while (dnc_offset < blob.size &&
          (dnc_offset - h.dnc_array_offset) < h.dnc_array_len) {
-    DirtyNodesForClass dnc;
+    DirtyNodesForClass dnc{};
 
-    if ((blob.size - dnc_offset) < sizeof(dnc)) {
+    // Records written before the dirtied-since fields were added have
+    // DirtyNodesForClass elements of LEN_V1 bytes; copy only the bytes
+    // that are present.
+    if ((blob.size - dnc_offset) < DirtyNodesForClass::LEN_V1) {
       ld_check(false);
       err = E::MALFORMED_RECORD;
       return -1;
     }
-
-    memcpy(&dnc, data + dnc_offset, sizeof(dnc));
+    memcpy(&dnc, data + dnc_offset, DirtyNodesForClass::LEN_V1);
+    if (dnc.len < DirtyNodesForClass::LEN_V1 ||
+        (blob.size - dnc_offset) < dnc.len) {
+      ld_check(false);
+      err = E::MALFORMED_RECORD;
+      return -1;
+    }
+    if (dnc.len > DirtyNodesForClass::LEN_V1) {
+      memcpy(&dnc,
+             data + dnc_offset,
+             std::min((size_t)dnc.len, sizeof(dnc)));
+    }
     dnc_offset += dnc.len;
 
     if (dnc.nid_array_offset < data_offset ||
@@ -129,6 +167,22 @@ int PartitionDirtyMetadata::deserialize(Slice blob) {
     }
     data_offset = dnc.nid_array_offset + dnc.nid_array_len;
 
+    if (dnc.dirtied_since_array_len != 0) {
+      if (dnc.dirtied_since_array_offset < data_offset ||
+          dnc.dirtied_since_array_offset >= blob.size ||
+          (dnc.dirtied_since_array_len % sizeof(uint64_t)) != 0 ||
+          (blob.size - dnc.dirtied_since_array_offset) <
+              dnc.dirtied_since_array_len ||
+          dnc.dirtied_since_array_len / sizeof(uint64_t) !=
+              dnc.nid_array_len / sizeof(node_index_t)) {
+        ld_check(false);
+        err = E::MALFORMED_RECORD;
+        return -1;
+      }
+      data_offset =
+          dnc.dirtied_since_array_offset + dnc.dirtied_since_array_len;
+    }
+
     if (static_cast<DataClass>(dnc.data_class) >= DataClass::MAX) {
       // Forward compatibility
       continue;
@@ -138,6 +192,14 @@ int PartitionDirtyMetadata::deserialize(Slice blob) {
       auto& dv = dirtied_by_[dnc.data_class];
       dv.resize(dnc.nid_array_len / sizeof(node_index_t));
       memcpy(dv.data(), data + dnc.nid_array_offset, dnc.nid_array_len);
+
+      if (dnc.dirtied_since_array_len != 0) {
+        auto& sv = dirtied_since_[dnc.data_class];
+        sv.resize(dnc.dirtied_since_array_len / sizeof(uint64_t));
+        memcpy(sv.data(),
+               data + dnc.dirtied_since_array_offset,
+               dnc.dirtied_since_array_len);
+      }
     }
   }
 
@@ -149,16 +211,18 @@ std::string PartitionDirtyMetadata::toString() const {
   size_t dci = 0;
   for (const auto& dv : dirtied_by_) {
     if (!dv.empty()) {
+      const auto& sv = dirtied_since_[dci];
       str += "{";
       str += dataClassPrefixes()[dci];
       str += ":";
-      bool first_node = true;
-      for (auto& node : dv) {
-        if (!first_node) {
+      for (size_t i = 0; i < dv.size(); ++i) {
+        if (i != 0) {
           str += ",";
         }
-        first_node = false;
-        str += std::to_string(node);
+        str += std::to_string(dv[i]);
+        if (i < sv.size() && sv[i] != DIRTIED_SINCE_UNKNOWN) {
+          str += "@" + format_time(std::chrono::milliseconds(sv[i]));
+        }
       }
       str += "}";
     }
@@ -8,6 +8,8 @@
 #pragma once
 
 #include <chrono>
+#include <cstddef>
+#include <limits>
 
 #include <folly/small_vector.h>
 #include <rocksdb/slice.h>
@@ -109,6 +111,13 @@ class PartitionDirtyMetadata : public PartitionMetadata {
  public:
   using DirtyNodeVector = std::vector<node_index_t>;
   using DirtyNodeVectors = std::array<DirtyNodeVector, (size_t)DataClass::MAX>;
+  using DirtiedSinceVector = std::vector<uint64_t>;
+  using DirtiedSinceVectors =
+      std::array<DirtiedSinceVector, (size_t)DataClass::MAX>;
+
+  // Serialized in place of a dirtied-since timestamp that isn't known.
+  static constexpr uint64_t DIRTIED_SINCE_UNKNOWN =
+      std::numeric_limits<uint64_t>::max();
 
   explicit PartitionDirtyMetadata() {}
   explicit PartitionDirtyMetadata(const DirtiedByMap&, bool under_replicated);
@@ -134,6 +143,15 @@ class PartitionDirtyMetadata : public PartitionMetadata {
     return dirtied_by_;
   }
 
+  // Timestamps (ms since epoch) of the earliest write that contributed to
+  // each node's dirty state, parallel to getDirtiedBy(dc). Empty if the
+  // record was written by a version that didn't persist timestamps;
+  // individual entries may be DIRTIED_SINCE_UNKNOWN.
+  const DirtiedSinceVector& getDirtiedSince(DataClass dc) const {
+    ld_check(dc < DataClass::MAX);
+    return dirtied_since_[(size_t)dc];
+  }
+
  private:
   // Offsets are from the beginning of the metadata record.
   // Both offsets and lengths are in terms of bytes.
@@ -145,9 +163,20 @@ class PartitionDirtyMetadata : public PartitionMetadata {
     uint8_t pad = 0;
     uint32_t nid_array_offset;
     uint32_t nid_array_len;
+    // Array of uint64_t dirtied-since timestamps (ms since epoch), parallel
+    // to the nid array. Zero length in records written by versions that
+    // predate these fields; such records have len == LEN_V1.
+    uint32_t dirtied_since_array_offset = 0;
+    uint32_t dirtied_since_array_len = 0;
+
+    // Size of this structure before the dirtied-since fields were added.
+    static constexpr uint16_t LEN_V1 = 12;
   };
-  static_assert(sizeof(DirtyNodesForClass) == 12,
+  static_assert(sizeof(DirtyNodesForClass) == 20,
                 "PartitionDirtyMetadata::DirtyNodesForClass is not packed.");
+  static_assert(offsetof(DirtyNodesForClass, dirtied_since_array_offset) ==
+                    DirtyNodesForClass::LEN_V1,
+                "PartitionDirtyMetadata::DirtyNodesForClass LEN_V1 mismatch.");
 
   struct Header {
     using flags_t = uint8_t;
@@ -170,6 +199,7 @@ class PartitionDirtyMetadata : public PartitionMetadata {
                 "PartitionDirtyMetadata::Header is not packed.");
 
   DirtyNodeVectors dirtied_by_;
+  DirtiedSinceVectors dirtied_since_;
 
   // This partition has lost records that have not yet been restored by
   // rebuilding.
@@ -9,9 +9,14 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iterator>
 #include <list>
+#include <numeric>
+#include <tuple>
 
 #include <folly/Conv.h>
 #include <folly/Likely.h>
@@ -38,6 +43,7 @@
 #include "logdevice/server/locallogstore/PartitionedRocksDBStoreFindKey.h"
 #include "logdevice/server/locallogstore/PartitionedRocksDBStoreFindTime.h"
 #include "logdevice/server/locallogstore/PartitionedRocksDBStoreIterators.h"
+#include "logdevice/server/locallogstore/PayloadDedup.h"
 #include "logdevice/server/locallogstore/RocksDBCompactionFilter.h"
 #include "logdevice/server/locallogstore/RocksDBEnv.h"
 #include "logdevice/server/locallogstore/RocksDBKeyFormat.h"
@@ -52,6 +58,7 @@
 namespace facebook { namespace logdevice {
 
 using RocksDBKeyFormat::CustomIndexDirectoryKey;
+using RocksDBKeyFormat::LogMetaKey;
 using RocksDBKeyFormat::PartitionDirectoryKey;
 using RocksDBKeyFormat::PartitionMetaKey;
 using RocksDBKeyFormat::PerEpochLogMetaKey;
@@ -62,6 +69,7 @@ using CFData = FlushEvaluator::CFData;
 const char* PartitionedRocksDBStore::METADATA_CF_NAME = "metadata";
 const char* PartitionedRocksDBStore::UNPARTITIONED_CF_NAME = "unpartitioned";
 const char* PartitionedRocksDBStore::SNAPSHOTS_CF_NAME = "snapshots";
+const char* PartitionedRocksDBStore::HOT_LOGS_FILENAME = "hot_logs";
 static const int SCHEMA_VERSION = 2;
 constexpr std::pair<node_index_t, DataClass>
     PartitionedRocksDBStore::DirtyState::SENTINEL_KEY;
@@ -155,12 +163,13 @@ bool PartitionedRocksDBStore::MetadataMergeOperator::Merge(
     const rocksdb::Slice& value,
     std::string* new_value,
     rocksdb::Logger* /*logger*/) const {
-  // This operator only applies to MutablePerEpochLogMetadata and the metadata
-  // index entries for findKey. Make sure key is valid.
+  // This operator only applies to MutablePerEpochLogMetadata, trim points
+  // and the metadata index entries for findKey. Make sure key is valid.
   const char header = key.size() > 0 ? key.data()[0] : '\0';
   if (key.size() == 0 ||
       (header !=
            PerEpochLogMetaKey::getHeader(PerEpochLogMetadataType::MUTABLE) &&
+       header != LogMetaKey::HEADER_TRIM_POINT &&
        !CustomIndexDirectoryKey::valid(key.data(), key.size()))) {
     RATELIMIT_ERROR(std::chrono::seconds(1),
                     1,
@@ -176,6 +185,29 @@ bool PartitionedRocksDBStore::MetadataMergeOperator::Merge(
     return true;
   }
 
+  if (header == LogMetaKey::HEADER_TRIM_POINT) {
+    // Trim points merge to the maximum, so that trim writers don't need
+    // a read-modify-write cycle. See RocksDBWriterMergeOperator's
+    // handleTrimPointMetadata() for the same logic in the unpartitioned
+    // store.
+    TrimMetadata existing;
+    TrimMetadata update;
+    if (UNLIKELY(existing.deserialize(
+                     Slice(existing_value->data(), existing_value->size())) !=
+                     0 ||
+                 update.deserialize(Slice(value.data(), value.size())) != 0)) {
+      RATELIMIT_ERROR(std::chrono::seconds(1),
+                      1,
+                      "Malformed trim point metadata; key: %s",
+                      hexdump_buf(key.data(), key.size()).c_str());
+      return false;
+    }
+    const rocksdb::Slice& winner =
+        existing.trim_point_ >= update.trim_point_ ? *existing_value : value;
+    new_value->assign(winner.data(), winner.size());
+    return true;
+  }
+
   // Generic lambda for safely merging metadata.
   const auto merge = [new_value, left = *existing_value, right = value](
                          auto&& metadata) -> bool {
@@ -351,7 +383,8 @@ PartitionedRocksDBStore::PartitionedRocksDBStore(
                           stats,
                           io_tracing),
       logs_(),
-      data_cf_options_(rocksdb_config_.options_) {
+      data_cf_options_(rocksdb_config_.options_),
+      unpartitioned_log_ranges_(getSettings()->unpartitioned_log_ranges) {
   if (defer_init == DeferInit::NO) {
     init(config);
   }
@@ -493,6 +526,15 @@ void PartitionedRocksDBStore::joinBackgroundThreads() {
     updateDirtyState(maxFlushToken());
   }
 
+  if (!getSettings()->read_only) {
+    // Finish any partition drops that dropPartitions() has queued but the
+    // lo-pri thread hasn't gotten to yet. Otherwise the dropped partitions
+    // would come back to life on the next startup. Must happen before
+    // CancelAllBackgroundWork(): the metadata cleanup needs writes to still
+    // succeed.
+    flushPendingDrops();
+  }
+
   // Cancel any in-progress operations, such as compactions, that our
   // threads may be blocked on. Compactions can take minutes to complete
   // and we do not want to delay shutdown. All of these operations will
@@ -521,6 +563,52 @@ void PartitionedRocksDBStore::setProcessor(Processor* processor) {
   processor_.store(checked_downcast<ServerProcessor*>(processor));
 }
 
+bool PartitionedRocksDBStore::isPayloadDedupEnabled(logid_t log_id) const {
+  if (!isLogPartitioned(log_id)) {
+    // Unpartitioned column families are never dropped, so dedup payload
+    // entries in them would accumulate forever.
+    return false;
+  }
+  ServerProcessor* processor = processor_.load();
+  if (!processor) {
+    // We're not fully initialized yet.
+    return false;
+  }
+  auto config = processor->config_->get();
+  if (!config->logsConfig()->isFullyLoaded()) {
+    return false;
+  }
+  uint64_t version = config->logsConfig()->getVersion();
+
+  {
+    auto cache = payload_dedup_cache_.rlock();
+    if (cache->config_version == version) {
+      auto it = cache->enabled.find(log_id);
+      if (it != cache->enabled.end()) {
+        return it->second;
+      }
+    }
+  }
+
+  bool enabled = false;
+  const auto log_config = config->getLogGroupByIDShared(log_id);
+  if (log_config) {
+    const auto& extras = log_config->attrs().extras();
+    if (extras.hasValue()) {
+      auto it = extras.value().find(PayloadDedup::EXTRAS_ATTRIBUTE);
+      enabled = it != extras.value().end() && it->second == "true";
+    }
+  }
+
+  auto cache = payload_dedup_cache_.wlock();
+  if (cache->config_version != version) {
+    cache->enabled.clear();
+    cache->config_version = version;
+  }
+  cache->enabled[log_id] = enabled;
+  return enabled;
+}
+
 std::unique_ptr<LocalLogStore::ReadIterator>
 PartitionedRocksDBStore::read(logid_t log_id,
                               const LocalLogStore::ReadOptions& options) const {
@@ -826,6 +914,20 @@ bool PartitionedRocksDBStore::open(
         setUnderReplicated(partition);
         auto dti =
             partition->dirtyTimeInterval(*getSettings(), latest_partition_id);
+        // If the timestamp of the write that first dirtied this node was
+        // persisted, records older than it (modulo the timestamp granularity
+        // slack) were already durable and don't need to be rebuilt. This
+        // matters for short outages: only the tail of the partition gets
+        // rescanned instead of the whole partition.
+        RecordTimestamp dirtied_since = ndd_kv.second.dirtiedSince();
+        if (dirtied_since != RecordTimestamp::max()) {
+          RecordTimestamp lower = dirtied_since -
+              std::min(dirtied_since.time_since_epoch(), // avoiding overflow
+                       getSettings()->partition_timestamp_granularity_);
+          if (lower > dti.lower() && lower < dti.upper()) {
+            dti = RecordTimeInterval(lower, dti.upper());
+          }
+        }
         ld_info("Partition s%u:%lu found dirty: %s",
                 shard_idx_,
                 partition->id_,
@@ -1203,6 +1305,11 @@ PartitionedRocksDBStore::prependPartitionsInternal(size_t count) {
   ld_check_gt(count, 0);
   ld_check_lt(count, first_partition->id_);
 
+  // Column family names are partition IDs, and we're about to reuse IDs just
+  // below the current oldest. Make sure no column family with such a name is
+  // still awaiting drop.
+  flushPendingDrops();
+
   // Create partitions.
   partition_id_t first_id = first_partition->id_ - count;
   auto partition_duration = getSettings()->partition_duration_;
@@ -1363,6 +1470,9 @@ bool PartitionedRocksDBStore::finishInterruptedDrops() {
                last_gap + 1);
     int rv = dropPartitions(last_gap + 1, [&]() { return last_gap + 1; });
     ld_check_ne(rv, 0);
+    // We're still starting up, so do the actual column family drops right
+    // away instead of leaving them to the background thread.
+    flushPendingDrops();
     return err == E::GAP;
   } else {
     cleanUpDirectory();
@@ -1663,12 +1773,18 @@ bool PartitionedRocksDBStore::readPartitionDirtyState(PartitionPtr partition) {
   size_t dci = 0;
   for (const auto& dnv : meta.getAllDirtiedBy()) {
     DataClass dc = static_cast<DataClass>(dci);
-    for (auto node_idx : dnv) {
+    const auto& since = meta.getDirtiedSince(dc);
+    for (size_t i = 0; i < dnv.size(); ++i) {
       auto result = partition->dirty_state_.dirtied_by_nodes.emplace(
           std::piecewise_construct,
-          std::forward_as_tuple(node_idx, dc),
+          std::forward_as_tuple(dnv[i], dc),
           std::forward_as_tuple());
       result.first->second.markDirtyUntil(FlushToken_MIN);
+      if (i < since.size() &&
+          since[i] != PartitionDirtyMetadata::DIRTIED_SINCE_UNKNOWN) {
+        result.first->second.noteDirtyingWrite(
+            RecordTimestamp::from(std::chrono::milliseconds(since[i])));
+      }
     }
     dci++;
   };
@@ -1773,6 +1889,149 @@ void PartitionedRocksDBStore::getLogsDBDirectories(
   }
 }
 
+void PartitionedRocksDBStore::noteLogAccessed(logid_t log_id) {
+  if (!getSettings()->cache_warmup_enabled_) {
+    return;
+  }
+  const size_t max_logs = getSettings()->cache_warmup_tracked_logs_;
+  std::lock_guard<std::mutex> lock(hot_logs_mutex_);
+  if (hot_logs_.size() < max_logs ||
+      hot_logs_.count(log_id.val_)) {
+    hot_logs_.insert(log_id.val_);
+  }
+}
+
+void PartitionedRocksDBStore::persistHotLogs() {
+  auto db_path = getLocalDBPath();
+  if (!db_path.has_value()) {
+    return;
+  }
+  std::vector<logid_t::raw_type> logs;
+  {
+    std::lock_guard<std::mutex> lock(hot_logs_mutex_);
+    logs.assign(hot_logs_.begin(), hot_logs_.end());
+  }
+  if (logs.empty()) {
+    return;
+  }
+  std::sort(logs.begin(), logs.end());
+
+  std::string final_path = db_path.value() + "/" + HOT_LOGS_FILENAME;
+  std::string tmp_path = final_path + ".tmp";
+  std::ofstream out(tmp_path, std::ios::trunc);
+  for (logid_t::raw_type log : logs) {
+    out << log << '\n';
+  }
+  out.close();
+  if (!out) {
+    RATELIMIT_ERROR(std::chrono::seconds(10),
+                    1,
+                    "Shard %d: failed to write hot logs file %s",
+                    getShardIdx(),
+                    tmp_path.c_str());
+    return;
+  }
+  if (::rename(tmp_path.c_str(), final_path.c_str()) != 0) {
+    RATELIMIT_ERROR(std::chrono::seconds(10),
+                    1,
+                    "Shard %d: failed to rename %s to %s: %s",
+                    getShardIdx(),
+                    tmp_path.c_str(),
+                    final_path.c_str(),
+                    strerror(errno));
+  }
+}
+
+std::vector<logid_t> PartitionedRocksDBStore::loadHotLogs() const {
+  std::vector<logid_t> logs;
+  auto db_path = getLocalDBPath();
+  if (!db_path.has_value()) {
+    return logs;
+  }
+  std::ifstream in(db_path.value() + "/" + HOT_LOGS_FILENAME);
+  if (!in.is_open()) {
+    return logs;
+  }
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty()) {
+      continue;
+    }
+    auto log = folly::tryTo<logid_t::raw_type>(line);
+    if (!log.hasValue()) {
+      ld_warning("Shard %d: malformed line in hot logs file: \"%s\"",
+                 getShardIdx(),
+                 line.c_str());
+      continue;
+    }
+    logs.push_back(logid_t(log.value()));
+  }
+  return logs;
+}
+
+void PartitionedRocksDBStore::warmUpCaches() {
+  auto settings = getSettings();
+  if (!settings->cache_warmup_enabled_) {
+    return;
+  }
+  std::vector<logid_t> logs = loadHotLogs();
+  if (logs.empty()) {
+    ld_info("Shard %d: no persisted hot logs, skipping cache warm-up.",
+            getShardIdx());
+    return;
+  }
+  if (logs.size() > settings->cache_warmup_tracked_logs_) {
+    logs.resize(settings->cache_warmup_tracked_logs_);
+  }
+
+  const partition_id_t latest_id = latest_.get()->id_;
+  std::vector<partition_id_t> partitions;
+  for (size_t i = 0; i < settings->cache_warmup_partitions_ && i <= latest_id;
+       ++i) {
+    PartitionPtr partition;
+    if (getPartition(latest_id - i, &partition)) {
+      partitions.push_back(latest_id - i);
+    }
+  }
+  std::sort(partitions.begin(), partitions.end());
+
+  std::vector<std::pair<logid_t, DirectoryEntry>> directory;
+  getLogsDBDirectories(partitions, logs, directory);
+
+  LocalLogStore::ReadOptions read_options("CacheWarmup");
+  read_options.readahead_size = 1 << 20;
+
+  const size_t max_bytes = settings->cache_warmup_max_bytes_per_shard_;
+  size_t bytes_read = 0;
+  size_t records_read = 0;
+  SteadyTimestamp start_time = currentSteadyTime();
+
+  for (const auto& p : directory) {
+    if (bytes_read >= max_bytes || shutdown_event_.signaled()) {
+      break;
+    }
+    auto it = read(p.first, read_options);
+    for (it->seek(p.second.first_lsn);
+         it->state() == IteratorState::AT_RECORD &&
+         it->getLSN() <= p.second.max_lsn && bytes_read < max_bytes;
+         it->next()) {
+      bytes_read += it->getRecord().size;
+      ++records_read;
+    }
+  }
+
+  auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+      currentSteadyTime() - start_time);
+  ld_info("Shard %d: cache warm-up read %lu records (%lu bytes) of %lu hot "
+          "logs across %lu partitions in %.3fs.",
+          getShardIdx(),
+          records_read,
+          bytes_read,
+          logs.size(),
+          partitions.size(),
+          duration.count() / 1e3);
+}
+
 PartitionedRocksDBStore::GetWritePartitionResult
 PartitionedRocksDBStore::getWritePartition(
     logid_t log_id,
@@ -3213,6 +3472,52 @@ int PartitionedRocksDBStore::writeMultiImpl(
   ld_check_eq(*min_target_partition_est, min_target_partition->id_);
   ld_check(!min_target_partition->is_dropped);
 
+  if (getSettings()->group_writes_by_log_ && writes.size() > 1) {
+    // Group record ops by target column family and log before handing them
+    // to RocksDBWriter, so that memtable inserts for the same log end up
+    // adjacent in the write batch. With the per-log insert hint
+    // (rocksdb-enable-insert-hint) every insert after the first one in a
+    // group starts from a cached skiplist position instead of a full
+    // search; interleaved logs would otherwise bounce the hint on every op.
+    // stable_sort preserves the relative order of ops with the same key
+    // (e.g. merge operands for different waves of one record).
+    auto sort_key = [&](size_t i) {
+      logid_t log = LOGID_INVALID;
+      lsn_t lsn = LSN_INVALID;
+      switch (writes[i]->getType()) {
+        case WriteType::PUT:
+        case WriteType::DELETE: {
+          const RecordWriteOp* op =
+              static_cast<const RecordWriteOp*>(writes[i]);
+          log = op->log_id;
+          lsn = op->lsn;
+          break;
+        }
+        case WriteType::DUMP_RELEASE_STATE:
+        case WriteType::PUT_LOG_METADATA:
+        case WriteType::PUT_SHARD_METADATA:
+        case WriteType::DELETE_LOG_METADATA:
+        case WriteType::MERGE_MUTABLE_PER_EPOCH_METADATA:
+          break;
+          // Let compiler check that all enum values are handled.
+      }
+      return std::make_tuple(cf_ptrs[i].get(), log.val_, lsn);
+    };
+    std::vector<size_t> order(writes.size());
+    std::iota(order.begin(), order.end(), 0ul);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+      return sort_key(a) < sort_key(b);
+    });
+    std::vector<const WriteOp*> sorted_writes(writes.size());
+    std::vector<RocksDBCFPtr> sorted_cf_ptrs(writes.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+      sorted_writes[i] = writes[order[i]];
+      sorted_cf_ptrs[i] = std::move(cf_ptrs[order[i]]);
+    }
+    writes = std::move(sorted_writes);
+    cf_ptrs = std::move(sorted_cf_ptrs);
+  }
+
   // Go over all holders and mark beginning of write on the partition.
   std::vector<rocksdb::ColumnFamilyHandle*> cf_handles;
   cf_handles.reserve(cf_ptrs.size());
@@ -3368,6 +3673,10 @@ int PartitionedRocksDBStore::writeMultiImpl(
 
       op->newly_dirtied = ndd_kv->second.markDirtyUntil(flush_token);
       ld_check_eq(op->newly_dirtied, emplaced);
+      // Remember the earliest write contributing to the dirty state. It is
+      // persisted along with the dirty metadata and lets mini-rebuilding
+      // skip the clean prefix of the partition after a crash.
+      ndd_kv->second.noteDirtyingWrite(op->timestamp);
 
       // If the write op has to wait for updated PartitionDirtyMetadata
       // to sync out, the caller must treat it as a synchronous write
@@ -3607,6 +3916,11 @@ int PartitionedRocksDBStore::dropPartitions(
   // All partition drops are serialized for simplicity.
   std::lock_guard<std::mutex> drop_lock(oldest_partition_mutex_);
 
+  compactions_in_progress_.fetch_add(1, std::memory_order_relaxed);
+  SCOPE_EXIT {
+    compactions_in_progress_.fetch_sub(1, std::memory_order_relaxed);
+  };
+
   partition_id_t prev_oldest = partitions_.firstID();
   ld_check(prev_oldest == oldest_partition_id_.load());
 
@@ -3688,17 +4002,62 @@ int PartitionedRocksDBStore::dropPartitions(
   // They will see that partition is dropped and choose another partition.
   partition_locks.clear();
 
-  // 4d) Drop column families.
+  // 4d) Queue the column family drops. The DropColumnFamilies() call, the
+  // file deletion that follows it and the cleanup of obsolete partition
+  // metadata are done later by flushPendingDrops(), outside
+  // oldest_partition_mutex_ and partition locks, so that the deletion I/O
+  // of a big retention cycle doesn't block threads that need those locks
+  // (in particular the partition cleaner on the hi-pri background thread,
+  // which shares oldest_partition_mutex_ with us).
+  {
+    std::lock_guard<std::mutex> lock(pending_drops_mutex_);
+    pending_drop_cfs_.insert(
+        pending_drop_cfs_.end(), partitions.begin(), partitions.end());
+    pending_drops_metadata_up_to_ =
+        std::max(pending_drops_metadata_up_to_, oldest_to_keep);
+  }
+
+  STAT_ADD(stats_, partitions_dropped, partitions.size());
+  STAT_SUB(stats_, partitions, partitions.size());
+
+  ld_debug("Dropped partitions [%lu, %lu)", prev_oldest, oldest_to_keep);
+
+  if (error != E::OK) {
+    err = error;
+    return -1;
+  }
+
+  return 0;
+}
+
+void PartitionedRocksDBStore::flushPendingDrops() {
+  std::lock_guard<std::mutex> flush_lock(pending_drops_flush_mutex_);
+
+  std::vector<PartitionPtr> partitions;
+  partition_id_t metadata_up_to;
+  {
+    std::lock_guard<std::mutex> lock(pending_drops_mutex_);
+    std::swap(partitions, pending_drop_cfs_);
+    metadata_up_to = pending_drops_metadata_up_to_;
+  }
+
+  if (partitions.empty()) {
+    return;
+  }
+
   std::vector<rocksdb::ColumnFamilyHandle*> cf_handles;
   cf_handles.reserve(partitions.size());
   for (auto& partition : partitions) {
+    ld_check(partition->is_dropped);
     cf_handles.push_back(partition->cf_->get());
   }
 
   rocksdb::Status status;
   {
-    SCOPED_IO_TRACING_CONTEXT(
-        getIOTracing(), "drop-cfs:{}-{}", prev_oldest, oldest_to_keep - 1);
+    SCOPED_IO_TRACING_CONTEXT(getIOTracing(),
+                              "drop-cfs:{}-{}",
+                              partitions.front()->id_,
+                              partitions.back()->id_);
     status = db_->DropColumnFamilies(cf_handles);
   }
 
@@ -3710,29 +4069,21 @@ int PartitionedRocksDBStore::dropPartitions(
              partitions.back()->id_,
              status.ToString().c_str());
     enterFailSafeIfFailed(status, "DropColumnFamilies()");
-    error = E::LOCAL_LOG_STORE_WRITE;
     // Try to cleanup anyway.
   }
 
-  if (shutdown_event_.signaled()) {
-    err = E::SHUTDOWN;
-    return -1;
-  }
+  // Releasing our references to the dropped partitions destroys the
+  // ColumnFamilyHandles, which makes rocksdb delete the files; the deletion
+  // itself is rate limited by the SstFileManager's trash mechanism.
+  partitions.clear();
 
-  cleanUpPartitionMetadataAfterDrop(oldest_to_keep);
+  // Clean up obsolete metadata only after the column families are dropped.
+  // If we crash in between, the leftover column families will be re-dropped
+  // on startup (by finishInterruptedDrops() or the next retention cycle);
+  // the other order could leave a column family without its metadata, which
+  // would prevent the DB from opening.
+  cleanUpPartitionMetadataAfterDrop(metadata_up_to);
   trimRebuildingRangesMetadata();
-
-  STAT_ADD(stats_, partitions_dropped, partitions.size());
-  STAT_SUB(stats_, partitions, partitions.size());
-
-  ld_debug("Dropped partitions [%lu, %lu)", prev_oldest, oldest_to_keep);
-
-  if (error != E::OK) {
-    err = error;
-    return -1;
-  }
-
-  return 0;
 }
 
 bool PartitionedRocksDBStore::cleanDirtyState(DirtyState& ds,
@@ -4450,7 +4801,8 @@ int PartitionedRocksDBStore::trimLogsBasedOnTime() {
 int PartitionedRocksDBStore::trimLogsBasedOnTime(
     partition_id_t* out_oldest_to_keep,
     std::vector<PartitionToCompact>* out_to_compact,
-    size_t* out_logs_in_grace_period) {
+    size_t* out_logs_in_grace_period,
+    bool incremental) {
   ld_check(!getSettings()->read_only);
   ld_check(!immutable_.load());
   ServerProcessor* processor = processor_.load();
@@ -4497,11 +4849,29 @@ int PartitionedRocksDBStore::trimLogsBasedOnTime(
   const auto now = currentTime().toSeconds();
   partition_id_t oldest_to_keep = latest;
 
-  PartitionDirectoryIterator iterator(*this);
+  // In incremental mode only a slice of the directory is evaluated per call,
+  // resuming from trim_sweep_.resume_after; drop and compaction decisions
+  // are refreshed once per completed pass.
+  const size_t logs_limit =
+      incremental ? settings->trim_sweep_logs_per_iteration : 0ul;
+  size_t logs_seen = 0;
+  size_t logs_in_grace_this_call = 0;
+  logid_t last_log = LOGID_INVALID;
+  bool cycle_complete = true;
+
+  PartitionDirectoryIterator iterator(
+      *this, incremental ? trim_sweep_.resume_after : LOGID_INVALID);
   while (iterator.nextLog()) {
+    if (logs_limit != 0 && logs_seen >= logs_limit) {
+      // Directory not exhausted; the next call picks up from last_log.
+      cycle_complete = false;
+      break;
+    }
+    ++logs_seen;
     logid_t log_id = iterator.getLogID();
+    last_log = log_id;
     folly::Optional<std::chrono::seconds> backlog =
-        getEffectiveBacklogDuration(log_id, out_logs_in_grace_period);
+        getEffectiveBacklogDuration(log_id, &logs_in_grace_this_call);
 
     // For each log we need the following:
     //  - updated trim point for this log
@@ -4607,6 +4977,41 @@ int PartitionedRocksDBStore::trimLogsBasedOnTime(
     return -1;
   }
 
+  if (incremental) {
+    // Fold this slice's results into the cycle state.
+    trim_sweep_.oldest_to_keep =
+        std::min(trim_sweep_.oldest_to_keep, oldest_to_keep);
+    trim_sweep_.logs_in_grace_period += logs_in_grace_this_call;
+    for (auto& it : backlog_durations) {
+      trim_sweep_.partitions_with_trimmed_records[it.first].insert(
+          it.second.partitions_with_trimmed_records.begin(),
+          it.second.partitions_with_trimmed_records.end());
+    }
+
+    if (!cycle_complete) {
+      // Mid-cycle: write out this slice's trim points right away, but report
+      // the previous completed cycle's totals; drop and compaction decisions
+      // are refreshed when the current cycle finishes.
+      trim_sweep_.resume_after = last_log;
+      if (out_oldest_to_keep != nullptr) {
+        *out_oldest_to_keep =
+            trim_sweep_.last_oldest_to_keep == PARTITION_INVALID
+            ? oldest_existing
+            : trim_sweep_.last_oldest_to_keep;
+      }
+      if (out_logs_in_grace_period != nullptr) {
+        *out_logs_in_grace_period = trim_sweep_.last_logs_in_grace_period;
+      }
+      return LocalLogStoreUtils::updateTrimPoints(new_trim_points,
+                                                  processor,
+                                                  *this,
+                                                  /* sync */ true,
+                                                  stats_);
+    }
+
+    oldest_to_keep = trim_sweep_.oldest_to_keep;
+  }
+
   if (out_to_compact != nullptr || out_oldest_to_keep != nullptr) {
     // Prevent empty dirty partitions from being trimmed away. We need
     // them to exist so that under-replicated regions are properly reported
@@ -4643,20 +5048,53 @@ int PartitionedRocksDBStore::trimLogsBasedOnTime(
   }
 
   if (out_to_compact != nullptr) {
-    for (auto& it : backlog_durations) {
-      // Advise compacting those partitions for which all records for logs with
-      // this backlog duration have been marked as trimmed.
-      for (partition_id_t partition :
-           it.second.partitions_with_trimmed_records) {
-        ld_check_lt(partition, it.second.oldest_non_trimmed);
-        if (partition >= oldest_to_keep &&
-            partitions->get(partition)->compacted_retention.load() < it.first) {
-          out_to_compact->emplace_back(partitions->get(partition), it.first);
+    if (incremental) {
+      // Advise compacting partitions accumulated over the whole cycle. Some
+      // of them may have been dropped since they were recorded.
+      for (auto& it : trim_sweep_.partitions_with_trimmed_records) {
+        for (partition_id_t partition : it.second) {
+          if (partition < partitions->firstID()) {
+            continue;
+          }
+          if (partition >= oldest_to_keep &&
+              partitions->get(partition)->compacted_retention.load() <
+                  it.first) {
+            out_to_compact->emplace_back(partitions->get(partition), it.first);
+          }
+        }
+      }
+    } else {
+      for (auto& it : backlog_durations) {
+        // Advise compacting those partitions for which all records for logs
+        // with this backlog duration have been marked as trimmed.
+        for (partition_id_t partition :
+             it.second.partitions_with_trimmed_records) {
+          ld_check_lt(partition, it.second.oldest_non_trimmed);
+          if (partition >= oldest_to_keep &&
+              partitions->get(partition)->compacted_retention.load() <
+                  it.first) {
+            out_to_compact->emplace_back(partitions->get(partition), it.first);
+          }
         }
       }
     }
   }
 
+  if (incremental) {
+    // Cycle complete: publish totals and reset the state for the next pass.
+    trim_sweep_.last_oldest_to_keep = oldest_to_keep;
+    trim_sweep_.last_logs_in_grace_period = trim_sweep_.logs_in_grace_period;
+    if (out_logs_in_grace_period != nullptr) {
+      *out_logs_in_grace_period = trim_sweep_.logs_in_grace_period;
+    }
+    trim_sweep_.resume_after = LOGID_INVALID;
+    trim_sweep_.oldest_to_keep = PARTITION_MAX;
+    trim_sweep_.logs_in_grace_period = 0;
+    trim_sweep_.partitions_with_trimmed_records.clear();
+  } else if (out_logs_in_grace_period != nullptr) {
+    *out_logs_in_grace_period += logs_in_grace_this_call;
+  }
+
   if (out_oldest_to_keep != nullptr) {
     *out_oldest_to_keep = oldest_to_keep;
   }
@@ -4780,8 +5218,10 @@ void PartitionedRocksDBStore::performCompactionInternal(
   }
 
   STAT_INCR(stats_, partition_compactions_in_progress);
+  compactions_in_progress_.fetch_add(1, std::memory_order_relaxed);
   SCOPE_EXIT {
     STAT_DECR(stats_, partition_compactions_in_progress);
+    compactions_in_progress_.fetch_sub(1, std::memory_order_relaxed);
   };
 
   auto start_time = currentSteadyTime();
@@ -6126,6 +6566,13 @@ void PartitionedRocksDBStore::loPriBackgroundThreadRun() {
       break;
     }
 
+    if (getSettings()->cache_warmup_enabled_ &&
+        currentSteadyTime() - last_hot_logs_persist_ >=
+            getSettings()->cache_warmup_persist_interval_) {
+      persistHotLogs();
+      last_hot_logs_persist_ = currentSteadyTime();
+    }
+
     // The order in which partitions are added to `to_compact` defines the
     // priorities of the compactions. From highest to lowest:
     //  1. Retention-based compactions.
@@ -6143,8 +6590,10 @@ void PartitionedRocksDBStore::loPriBackgroundThreadRun() {
     }
 
     size_t logs_in_grace_period = 0;
-    int rv = trimLogsBasedOnTime(
-        &oldest_to_keep, &to_compact, &logs_in_grace_period);
+    int rv = trimLogsBasedOnTime(&oldest_to_keep,
+                                 &to_compact,
+                                 &logs_in_grace_period,
+                                 /* incremental */ true);
     PER_SHARD_STAT_SET(stats_,
                        logs_waiting_for_grace_period,
                        shard_idx_,
@@ -6178,6 +6627,12 @@ void PartitionedRocksDBStore::loPriBackgroundThreadRun() {
           oldest_to_keep, [&]() { return findObsoletePartitions(); });
     }
 
+    // Do the slow part of the drops (column family drops, file deletion,
+    // metadata cleanup) now that all the locks are released. This also picks
+    // up drops queued by other callers of dropPartitions(), e.g. space-based
+    // trimming above.
+    flushPendingDrops();
+
     // Fetching hi-pri manual compactions
     size_t hi_pri_manual_compaction_max_num_per_loop = 1;
     if (getPartitionsForManualCompaction(
@@ -6312,6 +6767,11 @@ void PartitionedRocksDBStore::loPriBackgroundThreadRun() {
                        getSettings()->sst_delete_bytes_per_sec);
   }
 
+  if (getSettings()->cache_warmup_enabled_) {
+    // Capture the final state so that a restart right after a clean shutdown
+    // warms up the freshest set of logs.
+    persistHotLogs();
+  }
   ld_info("Shard %d lo-pri background thread finished", getShardIdx());
 }
 
@@ -12,12 +12,16 @@
 #include <chrono>
 #include <deque>
 #include <limits>
+#include <map>
 #include <mutex>
+#include <set>
 #include <thread>
+#include <unordered_set>
 #include <vector>
 
 #include <folly/IntrusiveList.h>
 #include <folly/SharedMutex.h>
+#include <folly/Synchronized.h>
 #include <folly/ThreadLocal.h>
 #include <folly/concurrency/ConcurrentHashMap.h>
 #include <rocksdb/db.h>
@@ -709,17 +713,34 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
 
   // If true, records for this log are stored in partitions.
   // If false, records are stored in 'unpartitioned' column family.
-  // Currently only metadata logs and internal logs such as the event log are
-  // unpartitioned. If needed, we can put all logs with infinite backlog
-  // duration here, or make it configurable.
+  // Metadata logs and internal logs such as the event log are always
+  // unpartitioned; data logs can additionally be routed there with
+  // --rocksdb-unpartitioned-logs to isolate hot log groups from the
+  // partitioned column families (see RocksDBSettings).
   // Note that metadata logs are written to "unpartitioned" column family
   // rather than "metadata" column family. This is because it has more
   // appropriate RocksDB settings.
   bool isLogPartitioned(logid_t log_id) const {
-    return !MetaDataLog::isMetaDataLog(log_id) &&
-        !configuration::InternalLogs::isInternal(log_id);
+    if (MetaDataLog::isMetaDataLog(log_id) ||
+        configuration::InternalLogs::isInternal(log_id)) {
+      return false;
+    }
+    // Fixed at startup (REQUIRES_RESTART), so no need to re-grab settings
+    // on every call.
+    for (const auto& range : unpartitioned_log_ranges_) {
+      if (log_id >= range.first && log_id <= range.second) {
+        return false;
+      }
+    }
+    return true;
   }
 
+  // True if the log's log group has the "payload-dedup" extras attribute and
+  // the log is partitioned (dedup payload entries are only reclaimed by
+  // partition drops). The per-log answers are cached and invalidated when
+  // the logs config version changes. See PayloadDedup.h.
+  bool isPayloadDedupEnabled(logid_t log_id) const override;
+
   // Memtables belonging to given column families will be flushed and committed
   // to manifest as a single atomic operation. Note: This works only if db is
   // opened with atomic_flush set to true.
@@ -760,6 +781,20 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
       const std::vector<logid_t>& logs,
       std::vector<std::pair<logid_t, DirectoryEntry>>& out) const;
 
+  // Records the log in the set of recently hot logs if cache warm-up is
+  // enabled. The set is periodically persisted to a sidecar file in the
+  // shard directory; warmUpCaches() replays it after a restart.
+  void noteLogAccessed(logid_t log_id) override;
+
+  // Primes rocksdb block cache and OS page cache by reading recent
+  // partitions of the logs that were hot before the last restart, as
+  // recorded by noteLogAccessed(). Called on server startup, before the
+  // node starts gossiping, so that traffic arrives on a warm cache.
+  // No-op unless --rocksdb-cache-warmup is set, the hot logs file exists
+  // and the DB is stored locally. Bounded by
+  // --rocksdb-cache-warmup-max-bytes-per-shard.
+  void warmUpCaches();
+
   // Returns the total size of trash files for this shard.
   uint64_t getTotalTrashSize();
 
@@ -1162,13 +1197,17 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
 
   // Returns true if a previous LogDevice failure has left one or more
   // partitions potentially under replicated.
-  bool isUnderReplicated() const {
+  bool isUnderReplicated() const override {
     return max_under_replicated_partition_.load(std::memory_order_relaxed) !=
         PARTITION_INVALID;
   }
 
   WriteThrottleState subclassSuggestedThrottleState() override;
 
+  bool isCompactionInProgress() const override {
+    return compactions_in_progress_.load(std::memory_order_relaxed) > 0;
+  }
+
   void markImmutable() override {
     joinBackgroundThreads();
   }
@@ -1589,9 +1628,18 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
   //        This counts the number of logs that were removed from the config,
   //        but whose data hasn't been trimmed, as they are waiting for
   //        grace period to expire.
+  // @param incremental
+  //        If true and the shard has more logs than
+  //        --rocksdb-trim-sweep-logs-per-iteration, only a slice of the
+  //        directory is evaluated per call, resuming from where the previous
+  //        call stopped (see trim_sweep_). Mid-cycle calls return the
+  //        results of the last completed cycle in the output arguments;
+  //        drop/compaction decisions are only refreshed when a cycle
+  //        completes. Must only be used from the lo-pri background thread.
   int trimLogsBasedOnTime(partition_id_t* out_oldest_to_keep,
                           std::vector<PartitionToCompact>* out_to_compact,
-                          size_t* out_logs_in_grace_period);
+                          size_t* out_logs_in_grace_period,
+                          bool incremental = false);
 
   // Updates log trim points so that all records in partitions
   // [1, oldest_to_keep) are trimmed.
@@ -1612,15 +1660,29 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
   // partition drops and trim point updates.
   // Dropping the latest partition is not allowed.
   //
+  // Only does the fast, logical part of the drop: the dropped partitions
+  // become invisible to readers and writers before this returns, but the
+  // column families and their files are deleted later by flushPendingDrops().
+  //
   // @return 0 on success, -1 on error. Sets err to:
   //   E::INTERNAL if an assertion failed.
-  //   E::LOCAL_LOG_STORE_WRITE if some RocksDB operation failed.
   //   E::GAP if there was a gap in column family numbers.
   //   E::NOBUFS if maximum number of logs was reached.
   //   E::SHUTDOWN if the the store is shutting down.
   int dropPartitions(partition_id_t oldest_to_keep_est,
                      std::function<partition_id_t()> get_oldest_to_keep);
 
+  // Performs the slow part of partition drops queued by dropPartitions():
+  // drops the column families, releases our references to them (which
+  // deletes the SST files, rate limited by the SstFileManager) and cleans
+  // up the obsolete per-partition metadata. Runs outside
+  // oldest_partition_mutex_ and partition locks so that the deletion I/O
+  // doesn't block threads that need those locks. Called from the lo-pri
+  // background thread, from prependPartitionsInternal() (so that column
+  // family names pending drop can be reused), from finishInterruptedDrops()
+  // and on shutdown.
+  void flushPendingDrops();
+
   // Performs compaction in a way optimized for situation when most of the logs
   // in the partition are fully trimmed. This is usually the case for retention
   // compactions.
@@ -1671,6 +1733,22 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
   // list.
   mutable std::mutex oldest_partition_mutex_;
 
+  // Partitions whose data has been logically dropped (marked is_dropped,
+  // removed from partitions_ and from the directory) but whose column
+  // families haven't been dropped yet. Filled by dropPartitions(), drained
+  // by flushPendingDrops(). Until flushed these partitions only pin some
+  // disk space; readers and writers already skip them.
+  std::mutex pending_drops_mutex_;
+  std::vector<PartitionPtr> pending_drop_cfs_;
+  // Highest oldest_to_keep passed to dropPartitions() so far; tells
+  // flushPendingDrops() how far to clean up per-partition metadata.
+  // Protected by pending_drops_mutex_.
+  partition_id_t pending_drops_metadata_up_to_{PARTITION_INVALID};
+  // Serializes flushPendingDrops() calls. Separate from pending_drops_mutex_
+  // so that dropPartitions() can queue more drops while a slow flush is in
+  // progress.
+  std::mutex pending_drops_flush_mutex_;
+
   // Locked when creating partitions at the end of partition list.
   std::mutex latest_partition_mutex_;
 
@@ -1718,6 +1796,17 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
   // Options used for data partitions
   rocksdb::ColumnFamilyOptions data_cf_options_;
 
+  // Copy of RocksDBSettings::unpartitioned_log_ranges taken at construction
+  // (the setting requires restart); consulted by isLogPartitioned()
+  std::vector<std::pair<logid_t, logid_t>> unpartitioned_log_ranges_;
+
+  // Cache for isPayloadDedupEnabled(), keyed by logs config version.
+  struct PayloadDedupCache {
+    uint64_t config_version{0};
+    std::unordered_map<logid_t, bool, logid_t::Hash> enabled;
+  };
+  mutable folly::Synchronized<PayloadDedupCache> payload_dedup_cache_;
+
   // Processor is needed to:
   //  - update trim points when dropping partitions,
   //  - get trimming policy from config.
@@ -1737,6 +1826,11 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
   // If true, stall low-pri writes to wait for partial compactions to catch up.
   std::atomic<bool> too_many_partial_compactions_{false};
 
+  // Number of compactions and partition drops currently running on this
+  // shard. Storage threads poll it (via isCompactionInProgress()) to
+  // defer non-latency-critical reads while the disk is busy compacting.
+  std::atomic<int> compactions_in_progress_{0};
+
   // Approximate time when "metadata" CF was last compacted.
   SteadyTimestamp last_metadata_manual_compaction_time_;
 
@@ -1783,6 +1877,47 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
   FlushToken last_broadcast_flush_{FlushToken_INVALID};
   std::atomic<bool> cleaner_pass_requested_{false};
 
+  // Name of the sidecar file in the shard directory where the set of
+  // recently hot logs is persisted for cache warm-up.
+  static const char* HOT_LOGS_FILENAME;
+
+  // Logs for which read iterators were created since startup. Only
+  // populated if cache warm-up is enabled; size is capped by
+  // --rocksdb-cache-warmup-tracked-logs.
+  mutable std::mutex hot_logs_mutex_;
+  std::unordered_set<logid_t::raw_type> hot_logs_;
+
+  // When hot_logs_ was last persisted by the lo-pri background thread.
+  SteadyTimestamp last_hot_logs_persist_{SteadyTimestamp::min()};
+
+  // State of the incremental retention sweep (see trimLogsBasedOnTime()
+  // with incremental = true). Only accessed from the lo-pri background
+  // thread, so no locking.
+  struct TrimSweepState {
+    // Log after which the next call resumes the directory scan.
+    // LOGID_INVALID means the next call starts a new cycle.
+    logid_t resume_after{LOGID_INVALID};
+    // Accumulators for the cycle in progress.
+    partition_id_t oldest_to_keep{PARTITION_MAX};
+    size_t logs_in_grace_period{0};
+    std::map<std::chrono::seconds, std::set<partition_id_t>>
+        partitions_with_trimmed_records;
+    // Results of the last completed cycle, reported while a new cycle is
+    // still in progress.
+    partition_id_t last_oldest_to_keep{PARTITION_INVALID};
+    size_t last_logs_in_grace_period{0};
+  };
+  TrimSweepState trim_sweep_;
+
+  // Writes the current hot_logs_ set to HOT_LOGS_FILENAME, atomically via
+  // a temp file. Called periodically from the lo-pri background thread,
+  // and once more when that thread shuts down.
+  void persistHotLogs();
+
+  // Reads the persisted hot logs set. Returns an empty vector if the file
+  // doesn't exist or can't be parsed.
+  std::vector<logid_t> loadHotLogs() const;
+
   // Set to valid partition ids if rebuilding has yet to restore data in one
   // or more partitions that were dirty at the time of an un-safe shutdown.
   std::atomic<partition_id_t> min_under_replicated_partition_{PARTITION_MAX};
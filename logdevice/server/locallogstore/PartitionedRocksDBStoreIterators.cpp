@@ -8,8 +8,10 @@
 #include "logdevice/server/locallogstore/PartitionedRocksDBStoreIterators.h"
 
 #include "logdevice/common/debug.h"
+#include "logdevice/server/ServerProcessor.h"
 #include "logdevice/server/locallogstore/IOTracing.h"
 #include "logdevice/server/locallogstore/RocksDBKeyFormat.h"
+#include "logdevice/server/read_path/LogStorageStateMap.h"
 
 namespace facebook { namespace logdevice {
 
@@ -299,7 +301,32 @@ void PartitionedRocksDBStore::Iterator::createMetaIteratorIfNull() {
       &meta_iterator_bounds_, options_.allow_blocking_io);
 }
 
+void PartitionedRocksDBStore::Iterator::updateTrimPoint() {
+  trim_point_ = LSN_INVALID;
+  if (!pstore_->getSettings()->iterator_skip_trimmed_partitions_) {
+    return;
+  }
+  ServerProcessor* processor = pstore_->processor_.load();
+  if (processor == nullptr) {
+    return;
+  }
+  LogStorageState* log_state =
+      processor->getLogStorageStateMap().find(log_id_, pstore_->getShardIdx());
+  if (log_state != nullptr) {
+    trim_point_ = log_state->getTrimPoint();
+  }
+}
+
+bool PartitionedRocksDBStore::Iterator::isFullyTrimmed(
+    const PartitionInfo& p) const {
+  return trim_point_ != LSN_INVALID && p.max_lsn_ != LSN_INVALID &&
+      p.max_lsn_ <= trim_point_ && latest_.partition_ != nullptr &&
+      p.partition_ != latest_.partition_;
+}
+
 void PartitionedRocksDBStore::Iterator::updatePartitionRange() {
+  updateTrimPoint();
+
   // Get latest partition and its first LSN.
   PartitionInfo new_latest;
   auto it = pstore_->logs_.find(log_id_.val_);
@@ -491,6 +518,15 @@ void PartitionedRocksDBStore::Iterator::moveUntilValid(bool forward,
       new_current.max_lsn_ = PartitionDirectoryValue::getMaxLSN(
           meta_iterator_->value().data(), meta_iterator_->value().size());
 
+      if (forward && isFullyTrimmed(new_current)) {
+        // Everything for this log in this partition is behind the trim point
+        // and only awaits compaction; don't pay for a data iterator there.
+        STAT_INCR(pstore_->stats_, logsdb_iterator_skipped_trimmed_partitions);
+        data_iterator_.reset();
+        current_.clear();
+        continue;
+      }
+
       // Set new_current as current_.
       setCurrent(new_current);
       setDataIteratorFromCurrent(filter);
@@ -604,6 +640,14 @@ void PartitionedRocksDBStore::Iterator::seek(lsn_t lsn,
 
   bool above_end = lsn > current_.max_lsn_;
 
+  if (!above_end && isFullyTrimmed(current_)) {
+    // The seek landed in a partition whose records for this log are all
+    // behind the trim point. Skip straight to the next partition in
+    // moveUntilValid() instead of opening a data iterator here.
+    STAT_INCR(pstore_->stats_, logsdb_iterator_skipped_trimmed_partitions);
+    above_end = true;
+  }
+
   if (!above_end) {
     setDataIteratorFromCurrent(filter);
 
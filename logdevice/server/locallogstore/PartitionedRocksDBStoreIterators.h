@@ -132,6 +132,14 @@ class PartitionedRocksDBStore::Iterator : public LocalLogStore::ReadIterator {
   // Updates latest_ and oldest_partition_id_.
   // latest_.partition_ == nullptr indicates that the log is empty.
   void updatePartitionRange();
+  // Refreshes trim_point_ from LogStorageState. Called on seeks, alongside
+  // updatePartitionRange().
+  void updateTrimPoint();
+  // True if all records of this log in the partition are at or below the
+  // trim point, i.e. the partition only has data pending removal by
+  // compaction. The latest partition is exempt since its max_lsn_ keeps
+  // growing as records are written.
+  bool isFullyTrimmed(const PartitionInfo& p) const;
   // If meta_iterator_ == nullptr, create it.
   void createMetaIteratorIfNull();
 
@@ -203,6 +211,11 @@ class PartitionedRocksDBStore::Iterator : public LocalLogStore::ReadIterator {
   // Last seen id of the oldest existing partition.
   partition_id_t oldest_partition_id_ = PARTITION_INVALID;
 
+  // Trim point of the log as of the last seek, LSN_INVALID if unknown.
+  // Used to skip directory entries of partitions whose records are all
+  // trimmed but not compacted away yet.
+  lsn_t trim_point_ = LSN_INVALID;
+
   // If meta_iterator_'s status() is not ok, state() returns ERROR or WOULDBLOCK
   // based on meta_iterator_. Otherwise, state() returns state_.
   IteratorState state_ = IteratorState::AT_END;
@@ -347,10 +360,15 @@ class PartitionedRocksDBStore::PartitionedAllLogsIterator
 class PartitionedRocksDBStore::PartitionDirectoryIterator {
  public:
   // Initially not pointed to any log. Call nextLog() before anything else.
-  explicit PartitionDirectoryIterator(PartitionedRocksDBStore& store)
+  // If @param start_after is given, the first nextLog() call positions on
+  // the first log with ID greater than it; used by the incremental retention
+  // sweep to resume a partial pass over the directory.
+  explicit PartitionDirectoryIterator(PartitionedRocksDBStore& store,
+                                      logid_t start_after = LOGID_INVALID)
       : store_(store),
         latest_partition_(store_.latest_.get()->id_),
-        meta_it_(store_.createMetadataIterator()) {}
+        meta_it_(store_.createMetadataIterator()),
+        log_id_(start_after) {}
 
   // Returns true if rocksdb reported an error, and this iterator is in a bad
   // state. If this is true, next*() will do nothing and return false.
@@ -388,7 +406,7 @@ class PartitionedRocksDBStore::PartitionDirectoryIterator {
   partition_id_t latest_partition_;
   // Positioned on _next_ partition (so that we can get last_* from it).
   RocksDBIterator meta_it_;
-  logid_t log_id_{0};
+  logid_t log_id_;
   partition_id_t partition_id_{PARTITION_INVALID};
   lsn_t first_lsn_;
 
@@ -0,0 +1,49 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/locallogstore/PayloadDedup.h"
+
+#include <cstring>
+
+#include <folly/hash/SpookyHashV2.h>
+
+namespace facebook { namespace logdevice { namespace PayloadDedup {
+
+Reference makeReference(const Slice& payload) {
+  Reference ref;
+  ref.hash_hi = 0;
+  ref.hash_lo = 0;
+  folly::hash::SpookyHashV2::Hash128(
+      payload.data, payload.size, &ref.hash_hi, &ref.hash_lo);
+  ref.size = payload.size;
+  return ref;
+}
+
+void serializeReference(const Reference& ref, std::string* out) {
+  out->reserve(out->size() + REFERENCE_SIZE);
+  out->push_back(static_cast<char>(MAGIC));
+  out->append(reinterpret_cast<const char*>(&ref.size), sizeof(ref.size));
+  out->append(reinterpret_cast<const char*>(&ref.hash_hi), sizeof(ref.hash_hi));
+  out->append(reinterpret_cast<const char*>(&ref.hash_lo), sizeof(ref.hash_lo));
+}
+
+int parseReference(const Slice& blob, Reference* ref_out) {
+  if (blob.size != REFERENCE_SIZE ||
+      *reinterpret_cast<const uint8_t*>(blob.data) != MAGIC) {
+    err = E::MALFORMED_RECORD;
+    return -1;
+  }
+  const char* ptr = reinterpret_cast<const char*>(blob.data) + 1;
+  memcpy(&ref_out->size, ptr, sizeof(ref_out->size));
+  ptr += sizeof(ref_out->size);
+  memcpy(&ref_out->hash_hi, ptr, sizeof(ref_out->hash_hi));
+  ptr += sizeof(ref_out->hash_hi);
+  memcpy(&ref_out->hash_lo, ptr, sizeof(ref_out->hash_lo));
+  return 0;
+}
+
+}}} // namespace facebook::logdevice::PayloadDedup
@@ -0,0 +1,82 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "logdevice/common/types_internal.h"
+#include "logdevice/include/Err.h"
+
+namespace facebook { namespace logdevice { namespace PayloadDedup {
+
+/**
+ * @file Content-addressed payload storage for fan-in log groups.
+ *
+ *       Pipelines that fan the same payload out to several logs at write
+ *       time store every copy in full; no per-log compression setting can
+ *       recover that redundancy. When payload dedup is enabled for a log
+ *       group (extras attribute "payload-dedup"), the write path stores
+ *       the payload once per column family under a DedupPayloadKey derived
+ *       from its content hash, and writes the record with
+ *       LocalLogStoreRecordFormat::FLAG_PAYLOAD_DEDUP set and the payload
+ *       section replaced by the small reference blob defined here. Read
+ *       iterators resolve the reference back into a plain record before
+ *       handing it out, so nothing above the local log store sees the
+ *       format.
+ *
+ *       Payload entries live in the same column family as the records that
+ *       reference them. In the partitioned store that means a partition
+ *       drop reclaims the shared payloads together with the records, so no
+ *       reference counting or garbage collection is needed; entries
+ *       orphaned by per-log trimming stick around until their partition is
+ *       dropped, which is how the bulk of logsdb space is reclaimed anyway.
+ *
+ *       Entries are addressed by a 128-bit SpookyHash of the payload plus
+ *       its length. A collision would make a record resolve to the wrong
+ *       payload; at 128 bits plus the length check this is far below the
+ *       error rates the rest of the read path already tolerates from
+ *       hardware.
+ */
+
+// Extras attribute on a log group that opts its logs into payload dedup
+// when set to "true", e.g.
+//   ldshell logs update --extras "payload-dedup: true" /my-logs
+constexpr const char* EXTRAS_ATTRIBUTE = "payload-dedup";
+
+// The payload section of a record with FLAG_PAYLOAD_DEDUP is laid out as:
+//   { u8 MAGIC, u64 payload size, u64 hash_hi, u64 hash_lo }
+// in host byte order, like the rest of the record format.
+constexpr uint8_t MAGIC = 0xd5;
+
+constexpr size_t REFERENCE_SIZE = 1 + 3 * sizeof(uint64_t);
+
+struct Reference {
+  uint64_t hash_hi;
+  uint64_t hash_lo;
+  uint64_t size;
+};
+
+/**
+ * Computes the content hash of a payload and fills in a Reference for it.
+ */
+Reference makeReference(const Slice& payload);
+
+/**
+ * Appends the serialized form of `ref` to `out`.
+ */
+void serializeReference(const Reference& ref, std::string* out);
+
+/**
+ * Parses the payload section of a record with FLAG_PAYLOAD_DEDUP.
+ * @return 0 on success, -1 with err set to E::MALFORMED_RECORD if the blob
+ *         doesn't have the expected size or magic byte.
+ */
+int parseReference(const Slice& blob, Reference* ref_out);
+
+}}} // namespace facebook::logdevice::PayloadDedup
@@ -18,6 +18,7 @@
 #include "logdevice/common/stats/Stats.h"
 #include "logdevice/server/ServerProcessor.h"
 #include "logdevice/server/ServerWorker.h"
+#include "logdevice/server/locallogstore/PackedRecordFormat.h"
 #include "logdevice/server/locallogstore/RocksDBKeyFormat.h"
 #include "logdevice/server/locallogstore/RocksDBWriterMergeOperator.h"
 #include "logdevice/server/read_path/LogStorageStateMap.h"
@@ -166,6 +167,7 @@ RocksDBCompactionFilter::filterImpl(const rocksdb::Slice& key,
 
   logid_t log_id;
   lsn_t lsn;
+  bool packed_value = false;
   if (header == CopySetIndexKey::HEADER) {
     if (!dd_assert(CopySetIndexKey::valid(key.data(), key.size()),
                    "Invalid CopySetIndexKey: %s",
@@ -191,6 +193,21 @@ RocksDBCompactionFilter::filterImpl(const rocksdb::Slice& key,
     }
     log_id = DataKey::getLogID(key.data());
     lsn = DataKey::getLSN(key.data());
+    folly::StringPiece value_sp(value.data(), value.size());
+    packed_value = !filtering_merge_operand_ &&
+        (PackedRecordFormat::isPacked(value_sp) ||
+         PackedRecordFormat::isPackedV2(value_sp));
+    if (packed_value) {
+      // The value is a packed record group keyed at its first LSN. It may
+      // only be dropped once *all* of its records are behind the trim
+      // point, so compare against the group's last LSN instead.
+      lsn_t max_lsn = PackedRecordFormat::isPackedV2(value_sp)
+          ? PackedRecordFormat::getMaxLSNV2(value_sp)
+          : PackedRecordFormat::getMaxLSN(value_sp);
+      if (max_lsn != LSN_INVALID) {
+        lsn = max_lsn;
+      }
+    }
   }
 
   getTrimInfo(log_id);
@@ -206,9 +223,18 @@ RocksDBCompactionFilter::filterImpl(const rocksdb::Slice& key,
       if (MetaDataLog::isMetaDataLog(log_id)) {
         ++metadata_log_records_removed_;
       }
-      updateRecordAge(log_id, lsn, value);
+      if (!packed_value) {
+        updateRecordAge(log_id, lsn, value);
+      }
+    }
+  } else if (header != IndexKey::HEADER && !filtering_merge_operand_ &&
+             context_ != nullptr && !packed_value &&
+             settings_->compaction_drop_drained_records_) {
+    decision = makeDecisionDrained(header, value);
+    if (decision == Decision::kKeep && header == DataKey::HEADER) {
+      advanceTrimPointIfNeeded(log_id, lsn, value);
     }
-  } else if (header == DataKey::HEADER) {
+  } else if (header == DataKey::HEADER && !packed_value) {
     // This record is ahead of trim point, but maybe it's behind cutoff
     // timestamp. If so, advance trim point. Can't remove the record in this
     // compaction because our trim point update will only be persisted after
@@ -225,6 +251,15 @@ RocksDBCompactionFilter::filterOutAndMaybeSkip(logid_t log_id,
                                                std::string* skip_until) {
   using namespace facebook::logdevice::RocksDBKeyFormat;
 
+  if (key.data()[0] == DataKey::HEADER &&
+      settings_->packed_record_group_max_records_ > 0) {
+    // With record packing enabled, a packed group keyed at or below the trim
+    // point may still contain records above it. kRemoveAndSkipUntil would
+    // drop such a group without consulting the filter, so drop keys one at
+    // a time instead.
+    return Decision::kRemove;
+  }
+
   if (!force_no_skips_) {
     // Tell rocksdb to drop this key-value, and also to drop everything up to
     // key skip_until. We'll fill skip_until with some lower bound estimate
@@ -353,6 +388,79 @@ RocksDBCompactionFilter::makeDecisionPerEpochLogMetadata(logid_t log_id,
   return decision;
 }
 
+// Removing drained record copies
+//
+// When rebuilding drains this shard, it re-replicates the affected records
+// elsewhere and amends the local copies with the DRAINED flag instead of
+// deleting them. Drained copies are invisible: read filters drop them at the
+// copyset index stage and rebuilding doesn't use them as a source. They are
+// only kept to make it cheap to wind the drain back (an amend restoring the
+// copyset is enough to make the existing payload visible again), at the cost
+// of carrying the payloads until retention expires.
+//
+// With --rocksdb-compaction-drop-drained-records the filter reclaims that
+// space. Only fully merged values are considered:
+// - A drain amend seen as an individual merge operand must be kept. Dropping
+//   it alone would leave the original operands to merge back into the
+//   pre-drain copyset, undoing the drain.
+// - RocksDB only folds merge operands into a plain value when compacting the
+//   bottommost level for the key, so a DRAINED value cannot be shadowing an
+//   older visible version that its removal would expose.
+// In practice this means the drain amend is merged into the record by one
+// compaction and the merged copy is removed by the next one, similar to the
+// two-phase trimming above.
+//
+// Custom index entries don't carry record flags, so index entries of drained
+// records stay behind until the trim point catches up; that's harmless, the
+// index is only used to position iterators.
+RocksDBCompactionFilter::Decision
+RocksDBCompactionFilter::makeDecisionDrained(char header,
+                                             const rocksdb::Slice& value) {
+  using namespace facebook::logdevice::RocksDBKeyFormat;
+
+  bool drained;
+  if (header == CopySetIndexKey::HEADER) {
+    LocalLogStoreRecordFormat::csi_flags_t csi_flags;
+    if (!LocalLogStoreRecordFormat::parseCopySetIndexSingleEntry(
+            Slice(value.data(), value.size()),
+            nullptr,
+            nullptr,
+            &csi_flags,
+            -1 /* unused */)) {
+      return Decision::kKeep;
+    }
+    drained = csi_flags & LocalLogStoreRecordFormat::CSI_FLAG_DRAINED;
+  } else {
+    ld_check(header == DataKey::HEADER);
+    LocalLogStoreRecordFormat::flags_t flags;
+    int rv = LocalLogStoreRecordFormat::parse(Slice(value.data(), value.size()),
+                                              nullptr,
+                                              nullptr,
+                                              &flags,
+                                              nullptr,
+                                              nullptr,
+                                              nullptr,
+                                              0,
+                                              nullptr,
+                                              nullptr,
+                                              nullptr,
+                                              -1 /* unused */);
+    if (rv != 0) {
+      return Decision::kKeep;
+    }
+    drained = flags & LocalLogStoreRecordFormat::FLAG_DRAINED;
+  }
+
+  if (!drained) {
+    return Decision::kKeep;
+  }
+
+  ++drained_removed_;
+  // Not using kRemoveAndSkipUntil: neighboring entries aren't necessarily
+  // drained too.
+  return Decision::kRemove;
+}
+
 void RocksDBCompactionFilter::advanceTrimPointIfNeeded(
     logid_t log_id,
     lsn_t lsn,
@@ -409,7 +517,12 @@ RocksDBCompactionFilter::filterMergeImpl(const rocksdb::Slice& key,
     value.remove_prefix(1);
   }
 
-  return filterImpl(key, value, skip_until);
+  // Let filterImpl() know it's looking at an individual merge operand, so it
+  // doesn't apply decisions that are only valid for fully merged values.
+  filtering_merge_operand_ = true;
+  Decision decision = filterImpl(key, value, skip_until);
+  filtering_merge_operand_ = false;
+  return decision;
 }
 
 void RocksDBCompactionFilter::updateRecordAge(logid_t log_id,
@@ -658,6 +771,7 @@ void RocksDBCompactionFilter::flushUpdatedTrimPoints() {
 RocksDBCompactionFilter::~RocksDBCompactionFilter() {
   Processor* processor = &storage_thread_pool_->getProcessor();
   STAT_ADD(processor->stats_, records_trimmed_removed, count_removed_);
+  STAT_ADD(processor->stats_, records_drained_removed, drained_removed_);
   STAT_ADD(processor->stats_,
            metadata_log_records_trimmed_removed,
            metadata_log_records_removed_);
@@ -48,6 +48,10 @@ namespace facebook { namespace logdevice {
  * 2. On the subsequent compaction, expired records will ACTUALLY be erased
  *    from db based on the updated trim point values. It then iterates from here
  *    to compute the next set of trim point values for the next compaction.
+ *
+ * If --rocksdb-compaction-drop-drained-records is enabled, the filter also
+ * removes record copies that rebuilding drained from this shard instead of
+ * carrying them until retention expires. See makeDecisionDrained().
  */
 
 class StorageThreadPool;
@@ -184,6 +188,10 @@ class RocksDBCompactionFilter : public rocksdb::CompactionFilter {
   // the compaction run finishes
   size_t count_removed_ = 0;
 
+  // Number of drained record copies and copyset index entries removed during
+  // compaction; see makeDecisionDrained()
+  size_t drained_removed_ = 0;
+
   // Number of metadata log records removed during compaction
   size_t metadata_log_records_removed_ = 0;
 
@@ -197,6 +205,13 @@ class RocksDBCompactionFilter : public rocksdb::CompactionFilter {
   // true if filterImpl() has never been called yet.
   bool first_record_ = true;
 
+  // true while filterImpl() is processing an individual merge operand
+  // (on behalf of filterMergeImpl()) rather than a fully merged value.
+  // Some decisions, like removing drained record copies, are only valid
+  // for merged values. The filter is used on a single thread, so a plain
+  // member is fine.
+  bool filtering_merge_operand_ = false;
+
   // Don't use kRemoveAndSkipUntil.
   bool force_no_skips_ = false;
 
@@ -215,6 +230,14 @@ class RocksDBCompactionFilter : public rocksdb::CompactionFilter {
 
   Decision makeDecisionPerEpochLogMetadata(logid_t log_id, epoch_t epoch);
 
+  // Decides whether the given record or copyset index entry is a copy that
+  // rebuilding drained from this shard and that can be removed because of
+  // --rocksdb-compaction-drop-drained-records. `header` is the first byte of
+  // the key, identifying its type. Must not be called for merge operands:
+  // removing a drain amend on its own would resurrect the pre-drain copyset
+  // when the remaining operands are merged.
+  Decision makeDecisionDrained(char header, const rocksdb::Slice& value);
+
   void advanceTrimPointIfNeeded(logid_t log_id,
                                 lsn_t lsn,
                                 const rocksdb::Slice& record);
@@ -31,8 +31,19 @@ void RocksDBEnv::Schedule(void (*function)(void* arg),
   job->unschedFunction = unschedFunction;
   job->arg = arg;
   job->pri = pri;
-  job->ioprio_to_set =
-      pri == Priority::LOW ? settings_->low_ioprio : folly::none;
+  // Classify background IO by thread pool: the LOW pool runs compactions,
+  // the HIGH pool runs memtable flushes.
+  switch (pri) {
+    case Priority::LOW:
+      job->ioprio_to_set = settings_->low_ioprio;
+      break;
+    case Priority::HIGH:
+      job->ioprio_to_set = settings_->flush_ioprio;
+      break;
+    default:
+      job->ioprio_to_set = folly::none;
+      break;
+  }
   job->env = this;
 
   rocksdb::EnvWrapper::Schedule(
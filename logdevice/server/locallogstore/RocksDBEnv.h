@@ -81,7 +81,8 @@ class RocksDBEnv : public rocksdb::EnvWrapper {
 
   // We wrap all background jobs to:
   //  (a) set information in ThreadID needed to identify rocksdb bg threads,
-  //  (b) change io priority if rocksdb-low-ioprio setting is set,
+  //  (b) change io priority if rocksdb-low-ioprio or rocksdb-flush-ioprio
+  //      setting is set,
   //  (c) help RocksDBListener reliably clear IOTracing context at the end of
   //      job execution.
   void Schedule(void (*function)(void* arg),
@@ -41,6 +41,7 @@ enum class KeyPrefix : char {
   DataKey = 'd',
   LogMeta_LogRemovalTime = 'e',
   LogMeta_RsmSnapshot = 'E',
+  DedupPayload = 'h',
   Index = 'I',
   LogMeta_SoftSeal = 'i',
   StoreMeta_ClusterMarker = 'i',
@@ -203,6 +204,10 @@ class DataKey {
  */
 class LogMetaKey {
  public:
+  // Exposed as a named constant because merge operators dispatch on it.
+  static constexpr char HEADER_TRIM_POINT =
+      prefix(KeyPrefix::LogMeta_TrimPoint);
+
   explicit LogMetaKey(LogMetadataType type, logid_t log_id)
       : header_(getHeader(type)), log_id_big_endian_(htobe64(log_id.val_)) {}
 
@@ -221,7 +226,7 @@ class LogMetaKey {
       case LogMetadataType::LAST_RELEASED:
         return prefix(KeyPrefix::LogMeta_LastReleased);
       case LogMetadataType::TRIM_POINT:
-        return prefix(KeyPrefix::LogMeta_TrimPoint);
+        return HEADER_TRIM_POINT;
       case LogMetadataType::SEAL:
         return prefix(KeyPrefix::LogMeta_Seal);
       case LogMetadataType::LAST_CLEAN:
@@ -816,6 +821,34 @@ class CustomIndexDirectoryKey {
   uint64_t partition_id_big_endian_;
 } __attribute__((__packed__));
 
+/**
+ * Key of a deduplicated payload entry (see PayloadDedup.h). Lives in the
+ * same column family as the records that reference it, so that dropping a
+ * partition reclaims the shared payloads along with the records, with no
+ * reference counting. Keyed by the content hash and size of the payload.
+ */
+class DedupPayloadKey {
+ public:
+  DedupPayloadKey(uint64_t hash_hi, uint64_t hash_lo, uint64_t payload_size)
+      : header_(prefix(KeyPrefix::DedupPayload)),
+        hash_hi_big_endian_(htobe64(hash_hi)),
+        hash_lo_big_endian_(htobe64(hash_lo)),
+        size_big_endian_(htobe64(payload_size)) {}
+
+  // Checks if a memory segment represents a valid DedupPayloadKey.
+  static bool valid(const void* blob, size_t size) {
+    return size == sizeof(DedupPayloadKey) &&
+        reinterpret_cast<const char*>(blob)[0] ==
+        prefix(KeyPrefix::DedupPayload);
+  }
+
+ private:
+  char header_;
+  uint64_t hash_hi_big_endian_;
+  uint64_t hash_lo_big_endian_;
+  uint64_t size_big_endian_;
+} __attribute__((__packed__));
+
 class LogSnapshotBlobKey {
  public:
   explicit LogSnapshotBlobKey(LocalLogStore::LogSnapshotBlobType type,
@@ -7,6 +7,7 @@
  */
 #include "logdevice/server/locallogstore/RocksDBLocalLogStore.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <ctime>
 #include <memory>
@@ -29,6 +30,8 @@
 #include "logdevice/include/Err.h"
 #include "logdevice/server/locallogstore/IOTracing.h"
 #include "logdevice/server/locallogstore/IteratorSearch.h"
+#include "logdevice/server/locallogstore/PackedRecordFormat.h"
+#include "logdevice/server/locallogstore/PayloadDedup.h"
 #include "logdevice/server/locallogstore/RocksDBCustomiser.h"
 #include "logdevice/server/locallogstore/RocksDBEnv.h"
 #include "logdevice/server/locallogstore/RocksDBKeyFormat.h"
@@ -169,6 +172,77 @@ RocksDBLocalLogStore::read(logid_t log_id,
                            const LocalLogStore::ReadOptions& options_in) const {
   return std::make_unique<CSIWrapper>(this, log_id, options_in, nullptr);
 }
+int RocksDBLocalLogStore::readRecords(
+    logid_t log_id,
+    const std::vector<lsn_t>& lsns,
+    std::vector<std::string>* blobs_out) const {
+  ld_check(blobs_out != nullptr);
+  ld_assert(std::is_sorted(lsns.begin(), lsns.end()));
+  blobs_out->clear();
+  blobs_out->resize(lsns.size());
+  if (lsns.empty()) {
+    return 0;
+  }
+
+  if (getSettings()->packed_record_group_max_records_ > 0) {
+    // Records may be packed into groups keyed at the group's first LSN,
+    // which point lookups can't find. The iterator-based default decodes
+    // packed groups transparently.
+    return LocalLogStore::readRecords(log_id, lsns, blobs_out);
+  }
+
+  // One batched point lookup over the sorted new-format keys instead of a
+  // full iterator seek per LSN. MultiGet() resolves merge operands the same
+  // way an iterator would.
+  std::vector<DataKey> keys;
+  keys.reserve(lsns.size());
+  std::vector<rocksdb::Slice> key_slices;
+  key_slices.reserve(lsns.size());
+  for (lsn_t lsn : lsns) {
+    keys.emplace_back(log_id, lsn);
+    key_slices.push_back(keys.back().sliceForForwardSeek());
+  }
+  std::vector<std::string> values;
+  std::vector<rocksdb::Status> statuses =
+      db_->MultiGet(getDefaultReadOptions(), key_slices, &values);
+  ld_check(statuses.size() == lsns.size());
+  ld_check(values.size() == lsns.size());
+
+  std::vector<lsn_t> missed_lsns;
+  std::vector<size_t> missed_indexes;
+  for (size_t i = 0; i < statuses.size(); ++i) {
+    const rocksdb::Status& status = statuses[i];
+    if (status.ok()) {
+      (*blobs_out)[i] = std::move(values[i]);
+    } else if (status.IsNotFound()) {
+      // The record may still exist under an old-format key (with the
+      // deprecated wave suffix); fall back to an iterator for these.
+      missed_lsns.push_back(lsns[i]);
+      missed_indexes.push_back(i);
+    } else {
+      RATELIMIT_ERROR(std::chrono::seconds(10),
+                      2,
+                      "MultiGet() failed for log %lu lsn %s: %s",
+                      log_id.val_,
+                      lsn_to_string(lsns[i]).c_str(),
+                      status.ToString().c_str());
+      err = E::LOCAL_LOG_STORE_READ;
+      return -1;
+    }
+  }
+
+  if (!missed_lsns.empty()) {
+    std::vector<std::string> missed_blobs;
+    if (LocalLogStore::readRecords(log_id, missed_lsns, &missed_blobs) != 0) {
+      return -1;
+    }
+    for (size_t i = 0; i < missed_indexes.size(); ++i) {
+      (*blobs_out)[missed_indexes[i]] = std::move(missed_blobs[i]);
+    }
+  }
+  return 0;
+}
+
 std::unique_ptr<LocalLogStore::AllLogsIterator>
 RocksDBLocalLogStore::readAllLogs(
     const LocalLogStore::ReadOptions& options_in,
@@ -222,6 +296,35 @@ int RocksDBLocalLogStore::performCompaction() {
   return 0;
 }
 
+int RocksDBLocalLogStore::ingestSSTFiles(
+    const std::vector<std::string>& paths) {
+  ld_check(!paths.empty());
+
+  rocksdb::IngestExternalFileOptions ingest_options;
+  // Link the files into the DB directory instead of copying them if they
+  // live on the same file system.
+  ingest_options.move_files = true;
+
+  rocksdb::Status status = db_->IngestExternalFile(
+      db_->DefaultColumnFamily(), paths, ingest_options);
+  if (!status.ok()) {
+    // Don't enter fail-safe mode here: a malformed input file is much more
+    // likely than a broken DB, and shouldn't take the shard down.
+    RATELIMIT_ERROR(std::chrono::seconds(10),
+                    2,
+                    "Failed to ingest %lu SST file(s) into shard %d: %s",
+                    paths.size(),
+                    getShardIdx(),
+                    status.ToString().c_str());
+    err = E::LOCAL_LOG_STORE_WRITE;
+    return -1;
+  }
+  ld_info("Ingested %lu SST file(s) into RocksDB shard %d.",
+          paths.size(),
+          getShardIdx());
+  return 0;
+}
+
 int RocksDBLocalLogStore::findTime(
     logid_t log_id,
     std::chrono::milliseconds timestamp,
@@ -440,6 +543,53 @@ class RocksDBLocalLogStore::CSIWrapper::DataIterator
   // If not empty, getRecord() returns this string instead of iterator_'s value.
   std::string merged_value_;
 
+  // If the current record's payload was deduplicated (FLAG_PAYLOAD_DEDUP),
+  // getRecord() lazily rebuilds the plain record here: header with the flag
+  // cleared, followed by the payload fetched from the dedup entry.
+  // See PayloadDedup.h.
+  mutable std::string resolved_value_;
+
+  // Fills resolved_value_ from the current record blob, whose payload
+  // section is a dedup reference. Returns -1 if the reference doesn't parse
+  // or the payload entry can't be read; resolved_value_ is left empty then.
+  int resolveDedupPayload(Slice blob) const;
+
+  // ==== Packed multi-record values (see PackedRecordFormat.h) ====
+
+  // When the underlying iterator stands on a packed value, the LSN of the
+  // group's record we are positioned on, and its blob. For v1 values the
+  // blob points into the rocksdb value (valid until the underlying iterator
+  // moves); for v2 values it points into packed_record_buf_, where the
+  // record is reassembled. LSN_INVALID when the current value is not packed
+  // -- or is packed but malformed, in which case the raw value is exposed
+  // and treated as a malformed record at the key's LSN by the layers above.
+  lsn_t packed_lsn_{LSN_INVALID};
+  folly::StringPiece packed_record_;
+  std::string packed_record_buf_;
+
+  // True if the underlying iterator is on a valid data key whose value is
+  // in the packed format.
+  bool onPackedValue() const;
+
+  // Called with the underlying iterator on a packed value. Positions on the
+  // first record with LSN >= boundary_lsn (FORWARD) or the last with
+  // LSN <= boundary_lsn (BACKWARD); if the group has no such record, steps
+  // the underlying iterator past it and keeps going while it stays on
+  // packed values. The boundary only applies to groups of boundary_log:
+  // when iterating over all logs, a group of another log is entered at its
+  // first (FORWARD) or last (BACKWARD) record.
+  void adjustForPackedValue(Direction dir,
+                            logid_t boundary_log,
+                            lsn_t boundary_lsn);
+
+  // Called after a forward seek to `loc`. Enters the packed group under the
+  // iterator, if any; otherwise, if the seek overshot the target, checks
+  // whether the group at the preceding key covers loc.lsn (groups hold
+  // consecutive LSNs, so only the immediately preceding key can). The probe
+  // costs an extra rocksdb seek or step, so it only runs while
+  // --rocksdb-packed-record-group-max-records is nonzero.
+  void maybeEnterPackedGroup(Location loc);
+
   // Called after moving iterator forward.
   // If the current LSN has both an old-format and a new-format key, merges the
   // values for these keys together, into merged_value_.
@@ -1302,6 +1452,7 @@ void RocksDBLocalLogStore::CSIWrapper::DataIterator::createIteratorIfNeeded() {
 
 void RocksDBLocalLogStore::CSIWrapper::DataIterator::releaseIterator() {
   iterator_.reset();
+  packed_lsn_ = LSN_INVALID;
   trackIteratorRelease();
 }
 
@@ -1359,19 +1510,318 @@ Location RocksDBLocalLogStore::CSIWrapper::DataIterator::getLocation() const {
   ld_check_eq(state(), IteratorState::AT_RECORD);
   ld_check(DataKey::valid(iterator_->key().data(), iterator_->key().size()));
   Location loc(DataKey::getLogID(iterator_->key().data()),
-               DataKey::getLSN(iterator_->key().data()));
+               packed_lsn_ != LSN_INVALID
+                   ? packed_lsn_
+                   : DataKey::getLSN(iterator_->key().data()));
   ld_check_eq(loc.log_id, parent_->log_id_.value_or(loc.log_id));
   return loc;
 }
 
 Slice RocksDBLocalLogStore::CSIWrapper::DataIterator::getRecord() const {
   ld_check(state() == IteratorState::AT_RECORD);
-  if (!merged_value_.empty()) {
+  if (packed_lsn_ != LSN_INVALID) {
+    // Records are never both packed and payload-deduped (the writer
+    // excludes dedup-eligible records from packing), so hand the group
+    // record out directly.
     return facebook::logdevice::Slice(
+        packed_record_.data(), packed_record_.size());
+  }
+  facebook::logdevice::Slice blob;
+  if (!merged_value_.empty()) {
+    blob = facebook::logdevice::Slice(
         merged_value_.data(), merged_value_.size());
+  } else {
+    rocksdb::Slice slice = iterator_->value();
+    blob = facebook::logdevice::Slice(slice.data(), slice.size());
+  }
+
+  bool is_deduped;
+  if (LocalLogStoreRecordFormat::isPayloadDeduped(blob, &is_deduped) == 0 &&
+      is_deduped) {
+    if (!resolved_value_.empty() || resolveDedupPayload(blob) == 0) {
+      return facebook::logdevice::Slice(
+          resolved_value_.data(), resolved_value_.size());
+    }
+    // Resolution failed; hand out the unresolved blob. The client will see
+    // a checksum mismatch, treat this copy as corrupt and get the record
+    // from another node.
+  }
+  return blob;
+}
+
+int RocksDBLocalLogStore::CSIWrapper::DataIterator::resolveDedupPayload(
+    Slice blob) const {
+  Payload payload;
+  int rv = LocalLogStoreRecordFormat::parse(blob,
+                                            nullptr,
+                                            nullptr,
+                                            nullptr,
+                                            nullptr,
+                                            nullptr,
+                                            nullptr,
+                                            0,
+                                            nullptr,
+                                            nullptr,
+                                            &payload,
+                                            parent_->getShardIdx());
+  PayloadDedup::Reference ref;
+  if (rv != 0 ||
+      PayloadDedup::parseReference(
+          Slice(payload.data(), payload.size()), &ref) != 0) {
+    RATELIMIT_ERROR(std::chrono::seconds(10),
+                    10,
+                    "Record %lu%s has FLAG_PAYLOAD_DEDUP but its payload "
+                    "section doesn't parse as a dedup reference.",
+                    getLocation().log_id.val_,
+                    lsn_to_string(getLocation().lsn).c_str());
+    STAT_INCR(getStatsHolder(), payload_dedup_resolution_errors);
+    return -1;
+  }
+
+  std::string dedup_payload;
+  {
+    SCOPED_IO_TRACING_CONTEXT(
+        parent_->getRocksDBStore()->getIOTracing(), "dedup-resolve");
+    RocksDBKeyFormat::DedupPayloadKey key(ref.hash_hi, ref.hash_lo, ref.size);
+    rocksdb::Status status = parent_->getDB().Get(
+        rocksdb::ReadOptions(),
+        parent_->cf_,
+        rocksdb::Slice(reinterpret_cast<const char*>(&key), sizeof(key)),
+        &dedup_payload);
+    if (!status.ok() || dedup_payload.size() != ref.size) {
+      RATELIMIT_ERROR(std::chrono::seconds(10),
+                      10,
+                      "Failed to resolve dedup payload of record %lu%s "
+                      "(%lu bytes): %s",
+                      getLocation().log_id.val_,
+                      lsn_to_string(getLocation().lsn).c_str(),
+                      ref.size,
+                      status.ok() ? "size mismatch"
+                                  : status.ToString().c_str());
+      STAT_INCR(getStatsHolder(), payload_dedup_resolution_errors);
+      return -1;
+    }
+  }
+
+  // Rebuild the plain record: header with the flag cleared, then payload.
+  LocalLogStoreRecordFormat::flags_t flags;
+  int parse_flags_rv = LocalLogStoreRecordFormat::parseFlags(blob, &flags);
+  ld_check(parse_flags_rv == 0); // parse() above succeeded
+  size_t header_size =
+      reinterpret_cast<const char*>(payload.data()) -
+      reinterpret_cast<const char*>(blob.data);
+  resolved_value_.clear();
+  rv = LocalLogStoreRecordFormat::replaceFlags(
+      Slice(blob.data, header_size),
+      flags & ~LocalLogStoreRecordFormat::FLAG_PAYLOAD_DEDUP,
+      &resolved_value_);
+  ld_check(rv == 0); // the header parsed already
+  resolved_value_.append(dedup_payload);
+  return 0;
+}
+
+namespace {
+// Helpers dispatching on the packed value's format version. For v2 values
+// the record blob is reassembled into *buf and *blob_out points into it;
+// for v1 it points into `value` and *buf is untouched.
+
+// Finds the record with the smallest LSN >= lsn in a packed value of
+// either version; see PackedRecordFormat::findRecord().
+int packedFindRecord(folly::StringPiece value,
+                     lsn_t lsn,
+                     lsn_t* lsn_out,
+                     folly::StringPiece* blob_out,
+                     std::string* buf) {
+  if (PackedRecordFormat::isPackedV2(value)) {
+    if (PackedRecordFormat::findRecordV2(value, lsn, lsn_out, buf) != 0) {
+      return -1;
+    }
+    *blob_out = *buf;
+    return 0;
+  }
+  return PackedRecordFormat::findRecord(value, lsn, lsn_out, blob_out);
+}
+
+// Finds the record with the largest LSN <= max_lsn in a packed value of
+// either version, the backward-iteration counterpart of packedFindRecord().
+int packedFloorRecord(folly::StringPiece value,
+                      lsn_t max_lsn,
+                      lsn_t* lsn_out,
+                      folly::StringPiece* blob_out,
+                      std::string* buf) {
+  const bool v2 = PackedRecordFormat::isPackedV2(value);
+  bool found = false;
+  auto cb = [&](lsn_t lsn, folly::StringPiece blob) {
+    if (lsn <= max_lsn) {
+      found = true;
+      *lsn_out = lsn;
+      if (v2) {
+        // The v2 blob only lives until the callback returns.
+        buf->assign(blob.data(), blob.size());
+      } else {
+        *blob_out = blob;
+      }
+    }
+  };
+  int rv = v2 ? PackedRecordFormat::unpackV2(value, cb)
+              : PackedRecordFormat::unpack(value, cb);
+  if (rv != 0) {
+    return -1;
+  }
+  if (!found) {
+    err = E::NOTFOUND;
+    return -1;
+  }
+  if (v2) {
+    *blob_out = *buf;
+  }
+  return 0;
+}
+
+// getMaxLSN() for a packed value of either version.
+lsn_t packedMaxLSN(folly::StringPiece value) {
+  return PackedRecordFormat::isPackedV2(value)
+      ? PackedRecordFormat::getMaxLSNV2(value)
+      : PackedRecordFormat::getMaxLSN(value);
+}
+} // namespace
+
+bool RocksDBLocalLogStore::CSIWrapper::DataIterator::onPackedValue() const {
+  if (!iterator_.has_value() || !iterator_->status().ok() ||
+      !iterator_->Valid()) {
+    return false;
+  }
+  const rocksdb::Slice key = iterator_->key();
+  if (!DataKey::valid(key.data(), key.size())) {
+    return false;
+  }
+  const rocksdb::Slice value = iterator_->value();
+  folly::StringPiece value_sp(value.data(), value.size());
+  return PackedRecordFormat::isPacked(value_sp) ||
+      PackedRecordFormat::isPackedV2(value_sp);
+}
+
+void RocksDBLocalLogStore::CSIWrapper::DataIterator::adjustForPackedValue(
+    Direction dir,
+    logid_t boundary_log,
+    lsn_t boundary_lsn) {
+  packed_lsn_ = LSN_INVALID;
+  while (true) {
+    while (onPackedValue()) {
+      const rocksdb::Slice value = iterator_->value();
+      folly::StringPiece group(value.data(), value.size());
+      // The caller's LSN boundary only constrains the log it was seeking in;
+      // a group of any other log is entered at its edge record.
+      const lsn_t effective_boundary =
+          DataKey::getLogID(iterator_->key().data()) == boundary_log
+          ? boundary_lsn
+          : (dir == Direction::FORWARD ? LSN_INVALID : LSN_MAX);
+      lsn_t lsn;
+      folly::StringPiece blob;
+      int rv = dir == Direction::FORWARD
+          ? packedFindRecord(
+                group, effective_boundary, &lsn, &blob, &packed_record_buf_)
+          : packedFloorRecord(
+                group, effective_boundary, &lsn, &blob, &packed_record_buf_);
+      if (rv == 0) {
+        packed_lsn_ = lsn;
+        packed_record_ = blob;
+        return;
+      }
+      if (err != E::NOTFOUND) {
+        ld_check_eq(err, E::MALFORMED_RECORD);
+        RATELIMIT_ERROR(
+            std::chrono::seconds(10),
+            10,
+            "Malformed packed record group at log %lu lsn %s",
+            DataKey::getLogID(iterator_->key().data()).val_,
+            lsn_to_string(DataKey::getLSN(iterator_->key().data())).c_str());
+        STAT_INCR(getStatsHolder(), packed_record_group_parse_errors);
+        // Stay on the raw value; the layers above will treat it as a
+        // malformed record at the key's LSN.
+        return;
+      }
+      // All records of this group are out of range; move past it.
+      if (dir == Direction::FORWARD) {
+        ROCKSDB_ACCOUNTED_NEXT(iterator_, record);
+      } else {
+        ROCKSDB_ACCOUNTED_PREV(iterator_, record);
+      }
+    }
+    if (dir != Direction::FORWARD) {
+      return;
+    }
+    handleKeyFormatMigration();
+    if (!onPackedValue()) {
+      return;
+    }
+    // The migration stepped onto another packed value; go around again.
+  }
+}
+
+void RocksDBLocalLogStore::CSIWrapper::DataIterator::maybeEnterPackedGroup(
+    Location loc) {
+  packed_lsn_ = LSN_INVALID;
+  if (onPackedValue()) {
+    adjustForPackedValue(Direction::FORWARD, loc.log_id, loc.lsn);
+    return;
+  }
+  if (parent_->getRocksDBStore()
+          ->getSettings()
+          ->packed_record_group_max_records_ == 0 ||
+      !iterator_->status().ok()) {
+    return;
+  }
+  // If the seek overshot the target LSN, the record may live inside a
+  // packed group keyed at a smaller LSN. Groups hold consecutive LSNs, so
+  // it's enough to look at the key immediately preceding the target.
+  bool overshot;
+  bool stepped_back = false;
+  if (!iterator_->Valid()) {
+    overshot = true;
+  } else {
+    const rocksdb::Slice key = iterator_->key();
+    overshot = !DataKey::valid(key.data(), key.size()) ||
+        DataKey::getLogID(key.data()) != loc.log_id ||
+        DataKey::getLSN(key.data()) > loc.lsn;
+  }
+  if (!overshot) {
+    return;
+  }
+  if (iterator_->Valid()) {
+    ROCKSDB_ACCOUNTED_PREV(iterator_, record);
+    stepped_back = true;
+  } else {
+    // Can't step back from an exhausted iterator; seek to the last key at
+    // or before the target instead.
+    DataKey key(loc.log_id, loc.lsn);
+    ROCKSDB_ACCOUNTED_SEEK_FOR_PREV(
+        iterator_, key.sliceForBackwardSeek(), record);
+  }
+  if (iterator_->status().ok() && iterator_->Valid()) {
+    const rocksdb::Slice key = iterator_->key();
+    if (DataKey::valid(key.data(), key.size()) &&
+        DataKey::getLogID(key.data()) == loc.log_id && onPackedValue()) {
+      const rocksdb::Slice value = iterator_->value();
+      if (packedMaxLSN(folly::StringPiece(value.data(), value.size())) >=
+          loc.lsn) {
+        adjustForPackedValue(Direction::FORWARD, loc.log_id, loc.lsn);
+        if (packed_lsn_ != LSN_INVALID) {
+          return;
+        }
+        // The group didn't actually parse (adjustForPackedValue() logged
+        // the error). We can't stay here: we'd be positioned before the
+        // seek target. Fall through and restore the original position.
+      }
+    }
+  }
+  // No covering group; restore the original position.
+  if (stepped_back && iterator_->status().ok() && iterator_->Valid()) {
+    ROCKSDB_ACCOUNTED_NEXT(iterator_, record);
+  } else {
+    DataKey key(loc.log_id, loc.lsn);
+    ROCKSDB_ACCOUNTED_SEEK(iterator_, key.sliceForForwardSeek(), record);
   }
-  rocksdb::Slice slice = iterator_->value();
-  return facebook::logdevice::Slice(slice.data(), slice.size());
 }
 
 void RocksDBLocalLogStore::CSIWrapper::DataIterator::seek(Location loc,
@@ -1380,14 +1830,26 @@ void RocksDBLocalLogStore::CSIWrapper::DataIterator::seek(Location loc,
                             "data:seek{}",
                             dir == Direction::FORWARD ? "" : "ForPrev");
   merged_value_.clear();
+  resolved_value_.clear();
+  packed_lsn_ = LSN_INVALID;
   createIteratorIfNeeded();
   DataKey key(loc.log_id, loc.lsn);
   if (dir == Direction::FORWARD) {
     ROCKSDB_ACCOUNTED_SEEK(iterator_, key.sliceForForwardSeek(), record);
-    handleKeyFormatMigration();
+    maybeEnterPackedGroup(loc);
+    if (packed_lsn_ == LSN_INVALID && !onPackedValue()) {
+      handleKeyFormatMigration();
+      if (onPackedValue()) {
+        // The migration stepped onto a packed value.
+        adjustForPackedValue(Direction::FORWARD, loc.log_id, loc.lsn);
+      }
+    }
   } else {
     ROCKSDB_ACCOUNTED_SEEK_FOR_PREV(
         iterator_, key.sliceForBackwardSeek(), record);
+    if (onPackedValue()) {
+      adjustForPackedValue(Direction::BACKWARD, loc.log_id, loc.lsn);
+    }
   }
   trackSeek(loc.lsn,
             getIteratorVersion(
@@ -1399,12 +1861,44 @@ void RocksDBLocalLogStore::CSIWrapper::DataIterator::step(Direction dir) {
                             "data:{}",
                             dir == Direction::FORWARD ? "next" : "prev");
   merged_value_.clear();
+  resolved_value_.clear();
   ld_assert(state() == IteratorState::AT_RECORD);
+  if (packed_lsn_ != LSN_INVALID) {
+    // Try to move within the current packed group first.
+    const rocksdb::Slice value = iterator_->value();
+    folly::StringPiece group(value.data(), value.size());
+    lsn_t lsn;
+    folly::StringPiece blob;
+    int rv = -1;
+    if (dir == Direction::FORWARD) {
+      rv = packedFindRecord(
+          group, packed_lsn_ + 1, &lsn, &blob, &packed_record_buf_);
+    } else if (packed_lsn_ > lsn_t(0)) {
+      rv = packedFloorRecord(
+          group, packed_lsn_ - 1, &lsn, &blob, &packed_record_buf_);
+    }
+    if (rv == 0) {
+      packed_lsn_ = lsn;
+      packed_record_ = blob;
+      return;
+    }
+    packed_lsn_ = LSN_INVALID;
+  }
   if (dir == Direction::FORWARD) {
     ROCKSDB_ACCOUNTED_NEXT(iterator_, record);
-    handleKeyFormatMigration();
+    if (onPackedValue()) {
+      adjustForPackedValue(Direction::FORWARD, LOGID_INVALID, LSN_INVALID);
+    } else {
+      handleKeyFormatMigration();
+      if (onPackedValue()) {
+        adjustForPackedValue(Direction::FORWARD, LOGID_INVALID, LSN_INVALID);
+      }
+    }
   } else {
     ROCKSDB_ACCOUNTED_PREV(iterator_, record);
+    if (onPackedValue()) {
+      adjustForPackedValue(Direction::BACKWARD, LOGID_INVALID, LSN_MAX);
+    }
   }
 }
 
@@ -1437,6 +1931,15 @@ void RocksDBLocalLogStore::CSIWrapper::DataIterator::
     }
 
     rocksdb::Slice value = iterator_->value();
+    {
+      folly::StringPiece value_sp(value.data(), value.size());
+      if (PackedRecordFormat::isPacked(value_sp) ||
+          PackedRecordFormat::isPackedV2(value_sp)) {
+        // Packed record groups are never amends, and their marker byte
+        // would confuse parseFlags() below.
+        break;
+      }
+    }
     facebook::logdevice::Slice slice(value.data(), value.size());
     LocalLogStoreRecordFormat::flags_t flags;
     int rv = LocalLogStoreRecordFormat::parseFlags(slice, &flags);
@@ -324,6 +324,10 @@ class RocksDBLocalLogStore : public RocksDBLogStoreBase {
   std::unique_ptr<ReadIterator>
   read(logid_t log_id, const LocalLogStore::ReadOptions&) const override;
 
+  int readRecords(logid_t log_id,
+                  const std::vector<lsn_t>& lsns,
+                  std::vector<std::string>* blobs_out) const override;
+
   std::unique_ptr<AllLogsIterator>
   readAllLogs(const LocalLogStore::ReadOptions& options_in,
               const folly::Optional<
@@ -353,6 +357,21 @@ class RocksDBLocalLogStore : public RocksDBLogStoreBase {
    */
   int performCompaction();
 
+  /**
+   * Bulk-ingests externally built SST files into the data column family,
+   * linking them straight into the LSM tree and bypassing memtables and the
+   * WAL. The files must have been produced by rocksdb::SstFileWriter and
+   * contain keys in local log store record format, sorted and not overlapping
+   * one another. This is the recipient half of disk-to-disk rebuilding: a
+   * donor exports a filtered slice of its store and ships the resulting
+   * files here instead of re-replicating record by record. Files are moved
+   * into the DB directory when possible, copied otherwise.
+   *
+   * @return 0 on success, -1 on failure with err set to
+   *         E::LOCAL_LOG_STORE_WRITE. The files are left in place on failure.
+   */
+  int ingestSSTFiles(const std::vector<std::string>& paths);
+
   int isEmpty() const override {
     return isCFEmpty(db_->DefaultColumnFamily());
   }
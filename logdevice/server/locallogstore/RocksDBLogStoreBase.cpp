@@ -361,6 +361,8 @@ rocksdb::ReadOptions RocksDBLogStoreBase::translateReadOptions(
   // allows us to cache and reuse the iterator.
   rocks_options.tailing = opts.tailing;
 
+  rocks_options.readahead_size = opts.readahead_size;
+
   if (upper_bound != nullptr && !upper_bound->empty()) {
     // Since this iterator is only used to read data for a given log, setting
     // iterate_upper_bound allows RocksDB to release some resources when child
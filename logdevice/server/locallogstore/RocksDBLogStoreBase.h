@@ -58,6 +58,11 @@ class RocksDBLogStoreBase : public LocalLogStore {
   Status acceptingWrites() const override {
     if (fail_safe_mode_.load()) {
       return E::DISABLED;
+    } else if (read_only_mode_.load()) {
+      // Report NOSPC rather than DISABLED: appenders route around the shard
+      // (NodeSetState) but nothing treats it as failed, and writes to
+      // metadata and internal logs are still allowed.
+      return E::NOSPC;
     } else if (!space_for_writes_.load()) {
       return E::NOSPC;
     } else if (low_watermark_crossed_.load()) {
@@ -195,6 +200,17 @@ class RocksDBLogStoreBase : public LocalLogStore {
 
   virtual void onMemTableWindowUpdated() {}
 
+  /**
+   * Whether RocksDBWriter should store payloads of the given log as
+   * content-addressed dedup entries (see PayloadDedup.h). Only the
+   * partitioned store supports this: dedup entries are reclaimed by
+   * dropping the partition they live in, and there's nothing to reclaim
+   * them in a plain store.
+   */
+  virtual bool isPayloadDedupEnabled(logid_t /* log_id */) const {
+    return false;
+  }
+
   /**
    * Returns path of RocksDB directory in local file system.
    * Returns folly::none if the DB doesn't live in local file system (but in
@@ -316,6 +332,23 @@ class RocksDBLogStoreBase : public LocalLogStore {
     }
   }
 
+  bool inReadOnlyMode() const override {
+    return read_only_mode_.load();
+  }
+
+  // Enter or leave read-only mode; see LocalLogStore::setReadOnlyMode().
+  bool setReadOnlyMode(bool read_only) override {
+    if (read_only_mode_.exchange(read_only) == read_only) {
+      return false;
+    }
+    ld_info("Shard %d %s read-only mode",
+            (int)shard_idx_,
+            read_only ? "entered" : "left");
+    PER_SHARD_STAT_SET(
+        getStatsHolder(), read_only_log_stores, shard_idx_, read_only ? 1 : 0);
+    return true;
+  }
+
   // If status is an error, count it in stats.
   // No-op if status is ok or incomplete.
   // Convention: if you directly call a rocksdb method that returns a Status,
@@ -597,6 +630,10 @@ class RocksDBLogStoreBase : public LocalLogStore {
   // true if store has failed such that we will not attempt writes.
   mutable std::atomic<bool> fail_safe_mode_{false};
 
+  // True if an operator put the shard in read-only mode to shed write load.
+  // See setReadOnlyMode().
+  std::atomic<bool> read_only_mode_{false};
+
   // True if we're low on space.
   std::atomic<bool> low_watermark_crossed_{false};
 
@@ -267,6 +267,24 @@ void RocksDBLogStoreConfig::addSstFileManagerForShard() {
   }
 }
 
+void RocksDBLogStoreConfig::createPerShardBlockCache(int num_shards) {
+  ld_check(num_shards > 0);
+  const size_t total = rocksdb_settings_->cache_size_;
+  if (total == 0) {
+    return;
+  }
+  rocksdb::LRUCacheOptions opt;
+  opt.capacity = total / num_shards;
+  opt.num_shard_bits = rocksdb_settings_->cache_numshardbits_;
+  opt.high_pri_pool_ratio = rocksdb_settings_->cache_high_pri_pool_ratio_;
+  opt.memory_allocator = getMemoryAllocator();
+  table_options_.block_cache = std::make_shared<RocksDBCache>(opt);
+  // The table factory captured table_options_ when this config was built;
+  // recreate it so the private cache takes effect.
+  options_.table_factory.reset(
+      rocksdb::NewBlockBasedTableFactory(table_options_));
+}
+
 std::shared_ptr<rocksdb::MemoryAllocator>
 RocksDBLogStoreConfig::getMemoryAllocator() {
   if (!rocksdb_settings_->use_nocachedump_memory_allocator) {
@@ -95,6 +95,13 @@ struct RocksDBLogStoreConfig {
   // called on a copy that has been created for a particular shard.
   void addSstFileManagerForShard();
 
+  // Replace the shared uncompressed block cache with a private one sized
+  // at 1/num_shards of --rocksdb-cache-size, and recreate the table
+  // factory to pick it up. Used when --rocksdb-cache-per-shard is set;
+  // like addSstFileManagerForShard(), only call this on a copy that has
+  // been created for a particular shard.
+  void createPerShardBlockCache(int num_shards);
+
  protected:
   std::shared_ptr<rocksdb::MemoryAllocator> getMemoryAllocator();
 };
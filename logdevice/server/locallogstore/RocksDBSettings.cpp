@@ -14,6 +14,7 @@
 
 #include <boost/program_options.hpp>
 #include <folly/Memory.h>
+#include <folly/String.h>
 #include <rocksdb/table.h>
 
 #include "logdevice/common/commandline_util_chrono.h"
@@ -55,6 +56,44 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        SERVER | REQUIRES_RESTART,
        SettingsCategory::RocksDB);
 
+  init("rocksdb-unpartitioned-logs",
+       &unpartitioned_log_ranges,
+       "",
+       [](const std::string& val) {
+         std::vector<std::pair<logid_t, logid_t>> ranges;
+         std::vector<std::string> tokens;
+         folly::split(',', val, tokens, /* ignoreEmpty */ true);
+         for (const std::string& token : tokens) {
+           logid_t::raw_type lo, hi;
+           if (sscanf(token.c_str(), "%lu..%lu", &lo, &hi) == 2) {
+             // range
+           } else if (sscanf(token.c_str(), "%lu", &lo) == 1) {
+             hi = lo;
+           } else {
+             throw boost::program_options::error(
+                 "invalid value '" + token +
+                 "' in --rocksdb-unpartitioned-logs. Expected a "
+                 "comma-separated list of log ids or 'lo..hi' ranges");
+           }
+           if (lo > hi || lo == 0) {
+             throw boost::program_options::error(
+                 "invalid range '" + token +
+                 "' in --rocksdb-unpartitioned-logs");
+           }
+           ranges.emplace_back(logid_t(lo), logid_t(hi));
+         }
+         return ranges;
+       },
+       "comma-separated list of log ids or inclusive 'lo..hi' log id ranges "
+       "whose records are stored in the unpartitioned column family, with "
+       "its own memtable and compaction budget, instead of being interleaved "
+       "with all other logs in the time-partitioned column families. Useful "
+       "for isolating a few ultra-hot log groups from thousands of cold "
+       "ones. Note: such logs are trimmed by the compaction filter instead "
+       "of partition drops, which is more expensive; keep this list short.",
+       SERVER | REQUIRES_RESTART,
+       SettingsCategory::RocksDB);
+
   init("rocksdb-compression-type",
        &compression,
        "lz4",
@@ -146,6 +185,21 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
       SERVER,
       SettingsCategory::RocksDB);
 
+  init("rocksdb-compaction-drop-drained-records",
+       &compaction_drop_drained_records_,
+       "false",
+       nullptr,
+       "If enabled, partition compactions remove record copies that "
+       "rebuilding drained from this shard (re-replicated elsewhere and "
+       "marked with the DRAINED flag). Drained copies are invisible to "
+       "readers and are normally kept until retention expires, only to make "
+       "it cheap to wind a drain back; dropping them reclaims the space "
+       "right away. Only record copies whose drain amend has already been "
+       "merged in by a previous compaction are removed, so the space is "
+       "typically reclaimed by the second compaction after the drain.",
+       SERVER,
+       SettingsCategory::LogsDB);
+
   init("rocksdb-sst-delete-bytes-per-sec",
        &sst_delete_bytes_per_sec,
        "100000000",
@@ -203,6 +257,28 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        SERVER | REQUIRES_RESTART,
        SettingsCategory::RocksDB);
 
+  init("rocksdb-group-writes-by-log",
+       &group_writes_by_log_,
+       "true",
+       nullptr,
+       "Group record writes of a batch by column family and log before "
+       "inserting them into memtables. Makes inserts for the same log "
+       "adjacent so the per-log insert hint (rocksdb-enable-insert-hint) "
+       "stays hot when many logs are interleaved in one batch.",
+       SERVER,
+       SettingsCategory::RocksDB);
+
+  init("rocksdb-iterator-skip-trimmed-partitions",
+       &iterator_skip_trimmed_partitions_,
+       "true",
+       nullptr,
+       "Let single-log iterators skip partitions whose directory entry shows "
+       "that all records of the log are at or below the trim point, instead "
+       "of seeking into them and reading blocks only to find data that is "
+       "pending removal by compaction.",
+       SERVER,
+       SettingsCategory::RocksDB);
+
   init("rocksdb-cache-index-with-high-priority",
        &cache_index_with_high_priority_,
        "false",
@@ -319,6 +395,63 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        SERVER,
        SettingsCategory::LogsDB);
 
+  init("rocksdb-cache-warmup",
+       &cache_warmup_enabled_,
+       "false",
+       nullptr,
+       "If true, keep track of recently read logs and, after a restart, prime "
+       "the block cache and OS page cache by re-reading recent data of those "
+       "logs before the node starts gossiping and accepting traffic. Shortens "
+       "the period of degraded read latency while caches are cold.",
+       SERVER,
+       SettingsCategory::LogsDB);
+
+  init("rocksdb-cache-warmup-max-bytes-per-shard",
+       &cache_warmup_max_bytes_per_shard_,
+       "1G",
+       parse_positive<size_t>(),
+       "Upper bound on how much record data cache warm-up reads per shard. "
+       "Warm-up stops early when the budget is exhausted. Should normally not "
+       "exceed the size of the rocksdb block cache.",
+       SERVER,
+       SettingsCategory::LogsDB);
+
+  init("rocksdb-cache-warmup-tracked-logs",
+       &cache_warmup_tracked_logs_,
+       "10000",
+       parse_positive<size_t>(),
+       "At most this many recently read logs are tracked (and warmed up) per "
+       "shard. Once the limit is reached, additional logs are not tracked "
+       "until the process restarts.",
+       SERVER,
+       SettingsCategory::LogsDB);
+
+  init("rocksdb-cache-warmup-partitions",
+       &cache_warmup_partitions_,
+       "2",
+       parse_positive<size_t>(),
+       "How many of the most recent partitions to warm up for each tracked "
+       "log.",
+       SERVER,
+       SettingsCategory::LogsDB);
+
+  init("rocksdb-cache-warmup-persist-interval",
+       &cache_warmup_persist_interval_,
+       "10min",
+       [](std::chrono::seconds val) {
+         if (val.count() <= 0) {
+           throw boost::program_options::error(
+               "value of --rocksdb-cache-warmup-persist-interval must be "
+               "positive; " +
+               std::to_string(val.count()) + "s given.");
+         }
+       },
+       "How often the set of recently read logs is persisted to the shard "
+       "directory. The persisted set is what warm-up replays after a restart, "
+       "including after a crash.",
+       SERVER,
+       SettingsCategory::LogsDB);
+
   init("rocksdb-unconfigured-log-trimming-grace-period",
        &unconfigured_log_trimming_grace_period_,
        "4d",
@@ -763,6 +896,26 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        SERVER | REQUIRES_RESTART,
        SettingsCategory::ResourceManagement);
 
+  init("rocksdb-flush-ioprio",
+       &flush_ioprio,
+       "",
+       [](const std::string& val) -> folly::Optional<std::pair<int, int>> {
+         folly::Optional<std::pair<int, int>> prio;
+         if (parse_ioprio(val, &prio) != 0) {
+           throw boost::program_options::error(
+               "value of --rocksdb-flush-ioprio must be of the form "
+               "<class>,<data> e.g. 2,6; " +
+               val + " given.");
+         }
+         return prio;
+       },
+       "IO priority to request for hi-pri rocksdb threads, i.e. the pool "
+       "running memtable flushes. This works only if current IO scheduler "
+       "supports IO priorities. See man ioprio_set for possible values. "
+       "\"any\" or \"\" to keep the default. ",
+       SERVER | REQUIRES_RESTART,
+       SettingsCategory::ResourceManagement);
+
   init("rocksdb-worker-blocking-io-threshold",
        &worker_blocking_io_threshold_,
        "10ms",
@@ -1156,6 +1309,18 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        SERVER | REQUIRES_RESTART,
        SettingsCategory::RocksDB);
 
+  init("rocksdb-cache-per-shard",
+       &cache_per_shard_,
+       "false",
+       nullptr,
+       "If true, give each shard its own uncompressed block cache of "
+       "--rocksdb-cache-size divided by the number of shards, instead of one "
+       "cache shared by all shards. On multi-socket machines this keeps cache "
+       "memory on the same NUMA node as the shard's storage threads and "
+       "avoids remote-node cache hits.",
+       SERVER | REQUIRES_RESTART,
+       SettingsCategory::RocksDB);
+
   init("rocksdb-metadata-cache-size",
        &metadata_cache_size_,
        "1G",
@@ -1694,6 +1859,86 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        SERVER | REQUIRES_RESTART,
        SettingsCategory::RocksDB);
 
+  init("rocksdb-payload-dedup-min-size",
+       &payload_dedup_min_size_,
+       "512",
+       parse_nonnegative<ssize_t>(),
+       "Minimum payload size, in bytes, for content-addressed payload "
+       "deduplication. Records of logs whose log group has the "
+       "\"payload-dedup\" extras attribute and whose payload is at least "
+       "this large are stored as a reference to a shared payload entry "
+       "keyed by the payload's content hash. Smaller payloads are stored "
+       "inline; below a few hundred bytes the reference and extra key "
+       "overhead cancel out the savings.",
+       SERVER,
+       SettingsCategory::LogsDB);
+
+  init("rocksdb-packed-record-group-max-records",
+       &packed_record_group_max_records_,
+       "0",
+       parse_nonnegative<ssize_t>(),
+       "If nonzero, consecutive records of one log within a write batch are "
+       "packed into a single data CF value of up to this many records, "
+       "keyed by the first LSN (see PackedRecordFormat.h). For payloads of "
+       "a few hundred bytes this amortizes the per-key rocksdb overhead "
+       "(index entry, restart points, key bytes) across the group. 0 "
+       "disables writing packed values. While packed values exist on disk "
+       "this must stay nonzero so that iterators probe for groups covering "
+       "the seek LSN and point lookups take the iterator path. Copyset "
+       "amends of already-packed records (issued by rebuilding) are not "
+       "applied; do not enable on clusters where that matters yet.",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::LogsDB);
+
+  init("rocksdb-packed-record-max-size",
+       &packed_record_max_size_,
+       "512",
+       parse_nonnegative<ssize_t>(),
+       "Records whose serialized blob (header plus payload) is larger than "
+       "this many bytes are never packed; beyond a few hundred bytes the "
+       "per-key overhead that packing saves is noise.",
+       SERVER,
+       SettingsCategory::LogsDB);
+
+  init("rocksdb-packed-record-format-version",
+       &packed_record_format_version_,
+       "1",
+       parse_validate_range<int>(1, 2),
+       "Format version newly written packed record groups use: 1 stores an "
+       "offset table plus the concatenated record blobs, 2 additionally "
+       "delta-encodes LSNs and timestamps and dictionary-encodes copysets "
+       "across the group (see PackedRecordFormat.h). Readers understand "
+       "both versions regardless of this setting.",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::LogsDB);
+
+  init("rocksdb-trim-sweep-logs-per-iteration",
+       &trim_sweep_logs_per_iteration,
+       "10000",
+       parse_nonnegative<ssize_t>(),
+       "Maximum number of logs whose trim points and partition drop "
+       "eligibility the background retention sweep evaluates per iteration. "
+       "When a shard has more logs than this, the sweep becomes incremental: "
+       "it resumes where the previous iteration stopped, and partition drops "
+       "and retention compactions are only decided when a full pass over the "
+       "directory completes. This spreads the cost of trimming many logs "
+       "over time instead of scanning everything in one go. 0 means "
+       "unlimited (full sweep every iteration).",
+       SERVER,
+       SettingsCategory::LogsDB);
+
+  init("rocksdb-payload-dedup-recent-hash-cache-size",
+       &payload_dedup_recent_hash_cache_size_,
+       "10000",
+       parse_nonnegative<ssize_t>(),
+       "Number of recently written payload content hashes to remember per "
+       "shard, used to skip rewriting a shared payload entry that is "
+       "already durably stored. Without a cache hit the payload entry is "
+       "written with every record that references it, and duplicates are "
+       "only collapsed by compaction. 0 disables the cache.",
+       SERVER,
+       SettingsCategory::LogsDB);
+
 #ifdef LOGDEVICE_ROCKSDB_HAS_SKIP_CHECKING_SST_FILE_SIZES_ON_DB_OPEN
   init("rocksdb-skip-checking-sst-file-sizes-on-db-open",
        &skip_checking_sst_file_sizes_on_db_open,
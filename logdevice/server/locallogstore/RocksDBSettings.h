@@ -124,6 +124,9 @@ class RocksDBSettings : public SettingsBundle {
   // IO priority to request for lo-pri rocksdb threads.
   folly::Optional<std::pair<int, int>> low_ioprio;
 
+  // IO priority to request for hi-pri rocksdb threads (memtable flushes).
+  folly::Optional<std::pair<int, int>> flush_ioprio;
+
   // Log a message if a blocking file deletion takes at least this long on a
   // Worker thread.
   std::chrono::milliseconds worker_blocking_io_threshold_;
@@ -168,6 +171,29 @@ class RocksDBSettings : public SettingsBundle {
   // that is no longer in the config.
   std::chrono::seconds unconfigured_log_trimming_grace_period_;
 
+  // Cache warm-up after restart: track recently read logs, persist them in
+  // a sidecar file in the shard directory and re-read their recent
+  // partitions on startup to prime block cache and page cache before the
+  // node starts serving traffic.
+  bool cache_warmup_enabled_;
+  // Upper bound on how much record data warm-up reads per shard.
+  size_t cache_warmup_max_bytes_per_shard_;
+  // At most this many hot logs are tracked (and warmed up) per shard.
+  size_t cache_warmup_tracked_logs_;
+  // How many of the most recent partitions to warm up.
+  size_t cache_warmup_partitions_;
+  // How often the set of hot logs is persisted.
+  std::chrono::seconds cache_warmup_persist_interval_;
+
+  // Inclusive logid ranges whose records are routed to the 'unpartitioned'
+  // column family instead of the time-partitioned ones. Used to isolate
+  // designated hot log groups in a column family with its own memtable and
+  // compaction budget so they stop polluting the block cache and compaction
+  // pipeline of the partitioned (cold) logs. Such logs lose partition-drop
+  // based trimming; their trim points are enforced by the compaction filter,
+  // same as internal logs. Empty by default.
+  std::vector<std::pair<logid_t, logid_t>> unpartitioned_log_ranges;
+
   // A partitions is considered old if it is older than the these
   // many hours, otherwise it is considered recent. The file num
   // threshold for partial compaction is appropriately applied
@@ -291,9 +317,42 @@ class RocksDBSettings : public SettingsBundle {
   // See cpp file for doc.
   rate_limit_t compaction_rate_limit_;
 
+  // If true, partition compactions remove record copies that rebuilding
+  // drained from this shard (marked with the DRAINED flag). See .cpp.
+  bool compaction_drop_drained_records_;
+
   // if true, all records will have the copyset index written for them
   bool write_copyset_index_;
 
+  // Payloads smaller than this are never deduplicated, even for logs with
+  // the "payload-dedup" extras attribute. See PayloadDedup.h.
+  size_t payload_dedup_min_size_;
+
+  // Size, in entries, of the per-shard cache of content hashes whose payload
+  // entries are already durable, used to skip rewriting them. 0 disables the
+  // cache (payload entries are then written with every record and only
+  // deduplicated by compaction).
+  size_t payload_dedup_recent_hash_cache_size_;
+
+  // Maximum number of consecutive same-log records of one write batch that
+  // get packed into a single data CF value. 0 disables writing packed
+  // values. Reading packed values stays enabled while this is nonzero; see
+  // PackedRecordFormat.h and the setting description in the .cpp.
+  size_t packed_record_group_max_records_;
+
+  // Records whose serialized blob is larger than this are never packed.
+  size_t packed_record_max_size_;
+
+  // Which packed value format new groups are written in: 1 (offset table
+  // plus whole blobs) or 2 (columnar; see PackedRecordFormat::packV2()).
+  // Readers handle both regardless of this setting.
+  int packed_record_format_version_;
+
+  // Maximum number of logs the retention sweep evaluates per background
+  // thread iteration; the sweep resumes from a cursor when the limit is hit.
+  // 0 means no limit. See trimLogsBasedOnTime().
+  size_t trim_sweep_logs_per_iteration;
+
   enum class FlushBlockPolicyType {
     DEFAULT,
     EACH_LOG,
@@ -327,6 +386,12 @@ class RocksDBSettings : public SettingsBundle {
   // uncompressed block cache
   int cache_numshardbits_;
 
+  // If true, each shard gets its own uncompressed block cache of
+  // cache_size_ / num_shards instead of one cache shared by all shards.
+  // With a NUMA-aware allocator, cache memory is then first-touched by
+  // the shard's own storage threads and stays node-local.
+  bool cache_per_shard_;
+
   size_t cache_small_block_threshold_for_high_priority_;
 
   // size of compressed block cache (disabled by default)
@@ -406,6 +471,15 @@ class RocksDBSettings : public SettingsBundle {
   // CPU usage for inserting keys into rocksdb and incur small memory overhead.
   bool enable_insert_hint_;
 
+  // Group record ops of a write batch by column family and log before
+  // inserting them into memtables, to get the most out of the per-log insert
+  // hint when many logs are interleaved in one batch.
+  bool group_writes_by_log_;
+
+  // Let single-log iterators skip partitions whose directory entry shows
+  // that all records of the log are at or below the trim point.
+  bool iterator_skip_trimmed_partitions_;
+
   // If Cache index and filter block in high pri pool of block cache, making
   // them less likely to be evicted than data blocks.
   bool cache_index_with_high_priority_;
@@ -16,6 +16,8 @@
 #include "logdevice/common/Metadata.h"
 #include "logdevice/common/RateLimiter.h"
 #include "logdevice/server/locallogstore/IOTracing.h"
+#include "logdevice/server/locallogstore/PackedRecordFormat.h"
+#include "logdevice/server/locallogstore/PayloadDedup.h"
 #include "logdevice/server/locallogstore/RocksDBKeyFormat.h"
 #include "logdevice/server/locallogstore/RocksDBWriterMergeOperator.h"
 #include "logdevice/server/locallogstore/WriteOps.h"
@@ -24,6 +26,7 @@ namespace facebook { namespace logdevice {
 
 using RocksDBKeyFormat::CopySetIndexKey;
 using RocksDBKeyFormat::DataKey;
+using RocksDBKeyFormat::DedupPayloadKey;
 using RocksDBKeyFormat::LogMetaKey;
 using RocksDBKeyFormat::PerEpochLogMetaKey;
 using RocksDBKeyFormat::StoreMetaKey;
@@ -32,6 +35,16 @@ static_assert(sizeof(DataKey) == 21, "expected 21");
 static_assert(sizeof(LogMetaKey) == 9, "expected 9");
 static_assert(sizeof(StoreMetaKey) == 1, "expected 1");
 
+namespace {
+
+// Role of a write op in packed-record grouping; see
+// --rocksdb-packed-record-group-max-records and PackedRecordFormat.h.
+// The first op of a group writes the packed value for the whole group;
+// the remaining members only write their CSI and index entries.
+enum class PackedRole : uint8_t { NONE, LEADER, MEMBER };
+
+} // namespace
+
 int RocksDBWriter::writeMulti(
     const std::vector<const WriteOp*>& writes,
     const LocalLogStore::WriteOptions& /*write_options*/,
@@ -61,6 +74,79 @@ int RocksDBWriter::writeMulti(
   size_t csi_bytes = 0;
   size_t index_bytes = 0;
 
+  // Cache keys of dedup payload entries written to wal_batch, to be added to
+  // recent_dedup_hashes_ once the batch is durable. See PayloadDedup.h.
+  std::vector<std::string> wal_dedup_cache_keys;
+
+  // Packed-record grouping: runs of small full records of one log with
+  // consecutive LSNs get packed into a single data CF value keyed by the
+  // first LSN. See PackedRecordFormat.h. The LSNs must be consecutive --
+  // not just increasing -- so that at read time the group immediately
+  // preceding a seek target is the only one that can cover it.
+  std::vector<PackedRole> packed_roles;
+  std::vector<size_t> packed_run_end;
+  const size_t packed_group_max =
+      store_->getSettings()->packed_record_group_max_records_;
+  if (packed_group_max > 1) {
+    const size_t packed_max_size =
+        store_->getSettings()->packed_record_max_size_;
+    auto eligible = [&](size_t i) {
+      if (writes[i]->getType() != WriteType::PUT) {
+        return false;
+      }
+      const PutWriteOp* op = static_cast<const PutWriteOp*>(writes[i]);
+      if (op->TEST_data_key_format != DataKeyFormat::DEFAULT ||
+          op->record_header.size + op->data.size > packed_max_size) {
+        return false;
+      }
+      if (payload_dedup_min_size_ != 0 &&
+          op->data.size >= payload_dedup_min_size_ &&
+          store_->isPayloadDedupEnabled(op->log_id)) {
+        // Would go through the payload dedup path; don't pack.
+        return false;
+      }
+      LocalLogStoreRecordFormat::flags_t flags;
+      if (LocalLogStoreRecordFormat::parseFlags(op->record_header, &flags) !=
+              0 ||
+          (flags & LocalLogStoreRecordFormat::PSEUDORECORD_MASK)) {
+        // Amends and other pseudorecords must merge at their own key.
+        return false;
+      }
+      return true;
+    };
+    auto compatible = [&](size_t prev, size_t cur) {
+      const PutWriteOp* p = static_cast<const PutWriteOp*>(writes[prev]);
+      const PutWriteOp* c = static_cast<const PutWriteOp*>(writes[cur]);
+      return c->log_id == p->log_id && c->lsn == p->lsn + 1 &&
+          (data_cf_handles == nullptr ||
+           (*data_cf_handles)[cur] == (*data_cf_handles)[prev]) &&
+          (c->durability() <= Durability::MEMORY) ==
+          (p->durability() <= Durability::MEMORY);
+    };
+    packed_roles.assign(writes.size(), PackedRole::NONE);
+    packed_run_end.assign(writes.size(), 0);
+    size_t i = 0;
+    while (i < writes.size()) {
+      if (!eligible(i)) {
+        ++i;
+        continue;
+      }
+      size_t j = i + 1;
+      while (j < writes.size() && j - i < packed_group_max && eligible(j) &&
+             compatible(j - 1, j)) {
+        ++j;
+      }
+      if (j - i >= 2) {
+        packed_roles[i] = PackedRole::LEADER;
+        packed_run_end[i] = j;
+        std::fill(packed_roles.begin() + i + 1,
+                  packed_roles.begin() + j,
+                  PackedRole::MEMBER);
+      }
+      i = j;
+    }
+  }
+
   for (size_t i = 0; i < writes.size(); ++i) {
     const WriteOp* write = writes[i];
     rocksdb::ColumnFamilyHandle* data_cf =
@@ -108,6 +194,79 @@ int RocksDBWriter::writeMulti(
           }
         }
 
+        // Payload dedup: if the log group opted in and the payload is large
+        // enough, store the payload once under its content hash and write
+        // the record with a small reference in place of the payload. Read
+        // iterators resolve the reference transparently. See PayloadDedup.h.
+        Slice record_header = op->record_header;
+        Slice record_data = op->data;
+        std::string dedup_header_buf;
+        std::string dedup_ref_buf;
+        LocalLogStoreRecordFormat::flags_t record_flags;
+        if (payload_dedup_min_size_ != 0 &&
+            op->data.size >= payload_dedup_min_size_ &&
+            store_->isPayloadDedupEnabled(op->log_id) &&
+            LocalLogStoreRecordFormat::parseFlags(
+                op->record_header, &record_flags) == 0 &&
+            !(record_flags & LocalLogStoreRecordFormat::PSEUDORECORD_MASK)) {
+          PayloadDedup::Reference ref = PayloadDedup::makeReference(op->data);
+          rv = LocalLogStoreRecordFormat::replaceFlags(
+              op->record_header,
+              record_flags | LocalLogStoreRecordFormat::FLAG_PAYLOAD_DEDUP,
+              &dedup_header_buf);
+          if (rv == 0) {
+            PayloadDedup::serializeReference(ref, &dedup_ref_buf);
+            record_header = Slice(
+                dedup_header_buf.data(), dedup_header_buf.size());
+            record_data = Slice(dedup_ref_buf.data(), dedup_ref_buf.size());
+
+            DedupPayloadKey dedup_key(ref.hash_hi, ref.hash_lo, ref.size);
+            rocksdb::Slice dedup_key_slice(
+                reinterpret_cast<const char*>(&dedup_key), sizeof(dedup_key));
+
+            // The payload entry may already be durable; if we've seen its
+            // hash recently, skip rewriting it. The cache key includes the
+            // column family ID because entries are only shared within one
+            // column family (records never reference another partition).
+            std::string cache_key;
+            uint32_t cf_id =
+                (data_cf ? data_cf : store_->getDB().DefaultColumnFamily())
+                    ->GetID();
+            cache_key.append(
+                reinterpret_cast<const char*>(&cf_id), sizeof(cf_id));
+            cache_key.append(dedup_key_slice.data(), dedup_key_slice.size());
+
+            bool skip_payload_put = false;
+            if (recent_dedup_hashes_capacity_ > 0) {
+              std::lock_guard<std::mutex> guard(recent_dedup_hashes_mutex_);
+              skip_payload_put = recent_dedup_hashes_.exists(cache_key);
+            }
+            if (skip_payload_put) {
+              STAT_INCR(
+                  store_->getStatsHolder(), payload_dedup_writes_skipped);
+              STAT_ADD(store_->getStatsHolder(),
+                       payload_dedup_bytes_skipped,
+                       op->data.size);
+            } else {
+              rocksdb_batch.Put(
+                  data_cf,
+                  dedup_key_slice,
+                  rocksdb::Slice(
+                      reinterpret_cast<const char*>(op->data.data),
+                      op->data.size));
+              record_bytes += dedup_key_slice.size() + op->data.size;
+              if (&rocksdb_batch == &wal_batch &&
+                  recent_dedup_hashes_capacity_ > 0) {
+                wal_dedup_cache_keys.push_back(std::move(cache_key));
+              }
+            }
+            STAT_INCR(store_->getStatsHolder(), payload_dedup_records_written);
+          }
+          // If replaceFlags() failed (malformed header; checkWellFormed
+          // above would have caught it unless verification is off), the
+          // record is simply stored inline.
+        }
+
         // NOTE: There is an assumption in prepare_write_op() in
         // RocksDBWriterMergeOperator that the value in RocksDB will be
         // exactly the concatenation of the header and data blobs.  If that
@@ -115,27 +274,81 @@ int RocksDBWriter::writeMulti(
         rocksdb::Slice key_slice =
             key.sliceForWriting(op->TEST_data_key_format);
 
-        folly::small_vector<rocksdb::Slice, 3> value_slices;
-
-        // NOTE: At least RocksDBWriterMergeOperator and
-        // RocksDBCompactionFilter expect this format (header byte then same
-        // as normal non-merge stores).
-        value_slices.emplace_back(
-            &RocksDBWriterMergeOperator::DATA_MERGE_HEADER, 1);
-        value_slices.emplace_back(
-            reinterpret_cast<const char*>(op->record_header.data),
-            op->record_header.size);
-        value_slices.emplace_back(
-            reinterpret_cast<const char*>(op->data.data), op->data.size);
-
-        rocksdb_batch.Merge(
-            data_cf,
-            rocksdb::SliceParts(&key_slice, 1),
-            rocksdb::SliceParts(value_slices.data(), value_slices.size()));
-
-        record_bytes += key_slice.size();
-        for (const auto& s : value_slices) {
-          record_bytes += s.size();
+        const PackedRole packed_role =
+            packed_roles.empty() ? PackedRole::NONE : packed_roles[i];
+        if (packed_role == PackedRole::LEADER) {
+          // Pack this op and the rest of its run into one value, written
+          // with a plain Put (packed values never go through the merge
+          // operator). Eligibility excluded the dedup path, so each
+          // member's blob is just its header and data concatenated.
+          const size_t run_end = packed_run_end[i];
+          std::vector<std::string> blob_bufs;
+          blob_bufs.reserve(run_end - i);
+          for (size_t j = i; j < run_end; ++j) {
+            const PutWriteOp* member =
+                static_cast<const PutWriteOp*>(writes[j]);
+            std::string blob;
+            blob.reserve(member->record_header.size + member->data.size);
+            blob.append(
+                reinterpret_cast<const char*>(member->record_header.data),
+                member->record_header.size);
+            blob.append(reinterpret_cast<const char*>(member->data.data),
+                        member->data.size);
+            blob_bufs.push_back(std::move(blob));
+          }
+          std::vector<std::pair<lsn_t, folly::StringPiece>> group;
+          group.reserve(run_end - i);
+          for (size_t j = i; j < run_end; ++j) {
+            group.emplace_back(
+                static_cast<const PutWriteOp*>(writes[j])->lsn,
+                blob_bufs[j - i]);
+          }
+          std::string packed_value;
+          if (store_->getSettings()->packed_record_format_version_ == 2) {
+            if (PackedRecordFormat::packV2(group, &packed_value) != 0) {
+              // A blob didn't parse as a single-record value. Shouldn't
+              // happen -- eligibility checked the headers -- but fall back
+              // to the v1 format rather than failing the write.
+              packed_value.clear();
+              PackedRecordFormat::pack(group, &packed_value);
+            }
+          } else {
+            PackedRecordFormat::pack(group, &packed_value);
+          }
+          rocksdb_batch.Put(data_cf, key_slice, rocksdb::Slice(packed_value));
+
+          record_bytes += key_slice.size() + packed_value.size();
+          STAT_INCR(store_->getStatsHolder(), packed_record_groups_written);
+          STAT_ADD(store_->getStatsHolder(),
+                   packed_records_written,
+                   group.size());
+        } else if (packed_role == PackedRole::MEMBER) {
+          // The run's leader wrote this record as part of the packed group;
+          // only the CSI and index entries below remain.
+        } else {
+          folly::small_vector<rocksdb::Slice, 3> value_slices;
+
+          // NOTE: At least RocksDBWriterMergeOperator and
+          // RocksDBCompactionFilter expect this format (header byte then same
+          // as normal non-merge stores).
+          value_slices.emplace_back(
+              &RocksDBWriterMergeOperator::DATA_MERGE_HEADER, 1);
+          value_slices.emplace_back(
+              reinterpret_cast<const char*>(record_header.data),
+              record_header.size);
+          value_slices.emplace_back(
+              reinterpret_cast<const char*>(record_data.data),
+              record_data.size);
+
+          rocksdb_batch.Merge(
+              data_cf,
+              rocksdb::SliceParts(&key_slice, 1),
+              rocksdb::SliceParts(value_slices.data(), value_slices.size()));
+
+          record_bytes += key_slice.size();
+          for (const auto& s : value_slices) {
+            record_bytes += s.size();
+          }
         }
 
         if (op->copyset_index_lsn.has_value()) {
@@ -397,6 +610,15 @@ int RocksDBWriter::writeMulti(
     options.disableWAL = true;
   }
 
+  if (!wal_dedup_cache_keys.empty()) {
+    // The batch is durable now; remember which payload entries it wrote so
+    // that future records referencing the same payloads can skip the write.
+    std::lock_guard<std::mutex> guard(recent_dedup_hashes_mutex_);
+    for (std::string& cache_key : wal_dedup_cache_keys) {
+      recent_dedup_hashes_.set(std::move(cache_key), folly::unit);
+    }
+  }
+
   STAT_ADD(store_->getStatsHolder(), record_bytes_written, record_bytes);
   STAT_ADD(store_->getStatsHolder(), csi_bytes_written, csi_bytes);
   STAT_ADD(store_->getStatsHolder(), index_bytes_written, index_bytes);
@@ -508,10 +730,19 @@ int RocksDBWriter::updateLogMetadata(
   LogMetaKey key(metadata.getType(), log_id);
   Slice value(metadata.serialize());
 
-  batch.Put(
-      cf,
-      rocksdb::Slice(reinterpret_cast<const char*>(&key), sizeof key),
-      rocksdb::Slice(reinterpret_cast<const char*>(value.data), value.size));
+  if (detail::useMerge(metadata)) {
+    // The merge operator keeps the maximum, so a stale write can't move the
+    // value backwards even if it races with writers that bypass locks_.
+    batch.Merge(
+        cf,
+        rocksdb::Slice(reinterpret_cast<const char*>(&key), sizeof key),
+        rocksdb::Slice(reinterpret_cast<const char*>(value.data), value.size));
+  } else {
+    batch.Put(
+        cf,
+        rocksdb::Slice(reinterpret_cast<const char*>(&key), sizeof key),
+        rocksdb::Slice(reinterpret_cast<const char*>(value.data), value.size));
+  }
 
   auto p = LogMetadataFactory::create(metadata.getType());
   ld_assert(dynamic_cast<ComparableLogMetadata*>(p.get()) != nullptr);
@@ -960,13 +1191,14 @@ int RocksDBWriter::enumeratePerEpochLogMetadata(
 }
 
 namespace detail {
-bool useMerge(const LogMetadata& /*metadata*/) {
+bool useMerge(const LogMetadata& metadata) {
   // Some LogMetadata types use merge operator, so they need to be written
   // using Merge() instead of a regular Put().
-  // ... except that there are no such LogMetadata types anymore. Maybe there
-  // will be some in future. In particular, all ComparableLogMetadata could
-  // be migrated to use merge operator instead of mutexes.
-  return false;
+  // Trim points merge to the maximum; this lets trim writers skip the
+  // read-modify-write cycle (and the per-log mutex) and makes blind batched
+  // trim writes safe. The remaining ComparableLogMetadata types could be
+  // migrated the same way in the future.
+  return metadata.getType() == LogMetadataType::TRIM_POINT;
 }
 } // namespace detail
 
@@ -13,6 +13,8 @@
 #include <vector>
 
 #include <folly/Demangle.h>
+#include <folly/Unit.h>
+#include <folly/container/EvictingCacheMap.h>
 #include <rocksdb/cache.h>
 #include <rocksdb/db.h>
 #include <rocksdb/env.h>
@@ -64,7 +66,12 @@ class RocksDBWriter {
                          const RocksDBSettings& rocksdb_settings)
       : store_(store),
         read_only_(rocksdb_settings.read_only),
-        locks_(rocksdb_settings.num_metadata_locks) {}
+        locks_(rocksdb_settings.num_metadata_locks),
+        payload_dedup_min_size_(rocksdb_settings.payload_dedup_min_size_),
+        recent_dedup_hashes_capacity_(
+            rocksdb_settings.payload_dedup_recent_hash_cache_size_),
+        recent_dedup_hashes_(
+            std::max<size_t>(1, recent_dedup_hashes_capacity_)) {}
 
   // see common/LocalLogStore.h for the description of these methods
 
@@ -407,6 +414,17 @@ class RocksDBWriter {
   // locks protecting metadata updates (read-modify-write)
   std::vector<std::mutex> locks_;
 
+  // Copies of RocksDBSettings::payload_dedup_* taken at construction.
+  size_t payload_dedup_min_size_;
+  size_t recent_dedup_hashes_capacity_;
+
+  // Serialized DedupPayloadKeys (prefixed with the column family ID) of
+  // payload entries known to be durably written, so that writeMulti() can
+  // skip rewriting them. See PayloadDedup.h. Only entries that went through
+  // the WAL are added. Unused if recent_dedup_hashes_capacity_ is 0.
+  std::mutex recent_dedup_hashes_mutex_;
+  folly::EvictingCacheMap<std::string, folly::Unit> recent_dedup_hashes_;
+
   std::atomic<FlushToken> next_wal_sync_token_{1};
   std::atomic<FlushToken> wal_synced_up_to_token_{0};
 };
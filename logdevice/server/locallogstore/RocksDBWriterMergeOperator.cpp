@@ -18,8 +18,10 @@
 
 #include "logdevice/common/Digest.h"
 #include "logdevice/common/LocalLogStoreRecordFormat.h"
+#include "logdevice/common/Metadata.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/common/types_internal.h"
+#include "logdevice/server/locallogstore/PackedRecordFormat.h"
 #include "logdevice/server/locallogstore/RocksDBKeyFormat.h"
 
 namespace facebook { namespace logdevice {
@@ -28,6 +30,7 @@ namespace facebook { namespace logdevice {
 
 using RocksDBKeyFormat::CopySetIndexKey;
 using RocksDBKeyFormat::DataKey;
+using RocksDBKeyFormat::LogMetaKey;
 using RocksDBKeyFormat::PerEpochLogMetaKey;
 
 bool RocksDBWriterMergeOperator::PartialMergeMulti(
@@ -54,9 +57,14 @@ bool RocksDBWriterMergeOperator::FullMergeV2(
 namespace {
 
 // Flags that should be ORed together from all merge operands.
+// FLAG_PAYLOAD_DEDUP is here because it describes the payload section, which
+// always comes from the operand that carries the payload: amends never go
+// through the dedup path, so if any operand has the flag, it's the payload
+// operand and the merged value's payload is a dedup reference.
 const LocalLogStoreRecordFormat::flags_t CUMULATIVE_RECORD_FLAGS =
     LocalLogStoreRecordFormat::FLAG_WRITTEN_BY_REBUILDING |
-    LocalLogStoreRecordFormat::FLAG_WRITTEN_BY_RECOVERY;
+    LocalLogStoreRecordFormat::FLAG_WRITTEN_BY_RECOVERY |
+    LocalLogStoreRecordFormat::FLAG_PAYLOAD_DEDUP;
 
 // Convert rocksdb::Slice to logdevice::Slice.
 static inline Slice toLdSlice(const rocksdb::Slice& rocksDbSlice) {
@@ -124,6 +132,12 @@ bool handleMutablePerEpochLogMetadata(const rocksdb::Slice& key,
                                       const rocksdb::Slice* existing_value,
                                       const OperandList& operand_list,
                                       DataMergeOutput& out);
+
+template <typename OperandList>
+bool handleTrimPointMetadata(const rocksdb::Slice& key,
+                             const rocksdb::Slice* existing_value,
+                             const OperandList& operand_list,
+                             DataMergeOutput& out);
 } // anonymous namespace
 
 template <typename OperandList>
@@ -160,6 +174,9 @@ bool RocksDBWriterMergeOperator::AnyWayMerge(
     case PerEpochLogMetaKey::HEADER_MUTABLE:
       rv = handleMutablePerEpochLogMetadata(key, existing_value, operands, out);
       break;
+    case LogMetaKey::HEADER_TRIM_POINT:
+      rv = handleTrimPointMetadata(key, existing_value, operands, out);
+      break;
     default:
       RATELIMIT_ERROR(std::chrono::seconds(1),
                       10,
@@ -304,6 +321,26 @@ bool handleDataRecord(const rocksdb::Slice& key,
   };
 
   if (existing_value != nullptr) {
+    folly::StringPiece existing_sp(
+        existing_value->data(), existing_value->size());
+    if (PackedRecordFormat::isPacked(existing_sp) ||
+        PackedRecordFormat::isPackedV2(existing_sp)) {
+      // The existing value is a packed record group keyed at its first LSN.
+      // Merge operands at this key can only be meant for that first record,
+      // and we have no way to amend one record inside a group in place.
+      // Keep the group intact and drop the operands; see the
+      // --rocksdb-packed-record-group-max-records setting for the resulting
+      // limitations.
+      RATELIMIT_WARNING(std::chrono::seconds(10),
+                        10,
+                        "Discarding %zu merge operand(s) for packed record "
+                        "group; key: %s",
+                        static_cast<size_t>(std::distance(
+                            operand_list.begin(), operand_list.end())),
+                        hexdump_buf(key.data(), key.size()).c_str());
+      out.setExistingOperand(toLdSlice(*existing_value));
+      return true;
+    }
     if (!process(toLdSlice(*existing_value))) {
       return false;
     }
@@ -650,6 +687,44 @@ bool handleMutablePerEpochLogMetadata(const rocksdb::Slice& /*key*/,
   return true;
 }
 
+template <typename OperandList>
+bool handleTrimPointMetadata(const rocksdb::Slice& /*key*/,
+                             const rocksdb::Slice* existing_value,
+                             const OperandList& operand_list,
+                             DataMergeOutput& out) {
+  // Trim points are written with Merge() so that concurrent writers (client
+  // trims, the retention sweep, compaction-derived updates) don't need a
+  // read-modify-write cycle; merging keeps the maximum, which matches the
+  // update-to-max semantics trim points have always had.
+  TrimMetadata acc;
+  auto operand_it(operand_list.begin());
+  if (existing_value != nullptr) {
+    if (UNLIKELY(!!acc.deserialize(toLdSlice(*existing_value)))) {
+      return false;
+    }
+  } else {
+    ld_check(operand_it != operand_list.end());
+    if (UNLIKELY(!!acc.deserialize(toLdSlice(*operand_it)))) {
+      return false;
+    }
+    ++operand_it;
+  }
+
+  while (operand_it != operand_list.end()) {
+    TrimMetadata operand;
+    if (UNLIKELY(!!operand.deserialize(toLdSlice(*operand_it)))) {
+      return false;
+    }
+    acc.trim_point_ = std::max(acc.trim_point_, operand.trim_point_);
+    ++operand_it;
+  }
+
+  const Slice acc_slice(acc.serialize());
+  out.new_value.assign(
+      static_cast<const char*>(acc_slice.data), acc_slice.size);
+  return true;
+}
+
 } // anonymous namespace
 
 }} // namespace facebook::logdevice
@@ -173,6 +173,10 @@ void ShardedRocksDBLocalLogStore::init(
       RocksDBLogStoreConfig shard_config = rocksdb_config_;
       shard_config.createMergeOperator(shard_idx);
 
+      if (db_settings_->cache_per_shard_) {
+        shard_config.createPerShardBlockCache(nshards_);
+      }
+
       // Create SstFileManager for this shard
       if (is_db_local_) {
         shard_config.addSstFileManagerForShard();
@@ -0,0 +1,76 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/locallogstore/CopySetSIMDFilter.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "logdevice/common/Random.h"
+
+using namespace facebook::logdevice;
+
+// Reference implementation: the nested std::find loop the SIMD kernel
+// replaces in LocalLogStoreReadFilter.
+static bool containsAnyScalar(const std::vector<ShardID>& copyset,
+                              const std::vector<ShardID>& shards) {
+  for (ShardID s : copyset) {
+    if (std::find(shards.begin(), shards.end(), s) != shards.end()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+TEST(CopySetSIMDFilterTest, PackedKeysAreUnique) {
+  // Padding must not collide with any valid shard, and distinct shards
+  // must produce distinct keys.
+  EXPECT_NE(copyset_simd::PAD_KEY, copyset_simd::packShardKey(ShardID(0, 0)));
+  EXPECT_NE(copyset_simd::packShardKey(ShardID(1, 0)),
+            copyset_simd::packShardKey(ShardID(0, 1)));
+  EXPECT_NE(copyset_simd::packShardKey(ShardID(5, 2)),
+            copyset_simd::packShardKey(ShardID(2, 5)));
+}
+
+TEST(CopySetSIMDFilterTest, Basic) {
+  std::vector<ShardID> copyset = {
+      ShardID(1, 0), ShardID(2, 0), ShardID(3, 1)};
+  EXPECT_TRUE(copyset_simd::copysetContainsAny(
+      copyset.data(), copyset.size(), copyset.data() + 1, 1));
+  ShardID absent(4, 0);
+  EXPECT_FALSE(copyset_simd::copysetContainsAny(
+      copyset.data(), copyset.size(), &absent, 1));
+  // Same node, different shard must not match.
+  ShardID wrong_shard(1, 1);
+  EXPECT_FALSE(copyset_simd::copysetContainsAny(
+      copyset.data(), copyset.size(), &wrong_shard, 1));
+}
+
+TEST(CopySetSIMDFilterTest, MatchesScalarOnRandomInputs) {
+  for (int iter = 0; iter < 1000; ++iter) {
+    const size_t copyset_size = 1 + folly::Random::rand32(COPYSET_SIZE_MAX);
+    std::vector<ShardID> copyset;
+    for (size_t i = 0; i < copyset_size; ++i) {
+      copyset.emplace_back(folly::Random::rand32(20),
+                           folly::Random::rand32(4));
+    }
+    std::vector<ShardID> shards;
+    const size_t num_shards = 1 + folly::Random::rand32(5);
+    for (size_t i = 0; i < num_shards; ++i) {
+      shards.emplace_back(folly::Random::rand32(20),
+                          folly::Random::rand32(4));
+    }
+    EXPECT_EQ(containsAnyScalar(copyset, shards),
+              copyset_simd::copysetContainsAny(copyset.data(),
+                                               copyset.size(),
+                                               shards.data(),
+                                               shards.size()))
+        << "iteration " << iter;
+  }
+}
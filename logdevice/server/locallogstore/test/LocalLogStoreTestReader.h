@@ -76,6 +76,10 @@ class LocalLogStoreTestReader {
     fail_after_ = v;
     return *this;
   }
+  LocalLogStoreTestReader& is_cancelled(std::function<bool()> v) {
+    is_cancelled_ = std::move(v);
+    return *this;
+  }
 
  private:
   logid_t log_id_{1};
@@ -87,6 +91,7 @@ class LocalLogStoreTestReader {
   std::shared_ptr<LocalLogStoreReadFilter> filter_;
   LocalLogStoreReader::ReadPointer read_ptr_{lsn_t{1}};
   int fail_after_ = -1;
+  std::function<bool()> is_cancelled_;
   bool use_csi_ = false;
   bool csi_only_ = false;
   Settings settings_;
@@ -0,0 +1,214 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/locallogstore/PackedRecordFormat.h"
+
+#include <gtest/gtest.h>
+
+#include "logdevice/common/LocalLogStoreRecordFormat.h"
+
+using namespace facebook::logdevice;
+
+namespace {
+
+// Forms a single-record blob (header + payload) as it would be written
+// to the data CF.
+std::string formRecord(int64_t timestamp,
+                       std::vector<ShardID> copyset,
+                       std::string payload) {
+  std::string buf;
+  LocalLogStoreRecordFormat::formRecordHeader(
+      timestamp,
+      esn_t(42),
+      LocalLogStoreRecordFormat::FLAG_SHARD_ID,
+      /*wave_or_recovery_epoch=*/1,
+      folly::Range<const ShardID*>(copyset.data(),
+                                   copyset.data() + copyset.size()),
+      OffsetMap(),
+      std::map<KeyType, std::string>(),
+      &buf);
+  buf += payload;
+  return buf;
+}
+
+} // namespace
+
+TEST(PackedRecordFormatTest, PackUnpackRoundTrip) {
+  std::vector<std::pair<lsn_t, folly::StringPiece>> records = {
+      {10, "alpha"}, {11, "b"}, {15, ""}, {100, "gamma-gamma"}};
+  std::string packed;
+  PackedRecordFormat::pack(records, &packed);
+  ASSERT_TRUE(PackedRecordFormat::isPacked(packed));
+
+  std::vector<std::pair<lsn_t, std::string>> out;
+  ASSERT_EQ(0,
+            PackedRecordFormat::unpack(
+                packed, [&](lsn_t lsn, folly::StringPiece blob) {
+                  out.emplace_back(lsn, blob.str());
+                }));
+  ASSERT_EQ(records.size(), out.size());
+  for (size_t i = 0; i < records.size(); ++i) {
+    EXPECT_EQ(records[i].first, out[i].first);
+    EXPECT_EQ(records[i].second.str(), out[i].second);
+  }
+  EXPECT_EQ(100, PackedRecordFormat::getMaxLSN(packed));
+}
+
+TEST(PackedRecordFormatTest, FindRecord) {
+  std::vector<std::pair<lsn_t, folly::StringPiece>> records = {
+      {10, "a"}, {20, "b"}, {30, "c"}};
+  std::string packed;
+  PackedRecordFormat::pack(records, &packed);
+
+  lsn_t lsn;
+  folly::StringPiece blob;
+  // Exact hit.
+  ASSERT_EQ(0, PackedRecordFormat::findRecord(packed, 20, &lsn, &blob));
+  EXPECT_EQ(20, lsn);
+  EXPECT_EQ("b", blob.str());
+  // Seek between records lands on the next one, like an iterator Seek.
+  ASSERT_EQ(0, PackedRecordFormat::findRecord(packed, 11, &lsn, &blob));
+  EXPECT_EQ(20, lsn);
+  // Before the first record.
+  ASSERT_EQ(0, PackedRecordFormat::findRecord(packed, 0, &lsn, &blob));
+  EXPECT_EQ(10, lsn);
+  // Past the last record.
+  ASSERT_EQ(-1, PackedRecordFormat::findRecord(packed, 31, &lsn, &blob));
+  EXPECT_EQ(E::NOTFOUND, err);
+}
+
+TEST(PackedRecordFormatTest, RejectsCorruptValues) {
+  EXPECT_FALSE(PackedRecordFormat::isPacked(""));
+  EXPECT_FALSE(PackedRecordFormat::isPacked("\x01plain-record"));
+
+  auto expect_malformed = [](const std::string& value) {
+    auto cb = [](lsn_t, folly::StringPiece) {};
+    EXPECT_EQ(-1, PackedRecordFormat::unpack(value, cb));
+    EXPECT_EQ(E::MALFORMED_RECORD, err);
+  };
+  // Marker alone.
+  expect_malformed("\xff");
+  // Count pointing past the end of the value.
+  std::string truncated("\xff", 1);
+  uint16_t count = 1000;
+  truncated.append(reinterpret_cast<const char*>(&count), sizeof(count));
+  expect_malformed(truncated);
+  // Zero records.
+  std::string empty_group("\xff", 1);
+  count = 0;
+  empty_group.append(reinterpret_cast<const char*>(&count), sizeof(count));
+  expect_malformed(empty_group);
+
+  EXPECT_EQ(LSN_INVALID, PackedRecordFormat::getMaxLSN(truncated));
+}
+
+TEST(PackedRecordFormatTest, V2PackUnpackRoundTrip) {
+  std::vector<ShardID> copyset = {ShardID(1, 0), ShardID(2, 0), ShardID(3, 0)};
+  std::vector<std::string> blobs = {
+      formRecord(1000000, copyset, "alpha"),
+      formRecord(1000001, copyset, "b"),
+      // Same timestamp as the previous record (zero delta), new copyset.
+      formRecord(1000001, {ShardID(4, 1)}, ""),
+      // Timestamp going backwards (negative delta), first copyset again.
+      formRecord(999999, copyset, "gamma-gamma"),
+  };
+  std::vector<std::pair<lsn_t, folly::StringPiece>> records = {
+      {10, blobs[0]}, {11, blobs[1]}, {15, blobs[2]}, {100, blobs[3]}};
+  std::string packed;
+  ASSERT_EQ(0, PackedRecordFormat::packV2(records, &packed));
+  ASSERT_TRUE(PackedRecordFormat::isPackedV2(packed));
+  ASSERT_FALSE(PackedRecordFormat::isPacked(packed));
+
+  std::vector<std::pair<lsn_t, std::string>> out;
+  ASSERT_EQ(0,
+            PackedRecordFormat::unpackV2(
+                packed, [&](lsn_t lsn, folly::StringPiece blob) {
+                  out.emplace_back(lsn, blob.str());
+                }));
+  ASSERT_EQ(records.size(), out.size());
+  for (size_t i = 0; i < records.size(); ++i) {
+    EXPECT_EQ(records[i].first, out[i].first);
+    EXPECT_EQ(blobs[i], out[i].second);
+  }
+  EXPECT_EQ(100, PackedRecordFormat::getMaxLSNV2(packed));
+}
+
+TEST(PackedRecordFormatTest, V2FindRecord) {
+  std::vector<ShardID> copyset = {ShardID(1, 0)};
+  std::vector<std::string> blobs = {formRecord(1, copyset, "a"),
+                                    formRecord(2, copyset, "b"),
+                                    formRecord(3, copyset, "c")};
+  std::vector<std::pair<lsn_t, folly::StringPiece>> records = {
+      {10, blobs[0]}, {20, blobs[1]}, {30, blobs[2]}};
+  std::string packed;
+  ASSERT_EQ(0, PackedRecordFormat::packV2(records, &packed));
+
+  lsn_t lsn;
+  std::string blob;
+  ASSERT_EQ(0, PackedRecordFormat::findRecordV2(packed, 20, &lsn, &blob));
+  EXPECT_EQ(20, lsn);
+  EXPECT_EQ(blobs[1], blob);
+  ASSERT_EQ(0, PackedRecordFormat::findRecordV2(packed, 11, &lsn, &blob));
+  EXPECT_EQ(20, lsn);
+  ASSERT_EQ(-1, PackedRecordFormat::findRecordV2(packed, 31, &lsn, &blob));
+  EXPECT_EQ(E::NOTFOUND, err);
+}
+
+TEST(PackedRecordFormatTest, V2Overhead) {
+  // The point of v2: with one shared copyset and near-identical
+  // timestamps, the encoding should spend only a few bytes per record
+  // beyond the payloads, much less than v1's 12B index entry plus the
+  // ~21B of header each record carries inline.
+  std::vector<ShardID> copyset = {ShardID(1, 0), ShardID(2, 0), ShardID(3, 0)};
+  std::vector<std::string> blobs;
+  std::vector<std::pair<lsn_t, folly::StringPiece>> records;
+  size_t payload_bytes = 0;
+  for (lsn_t lsn = 1; lsn <= 100; ++lsn) {
+    blobs.push_back(formRecord(1000000 + lsn, copyset, "0123456789"));
+    payload_bytes += 10;
+  }
+  for (lsn_t lsn = 1; lsn <= 100; ++lsn) {
+    records.emplace_back(lsn, blobs[lsn - 1]);
+  }
+  std::string v1;
+  PackedRecordFormat::pack(records, &v1);
+  std::string v2;
+  ASSERT_EQ(0, PackedRecordFormat::packV2(records, &v2));
+  EXPECT_LT(v2.size(), v1.size());
+  // Timestamp, copyset and the v1 index are amortized; what remains per
+  // record is the ~11B mid column (last_known_good + flags + wave) plus
+  // a few varints.
+  EXPECT_LT(v2.size(), payload_bytes + 16 * records.size() + 100);
+}
+
+TEST(PackedRecordFormatTest, V2RejectsCorruptValues) {
+  auto expect_malformed = [](const std::string& value) {
+    auto cb = [](lsn_t, folly::StringPiece) {};
+    EXPECT_EQ(-1, PackedRecordFormat::unpackV2(value, cb));
+    EXPECT_EQ(E::MALFORMED_RECORD, err);
+  };
+  // Marker alone, and a truncated fixed header.
+  expect_malformed("\xfe");
+  expect_malformed(std::string("\xfe\x01\x00", 3));
+
+  // A valid value truncated at every possible length must not parse.
+  std::vector<ShardID> copyset = {ShardID(1, 0)};
+  std::string blob = formRecord(1, copyset, "payload");
+  std::vector<std::pair<lsn_t, folly::StringPiece>> records = {{10, blob},
+                                                               {20, blob}};
+  std::string packed;
+  ASSERT_EQ(0, PackedRecordFormat::packV2(records, &packed));
+  for (size_t len = 1; len < packed.size(); ++len) {
+    expect_malformed(packed.substr(0, len));
+  }
+
+  // Blobs that aren't single-record values don't pack.
+  std::vector<std::pair<lsn_t, folly::StringPiece>> bad = {{10, "short"}};
+  std::string out;
+  EXPECT_EQ(-1, PackedRecordFormat::packV2(bad, &out));
+  EXPECT_EQ(E::MALFORMED_RECORD, err);
+}
@@ -13,6 +13,7 @@
 #include <iterator>
 #include <queue>
 #include <set>
+#include <unordered_set>
 
 #include <folly/Random.h>
 #include <folly/Varint.h>
@@ -212,6 +213,12 @@ class TestPartitionedRocksDBStore : public PartitionedRocksDBStore {
     return p;
   }
 
+  // Tests opt logs into payload dedup directly instead of going through
+  // logs config extras.
+  bool isPayloadDedupEnabled(logid_t log_id) const override {
+    return payload_dedup_logs_.count(log_id) > 0;
+  }
+
   // Fake throttle state for unit tests.
   WriteThrottleState subclassSuggestedThrottleState() override {
     return std::max(suggested_throttle_state_,
@@ -238,6 +245,7 @@ class TestPartitionedRocksDBStore : public PartitionedRocksDBStore {
 
   SystemTimestamp* time_;
   WriteThrottleState suggested_throttle_state_ = WriteThrottleState::NONE;
+  std::unordered_set<logid_t, logid_t::Hash> payload_dedup_logs_;
 };
 
 using filter_history_t = std::vector<std::pair<std::string, std::string>>;
@@ -645,6 +653,7 @@ class PartitionedRocksDBStoreTest : public ::testing::Test {
     Durability durability = Durability::ASYNC_WRITE;
     bool index = false;
     bool is_amend = false;
+    bool is_drained = false;
     std::map<KeyType, std::string> optional_keys;
     std::string additional_payload;
 
@@ -728,6 +737,10 @@ class PartitionedRocksDBStoreTest : public ::testing::Test {
       is_amend = true;
       return *this;
     }
+    TestRecord& drained() {
+      is_drained = true;
+      return *this;
+    }
     bool operator<(const TestRecord& rhs) const {
       return std::tie(logid, lsn) < std::tie(rhs.logid, rhs.lsn);
     }
@@ -1138,6 +1151,9 @@ class PartitionedRocksDBStoreTest : public ::testing::Test {
         if (ops[i].is_amend) {
           hdr.flags |= STORE_Header::AMEND;
         }
+        if (ops[i].is_drained) {
+          hdr.flags |= STORE_Header::DRAINED;
+        }
         Slice header = formRecordHeader(
             headers[i], hdr, csi_copyset.data(), ops[i].optional_keys);
         Slice payload(payloads[i].data(), payloads[i].size());
@@ -1876,6 +1892,57 @@ TEST_F(PartitionedRocksDBStoreTest, ReadOnlyWritesCrash) {
   ASSERT_DEATH(put({TestRecord(logid, 40)}), "");
 }
 
+TEST_F(PartitionedRocksDBStoreTest, PayloadDedup) {
+  logid_t logid(3);
+
+  closeStore();
+  ServerConfig::SettingsConfig s;
+  s["rocksdb-payload-dedup-min-size"] = "1";
+  openStore(s);
+  store_->payload_dedup_logs_.insert(logid);
+
+  put({TestRecord(logid, 10), TestRecord(logid, 20)});
+  // Log 150 isn't opted in; its payloads are stored inline.
+  put({TestRecord(logid_t(150), 10)});
+
+  Stats stats = stats_.aggregate();
+  EXPECT_EQ(2, stats.payload_dedup_records_written.load());
+  EXPECT_EQ(0, stats.payload_dedup_writes_skipped.load());
+
+  // Re-storing a record with the same payload hits the recent-hash cache and
+  // skips the redundant payload put.
+  put({TestRecord(logid, 10)});
+  stats = stats_.aggregate();
+  EXPECT_EQ(3, stats.payload_dedup_records_written.load());
+  EXPECT_EQ(1, stats.payload_dedup_writes_skipped.load());
+
+  auto read_back = [&](logid_t log, std::vector<lsn_t> lsns) {
+    auto it = store_->read(log, LocalLogStore::ReadOptions("PayloadDedup"));
+    for (lsn_t lsn : lsns) {
+      it->seek(lsn);
+      ASSERT_EQ(IteratorState::AT_RECORD, it->state());
+      ASSERT_EQ(lsn, it->getLSN());
+      Slice record = it->getRecord();
+      // Iterators resolve dedup references in place; the storage-local flag
+      // must not leak to readers.
+      LocalLogStoreRecordFormat::flags_t flags;
+      ASSERT_EQ(0, LocalLogStoreRecordFormat::parseFlags(record, &flags));
+      EXPECT_EQ(0, flags & LocalLogStoreRecordFormat::FLAG_PAYLOAD_DEDUP);
+      verifyRecord(log, lsn, record);
+    }
+  };
+  read_back(logid, {10, 20});
+  read_back(logid_t(150), {10});
+
+  // Deduped records stay readable after a flush and a reopen, even with dedup
+  // turned back off.
+  store_->flushAllMemtables();
+  closeStore();
+  openStore();
+  read_back(logid, {10, 20});
+  read_back(logid_t(150), {10});
+}
+
 TEST_F(PartitionedRocksDBStoreTest, TailingIterator) {
   logid_t logid(2);
 
@@ -6094,6 +6161,38 @@ TEST_F(PartitionedRocksDBStoreTest, CompactionRangeSkip) {
   EXPECT_EQ(std::vector<lsn_t>({450}), data[0][logid_t(230)].records);
 }
 
+TEST_F(PartitionedRocksDBStoreTest, CompactionDropsDrainedRecords) {
+  // Log with infinite retention, so time-based trimming stays out of the way.
+  const logid_t logid(400);
+
+  put({TestRecord(logid, 10, BASE_TIME)});
+  put({TestRecord(logid, 20, BASE_TIME)});
+  put({TestRecord(logid, 30, BASE_TIME)});
+  // Rebuilding drains lsn 20 from this shard: the copy is amended with the
+  // DRAINED flag instead of being deleted.
+  put({TestRecord(logid, 20, BASE_TIME).amend().drained()});
+  store_->createPartition();
+
+  // With the setting disabled (default) compactions keep drained copies
+  // around. The first compaction also merges the drain amend into the record.
+  store_->performCompaction(ID0);
+  store_->performCompaction(ID0);
+  EXPECT_EQ(2, stats_.aggregate().partitions_compacted);
+  EXPECT_EQ(0, stats_.aggregate().records_drained_removed);
+  auto data = readAndCheck();
+  ASSERT_EQ(2, data.size());
+  EXPECT_EQ(std::vector<lsn_t>({10, 20, 30}), data[0][logid].records);
+  openStore();
+
+  updateSetting("rocksdb-compaction-drop-drained-records", "true");
+  store_->performCompaction(ID0);
+  // The record and its copyset index entry are removed.
+  EXPECT_EQ(2, stats_.aggregate().records_drained_removed);
+  data = readAndCheck();
+  ASSERT_EQ(2, data.size());
+  EXPECT_EQ(std::vector<lsn_t>({10, 30}), data[0][logid].records);
+}
+
 TEST_F(PartitionedRocksDBStoreTest, NewPartitionTriggers) {
   closeStore();
   openStore({{"rocksdb-partition-duration", "10h"},
@@ -6862,6 +6961,73 @@ TEST_F(PartitionedRocksDBStoreTest, AnticipatoryDirty) {
   readAndCheck();
 }
 
+TEST_F(PartitionedRocksDBStoreTest, PartitionDirtyMetadataSerialization) {
+  // Round trip a dirty map containing nodes with and without known
+  // dirtied-since timestamps.
+  DirtiedByMap dbm;
+  auto& n1 = dbm[{node_index_t(1), DataClass::APPEND}];
+  n1.markDirtyUntil(FlushToken(10));
+  n1.noteDirtyingWrite(RecordTimestamp(std::chrono::milliseconds(BASE_TIME)));
+  n1.noteDirtyingWrite(
+      RecordTimestamp(std::chrono::milliseconds(BASE_TIME + MINUTE)));
+  auto& n2 = dbm[{node_index_t(2), DataClass::APPEND}];
+  n2.markDirtyUntil(FlushToken(11));
+  auto& n3 = dbm[{node_index_t(3), DataClass::REBUILD}];
+  n3.markDirtyUntil(FlushToken(12));
+  n3.noteDirtyingWrite(
+      RecordTimestamp(std::chrono::milliseconds(BASE_TIME - HOUR)));
+  // Clean nodes are not serialized.
+  dbm[{node_index_t(4), DataClass::APPEND}];
+
+  PartitionDirtyMetadata out(dbm, /*under_replicated*/ true);
+  Slice blob = out.serialize();
+
+  PartitionDirtyMetadata in;
+  ASSERT_EQ(0, in.deserialize(blob));
+  EXPECT_TRUE(in.isUnderReplicated());
+  EXPECT_EQ(std::vector<node_index_t>({1, 2}),
+            in.getDirtiedBy(DataClass::APPEND));
+  // noteDirtyingWrite() keeps the minimum timestamp; nodes without a
+  // recorded write serialize as DIRTIED_SINCE_UNKNOWN.
+  EXPECT_EQ(std::vector<uint64_t>(
+                {BASE_TIME, PartitionDirtyMetadata::DIRTIED_SINCE_UNKNOWN}),
+            in.getDirtiedSince(DataClass::APPEND));
+  EXPECT_EQ(std::vector<node_index_t>({3}),
+            in.getDirtiedBy(DataClass::REBUILD));
+  EXPECT_EQ(std::vector<uint64_t>({BASE_TIME - HOUR}),
+            in.getDirtiedSince(DataClass::REBUILD));
+
+  // Records written before dirtied-since timestamps were added have 12 byte
+  // DirtyNodesForClass elements and no timestamp arrays. Build one by hand
+  // and make sure it still deserializes.
+  std::vector<uint8_t> v1_blob(12 + 12 + 2 * sizeof(node_index_t), 0);
+  struct {
+    uint16_t len = 12;
+    uint8_t flags = 0;
+    uint8_t pad = 0;
+    uint32_t dnc_array_offset = 12;
+    uint32_t dnc_array_len = 12;
+  } v1_header;
+  struct {
+    uint16_t len = 12;
+    uint8_t data_class = (uint8_t)DataClass::APPEND;
+    uint8_t pad = 0;
+    uint32_t nid_array_offset = 24;
+    uint32_t nid_array_len = 2 * sizeof(node_index_t);
+  } v1_dnc;
+  node_index_t v1_nids[] = {5, 6};
+  memcpy(v1_blob.data(), &v1_header, sizeof(v1_header));
+  memcpy(v1_blob.data() + 12, &v1_dnc, sizeof(v1_dnc));
+  memcpy(v1_blob.data() + 24, v1_nids, sizeof(v1_nids));
+
+  PartitionDirtyMetadata v1_in;
+  ASSERT_EQ(0, v1_in.deserialize(Slice(v1_blob.data(), v1_blob.size())));
+  EXPECT_FALSE(v1_in.isUnderReplicated());
+  EXPECT_EQ(std::vector<node_index_t>({5, 6}),
+            v1_in.getDirtiedBy(DataClass::APPEND));
+  EXPECT_TRUE(v1_in.getDirtiedSince(DataClass::APPEND).empty());
+}
+
 TEST_F(PartitionedRocksDBStoreTest, DirectoryCleanupAfterCompaction) {
   ServerConfig::SettingsConfig s;
   s["rocksdb-partition-duration"] = "8h";
@@ -0,0 +1,152 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/locallogstore/PayloadDedup.h"
+
+#include <gtest/gtest.h>
+
+#include "logdevice/common/LocalLogStoreRecordFormat.h"
+
+using namespace facebook::logdevice;
+
+namespace {
+
+Slice sliceOf(const std::string& s) {
+  return Slice(s.data(), s.size());
+}
+
+// Forms a record blob (header + payload section) with the given flags.
+std::string formRecord(LocalLogStoreRecordFormat::flags_t flags,
+                       std::string payload_section) {
+  std::vector<ShardID> copyset = {ShardID(1, 0), ShardID(2, 0), ShardID(3, 0)};
+  std::string buf;
+  LocalLogStoreRecordFormat::formRecordHeader(
+      /*timestamp=*/1234567890,
+      esn_t(42),
+      flags,
+      /*wave_or_recovery_epoch=*/1,
+      folly::Range<const ShardID*>(copyset.data(),
+                                   copyset.data() + copyset.size()),
+      OffsetMap(),
+      std::map<KeyType, std::string>(),
+      &buf);
+  buf += payload_section;
+  return buf;
+}
+
+} // namespace
+
+TEST(PayloadDedupTest, ReferenceRoundTrip) {
+  const std::string payload = "fan-in payload shared by many logs";
+  PayloadDedup::Reference ref = PayloadDedup::makeReference(sliceOf(payload));
+  EXPECT_EQ(payload.size(), ref.size);
+
+  // Hashing is deterministic and content-sensitive.
+  PayloadDedup::Reference ref2 = PayloadDedup::makeReference(sliceOf(payload));
+  EXPECT_EQ(ref.hash_hi, ref2.hash_hi);
+  EXPECT_EQ(ref.hash_lo, ref2.hash_lo);
+  const std::string other = "fan-in payload shared by many logS";
+  PayloadDedup::Reference ref3 = PayloadDedup::makeReference(sliceOf(other));
+  EXPECT_TRUE(ref.hash_hi != ref3.hash_hi || ref.hash_lo != ref3.hash_lo);
+
+  std::string blob;
+  PayloadDedup::serializeReference(ref, &blob);
+  ASSERT_EQ(PayloadDedup::REFERENCE_SIZE, blob.size());
+  EXPECT_EQ(PayloadDedup::MAGIC, static_cast<uint8_t>(blob[0]));
+
+  PayloadDedup::Reference parsed;
+  ASSERT_EQ(0, PayloadDedup::parseReference(sliceOf(blob), &parsed));
+  EXPECT_EQ(ref.hash_hi, parsed.hash_hi);
+  EXPECT_EQ(ref.hash_lo, parsed.hash_lo);
+  EXPECT_EQ(ref.size, parsed.size);
+}
+
+TEST(PayloadDedupTest, ParseErrors) {
+  std::string blob;
+  PayloadDedup::serializeReference(
+      PayloadDedup::makeReference(sliceOf("payload")), &blob);
+
+  // Wrong size.
+  PayloadDedup::Reference parsed;
+  std::string truncated = blob.substr(0, blob.size() - 1);
+  EXPECT_EQ(-1, PayloadDedup::parseReference(sliceOf(truncated), &parsed));
+  EXPECT_EQ(E::MALFORMED_RECORD, err);
+  std::string padded = blob + "x";
+  EXPECT_EQ(-1, PayloadDedup::parseReference(sliceOf(padded), &parsed));
+  EXPECT_EQ(E::MALFORMED_RECORD, err);
+
+  // Wrong magic byte.
+  std::string bad_magic = blob;
+  bad_magic[0] ^= 0xff;
+  EXPECT_EQ(-1, PayloadDedup::parseReference(sliceOf(bad_magic), &parsed));
+  EXPECT_EQ(E::MALFORMED_RECORD, err);
+}
+
+TEST(PayloadDedupTest, ReplaceFlags) {
+  const LocalLogStoreRecordFormat::flags_t base_flags =
+      LocalLogStoreRecordFormat::FLAG_SHARD_ID |
+      LocalLogStoreRecordFormat::FLAG_CHECKSUM_PARITY;
+  const std::string payload = "some payload";
+  std::string record = formRecord(base_flags, payload);
+
+  bool is_deduped;
+  ASSERT_EQ(
+      0,
+      LocalLogStoreRecordFormat::isPayloadDeduped(sliceOf(record),
+                                                  &is_deduped));
+  EXPECT_FALSE(is_deduped);
+
+  // Setting FLAG_PAYLOAD_DEDUP produces a blob that still parses and that
+  // the fast-path check recognizes.
+  std::string deduped;
+  ASSERT_EQ(0,
+            LocalLogStoreRecordFormat::replaceFlags(
+                sliceOf(record),
+                base_flags | LocalLogStoreRecordFormat::FLAG_PAYLOAD_DEDUP,
+                &deduped));
+  ASSERT_EQ(
+      0,
+      LocalLogStoreRecordFormat::isPayloadDeduped(sliceOf(deduped),
+                                                  &is_deduped));
+  EXPECT_TRUE(is_deduped);
+
+  LocalLogStoreRecordFormat::flags_t flags;
+  ASSERT_EQ(0, LocalLogStoreRecordFormat::parseFlags(sliceOf(deduped), &flags));
+  EXPECT_EQ(base_flags | LocalLogStoreRecordFormat::FLAG_PAYLOAD_DEDUP, flags);
+
+  // Clearing the flag again round-trips back to the original blob.
+  std::string restored;
+  ASSERT_EQ(0,
+            LocalLogStoreRecordFormat::replaceFlags(
+                sliceOf(deduped), base_flags, &restored));
+  EXPECT_EQ(record, restored);
+
+  Payload parsed_payload;
+  std::chrono::milliseconds timestamp;
+  ASSERT_EQ(0,
+            LocalLogStoreRecordFormat::parse(sliceOf(restored),
+                                             &timestamp,
+                                             nullptr,
+                                             &flags,
+                                             nullptr,
+                                             nullptr,
+                                             nullptr,
+                                             0,
+                                             nullptr,
+                                             nullptr,
+                                             &parsed_payload,
+                                             /*this_shard=*/0));
+  EXPECT_EQ(base_flags, flags);
+  EXPECT_EQ(payload, parsed_payload.toString());
+
+  // Blobs too short to contain the flags are rejected.
+  std::string empty;
+  EXPECT_EQ(-1,
+            LocalLogStoreRecordFormat::replaceFlags(
+                Slice(record.data(), 4), base_flags, &empty));
+  EXPECT_EQ(E::MALFORMED_RECORD, err);
+}
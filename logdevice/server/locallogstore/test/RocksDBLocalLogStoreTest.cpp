@@ -23,9 +23,11 @@
 #include "logdevice/server/locallogstore/LocalLogStore.h"
 #include "logdevice/server/locallogstore/PartitionedRocksDBStore.h"
 #include "logdevice/server/locallogstore/RocksDBCustomiser.h"
+#include "logdevice/server/locallogstore/RocksDBKeyFormat.h"
 #include "logdevice/server/locallogstore/WriteOps.h"
 #include "logdevice/server/locallogstore/test/TemporaryLogStore.h"
 #include "rocksdb/db.h"
+#include "rocksdb/sst_file_writer.h"
 
 using namespace facebook::logdevice;
 
@@ -507,6 +509,98 @@ TEST_F(RocksDBLocalLogStoreTest, WriteReadBackTest) {
   }
 }
 
+/**
+ * Build an SST file with rocksdb::SstFileWriter and bulk-ingest it into the
+ * store, then read the records back through a normal iterator.
+ */
+TEST_F(RocksDBLocalLogStoreTest, IngestSSTFiles) {
+  TemporaryDirectory temp_dir("IngestSSTFiles");
+  auto store = std::make_unique<RocksDBLocalLogStore>(
+      0,
+      1,
+      temp_dir.path().string(),
+      rocksdb_config_,
+      RocksDBCustomiser::defaultInstance(),
+      &stats_,
+      /* io_tracing */ nullptr);
+
+  // One record written through the normal path, to check that ingested data
+  // coexists with it.
+  PutWriteOp op{logid_t(1),
+                6,
+                getHeader(),
+                Slice("abc16", 5),
+                folly::none,
+                folly::none,
+                Slice(nullptr, 0),
+                std::vector<std::pair<char, std::string>>(),
+                Durability::ASYNC_WRITE,
+                false};
+  ASSERT_EQ(0, store->writeMulti(std::vector<const WriteOp*>{&op}));
+
+  // "Donor" side: dump records 1, 4 and 5 of log 2 into an SST file, keys in
+  // increasing order as SstFileWriter requires. Values are in the fully
+  // merged format: header followed by payload.
+  std::string sst_path = (temp_dir.path() / "donor.sst").string();
+  rocksdb::SstFileWriter writer(
+      rocksdb::EnvOptions(), rocksdb_config_.options_);
+  ASSERT_TRUE(writer.Open(sst_path).ok());
+  Slice header = getHeader();
+  for (lsn_t lsn : {1, 4, 5}) {
+    std::string value(reinterpret_cast<const char*>(header.data), header.size);
+    value += "abc2" + std::to_string(lsn);
+    RocksDBKeyFormat::DataKey key(logid_t(2), lsn);
+    ASSERT_TRUE(
+        writer.Put(key.sliceForWriting(), rocksdb::Slice(value)).ok());
+  }
+  ASSERT_TRUE(writer.Finish().ok());
+
+  ASSERT_EQ(0, store->ingestSSTFiles({sst_path}));
+
+  // Both the ingested records and the regular write should be readable.
+  {
+    std::unique_ptr<LocalLogStore::ReadIterator> it =
+        store->read(logid_t(2), LocalLogStore::ReadOptions("IngestSSTFiles"));
+    it->seek(0);
+    int nread = 0;
+    for (nread = 0; it->state() == IteratorState::AT_RECORD;
+         ++nread, it->next()) {
+      if (nread == 0) {
+        EXPECT_EQ(1, it->getLSN());
+        verifyRecord("abc21", it);
+      } else if (nread == 1) {
+        EXPECT_EQ(4, it->getLSN());
+        verifyRecord("abc24", it);
+      } else if (nread == 2) {
+        EXPECT_EQ(5, it->getLSN());
+        verifyRecord("abc25", it);
+      }
+    }
+    EXPECT_EQ(3, nread);
+  }
+
+  {
+    std::unique_ptr<LocalLogStore::ReadIterator> it =
+        store->read(logid_t(1), LocalLogStore::ReadOptions("IngestSSTFiles"));
+    it->seek(0);
+    int nread = 0;
+    for (nread = 0; it->state() == IteratorState::AT_RECORD;
+         ++nread, it->next()) {
+      if (nread == 0) {
+        EXPECT_EQ(6, it->getLSN());
+        verifyRecord("abc16", it);
+      }
+    }
+    EXPECT_EQ(1, nread);
+  }
+
+  // Ingesting a path that doesn't exist fails without taking the store down.
+  ASSERT_EQ(
+      -1, store->ingestSSTFiles({(temp_dir.path() / "missing.sst").string()}));
+  EXPECT_EQ(E::LOCAL_LOG_STORE_WRITE, err);
+  EXPECT_EQ(E::OK, store->acceptingWrites());
+}
+
 TEST_F(RocksDBLocalLogStoreTest, BatchWithDelete) {
   auto store = createRocksDBLocalLogStore();
   std::vector<std::unique_ptr<WriteOp>> ops;
@@ -800,6 +894,36 @@ STORE_TEST(RocksDBLocalLogStoreTest, PersistentError, store) {
       1, stats_.aggregate().totalPerShardStats().local_logstore_failed_writes);
 }
 
+STORE_TEST(RocksDBLocalLogStoreTest, ReadOnlyMode, store) {
+  EXPECT_EQ(E::OK, store.acceptingWrites());
+  EXPECT_FALSE(store.inReadOnlyMode());
+
+  EXPECT_TRUE(store.setReadOnlyMode(true));
+  EXPECT_FALSE(store.setReadOnlyMode(true));
+  EXPECT_TRUE(store.inReadOnlyMode());
+  EXPECT_EQ(E::NOSPC, store.acceptingWrites());
+  EXPECT_EQ(1, stats_.aggregate().totalPerShardStats().read_only_log_stores);
+
+  // The store itself still takes writes (e.g. to internal logs); stores are
+  // rejected higher up the stack based on acceptingWrites().
+  PutWriteOp op{logid_t(123),
+                511,
+                getHeader(),
+                Slice("abc1", 4),
+                folly::none,
+                folly::none,
+                Slice(nullptr, 0),
+                {},
+                Durability::ASYNC_WRITE,
+                false};
+  EXPECT_EQ(0, store.writeMulti(std::vector<const WriteOp*>{&op}));
+
+  EXPECT_TRUE(store.setReadOnlyMode(false));
+  EXPECT_FALSE(store.inReadOnlyMode());
+  EXPECT_EQ(E::OK, store.acceptingWrites());
+  EXPECT_EQ(0, stats_.aggregate().totalPerShardStats().read_only_log_stores);
+}
+
 STORE_TEST(RocksDBLocalLogStoreTest, sync, store) {
   EXPECT_EQ(E::OK, store.acceptingWrites());
 
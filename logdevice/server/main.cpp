@@ -442,6 +442,12 @@ int main(int argc, const char** argv) {
   possibly_lock_mem(server_settings);
   drop_root(server_settings);
 
+  if (params->getStats() &&
+      settings->stats_background_aggregation_interval.count() > 0) {
+    params->getStats()->enableBackgroundAggregation(
+        settings->stats_background_aggregation_interval);
+  }
+
   // Run the StatsCollectionThread
   std::unique_ptr<StatsCollectionThread> stats_thread =
       StatsCollectionThread::maybeCreate(
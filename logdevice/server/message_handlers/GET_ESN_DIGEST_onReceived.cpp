@@ -0,0 +1,161 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/message_handlers/GET_ESN_DIGEST_onReceived.h"
+
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/protocol/ESN_DIGEST_Message.h"
+#include "logdevice/common/stats/Stats.h"
+#include "logdevice/server/EsnDigestStorageTask.h"
+#include "logdevice/server/ServerProcessor.h"
+#include "logdevice/server/ServerWorker.h"
+#include "logdevice/server/locallogstore/PartitionedRocksDBStore.h"
+#include "logdevice/server/read_path/LogStorageStateMap.h"
+#include "logdevice/server/storage_tasks/ShardedStorageThreadPool.h"
+
+namespace facebook { namespace logdevice {
+
+// Upper bound on the number of ESNs a single digest may cover; a larger
+// request would make the storage task iterate (and the reply carry) too much.
+// 1M ESNs is a 128KB bitmap, comfortably within a client's read window.
+static constexpr size_t MAX_DIGEST_ESNS = 1ul << 20;
+
+static void send_error(const Address& to,
+                       const GET_ESN_DIGEST_Header& request,
+                       Status status) {
+  ld_check(status != E::OK);
+  ESN_DIGEST_Header header = {request.log_id,
+                              request.read_stream_id,
+                              request.shard,
+                              status,
+                              request.filter_version,
+                              request.epoch,
+                              request.esn_start,
+                              /*num_esns=*/0};
+  Worker::onThisThread()->sender().sendMessage(
+      std::make_unique<ESN_DIGEST_Message>(header, std::vector<uint8_t>()),
+      to);
+}
+
+Message::Disposition GET_ESN_DIGEST_onReceived(GET_ESN_DIGEST_Message* msg,
+                                               const Address& from) {
+  GET_ESN_DIGEST_Header header = msg->getHeader();
+
+  if (!from.isClientAddress()) {
+    ld_error("got GET_ESN_DIGEST message from non-client %s",
+             Sender::describeConnection(from).c_str());
+    err = E::PROTO;
+    return Message::Disposition::ERROR;
+  }
+
+  if (header.log_id == LOGID_INVALID || header.epoch == EPOCH_INVALID ||
+      header.esn_start == ESN_INVALID || header.esn_start > header.esn_end) {
+    RATELIMIT_ERROR(std::chrono::seconds(10),
+                    10,
+                    "got GET_ESN_DIGEST message from %s with invalid range: "
+                    "log %lu, epoch %u, esns [%u, %u]",
+                    Sender::describeConnection(from).c_str(),
+                    header.log_id.val_,
+                    header.epoch.val_,
+                    header.esn_start.val_,
+                    header.esn_end.val_);
+    err = E::PROTO;
+    return Message::Disposition::ERROR;
+  }
+
+  if (size_t(header.esn_end.val_) - header.esn_start.val_ + 1 >
+      MAX_DIGEST_ESNS) {
+    RATELIMIT_ERROR(std::chrono::seconds(10),
+                    10,
+                    "GET_ESN_DIGEST from %s for log %lu asks for %lu ESNs, "
+                    "over the limit of %lu",
+                    Sender::describeConnection(from).c_str(),
+                    header.log_id.val_,
+                    size_t(header.esn_end.val_) - header.esn_start.val_ + 1,
+                    MAX_DIGEST_ESNS);
+    send_error(from, header, E::INVALID_PARAM);
+    return Message::Disposition::NORMAL;
+  }
+
+  ServerWorker* worker = ServerWorker::onThisThread();
+  if (!worker->isAcceptingWork()) {
+    ld_debug("Ignoring GET_ESN_DIGEST message: not accepting more work");
+    send_error(from, header, E::SHUTDOWN);
+    return Message::Disposition::NORMAL;
+  }
+
+  ServerProcessor* processor = worker->processor_;
+  if (!processor->runningOnStorageNode()) {
+    send_error(from, header, E::NOTSTORAGE);
+    return Message::Disposition::NORMAL;
+  }
+
+  const shard_size_t n_shards = worker->getNodesConfiguration()->getNumShards();
+  shard_index_t shard_idx = header.shard;
+  if (shard_idx >= n_shards) {
+    RATELIMIT_ERROR(std::chrono::seconds(10),
+                    10,
+                    "Got GET_ESN_DIGEST message from client %s with "
+                    "invalid shard %u, this node only has %u shards",
+                    Sender::describeConnection(from).c_str(),
+                    shard_idx,
+                    n_shards);
+    return Message::Disposition::NORMAL;
+  }
+
+  if (processor->isDataMissingFromShard(shard_idx)) {
+    send_error(from, header, E::REBUILDING);
+    return Message::Disposition::NORMAL;
+  }
+
+  LogStorageStateMap& map = processor->getLogStorageStateMap();
+  LogStorageState* log_state = map.insertOrGet(header.log_id, shard_idx);
+  if (log_state == nullptr || log_state->hasPermanentError()) {
+    send_error(from, header, E::FAILED);
+    return Message::Disposition::NORMAL;
+  }
+
+  // Clamp the requested range to the last released LSN. Beyond it, the
+  // absence of a copyset index entry is not authoritative: a copy of a
+  // not-yet-released record may still arrive (e.g. from recovery or
+  // rebuilding), so reporting it as absent could make the reader ship a
+  // false gap. E::AGAIN tells the client to retry later if it still cares.
+  const lsn_t last_released = log_state->getLastReleasedLSN().value();
+  if (last_released == LSN_INVALID ||
+      lsn_to_epoch(last_released) < header.epoch ||
+      (lsn_to_epoch(last_released) == header.epoch &&
+       lsn_to_esn(last_released) < header.esn_start)) {
+    send_error(from, header, E::AGAIN);
+    return Message::Disposition::NORMAL;
+  }
+  if (lsn_to_epoch(last_released) == header.epoch) {
+    header.esn_end = std::min(header.esn_end, lsn_to_esn(last_released));
+  }
+
+  LocalLogStore& store =
+      processor->sharded_storage_thread_pool_->getByIndex(shard_idx)
+          .getLocalLogStore();
+  auto partitioned_store = dynamic_cast<PartitionedRocksDBStore*>(&store);
+  if (partitioned_store != nullptr && partitioned_store->isUnderReplicated()) {
+    RATELIMIT_DEBUG(std::chrono::seconds(10),
+                    10,
+                    "GET_ESN_DIGEST(%lu): local log store has dirty "
+                    "partitions, reporting transient rebuilding state",
+                    header.log_id.val_);
+    send_error(from, header, E::REBUILDING);
+    return Message::Disposition::NORMAL;
+  }
+
+  worker->getStorageTaskQueueForShard(shard_idx)->putTask(
+      std::make_unique<EsnDigestStorageTask>(
+          from.id_.client_,
+          header,
+          Worker::onThisThread()->sender().getSockaddr(from)));
+  return Message::Disposition::NORMAL;
+}
+
+}} // namespace facebook::logdevice
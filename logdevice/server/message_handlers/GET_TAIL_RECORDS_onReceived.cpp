@@ -0,0 +1,120 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/message_handlers/GET_TAIL_RECORDS_onReceived.h"
+
+#include "logdevice/common/AllSequencers.h"
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/Sequencer.h"
+#include "logdevice/common/SequencerTailCache.h"
+#include "logdevice/common/protocol/TAIL_RECORDS_REPLY_Message.h"
+#include "logdevice/common/util.h"
+#include "logdevice/server/ServerProcessor.h"
+#include "logdevice/server/ServerWorker.h"
+
+namespace facebook { namespace logdevice {
+
+static void send_reply(const Address& to,
+                       const GET_TAIL_RECORDS_Header& request,
+                       Status status,
+                       NodeID redirect = NodeID(),
+                       lsn_t tail_lsn = LSN_INVALID,
+                       std::vector<TailRecord> records = {}) {
+  TAIL_RECORDS_REPLY_Header header = {
+      request.client_rqid,
+      request.log_id,
+      tail_lsn,
+      static_cast<uint32_t>(records.size()),
+      /*flags=*/0};
+  auto msg = std::make_unique<TAIL_RECORDS_REPLY_Message>(header);
+  msg->status_ = status;
+  msg->redirect_ = redirect;
+  msg->records_ = std::move(records);
+  Worker::onThisThread()->sender().sendMessage(std::move(msg), to);
+}
+
+Message::Disposition
+GET_TAIL_RECORDS_onReceived(GET_TAIL_RECORDS_Message* msg,
+                            const Address& from) {
+  const GET_TAIL_RECORDS_Header& header = msg->getHeader();
+
+  if (!from.isClientAddress()) {
+    ld_error("got GET_TAIL_RECORDS message from non-client %s",
+             Sender::describeConnection(from).c_str());
+    err = E::PROTO;
+    return Message::Disposition::ERROR;
+  }
+
+  if (header.log_id == LOGID_INVALID || header.start_lsn == LSN_INVALID ||
+      header.max_records == 0) {
+    RATELIMIT_ERROR(std::chrono::seconds(10),
+                    10,
+                    "got GET_TAIL_RECORDS message from %s with invalid "
+                    "parameters: log %lu, start_lsn %s, max_records %u",
+                    Sender::describeConnection(from).c_str(),
+                    header.log_id.val_,
+                    lsn_to_string(header.start_lsn).c_str(),
+                    header.max_records);
+    send_reply(from, header, E::INVALID_PARAM);
+    return Message::Disposition::NORMAL;
+  }
+
+  ServerWorker* worker = ServerWorker::onThisThread();
+  if (worker->shuttingDown()) {
+    send_reply(from, header, E::SHUTDOWN);
+    return Message::Disposition::NORMAL;
+  }
+
+  std::shared_ptr<Sequencer> sequencer =
+      worker->processor_->allSequencers().findSequencer(header.log_id);
+  if (sequencer == nullptr) {
+    send_reply(from, header, E::NOSEQUENCER);
+    return Message::Disposition::NORMAL;
+  }
+
+  if (sequencer->getState() == Sequencer::State::PREEMPTED) {
+    NodeID preempted_by =
+        sequencer->checkIfPreempted(sequencer->getCurrentEpoch());
+    if (preempted_by.isNodeID()) {
+      send_reply(from, header, E::PREEMPTED, preempted_by);
+    } else {
+      send_reply(from, header, E::NOSEQUENCER);
+    }
+    return Message::Disposition::NORMAL;
+  }
+
+  SequencerTailCache* cache = sequencer->getTailCache();
+  if (cache == nullptr) {
+    // --sequencer-recent-records-cache-bytes is 0 on this node
+    send_reply(from, header, E::NOTSUPPORTED);
+    return Message::Disposition::NORMAL;
+  }
+
+  // Never hand out records past the last released LSN: records above it are
+  // not yet safe to deliver to readers (e.g. log recovery may still rewrite
+  // them).
+  const lsn_t tail_lsn = sequencer->getLastReleased();
+  if (tail_lsn == LSN_INVALID) {
+    // recovery hasn't completed yet; the client should retry later
+    send_reply(from, header, E::AGAIN);
+    return Message::Disposition::NORMAL;
+  }
+
+  std::vector<TailRecord> records;
+  Status status = cache->getRecords(
+      header.start_lsn, tail_lsn, header.max_records, &records);
+  if (status != E::OK) {
+    ld_check(status == E::STALE);
+    send_reply(from, header, status);
+    return Message::Disposition::NORMAL;
+  }
+
+  send_reply(from, header, E::OK, NodeID(), tail_lsn, std::move(records));
+  return Message::Disposition::NORMAL;
+}
+
+}} // namespace facebook::logdevice
@@ -91,6 +91,7 @@ Message::Disposition START_onReceived(START_Message* msg,
   }
 
   ServerWorker* w = ServerWorker::onThisThread();
+  Worker::attributeActiveCpuToLog(header.log_id);
 
   // Check if connection to client ID is still alive by trying to get the socket
   // addr.
@@ -404,7 +405,7 @@ Message::Disposition START_onReceived(START_Message* msg,
     stream->fill_cache_ = !(header.flags & START_Header::DIRECT);
     stream->digest_ = header.flags & START_Header::DIGEST;
 
-    stream->filter_version_ = header.filter_version;
+    stream->setFilterVersion(header.filter_version);
     if (header.flags & START_Header::SINGLE_COPY_DELIVERY) {
       stream->enableSingleCopyDelivery(
           msg->filtered_out_, w->processor_->getMyNodeID().index());
@@ -21,10 +21,12 @@
 #include "logdevice/server/ServerProcessor.h"
 #include "logdevice/server/ServerWorker.h"
 #include "logdevice/server/locallogstore/LocalLogStore.h"
+#include "logdevice/server/locallogstore/WriteOps.h"
 #include "logdevice/server/read_path/LogStorageStateMap.h"
 #include "logdevice/server/storage_tasks/PerWorkerStorageTaskQueue.h"
 #include "logdevice/server/storage_tasks/StorageTask.h"
 #include "logdevice/server/storage_tasks/StorageThreadPool.h"
+#include "logdevice/server/storage_tasks/WriteStorageTask.h"
 
 namespace facebook { namespace logdevice {
 
@@ -38,8 +40,14 @@ static void send_reply(const Address& to,
 }
 
 namespace {
-// A task to write the trim point to local log store
-class WriteTrimMetadataTask : public StorageTask {
+// A task to write the trim point to local log store. It's a WriteStorageTask
+// so that trim points for different logs land in the shared write batches on
+// StorageThreadPool instead of one metadata write (and WAL sync) per log;
+// retention services tend to trim tens of thousands of logs at once.
+// The write is blind: trim point metadata merges to the maximum (see
+// detail::useMerge() in RocksDBWriter), so a stale trim can't move the trim
+// point backwards.
+class WriteTrimMetadataTask : public WriteStorageTask {
  public:
   explicit WriteTrimMetadataTask(logid_t log_id,
                                  lsn_t trim_point,
@@ -48,53 +56,53 @@ class WriteTrimMetadataTask : public StorageTask {
                                  std::string client_name,
                                  std::string client_address,
                                  PrincipalIdentity identity)
-      : StorageTask(StorageTask::Type::WRITE_TRIM_METADATA),
+      : WriteStorageTask(StorageTask::Type::WRITE_TRIM_METADATA),
         log_id_(log_id),
         trim_point_(trim_point),
         reply_to_(reply_to),
         client_rqid_(client_rqid),
-        status_(E::OK),
         client_name_(std::move(client_name)),
         client_address_(std::move(client_address)),
-        identity_(std::move(identity)) {}
+        identity_(std::move(identity)),
+        metadata_{trim_point},
+        op_(log_id, &metadata_, Durability::SYNC_WRITE) {}
 
   Principal getPrincipal() const override {
     return Principal::METADATA;
   }
 
-  void execute() override {
-    LocalLogStore& store = storageThreadPool_->getLocalLogStore();
-    LogStorageStateMap& map =
-        storageThreadPool_->getProcessor().getLogStorageStateMap();
-
-    TrimMetadata trim_metadata{trim_point_};
-    LocalLogStore::WriteOptions options;
-    int rv = store.updateLogMetadata(log_id_, trim_metadata, options);
-    if (rv != 0) {
-      // if local log store already contained a trim point with a higher LSN,
-      // report it as a success to the client
-      status_ = (err == E::UPTODATE ? E::OK : E::FAILED);
-      return;
-    }
-
-    LogStorageState* log_state =
-        map.insertOrGet(log_id_, storageThreadPool_->getShardIdx());
-    if (log_state == nullptr) {
-      status_ = E::FAILED;
-      return;
-    }
-
-    log_state->updateTrimPoint(trim_point_);
-    durability_ = Durability::SYNC_WRITE;
+  size_t getNumWriteOps() const override {
+    return 1;
   }
 
-  Durability durability() const override {
-    return durability_;
+  size_t getWriteOps(const WriteOp** write_ops,
+                     size_t write_ops_len) const override {
+    if (write_ops_len == 0) {
+      return 0;
+    }
+    write_ops[0] = &op_;
+    return 1;
   }
 
   void onDone() override {
+    Status status = status_;
+    if (status == E::OK) {
+      LogStorageStateMap& map =
+          storageThreadPool_->getProcessor().getLogStorageStateMap();
+      LogStorageState* log_state =
+          map.insertOrGet(log_id_, storageThreadPool_->getShardIdx());
+      if (log_state != nullptr) {
+        // May fail with E::UPTODATE, which is fine: the merged on-disk value
+        // is at least as high as trim_point_.
+        log_state->updateTrimPoint(trim_point_);
+      } else {
+        status = E::FAILED;
+      }
+    } else {
+      status = E::FAILED;
+    }
     send_reply(
-        reply_to_, client_rqid_, status_, storageThreadPool_->getShardIdx());
+        reply_to_, client_rqid_, status, storageThreadPool_->getShardIdx());
   }
 
   void onDropped() override {
@@ -107,11 +115,11 @@ class WriteTrimMetadataTask : public StorageTask {
   lsn_t trim_point_;
   Address reply_to_;
   request_id_t client_rqid_;
-  Status status_;
-  Durability durability_ = Durability::INVALID;
   std::string client_name_;
   std::string client_address_;
   PrincipalIdentity identity_;
+  TrimMetadata metadata_;
+  PutLogMetadataWriteOp op_;
 };
 } // namespace
 
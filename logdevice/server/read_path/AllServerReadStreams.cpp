@@ -246,6 +246,20 @@ void AllServerReadStreams::scheduleForCatchup(
     queue_ptr.reset(new CatchupQueue(std::move(deps), stream.client_id_));
   }
 
+  // Fast path for latency-sensitive tailers: if this wakeup was triggered by
+  // a release and the records to deliver are already sitting in the real-time
+  // record buffer, delivery is a pure in-memory push on this worker, so the
+  // delivery-latency batching delay would be all cost and no benefit. The
+  // sweep is cheap when there is nothing new to distribute.
+  if (allow_delay && catchup_reason == CatchupEventTrigger::RELEASE &&
+      settings_->real_time_reads_enabled &&
+      settings_->real_time_fast_delivery) {
+    distributeNewlyReleasedRecords();
+    if (stream.releasedRecordsCover(stream.getReadPtr().lsn)) {
+      allow_delay = false;
+    }
+  }
+
   // Add this read stream to the CatchupQueue. If we got here because more
   // records became available for delivery (i.e. released), do a delayed push
   // to allow CatchupQueue to process the stream when it's ready to read new
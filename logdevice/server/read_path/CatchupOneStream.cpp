@@ -22,14 +22,18 @@
 #include "logdevice/common/Metadata.h"
 #include "logdevice/common/Sender.h"
 #include "logdevice/common/ServerRecordFilter.h"
+#include "logdevice/common/chrono_util.h"
 #include "logdevice/common/configuration/InternalLogs.h"
+#include "logdevice/common/protocol/Compatibility.h"
 #include "logdevice/common/protocol/GAP_Message.h"
+#include "logdevice/common/protocol/RECORD_BATCH_Message.h"
 #include "logdevice/common/protocol/RECORD_Message.h"
 #include "logdevice/common/protocol/STARTED_Message.h"
 #include "logdevice/common/stats/Histogram.h"
 #include "logdevice/common/stats/ServerHistograms.h"
 #include "logdevice/common/stats/Stats.h"
 #include "logdevice/include/Record.h"
+#include "logdevice/server/CompressedRecordTier.h"
 #include "logdevice/server/EpochRecordCache.h"
 #include "logdevice/server/IOFaultInjection.h"
 #include "logdevice/server/RecordCache.h"
@@ -184,6 +188,9 @@ class ReadingCallback : public LocalLogStoreReader::Callback {
 
   int nrecords_ = 0;
 
+  // @param blob_owner  if non-null, a refcounted buffer that `payload` points
+  //                     into; shipRecord() references the payload from it
+  //                     instead of making a private copy
   int processRecord(const lsn_t lsn,
                     const std::chrono::milliseconds timestamp,
                     const LocalLogStoreRecordFormat::flags_t flags,
@@ -193,7 +200,21 @@ class ReadingCallback : public LocalLogStoreReader::Callback {
                     const esn_t last_known_good,
                     const copyset_size_t copyset_size,
                     const ShardID* const copyset,
-                    const OffsetMap& offsets_within_epoch);
+                    const OffsetMap& offsets_within_epoch,
+                    const folly::IOBuf* blob_owner = nullptr);
+
+  /**
+   * Ships any records buffered by shipRecord() for RECORD_BATCH delivery.
+   * Must be called after the last processRecord() of a burst, before any
+   * state derived from the records (e.g. the read pointer) is acted on.
+   *
+   * @return 0 on success. On failure (err set by Sender::sendMessage()),
+   *         rewinds the stream to its state before the first buffered record
+   *         -- nothing else ran on this Worker since the records were
+   *         buffered, so the rewind is exact -- and returns -1; the records
+   *         will be re-read on the next catchup attempt.
+   */
+  int flushBatch();
 
  private:
   // Sends a RECORD_Message for the given record over the wire
@@ -202,7 +223,8 @@ class ReadingCallback : public LocalLogStoreReader::Callback {
                  LocalLogStoreRecordFormat::flags_t disk_flags,
                  Payload payload,
                  std::unique_ptr<ExtraMetadata> extra_metadata,
-                 OffsetMap offsets);
+                 OffsetMap offsets,
+                 const folly::IOBuf* blob_owner);
 
   std::unique_ptr<ExtraMetadata>
   prepareExtraMetadata(esn_t last_known_good,
@@ -216,16 +238,54 @@ class ReadingCallback : public LocalLogStoreReader::Callback {
    */
   OffsetMap getEpochOffsets(epoch_t record_epoch, LogStorageState& log_state);
 
+  /**
+   * Issues an EpochOffsetStorageTask for the epoch following current_epoch
+   * if its offsets aren't cached yet. Called when a bridge record is
+   * delivered, so the offsets are ready before the first records of the
+   * next epoch are.
+   */
+  void prefetchNextEpochOffsets(epoch_t current_epoch,
+                                LogStorageState& log_state);
+
+  // True if records of this stream may be shipped in RECORD_BATCH frames:
+  // batching is enabled, the client speaks the protocol, and the stream
+  // doesn't request anything a batched record can't carry. Constant for the
+  // lifetime of this callback, so bursts never mix batched and plain records.
+  bool canBatchRecords() const;
+
   CatchupOneStream* catchup_;
   ServerReadStream* stream_;
   LocalLogStore* store_;
   ServerReadStream::RecordSource source_;
   CatchupEventTrigger catchup_reason_;
+
+  // Records of the current burst waiting to be shipped in one RECORD_BATCH
+  // frame by flushBatch(); only used when canBatchRecords() is true.
+  std::vector<std::unique_ptr<RECORD_Message>> batch_;
+  // Sum of the records' individual RECORD message sizes, credited to
+  // record_bytes_queued_ when the batch is sent (the drain side debits per
+  // record too, see ServerMessageDispatch's RECORD_BATCH onSent fan-out).
+  size_t batch_msg_bytes_ = 0;
+  // Stream state snapshot from just before the first buffered record, used
+  // by flushBatch() to rewind the stream if sending the batch fails.
+  lsn_t batch_saved_last_delivered_lsn_ = LSN_INVALID;
+  lsn_t batch_saved_last_delivered_record_ = LSN_INVALID;
+  lsn_t batch_saved_filtered_out_end_lsn_ = LSN_INVALID;
+  LocalLogStoreReader::ReadPointer batch_saved_read_ptr_{LSN_INVALID};
 };
 
 int ReadingCallback::processRecord(const RawRecord& record) {
   const lsn_t lsn = record.lsn;
 
+  StatsHolder* stats = Worker::stats();
+  auto* ship_hist = stats && stats->get().server_histograms
+      ? &stats->get().server_histograms->catchup_record_ship_latency
+      : nullptr;
+  // Decide whether to time this record before reading the clock, so
+  // unsampled records skip the timestamps entirely.
+  const uint64_t start_cycles =
+      ship_hist && ship_hist->shouldRecord() ? cycle_timestamp() : 0;
+
   // Parse the local log store blob
   std::chrono::milliseconds timestamp;
   Payload payload;
@@ -278,16 +338,21 @@ int ReadingCallback::processRecord(const RawRecord& record) {
   //       is only reset at the end of each read if the read only accessed
   //       fully replicated portions of the LocalLogStore.
   stream_->in_under_replicated_region_ |= record.from_under_replicated_region;
-  return processRecord(lsn,
-                       timestamp,
-                       flags,
-                       optional_keys,
-                       payload,
-                       wave,
-                       last_known_good,
-                       copyset_size,
-                       copyset,
-                       offsets_within_epoch);
+  rv = processRecord(lsn,
+                     timestamp,
+                     flags,
+                     optional_keys,
+                     payload,
+                     wave,
+                     last_known_good,
+                     copyset_size,
+                     copyset,
+                     offsets_within_epoch,
+                     record.owner.empty() ? nullptr : &record.owner);
+  if (start_cycles != 0) {
+    ship_hist->addSampled(cycles_to_usec(cycle_timestamp() - start_cycles));
+  }
+  return rv;
 }
 
 int ReadingCallback::processRecord(
@@ -300,7 +365,8 @@ int ReadingCallback::processRecord(
     const esn_t last_known_good,
     const copyset_size_t copyset_size,
     const ShardID* const copyset,
-    const OffsetMap& offsets_within_epoch) {
+    const OffsetMap& offsets_within_epoch,
+    const folly::IOBuf* blob_owner) {
   ld_check(lsn > stream_->last_delivered_lsn_);
 
   // [Experimental Feature] If server-side filtering is enabled, we should
@@ -416,7 +482,8 @@ int ReadingCallback::processRecord(
                         flags,
                         payload,
                         std::move(extra_metadata),
-                        std::move(offsets));
+                        std::move(offsets),
+                        blob_owner);
     if (rv != 0) {
       return -1;
     }
@@ -445,6 +512,17 @@ int ReadingCallback::processRecord(
                     source_,
                     RECORD_Message::expectedSize(payload.size()));
 
+  // A bridge record marks the end of its epoch: everything this stream
+  // delivers next will be in a higher epoch, whose offsets are almost never
+  // cached yet. Start fetching them now so the first records of the new
+  // epoch don't ship without offsets while an EpochOffsetStorageTask makes
+  // its round trip.
+  if (stream_->include_byte_offset_ &&
+      (flags & LocalLogStoreRecordFormat::FLAG_BRIDGE) &&
+      catchup_->deps_.getSettings().prefetch_epoch_offsets) {
+    prefetchNextEpochOffsets(lsn_to_epoch(lsn), log_state);
+  }
+
   return 0;
 }
 
@@ -584,12 +662,53 @@ OffsetMap ReadingCallback::getEpochOffsets(epoch_t record_epoch,
   return OffsetMap();
 }
 
+void ReadingCallback::prefetchNextEpochOffsets(epoch_t current_epoch,
+                                               LogStorageState& log_state) {
+  if (current_epoch >= EPOCH_MAX || stream_->epoch_task_in_flight) {
+    return;
+  }
+  const epoch_t next_epoch(current_epoch.val_ + 1);
+
+  // Per-epoch metadata only exists for recovered epochs; don't waste a
+  // storage task (and log an error on its completion) on the epoch the
+  // sequencer is still writing into.
+  LogStorageState::LastReleasedLSN last_released =
+      log_state.getLastReleasedLSN();
+  if (next_epoch >= lsn_to_epoch(last_released.value())) {
+    return;
+  }
+
+  // Nothing to do if the offsets are already available from either cache.
+  const auto& from_metadata = stream_->epoch_offsets_;
+  if (from_metadata.has_value() && from_metadata.value().first == next_epoch) {
+    return;
+  }
+  auto from_log_state = log_state.getEpochOffsetMap();
+  if (from_log_state.has_value() &&
+      from_log_state.value().first == next_epoch) {
+    return;
+  }
+
+  auto prio = catchup_->getPriorityForStorageTasks();
+  auto task = std::make_unique<EpochOffsetStorageTask>(stream_->createRef(),
+                                                       stream_->log_id_,
+                                                       next_epoch,
+                                                       std::get<1>(prio),
+                                                       std::get<2>(prio));
+  stream_->epoch_task_in_flight = true;
+  ServerWorker::onThisThread()
+      ->getStorageTaskQueueForShard(stream_->shard_)
+      ->putTask(std::move(task));
+  STAT_INCR(catchup_->deps_.getStatsHolder(), epoch_offset_prefetches);
+}
+
 int ReadingCallback::shipRecord(lsn_t lsn,
                                 std::chrono::milliseconds timestamp,
                                 LocalLogStoreRecordFormat::flags_t disk_flags,
                                 Payload payload,
                                 std::unique_ptr<ExtraMetadata> extra_metadata,
-                                OffsetMap offsets) {
+                                OffsetMap offsets,
+                                const folly::IOBuf* blob_owner) {
   ++nrecords_;
 
   RECORD_flags_t wire_flags = 0;
@@ -649,6 +768,21 @@ int ReadingCallback::shipRecord(lsn_t lsn,
     h.length = static_cast<uint32_t>(payload.size());
     h.hash = checksum_32bit(Slice(payload));
     payload_holder = PayloadHolder::copyBuffer(&h, sizeof(h));
+  } else if (blob_owner != nullptr && payload.size() > 0) {
+    // The payload already lives in a refcounted buffer (the storage blob or
+    // a record cache entry).  Reference the payload bytes from it instead of
+    // copying them; the clone pins the buffer until the, possibly deferred on
+    // transmission, RECORD message is serialized or dropped.
+    const uint8_t* data = static_cast<const uint8_t*>(payload.data());
+    ld_assert(data >= blob_owner->data() &&
+              data + payload.size() <= blob_owner->tail());
+    folly::IOBuf buf = blob_owner->cloneOneAsValue();
+    buf.trimStart(data - blob_owner->data());
+    buf.trimEnd(buf.length() - payload.size());
+    payload_holder = PayloadHolder(std::move(buf));
+    STAT_ADD(catchup_->deps_.getStatsHolder(),
+             read_streams_payload_zero_copied_bytes,
+             payload.size());
   } else {
     // Make private copy of the data so it is stable for the lifetime of
     // the, possibly deferred on transmission, RECORD message.
@@ -685,6 +819,44 @@ int ReadingCallback::shipRecord(lsn_t lsn,
   // Remember how much space we will take in the output evbuffer
   const auto msg_size = msg->size();
 
+  if (catchup_reason_ == CatchupEventTrigger::RELEASE) {
+    uint64_t latency = std::chrono::duration_cast<std::chrono::milliseconds>(
+                           std::chrono::system_clock::now().time_since_epoch())
+                           .count() -
+        header.timestamp;
+    latency *= 1000;
+
+    HISTOGRAM_ADD(Worker::stats(), write_to_read_latency, latency);
+    // Also attribute the visibility delay to the log group, so release-delay
+    // regressions can be pinned to specific logs.
+    WORKER_LOG_STAT_ADD(
+        header.log_id, write_to_read_latency_sum_usec, latency);
+    WORKER_LOG_STAT_INCR(header.log_id, write_to_read_latency_count);
+  }
+
+  if (canBatchRecords()) {
+    // Buffer the record so the whole burst ships in one RECORD_BATCH frame;
+    // flushBatch() hands it to the Sender and does the byte accounting.
+    if (batch_.empty()) {
+      batch_saved_last_delivered_lsn_ = stream_->last_delivered_lsn_;
+      batch_saved_last_delivered_record_ = stream_->last_delivered_record_;
+      batch_saved_filtered_out_end_lsn_ = stream_->filtered_out_end_lsn_;
+      batch_saved_read_ptr_ = stream_->getReadPtr();
+    }
+    batch_.push_back(std::move(msg));
+    batch_msg_bytes_ += msg_size;
+
+    const size_t max_records =
+        std::min<size_t>(catchup_->deps_.getSettings().record_batch_max_records,
+                         std::numeric_limits<uint16_t>::max());
+    if (batch_.size() >= max_records) {
+      // Close out the frame so it stays within the configured bound
+      // (record_count is 16 bits in any case).
+      return flushBatch();
+    }
+    return 0;
+  }
+
   // Let the Sender deal with any traffic shaping induced deferral.
   // We don't want to have to read the data again just because traffic
   // shaping is pacing data.
@@ -711,16 +883,6 @@ int ReadingCallback::shipRecord(lsn_t lsn,
     return -1;
   }
 
-  if (catchup_reason_ == CatchupEventTrigger::RELEASE) {
-    uint64_t latency = std::chrono::duration_cast<std::chrono::milliseconds>(
-                           std::chrono::system_clock::now().time_since_epoch())
-                           .count() -
-        header.timestamp;
-    latency *= 1000;
-
-    HISTOGRAM_ADD(Worker::stats(), write_to_read_latency, latency);
-  }
-
   size_t& bytes_queued = catchup_->record_bytes_queued_;
   ld_check(bytes_queued <= std::numeric_limits<size_t>::max() - msg_size);
   bytes_queued += msg_size;
@@ -732,6 +894,74 @@ int ReadingCallback::shipRecord(lsn_t lsn,
   return 0;
 }
 
+bool ReadingCallback::canBatchRecords() const {
+  if (catchup_->deps_.getSettings().record_batch_max_records <= 1 ||
+      stream_->proto_ < Compatibility::RECORD_BATCH_MESSAGE_SUPPORT) {
+    return false;
+  }
+  // Digests, extra metadata and byte offsets have no batch encoding; those
+  // streams keep shipping plain RECORDs.
+  return !stream_->digest_ && !stream_->include_extra_metadata_ &&
+      !stream_->include_byte_offset_;
+}
+
+int ReadingCallback::flushBatch() {
+  if (batch_.empty()) {
+    return 0;
+  }
+  ld_check(batch_.size() <= std::numeric_limits<uint16_t>::max());
+
+  std::unique_ptr<Message> msg;
+  if (batch_.size() == 1) {
+    // A batch of one is slightly bigger on the wire than a plain RECORD;
+    // ship lone records in their own frame.
+    msg = std::move(batch_.front());
+  } else {
+    STAT_INCR(catchup_->deps_.getStatsHolder(), record_batches_sent);
+    STAT_ADD(catchup_->deps_.getStatsHolder(), records_batched, batch_.size());
+    RECORD_BATCH_Header header = {stream_->log_id_,
+                                  stream_->id_,
+                                  stream_->shard_,
+                                  static_cast<uint16_t>(batch_.size())};
+    msg = std::make_unique<RECORD_BATCH_Message>(
+        header, stream_->trafficClass(), std::move(batch_));
+  }
+  batch_.clear();
+  const size_t msg_bytes = batch_msg_bytes_;
+  batch_msg_bytes_ = 0;
+
+  int rv =
+      catchup_->deps_.sender_->sendMessage(std::move(msg), stream_->client_id_);
+  if (rv != 0) {
+    ld_check(err != E::CBREGISTERED);
+    if (err != E::NOBUFS && err != E::SHUTDOWN) {
+      // see shipRecord() for why other errors are unexpected here
+      ld_check(false);
+      ld_error("got unexpected error from sender::sendMessage(): %s",
+               error_description(err));
+    }
+    // The records never reached the messaging layer. Rewind the stream to
+    // its state before the first buffered record so the next catchup
+    // attempt re-reads the burst; any gaps shipped in between covered only
+    // LSNs above the buffered records, and re-delivering below a TRIM gap
+    // is allowed (trim is advisory and we err on the side of over
+    // delivery).
+    stream_->last_delivered_lsn_ = batch_saved_last_delivered_lsn_;
+    stream_->last_delivered_record_ = batch_saved_last_delivered_record_;
+    stream_->filtered_out_end_lsn_ = batch_saved_filtered_out_end_lsn_;
+    stream_->setReadPtr(batch_saved_read_ptr_);
+    return -1;
+  }
+
+  size_t& bytes_queued = catchup_->record_bytes_queued_;
+  ld_check(bytes_queued <= std::numeric_limits<size_t>::max() - msg_bytes);
+  bytes_queued += msg_bytes;
+  ld_spew("record batch queued, msg_bytes:%zu, record_bytes_queued_ = %zu",
+          msg_bytes,
+          bytes_queued);
+  return 0;
+}
+
 std::unique_ptr<ExtraMetadata>
 ReadingCallback::prepareExtraMetadata(esn_t last_known_good,
                                       uint32_t wave,
@@ -1039,6 +1269,16 @@ CatchupOneStream::startRead(WeakRef<CatchupQueue> catchup_queue,
     }
   }
 
+  // The records may have been released and evicted from the record cache only
+  // recently; check the compressed second tier before resorting to a storage
+  // task.
+  if (!inject_latency) {
+    Action action = readFromCompressedTier(read_ctx);
+    if (action != Action::NOT_IN_REAL_TIME_BUFFER) {
+      return action;
+    }
+  }
+
   if (!allow_storage_task) {
     stream_->last_batch_status_ = "WOULDBLOCK";
     return Action::WOULDBLOCK;
@@ -1191,6 +1431,12 @@ CatchupOneStream::Action CatchupOneStream::pushReleasedRecords(
                 lsn_to_string(read_ctx.read_ptr_.lsn).c_str(),
                 toString(*rec).c_str());
       }
+      if (callback.flushBatch() != 0) {
+        // flushBatch() rewound the stream; report the failure instead of
+        // falling through to a storage read.
+        return handleBatchEnd(
+            stream_->version_, E::ABORTED, stream_->getReadPtr());
+      }
       return Action::NOT_IN_REAL_TIME_BUFFER;
     }
 
@@ -1245,7 +1491,8 @@ CatchupOneStream::Action CatchupOneStream::pushReleasedRecords(
                                  entry->last_known_good,
                                  entry->copyset.size(),
                                  entry->copyset.data(),
-                                 entry->offsets_within_epoch);
+                                 entry->offsets_within_epoch,
+                                 &entry->payload.iobuf());
       if (rv != 0) {
         ld_check_ne(err, E::CBREGISTERED);
         status = E::ABORTED;
@@ -1260,6 +1507,135 @@ CatchupOneStream::Action CatchupOneStream::pushReleasedRecords(
     }
   }
 
+  if (callback.flushBatch() != 0) {
+    status = E::ABORTED;
+  }
+  if (status == E::ABORTED) {
+    // A failed ship may have rewound the stream (see flushBatch()); don't
+    // re-advance the read pointer past records that were never delivered.
+    read_ctx.read_ptr_ = stream_->getReadPtr();
+  }
+
+  if (read_ctx.read_ptr_.lsn > stream_->getReadPtr().lsn) {
+    stream_->setReadPtr(read_ctx.read_ptr_.lsn);
+  }
+
+  if (status == E::OK) {
+    status = read_ctx.read_ptr_.lsn <= stream_->until_lsn_
+        ? E::CAUGHT_UP
+        : E::UNTIL_LSN_REACHED;
+  }
+
+  return handleBatchEnd(stream_->version_, status, read_ctx.read_ptr_);
+}
+
+CatchupOneStream::Action CatchupOneStream::readFromCompressedTier(
+    LocalLogStoreReader::ReadContext& read_ctx) {
+  CompressedRecordTier* tier =
+      deps_.getLogStorageStateMap().getCompressedRecordTier(stream_->shard_);
+  if (tier == nullptr) {
+    return Action::NOT_IN_REAL_TIME_BUFFER;
+  }
+
+  std::shared_ptr<ReleasedRecords> records =
+      tier->lookup(stream_->log_id_, read_ctx.read_ptr_.lsn);
+  if (records == nullptr) {
+    STAT_INCR(deps_.getStatsHolder(), record_cache_compressed_tier_miss);
+    return Action::NOT_IN_REAL_TIME_BUFFER;
+  }
+  STAT_INCR(deps_.getStatsHolder(), record_cache_compressed_tier_hit);
+
+  stream_ld_debug(*stream_,
+                  "Serving batch from compressed record tier, range %s",
+                  records->toString().c_str());
+
+  // Everything in the tier has been released, so, as in
+  // pushReleasedRecords(), it's safe to advance last_released_lsn_ past a
+  // per-epoch release that the read context hasn't observed yet.
+  if (records->end_lsn_ > read_ctx.last_released_lsn_ &&
+      same_epoch(records->end_lsn_, read_ctx.last_released_lsn_)) {
+    read_ctx.last_released_lsn_ = records->end_lsn_;
+  }
+
+  ReadingCallback callback(this,
+                           stream_,
+                           ServerReadStream::RecordSource::COMPRESSED_TIER,
+                           read_ctx.catchup_reason_);
+
+  int nrecords = 0;
+  size_t bytes_delivered = 0;
+  Status status = E::OK;
+  for (ZeroCopiedRecord* entry = records->entries_.get(); entry != nullptr;
+       entry = entry->next_.get()) {
+    // Skip over already-delivered records
+    if (entry->lsn < read_ctx.read_ptr_.lsn) {
+      continue;
+    }
+
+    // SCD filtering
+    if (!(*read_ctx.lls_filter_)(
+            stream_->log_id_,
+            entry->lsn,
+            entry->copyset.data(),
+            entry->copyset.size(),
+            entry->flags & STORE_Header::HOLE,
+            RecordTimestamp(std::chrono::milliseconds(entry->timestamp)),
+            RecordTimestamp(std::chrono::milliseconds(entry->timestamp)))) {
+      continue;
+    }
+
+    read_ctx.read_ptr_ = {entry->lsn};
+    status = read_ctx.checkBatchComplete(IteratorState::AT_RECORD);
+    if (status != E::OK) {
+      break;
+    }
+
+    size_t msg_size = RECORD_Message::expectedSize(entry->payload.size());
+
+    if (read_ctx.byteLimitReached(nrecords, bytes_delivered, msg_size)) {
+      status = E::BYTE_LIMIT_REACHED;
+      break;
+    }
+
+    nrecords++;
+
+    int rv =
+        callback.processRecord(entry->lsn,
+                               std::chrono::milliseconds(entry->timestamp),
+                               entry->flags,
+                               entry->keys,
+                               entry->payload.getPayload(),
+                               entry->wave_or_recovery_epoch,
+                               entry->last_known_good,
+                               entry->copyset.size(),
+                               entry->copyset.data(),
+                               entry->offsets_within_epoch,
+                               &entry->payload.iobuf());
+    if (rv != 0) {
+      ld_check_ne(err, E::CBREGISTERED);
+      status = E::ABORTED;
+      break;
+    }
+    bytes_delivered += msg_size;
+    read_ctx.read_ptr_ = {entry->lsn + 1};
+  }
+
+  if (callback.flushBatch() != 0) {
+    status = E::ABORTED;
+  }
+  if (status == E::ABORTED) {
+    // A failed ship may have rewound the stream (see flushBatch()); don't
+    // re-advance the read pointer past records that were never delivered.
+    read_ctx.read_ptr_ = stream_->getReadPtr();
+  }
+
+  if (status == E::OK) {
+    // The range is complete: this node has no records in
+    // [begin_lsn_, end_lsn_] other than the entries we just went through, so
+    // the read pointer can move past its end.
+    read_ctx.read_ptr_ = {records->end_lsn_ + 1};
+  }
+
   if (read_ctx.read_ptr_.lsn > stream_->getReadPtr().lsn) {
     stream_->setReadPtr(read_ctx.read_ptr_.lsn);
   }
@@ -1309,6 +1685,13 @@ CatchupOneStream::readNonBlocking(WeakRef<CatchupQueue> /*catchup_queue*/,
                            read_ctx.catchup_reason_);
   Status status = deps_.read(read_iterator.get(), callback, &read_ctx);
 
+  if (callback.flushBatch() != 0) {
+    // flushBatch() rewound the stream; make sure we don't re-advance the
+    // read pointer past the records that were never delivered.
+    status = E::ABORTED;
+    read_ctx.read_ptr_ = stream_->getReadPtr();
+  }
+
   stream_ld_debug(*stream_,
                   "got %d records without blocking, status=%s",
                   callback.nrecords_,
@@ -1374,6 +1757,10 @@ void CatchupOneStream::readOnStorageThread(
   options.allow_copyset_index = true;
   options.csi_data_only = stream_->csi_data_only_;
   options.inject_latency = inject_latency;
+  // Prefetch data blocks ahead of the iterator on storage threads, so a
+  // lagging reader that keeps re-seeking forward within a partition
+  // doesn't pay a synchronous block read per batch.
+  options.readahead_size = deps_.getSettings().read_iterator_readahead_bytes;
 
   std::weak_ptr<LocalLogStore::ReadIterator> read_iterator;
   if (stream_->iterator_cache_ && stream_->iterator_cache_->valid(options)) {
@@ -1405,6 +1792,14 @@ void CatchupOneStream::readOnStorageThread(
                                                      std::get<2>(prio),
                                                      std::get<3>(prio),
                                                      client_address);
+
+  // Give the task a deadline so that it doesn't execute if it spends so long
+  // on the storage task queue that the client will have given up by then.
+  const auto task_deadline = deps_.getSettings().read_storage_task_deadline;
+  if (task_deadline != std::chrono::milliseconds::max()) {
+    task_uniq->deadline_ = std::chrono::steady_clock::now() + task_deadline;
+  }
+
   deps_.putStorageTask(std::move(task_uniq), stream_->shard_);
   STAT_INCR(deps_.getStatsHolder(), read_requests_to_storage);
 
@@ -1453,10 +1848,11 @@ CatchupOneStream::processTask(const ReadStorageTask& task) {
   ld_check(task.status_ != E::UNKNOWN);
 
   bool accessed_under_replicated_region =
-      task.owned_iterator_ && // May be null in tests.
+      // May be null in tests or if the task was served by point lookups.
+      task.owned_iterator_ &&
       task.owned_iterator_->accessedUnderReplicatedRegion();
 
-  if (stream_->iterator_cache_ &&
+  if (stream_->iterator_cache_ && task.owned_iterator_ &&
       !stream_->iterator_cache_->valid(task.options_)) {
     // We don't have an iterator in cache, either because it was the first
     // batch, or because we invalidated the iterator while the storage task was
@@ -1654,6 +2050,13 @@ CatchupOneStream::Action CatchupOneStream::processRecords(
     }
   }
 
+  if (callback.flushBatch() != 0) {
+    ld_check(err != E::CBREGISTERED);
+    // flushBatch() rewound the stream; E::ABORTED keeps handleBatchEnd()
+    // from advancing the read pointer past the rewound position.
+    status = E::ABORTED;
+  }
+
   stream_->in_under_replicated_region_ = accessed_under_replicated_region;
 
   return handleBatchEnd(version, status, read_ptr);
@@ -1927,17 +2330,37 @@ CatchupOneStream::getPriorityForStorageTasks() {
     } else if (tail) {
       return std::make_tuple(StorageTaskType::READ_TAIL,
                              StorageTaskThreadType::SLOW,
-                             StorageTaskPriority::HIGH,
+                             getStorageTaskReadPriority(),
                              StorageTaskPrincipal::READ_TAIL);
     } else {
       return std::make_tuple(StorageTaskType::READ_BACKLOG,
                              StorageTaskThreadType::SLOW,
-                             StorageTaskPriority::MID,
+                             getStorageTaskReadPriority(),
                              StorageTaskPrincipal::READ_BACKLOG);
     }
   }
 }
 
+StorageTaskPriority CatchupOneStream::getStorageTaskReadPriority() const {
+  // The shaper admits reads per Priority, but the storage threads below used
+  // to see a fixed priority per traffic class. Deriving the storage task
+  // priority from the shaping priority carries the tag all the way down:
+  // within a priority the per-shard queue is FIFO, so I/O is issued in the
+  // order the shaper released it, and a stream whose principal was demoted
+  // (or promoted) by configuration queues behind (or ahead of) default
+  // streams on the storage threads as well, not just at the shaper.
+  switch (stream_->getReadPriority()) {
+    case Priority::MAX:
+    case Priority::CLIENT_HIGH:
+    case Priority::CLIENT_NORMAL:
+      return StorageTaskPriority::HIGH;
+    case Priority::CLIENT_LOW:
+      return StorageTaskPriority::MID;
+    default:
+      return StorageTaskPriority::LOW;
+  }
+}
+
 int CatchupOneStream::readLastKnownGood(WeakRef<CatchupQueue> catchup_queue,
                                         bool allow_storage_task) {
   ServerReadStream& stream = *stream_;
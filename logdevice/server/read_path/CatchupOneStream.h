@@ -182,6 +182,15 @@ class CatchupOneStream {
   Action pushReleasedRecords(std::vector<std::shared_ptr<ReleasedRecords>>&,
                              LocalLogStoreReader::ReadContext& read_ctx);
 
+  /**
+   * Attempts to serve the batch from the compressed second tier of the
+   * record cache (see CompressedRecordTier). Returns
+   * Action::NOT_IN_REAL_TIME_BUFFER if the tier is disabled or doesn't have
+   * a range containing the read pointer, in which case the caller should
+   * fall back to the local log store.
+   */
+  Action readFromCompressedTier(LocalLogStoreReader::ReadContext& read_ctx);
+
   Action processTask(const ReadStorageTask& task);
 
   Action processRecords(const std::vector<RawRecord>& records,
@@ -303,6 +312,13 @@ class CatchupOneStream {
              StorageTaskPrincipal>
   getPriorityForStorageTasks();
 
+  /**
+   * Maps the stream's traffic shaping priority onto a storage task priority,
+   * so that the per-shard storage queue issues read I/O in the same order the
+   * read shaper admits it.
+   */
+  StorageTaskPriority getStorageTaskReadPriority() const;
+
   /**
    * Read last known good.
    *
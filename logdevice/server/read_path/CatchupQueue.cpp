@@ -13,6 +13,7 @@
 #include "logdevice/common/BackoffTimer.h"
 #include "logdevice/common/ExponentialBackoffTimer.h"
 #include "logdevice/common/LocalLogStoreRecordFormat.h"
+#include "logdevice/common/PrincipalThrottle.h"
 #include "logdevice/common/ShapingContainer.h"
 #include "logdevice/common/SocketSender.h"
 #include "logdevice/common/Timer.h"
@@ -184,6 +185,21 @@ void CatchupQueue::pushRecords(CatchupEventTrigger catchup_reason) {
     return;
   }
 
+  {
+    const size_t cost = principal_bytes_uncharged_;
+    principal_bytes_uncharged_ = 0;
+    if (!deps_->principalReadAllowed(client_id_, cost)) {
+      // The client's principal is over its configured read throughput
+      // ceiling (see PrincipalThrottle). Pause catchup for this client;
+      // the ping timer or the socket draining will retry once the debt
+      // has been paid off.
+      catchup_queue_ld_debug("Principal over its read rate limit");
+      STAT_INCR(deps_->getStatsHolder(), catchup_queue_principal_throttled);
+      adjustPingTimer();
+      return;
+    }
+  }
+
   size_t max_record_bytes_queued = deps_->getMaxRecordBytesQueued(client_id_);
 
   // We limit the number of iterations in that loop in order to yield in the
@@ -247,6 +263,34 @@ void CatchupQueue::pushRecords(CatchupEventTrigger catchup_reason) {
 
     ld_check_lt(record_bytes_queued_, max_record_bytes_queued);
 
+    size_t byte_budget = max_record_bytes_queued - record_bytes_queued_;
+    if (deps_->getSettings()
+                .storage_queue_sojourn_overload_threshold.count() > 0 &&
+        deps_->isStorageTaskQueueOverloaded(stream->shard_)) {
+      // The shard's read queue is backed up: tasks are sitting in it longer
+      // than --storage-queue-sojourn-overload-threshold. Read in smaller
+      // batches so catchup adds less to the queue delay that other readers
+      // on the shard are already suffering.
+      byte_budget = std::min(
+          byte_budget, std::max<size_t>(byte_budget / 4, 16 * 1024));
+      STAT_INCR(deps_->getStatsHolder(), catchup_queue_overload_throttled);
+    }
+    if (deps_->getSettings().adaptive_catchup_batches) {
+      // Size the batch from the client's observed drain rate: enough
+      // records to keep the socket busy for kAdaptiveBatchTarget, so
+      // slow or stalled clients don't trigger large storage reads whose
+      // results sit in Sender (and may be dropped on a stream rewind).
+      // Streams without drain history get the full budget.
+      static constexpr std::chrono::milliseconds kAdaptiveBatchTarget{500};
+      static constexpr size_t kAdaptiveBatchMinBytes = 16 * 1024;
+      byte_budget = std::min(
+          byte_budget,
+          stream->drain_rate_.suggestBatchBytes(SteadyTimestamp::now(),
+                                                kAdaptiveBatchTarget,
+                                                kAdaptiveBatchMinBytes,
+                                                byte_budget));
+    }
+
     CatchupOneStream::Action act;
     size_t n_bytes_queued;
     bool try_non_blocking_read =
@@ -256,11 +300,12 @@ void CatchupQueue::pushRecords(CatchupEventTrigger catchup_reason) {
                                &*stream,
                                ref_holder_.ref(),
                                try_non_blocking_read,
-                               max_record_bytes_queued - record_bytes_queued_,
+                               byte_budget,
                                record_bytes_queued_ == 0,
                                !storage_task_in_flight_,
                                catchup_reason);
     record_bytes_queued_ += n_bytes_queued;
+    principal_bytes_uncharged_ += n_bytes_queued;
 
     // Note: storage_task_in_flight_ is NOT updated in the above call to
     // CatchupOneStream::read(), but stream->storage_task_in_flight_ is.  Also,
@@ -425,10 +470,16 @@ void CatchupQueue::onRecordSent(const RECORD_Message& msg,
   // We do this after all validations because pushRecords() can destroy
   // the stream.
   SCOPE_EXIT {
-    if (record_bytes_queued_ == 0) {
+    // In readahead mode, start the next batch once the output evbuffer has
+    // drained halfway so the next storage read overlaps with sending the
+    // rest of this one; otherwise wait until all RECORD messages have been
+    // flushed out of the output evbuffer.
+    size_t low_watermark = 0;
+    if (deps_->getSettings().catchup_readahead) {
+      low_watermark = deps_->getMaxRecordBytesQueued(client_id_) / 2;
+    }
+    if (record_bytes_queued_ <= low_watermark) {
       catchup_queue_ld_debug("Output evbuffer drained");
-      // Only trigger more work when we have flushed all RECORD messages out of
-      // the output evbuffer
       pushRecords();
     }
   };
@@ -438,6 +489,8 @@ void CatchupQueue::onRecordSent(const RECORD_Message& msg,
     return;
   }
 
+  stream->drain_rate_.onBytesDrained(msg_size, SteadyTimestamp::now());
+
   // Handle the case of a stream rewind after we hit until lsn and
   // destroyed the ServerReadStream object.
   if (enqueue_time < stream->created_) {
@@ -717,6 +770,24 @@ std::chrono::milliseconds CatchupQueueDependencies::iteratorTimerTTL() const {
   return Worker::settings().iterator_cache_ttl;
 }
 
+bool CatchupQueueDependencies::isStorageTaskQueueOverloaded(
+    shard_index_t shard) const {
+  return ServerWorker::onThisThread()
+      ->getStorageTaskQueueForShard(shard)
+      ->isOverloaded(StorageTask::ThreadType::SLOW);
+}
+
+bool CatchupQueueDependencies::principalReadAllowed(ClientID client_id,
+                                                    size_t cost) {
+  Worker* w = Worker::onThisThread(false);
+  if (w == nullptr) {
+    // May happen in tests.
+    return true;
+  }
+  return w->principalThrottle().chargeRead(
+      w->sender().getPrincipal(Address(client_id)), cost);
+}
+
 std::unique_ptr<Timer>
 CatchupQueueDependencies::createIteratorTimer(std::function<void()> callback) {
   return std::make_unique<Timer>(std::move(callback));
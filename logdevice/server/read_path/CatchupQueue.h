@@ -120,6 +120,20 @@ class CatchupQueueDependencies {
     return stats_holder_;
   }
 
+  /**
+   * Proxy for PerWorkerStorageTaskQueue::isOverloaded() on the queue feeding
+   * the given shard's "slow" storage threads.  Used to read in smaller
+   * batches while the shard's read queue is backed up.
+   */
+  virtual bool isStorageTaskQueueOverloaded(shard_index_t shard) const;
+
+  /**
+   * Reports `cost` bytes of records queued for the client's principal and
+   * returns whether catchup may schedule more reads for it. See
+   * PrincipalThrottle::chargeRead().
+   */
+  virtual bool principalReadAllowed(ClientID client_id, size_t cost);
+
   virtual const Settings& getSettings() const;
 
   /**
@@ -321,6 +335,12 @@ class CatchupQueue {
   // network.
   size_t record_bytes_queued_ = 0;
 
+  // Record bytes queued since the last report to the client principal's
+  // read throttle; reads are charged after the fact since the cost of a
+  // batch is only known once it's been read. See
+  // CatchupQueueDependencies::principalReadAllowed().
+  size_t principal_bytes_uncharged_ = 0;
+
   // Is there a storage task in flight for this catchup queue?  We only allow
   // one at a time.
   bool storage_task_in_flight_ = false;
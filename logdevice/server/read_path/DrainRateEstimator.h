@@ -0,0 +1,91 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "logdevice/common/Timestamp.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file DrainRateEstimator tracks how fast RECORD bytes queued for one
+ *       read stream actually drain into the client's socket, as an
+ *       exponentially decayed rate. CatchupQueue uses it to size each
+ *       stream's next read batch: slow or stalled clients get small
+ *       reads, so storage I/O isn't wasted on records that would sit in
+ *       Sender and possibly be dropped on a stream rewind, while fast
+ *       clients keep getting maximal batches.
+ */
+
+class DrainRateEstimator {
+ public:
+  // Half-life of the decayed rate. Short enough to react to a client
+  // stalling, long enough to ride out scheduling jitter.
+  static constexpr std::chrono::milliseconds HALF_LIFE{2000};
+
+  /**
+   * Called when RECORD bytes for this stream drain out of the output
+   * buffer.
+   */
+  void onBytesDrained(size_t bytes, SteadyTimestamp now) {
+    decayTo(now);
+    accumulated_ += bytes;
+  }
+
+  /**
+   * @return estimated drain rate in bytes/sec. Zero until the first
+   *         drain has been observed.
+   */
+  double rateBytesPerSec(SteadyTimestamp now) {
+    decayTo(now);
+    // The decayed byte count corresponds to roughly one half-life worth
+    // of traffic.
+    return accumulated_ /
+        std::chrono::duration<double>(HALF_LIFE).count();
+  }
+
+  /**
+   * Suggests a byte budget for the next read batch: enough to keep the
+   * client busy for `target` at the current drain rate, clamped to
+   * [min_bytes, max_bytes]. Streams with no drain history yet get
+   * max_bytes, so new and rewound streams start at full speed and only
+   * shrink if the client proves slow.
+   */
+  size_t suggestBatchBytes(SteadyTimestamp now,
+                           std::chrono::milliseconds target,
+                           size_t min_bytes,
+                           size_t max_bytes) {
+    if (last_update_ == SteadyTimestamp::min()) {
+      return max_bytes;
+    }
+    const double budget = rateBytesPerSec(now) *
+        std::chrono::duration<double>(target).count();
+    return std::max(
+        min_bytes, std::min(max_bytes, static_cast<size_t>(budget)));
+  }
+
+ private:
+  // Applies exponential decay for the time elapsed since the last update.
+  void decayTo(SteadyTimestamp now) {
+    if (last_update_ != SteadyTimestamp::min() && now > last_update_) {
+      const double elapsed =
+          std::chrono::duration<double>(now - last_update_).count();
+      const double half_life = std::chrono::duration<double>(HALF_LIFE).count();
+      accumulated_ *= std::exp2(-elapsed / half_life);
+    }
+    last_update_ = now;
+  }
+
+  double accumulated_ = 0;
+  SteadyTimestamp last_update_ = SteadyTimestamp::min();
+};
+
+}} // namespace facebook::logdevice
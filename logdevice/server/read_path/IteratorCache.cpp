@@ -19,6 +19,7 @@ std::shared_ptr<LocalLogStore::ReadIterator>
 IteratorCache::createOrGet(const LocalLogStore::ReadOptions& options) {
   auto& wrapper = getWrapper(options);
   if (!wrapper.iterator) {
+    store_->noteLogAccessed(log_id_);
     wrapper.iterator = store_->read(log_id_, options);
   } else {
     wrapper.iterator->setContextString(options.tracking_ctx.more_context);
@@ -35,6 +36,9 @@ bool IteratorCache::valid(const LocalLogStore::ReadOptions& options) {
 void IteratorCache::set(const LocalLogStore::ReadOptions& options,
                         std::shared_ptr<LocalLogStore::ReadIterator> iter) {
   auto& wrapper = getWrapper(options);
+  // The iterator was created on a storage thread, so this is the first time
+  // the cache sees this access.
+  store_->noteLogAccessed(log_id_);
   wrapper.iterator = iter;
   wrapper.last_used = std::chrono::steady_clock::now();
 }
@@ -8,7 +8,11 @@
 #include "logdevice/server/read_path/LocalLogStoreReader.h"
 
 #include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
 #include <memory>
+#include <new>
 
 #include <folly/ScopeGuard.h>
 #include <folly/small_vector.h>
@@ -123,6 +127,7 @@ Status readImpl(LocalLogStore::ReadIterator& read_iterator,
 
   size_t bytes_delivered = 0;
   int nrecords = 0;
+  size_t steps_until_cancel_check = 0;
 
   for (read_iterator.seek(read_ctx->read_ptr_.lsn,
                           &*read_ctx->lls_filter_,
@@ -156,6 +161,22 @@ Status readImpl(LocalLogStore::ReadIterator& read_iterator,
       return st;
     }
 
+    // Cooperative cancellation check between iterator steps, so that a batch
+    // whose consumer no longer wants the data (destroyed or rewound read
+    // stream) stops doing disk work early. Only checked every few steps to
+    // keep the common path cheap.
+    if (read_ctx->is_cancelled_ && steps_until_cancel_check-- == 0) {
+      steps_until_cancel_check = 15;
+      if (read_ctx->is_cancelled_()) {
+        STAT_INCR(stats, read_streams_batches_cancelled);
+        STAT_ADD(stats,
+                 read_streams_cancelled_read_bytes,
+                 read_ctx->it_stats_.read_record_bytes +
+                     read_ctx->it_stats_.read_csi_bytes);
+        return E::ABORTED;
+      }
+    }
+
     // Ship the record if needed.
     if (state == IteratorState::AT_RECORD) {
       lsn_t lsn = read_iterator.getLSN();
@@ -279,6 +300,164 @@ Status read(LocalLogStore::ReadIterator& read_iterator,
   return st;
 }
 
+Status readPointLookups(const LocalLogStore& store,
+                        Callback& callback,
+                        ReadContext* read_ctx,
+                        StatsHolder* stats) {
+  ld_check(read_ctx != nullptr);
+  read_ctx->it_stats_ = decltype(read_ctx->it_stats_)();
+
+  SCOPE_EXIT {
+    STAT_ADD(
+        stats, read_streams_num_records_read, read_ctx->it_stats_.read_records);
+    STAT_ADD(stats,
+             read_streams_num_bytes_read,
+             read_ctx->it_stats_.read_record_bytes);
+    STAT_ADD(stats,
+             read_streams_num_record_bytes_read,
+             read_ctx->it_stats_.read_record_bytes);
+    STAT_ADD(stats,
+             read_streams_num_records_filtered,
+             read_ctx->it_stats_.filtered_records);
+    STAT_ADD(stats,
+             read_streams_num_bytes_filtered,
+             read_ctx->it_stats_.filtered_record_bytes);
+  };
+
+  const lsn_t through = std::min(
+      std::min(read_ctx->until_lsn_, read_ctx->last_released_lsn_),
+      read_ctx->window_high_);
+  ld_check(read_ctx->read_ptr_.lsn <= through);
+
+  std::vector<lsn_t> lsns;
+  lsns.reserve(through - read_ctx->read_ptr_.lsn + 1);
+  for (lsn_t lsn = read_ctx->read_ptr_.lsn; lsn <= through; ++lsn) {
+    lsns.push_back(lsn);
+  }
+
+  STAT_INCR(stats, read_streams_num_ops);
+  STAT_INCR(stats, read_streams_point_lookup_batches);
+
+  std::vector<std::string> blobs;
+  if (store.readRecords(read_ctx->logid_, lsns, &blobs) != 0) {
+    return E::FAILED;
+  }
+  ld_check_eq(blobs.size(), lsns.size());
+
+  // Point lookups can't distinguish a clean miss from a missing copy.  The
+  // caller checks isUnderReplicated() before dispatching here, but the store
+  // may have lost records concurrently with the lookup; re-checking after the
+  // reads closes the window.  Fail the batch without moving read_ptr_ -- the
+  // retry takes the iterator path, which reports under-replicated regions.
+  if (store.isUnderReplicated()) {
+    return E::FAILED;
+  }
+
+  size_t bytes_delivered = 0;
+  int nrecords = 0;
+
+  for (size_t i = 0; i < lsns.size(); ++i) {
+    const lsn_t lsn = lsns[i];
+    const std::string& blob = blobs[i];
+    if (blob.empty()) {
+      // No record at this LSN. The lookup is authoritative (the store is not
+      // under-replicated and the LSN is below last_released_lsn_), so we can
+      // move past it, just like the iterator path does when it skips ahead.
+      read_ctx->read_ptr_ = {lsn + 1};
+      continue;
+    }
+
+    ++read_ctx->it_stats_.read_records;
+    read_ctx->it_stats_.read_record_bytes += blob.size();
+
+    // Apply the read filter that the iterator path pushes down into the
+    // copyset index, and skip dangling amends the same way
+    // applyFilterToDataRecord() does.
+    std::array<ShardID, COPYSET_SIZE_MAX> copyset;
+    copyset_size_t copyset_size;
+    LocalLogStoreRecordFormat::flags_t flags;
+    std::chrono::milliseconds timestamp;
+    int rv = LocalLogStoreRecordFormat::parse(Slice::fromString(blob),
+                                              &timestamp,
+                                              nullptr,
+                                              &flags,
+                                              nullptr,
+                                              &copyset_size,
+                                              &copyset[0],
+                                              copyset.size(),
+                                              nullptr,
+                                              nullptr,
+                                              nullptr,
+                                              store.getShardIdx());
+    if (rv == 0) {
+      if (flags & LocalLogStoreRecordFormat::FLAG_AMEND) {
+        // Copyset amendment pseudorecord not backed by an actual record,
+        // e.g. an amend that arrived after the record was trimmed.
+        read_ctx->read_ptr_ = {lsn + 1};
+        continue;
+      }
+      if (read_ctx->lls_filter_ != nullptr &&
+          !(*read_ctx->lls_filter_)(
+              read_ctx->logid_,
+              lsn,
+              &copyset[0],
+              copyset_size,
+              LocalLogStoreRecordFormat::formCopySetIndexFlags(flags),
+              RecordTimestamp(timestamp),
+              RecordTimestamp(timestamp))) {
+        ++read_ctx->it_stats_.filtered_records;
+        read_ctx->it_stats_.filtered_record_bytes += blob.size();
+        read_ctx->read_ptr_ = {lsn + 1};
+        continue;
+      }
+    }
+    // On a parse error be conservative and ship the record, like the
+    // iterator path; the worker side deals with malformed records.
+
+    const size_t msg_size = RECORD_Message::expectedSize(blob.size());
+    if (read_ctx->byteLimitReached(nrecords, bytes_delivered, msg_size)) {
+      // read_ptr_ stays at this record; the next batch re-reads it.
+      return E::BYTE_LIMIT_REACHED;
+    }
+
+    // Unlike the iterator path, the blob doesn't live in store-owned memory
+    // that outlives this call, so hand the callback an owned copy.
+    void* buf = malloc(blob.size());
+    if (buf == nullptr) {
+      throw std::bad_alloc();
+    }
+    memcpy(buf, blob.data(), blob.size());
+    RawRecord record(lsn,
+                     Slice(buf, blob.size()),
+                     /*owned=*/true,
+                     /*from_under_replicated_region=*/false);
+
+    if (callback.processRecord(record) != 0) {
+      if (err != E::CBREGISTERED) {
+        err = E::ABORTED;
+      }
+      return err;
+    }
+    bytes_delivered += msg_size;
+    ++nrecords;
+    read_ctx->read_ptr_ = {lsn + 1};
+  }
+
+  // The whole span was looked up; report the batch end the same way
+  // checkBatchComplete() would for an iterator at this position.
+  ld_check_eq(read_ctx->read_ptr_.lsn, through + 1);
+  if (read_ctx->read_ptr_.lsn > read_ctx->last_released_lsn_) {
+    return read_ctx->last_released_lsn_ < read_ctx->until_lsn_
+        ? E::CAUGHT_UP
+        : E::UNTIL_LSN_REACHED;
+  }
+  if (read_ctx->read_ptr_.lsn > read_ctx->until_lsn_) {
+    return E::UNTIL_LSN_REACHED;
+  }
+  ld_check_gt(read_ctx->read_ptr_.lsn, read_ctx->window_high_);
+  return E::WINDOW_END_REACHED;
+}
+
 Status ReadContext::checkBatchComplete(IteratorState state) {
   auto print_result = [&](Status st) {
     ld_spew("Read context: %s, state: %s, result: %s",
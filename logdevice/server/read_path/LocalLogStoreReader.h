@@ -10,8 +10,10 @@
 #include <chrono>
 #include <cstdint>
 #include <cstdlib>
+#include <functional>
 
 #include <boost/noncopyable.hpp>
+#include <folly/io/IOBuf.h>
 
 #include "logdevice/common/CopySet.h"
 #include "logdevice/common/LocalLogStoreRecordFormat.h"
@@ -55,6 +57,19 @@ class RawRecord : boost::noncopyable {
         owned(owned),
         from_under_replicated_region(from_under_replicated_region) {}
 
+  // Blob lives in a refcounted IOBuf.  Unlike the malloc-based constructor
+  // above, this allows sharing the blob: the read path clones the IOBuf to
+  // reference record payloads from outgoing RECORD messages without copying
+  // them (see ReadingCallback::shipRecord()).
+  RawRecord(lsn_t lsn,
+            folly::IOBuf blob_buf,
+            bool from_under_replicated_region = false)
+      : lsn(lsn),
+        blob(blob_buf.data(), blob_buf.length()),
+        owned(false),
+        from_under_replicated_region(from_under_replicated_region),
+        owner(std::move(blob_buf)) {}
+
   ~RawRecord() {
     if (owned) {
       std::free(const_cast<void*>(blob.data));
@@ -65,17 +80,22 @@ class RawRecord : boost::noncopyable {
       : lsn(other.lsn),
         blob(other.blob),
         owned(other.owned),
-        from_under_replicated_region(other.from_under_replicated_region) {
+        from_under_replicated_region(other.from_under_replicated_region),
+        owner(std::move(other.owner)) {
     other.lsn = LSN_INVALID;
     other.blob = Slice();
     other.owned = false;
     other.from_under_replicated_region = false;
+    other.owner = folly::IOBuf();
   }
 
   lsn_t lsn;
   Slice blob;
   bool owned;
   bool from_under_replicated_region;
+  // Non-empty iff the record was created with the IOBuf constructor; owns
+  // the memory `blob` points into.  `owned` is false in that case.
+  folly::IOBuf owner;
 };
 
 namespace LocalLogStoreReader {
@@ -139,6 +159,11 @@ struct ReadContext {
   std::shared_ptr<LocalLogStore::ReadFilter> lls_filter_;
   // A reason of the current catchup
   CatchupEventTrigger catchup_reason_;
+  // If set, called by read() between iterator steps; when it returns true
+  // the batch stops with E::ABORTED. Must be safe to call from storage
+  // threads. Used for cooperative cancellation of reads whose consumer no
+  // longer wants the data (e.g. the read stream was destroyed or rewound).
+  std::function<bool()> is_cancelled_;
   // Iterator statistics. Reset by LocalLogStoreReader::read().
   // It duplicates some of the stopping conditions, e.g.
   // the lsn in it_stats_.stop_reading_after is usually set to
@@ -247,7 +272,8 @@ class Callback {
  * - E::WOULDBLOCK (after 0+ records): no more data could be returned
  *   without performing blocking I/O, which was forbidden
  * - E::FAILED (after 0+ records): unrecoverable error such as data corruption
- * - E::ABORTED (after 0+ records): callback processRecord() signalled failure
+ * - E::ABORTED (after 0+ records): callback processRecord() signalled failure,
+ *   or read_ctx->is_cancelled_() reported that the batch was cancelled
  * - E::CBREGISTERED (after 0+ records): callback processRecord() signalled
  *   lack of bandwidth to process the record.
  *
@@ -266,6 +292,33 @@ Status read(LocalLogStore::ReadIterator& iterator,
             StatsHolder* stats,
             const Settings& settings);
 
+/**
+ * Alternative to read() for batches that span only a handful of LSNs, e.g.
+ * a catching-up reader verifying a small gap right below the tail.  Every
+ * LSN in [read_ctx->read_ptr_, min(until_lsn_, window_high_,
+ * last_released_lsn_)] is looked up with a single
+ * LocalLogStore::readRecords() call -- a batched point lookup where the
+ * store supports it -- instead of seeking an iterator and scanning.
+ * Records are filtered, size-limited and delivered through `callback`
+ * exactly like read() does; read_ctx->read_ptr_ is advanced the same way.
+ *
+ * Must not be used while store.isUnderReplicated() is true: a point lookup
+ * cannot tell a clean miss from a copy lost in a failure, while the
+ * iterator path reports such regions via accessedUnderReplicatedRegion().
+ * The caller is expected to check this before dispatching; the flag is
+ * re-checked here after the lookups, and the batch fails with E::FAILED
+ * (read_ptr_ unmoved) if the store became under-replicated concurrently.
+ * The caller should also keep the LSN span small -- cost is one lookup per
+ * LSN in the range whether or not a record exists.
+ *
+ * @return same statuses as read(), except E::WOULDBLOCK and E::PARTIAL
+ *         (lookups do blocking IO and the batch is bounded by the span).
+ */
+Status readPointLookups(const LocalLogStore& store,
+                        Callback& callback,
+                        ReadContext* read_ctx,
+                        StatsHolder* stats);
+
 /**
  * Utility function that finds the last known good ESN for a given epoch by
  * extracting it from a data record.
@@ -168,4 +168,20 @@ LogStorageStateMap::makeMap(shard_size_t num_shards) {
   return ret;
 }
 
+std::vector<std::unique_ptr<CompressedRecordTier>>
+LogStorageStateMap::makeCompressedTiers(size_t compressed_tier_size,
+                                        shard_size_t num_shards,
+                                        StatsHolder* stats) {
+  std::vector<std::unique_ptr<CompressedRecordTier>> ret;
+
+  if (compressed_tier_size > 0) {
+    for (shard_index_t s = 0; s < num_shards; ++s) {
+      ret.push_back(
+          std::make_unique<CompressedRecordTier>(compressed_tier_size, stats));
+    }
+  }
+
+  return ret;
+}
+
 }} // namespace facebook::logdevice
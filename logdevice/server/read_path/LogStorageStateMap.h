@@ -18,6 +18,7 @@
 #include "logdevice/common/util.h"
 #include "logdevice/include/Err.h"
 #include "logdevice/include/types.h"
+#include "logdevice/server/CompressedRecordTier.h"
 #include "logdevice/server/RecordCacheDisposal.h"
 #include "logdevice/server/RecordCacheMonitorThread.h"
 #include "logdevice/server/read_path/LogStorageState.h"
@@ -33,14 +34,18 @@ namespace facebook { namespace logdevice {
 class LogStorageStateMap {
  public:
   /**
-   * @param num_shards         Number of shards on this node
-   *                           map, required by AtomicHashMap
-   * @param recovery_interval  interval between consecutive attempts to recover
-   *                           log state
+   * @param num_shards             Number of shards on this node
+   *                               map, required by AtomicHashMap
+   * @param compressed_tier_size   per-shard byte budget for the compressed
+   *                               second tier of the record cache, 0 to
+   *                               disable it
+   * @param recovery_interval      interval between consecutive attempts to
+   *                               recover log state
    */
   explicit LogStorageStateMap(shard_size_t num_shards,
                               StatsHolder* stats,
                               bool enable_record_cache,
+                              size_t compressed_tier_size = 0,
                               std::chrono::microseconds recovery_interval =
                                   std::chrono::microseconds(500000))
       : cache_disposal_(enable_record_cache
@@ -49,6 +54,12 @@ class LogStorageStateMap {
         num_shards_(num_shards),
         processor_(nullptr),
         shard_map_(makeMap(num_shards)),
+        compressed_tiers_(makeCompressedTiers(
+            // The tier only ever gets records out of the record cache, so
+            // it's pointless without it.
+            enable_record_cache ? compressed_tier_size : 0,
+            num_shards,
+            stats)),
         state_recovery_interval_(recovery_interval),
         stats_(stats) {}
 
@@ -163,6 +174,18 @@ class LogStorageStateMap {
   void setProcessor(ServerProcessor*);
   StatsHolder* getStats();
 
+  /**
+   * Compressed second tier of the record cache for the given shard, nullptr
+   * if the tier is disabled.
+   */
+  CompressedRecordTier* getCompressedRecordTier(shard_index_t shard) const {
+    if (compressed_tiers_.empty()) {
+      return nullptr;
+    }
+    ld_check(shard < compressed_tiers_.size());
+    return compressed_tiers_[shard].get();
+  }
+
   /**
    * Disposal for evicted cache entries, nullptr if record caching is
    * disabled.
@@ -185,6 +208,14 @@ class LogStorageStateMap {
 
   static std::vector<std::unique_ptr<Map>> makeMap(shard_size_t num_shards);
 
+  // One tier per shard; empty if the tier is disabled.
+  const std::vector<std::unique_ptr<CompressedRecordTier>> compressed_tiers_;
+
+  static std::vector<std::unique_ptr<CompressedRecordTier>>
+  makeCompressedTiers(size_t compressed_tier_size,
+                      shard_size_t num_shards,
+                      StatsHolder* stats);
+
   // Attempt to recover log state only once this many usecs.
   std::chrono::microseconds state_recovery_interval_;
 
@@ -11,6 +11,7 @@
 #include <string>
 
 #include "logdevice/common/AdminCommandTable.h"
+#include "logdevice/common/PriorityMap.h"
 #include "logdevice/common/SocketSender.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/configuration/Configuration.h"
@@ -47,6 +48,7 @@ ServerReadStream::ServerReadStream(const std::string& csid,
       version_(0),
       ref_holder_(this),
       filter_version_(0),
+      shared_filter_version_(std::make_shared<std::atomic<uint64_t>>(0)),
       include_extra_metadata_(false),
       fill_cache_(true),
       ignore_released_status_(false),
@@ -85,6 +87,7 @@ ServerReadStream::~ServerReadStream() {
 
 const SimpleEnumMap<ServerReadStream::RecordSource, const char*>
     ServerReadStream::names{{RecordSource::REAL_TIME, "REAL_TIME"},
+                            {RecordSource::COMPRESSED_TIER, "COMPRESSED_TIER"},
                             {RecordSource::NON_BLOCKING, "NON_BLOCKING"},
                             {RecordSource::BLOCKING, "BLOCKING"}};
 
@@ -218,6 +221,16 @@ void ServerReadStream::setTrafficClass(TrafficClass c) {
   if (traffic_class_ != TrafficClass::MAX) {
     TRAFFIC_CLASS_STAT_INCR(stats_, traffic_class_, read_streams_created);
   }
+
+  // Keep the read shaping priority in sync with the traffic class, using the
+  // same mapping that network shaping applies to outgoing messages. The
+  // priority tags both the bandwidth debits made on behalf of this stream and
+  // the ReadStorageTasks it issues, so reads are prioritized consistently
+  // from the shaper down to the per-shard storage queue.
+  Priority rp = PriorityMap::fromTrafficClass()[c];
+  if (rp != Priority::INVALID) {
+    setPriority(rp);
+  }
 }
 
 void ServerReadStream::getDebugInfo(InfoReadersTable& table) const {
@@ -310,6 +323,11 @@ void ServerReadStream::noteSent(StatsHolder* stats,
       STAT_INCR(stats, read_streams_records_real_time);
       STAT_ADD(stats, read_streams_bytes_real_time, msg_size_bytes_approx);
       break;
+    case RecordSource::COMPRESSED_TIER:
+      STAT_INCR(stats, read_streams_records_compressed_tier);
+      STAT_ADD(
+          stats, read_streams_bytes_compressed_tier, msg_size_bytes_approx);
+      break;
     case RecordSource::NON_BLOCKING:
       STAT_INCR(stats, read_streams_records_non_blocking);
       STAT_ADD(stats, read_streams_bytes_non_blocking, msg_size_bytes_approx);
@@ -331,6 +349,9 @@ void ServerReadStream::noteSent(StatsHolder* stats,
     case RecordSource::REAL_TIME:
       STAT_INCR(stats, real_time_switched_to_real_time);
       break;
+    case RecordSource::COMPRESSED_TIER:
+      STAT_INCR(stats, real_time_switched_to_compressed_tier);
+      break;
     case RecordSource::NON_BLOCKING:
       STAT_INCR(stats, real_time_switched_to_non_blocking);
       break;
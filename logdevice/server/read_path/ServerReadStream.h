@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <memory>
 
@@ -30,6 +31,7 @@
 #include "logdevice/include/strong_typedef.h"
 #include "logdevice/include/types.h"
 #include "logdevice/server/RealTimeRecordBuffer.h"
+#include "logdevice/server/read_path/DrainRateEstimator.h"
 #include "logdevice/server/read_path/LocalLogStoreReader.h"
 #include "logdevice/server/read_path/ReadIoShapingCallback.h"
 
@@ -219,6 +221,20 @@ class ServerReadStream : boost::noncopyable {
 
   void addReleasedRecords(const std::shared_ptr<ReleasedRecords>& ptr);
 
+  /**
+   * @return true if some pending ReleasedRecords instance contains the given
+   *         LSN, i.e. reading from this position can be served straight from
+   *         the real-time record buffer without a storage task.
+   */
+  bool releasedRecordsCover(lsn_t lsn) const {
+    for (const auto& records : released_records_) {
+      if (!(*records < lsn) && !(*records > lsn)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
   std::vector<std::shared_ptr<ReleasedRecords>> giveReleasedRecords() {
     // Note: the move constructor here doesn't guarantee that released_records_
     // will be empty.  In fact, the optimizer may elide the construction of a
@@ -377,6 +393,26 @@ class ServerReadStream : boost::noncopyable {
    */
   filter_version_t filter_version_;
 
+  /**
+   * Mirror of filter_version_ that may be read from storage threads.
+   * ReadStorageTask keeps a reference to it and compares it against the
+   * filter version it was created with between iterator steps, so that a
+   * batch for a stream that has rewound stops doing disk work early. Held
+   * through a shared_ptr so the mirror outlives this stream while tasks are
+   * in flight.
+   */
+  std::shared_ptr<std::atomic<uint64_t>> shared_filter_version_;
+
+  /**
+   * Updates filter_version_ and its cross-thread mirror. Must be used
+   * instead of assigning filter_version_ directly so that in-flight
+   * ReadStorageTasks observe the rewind.
+   */
+  void setFilterVersion(filter_version_t fv) {
+    filter_version_ = fv;
+    shared_filter_version_->store(fv.val(), std::memory_order_relaxed);
+  }
+
   /**
    * Support for verifying stream invariants as the message layer confirms
    * messages are sent.
@@ -442,6 +478,13 @@ class ServerReadStream : boost::noncopyable {
    */
   bool payload_hash_only_ = false;
 
+  /**
+   * Tracks how fast this stream's RECORD bytes drain into the client's
+   * socket; used to size read batches when --adaptive-catchup-batches is
+   * enabled.
+   */
+  DrainRateEstimator drain_rate_;
+
   /**
    * Indicate that storage node should try to send byte offset of log up to
    * current reading record if record contain offset_within_epoch. Byte offset
@@ -533,7 +576,13 @@ class ServerReadStream : boost::noncopyable {
   // onSent handler
   std::shared_ptr<std::string> log_group_path_;
 
-  enum class RecordSource { REAL_TIME, NON_BLOCKING, BLOCKING, MAX };
+  enum class RecordSource {
+    REAL_TIME,
+    COMPRESSED_TIER,
+    NON_BLOCKING,
+    BLOCKING,
+    MAX
+  };
 
   static const SimpleEnumMap<RecordSource, const char*> names;
 
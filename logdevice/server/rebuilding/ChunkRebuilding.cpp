@@ -58,6 +58,22 @@ ChunkRebuilding::getRebuildingSettings() const {
   return rebuildingSettings_;
 }
 
+bool ChunkRebuilding::getCopysetFromCache(const copyset_t& base,
+                                          copyset_t* copyset_out) const {
+  if (!copysetCached_ || cachedCopysetBase_ != base) {
+    return false;
+  }
+  *copyset_out = cachedCopyset_;
+  return true;
+}
+
+void ChunkRebuilding::putCopysetInCache(const copyset_t& base,
+                                        const copyset_t& copyset) {
+  cachedCopysetBase_ = base;
+  cachedCopyset_ = copyset;
+  copysetCached_ = true;
+}
+
 void ChunkRebuilding::start() {
   ld_check(data_->numRecords() > 0);
   readOnly_ =
@@ -158,10 +174,7 @@ bool ChunkRebuilding::onStored(const STORED_Header& header,
 void ChunkRebuilding::onAllStoresReceived(
     lsn_t lsn,
     std::unique_ptr<FlushTokenMap> flushTokenMap) {
-  if (!flushTokenMap->empty()) {
-    // TODO (#24665001): Wait for flushes. For now, setting
-    // rebuild-store-durability=memory just loses memtables on crash.
-  }
+  onFlushTokensReceived(*flushTokenMap);
   ld_check(numInFlight_ > 0);
   ssize_t idx = data_->findLSN(lsn);
   ld_check(idx != -1);
@@ -191,9 +204,7 @@ void ChunkRebuilding::onCopysetInvalid(lsn_t lsn) {
 void ChunkRebuilding::onAllAmendsReceived(
     lsn_t lsn,
     std::unique_ptr<FlushTokenMap> flushTokenMap) {
-  if (!flushTokenMap->empty()) {
-    // TODO (#24665001): Wait for flushes.
-  }
+  onFlushTokensReceived(*flushTokenMap);
   onAmendDone(lsn);
 }
 
@@ -208,21 +219,107 @@ void ChunkRebuilding::onAmendDone(lsn_t lsn) {
   --numInFlight_;
 
   if (numInFlight_ == 0) {
-    owner_.postCallbackRequest([chunk_id = chunkID_,
-                                oldest_timestamp = data_->oldestTimestamp](
-                                   ShardRebuilding* shard_rebuilding) {
-      if (!shard_rebuilding) {
-        RATELIMIT_INFO(
-            std::chrono::seconds(10),
-            1,
-            "ShardRebuilding went away while ChunkRebuilding was in flight.");
-        return;
-      }
-      shard_rebuilding->onChunkRebuildingDone(chunk_id, oldest_timestamp);
-    });
+    allRecordsDone_ = true;
+    if (!pendingFlushTokens_.empty()) {
+      WORKER_STAT_INCR(rebuilding_chunks_waited_for_flush);
+    }
+    finalizeIfDone();
+  }
+}
+
+void ChunkRebuilding::onFlushTokensReceived(const FlushTokenMap& tokens) {
+  for (const auto& kv : tokens) {
+    auto ins = pendingFlushTokens_.insert(kv);
+    if (!ins.second) {
+      ins.first->second = std::max(ins.first->second, kv.second);
+    }
+  }
+}
+
+void ChunkRebuilding::onMemtableFlushed(node_index_t node_index,
+                                        ServerInstanceId server_instance_id,
+                                        FlushToken flushed_up_to) {
+  bool recipient_restarted = false;
+  for (auto it = pendingFlushTokens_.begin();
+       it != pendingFlushTokens_.end();) {
+    if (it->first.first != node_index) {
+      ++it;
+    } else if (it->first.second == server_instance_id &&
+               it->second <= flushed_up_to) {
+      // These stores reached stable storage.
+      it = pendingFlushTokens_.erase(it);
+    } else if (it->first.second < server_instance_id) {
+      // The node restarted since it acknowledged our stores. The memtables
+      // we were waiting on are gone, and our copies with them.
+      recipient_restarted = true;
+      ++it;
+    } else {
+      ++it;
+    }
+  }
+
+  if (recipient_restarted) {
+    RATELIMIT_WARNING(std::chrono::seconds(10),
+                      2,
+                      "N%hd restarted before flushing rebuilding stores of "
+                      "chunk %lu [%s, %s]. Re-replicating the chunk.",
+                      node_index,
+                      data_->address.log.val(),
+                      lsn_to_string(data_->address.min_lsn).c_str(),
+                      lsn_to_string(data_->address.max_lsn).c_str());
+    WORKER_STAT_INCR(rebuilding_chunks_restarted_after_recipient_restart);
+    restart();
+    return;
+  }
+
+  finalizeIfDone();
+}
 
-    deleteThis();
+void ChunkRebuilding::finalizeIfDone() {
+  if (!allRecordsDone_) {
+    return;
+  }
+  if (!pendingFlushTokens_.empty()) {
+    // rebuild-store-durability is "memory" and some recipients haven't
+    // flushed our stores yet. Stay registered and wait for MEMTABLE_FLUSHED
+    // notifications; the flush triggers on the recipients (e.g.
+    // --rocksdb-partition-data-age-flush-trigger) bound the wait.
+    ld_spew("Chunk %lu [%s, %s] is waiting for %lu memtable flushes",
+            data_->address.log.val(),
+            lsn_to_string(data_->address.min_lsn).c_str(),
+            lsn_to_string(data_->address.max_lsn).c_str(),
+            pendingFlushTokens_.size());
+    return;
   }
+
+  owner_.postCallbackRequest([chunk_id = chunkID_,
+                              oldest_timestamp = data_->oldestTimestamp](
+                                 ShardRebuilding* shard_rebuilding) {
+    if (!shard_rebuilding) {
+      RATELIMIT_INFO(
+          std::chrono::seconds(10),
+          1,
+          "ShardRebuilding went away while ChunkRebuilding was in flight.");
+      return;
+    }
+    shard_rebuilding->onChunkRebuildingDone(chunk_id, oldest_timestamp);
+  });
+
+  deleteThis();
+}
+
+void ChunkRebuilding::restart() {
+  // Stale STOREDs from the aborted attempt may still arrive and be credited
+  // to the new RecordRebuildingStores. That's harmless: any flush token they
+  // carry is keyed by the old server instance id, so it will just trigger
+  // another restart if the store didn't actually survive.
+  rrStores_.clear();
+  rrAmends_.clear();
+  pendingFlushTokens_.clear();
+  numInFlight_ = 0;
+  allRecordsDone_ = false;
+  copysetCached_ = false;
+  start();
 }
 
 void ChunkRebuilding::deleteThis() {
@@ -24,16 +24,22 @@ namespace facebook { namespace logdevice {
  *       Currently ChunkRebuilding is implemented as a collection of
  *       RecordRebuildingStore and RecordRebuildingAmend state machines for
  *       individual records, which defeats some of the purpose of having chunks
- *       in the first place. (The separation between Store and Amend part of
- *       RecordRebuilding is a leftover from rebuilding without WAL feature,
- *       which was removed and needs to be reimplemented; without it the
- *       separation serves no purpose.) Would be good to refactor it to do the
+ *       in the first place. Would be good to refactor it to do the
  *       actual re-replication work (picking copyset, sending out stores and
  *       amends, dealing with timeouts, etc) in ChunkRebuilding directly -
  *       perhaps by moving most of the code from RecordRebuilding* into
  *       ChunkRebuilding, and perhaps adding a multi-STORE message to send the
  *       whole chunk at once (which may also simplify handling of timeouts and
  *       other errors).
+ *
+ *       When rebuild-store-durability is "memory", recipients store our
+ *       records without writing the RocksDB WAL and acknowledge them with a
+ *       flush token. The chunk then acts as a durability barrier: it's not
+ *       reported as done to ShardRebuilding until MEMTABLE_FLUSHED
+ *       notifications confirm that every recipient has flushed past the
+ *       tokens it gave us. If a recipient restarts before flushing, our
+ *       copies died with its memtables and the chunk is re-replicated from
+ *       scratch.
  */
 
 struct ChunkAddress {
@@ -159,6 +165,13 @@ class ChunkRebuilding : public RecordRebuildingOwner {
   ServerInstanceId getServerInstanceId() const override;
   UpdateableSettings<RebuildingSettings> getRebuildingSettings() const override;
 
+  // Chunk-level cache of copyset selection, shared by the RecordRebuildings
+  // of this chunk; see RecordRebuildingOwner for details.
+  bool getCopysetFromCache(const copyset_t& base,
+                           copyset_t* copyset_out) const override;
+  void putCopysetInCache(const copyset_t& base,
+                         const copyset_t& copyset) override;
+
   // These are routed to a corresponding RecordRebuilding.
   // Return false if the corresponding RecordRebuilding has completed; the
   // caller prints a warning in this case.
@@ -175,6 +188,17 @@ class ChunkRebuilding : public RecordRebuildingOwner {
                 ServerInstanceId server_instance_id,
                 FlushToken flush_token);
 
+  // Called (via MemtableFlushedRequest) when a storage node notifies us that
+  // it has flushed its memtables up to `flushed_up_to`. Discharges matching
+  // pending flush tokens and completes the chunk if nothing is left to wait
+  // for. If the node restarted since it acknowledged our stores (its server
+  // instance id changed), the copies it accepted may have been lost with its
+  // memtables, and the whole chunk is re-replicated.
+  // May unregister and destroy `this`.
+  void onMemtableFlushed(node_index_t node_index,
+                         ServerInstanceId server_instance_id,
+                         FlushToken flushed_up_to);
+
   // These indicate that one of the RecordRebuildings has completed.
   void
   onAllStoresReceived(lsn_t lsn,
@@ -205,11 +229,39 @@ class ChunkRebuilding : public RecordRebuildingOwner {
   std::vector<std::unique_ptr<RecordRebuildingStore>> rrStores_;
   std::vector<std::unique_ptr<RecordRebuildingAmend>> rrAmends_;
 
+  // Copyset picked for the first record of the chunk, reused by the other
+  // records as long as they derive the same base from their existing copyset.
+  copyset_t cachedCopysetBase_;
+  copyset_t cachedCopyset_;
+  bool copysetCached_ = false;
+
   size_t numInFlight_ = 0;
 
   bool readOnly_ = false;
 
+  // True when all RecordRebuildings have completed. The chunk may still be
+  // waiting for pendingFlushTokens_ to drain at that point.
+  bool allRecordsDone_ = false;
+
+  // Flush tokens from STORED replies that the recipients haven't flushed to
+  // stable storage yet. Only populated when rebuild-store-durability is
+  // "memory"; the chunk is not done until this is empty.
+  FlushTokenMap pendingFlushTokens_;
+
   void onAmendDone(lsn_t lsn);
+
+  // Folds the flush tokens collected by a completed RecordRebuilding into
+  // pendingFlushTokens_.
+  void onFlushTokensReceived(const FlushTokenMap& tokens);
+
+  // Reports the chunk as done to ShardRebuilding and unregisters `this`,
+  // unless some records are still in flight or some recipients haven't
+  // flushed our stores yet.
+  void finalizeIfDone();
+
+  // Re-replicates the chunk from scratch. Used when a recipient restarted
+  // before flushing our stores.
+  void restart();
 };
 
 class StartChunkRebuildingRequest : public Request {
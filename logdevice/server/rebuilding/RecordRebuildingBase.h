@@ -104,8 +104,8 @@ struct ReplicationScheme {
 // In order to reduce the memory usage while waiting for stores
 // to be durable, we use this struct to hold necessary info and create a
 // RecordRebuildingAmendState machine only when it is required.
-using RebuildingStoreChain = folly::small_vector<StoreChainLink, 6>;
-using RebuildingCopyset = folly::small_vector<ShardID, 6>;
+using RebuildingStoreChain = copyset_chain_t;
+using RebuildingCopyset = copyset_t;
 using RebuildingLegacyCopyset = folly::small_vector<node_index_t, 6>;
 struct RecordRebuildingAmendState {
  public:
@@ -156,6 +156,23 @@ class RecordRebuildingOwner {
   virtual void
   onAllAmendsReceived(lsn_t lsn,
                       std::unique_ptr<FlushTokenMap> flushTokenMap) = 0;
+
+  /**
+   * Chunk-level cache of copyset selection results. All records in a chunk
+   * have the same block ID and (usually) the same existing copyset, and
+   * copyset selection is deterministic in those, so the result computed for
+   * the first record of the chunk is almost always valid for the rest of it.
+   * `base` is the part of the existing copyset that's being kept (the input
+   * of copyset selection). getCopysetFromCache() returns true and fills
+   * *copyset_out if a result computed from the same base is cached.
+   * The default implementation caches nothing.
+   */
+  virtual bool getCopysetFromCache(const copyset_t& base,
+                                   copyset_t* copyset_out) const {
+    return false;
+  }
+  virtual void putCopysetInCache(const copyset_t& base,
+                                 const copyset_t& copyset) {}
 };
 
 class RecordRebuildingBase : public RecordRebuildingInterface {
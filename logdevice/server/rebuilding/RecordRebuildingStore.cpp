@@ -304,19 +304,40 @@ int RecordRebuildingStore::pickCopyset() {
 
   copyset_t amendable_copies = newCopyset_;
 
-  int rv = pickCopysetImpl();
-  if (rv != 0) {
-    RATELIMIT_ERROR(
-        std::chrono::seconds(10),
-        2,
-        "Failed to pick copyset to re-replicate record %lu%s, will retry. "
-        "existing copies: %s, rebuilding set: %s",
-        owner_->getLogID().val_,
-        lsn_to_string(lsn_).c_str(),
-        toString(amendable_copies).c_str(),
-        owner_->getRebuildingSet().describe().c_str());
-    err = E::FAILED;
-    return -1;
+  // Records of a chunk share block ID and (usually) existing copyset, and
+  // copyset selection is deterministic in those, so the copyset picked for
+  // the first record of the chunk is almost always what we'd pick here too.
+  // Ask the owner for a cached result before running the copyset selector.
+  // Only the first wave uses the cache: if a wave failed, each record should
+  // pick a fresh copyset rather than re-pick the one that just failed.
+  bool cache_hit = false;
+  if (rebuildingWave_ == 1) {
+    copyset_t cached;
+    if (owner_->getCopysetFromCache(newCopyset_, &cached)) {
+      newCopyset_ = std::move(cached);
+      cache_hit = true;
+      WORKER_STAT_INCR(rebuilding_copyset_cache_hits);
+    }
+  }
+
+  if (!cache_hit) {
+    int rv = pickCopysetImpl();
+    if (rv != 0) {
+      RATELIMIT_ERROR(
+          std::chrono::seconds(10),
+          2,
+          "Failed to pick copyset to re-replicate record %lu%s, will retry. "
+          "existing copies: %s, rebuilding set: %s",
+          owner_->getLogID().val_,
+          lsn_to_string(lsn_).c_str(),
+          toString(amendable_copies).c_str(),
+          owner_->getRebuildingSet().describe().c_str());
+      err = E::FAILED;
+      return -1;
+    }
+    if (rebuildingWave_ == 1) {
+      owner_->putCopysetInCache(amendable_copies, newCopyset_);
+    }
   }
   ld_check(newCopyset_.size() == replication_factor);
   storeHeader_.copyset_size = newCopyset_.size();
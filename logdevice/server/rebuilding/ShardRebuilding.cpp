@@ -7,7 +7,13 @@
  */
 #include "logdevice/server/rebuilding/ShardRebuilding.h"
 
+#include <algorithm>
+#include <cmath>
+
+#include <folly/hash/Hash.h>
+
 #include "logdevice/common/AdminCommandTable.h"
+#include "logdevice/common/ClusterState.h"
 #include "logdevice/common/MetaDataLog.h"
 #include "logdevice/common/configuration/InternalLogs.h"
 #include "logdevice/server/ServerWorker.h"
@@ -19,8 +25,26 @@ namespace facebook { namespace logdevice {
 static constexpr std::chrono::milliseconds PROFILING_TIMER_PERIOD =
     std::chrono::minutes(1);
 
+// Smoothing horizon of the throughput model used for ETA estimation.
+// Long enough to ride out individual slow partitions, short enough that an
+// actual change in donor throughput shows up within a few minutes.
+static constexpr std::chrono::minutes PROGRESS_RATE_SMOOTHING{10};
+
 std::atomic<chunk_rebuilding_id_t::raw_type> ShardRebuilding::nextChunkID_{0};
 
+// Don't use timestamp window (both local and global) for metadata/internal
+// logs. These logs are not stored in partitions and are read in log-by-log
+// order rather than roughly chronological (partition-by-partition) order,
+// so timestamp windows make no sense for these logs. The recipient storage
+// nodes also don't care how spread out the timestamps of these records are,
+// since they're all going to the same "unpartitioned" column family, unlike
+// data log records that go to many different partitions.
+// All metadata/internal logs are read before any data logs.
+static bool isLogExemptedFromWindow(logid_t log) {
+  return MetaDataLog::isMetaDataLog(log) ||
+      configuration::InternalLogs::isInternal(log);
+}
+
 ShardRebuilding::ShardRebuilding(
     shard_index_t shard,
     lsn_t rebuilding_version,
@@ -45,6 +69,7 @@ ShardRebuilding::ShardRebuilding(
 ShardRebuilding::~ShardRebuilding() {
   PER_SHARD_STAT_SET(
       getStats(), rebuilding_global_window_waiting_flag, shard_, 0);
+  PER_SHARD_STAT_SET(getStats(), rebuilding_estimated_eta_sec, shard_, 0);
   abortChunkRebuildings();
 }
 
@@ -67,30 +92,50 @@ void ShardRebuilding::start(
   startTime_ = SteadyTimestamp::now();
   readingProgressTimestamp_ = direction_.firstTimestamp();
   readRateLimiter_ = RateLimiter(rebuildingSettings_->rate_limit);
-  readContext_ = std::make_shared<RebuildingReadStorageTask::Context>();
-  readContext_->onDone = [this, this_ref = callbackHelper_.getHolder().ref()](
-                             std::vector<std::unique_ptr<ChunkData>> chunks) {
-    if (this_ref.get() != nullptr) {
-      onReadTaskDone(std::move(chunks));
-    }
-  };
-  readContext_->rebuildingSet = rebuildingSet_;
-  readContext_->rebuildingSettings = rebuildingSettings_;
-  readContext_->myShardID = ShardID(getMyNodeIndex(), shard_);
-  readContext_->progressTimestamp = direction_.firstTimestamp();
+  throttledByHealth_ = false;
+  updateReadRateLimit();
+
+  // Stripe reading across multiple streams if requested. Logs are assigned
+  // to streams by hash, so each log is read by exactly one stream, and all
+  // the per-log sequential state in the reading context (sticky copyset
+  // block detection, last seen LSN) keeps working as in the single-iterator
+  // case. No point in more streams than logs.
+  const size_t nstreams =
+      std::min(std::max<size_t>(1, rebuildingSettings_->read_streams),
+               std::max<size_t>(1, plan.size()));
+  readStreams_.resize(nstreams);
+  for (size_t i = 0; i < nstreams; ++i) {
+    ReadStream& stream = readStreams_[i];
+    stream.progressTimestamp = direction_.firstTimestamp();
+    stream.context = std::make_shared<RebuildingReadStorageTask::Context>();
+    stream.context->onDone =
+        [this, i, this_ref = callbackHelper_.getHolder().ref()](
+            std::vector<std::unique_ptr<ChunkData>> chunks) {
+          if (this_ref.get() != nullptr) {
+            onReadTaskDone(i, std::move(chunks));
+          }
+        };
+    stream.context->rebuildingSet = rebuildingSet_;
+    stream.context->rebuildingSettings = rebuildingSettings_;
+    stream.context->myShardID = ShardID(getMyNodeIndex(), shard_);
+    stream.context->progressTimestamp = direction_.firstTimestamp();
+    stream.iteratorInvalidationTimer =
+        createTimer([this, i] { invalidateIterator(i); });
+  }
 
   for (const auto& log_plan : plan) {
-    auto ins = readContext_->logs.emplace(
-        std::piecewise_construct,
-        std::forward_as_tuple(log_plan.first),
-        std::forward_as_tuple(std::move(*log_plan.second)));
+    auto& context = *readStreams_[mapLogToReadStream(log_plan.first)].context;
+    auto ins =
+        context.logs.emplace(std::piecewise_construct,
+                             std::forward_as_tuple(log_plan.first),
+                             std::forward_as_tuple(std::move(*log_plan.second)));
     ld_check(ins.second);
   }
 
   delayedReadTimer_ = createTimer([this] { tryMakeProgress(); });
-  iteratorInvalidationTimer_ = createTimer([this] { invalidateIterator(); });
   profilingTimer_ = createTimer([this] {
     flushCurrentStateTime();
+    updateProgressEstimate();
     profilingTimer_->activate(PROFILING_TIMER_PERIOD);
   });
 
@@ -101,7 +146,7 @@ void ShardRebuilding::start(
 
 void ShardRebuilding::advanceGlobalWindow(RecordTimestamp new_window_end) {
   globalWindowEnd_ = new_window_end;
-  if (readContext_ != nullptr) {
+  if (!readStreams_.empty()) {
     tryMakeProgress();
   } else {
     // start() hasn't been called yet.
@@ -110,42 +155,50 @@ void ShardRebuilding::advanceGlobalWindow(RecordTimestamp new_window_end) {
 
 void ShardRebuilding::sendStorageTaskIfNeeded() {
   const size_t read_batch_size = rebuildingSettings_->max_batch_bytes;
-  // Hard code max size of readBuffer_ as 3x max read batch size.
+  // Hard code max size of readBuffer_ as 3x max read batch size per stream.
   // This could be a separate setting, but that doesn't seem very useful.
-  const size_t max_read_buffer_size = read_batch_size * 3;
-
-  // Note that reading is not affected by global window or
-  // max_record_bytes_in_flight. Reading just tries to keep readBuffer_
-  // reasonably full.
-  if (completed_ || storageTaskInFlight_ || readContext_->reachedEnd ||
-      readContext_->persistentError ||
-      bytesInReadBuffer_ + read_batch_size > max_read_buffer_size ||
-      rebuildingSettings_->test_stall_rebuilding) {
+  const size_t max_read_buffer_size =
+      read_batch_size * 3 * readStreams_.size();
+
+  if (completed_ || rebuildingSettings_->test_stall_rebuilding) {
     return;
   }
 
-  // Consult rate limiter. Use zero cost for now. We'll tell rate limiter the
-  // actual cost in bytes once the storage task is done.
-  std::chrono::steady_clock::duration to_wait;
-  bool allowed = readRateLimiter_.isAllowed(
-      0, &to_wait, std::chrono::steady_clock::duration::zero());
-  if (!allowed) {
-    if (to_wait != std::chrono::steady_clock::duration::max()) {
-      delayedReadTimer_->activate(
-          std::chrono::duration_cast<std::chrono::microseconds>(to_wait));
+  for (size_t i = 0; i < readStreams_.size(); ++i) {
+    ReadStream& stream = readStreams_[i];
+    // Note that reading is not affected by global window or
+    // max_record_bytes_in_flight. Reading just tries to keep readBuffer_
+    // reasonably full.
+    if (stream.storageTaskInFlight || stream.context->reachedEnd ||
+        stream.context->persistentError ||
+        bytesInReadBuffer_ + read_batch_size > max_read_buffer_size) {
+      continue;
+    }
+
+    // Consult rate limiter. Use zero cost for now. We'll tell rate limiter
+    // the actual cost in bytes once the storage task is done.
+    std::chrono::steady_clock::duration to_wait;
+    bool allowed = readRateLimiter_.isAllowed(
+        0, &to_wait, std::chrono::steady_clock::duration::zero());
+    if (!allowed) {
+      if (to_wait != std::chrono::steady_clock::duration::max()) {
+        delayedReadTimer_->activate(
+            std::chrono::duration_cast<std::chrono::microseconds>(to_wait));
+      }
+      return;
     }
-    return;
-  }
 
-  if (readContext_->iterator != nullptr) {
-    iteratorInvalidationTimer_->cancel();
+    if (stream.context->iterator != nullptr) {
+      stream.iteratorInvalidationTimer->cancel();
+    }
+    stream.storageTaskInFlight = true;
+    putStorageTask(i);
   }
-  storageTaskInFlight_ = true;
-  putStorageTask();
 }
 
-void ShardRebuilding::putStorageTask() {
-  auto task = std::make_unique<RebuildingReadStorageTask>(readContext_);
+void ShardRebuilding::putStorageTask(size_t stream_idx) {
+  auto task = std::make_unique<RebuildingReadStorageTask>(
+      readStreams_[stream_idx].context);
   auto task_queue =
       ServerWorker::onThisThread()->getStorageTaskQueueForShard(shard_);
   task_queue->putTask(std::move(task));
@@ -155,23 +208,168 @@ std::chrono::milliseconds ShardRebuilding::getIteratorTTL() {
   return Worker::settings().iterator_cache_ttl;
 }
 
+NodeHealthStatus ShardRebuilding::getLocalNodeHealthStatus() {
+  ClusterState* cluster_state = Worker::getClusterState();
+  if (cluster_state == nullptr) {
+    return NodeHealthStatus::UNDEFINED;
+  }
+  return cluster_state->getNodeStatus(getMyNodeIndex());
+}
+
 std::unique_ptr<TimerInterface>
 ShardRebuilding::createTimer(std::function<void()> cb) {
   return std::make_unique<Timer>(cb);
 }
 
-void ShardRebuilding::invalidateIterator() {
+void ShardRebuilding::invalidateIterator(size_t stream_idx) {
   ld_info("Invalidating rebuilding iterator in shard %u", shard_);
-  ld_check(!storageTaskInFlight_);
-  ld_check(readContext_->iterator != nullptr);
-  readContext_->iterator->invalidate();
+  ReadStream& stream = readStreams_.at(stream_idx);
+  ld_check(!stream.storageTaskInFlight);
+  ld_check(stream.context->iterator != nullptr);
+  stream.context->iterator->invalidate();
+}
+
+size_t ShardRebuilding::mapLogToReadStream(logid_t log) const {
+  ld_check(!readStreams_.empty());
+  return folly::hash::twang_mix64(log.val()) % readStreams_.size();
+}
+
+bool ShardRebuilding::anyStorageTaskInFlight() const {
+  for (const ReadStream& stream : readStreams_) {
+    if (stream.storageTaskInFlight) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ShardRebuilding::anyStreamPersistentError() const {
+  for (const ReadStream& stream : readStreams_) {
+    if (!stream.storageTaskInFlight && stream.context->persistentError) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void ShardRebuilding::recomputeReadingProgress() {
+  // The overall reading position is the least advanced of the streams'
+  // positions, and the progress fraction is the average, since the streams
+  // cover disjoint subsets of the logs of roughly equal total size.
+  RecordTimestamp timestamp = direction_.lastTimestamp();
+  double progress = 0;
+  bool progress_supported = true;
+  for (const ReadStream& stream : readStreams_) {
+    if (direction_.timestampCmp(stream.progressTimestamp, timestamp) < 0) {
+      timestamp = stream.progressTimestamp;
+    }
+    if (stream.progress == -1) {
+      progress_supported = false;
+    } else {
+      progress += stream.progress;
+    }
+  }
+  readingProgressTimestamp_ = timestamp;
+  readingProgress_ =
+      progress_supported ? progress / readStreams_.size() : -1;
+}
+
+void ShardRebuilding::updateProgressEstimate() {
+  const auto now = SteadyTimestamp::now();
+  if (completed_ || readingProgress_ < 0) {
+    progressRateValid_ = false;
+    PER_SHARD_STAT_SET(getStats(), rebuilding_estimated_eta_sec, shard_, 0);
+    return;
+  }
+  if (lastProgressSampleTime_ == SteadyTimestamp::min()) {
+    // First sample; just record the starting point.
+    lastProgressFraction_ = readingProgress_;
+    lastProgressSampleTime_ = now;
+    return;
+  }
+  const double dt = std::chrono::duration_cast<std::chrono::duration<double>>(
+                        now - lastProgressSampleTime_)
+                        .count();
+  if (dt <= 0) {
+    return;
+  }
+  const double rate = (readingProgress_ - lastProgressFraction_) / dt;
+  lastProgressFraction_ = readingProgress_;
+  lastProgressSampleTime_ = now;
+
+  // Time-aware EWMA: however often the timer happens to fire, samples stop
+  // mattering once they're older than the smoothing horizon.
+  const double alpha = 1 -
+      std::exp(-dt /
+               std::chrono::duration_cast<std::chrono::duration<double>>(
+                   PROGRESS_RATE_SMOOTHING)
+                   .count());
+  if (!progressRateValid_) {
+    progressRate_ = rate;
+    progressRateVar_ = 0;
+    progressRateValid_ = true;
+  } else {
+    const double dev = rate - progressRate_;
+    progressRate_ += alpha * dev;
+    progressRateVar_ += alpha * (dev * dev - progressRateVar_);
+  }
+
+  const auto eta = estimateTimeRemaining();
+  PER_SHARD_STAT_SET(getStats(),
+                     rebuilding_estimated_eta_sec,
+                     shard_,
+                     eta.count() >= 0 ? eta.count() / 1000 : 0);
+}
+
+std::chrono::milliseconds
+ShardRebuilding::estimateTimeRemaining(double num_stddevs) const {
+  if (completed_) {
+    return std::chrono::milliseconds(0);
+  }
+  if (!progressRateValid_ || readingProgress_ < 0) {
+    return std::chrono::milliseconds(-1);
+  }
+  const double rate =
+      progressRate_ - num_stddevs * std::sqrt(std::max(0.0, progressRateVar_));
+  if (rate <= 1e-9) {
+    // Stalled or going backwards; no finite estimate.
+    return std::chrono::milliseconds(-1);
+  }
+  const double remaining_sec = std::max(0.0, 1 - readingProgress_) / rate;
+  return std::chrono::milliseconds(
+      static_cast<int64_t>(std::min(remaining_sec * 1000, 1e15)));
+}
+
+void ShardRebuilding::updateReadRateLimit() {
+  bool throttle = false;
+  if (rebuildingSettings_->rate_limit_while_overloaded != RATE_UNLIMITED) {
+    NodeHealthStatus status = getLocalNodeHealthStatus();
+    throttle = status == NodeHealthStatus::OVERLOADED ||
+        status == NodeHealthStatus::UNHEALTHY;
+    if (throttle != throttledByHealth_) {
+      ld_info("Health monitor reports this node %s, %s rebuilding reads in "
+              "shard %u",
+              toString(status).c_str(),
+              throttle ? "throttling" : "unthrottling",
+              shard_);
+    }
+  }
+  throttledByHealth_ = throttle;
+  readRateLimiter_.update(throttle
+                              ? rebuildingSettings_->rate_limit_while_overloaded
+                              : rebuildingSettings_->rate_limit);
 }
 
 void ShardRebuilding::onReadTaskDone(
+    size_t stream_idx,
     std::vector<std::unique_ptr<ChunkData>> chunks) {
+  ReadStream& stream = readStreams_.at(stream_idx);
+  // Re-check node health first, so that the cost of this read task is
+  // charged at the rate that currently applies.
+  updateReadRateLimit();
   // Report the cost of this read task to rate limiter.
   std::chrono::steady_clock::duration unused;
-  readRateLimiter_.isAllowed(readContext_->bytesRead, &unused);
+  readRateLimiter_.isAllowed(stream.context->bytesRead, &unused);
 
   for (auto& c : chunks) {
     bytesInReadBuffer_ += c->totalBytes();
@@ -179,14 +377,34 @@ void ShardRebuilding::onReadTaskDone(
   readBuffer_.insert(readBuffer_.end(),
                      std::make_move_iterator(chunks.begin()),
                      std::make_move_iterator(chunks.end()));
-  storageTaskInFlight_ = false;
+  if (readStreams_.size() > 1) {
+    // Merge chunks delivered by different streams into roughly the order a
+    // single iterator would produce: metadata/internal logs first, then data
+    // logs by timestamp. Each log is read by exactly one stream, so the
+    // per-log LSN order that the rest of the pipeline relies on is not
+    // affected by the sort (it's stable).
+    std::stable_sort(readBuffer_.begin(),
+                     readBuffer_.end(),
+                     [this](const std::unique_ptr<ChunkData>& a,
+                            const std::unique_ptr<ChunkData>& b) {
+                       bool a_exempt = isLogExemptedFromWindow(a->address.log);
+                       bool b_exempt = isLogExemptedFromWindow(b->address.log);
+                       if (a_exempt || b_exempt) {
+                         return a_exempt && !b_exempt;
+                       }
+                       return direction_.timestampCmp(a->oldestTimestamp,
+                                                      b->oldestTimestamp) < 0;
+                     });
+  }
+  stream.storageTaskInFlight = false;
   ++readTasksDone_;
-  nextLocation_ = readContext_->nextLocation;
-  readingProgressTimestamp_ = readContext_->progressTimestamp;
-  readingProgress_ = readContext_->progress;
-  if (readContext_->iterator != nullptr) {
-    iteratorInvalidationTimer_->activate(getIteratorTTL());
+  stream.nextLocation = stream.context->nextLocation;
+  stream.progressTimestamp = stream.context->progressTimestamp;
+  stream.progress = stream.context->progress;
+  if (stream.context->iterator != nullptr) {
+    stream.iteratorInvalidationTimer->activate(getIteratorTTL());
   }
+  recomputeReadingProgress();
   tryMakeProgress();
 }
 
@@ -197,24 +415,11 @@ void ShardRebuilding::startSomeChunkRebuildingsIfNeeded() {
       rebuildingSettings_->max_record_bytes_in_flight;
   const bool new_to_old = rebuildingSettings_->new_to_old;
 
-  auto is_log_exempted_from_window = [&](logid_t log) {
-    // Don't use timestamp window (both local and global) for metadata/internal
-    // logs. These logs are not stored in partitions and are read in log-by-log
-    // order rather than roughly chronological (partition-by-partition) order,
-    // so timestamp windows make no sense for these logs. The recipient storage
-    // nodes also don't care how spread out the timestamps of these records are,
-    // since they're all going to the same "unpartitioned" column family, unlike
-    // data log records that go to many different partitions.
-    // All metadata/internal logs are read before any data logs.
-    return MetaDataLog::isMetaDataLog(log) ||
-        configuration::InternalLogs::isInternal(log);
-  };
-
   auto record_rebuildings_are_too_spread_out = [&] {
     if (chunkRebuildings_.empty()) {
       return false;
     }
-    if (is_log_exempted_from_window(readBuffer_.front()->address.log)) {
+    if (isLogExemptedFromWindow(readBuffer_.front()->address.log)) {
       return false;
     }
     // How far ahead is the next record in read buffer compared to the ~oldest
@@ -238,7 +443,7 @@ void ShardRebuilding::startSomeChunkRebuildingsIfNeeded() {
          chunkRebuildingRecordsInFlight_ < max_records_in_flight &&
          chunkRebuildingBytesInFlight_ < max_bytes_in_flight &&
          !record_rebuildings_are_too_spread_out()) {
-    if (!is_log_exempted_from_window(readBuffer_.front()->address.log) &&
+    if (!isLogExemptedFromWindow(readBuffer_.front()->address.log) &&
         direction_.timestampCmp(
             readBuffer_.front()->oldestTimestamp, globalWindowEnd_) > 0) {
       // The next record in readBuffer_ is below global window end.
@@ -294,7 +499,7 @@ void ShardRebuilding::startSomeChunkRebuildingsIfNeeded() {
     // If there are some records in flight, use the oldest one.
     const auto& chunk =
         new_to_old ? *chunkRebuildings_.rbegin() : *chunkRebuildings_.begin();
-    if (!is_log_exempted_from_window(chunk.second.address.log)) {
+    if (!isLogExemptedFromWindow(chunk.second.address.log)) {
       progress_timestamp = chunk.first.oldestTimestamp;
     } else {
       // We're still rebuilding internal logs, leave progress_timestamp at
@@ -302,7 +507,7 @@ void ShardRebuilding::startSomeChunkRebuildingsIfNeeded() {
     }
   } else if (!readBuffer_.empty()) {
     // If there are some records in buffer, use the first one.
-    if (!is_log_exempted_from_window(readBuffer_.front()->address.log)) {
+    if (!isLogExemptedFromWindow(readBuffer_.front()->address.log)) {
       progress_timestamp = readBuffer_.front()->oldestTimestamp;
     } else {
       // We're still rebuilding internal/metadata logs. Don't report progress
@@ -376,11 +581,16 @@ void ShardRebuilding::finalizeIfNeeded() {
   // ShardRebuilding indefinitely; usually this happens if our own disk is
   // broken, in which case self-initiated rebuilding will soon request a
   // rebuilding, and this ShardRebuilding will be aborted.
-  if (completed_ || storageTaskInFlight_ || !readContext_->reachedEnd ||
-      readContext_->persistentError || !readBuffer_.empty() ||
+  if (completed_ || readStreams_.empty() || !readBuffer_.empty() ||
       !chunkRebuildings_.empty()) {
     return;
   }
+  for (const ReadStream& stream : readStreams_) {
+    if (stream.storageTaskInFlight || !stream.context->reachedEnd ||
+        stream.context->persistentError) {
+      return;
+    }
+  }
   completed_ = true;
   ld_info("Rebuilt shard %u in %.3fs (%s). Rebuilt %lu chunks, %lu records, "
           "%lu bytes. Executed %lu read storage tasks.",
@@ -410,7 +620,7 @@ void ShardRebuilding::noteConfigurationChanged() {
 }
 
 void ShardRebuilding::noteRebuildingSettingsChanged() {
-  readRateLimiter_.update(rebuildingSettings_->rate_limit);
+  updateReadRateLimit();
   tryMakeProgress();
 }
 
@@ -430,26 +640,52 @@ void ShardRebuilding::getDebugInfo(InfoRebuildingShardsTable& table) const {
   table.set<6>(bytesInReadBuffer_ + chunkRebuildingBytesInFlight_);
   table.set<7>(numLogs_);
   table.set<9>(describeTimeByState());
-  table.set<10>(storageTaskInFlight_);
-  if (!storageTaskInFlight_) {
-    table.set<11>(readContext_->persistentError);
+  const bool task_in_flight = anyStorageTaskInFlight();
+  table.set<10>(task_in_flight);
+  if (!task_in_flight) {
+    table.set<11>(anyStreamPersistentError());
   }
   table.set<12>(bytesInReadBuffer_);
   // TODO (#24665001):
   //   When ChunkRebuilding gets reimplemented to process all records at once,
   //   change this into number of chunks in flight.
   table.set<13>(chunkRebuildingRecordsInFlight_);
-  if (nextLocation_ != nullptr) {
-    table.set<14>(nextLocation_->toString());
+  std::string locations;
+  for (const ReadStream& stream : readStreams_) {
+    if (stream.nextLocation != nullptr) {
+      if (!locations.empty()) {
+        locations += " | ";
+      }
+      locations += stream.nextLocation->toString();
+    }
+  }
+  if (!locations.empty()) {
+    table.set<14>(locations);
   }
   table.set<15>(readingProgress_);
+  const auto eta = estimateTimeRemaining();
+  if (eta.count() >= 0) {
+    table.set<16>(eta);
+    // One-sided 95% upper bound on the ETA, assuming the smoothed rate
+    // estimate is roughly normally distributed.
+    const auto eta_p95 = estimateTimeRemaining(1.65);
+    if (eta_p95.count() >= 0) {
+      table.set<17>(eta_p95);
+    }
+  }
 }
 
 std::function<void(InfoRebuildingLogsTable&)>
 ShardRebuilding::beginGetLogsDebugInfo() const {
-  ld_check(readContext_ != nullptr);
-  return [context = readContext_](InfoRebuildingLogsTable& table) {
-    context->getLogsDebugInfo(table);
+  ld_check(!readStreams_.empty());
+  std::vector<std::shared_ptr<RebuildingReadStorageTask::Context>> contexts;
+  for (const ReadStream& stream : readStreams_) {
+    contexts.push_back(stream.context);
+  }
+  return [contexts](InfoRebuildingLogsTable& table) {
+    for (const auto& context : contexts) {
+      context->getLogsDebugInfo(table);
+    }
   };
 }
 
@@ -502,9 +738,10 @@ void ShardRebuilding::flushCurrentStateTime() {
   }
 }
 void ShardRebuilding::updateProfilingState() {
+  const bool task_in_flight = anyStorageTaskInFlight();
   ProfilingState new_state;
   if (chunkRebuildings_.empty()) {
-    if (storageTaskInFlight_) {
+    if (task_in_flight) {
       new_state = ProfilingState::WAITING_FOR_READ;
     } else if (readBuffer_.empty()) {
       new_state = ProfilingState::RATE_LIMITED;
@@ -512,13 +749,12 @@ void ShardRebuilding::updateProfilingState() {
       new_state = ProfilingState::STALLED;
     }
   } else {
-    new_state = storageTaskInFlight_
-        ? ProfilingState::FULLY_OCCUPIED
-        : ProfilingState::WAITING_FOR_REREPLICATION;
+    new_state = task_in_flight ? ProfilingState::FULLY_OCCUPIED
+                               : ProfilingState::WAITING_FOR_REREPLICATION;
   }
   if (new_state != profilingState_) {
     // Log a message if we started or stopped waiting on global window.
-    if (storageTaskInFlight_ || !readContext_->persistentError) {
+    if (task_in_flight || !anyStreamPersistentError()) {
       if (new_state == ProfilingState::STALLED) {
         PER_SHARD_STAT_SET(
             getStats(), rebuilding_global_window_waiting_flag, shard_, 1);
@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include "logdevice/common/NodeHealthStatus.h"
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/RateLimiter.h"
 #include "logdevice/common/RebuildingTypes.h"
@@ -35,7 +36,8 @@ class ShardRebuilding : public ShardRebuildingInterface {
   void noteConfigurationChanged() override;
   void noteRebuildingSettingsChanged() override;
 
-  void onReadTaskDone(std::vector<std::unique_ptr<ChunkData>> chunks);
+  void onReadTaskDone(size_t stream_idx,
+                      std::vector<std::unique_ptr<ChunkData>> chunks);
   void onChunkRebuildingDone(chunk_rebuilding_id_t chunk_id,
                              RecordTimestamp oldest_timestamp);
 
@@ -56,7 +58,8 @@ class ShardRebuilding : public ShardRebuildingInterface {
   virtual worker_id_t startChunkRebuilding(std::unique_ptr<ChunkData> chunk,
                                            chunk_rebuilding_id_t chunk_id);
   virtual std::chrono::milliseconds getIteratorTTL();
-  virtual void putStorageTask();
+  virtual NodeHealthStatus getLocalNodeHealthStatus();
+  virtual void putStorageTask(size_t stream_idx);
   virtual std::unique_ptr<TimerInterface> createTimer(std::function<void()> cb);
 
  protected:
@@ -94,13 +97,35 @@ class ShardRebuilding : public ShardRebuildingInterface {
 
   RecordTimestamp globalWindowEnd_;
 
-  // There's at most one RebuildingReadStorageTask in flight at any time.
-  bool storageTaskInFlight_ = false;
-  // The reading context is shared between us and the storage task.
-  // When a storage task is in flight, we're not allowed to access the context.
-  std::shared_ptr<RebuildingReadStorageTask::Context> readContext_;
+  // Reading is striped across one or more streams, each with its own
+  // iterator and reading context covering a disjoint subset of the logs
+  // (assigned by hash of log ID). Each stream has at most one
+  // RebuildingReadStorageTask in flight at any time. The number of streams
+  // is controlled by the rebuilding-read-streams setting; usually it's one.
+  struct ReadStream {
+    // The reading context is shared between us and the storage task.
+    // When a storage task is in flight, we're not allowed to access the
+    // context.
+    std::shared_ptr<RebuildingReadStorageTask::Context> context;
+    bool storageTaskInFlight = false;
+    // If the iterator doesn't get seeked for some time, this timer fires and
+    // invalidates it. For rocksdb-based LocalLogStore implementations the
+    // invalidation prevents the iterator from pinning old versions of
+    // data indefinitely.
+    std::unique_ptr<TimerInterface> iteratorInvalidationTimer;
+    // The following are duplicated from `context` to make sure we always
+    // have lock-free access to them.
+    std::shared_ptr<LocalLogStore::AllLogsIterator::Location> nextLocation;
+    RecordTimestamp progressTimestamp;
+    double progress = 0;
+  };
+  std::vector<ReadStream> readStreams_;
 
   RateLimiter readRateLimiter_;
+  // True if readRateLimiter_ currently uses rate_limit_while_overloaded
+  // instead of rate_limit, because the health monitor reports this node
+  // overloaded or unhealthy.
+  bool throttledByHealth_ = false;
   // The timer is used when readRateLimiter_ tells us to wait before reading.
   std::unique_ptr<TimerInterface> delayedReadTimer_;
 
@@ -119,12 +144,6 @@ class ShardRebuilding : public ShardRebuildingInterface {
   size_t chunkRebuildingRecordsInFlight_ = 0;
   size_t chunkRebuildingBytesInFlight_ = 0;
 
-  // If iterator doesn't get seeked for some time, this timer fires and
-  // invalidates it. For rocksdb-based LocalLogStore implementations the
-  // invalidation prevents the iterator from pinning old versions of
-  // data indefinitely.
-  std::unique_ptr<TimerInterface> iteratorInvalidationTimer_;
-
   WorkerCallbackHelper<ShardRebuilding> callbackHelper_;
 
   static std::atomic<chunk_rebuilding_id_t::raw_type> nextChunkID_;
@@ -136,7 +155,25 @@ class ShardRebuilding : public ShardRebuildingInterface {
   void startSomeChunkRebuildingsIfNeeded();
   void finalizeIfNeeded();
 
-  void invalidateIterator();
+  void invalidateIterator(size_t stream_idx);
+
+  // Which read stream reads the given log.
+  size_t mapLogToReadStream(logid_t log) const;
+
+  bool anyStorageTaskInFlight() const;
+  // Only looks at streams with no storage task in flight, since a stream's
+  // context can't be accessed while its task is in flight.
+  bool anyStreamPersistentError() const;
+
+  // Updates readingProgressTimestamp_ and readingProgress_ by aggregating
+  // the per-stream values.
+  void recomputeReadingProgress();
+
+  // Points readRateLimiter_ at either rate_limit or
+  // rate_limit_while_overloaded depending on the node's health status.
+  // Called when settings change and after each completed read task, so
+  // health changes take effect at batch granularity.
+  void updateReadRateLimit();
 
   void tryMakeProgress();
 
@@ -177,10 +214,7 @@ class ShardRebuilding : public ShardRebuildingInterface {
   size_t recordsRebuilt_ = 0;
   size_t bytesRebuilt_ = 0;
   size_t readTasksDone_ = 0;
-  // These are duplicated from readContext_ to make sure we always have
-  // lock-free access to them.
   size_t numLogs_;
-  std::shared_ptr<LocalLogStore::AllLogsIterator::Location> nextLocation_;
   // Calls flushCurrentStateTime() every minute, to make sure we're publishing
   // accurate time spent in each state even when state doesn't change often.
   std::unique_ptr<TimerInterface> profilingTimer_;
@@ -195,6 +229,34 @@ class ShardRebuilding : public ShardRebuildingInterface {
   // we have read. -1 means not supported.
   double readingProgress_ = 0;
 
+  // Stuff below is for estimating when this shard will finish rebuilding.
+
+  // Progress fraction and time at which updateProgressEstimate() last took
+  // a sample.
+  double lastProgressFraction_ = 0;
+  SteadyTimestamp lastProgressSampleTime_ = SteadyTimestamp::min();
+  // Exponentially smoothed rate at which the progress fraction grows
+  // (fraction of the shard per second), and smoothed squared deviation of
+  // the instantaneous rate from it. The deviation turns the point ETA into
+  // a confidence interval: donor throughput varies a lot between partitions
+  // that are cached in memory and ones read cold from disk.
+  double progressRate_ = 0;
+  double progressRateVar_ = 0;
+  bool progressRateValid_ = false;
+
+  // Feeds the current readingProgress_ into the smoothed throughput model
+  // and publishes the resulting ETA stat. Called from the profiling timer
+  // so samples are evenly spaced.
+  void updateProgressEstimate();
+
+  // Estimated time until this shard finishes rebuilding, based on the
+  // smoothed progress rate. `num_stddevs` shifts the assumed rate down by
+  // that many standard deviations, turning the point estimate into the
+  // upper end of a confidence interval. Returns -1ms if no estimate is
+  // available (progress estimation not supported, not enough samples yet,
+  // or rebuilding is stalled).
+  std::chrono::milliseconds estimateTimeRemaining(double num_stddevs = 0) const;
+
   // Advances currentStateStartTime_ to current time, updating totalTimeByState_
   // and stats as needed.
   void flushCurrentStateTime();
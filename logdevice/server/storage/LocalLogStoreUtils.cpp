@@ -10,6 +10,7 @@
 #include "logdevice/common/debug.h"
 #include "logdevice/common/stats/Stats.h"
 #include "logdevice/server/ServerProcessor.h"
+#include "logdevice/server/locallogstore/WriteOps.h"
 #include "logdevice/server/read_path/LogStorageStateMap.h"
 
 namespace facebook { namespace logdevice { namespace LocalLogStoreUtils {
@@ -23,21 +24,39 @@ int updateTrimPoints(const TrimPointUpdateMap& trim_points,
   LogStorageStateMap* state_map =
       processor ? &processor->getLogStorageStateMap() : nullptr;
 
-  for (auto& kv : trim_points) {
-    TrimMetadata metadata{kv.second};
-    int rv = store.updateLogMetadata(kv.first, metadata);
-    if (rv != 0 && err != E::UPTODATE) {
+  if (!trim_points.empty()) {
+    // Write all trim points in one shared batch instead of one
+    // read-modify-write per log. Trim point metadata merges to the maximum
+    // (see detail::useMerge()), so blind batched writes can't move a trim
+    // point backwards even when racing with client trims.
+    std::vector<TrimMetadata> metadata;
+    metadata.reserve(trim_points.size());
+    std::vector<PutLogMetadataWriteOp> write_ops;
+    write_ops.reserve(trim_points.size());
+    for (auto& kv : trim_points) {
+      metadata.emplace_back(TrimMetadata{kv.second});
+      write_ops.emplace_back(
+          kv.first, &metadata.back(), Durability::ASYNC_WRITE);
+    }
+    std::vector<const WriteOp*> op_ptrs;
+    op_ptrs.reserve(write_ops.size());
+    for (const PutLogMetadataWriteOp& op : write_ops) {
+      op_ptrs.push_back(&op);
+    }
+
+    if (store.writeMulti(op_ptrs) != 0) {
       RATELIMIT_ERROR(std::chrono::seconds(1),
                       1,
-                      "Unable to update the trim point in Store metadata "
-                      "for log %lu: %s",
-                      kv.first.val_,
+                      "Unable to update trim points in Store metadata "
+                      "for %lu logs: %s",
+                      trim_points.size(),
                       error_description(err));
       error = E::LOCAL_LOG_STORE_WRITE;
-      continue;
     }
+  }
 
-    if (state_map) {
+  if (error == E::OK && state_map) {
+    for (auto& kv : trim_points) {
       LogStorageState* log_state =
           state_map->insertOrGet(kv.first, store.getShardIdx());
       if (log_state == nullptr) {
@@ -52,7 +71,7 @@ int updateTrimPoints(const TrimPointUpdateMap& trim_points,
       }
 
       // updateTrimPoint will only fail with E::UPTODATE
-      log_state->updateTrimPoint(metadata.trim_point_);
+      log_state->updateTrimPoint(kv.second);
     }
   }
 
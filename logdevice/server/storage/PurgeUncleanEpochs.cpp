@@ -298,11 +298,23 @@ void PurgeUncleanEpochs::onAllEpochMetaDataGotten() {
         } else {
           ld_check(epoch_info_ != nullptr);
           ld_check(!epoch_info_->empty());
-          for (auto it = epoch_info_->lower_bound(first_epoch.val_);
-               it != epoch_info_->end() && it->first <= last_epoch.val_;
-               ++it) {
-            postEpochRecoveryMetadataRequest(
-                epoch_t(it->first), epoch_t(it->first), epochMetadata);
+          // Coalesce runs of consecutive non-empty epochs into a single
+          // request. The protocol and the storage task serving the request
+          // already support epoch ranges; batching avoids sending one
+          // GET_EPOCH_RECOVERY_METADATA message (and running one storage
+          // task on every node in the nodeset) per epoch when a crash
+          // leaves many unclean epochs behind.
+          auto it = epoch_info_->lower_bound(first_epoch.val_);
+          while (it != epoch_info_->end() && it->first <= last_epoch.val_) {
+            const epoch_t run_start = epoch_t(it->first);
+            epoch_t run_end = run_start;
+            ++it;
+            while (it != epoch_info_->end() && it->first <= last_epoch.val_ &&
+                   epoch_t(it->first) == epoch_t(run_end.val_ + 1)) {
+              run_end = epoch_t(it->first);
+              ++it;
+            }
+            postEpochRecoveryMetadataRequest(run_start, run_end, epochMetadata);
           }
         }
       }
@@ -14,6 +14,7 @@
 #include "logdevice/common/Timestamp.h"
 #include "logdevice/common/stats/PerShardHistograms.h"
 #include "logdevice/common/stats/Stats.h"
+#include "logdevice/common/util.h"
 #include "logdevice/server/ServerProcessor.h"
 #include "logdevice/server/locallogstore/LocalLogStore.h"
 #include "logdevice/server/storage_tasks/StorageTask.h"
@@ -33,6 +34,16 @@ void ExecStorageThread::run() {
     set_io_priority_of_this_thread(settings->slow_ioprio.value());
   }
 
+  // Pin this thread to its shard's CPU set if one was configured, to keep
+  // the shard's storage threads on the NUMA node that holds its memory.
+  if (settings->storage_pool_cpu_affinity.has_value()) {
+    const auto& affinity = settings->storage_pool_cpu_affinity.value();
+    auto it = affinity.find(pool_->getShardIdx());
+    if (it != affinity.end()) {
+      set_cpu_affinity_of_this_thread(it->second);
+    }
+  }
+
   SlowStorageTasksTracer slow_task_tracer{pool_->getTraceLogger()};
 
   while (shouldProcessTasks_) {
@@ -55,8 +66,26 @@ void ExecStorageThread::run() {
     }
 
     auto execution_start_time = std::chrono::steady_clock::now();
+
+    // Deadline-expiry sweep: if the task's deadline passed while it was
+    // queued, its result is no longer wanted and executing it would be
+    // wasted disk work. Send it back through the dropped path so the worker
+    // can clean up (and reissue if the consumer is still around).
+    if (task->isDroppable() && task->deadlineExpired(execution_start_time)) {
+      STORAGE_TASK_TYPE_STAT_INCR(
+          pool_->stats(), task->getType(), storage_tasks_deadline_expired);
+      StorageTaskResponse::sendDroppedToWorker(std::move(task));
+      continue;
+    }
+
     task->execute();
     auto execution_end_time = std::chrono::steady_clock::now();
+    // Stash the timestamps on the task so the worker can compute the
+    // time-in-queue when the reply comes back (see
+    // PerWorkerStorageTaskQueue::onReply()) and "info storage_tasks" can
+    // report them.
+    task->execution_start_time_ = execution_start_time;
+    task->execution_end_time_ = execution_end_time;
     auto usec = SystemTimestamp(execution_end_time - execution_start_time)
                     .toMicroseconds()
                     .count();
@@ -100,6 +129,23 @@ void ExecStorageThread::run() {
        task->bytesProcessed(0);
     */
 
+    if (task->requeueRequested()) {
+      // The task yielded mid-operation (see MultiStepStorageTask): put it
+      // back on this pool's queue so its next slice runs on a storage thread
+      // directly, skipping the round trip through the worker.
+      ld_check(task->durability() != Durability::SYNC_WRITE);
+      task->enqueue_time_ = std::chrono::steady_clock::now();
+      STORAGE_TASK_TYPE_STAT_INCR(
+          pool_->stats(), task->getType(), storage_tasks_yielded);
+      if (pool_->tryPutTask(std::move(task)) != 0) {
+        // Queue full or shutting down; the operation can't make progress.
+        // tryPutTask() left ownership with us, send the task back through
+        // the dropped path so the worker can clean up.
+        StorageTaskResponse::sendDroppedToWorker(std::move(task));
+      }
+      continue;
+    }
+
     if (task->durability() == Durability::SYNC_WRITE) {
       pool_->enqueueForSync(std::move(task));
     } else {
@@ -0,0 +1,36 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/storage_tasks/MultiStepStorageTask.h"
+
+namespace facebook { namespace logdevice {
+
+void MultiStepStorageTask::execute() {
+  yield_requested_ = false;
+  const size_t max_steps = maxStepsPerSlice();
+  ld_check(max_steps > 0);
+
+  for (size_t steps_run = 0;;) {
+    switch (step()) {
+      case StepResult::DONE:
+        return;
+      case StepResult::CONTINUE:
+        if (++steps_run < max_steps) {
+          break;
+        }
+        // Ran a full slice without yielding; force one so other queued
+        // tasks get a chance to run on this thread.
+        yield_requested_ = true;
+        return;
+      case StepResult::YIELD:
+        yield_requested_ = true;
+        return;
+    }
+  }
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,85 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include "logdevice/server/storage_tasks/StorageTask.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Base class for storage tasks that consist of several sequential
+ * steps against the local log store, e.g. a lookup whose second read depends
+ * on the first one's result.
+ *
+ * Historically such operations were written as chains of single-step tasks:
+ * after each step the task travelled back to the worker thread, which looked
+ * at the result and put a new task on the PerWorkerStorageTaskQueue. Every
+ * step paid two cross-thread hops plus storage task queueing latency.
+ * Subclasses of this class instead express the operation as a sequence of
+ * step() calls; control stays on the storage thread between steps, and the
+ * task goes back to the worker only once, when the whole operation is done
+ * (or dropped).
+ *
+ * A step may also yield, which re-enqueues the task at the back of the
+ * storage thread pool's own queue (see ExecStorageThread::run()): the next
+ * step still doesn't involve the worker, but other queued tasks get to run
+ * in between. Long operations should yield periodically for fairness; as a
+ * backstop, execute() forces a yield after maxStepsPerSlice() consecutive
+ * steps.
+ */
+
+class MultiStepStorageTask : public StorageTask {
+ public:
+  enum class StepResult {
+    // The operation finished (successfully or not); pass the task back to
+    // the worker thread, which will invoke onDone().
+    DONE,
+    // Run the next step right away, on this storage thread.
+    CONTINUE,
+    // Re-enqueue the task on the storage thread pool; the next step runs
+    // on a storage thread once the task is dequeued again.
+    YIELD,
+  };
+
+  explicit MultiStepStorageTask(Type type) : StorageTask(type) {}
+
+  /**
+   * Runs step() until the operation completes or yields. Final; subclasses
+   * implement step() instead.
+   */
+  void execute() final;
+
+  /**
+   * One step of the operation. Runs on a storage thread; may block on IO.
+   * Intermediate state lives in the subclass, which outlives all steps.
+   */
+  virtual StepResult step() = 0;
+
+  /**
+   * How many consecutive steps execute() may run before forcing a yield, so
+   * that one multi-step task can't monopolize a storage thread. Subclasses
+   * with unusually cheap or expensive steps can override.
+   */
+  virtual size_t maxStepsPerSlice() const {
+    return 16;
+  }
+
+  /**
+   * True if the last execute() slice ended in a yield rather than
+   * completion. Checked by ExecStorageThread to decide whether to re-enqueue
+   * the task or send it back to the worker.
+   */
+  bool requeueRequested() const override {
+    return yield_requested_;
+  }
+
+ private:
+  bool yield_requested_ = false;
+};
+
+}} // namespace facebook::logdevice
@@ -175,6 +175,13 @@ void PerWorkerStorageTaskQueue::onReply(const StorageTask& task) {
   // we expect two replies per write, each releasing one inflight slot.
   --taskBuffer_[(int)type].tasks_in_flight;
 
+  if (task.execution_start_time_.has_value()) {
+    noteTaskSojournTime(
+        type,
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            task.execution_start_time_.value() - task.enqueue_time_));
+  }
+
   auto check_queue = [=](std::queue<std::unique_ptr<StorageTask>>& queue) {
     while (!queue.empty() && canSendToStorageThread(*queue.front())) {
       sendTaskToStorageThread(std::move(queue.front()));
@@ -186,27 +193,67 @@ void PerWorkerStorageTaskQueue::onReply(const StorageTask& task) {
   check_queue(taskBuffer_[(int)type].normal);
 }
 
-bool PerWorkerStorageTaskQueue::isOverloaded() const {
+void PerWorkerStorageTaskQueue::noteTaskSojournTime(
+    StorageTask::ThreadType thread_type,
+    std::chrono::microseconds sojourn) {
+  const auto threshold =
+      Worker::settings().storage_queue_sojourn_overload_threshold;
+  if (threshold.count() <= 0) {
+    return;
+  }
+  auto& buffer = taskBuffer_[(int)thread_type];
+  // Decayed average with a weight of 1/8 per observation: smooth enough not
+  // to flap on a single slow pickup, while a genuinely backed up queue moves
+  // it past the threshold within a couple dozen replies.
+  buffer.sojourn_avg_usec += (sojourn.count() - buffer.sojourn_avg_usec) / 8;
+
+  const double threshold_usec =
+      std::chrono::duration_cast<std::chrono::microseconds>(threshold).count();
+  if (!buffer.sojourn_overloaded) {
+    if (buffer.sojourn_avg_usec > threshold_usec) {
+      buffer.sojourn_overloaded = true;
+      WORKER_STORAGE_TASK_STAT_INCR(
+          thread_type, storage_task_queue_sojourn_overloads);
+      RATELIMIT_INFO(std::chrono::seconds(10),
+                     2,
+                     "Storage task queue for shard %d (%s threads) is "
+                     "overloaded: tasks spend %.0fms in queue on average",
+                     shard_idx_,
+                     storageTaskThreadTypeName(thread_type),
+                     buffer.sojourn_avg_usec / 1000);
+    }
+  } else if (2 * buffer.sojourn_avg_usec < threshold_usec) {
+    buffer.sojourn_overloaded = false;
+  }
+}
+
+bool PerWorkerStorageTaskQueue::isOverloaded(
+    StorageTask::ThreadType thread_type) const {
+  auto& buffer = taskBuffer_[(int)thread_type];
+
+  auto elapsed = std::chrono::steady_clock::now() - buffer.last_queue_drop_time;
+  if (std::chrono::duration_cast<std::chrono::milliseconds>(elapsed) <=
+      Worker::settings().queue_drop_overload_time) {
+    return true; // the queue was dropped very recently
+  }
+
+  if (Worker::settings().storage_queue_sojourn_overload_threshold.count() > 0) {
+    // Overload is judged by how long tasks sit in the queue rather than by
+    // how many of them there are: time-in-queue tracks the latency that
+    // upstream components actually suffer and does not need per-fleet tuning
+    // of queue depths for heterogeneous disks.
+    return buffer.sojourn_overloaded;
+  }
+
   int64_t p = Worker::settings().queue_size_overload_percentage;
-  // Since the overloaded status is only used on the append path to determine
-  // viable candidate nodes, only consider the buffer consumed by "fast" storage
-  // threads (those writing records from Appenders) here. In the future we may
-  // also want to expose the state of the read path.
-  auto& buffer = taskBuffer_[(int)StorageTask::ThreadType::FAST_TIME_SENSITIVE];
   double mem_budget_used =
       ServerWorker::onThisThread()
           ->processor_->sharded_storage_thread_pool_->getByIndex(shard_idx_)
-          .getMemoryBudget(StorageTask::ThreadType::FAST_TIME_SENSITIVE)
+          .getMemoryBudget(thread_type)
           .fractionUsed();
 
-  if (100 * buffer.size() > p * max_buffered_tasks_ ||
-      100 * mem_budget_used > p) {
-    return true; // too many buffered tasks
-  }
-
-  auto elapsed = std::chrono::steady_clock::now() - buffer.last_queue_drop_time;
-  return std::chrono::duration_cast<std::chrono::milliseconds>(elapsed) <=
-      Worker::settings().queue_drop_overload_time;
+  return 100 * buffer.size() > p * max_buffered_tasks_ ||
+      100 * mem_budget_used > p; // too many buffered tasks
 }
 
 bool PerWorkerStorageTaskQueue::canSendToStorageThread(
@@ -79,8 +79,16 @@ class PerWorkerStorageTaskQueue {
 
   /**
    * Check if this queue is taking too much work.
+   *
+   * If --storage-queue-sojourn-overload-threshold is set, the answer is based
+   * on how long tasks of the given thread type have recently been sitting in
+   * the queue before a storage thread picked them up (see
+   * noteTaskSojournTime()).  Otherwise it falls back to the static
+   * queue-length and memory-budget thresholds
+   * (--queue-size-overload-percentage).
    */
-  bool isOverloaded() const;
+  bool isOverloaded(StorageTask::ThreadType thread_type =
+                        StorageTask::ThreadType::FAST_TIME_SENSITIVE) const;
 
  private:
   // Index in worker's storage_task_queues_ vector, used to send requests to
@@ -107,6 +115,15 @@ class PerWorkerStorageTaskQueue {
   // StorageThreadPool corresponding to shard_idx_ to drop tasks as well.
   void onBufferFull(StorageTask::ThreadType thread_type);
 
+  // Called from onReply() with the time the task spent queued before a
+  // storage thread picked it up.  Maintains a decayed average of the sojourn
+  // time per thread type and flips the overload state with hysteresis:
+  // entered when the average exceeds
+  // --storage-queue-sojourn-overload-threshold, left once it falls below half
+  // of it.  No-op when the setting is zero.
+  void noteTaskSojournTime(StorageTask::ThreadType thread_type,
+                           std::chrono::microseconds sojourn);
+
   const size_t max_tasks_in_flight_;
   const size_t max_buffered_tasks_;
 
@@ -126,6 +143,16 @@ class PerWorkerStorageTaskQueue {
 
     // last time drop() was called
     std::chrono::steady_clock::time_point last_queue_drop_time{};
+
+    // Exponentially decayed average of how long tasks of this thread type
+    // spent queued before a storage thread picked them up, in usec.
+    // Maintained by noteTaskSojournTime().
+    double sojourn_avg_usec{0};
+
+    // True while sojourn_avg_usec is above
+    // --storage-queue-sojourn-overload-threshold; cleared once it drops
+    // below half the threshold.
+    bool sojourn_overloaded{false};
   } taskBuffer_[(int)StorageTask::ThreadType::MAX];
 };
 }} // namespace facebook::logdevice
@@ -8,10 +8,12 @@
 #define __STDC_FORMAT_MACROS // pull in PRId64 etc
 #include "logdevice/server/storage_tasks/ReadStorageTask.h"
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
 
 #include <folly/Memory.h>
+#include <folly/io/IOBuf.h>
 #include <folly/synchronization/Baton.h>
 
 #include "logdevice/common/AdminCommandTable.h"
@@ -79,6 +81,8 @@ ReadStorageTask::ReadStorageTask(
   auto stream_ptr = stream_.get().get();
   ld_check(stream_ptr);
 
+  stream_filter_version_ = stream_ptr->shared_filter_version_;
+
   // saving debug info
   stream_id_ = stream_ptr->id_;
   client_id_ = stream_ptr->client_id_;
@@ -127,31 +131,63 @@ void ReadStorageTask::execute() {
       auto& io_fault_injection = IOFaultInjection::instance();
       baton.try_wait_for(io_fault_injection.getLatencyToInject(stream_shard_));
     }
-    owned_iterator_ = iterator_from_cache_.lock();
-    if (!owned_iterator_) {
-      // Either the iterator wasn't passed in by CatchupOneStream because it
-      // wasn't found in the cache, or the iterator has since then been
-      // invalidated because its ttl expired.
-      // Create a new iterator that will later be handed over to
-      // CatchupOneStream.
-      owned_iterator_ = storageThreadPool_->getLocalLogStore().read(
-          read_ctx_.logid_, options_);
-    }
+    StorageThreadCallback callback;
+    const LocalLogStore& store = storageThreadPool_->getLocalLogStore();
+    const size_t max_point_lookup_span =
+        storageThreadPool_->getSettings()->read_point_lookups_max_lsn_span;
+    const lsn_t through =
+        std::min(std::min(read_ctx_.until_lsn_, read_ctx_.last_released_lsn_),
+                 read_ctx_.window_high_);
+    if (max_point_lookup_span > 0 && read_ctx_.read_ptr_.lsn <= through &&
+        through - read_ctx_.read_ptr_.lsn < max_point_lookup_span &&
+        !store.isUnderReplicated()) {
+      // The batch spans few enough LSNs that looking each of them up
+      // individually is cheaper than seeking an iterator, which reads (and
+      // possibly decompresses) whole blocks. Typical for re-reads of a short
+      // range near the tail, e.g. after a gap or a record cache miss.
+      // owned_iterator_ stays nullptr; CatchupOneStream tolerates that.
+      // Not usable while the store may be missing records: a point lookup
+      // can't tell a clean miss from a lost copy, while iterators report
+      // under-replicated regions they pass through.
+      status_ = LocalLogStoreReader::readPointLookups(
+          store, callback, &read_ctx_, storageThreadPool_->stats());
+    } else {
+      owned_iterator_ = iterator_from_cache_.lock();
+      if (!owned_iterator_) {
+        // Either the iterator wasn't passed in by CatchupOneStream because it
+        // wasn't found in the cache, or the iterator has since then been
+        // invalidated because its ttl expired.
+        // Create a new iterator that will later be handed over to
+        // CatchupOneStream.
+        owned_iterator_ = storageThreadPool_->getLocalLogStore().read(
+            read_ctx_.logid_, options_);
+      }
 
-    ld_check(owned_iterator_);
+      ld_check(owned_iterator_);
 
-    StorageThreadCallback callback;
-    Status status =
-        LocalLogStoreReader::read(*owned_iterator_,
-                                  callback,
-                                  &read_ctx_,
-                                  storageThreadPool_->stats(),
-                                  *storageThreadPool_->getSettings().get());
-
-    // The `read()` call populated `callback` with some records.  Now move them
+      // Cooperative cancellation: abandon the batch mid-read if the stream was
+      // destroyed (client disconnected, reader stopped) or rewound (filter
+      // version bumped) while we are reading. WeakRef's operator bool() and
+      // the filter version mirror are both safe to access from this thread.
+      // In either case the worker side discards the task's results, so any
+      // further disk work would be wasted.
+      read_ctx_.is_cancelled_ = [this] {
+        return !stream_.getFromAnyThread() ||
+            stream_filter_version_->load(std::memory_order_relaxed) !=
+            filter_version_.val();
+      };
+
+      status_ =
+          LocalLogStoreReader::read(*owned_iterator_,
+                                    callback,
+                                    &read_ctx_,
+                                    storageThreadPool_->stats(),
+                                    *storageThreadPool_->getSettings().get());
+    }
+
+    // The read call populated `callback` with some records.  Now move them
     // into the ReadStorageTask instance, which will get passed back to the
     // worker.
-    status_ = status;
     records_ = std::move(callback.releaseRecords());
 
     total_bytes_ = callback.totalBytes();
@@ -226,21 +262,17 @@ void ReadStorageTask::getDebugInfoDetailed(StorageTaskDebugInfo& info) const {
 
 int StorageThreadCallback::processRecord(const RawRecord& record) {
   // When doing local log store reads on a storage thread, we need to copy the
-  // data out of the local log store into a malloc'd buffer, since records
-  // will only get passed to the messaging layer at some later time (when the
-  // worker thread gets around to processing the ReadStorageTask result).
-  void* blob_copy = malloc(record.blob.size);
-  if (blob_copy == nullptr) {
-    throw std::bad_alloc();
-  }
-  memcpy(blob_copy, record.blob.data, record.blob.size);
+  // data out of the local log store, since records will only get passed to
+  // the messaging layer at some later time (when the worker thread gets
+  // around to processing the ReadStorageTask result).  The copy goes into a
+  // refcounted IOBuf so that RECORD messages can reference the payload from
+  // it instead of copying it a second time.
+  folly::IOBuf blob_copy(
+      folly::IOBuf::COPY_BUFFER, record.blob.data, record.blob.size);
   total_bytes_ += record.blob.size;
 
   records_.emplace_back( // creating a RawRecord
-      record.lsn,
-      Slice(blob_copy, record.blob.size),
-      /*owned*/ true, // We malloc-d the memory
-      record.from_under_replicated_region);
+      record.lsn, std::move(blob_copy), record.from_under_replicated_region);
   return 0;
 }
 }} // namespace facebook::logdevice
@@ -141,6 +141,11 @@ class ReadStorageTask : public StorageTask {
  private:
   void getDebugInfoDetailed(StorageTaskDebugInfo&) const override;
 
+  // Mirror of the stream's filter version, readable from storage threads.
+  // Compared against filter_version_ between iterator steps so the read is
+  // abandoned early if the stream rewinds while this task is in flight.
+  std::shared_ptr<const std::atomic<uint64_t>> stream_filter_version_;
+
   // The following fields store some information about the read stream for debug
   // output
   read_stream_id_t stream_id_;
@@ -20,10 +20,7 @@
 
 namespace facebook { namespace logdevice {
 
-void RecoverSealTask::execute() {
-  SealMetadata seal_metadata;
-  SoftSealMetadata softseal_metadata;
-
+MultiStepStorageTask::StepResult RecoverSealTask::step() {
   auto read_seal_metadata = [&, this](SealMetadata& metadata) {
     int rv = storageThreadPool_->getLocalLogStore().readLogMetadata(
         log_id_, &metadata);
@@ -42,17 +39,31 @@ void RecoverSealTask::execute() {
     return 0;
   };
 
-  status_ = E::OK;
-
-  if (read_seal_metadata(seal_metadata) == 0 &&
-      read_seal_metadata(softseal_metadata) == 0) {
-    ld_check(status_ == E::OK);
-    // if NOTFOUND, use the default initialized seal in metadata
-    seals_.setSeal(LogStorageState::SealType::NORMAL, seal_metadata.seal_);
-    seals_.setSeal(LogStorageState::SealType::SOFT, softseal_metadata.seal_);
-  } else {
-    // there must be some error
-    ld_check(status_ != E::OK);
+  switch (next_step_++) {
+    case 0: {
+      status_ = E::OK;
+      SealMetadata seal_metadata;
+      if (read_seal_metadata(seal_metadata) != 0) {
+        ld_check(status_ != E::OK);
+        return StepResult::DONE;
+      }
+      // if NOTFOUND, use the default initialized seal in metadata
+      seals_.setSeal(LogStorageState::SealType::NORMAL, seal_metadata.seal_);
+      return StepResult::CONTINUE;
+    }
+    case 1: {
+      SoftSealMetadata softseal_metadata;
+      if (read_seal_metadata(softseal_metadata) != 0) {
+        ld_check(status_ != E::OK);
+        return StepResult::DONE;
+      }
+      seals_.setSeal(LogStorageState::SealType::SOFT, softseal_metadata.seal_);
+      ld_check(status_ == E::OK);
+      return StepResult::DONE;
+    }
+    default:
+      ld_check(false);
+      return StepResult::DONE;
   }
 }
 
@@ -11,26 +11,27 @@
 #include "logdevice/common/types_internal.h"
 #include "logdevice/include/Err.h"
 #include "logdevice/server/read_path/LogStorageState.h"
-#include "logdevice/server/storage_tasks/StorageTask.h"
+#include "logdevice/server/storage_tasks/MultiStepStorageTask.h"
 
 namespace facebook { namespace logdevice {
 
 /**
- * @file Task used to read the seal record from the local log store. After
- *       completion, registered callback will be called on a worker
- *       thread which enqueued this task.
+ * @file Task used to read the seal and soft seal records from the local log
+ *       store, one read per MultiStepStorageTask step. After completion,
+ *       registered callback will be called on a worker thread which enqueued
+ *       this task.
  */
 
-class RecoverSealTask : public StorageTask {
+class RecoverSealTask : public MultiStepStorageTask {
  public:
   explicit RecoverSealTask(logid_t log_id,
                            LogStorageState::seal_callback_t callback)
-      : StorageTask(StorageTask::Type::RECOVER_SEAL),
+      : MultiStepStorageTask(StorageTask::Type::RECOVER_SEAL),
         log_id_(log_id),
         callback_(callback),
         status_(E::OK) {}
 
-  void execute() override;
+  StepResult step() override;
   void onDone() override;
   void onDropped() override;
 
@@ -44,6 +45,10 @@ class RecoverSealTask : public StorageTask {
   Status status_ = E::INTERNAL;
   LogStorageState::Seals seals_;
 
+  // Which step() invocation comes next: 0 reads the normal seal, 1 the soft
+  // seal.
+  size_t next_step_ = 0;
+
   void invokeCallback();
 };
 }} // namespace facebook::logdevice
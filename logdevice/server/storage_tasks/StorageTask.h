@@ -179,6 +179,16 @@ class StorageTask {
    */
   virtual void onStorageThreadDrop() {}
 
+  /**
+   * Called by ExecStorageThread after execute(). If true, the task is put
+   * back on the storage thread pool's queue instead of being sent back to
+   * the worker, so its next execution slice runs on a storage thread without
+   * a worker round trip. See MultiStepStorageTask.
+   */
+  virtual bool requeueRequested() const {
+    return false;
+  }
+
   /**
    * Called by StorageThreadPool as soon as the task gets handed to the
    * storage thread pool to provide tasks access to the local log store etc.
@@ -248,6 +258,17 @@ class StorageTask {
   // Used to maintain histograms of queueing time of storage tasks.
   std::chrono::steady_clock::time_point enqueue_time_;
 
+  // Optional deadline after which executing this task is pointless, e.g.
+  // because the worker-side consumer of the result will have given up by
+  // then. ExecStorageThread skips execution of droppable tasks whose
+  // deadline expired while they were queued and sends them back through the
+  // dropped path.
+  folly::Optional<std::chrono::steady_clock::time_point> deadline_;
+
+  bool deadlineExpired(std::chrono::steady_clock::time_point now) const {
+    return deadline_.has_value() && now > deadline_.value();
+  }
+
   // Time this task execution was started
   folly::Optional<std::chrono::steady_clock::time_point> execution_start_time_;
   // Time this task execution was finished
@@ -15,6 +15,36 @@
 
 namespace facebook { namespace logdevice {
 
+namespace {
+int8_t executorPriorityForThreadType(StorageTaskThreadType thread_type) {
+  switch (thread_type) {
+    case StorageTaskThreadType::FAST_TIME_SENSITIVE:
+      return folly::Executor::HI_PRI;
+    case StorageTaskThreadType::DEFAULT:
+      return folly::Executor::MID_PRI;
+    case StorageTaskThreadType::SLOW:
+    case StorageTaskThreadType::FAST_STALLABLE:
+      return folly::Executor::LO_PRI;
+    default:
+      ld_check(false);
+  }
+  return folly::Executor::LO_PRI;
+}
+
+// Completes one task on its worker thread; shared by StorageTaskResponse
+// and StorageTaskBatchResponse.
+void completeTaskOnWorker(ServerWorker* worker, StorageTask& task) {
+  worker->getStorageTaskQueueForShard(task.reply_shard_idx_)->onReply(task);
+
+  if (task.dropped_from_storage_thread_queue_) {
+    WORKER_STORAGE_TASK_STAT_INCR(task.getThreadType(), storage_tasks_dropped);
+    task.onDropped();
+  } else {
+    task.onDone();
+  }
+}
+} // namespace
+
 void StorageTaskResponse::sendBackToWorker(std::unique_ptr<StorageTask> task) {
   auto executor = task->reply_executor_;
   if (!executor) {
@@ -58,33 +88,12 @@ void StorageTaskResponse::sendDroppedToWorker(
 }
 
 Request::Execution StorageTaskResponse::execute() {
-  ServerWorker* worker = ServerWorker::onThisThread();
-  worker->getStorageTaskQueueForShard(task_->reply_shard_idx_)->onReply(*task_);
-
-  if (task_->dropped_from_storage_thread_queue_) {
-    WORKER_STORAGE_TASK_STAT_INCR(
-        task_->getThreadType(), storage_tasks_dropped);
-    task_->onDropped();
-  } else {
-    task_->onDone();
-  }
-
+  completeTaskOnWorker(ServerWorker::onThisThread(), *task_);
   return Execution::COMPLETE;
 }
 
 int8_t StorageTaskResponse::getExecutorPriority() const {
-  switch (task_->getThreadType()) {
-    case StorageTaskThreadType::FAST_TIME_SENSITIVE:
-      return folly::Executor::HI_PRI;
-    case StorageTaskThreadType::DEFAULT:
-      return folly::Executor::MID_PRI;
-    case StorageTaskThreadType::SLOW:
-    case StorageTaskThreadType::FAST_STALLABLE:
-      return folly::Executor::LO_PRI;
-    default:
-      ld_check(false);
-  }
-  return folly::Executor::LO_PRI;
+  return executorPriorityForThreadType(task_->getThreadType());
 }
 
 std::string StorageTaskResponse::describe() const {
@@ -92,4 +101,87 @@ std::string StorageTaskResponse::describe() const {
       storageTaskTypeNames[task_->getType()] + ")";
 }
 
+Request::Execution StorageTaskBatchResponse::execute() {
+  ServerWorker* worker = ServerWorker::onThisThread();
+  for (auto& task : tasks_) {
+    completeTaskOnWorker(worker, *task);
+  }
+  return Execution::COMPLETE;
+}
+
+int8_t StorageTaskBatchResponse::getExecutorPriority() const {
+  // Batches are formed from one completion-queue drain, so the tasks all
+  // came off the same thread type's queue.
+  return executorPriorityForThreadType(tasks_[0]->getThreadType());
+}
+
+std::string StorageTaskBatchResponse::describe() const {
+  return requestTypeNames[type_] + "(" +
+      storageTaskTypeNames[tasks_[0]->getType()] + " x " +
+      std::to_string(tasks_.size()) + ")";
+}
+
+StorageTaskResponseBatcher::~StorageTaskResponseBatcher() {
+  flush();
+}
+
+void StorageTaskResponseBatcher::sendBackToWorker(
+    std::unique_ptr<StorageTask> task) {
+  if (task->reply_executor_ == nullptr ||
+      task->reply_worker_idx_ == WORKER_ID_INVALID) {
+    // Completed directly or not replied to at all; there's no cross-thread
+    // post to save.
+    StorageTaskResponse::sendBackToWorker(std::move(task));
+    return;
+  }
+  pending_[task->reply_executor_].push_back(std::move(task));
+}
+
+void StorageTaskResponseBatcher::sendDroppedToWorker(
+    std::unique_ptr<StorageTask> task) {
+  task->dropped_from_storage_thread_queue_ = true;
+  task->onStorageThreadDrop();
+  sendBackToWorker(std::move(task));
+}
+
+void StorageTaskResponseBatcher::flush() {
+  for (auto& kv : pending_) {
+    post(std::move(kv.second));
+  }
+  pending_.clear();
+}
+
+void StorageTaskResponseBatcher::post(
+    StorageTaskBatchResponse::TaskList tasks) {
+  ld_check(!tasks.empty());
+  if (tasks.size() == 1) {
+    // A batch of one saves no wakeup; post the plain response.
+    StorageTaskResponse::sendBackToWorker(std::move(tasks[0]));
+    return;
+  }
+
+  folly::Executor* executor = tasks[0]->reply_executor_;
+  auto stats = tasks[0]->stats_;
+  auto worker_idx = tasks[0]->reply_worker_idx_;
+  STAT_ADD(stats, storage_task_responses_batched, tasks.size());
+
+  std::unique_ptr<Request> req =
+      std::make_unique<StorageTaskBatchResponse>(std::move(tasks));
+  auto req_type = req->type_;
+  auto worker_type = req->getWorkerTypeAffinity();
+
+  req->enqueue_time_ = std::chrono::steady_clock::now();
+  auto w = dynamic_cast<Worker*>(executor);
+  if (w) {
+    int rv = w->forcePost(req);
+    ld_check(rv == 0);
+  } else {
+    auto priority = req->getExecutorPriority();
+    executor->addWithPriority(
+        [rq = std::move(req)] { rq->execute(); }, priority);
+  }
+
+  Request::bumpStatsWhenPosted(stats, req_type, worker_type, worker_idx, true);
+}
+
 }} // namespace facebook::logdevice
@@ -9,6 +9,9 @@
 
 #include <memory>
 
+#include <folly/container/F14Map.h>
+#include <folly/small_vector.h>
+
 #include "logdevice/common/Request.h"
 #include "logdevice/common/RequestType.h"
 #include "logdevice/server/storage_tasks/StorageTask.h"
@@ -16,8 +19,10 @@
 namespace facebook { namespace logdevice {
 
 /**
- * @file Storage threads create this Request to let the worker thread know
- *       when the StorageTask has finished processing.
+ * @file Storage threads create these Requests to let the worker thread know
+ *       when StorageTasks have finished processing: StorageTaskResponse
+ *       carries a single task, StorageTaskBatchResponse all tasks of one
+ *       completion batch headed to the same Worker.
  */
 
 class StorageTaskResponse : public Request {
@@ -50,4 +55,80 @@ class StorageTaskResponse : public Request {
  private:
   std::unique_ptr<StorageTask> task_;
 };
+
+/**
+ * A vectored StorageTaskResponse: carries every task of one completion batch
+ * that is destined for the same Worker, completed in a tight loop on the
+ * worker thread. Posting the group as one Request costs one cross-thread
+ * wakeup instead of one per task.
+ */
+class StorageTaskBatchResponse : public Request {
+ public:
+  using TaskList = folly::small_vector<std::unique_ptr<StorageTask>, 4>;
+
+  explicit StorageTaskBatchResponse(TaskList tasks)
+      : Request(RequestType::STORAGE_TASK_BATCH_RESPONSE),
+        tasks_(std::move(tasks)) {
+    ld_check(!tasks_.empty());
+  }
+
+  Execution execute() override;
+
+  RunContext getRunContext() const override {
+    return RunContext(tasks_[0]->getType());
+  }
+
+  int8_t getExecutorPriority() const override;
+
+  std::string describe() const override;
+
+ private:
+  TaskList tasks_;
+};
+
+/**
+ * Accumulates completed StorageTasks per destination Worker for the duration
+ * of one completion-queue drain (a write batch or a WAL sync group) and
+ * posts each Worker's share as a single StorageTaskBatchResponse, mimicking
+ * how an io_uring completion queue delivers many completions per wakeup.
+ * Cross-thread posts are a significant slice of storage node kernel time,
+ * and a batch of writes otherwise wakes each Worker once per task.
+ *
+ * Tasks without a reply executor or worker are handled exactly as by
+ * StorageTaskResponse. Any tasks still pending are flushed on destruction.
+ * Not thread-safe; meant to live on a storage thread's stack.
+ */
+class StorageTaskResponseBatcher {
+ public:
+  StorageTaskResponseBatcher() {}
+  ~StorageTaskResponseBatcher();
+
+  StorageTaskResponseBatcher(const StorageTaskResponseBatcher&) = delete;
+  StorageTaskResponseBatcher& operator=(const StorageTaskResponseBatcher&) =
+      delete;
+
+  /**
+   * Same contract as StorageTaskResponse::sendBackToWorker(), but the post
+   * to the Worker may be deferred until flush().
+   */
+  void sendBackToWorker(std::unique_ptr<StorageTask> task);
+
+  /**
+   * Same contract as StorageTaskResponse::sendDroppedToWorker(), but the
+   * post to the Worker may be deferred until flush().
+   */
+  void sendDroppedToWorker(std::unique_ptr<StorageTask> task);
+
+  /**
+   * Posts all pending responses now, one batch per Worker.
+   */
+  void flush();
+
+ private:
+  void post(StorageTaskBatchResponse::TaskList tasks);
+
+  // Completions grouped by destination worker, in completion order.
+  folly::F14FastMap<folly::Executor*, StorageTaskBatchResponse::TaskList>
+      pending_;
+};
 }} // namespace facebook::logdevice
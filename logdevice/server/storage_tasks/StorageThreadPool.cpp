@@ -7,6 +7,9 @@
  */
 #include "logdevice/server/storage_tasks/StorageThreadPool.h"
 
+#include <chrono>
+#include <thread>
+
 #include <folly/Memory.h>
 
 #include "logdevice/common/AdminCommandTable.h"
@@ -394,6 +397,18 @@ StorageThreadPool::blockingGetTask(StorageTask::ThreadType type) {
                      toString(dropped_by_type).c_str());
     }
 
+    // While a compaction or partition drop is running on this shard,
+    // hold low-priority reads (rebuilding, digest) back briefly before
+    // executing them so they don't compete with the compaction and with
+    // latency-critical reads for the disk. Only this thread is delayed;
+    // the other storage threads keep draining the queue.
+    if (!task->isWriteTask() &&
+        task->getPriority() == StorageTaskPriority::LOW &&
+        !shutting_down_.load() && local_log_store_->isCompactionInProgress()) {
+      static constexpr std::chrono::milliseconds kCompactingReadDelay{20};
+      /* sleep override */ std::this_thread::sleep_for(kCompactingReadDelay);
+    }
+
     STORAGE_TASK_STAT_INCR(stats_, type, storage_tasks_dequeued);
     return task;
   }
@@ -156,14 +156,18 @@ void SyncingStorageThread::run() {
           },
           duration_ms);
 
+      // One response batch per Worker for the whole sync group instead of
+      // one cross-thread post per task; see StorageTaskResponseBatcher.
+      StorageTaskResponseBatcher batcher;
       for (auto& ptr : batch) {
         if (ptr) {
           ptr->onSynced();
-          StorageTaskResponse::sendBackToWorker(std::move(ptr));
+          batcher.sendBackToWorker(std::move(ptr));
         } else {
         }
       }
       batch.clear();
+      batcher.flush();
     }
   }
 }
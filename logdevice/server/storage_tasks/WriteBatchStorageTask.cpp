@@ -13,6 +13,7 @@
 #include <unistd.h>
 #include <vector>
 
+#include <folly/ScopeGuard.h>
 #include <folly/small_vector.h>
 #include <folly/synchronization/Baton.h>
 
@@ -42,6 +43,14 @@ void WriteBatchStorageTask::execute() {
     return;
   }
 
+  // Group this drain's completions per destination Worker so each Worker
+  // gets one wakeup for the whole batch instead of one per write.
+  StorageTaskResponseBatcher batcher;
+  batcher_ = &batcher;
+  SCOPE_EXIT {
+    batcher_ = nullptr;
+  };
+
   // Yield to higher-pri tasks if needed. Since this can take a few seconds
   // or even minutes, this is done before checking timeouts and preemption.
   auto reject_writes = throttleIfNeeded();
@@ -131,6 +140,10 @@ void WriteBatchStorageTask::execute() {
     STAT_INCR(stats(), write_batches);
   }
 
+  // Post rejection replies before the write itself so they aren't delayed
+  // behind it.
+  batcher.flush();
+
   int rv = writeMulti(write_ops);
   Status status = rv == 0 ? E::OK : err;
 
@@ -232,12 +245,20 @@ WriteBatchStorageTask::tryGetWriteBatch(size_t max_count, size_t max_bytes) {
 
 void WriteBatchStorageTask::sendBackToWorker(
     std::unique_ptr<WriteStorageTask> write) {
-  StorageTaskResponse::sendBackToWorker(std::move(write));
+  if (batcher_ != nullptr) {
+    batcher_->sendBackToWorker(std::move(write));
+  } else {
+    StorageTaskResponse::sendBackToWorker(std::move(write));
+  }
 }
 
 void WriteBatchStorageTask::sendDroppedToWorker(
     std::unique_ptr<WriteStorageTask> write) {
-  StorageTaskResponse::sendDroppedToWorker(std::move(write));
+  if (batcher_ != nullptr) {
+    batcher_->sendDroppedToWorker(std::move(write));
+  } else {
+    StorageTaskResponse::sendDroppedToWorker(std::move(write));
+  }
 }
 
 int WriteBatchStorageTask::writeMulti(
@@ -56,6 +56,7 @@ namespace facebook { namespace logdevice {
  */
 
 class StatsHolder;
+class StorageTaskResponseBatcher;
 class WriteOp;
 
 class WriteBatchStorageTask : public StorageTask {
@@ -88,5 +89,11 @@ class WriteBatchStorageTask : public StorageTask {
   virtual int writeMulti(const std::vector<const WriteOp*>& write_ops);
   // Returns true if entire tasks will be rejected.
   virtual bool throttleIfNeeded();
+
+ private:
+  // Set by execute() for its duration; when non-null, sendBackToWorker() and
+  // sendDroppedToWorker() accumulate responses here (one batch per Worker
+  // per drain) instead of posting each one individually.
+  StorageTaskResponseBatcher* batcher_ = nullptr;
 };
 }} // namespace facebook::logdevice
@@ -20,10 +20,12 @@
 #include "logdevice/common/protocol/Compatibility.h"
 #include "logdevice/common/protocol/GAP_Message.h"
 #include "logdevice/common/protocol/Message.h"
+#include "logdevice/common/protocol/RECORD_BATCH_Message.h"
 #include "logdevice/common/protocol/RECORD_Message.h"
 #include "logdevice/common/protocol/STARTED_Message.h"
 #include "logdevice/common/protocol/STORE_Message.h"
 #include "logdevice/common/protocol/WINDOW_Message.h"
+#include "logdevice/common/settings/util.h"
 #include "logdevice/common/stats/Stats.h"
 #include "logdevice/common/test/MockBackoffTimer.h"
 #include "logdevice/common/test/MockTimer.h"
@@ -295,6 +297,10 @@ class CatchupQueueTest : public ::testing::Test {
                         folly::StringPiece record_key1,
                         folly::StringPiece record_key2);
 
+  // Settings returned by MockCatchupQueueDependencies::getSettings(); tests
+  // may tweak them before driving the queue.
+  Settings settings_ = create_default_settings<Settings>();
+
   LogStorageStateMap log_storage_state_map_;
   InterceptedTasks tasks_;
   TestAllServerReadStreams streams_;
@@ -451,7 +457,7 @@ class MockCatchupQueueDependencies : public CatchupQueueDependencies {
   }
 
   const Settings& getSettings() const override {
-    return *settings_.get();
+    return test_.settings_;
   }
 
  private:
@@ -461,7 +467,6 @@ class MockCatchupQueueDependencies : public CatchupQueueDependencies {
     test_.flow_group_->push(callback, priority);
   }
 
-  UpdateableSettings<Settings> settings_; // never updated
   CatchupQueueTest& test_;
   StatsHolder server_stats_;
 };
@@ -715,6 +720,76 @@ TEST_F(CatchupQueueTest, UntilLSNReached) {
   ASSERT_EQ(5, getHeader(*r2).lsn);
 }
 
+/**
+ * With record-batch-max-records set, all records of one read burst should be
+ * shipped in a single RECORD_BATCH frame, while a burst of one record keeps
+ * using a plain RECORD message.
+ */
+TEST_F(CatchupQueueTest, RecordBatchEmission) {
+  settings_.record_batch_max_records = 100;
+
+  read_stream_id_t read_stream_id(1);
+  ServerReadStream& stream = createStream(read_stream_id);
+  notifyNeedsCatchup(stream, read_stream_id);
+
+  ASSERT_EQ(1, tasks_.size());
+  std::unique_ptr<ReadStorageTask> task = std::move(tasks_.front());
+  tasks_.clear();
+  messages_.clear(); // drop the STARTED message
+
+  {
+    ReadStorageTask::RecordContainer records;
+    records.push_back(createFakeRecord(1, 100));
+    records.push_back(createFakeRecord(2, 100));
+    records.push_back(createFakeRecord(3, 100));
+    task->status_ = E::CAUGHT_UP;
+    task->records_ = std::move(records);
+    task->read_ctx_.read_ptr_ = {lsn_t{4}};
+    streams_.onReadTaskDone(*task);
+  }
+
+  // The burst should have produced one RECORD_BATCH carrying all three
+  // records, in order.
+  ASSERT_EQ(1, messages_.size());
+  auto* batch = dynamic_cast<RECORD_BATCH_Message*>(messages_[0].first.get());
+  ASSERT_NE(nullptr, batch);
+  EXPECT_EQ(log_id_, batch->header_.log_id);
+  EXPECT_EQ(read_stream_id, batch->header_.read_stream_id);
+  ASSERT_EQ(3, batch->header_.record_count);
+  ASSERT_EQ(3, batch->records_.size());
+  EXPECT_EQ(1, getHeader(*batch->records_[0]).lsn);
+  EXPECT_EQ(2, getHeader(*batch->records_[1]).lsn);
+  EXPECT_EQ(3, getHeader(*batch->records_[2]).lsn);
+  EXPECT_EQ(3, stream.last_delivered_lsn_);
+
+  // record_bytes_queued_ should account for the batched records the same way
+  // it does for standalone RECORD messages.
+  EXPECT_EQ(3 * RECORD_Message::expectedSize(100),
+            getCatchupQueueRecordBytesQueued(client_id_));
+
+  // A burst with a single record should go out as a plain RECORD.
+  messages_.clear();
+  notifyNeedsCatchup(stream, read_stream_id);
+  ASSERT_EQ(1, tasks_.size());
+  task = std::move(tasks_.front());
+  tasks_.clear();
+
+  {
+    ReadStorageTask::RecordContainer records;
+    records.push_back(createFakeRecord(4, 100));
+    task->status_ = E::CAUGHT_UP;
+    task->records_ = std::move(records);
+    task->read_ctx_.read_ptr_ = {lsn_t{5}};
+    streams_.onReadTaskDone(*task);
+  }
+
+  ASSERT_EQ(1, messages_.size());
+  RECORD_Message* rec =
+      dynamic_cast<RECORD_Message*>(messages_[0].first.get());
+  ASSERT_NE(nullptr, rec);
+  EXPECT_EQ(4, getHeader(*rec).lsn);
+}
+
 /**
  * CatchupQueue should send a GAP message to the client if the next available
  * record is past until_lsn.
@@ -2070,7 +2145,7 @@ TEST_F(CatchupQueueTest, StartedStreamValidations) {
   }
 
   // Simulate a stream rewind. This will bump the filter version.
-  stream.filter_version_ = filter_version_t(1);
+  stream.setFilterVersion(filter_version_t(1));
   stream.needs_started_message_ = true;
   notifyNeedsCatchup(stream, id1);
   ASSERT_EQ(1, messages_.size());
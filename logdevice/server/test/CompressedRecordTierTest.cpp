@@ -0,0 +1,158 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/CompressedRecordTier.h"
+
+#include <gtest/gtest.h>
+
+#include "logdevice/common/CopySet.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/STORE_Message.h"
+#include "logdevice/server/EpochRecordCacheEntry.h"
+#include "logdevice/server/RealTimeRecordBuffer.h"
+
+using namespace facebook::logdevice;
+using Entry = EpochRecordCacheEntry;
+
+const logid_t LOG_ID(7);
+const shard_index_t SHARD(0);
+const epoch_t EPOCH(3);
+
+#define N0 ShardID(0, SHARD)
+#define N1 ShardID(1, SHARD)
+#define N2 ShardID(2, SHARD)
+
+namespace {
+
+lsn_t lsn(esn_t::raw_type esn) {
+  return compose_lsn(EPOCH, esn_t(esn));
+}
+
+// payload of the record is a fixed 8 bytes storing the lsn of the record
+std::shared_ptr<Entry> createEntry(lsn_t lsn) {
+  return std::shared_ptr<Entry>(
+      new Entry(lsn,
+                STORE_flags_t(0),
+                /*timestamp=*/lsn,
+                /*last_known_good=*/esn_t(0),
+                /*wave_or_recovery_epoch=*/1,
+                copyset_t({N0, N1, N2}),
+                OffsetMap(),
+                std::map<KeyType, std::string>(),
+                PayloadHolder::copyBuffer(&lsn, sizeof(lsn))),
+      Entry::Disposer(nullptr));
+}
+
+ReleasedVector createRange(std::initializer_list<esn_t::raw_type> esns) {
+  ReleasedVector entries;
+  for (esn_t::raw_type esn : esns) {
+    entries.push_back(createEntry(lsn(esn)));
+  }
+  return entries;
+}
+
+// collect the lsns of the reconstructed chain
+std::vector<lsn_t> chainLsns(const ReleasedRecords& records) {
+  std::vector<lsn_t> lsns;
+  for (const ZeroCopiedRecord* entry = records.entries_.get();
+       entry != nullptr;
+       entry = entry->next_.get()) {
+    lsns.push_back(entry->lsn);
+  }
+  return lsns;
+}
+
+} // anonymous namespace
+
+TEST(CompressedRecordTierTest, PutAndLookup) {
+  CompressedRecordTier tier(1024 * 1024, /*stats=*/nullptr);
+  // Range with a hole at esn 3: this node just doesn't have a record there.
+  tier.put(LOG_ID, lsn(1), lsn(5), createRange({1, 2, 4, 5}));
+  ASSERT_GT(tier.getBytesUsed(), 0);
+
+  // Every lsn in [1, 5] should hit, including the hole.
+  for (esn_t::raw_type esn = 1; esn <= 5; ++esn) {
+    auto records = tier.lookup(LOG_ID, lsn(esn));
+    ASSERT_NE(nullptr, records);
+    EXPECT_EQ(LOG_ID, records->logid_);
+    EXPECT_EQ(lsn(1), records->begin_lsn_);
+    EXPECT_EQ(lsn(5), records->end_lsn_);
+    EXPECT_EQ(std::vector<lsn_t>({lsn(1), lsn(2), lsn(4), lsn(5)}),
+              chainLsns(*records));
+  }
+
+  // Reconstructed entries should round-trip faithfully.
+  auto records = tier.lookup(LOG_ID, lsn(2));
+  ASSERT_NE(nullptr, records);
+  const ZeroCopiedRecord* entry = records->entries_->next_.get();
+  ASSERT_NE(nullptr, entry);
+  EXPECT_EQ(lsn(2), entry->lsn);
+  EXPECT_EQ(lsn(2), entry->timestamp);
+  EXPECT_EQ(copyset_t({N0, N1, N2}), entry->copyset);
+  ASSERT_EQ(sizeof(lsn_t), entry->payload.size());
+  EXPECT_EQ(lsn(2), *((const lsn_t*)entry->payload.getPayload().data()));
+
+  // Outside the stored range, or for another log: miss.
+  EXPECT_EQ(nullptr, tier.lookup(LOG_ID, lsn(6)));
+  EXPECT_EQ(nullptr, tier.lookup(LOG_ID, compose_lsn(EPOCH, ESN_INVALID)));
+  EXPECT_EQ(nullptr, tier.lookup(logid_t(8), lsn(2)));
+}
+
+TEST(CompressedRecordTierTest, MultipleRanges) {
+  CompressedRecordTier tier(1024 * 1024, /*stats=*/nullptr);
+  tier.put(LOG_ID, lsn(1), lsn(3), createRange({1, 2, 3}));
+  tier.put(LOG_ID, lsn(4), lsn(6), createRange({4, 5, 6}));
+
+  auto records = tier.lookup(LOG_ID, lsn(3));
+  ASSERT_NE(nullptr, records);
+  EXPECT_EQ(lsn(1), records->begin_lsn_);
+
+  records = tier.lookup(LOG_ID, lsn(4));
+  ASSERT_NE(nullptr, records);
+  EXPECT_EQ(lsn(4), records->begin_lsn_);
+  EXPECT_EQ(lsn(6), records->end_lsn_);
+}
+
+TEST(CompressedRecordTierTest, Eviction) {
+  // Budget enough for only a couple of ranges.
+  CompressedRecordTier tier(512, /*stats=*/nullptr);
+  esn_t::raw_type esn = 1;
+  for (int i = 0; i < 100; ++i, esn += 2) {
+    tier.put(LOG_ID, lsn(esn), lsn(esn + 1), createRange({esn, esn + 1}));
+    ASSERT_LE(tier.getBytesUsed(), 512);
+  }
+
+  // The oldest ranges must be long gone, the newest one still there.
+  EXPECT_EQ(nullptr, tier.lookup(LOG_ID, lsn(1)));
+  EXPECT_NE(nullptr, tier.lookup(LOG_ID, lsn(esn - 1)));
+}
+
+TEST(CompressedRecordTierTest, OversizedRangeSkipped) {
+  // Budget too small for anything.
+  CompressedRecordTier tier(8, /*stats=*/nullptr);
+  tier.put(LOG_ID, lsn(1), lsn(2), createRange({1, 2}));
+  EXPECT_EQ(0, tier.getBytesUsed());
+  EXPECT_EQ(nullptr, tier.lookup(LOG_ID, lsn(1)));
+}
+
+TEST(CompressedRecordTierTest, OverlappingReleaseReplaced) {
+  CompressedRecordTier tier(1024 * 1024, /*stats=*/nullptr);
+  tier.put(LOG_ID, lsn(1), lsn(2), createRange({1, 2}));
+  const size_t bytes_before = tier.getBytesUsed();
+
+  // Re-release of the same range, extended by one record; the newer version
+  // should win.
+  tier.put(LOG_ID, lsn(1), lsn(3), createRange({1, 2, 3}));
+  EXPECT_GT(tier.getBytesUsed(), bytes_before);
+
+  auto records = tier.lookup(LOG_ID, lsn(3));
+  ASSERT_NE(nullptr, records);
+  EXPECT_EQ(lsn(1), records->begin_lsn_);
+  EXPECT_EQ(lsn(3), records->end_lsn_);
+  EXPECT_EQ(std::vector<lsn_t>({lsn(1), lsn(2), lsn(3)}),
+            chainLsns(*records));
+}
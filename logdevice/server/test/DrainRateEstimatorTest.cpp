@@ -0,0 +1,76 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/read_path/DrainRateEstimator.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::logdevice;
+
+namespace {
+
+SteadyTimestamp ts(std::chrono::milliseconds ms) {
+  return SteadyTimestamp(ms);
+}
+
+} // namespace
+
+// A stream with no drain history should get the full budget so that new
+// and rewound streams start at full speed.
+TEST(DrainRateEstimatorTest, NoHistoryGetsMaxBudget) {
+  DrainRateEstimator est;
+  EXPECT_EQ(1000u,
+            est.suggestBatchBytes(ts(std::chrono::milliseconds(100)),
+                                  std::chrono::milliseconds(500),
+                                  10,
+                                  1000));
+}
+
+TEST(DrainRateEstimatorTest, RateTracksDrains) {
+  DrainRateEstimator est;
+  auto t = std::chrono::milliseconds(0);
+  // Drain 1000 bytes every 100ms for a while; the decayed rate should
+  // settle near 10000 bytes/sec.
+  for (int i = 0; i < 100; ++i) {
+    est.onBytesDrained(1000, ts(t));
+    t += std::chrono::milliseconds(100);
+  }
+  const double rate = est.rateBytesPerSec(ts(t));
+  EXPECT_GT(rate, 5000.0);
+  EXPECT_LT(rate, 20000.0);
+}
+
+TEST(DrainRateEstimatorTest, SlowDrainShrinksBudget) {
+  DrainRateEstimator est;
+  auto t = std::chrono::milliseconds(0);
+  // 100 bytes/sec.
+  for (int i = 0; i < 100; ++i) {
+    est.onBytesDrained(100, ts(t));
+    t += std::chrono::seconds(1);
+  }
+  // A 500ms batch target at ~100 bytes/sec should suggest far less than
+  // the 1MB max, but never less than the floor.
+  const size_t budget = est.suggestBatchBytes(
+      ts(t), std::chrono::milliseconds(500), 64, 1 << 20);
+  EXPECT_LT(budget, 10000u);
+  EXPECT_GE(budget, 64u);
+}
+
+TEST(DrainRateEstimatorTest, StallDecaysRateToFloor) {
+  DrainRateEstimator est;
+  auto t = std::chrono::milliseconds(0);
+  for (int i = 0; i < 10; ++i) {
+    est.onBytesDrained(1 << 20, ts(t));
+    t += std::chrono::milliseconds(100);
+  }
+  // After many half-lives of silence the rate is ~zero, so the suggested
+  // budget collapses to the floor.
+  t += std::chrono::minutes(5);
+  const size_t budget = est.suggestBatchBytes(
+      ts(t), std::chrono::milliseconds(500), 4096, 1 << 20);
+  EXPECT_EQ(4096u, budget);
+}
@@ -394,6 +394,16 @@ TEST_F(FailureDetectorTest, RoundRobinGossip) {
   simulate(20, settings);
 }
 
+// Failure detection must still converge when gossip messages only carry
+// nodes whose state changed since the last gossip to the destination.
+TEST_F(FailureDetectorTest, DeltaGossip) {
+  GossipSettings settings = create_default_settings<GossipSettings>();
+  settings.mode = GossipSettings::SelectionMode::ROUND_ROBIN;
+  settings.suspect_duration = std::chrono::milliseconds(0);
+  settings.gossip_delta_encoding = true;
+  simulate(20, settings);
+}
+
 namespace {
 // simulates a single round of gossiping between two nodes
 void gossip_round(MockFailureDetector* d1, MockFailureDetector* d2) {
@@ -370,6 +370,39 @@ TEST_P(LocalLogStoreReaderTest, ZeroExecutionTime_) {
   ASSERT_EQ(E::PARTIAL, st);
   ASSERT_EQ(1, records.size());
 }
+
+// A batch whose is_cancelled_ hook reports cancellation is abandoned with
+// E::ABORTED before shipping any records, while a hook that never reports
+// cancellation doesn't affect the read.
+TEST_P(LocalLogStoreReaderTest, CancelledBatch) {
+  auto store = createStore({{1, 1, {N1, N2, N3, N4}},
+                            {2, 1, {N1, N2, N3, N4}},
+                            {3, 1, {N1, N2, N3, N4}},
+                            {4, 1, {N1, N2, N3, N4}}});
+
+  std::vector<RawRecord> records;
+  Status st = ReadOperation()
+                  .use_csi(useCSI())
+                  .until_lsn(3)
+                  .window_high(3)
+                  .last_released(4)
+                  .is_cancelled([] { return true; })
+                  .process(store.get(), records);
+
+  ASSERT_EQ(E::ABORTED, st);
+  ASSERT_EQ(0, records.size());
+
+  st = ReadOperation()
+           .use_csi(useCSI())
+           .until_lsn(3)
+           .window_high(3)
+           .last_released(4)
+           .is_cancelled([] { return false; })
+           .process(store.get(), records);
+
+  ASSERT_EQ(E::UNTIL_LSN_REACHED, st);
+  ASSERT_SHIPPED(records, 1, 2, 3);
+}
 /**
  * If the local log store contains an old-format and a new-format DataKey with
  * the same log ID and LSN, LocalLogStoreReader only delivers the copy with the
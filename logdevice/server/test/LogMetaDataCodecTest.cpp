@@ -28,8 +28,7 @@ TailRecord create_dummy_tail_record() {
       {}};
 
   OffsetMap map;
-  map.setCounter(123, 321);
-  map.setCounter(124, 322);
+  map.setCounter(BYTE_OFFSET, 321);
 
   return TailRecord(std::move(hdr), std::move(map), PayloadHolder());
 }
@@ -692,6 +692,83 @@ TEST_F(PurgeUncleanEpochsTest, EmptyEpochsDoNotFetchERM) {
   ASSERT_EQ(Status::OK, completion_);
 }
 
+TEST_F(PurgeUncleanEpochsTest, ConsecutiveNonEmptyEpochsCoalesced) {
+  // last clean epoch: 6 already known
+  // purge up to: 20
+  // new lce: 20
+  // non-empty epochs: 14,15,16,19 with one epoch metadata interval
+  // covering all of them. Requests for consecutive non-empty epochs
+  // should be coalesced: [14, 16] and [19, 19]
+  purge_to_ = epoch_t(20);
+  current_last_clean_epoch_ = epoch_t(6);
+  new_last_clean_epoch_ = epoch_t(20);
+  setUp();
+  settings_.get_erm_for_empty_epoch = false;
+
+  purge_->start();
+  ASSERT_EQ(State::GET_PURGE_EPOCHS, getState());
+  CHECK_STORAGE_TASK(SealStorageTask);
+
+  auto epoch_map = new SealStorageTask::EpochInfoMap(
+      {{14, SealStorageTask::EpochInfo{esn_t(1), esn_t(2)}},
+       {15, SealStorageTask::EpochInfo{esn_t(1), esn_t(2)}},
+       {16, SealStorageTask::EpochInfo{esn_t(10), esn_t(20)}},
+       {19, SealStorageTask::EpochInfo{esn_t(1), esn_t(2)}}});
+
+  purge_->onGetPurgeEpochsDone(
+      E::OK, std::unique_ptr<SealStorageTask::EpochInfoMap>(epoch_map));
+
+  genEpochMetaDataMap({2}, epoch_t(19));
+  onHistoricalMetadata(E::OK);
+
+  // one request for the run of consecutive non-empty epochs, one for the
+  // isolated epoch
+  checkGetEpochRecoveryMetadataRequestPosted(epoch_t(14), epoch_t(16));
+  checkGetEpochRecoveryMetadataRequestPosted(epoch_t(19), epoch_t(19));
+  ASSERT_TRUE(pendingEpochRecoveryMetadataRequests.empty());
+
+  // Now GetEpochRecoveryMetadataRequest completes
+  epoch_size_map.setCounter(BYTE_OFFSET, 200);
+  tail_record.offsets_map_.setCounter(BYTE_OFFSET, 100);
+  epoch_end_offsets.setCounter(BYTE_OFFSET, 100);
+  EpochRecoveryMetadata md(epoch_t(15),
+                           esn_t(2),
+                           esn_t(4),
+                           0,
+                           tail_record,
+                           epoch_size_map,
+                           epoch_end_offsets);
+
+  onGetEpochRecoveryMetadataComplete(
+      E::OK,
+      EpochRecoveryStateMap{
+          {14, std::make_pair(E::OK, md)},
+          {15, std::make_pair(E::OK, md)},
+          {16, std::make_pair(E::EMPTY, EpochRecoveryMetadata())}});
+
+  // still waiting on the second request
+  ASSERT_EQ(State::GET_EPOCH_RECOVERY_METADATA, getState());
+
+  onGetEpochRecoveryMetadataComplete(
+      E::OK,
+      EpochRecoveryStateMap{
+          {19, std::make_pair(E::EMPTY, EpochRecoveryMetadata())}});
+
+  ASSERT_EQ(State::RUN_PURGE_EPOCHS, getState());
+  purge_->onPurgeSingleEpochDone(epoch_t(14), E::OK);
+  purge_->onPurgeSingleEpochDone(epoch_t(15), E::OK);
+  purge_->onPurgeSingleEpochDone(epoch_t(16), E::OK);
+  purge_->onPurgeSingleEpochDone(epoch_t(19), E::OK);
+
+  ASSERT_TRUE(getPurgeSingleEpochsMap().empty());
+  ASSERT_EQ(State::WRITE_LAST_CLEAN, getState());
+  CHECK_STORAGE_TASK(PurgeWriteLastCleanTask);
+
+  ASSERT_EQ(Status::UNKNOWN, completion_);
+  purge_->onWriteLastCleanDone(E::OK);
+  ASSERT_EQ(Status::OK, completion_);
+}
+
 TEST_F(PurgeUncleanEpochsTest, NoPurgeNeededButAdvanceLCE) {
   // last clean epoch: 6 already known
   // purge up to: 6
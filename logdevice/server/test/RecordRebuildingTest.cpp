@@ -216,6 +216,10 @@ class TestRecordRebuildingStore : public RecordRebuildingStore,
 
   std::queue<CopysetPick> copysets_to_pick_;
 
+  // Mirrors the copyset cache kept by ChunkRebuilding.
+  std::pair<std::vector<ShardID>, std::vector<ShardID>> copyset_cache_;
+  bool copyset_cached_ = false;
+
   bool retry_timer_active_ = false;
   bool store_timer_active_ = false;
   bool complete_ = false;
@@ -266,6 +270,23 @@ class TestRecordRebuildingStore : public RecordRebuildingStore,
   getRebuildingSettings() const override {
     return rebuildingSettings_;
   }
+  bool getCopysetFromCache(const copyset_t& base,
+                           copyset_t* copyset_out) const override {
+    if (!copyset_cached_ ||
+        copyset_cache_.first !=
+            std::vector<ShardID>(base.begin(), base.end())) {
+      return false;
+    }
+    copyset_out->assign(
+        copyset_cache_.second.begin(), copyset_cache_.second.end());
+    return true;
+  }
+  void putCopysetInCache(const copyset_t& base,
+                         const copyset_t& copyset) override {
+    copyset_cache_ = {std::vector<ShardID>(base.begin(), base.end()),
+                      std::vector<ShardID>(copyset.begin(), copyset.end())};
+    copyset_cached_ = true;
+  }
   int pickCopysetImpl() override {
     if (copysets_to_pick_.empty()) {
       return -1;
@@ -442,6 +463,40 @@ TEST_F(RecordRebuildingStoreTest, Basic) {
   EXPECT_TRUE(r.complete_);
 }
 
+TEST_F(RecordRebuildingStoreTest, CopysetCache) {
+  // First record of a chunk: runs the copyset selector and populates the
+  // cache.
+  TestRecordRebuildingStore r1(createRecord(321, {N30, N20, N40}),
+                               replication_,
+                               {N30},
+                               20,
+                               &node_availability_);
+  r1.copysets_to_pick_.push({{N20, N40}, {N50}});
+  r1.start();
+  EXPECT_EQ(0, r1.copysets_to_pick_.size());
+  ASSERT_EQ(1, r1.messages_sent_.size());
+  EXPECT_EQ(NodeID(50, 0), r1.messages_sent_[0].second);
+  EXPECT_TRUE(r1.copyset_cached_);
+  EXPECT_EQ(std::vector<ShardID>({N20, N40}), r1.copyset_cache_.first);
+  EXPECT_EQ(std::vector<ShardID>({N20, N40, N50}), r1.copyset_cache_.second);
+
+  // A later record of the same chunk is served from the cache without
+  // consulting the copyset selector: copysets_to_pick_ is left empty, which
+  // would fail the pick if the selector ran.
+  TestRecordRebuildingStore r2(createRecord(321, {N30, N20, N40}),
+                               replication_,
+                               {N30},
+                               20,
+                               &node_availability_);
+  r2.copyset_cache_ = r1.copyset_cache_;
+  r2.copyset_cached_ = true;
+  r2.start();
+  ASSERT_EQ(1, r2.messages_sent_.size());
+  EXPECT_EQ(NodeID(50, 0), r2.messages_sent_[0].second);
+  r2.onStored(createStoredHeader(321), N50, LSN_INVALID, 0, REBUILDING_ID);
+  EXPECT_TRUE(r2.complete_);
+}
+
 TEST_F(RecordRebuildingStoreTest, TimeoutsAndFailures) {
   replication_->epoch_metadata.replication =
       ReplicationProperty({{NodeLocationScope::NODE, 5}});
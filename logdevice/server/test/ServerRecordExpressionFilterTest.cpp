@@ -0,0 +1,92 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/ServerRecordExpressionFilter.h"
+
+#include <gtest/gtest.h>
+
+#include "logdevice/server/ServerRecordFilterFactory.h"
+
+using namespace facebook::logdevice;
+
+TEST(ServerRecordExpressionFilterTest, KeyComparisons) {
+  RecordFilterExpressionBuilder b;
+  b.keyGe("aaa").keyLe("mmm").and_();
+  ServerRecordExpressionFilter filter(b.str());
+  ASSERT_TRUE(filter.valid());
+  EXPECT_TRUE(filter("aaa"));
+  EXPECT_TRUE(filter("ccc"));
+  EXPECT_TRUE(filter("mmm"));
+  EXPECT_FALSE(filter("mmmm"));
+  EXPECT_FALSE(filter("zzz"));
+  EXPECT_FALSE(filter(""));
+}
+
+TEST(ServerRecordExpressionFilterTest, PrefixAndByteMatch) {
+  // key starts with "user:" || key[0] == 0x7f
+  RecordFilterExpressionBuilder b;
+  b.keyPrefix("user:").byteEq(0, 0x7f).or_();
+  ServerRecordExpressionFilter filter(b.str());
+  ASSERT_TRUE(filter.valid());
+  EXPECT_TRUE(filter("user:42"));
+  EXPECT_TRUE(filter("\x7f\x01\x02"));
+  EXPECT_FALSE(filter("usez:42"));
+  EXPECT_FALSE(filter(""));
+}
+
+TEST(ServerRecordExpressionFilterTest, Not) {
+  RecordFilterExpressionBuilder b;
+  b.keyEq("skip").not_();
+  ServerRecordExpressionFilter filter(b.str());
+  ASSERT_TRUE(filter.valid());
+  EXPECT_FALSE(filter("skip"));
+  EXPECT_TRUE(filter("keep"));
+}
+
+TEST(ServerRecordExpressionFilterTest, MalformedPrograms) {
+  // Empty program.
+  EXPECT_FALSE(ServerRecordExpressionFilter("").valid());
+  // AND with only one value on the stack.
+  {
+    RecordFilterExpressionBuilder b;
+    b.keyEq("x").and_();
+    EXPECT_FALSE(ServerRecordExpressionFilter(b.str()).valid());
+  }
+  // Two values left on the stack.
+  {
+    RecordFilterExpressionBuilder b;
+    b.keyEq("x").keyEq("y");
+    EXPECT_FALSE(ServerRecordExpressionFilter(b.str()).valid());
+  }
+  // Truncated string operand.
+  {
+    RecordFilterExpressionBuilder b;
+    b.keyEq("hello");
+    std::string truncated = b.str().substr(0, b.str().size() - 2);
+    EXPECT_FALSE(ServerRecordExpressionFilter(truncated).valid());
+  }
+  // Unknown opcode.
+  EXPECT_FALSE(ServerRecordExpressionFilter(std::string(1, '\xee')).valid());
+}
+
+TEST(ServerRecordExpressionFilterTest, FactoryRejectsMalformed) {
+  RecordFilterExpressionBuilder b;
+  b.keyEq("x").and_();
+  auto filter = ServerRecordFilterFactory::create(
+      ServerRecordFilterType::EXPRESSION, b.str(), "");
+  EXPECT_EQ(nullptr, filter);
+}
+
+TEST(ServerRecordExpressionFilterTest, FactoryCreatesValid) {
+  RecordFilterExpressionBuilder b;
+  b.keyPrefix("k");
+  auto filter = ServerRecordFilterFactory::create(
+      ServerRecordFilterType::EXPRESSION, b.str(), "");
+  ASSERT_NE(nullptr, filter);
+  EXPECT_TRUE((*filter)("key1"));
+  EXPECT_FALSE((*filter)("other"));
+}
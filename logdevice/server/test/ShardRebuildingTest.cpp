@@ -7,6 +7,8 @@
  */
 #include "logdevice/server/rebuilding/ShardRebuilding.h"
 
+#include <set>
+
 #include <gtest/gtest.h>
 
 #include "logdevice/common/settings/SettingsUpdater.h"
@@ -31,9 +33,15 @@ class MockedShardRebuilding : public ShardRebuilding,
   };
 
   StatsHolder stats;
+  // Indices of read streams that have a storage task in flight.
+  std::set<size_t> tasksInFlight;
+  // Shorthand for !tasksInFlight.empty(), convenient for the common
+  // single-stream tests.
   bool taskInFlight = false;
   bool waitingForGlobalWindow = false;
   bool completed = false;
+  // What getLocalNodeHealthStatus() reports to ShardRebuilding.
+  NodeHealthStatus nodeHealthStatus = NodeHealthStatus::HEALTHY;
 
   // Populated by ShardRebuilding and emptied by simulateChunkRebuildingDone().
   std::deque<ChunkInfo> chunkRebuildings;
@@ -109,6 +117,9 @@ class MockedShardRebuilding : public ShardRebuilding,
   node_index_t getMyNodeIndex() override {
     return MY_NODE_IDX;
   }
+  NodeHealthStatus getLocalNodeHealthStatus() override {
+    return nodeHealthStatus;
+  }
   worker_id_t startChunkRebuilding(std::unique_ptr<ChunkData> chunk,
                                    chunk_rebuilding_id_t chunk_id) override {
     worker_id_t worker{(int)(chunk_id.val() % 10)};
@@ -116,8 +127,9 @@ class MockedShardRebuilding : public ShardRebuilding,
         ChunkInfo{.id = chunk_id, .data = std::move(chunk), .worker = worker});
     return worker;
   }
-  void putStorageTask() override {
-    EXPECT_FALSE(taskInFlight);
+  void putStorageTask(size_t stream_idx) override {
+    EXPECT_EQ(0, tasksInFlight.count(stream_idx));
+    tasksInFlight.insert(stream_idx);
     taskInFlight = true;
   }
 
@@ -148,25 +160,32 @@ class MockedShardRebuilding : public ShardRebuilding,
   }
 
   void simulateReadTaskDone(std::vector<ChunkData*> chunks,
-                            bool reached_end = false) {
-    ld_check(taskInFlight);
-    taskInFlight = false;
-
-    ld_check(!readContext_->reachedEnd);
-    readContext_->reachedEnd = reached_end;
+                            bool reached_end = false,
+                            size_t stream_idx = 0,
+                            size_t bytes_read = 0) {
+    ld_check(tasksInFlight.count(stream_idx));
+    tasksInFlight.erase(stream_idx);
+    taskInFlight = !tasksInFlight.empty();
+
+    auto& context = readStreams_.at(stream_idx).context;
+    ld_check(!context->reachedEnd);
+    context->reachedEnd = reached_end;
+    context->bytesRead = bytes_read;
     auto before = SteadyTimestamp::now();
-    readContext_->onDone(
+    context->onDone(
         std::vector<std::unique_ptr<ChunkData>>(chunks.begin(), chunks.end()));
     globalWindowWaitingMayHaveChanged(before);
   }
 
-  void simulatePersistentError() {
-    ld_check(taskInFlight);
-    taskInFlight = false;
+  void simulatePersistentError(size_t stream_idx = 0) {
+    ld_check(tasksInFlight.count(stream_idx));
+    tasksInFlight.erase(stream_idx);
+    taskInFlight = !tasksInFlight.empty();
 
-    readContext_->persistentError = true;
+    auto& context = readStreams_.at(stream_idx).context;
+    context->persistentError = true;
     auto before = SteadyTimestamp::now();
-    readContext_->onDone({});
+    context->onDone({});
     globalWindowWaitingMayHaveChanged(before);
   }
 
@@ -238,7 +257,7 @@ ChunkData* makeChunk(logid_t log,
 TEST_P(ShardRebuildingTest, Basic) {
   MockedShardRebuilding reb(rebuildingSettings_);
   // ShardRebuilding doesn't directly use rebuilding plan, it just passes it to
-  // readContext_. So we can pass an empty plan.
+  // the reading context. So we can pass an empty plan.
   reb.start({});
   EXPECT_TRUE(reb.taskInFlight);
   EXPECT_EQ(0, reb.chunkRebuildings.size());
@@ -528,6 +547,113 @@ TEST_P(ShardRebuildingTest, WindowsAndInternalLogs) {
   EXPECT_DONOR_PROGRESS(BASE_TIME + direction * HOUR);
 }
 
+// With rebuilding-read-streams > 1 there's one storage task in flight per
+// stream, chunks delivered by different streams get merged into timestamp
+// order, and rebuilding only completes once every stream has reached the end.
+TEST_P(ShardRebuildingTest, StripedReading) {
+  rebuildingSettingsUpdater_.setFromCLI({{"rebuilding-read-streams", "2"}});
+
+  int direction = GetParam() ? -1 : +1; // new to old: -1, old to new: +1
+
+  MockedShardRebuilding reb(rebuildingSettings_);
+  reb.simulateAdvanceGlobalWindow(BASE_TIME - direction * MINUTE);
+  std::unordered_map<logid_t, std::unique_ptr<RebuildingPlan>> plan;
+  for (int i = 1; i <= 4; ++i) {
+    plan[logid_t(i)] = std::make_unique<RebuildingPlan>();
+  }
+  reb.start(std::move(plan));
+  // One storage task per stream.
+  EXPECT_EQ(std::set<size_t>({0, 1}), reb.tasksInFlight);
+
+  // The second stream comes back first, with the chronologically later chunk.
+  // It's above global window, so it just sits in the read buffer.
+  reb.simulateReadTaskDone(
+      {makeChunk(logid_t(2), 50, 51, 10, BASE_TIME + direction * MINUTE * 2)},
+      /* reached_end */ false,
+      /* stream_idx */ 1);
+  EXPECT_EQ(std::set<size_t>({0, 1}), reb.tasksInFlight);
+  EXPECT_EQ(0, reb.chunkRebuildings.size());
+  EXPECT_DONOR_PROGRESS(BASE_TIME + direction * MINUTE * 2);
+
+  // The first stream delivers an older chunk. It must be merged in front of
+  // the other stream's chunk, so it's the one reported as next to rebuild.
+  reb.simulateReadTaskDone(
+      {makeChunk(logid_t(1), 100, 101, 10, BASE_TIME + direction * MINUTE)},
+      /* reached_end */ false,
+      /* stream_idx */ 0);
+  EXPECT_EQ(std::set<size_t>({0, 1}), reb.tasksInFlight);
+  EXPECT_EQ(0, reb.chunkRebuildings.size());
+  EXPECT_DONOR_PROGRESS(BASE_TIME + direction * MINUTE);
+
+  // Move global window above both chunks. They should start in timestamp
+  // order regardless of the order the streams delivered them in.
+  reb.simulateAdvanceGlobalWindow(BASE_TIME + direction * MINUTE * 10);
+  ASSERT_EQ(2, reb.chunkRebuildings.size());
+  EXPECT_EQ(BASE_TIME + direction * MINUTE,
+            reb.chunkRebuildings[0].data->oldestTimestamp);
+  EXPECT_EQ(BASE_TIME + direction * MINUTE * 2,
+            reb.chunkRebuildings[1].data->oldestTimestamp);
+  EXPECT_DONOR_PROGRESS(BASE_TIME + direction * MINUTE);
+
+  // One stream reaching the end doesn't finish reading: the other stream's
+  // task is still in flight.
+  reb.simulateReadTaskDone({}, /* reached_end */ true, /* stream_idx */ 0);
+  EXPECT_EQ(std::set<size_t>({1}), reb.tasksInFlight);
+  EXPECT_DONOR_PROGRESS(BASE_TIME + direction * MINUTE);
+
+  reb.simulateReadTaskDone({}, /* reached_end */ true, /* stream_idx */ 1);
+  EXPECT_EQ(0, reb.tasksInFlight.size());
+  EXPECT_DONOR_PROGRESS(BASE_TIME + direction * MINUTE);
+
+  // Rebuilding completes only after both in-flight chunks are done.
+  reb.simulateChunkRebuildingDone(0);
+  EXPECT_FALSE(reb.completed);
+  EXPECT_DONOR_PROGRESS(BASE_TIME + direction * MINUTE * 2);
+
+  reb.simulateChunkRebuildingDone(0);
+  EXPECT_EQ(0, reb.donorProgress.size());
+  EXPECT_TRUE(reb.completed);
+}
+
+TEST_P(ShardRebuildingTest, HealthBasedThrottling) {
+  rebuildingSettingsUpdater_.setFromCLI(
+      // Low enough that one read batch pays for years of waiting.
+      {{"rebuilding-rate-limit-while-overloaded", "10/1000s"}});
+
+  MockedShardRebuilding reb(rebuildingSettings_);
+  reb.start({});
+  EXPECT_TRUE(reb.taskInFlight);
+
+  // While the node is healthy the normal (unlimited) rate limit applies,
+  // no matter how much we read.
+  reb.simulateReadTaskDone({makeChunk(logid_t(1), 100, 101, 10, BASE_TIME)},
+                           /* reached_end */ false,
+                           /* stream_idx */ 0,
+                           /* bytes_read */ 1000000);
+  EXPECT_TRUE(reb.taskInFlight);
+  ASSERT_EQ(1, reb.chunkRebuildings.size());
+
+  // The node becomes overloaded. The cost of the completed read batch is
+  // charged at the throttled rate, so the next storage task is delayed.
+  reb.nodeHealthStatus = NodeHealthStatus::OVERLOADED;
+  reb.simulateReadTaskDone({makeChunk(logid_t(1), 102, 103, 10, BASE_TIME)},
+                           /* reached_end */ false,
+                           /* stream_idx */ 0,
+                           /* bytes_read */ 1000000);
+  EXPECT_FALSE(reb.taskInFlight);
+  ASSERT_EQ(2, reb.chunkRebuildings.size());
+
+  // Once the node recovers, reading resumes at full speed.
+  reb.nodeHealthStatus = NodeHealthStatus::HEALTHY;
+  reb.noteRebuildingSettingsChanged();
+  EXPECT_TRUE(reb.taskInFlight);
+
+  reb.simulateReadTaskDone({}, /* reached_end */ true);
+  reb.simulateChunkRebuildingDone(0);
+  reb.simulateChunkRebuildingDone(0);
+  EXPECT_TRUE(reb.completed);
+}
+
 // TODO: getDebugInfo()
 // TODO: getDebugInfo() while waiting for global window
 // TODO: getDebugInfo() while have and don't have storage task in flight
@@ -56,6 +56,7 @@ class ZookeeperEpochStoreTestBase : public ::testing::TestWithParam<bool> {
     settings.server = true; // ZookeeperEpochStore requires this
     settings.epoch_store_double_write_new_serialization_format =
         enableDoubleWrite();
+    settings.epoch_store_batch_zk_writes = enableBatchedWrites();
 
     auto cfg_in =
         Configuration::fromJsonFile(TEST_CONFIG_FILE(TEST_CLUSTER ".conf"))
@@ -90,6 +91,10 @@ class ZookeeperEpochStoreTestBase : public ::testing::TestWithParam<bool> {
     return false;
   }
 
+  virtual bool enableBatchedWrites() const {
+    return false;
+  }
+
   virtual ZookeeperClientInMemory::state_map_t getPrefillZnodes() {
     ZookeeperClientInMemory::state_map_t map;
     map["/logdevice/epochstore_test/logs"] = {"", {}};
@@ -136,6 +141,12 @@ class ZookeeperEpochStoreTest : public ZookeeperEpochStoreTestBase {
   }
 };
 
+class ZookeeperEpochStoreBatchedWritesTest : public ZookeeperEpochStoreTestBase {
+  bool enableBatchedWrites() const override {
+    return true;
+  }
+};
+
 class ZookeeperEpochStoreTestEmpty : public ZookeeperEpochStoreTest {
  public:
   ZookeeperClientInMemory::state_map_t getPrefillZnodes() override {
@@ -654,6 +665,39 @@ TEST_P(ZookeeperEpochStoreTest, EpochMetaDataTest) {
   }
 }
 
+/**
+ *  Same as the NextEpoch part of EpochMetaDataTest, but with znode write
+ *  batching enabled, so the version-conditional writes go through the
+ *  batched multi-op path (including the retry-on-conflict handling for
+ *  racing updates of the same log).
+ */
+TEST_F(ZookeeperEpochStoreBatchedWritesTest, NextEpochWithBatchedWrites) {
+  int rv;
+
+  NextEpochTestRequest::completedRequestCnt.store(0);
+  for (logid_t logid : VALID_LOG_IDS) {
+    std::unique_ptr<Request> rq =
+        std::make_unique<NextEpochTestRequest>(epochstore.get(), logid);
+
+    rv = processor->postRequest(rq);
+    ASSERT_EQ(0, rv);
+  }
+
+  std::unique_ptr<Request> invalid_logid_rq =
+      std::make_unique<NextEpochTestRequest>(
+          epochstore.get(), UNPROVISIONED_LOG_ID);
+
+  rv = processor->postRequest(invalid_logid_rq);
+  ASSERT_EQ(0, rv);
+
+  const int n_requests_posted = VALID_LOG_IDS.size() + 1;
+
+  while (NextEpochTestRequest::completedRequestCnt < n_requests_posted) {
+    /* sleep override */
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+}
+
 /**
  *  Try to create a znode when the root does not exist.
  */
@@ -0,0 +1,245 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <folly/Benchmark.h>
+#include <folly/Format.h>
+#include <folly/Singleton.h>
+#include <folly/String.h>
+#include <folly/memory/Malloc.h>
+
+#include "logdevice/common/NoopTraceLogger.h"
+#include "logdevice/common/Request.h"
+#include "logdevice/common/Semaphore.h"
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/Timestamp.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/protocol/Message.h"
+#include "logdevice/common/protocol/ProtocolWriter.h"
+#include "logdevice/common/request_util.h"
+#include "logdevice/common/test/TestUtil.h"
+#include "logdevice/common/types_internal.h"
+#include "logdevice/lib/ClientImpl.h"
+#include "logdevice/test/utils/IntegrationTestUtils.h"
+
+DEFINE_string(num_server_workers,
+              "ncores",
+              "number of worker threads for the node");
+DEFINE_string(num_client_workers,
+              "ncores",
+              "number of worker threads for the client");
+DEFINE_int32(
+    max_sends_per_iteration,
+    1000,
+    "a cap on the number of messages to send in a single event loop iteration");
+DEFINE_string(message_size_mix,
+              "128:8,4096:1",
+              "comma-separated size:weight pairs describing the mix of "
+              "message body sizes to pump through the connections");
+
+namespace facebook { namespace logdevice {
+
+namespace {
+
+// Pretends to be a TEST_Message (whose deserializer accepts any body, see
+// TEST_Message::deserialize()) but carries a body of the given size, so the
+// harness can exercise arbitrary message-size mixes on the wire.
+class PayloadTestMessage : public Message {
+ public:
+  explicit PayloadTestMessage(size_t size)
+      : Message(MessageType::TEST, TrafficClass::REBUILD), size_(size) {}
+
+  void serialize(ProtocolWriter& writer) const override {
+    std::string payload(size_, ' ');
+    writer.writeVector(payload);
+  }
+
+  Disposition onReceived(const Address&) override {
+    return Disposition::NORMAL;
+  }
+
+ private:
+  size_t size_;
+};
+
+// Expands "size:weight,..." into a repeating pattern of body sizes that
+// senders walk round-robin, so every worker produces the requested mix.
+std::vector<size_t> parseSizeMix(const std::string& mix) {
+  std::vector<size_t> pattern;
+  std::vector<std::string> entries;
+  folly::split(',', mix, entries);
+  for (const auto& entry : entries) {
+    size_t size, weight;
+    if (folly::split(':', entry, size, weight) && weight > 0) {
+      pattern.insert(pattern.end(), weight, size);
+    } else {
+      ld_info("Invalid --message_size_mix entry \"%s\"", entry.c_str());
+      exit(1);
+    }
+  }
+  ld_check(!pattern.empty());
+  return pattern;
+}
+
+// Cumulative bytes the process has allocated, from jemalloc. Returns 0 when
+// not running with jemalloc, in which case per-message allocation volume is
+// not reported.
+uint64_t allocatedBytes() {
+  if (!folly::usingJEMalloc()) {
+    return 0;
+  }
+  uint64_t epoch = 1;
+  size_t size = sizeof(epoch);
+  mallctl("epoch", nullptr, nullptr, &epoch, size);
+  uint64_t allocated = 0;
+  size = sizeof(allocated);
+  mallctl("stats.allocated", &allocated, &size, nullptr, 0);
+  return allocated;
+}
+
+} // anonymous namespace
+
+// Benchmark that pumps a configurable mix of message sizes through real
+// Connections over loopback and reports per-message transport costs, so
+// changes to the send/receive path can be evaluated without a full cluster
+// deployment: messages/s, bytes/s, socket read/write events per message
+// (a proxy for syscalls per message) and allocated bytes per message.
+BENCHMARK(ConnectionThroughputBenchmark, n) {
+  folly::BenchmarkSuspender benchmark_suspender;
+
+  auto cluster =
+      IntegrationTestUtils::ClusterFactory()
+          .setParam("--num-workers", FLAGS_num_server_workers.c_str())
+          .create(1);
+  std::unique_ptr<ClientSettings> client_settings{ClientSettings::create()};
+  if (client_settings->set("num-workers", FLAGS_num_client_workers.c_str()) !=
+      0) {
+    ld_info("Unable to set client num-workers to %s",
+            FLAGS_num_client_workers.c_str());
+    exit(1);
+  }
+  if (client_settings->set("execute-requests", "1") != 0) {
+    ld_info("Unable to set execute-requests");
+    exit(1);
+  }
+  auto client = cluster->createClient(
+      getDefaultTestTimeout(), std::move(client_settings));
+  ClientImpl* client_impl = checked_downcast<ClientImpl*>(client.get());
+  Processor* processor = &client_impl->getProcessor();
+
+  const std::vector<size_t> size_pattern =
+      parseSizeMix(FLAGS_message_size_mix);
+
+  // Count the number of workers
+  auto worker_counter = run_on_all_workers(processor, [&]() { return 1; });
+  size_t num_workers =
+      std::accumulate(worker_counter.begin(), worker_counter.end(), 0);
+
+  // Separate work among worker threads
+  std::vector<size_t> per_worker_messages_to_send;
+  size_t remaining_messages = n;
+  size_t remaining_workers = num_workers;
+  while (remaining_workers) {
+    size_t wm = remaining_messages / remaining_workers;
+    per_worker_messages_to_send.push_back(wm);
+    remaining_messages -= wm;
+    --remaining_workers;
+  }
+  ld_assert(remaining_messages == 0);
+
+  std::atomic<uint64_t> bytes_sent{0};
+
+  // Body of the main request running on the workers. Posts itself to the
+  // worker again from time to time to yield to the event loop for flushing
+  Semaphore sem;
+  std::function<int()> callback_fn;
+  callback_fn = [&]() {
+    auto w = Worker::onThisThread();
+    size_t& to_send = per_worker_messages_to_send.at(w->idx_.val());
+    size_t sent_in_this_iteration = 0;
+    Address addr(NodeID(0));
+    while (to_send) {
+      size_t size = size_pattern[to_send % size_pattern.size()];
+      auto msg = std::make_unique<PayloadTestMessage>(size);
+      int rv = w->sender().sendMessage(std::move(msg), addr);
+      if (rv == 0) {
+        --to_send;
+        ++sent_in_this_iteration;
+        bytes_sent.fetch_add(size, std::memory_order_relaxed);
+      }
+      if (rv != 0 || sent_in_this_iteration >= FLAGS_max_sends_per_iteration) {
+        // Either our send failed or we sent enough in this iteration - post
+        // another request and yield to the event loop
+        auto callback_copy = callback_fn;
+        run_on_worker_nonblocking(processor,
+                                  w->idx_,
+                                  w->worker_type_,
+                                  RequestType::ADMIN_CMD_UTIL_INTERNAL,
+                                  std::move(callback_copy),
+                                  true);
+        return 0;
+      }
+    }
+    sem.post();
+    return 0;
+  };
+
+  Stats client_stats_before = client_impl->stats()->aggregate();
+  uint64_t read_events_before = cluster->getNode(0).stats()["sock_read_events"];
+  uint64_t allocated_before = allocatedBytes();
+  auto start = SteadyTimestamp::now();
+  benchmark_suspender.dismiss();
+
+  run_on_all_workers(processor, callback_fn);
+  for (size_t i = 0; i < num_workers; ++i) {
+    sem.wait();
+  }
+  auto output = [&](const std::string& action) {
+    auto usec = usec_since(start);
+    ld_info("%s %d messages (%lu payload bytes) in %lu usec using %lu "
+            "workers, %01.2fM msgs/sec, %01.2f MB/sec",
+            action.c_str(),
+            n,
+            bytes_sent.load(),
+            usec,
+            num_workers,
+            double(n) / usec,
+            double(bytes_sent.load()) / usec);
+  };
+  output("Sent");
+  wait_until("all messages received", [&]() {
+    uint64_t rcvd = cluster->getNode(0).stats()["message_received.TEST"];
+    ld_info("Received %lu", rcvd);
+    return rcvd == n;
+  });
+  output("Sent and received");
+
+  uint64_t allocated = allocatedBytes() - allocated_before;
+  Stats client_stats = client_impl->stats()->aggregate();
+  uint64_t write_events =
+      client_stats.sock_write_events - client_stats_before.sock_write_events;
+  uint64_t read_events =
+      cluster->getNode(0).stats()["sock_read_events"] - read_events_before;
+  ld_info("Client write events/message: %01.3f, server read "
+          "events/message: %01.3f%s",
+          double(write_events) / n,
+          double(read_events) / n,
+          folly::usingJEMalloc()
+              ? folly::sformat(
+                    ", client allocated bytes/message: {:.1f}",
+                    double(allocated) / n)
+                    .c_str()
+              : "");
+}
+
+}} // namespace facebook::logdevice
+
+int main(int argc, char** argv) {
+  folly::SingletonVault::singleton()->registrationComplete();
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -0,0 +1,223 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <string>
+#include <vector>
+
+#include <folly/Benchmark.h>
+#include <gflags/gflags.h>
+
+#include "logdevice/common/LocalLogStoreRecordFormat.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/STORE_Message.h"
+#include "logdevice/server/locallogstore/LocalLogStore.h"
+#include "logdevice/server/locallogstore/WriteOps.h"
+#include "logdevice/server/locallogstore/test/LocalLogStoreTestReader.h"
+#include "logdevice/server/locallogstore/test/TemporaryLogStore.h"
+#include "logdevice/server/read_path/LocalLogStoreReader.h"
+
+using namespace facebook::logdevice;
+
+/**
+ * @file Benchmarks for the storage side of the read path:
+ *       LocalLogStoreReader::read() iterating a TemporaryRocksDBStore, which
+ *       is the hot loop CatchupOneStream runs on storage threads. Dimensions:
+ *       payload size, copyset index on/off, filter selectivity (what fraction
+ *       of records the read filter lets through) and the number of concurrent
+ *       streams taking turns on the same log.
+ *
+ *       Each benchmark iteration is one read() call capped at
+ *       --bytes_per_batch. Records/s and bytes/s follow from the reported
+ *       time per iteration: with selectivity 1/N, a batch ships about
+ *       bytes_per_batch / (record_size) records out of N times as many
+ *       iterated.
+ */
+
+DEFINE_int32(records_per_log, 100000, "number of records written to the log");
+DEFINE_int32(bytes_per_batch, 65536, "max record bytes per read() call");
+
+namespace {
+
+const logid_t LOG_ID(1);
+
+// Lets through one record in keep_one_in_, by LSN. Stands in for SCD or
+// server-side filtering of a given selectivity.
+class SelectivityFilter : public LocalLogStoreReadFilter {
+ public:
+  explicit SelectivityFilter(lsn_t keep_one_in) : keep_one_in_(keep_one_in) {}
+
+  bool operator()(logid_t,
+                  lsn_t lsn,
+                  const ShardID*,
+                  const copyset_size_t,
+                  const csi_flags_t,
+                  RecordTimestamp,
+                  RecordTimestamp) override {
+    return lsn % keep_one_in_ == 0;
+  }
+
+ private:
+  lsn_t keep_one_in_;
+};
+
+Slice formRecordHeader(lsn_t lsn, size_t payload_size, std::string* buf) {
+  STORE_Header hdr;
+  hdr.rid = RecordID(lsn, LOG_ID);
+  hdr.timestamp = 0;
+  hdr.last_known_good = esn_t(0);
+  hdr.wave = 1;
+  hdr.flags = STORE_Header::CHECKSUM_PARITY;
+  hdr.copyset_size = 4;
+  StoreChainLink chain[4] = {{ShardID(1, 0), ClientID::INVALID},
+                             {ShardID(2, 0), ClientID::INVALID},
+                             {ShardID(3, 0), ClientID::INVALID},
+                             {ShardID(4, 0), ClientID::INVALID}};
+  LocalLogStoreRecordFormat::formRecordHeader(
+      hdr,
+      chain,
+      buf,
+      /* shard_id_in_copyset */ false,
+      std::map<KeyType, std::string>());
+  buf->append(payload_size, 'x');
+  return Slice(buf->data(), buf->size());
+}
+
+Slice formCopySetIndexEntry(std::string* buf) {
+  ShardID copyset[4] = {
+      ShardID(1, 0), ShardID(2, 0), ShardID(3, 0), ShardID(4, 0)};
+  return LocalLogStoreRecordFormat::formCopySetIndexEntry(
+      /* wave */ 1,
+      copyset,
+      /* copyset_size */ 4,
+      LSN_INVALID,
+      LocalLogStoreRecordFormat::formCopySetIndexFlags(0),
+      buf);
+}
+
+std::unique_ptr<TemporaryRocksDBStore> createStore(size_t payload_size) {
+  auto store = std::make_unique<TemporaryRocksDBStore>();
+
+  const size_t n = FLAGS_records_per_log;
+  std::vector<std::string> payloads(n);
+  std::vector<std::string> csi_entries(n);
+  std::vector<PutWriteOp> put_ops;
+  for (size_t i = 0; i < n; ++i) {
+    const lsn_t lsn = i + 1;
+    Slice s = formRecordHeader(lsn, payload_size, &payloads[i]);
+    put_ops.emplace_back(LOG_ID, lsn, s);
+    put_ops.back().copyset_index_entry = formCopySetIndexEntry(&csi_entries[i]);
+    put_ops.back().copyset_index_lsn = LSN_INVALID;
+  }
+
+  std::vector<const WriteOp*> ops;
+  for (auto& x : put_ops) {
+    ops.push_back(&x);
+  }
+  ld_check(store->writeMulti(ops) == 0);
+
+  return store;
+}
+
+// Runs `iters' read() batches round-robin over n_streams read pointers on the
+// same log, restarting a stream from the beginning of the log when it catches
+// up. This is the access pattern of several CatchupOneStreams at different
+// positions in a hot log.
+void readBenchmark(unsigned iters,
+                   size_t payload_size,
+                   bool use_csi,
+                   lsn_t keep_one_in,
+                   size_t n_streams) {
+  std::unique_ptr<TemporaryRocksDBStore> store;
+  std::shared_ptr<LocalLogStoreReadFilter> filter;
+  std::vector<LocalLogStoreReader::ReadPointer> read_ptrs;
+
+  BENCHMARK_SUSPEND {
+    store = createStore(payload_size);
+    if (keep_one_in > 1) {
+      filter = std::make_shared<SelectivityFilter>(keep_one_in);
+    } else {
+      filter = std::make_shared<LocalLogStoreReadFilter>();
+    }
+    // Spread the streams' starting points across the log.
+    for (size_t i = 0; i < n_streams; ++i) {
+      read_ptrs.push_back(
+          {lsn_t(1 + i * FLAGS_records_per_log / n_streams)});
+    }
+  }
+
+  std::vector<RawRecord> records;
+  size_t bytes_read = 0;
+  for (unsigned i = 0; i < iters; ++i) {
+    auto& read_ptr = read_ptrs[i % n_streams];
+    records.clear();
+    const Status st = test::LocalLogStoreTestReader()
+                          .logID(LOG_ID)
+                          .from(read_ptr)
+                          .last_released(FLAGS_records_per_log)
+                          .max_bytes_all_records(FLAGS_bytes_per_batch)
+                          .use_csi(use_csi)
+                          .filter(filter)
+                          .process(store.get(), records, &read_ptr);
+    if (st != E::BYTE_LIMIT_REACHED && st != E::PARTIAL) {
+      // End of log (or a batch entirely filtered out at the end of it);
+      // rewind this stream.
+      read_ptr = {lsn_t(1)};
+    }
+    for (const RawRecord& rec : records) {
+      bytes_read += rec.blob.size;
+    }
+  }
+  folly::doNotOptimizeAway(bytes_read);
+}
+
+} // namespace
+
+BENCHMARK(SmallRecords, iters) {
+  readBenchmark(iters, 128, /* csi */ false, /* keep 1 in */ 1, 1);
+}
+
+BENCHMARK(SmallRecordsCSI, iters) {
+  readBenchmark(iters, 128, /* csi */ true, /* keep 1 in */ 1, 1);
+}
+
+BENCHMARK(LargeRecords, iters) {
+  readBenchmark(iters, 4096, /* csi */ false, /* keep 1 in */ 1, 1);
+}
+
+BENCHMARK(LargeRecordsCSI, iters) {
+  readBenchmark(iters, 4096, /* csi */ true, /* keep 1 in */ 1, 1);
+}
+
+BENCHMARK_DRAW_LINE();
+
+// Selective filters: with CSI the filter runs on the small index entries and
+// skips reading filtered-out records entirely; without it every record is
+// read and then dropped.
+BENCHMARK(SelectiveFilter10, iters) {
+  readBenchmark(iters, 4096, /* csi */ false, /* keep 1 in */ 10, 1);
+}
+
+BENCHMARK(SelectiveFilter10CSI, iters) {
+  readBenchmark(iters, 4096, /* csi */ true, /* keep 1 in */ 10, 1);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(ManyStreams, iters) {
+  readBenchmark(iters, 4096, /* csi */ false, /* keep 1 in */ 1, 16);
+}
+
+BENCHMARK(ManyStreamsCSI, iters) {
+  readBenchmark(iters, 4096, /* csi */ true, /* keep 1 in */ 1, 16);
+}
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  dbg::currentLevel = dbg::Level::ERROR;
+  folly::runBenchmarks();
+  return 0;
+}
@@ -0,0 +1,76 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <gtest/gtest.h>
+
+#include "logdevice/common/debug.h"
+#include "logdevice/common/test/TestUtil.h"
+#include "logdevice/include/Client.h"
+#include "logdevice/test/utils/IntegrationTestBase.h"
+#include "logdevice/test/utils/IntegrationTestUtils.h"
+
+using namespace facebook::logdevice;
+using IntegrationTestUtils::RecoveryBenchmarkOptions;
+using IntegrationTestUtils::RecoveryBenchmarkResult;
+
+/**
+ * Regression gate for sequencer failover recovery latency. Runs the harness
+ * from IntegrationTestUtils over a small sweep of epoch/record distributions
+ * and reports time-to-first-released-append and recovery message counts.
+ * The numbers are logged rather than asserted against absolute thresholds --
+ * track them across releases to catch recovery latency regressions; the test
+ * only fails if a failover doesn't recover at all.
+ */
+class RecoveryBenchmarkTest : public IntegrationTestBase {};
+
+static std::unique_ptr<IntegrationTestUtils::Cluster>
+createCluster(size_t num_logs) {
+  return IntegrationTestUtils::ClusterFactory()
+      .setNumLogs(num_logs)
+      // Make epoch recovery start promptly after the restart.
+      .setParam("--log-state-recovery-interval", "0ms")
+      .create(4);
+}
+
+TEST_F(RecoveryBenchmarkTest, FailoverSweep) {
+  // Fixed number of records spread over increasingly many epochs; recovery
+  // work grows with the number of unclean epochs.
+  const std::vector<RecoveryBenchmarkOptions> sweep = [] {
+    std::vector<RecoveryBenchmarkOptions> res;
+    for (size_t num_epochs : {1, 4, 8}) {
+      RecoveryBenchmarkOptions options;
+      options.num_logs = 2;
+      options.num_epochs = num_epochs;
+      options.records_per_epoch = 80 / num_epochs;
+      res.push_back(options);
+    }
+    return res;
+  }();
+
+  for (const RecoveryBenchmarkOptions& options : sweep) {
+    auto cluster = createCluster(options.num_logs);
+    cluster->waitForRecovery();
+
+    RecoveryBenchmarkResult result;
+    ASSERT_EQ(0,
+              IntegrationTestUtils::runRecoveryBenchmark(
+                  *cluster, options, &result));
+
+    ld_info("recovery benchmark: logs=%lu epochs=%lu records/epoch=%lu: "
+            "time_to_first_released_append=%ldms, "
+            "recovery_messages_received=%lu",
+            options.num_logs,
+            options.num_epochs,
+            options.records_per_epoch,
+            result.time_to_first_released_append.count(),
+            result.recovery_messages_received);
+
+    // Sanity only: recovery completed and actually exchanged messages.
+    EXPECT_GT(result.time_to_first_released_append.count(), 0);
+    EXPECT_GT(result.recovery_messages_received, 0);
+  }
+}
@@ -167,6 +167,10 @@ int BackfillWorker::run() {
     appendCallback(status, record);
   });
 
+  // Align the phase boundaries across workers if a common start time was
+  // given.
+  waitUntilStartTime();
+
   std::unique_lock<std::recursive_mutex> lock(mutex_);
 
   // Warm up. Perform appends at steady write rate until
@@ -174,7 +178,10 @@ int BackfillWorker::run() {
   // in a steady state when we commence the actual benchmark.
   ld_info(
       "Performing warm-up for %" PRIu64 " seconds", options.warmup_duration);
-  end_time_ = Clock::now() + std::chrono::seconds(options.warmup_duration);
+  publishPhaseEvent(BenchPhase::WARMUP);
+  end_time_ = Clock::now() +
+      remainingPhaseTime(BenchPhase::WARMUP,
+                         std::chrono::seconds(options.warmup_duration));
   while (!tryAppend(lock, log_id_dist, append_cb)) {
     /* keep going */
   }
@@ -191,7 +198,10 @@ int BackfillWorker::run() {
           options.duration);
 
   // Perform appends in background thread until options.duration has passed.
-  end_time_ = Clock::now() + std::chrono::seconds(options.duration);
+  publishPhaseEvent(BenchPhase::MEASURE);
+  end_time_ = Clock::now() +
+      remainingPhaseTime(BenchPhase::MEASURE,
+                         std::chrono::seconds(options.duration));
   appender_thread_ = std::make_unique<std::thread>(
       &BackfillWorker::appenderMain, this, append_cb, log_id_dist);
 
@@ -272,7 +282,10 @@ int BackfillWorker::run() {
   // times.
   ld_info("Performing cool-down for %" PRIu64 " seconds",
           options.cooldown_duration);
-  end_time_ = Clock::now() + std::chrono::seconds(options.cooldown_duration);
+  publishPhaseEvent(BenchPhase::COOLDOWN);
+  end_time_ = Clock::now() +
+      remainingPhaseTime(BenchPhase::COOLDOWN,
+                         std::chrono::seconds(options.cooldown_duration));
   while (!tryAppend(lock, log_id_dist, append_cb)) {
     /* keep going */
   }
@@ -8,11 +8,98 @@
 
 #include "logdevice/test/ldbench/worker/BenchStats.h"
 
+#include <algorithm>
 #include <functional>
 #include <iostream>
 
+#include <folly/lang/Bits.h>
+
 namespace facebook { namespace logdevice { namespace ldbench {
 
+size_t LatencyHistogram::valueToIndex(uint64_t value_us) {
+  if (value_us < kSubBuckets) {
+    return value_us;
+  }
+  // Highest set bit decides the power-of-two bucket; the kSubBucketBits bits
+  // below it pick the linear sub-bucket.
+  int msb = folly::findLastSet(value_us) - 1;
+  if (msb >= kMaxValueBits) {
+    return kNumBuckets - 1;
+  }
+  int shift = msb - kSubBucketBits;
+  return kSubBuckets * (msb - kSubBucketBits) + (value_us >> shift);
+}
+
+uint64_t LatencyHistogram::indexToValue(size_t index) {
+  if (index < 2 * kSubBuckets) {
+    // Buckets up to 2^(kSubBucketBits+1) are exact.
+    return index;
+  }
+  int msb = static_cast<int>(index / kSubBuckets) + kSubBucketBits - 1;
+  int shift = msb - kSubBucketBits;
+  uint64_t lower_bound = (index - kSubBuckets * (msb - kSubBucketBits))
+      << shift;
+  return lower_bound + (1ull << shift) / 2;
+}
+
+void LatencyHistogram::add(uint64_t value_us) {
+  counts_[valueToIndex(value_us)].fetch_add(1, std::memory_order_relaxed);
+  total_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::addWithExpectedInterval(uint64_t value_us,
+                                               uint64_t expected_interval_us) {
+  add(value_us);
+  if (expected_interval_us == 0) {
+    return;
+  }
+  uint64_t added = 0;
+  for (uint64_t v = value_us;
+       v > expected_interval_us && added < kMaxSyntheticSamples;
+       ++added) {
+    v -= expected_interval_us;
+    add(v);
+  }
+}
+
+void LatencyHistogram::aggregate(const LatencyHistogram& other) {
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    uint64_t count = other.counts_[i].load(std::memory_order_relaxed);
+    if (count > 0) {
+      counts_[i].fetch_add(count, std::memory_order_relaxed);
+    }
+  }
+  total_.fetch_add(other.total_.load(std::memory_order_relaxed),
+                   std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::totalCount() const {
+  return total_.load(std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::estimatePercentile(double percentile) const {
+  uint64_t total = totalCount();
+  if (total == 0) {
+    return 0;
+  }
+  uint64_t target = std::max<uint64_t>(
+      1, static_cast<uint64_t>(percentile * static_cast<double>(total)));
+  uint64_t seen = 0;
+  size_t last_nonempty = 0;
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    uint64_t count = counts_[i].load(std::memory_order_relaxed);
+    if (count > 0) {
+      seen += count;
+      last_nonempty = i;
+      if (seen >= target) {
+        return indexToValue(i);
+      }
+    }
+  }
+  // Writers may race with the total; fall back to the highest value seen.
+  return indexToValue(last_nonempty);
+}
+
 BenchStats::BenchStats(const std::string& type)
     : success_(0),
       success_byte_(0),
@@ -59,12 +146,18 @@ void BenchStats::incStat(StatsType attr, int64_t num) {
   }
 }
 
+void BenchStats::recordLatency(uint64_t latency_us,
+                               uint64_t expected_interval_us) {
+  latencies_.addWithExpectedInterval(latency_us, expected_interval_us);
+}
+
 void BenchStats::aggregate(const BenchStats& stats) {
   success_ += stats.getAttr(StatsType::SUCCESS);
   success_byte_ += stats.getAttr(StatsType::SUCCESS_BYTE);
   failure_ += stats.getAttr(StatsType::FAILURE);
   skipped_ += stats.getAttr(StatsType::SKIPPED);
   in_flight_ += stats.getAttr(StatsType::INFLIGHT);
+  latencies_.aggregate(stats.latencies_);
   return;
 }
 
@@ -82,6 +175,12 @@ folly::dynamic BenchStats::collectStatsAsPairs() {
   stats_res["fail"] = failure_.load();
   stats_res["skipped"] = skipped_.load();
   stats_res["inflight"] = in_flight_.load();
+  stats_res["latency_count"] = latencies_.totalCount();
+  stats_res["latency_us_p50"] = latencies_.estimatePercentile(0.50);
+  stats_res["latency_us_p95"] = latencies_.estimatePercentile(0.95);
+  stats_res["latency_us_p99"] = latencies_.estimatePercentile(0.99);
+  stats_res["latency_us_p999"] = latencies_.estimatePercentile(0.999);
+  stats_res["latency_us_max"] = latencies_.estimatePercentile(1.0);
   return stats_res;
 }
 
@@ -8,7 +8,10 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 
 #include <folly/ThreadLocal.h>
 #include <folly/dynamic.h>
@@ -21,6 +24,72 @@ namespace facebook { namespace logdevice { namespace ldbench {
 
 enum class StatsType { SUCCESS, SUCCESS_BYTE, FAILURE, INFLIGHT, SKIPPED };
 
+/**
+ * HDR-style latency histogram: values are bucketed by power of two, each
+ * power split into 32 linear sub-buckets, giving a constant ~3% worst-case
+ * relative error across the whole range.  Unlike an equi-depth histogram
+ * built from a small reservoir, percentiles as deep as p99.9 are stable and
+ * comparable across runs.
+ *
+ * Counters are atomic so a thread-local writer and the aggregation thread
+ * can touch the same instance.
+ */
+class LatencyHistogram {
+ public:
+  /**
+   * Record a single latency, in microseconds.  Values too large for the
+   * histogram range (~12 days) are clamped.
+   */
+  void add(uint64_t value_us);
+
+  /**
+   * Record a latency measured by a paced load generator.  When the measured
+   * value exceeds the pacing interval, the requests that should have been
+   * issued while the generator was stuck are recorded too (at value minus
+   * the interval, value minus twice the interval, ...).  This compensates
+   * for coordinated omission: a throttled generator stops measuring during
+   * the worst moments, which understates the tail.
+   *
+   * An expected_interval_us of 0 records just the value.
+   */
+  void addWithExpectedInterval(uint64_t value_us,
+                               uint64_t expected_interval_us);
+
+  /**
+   * Add counts from another histogram into this one.
+   */
+  void aggregate(const LatencyHistogram& other);
+
+  uint64_t totalCount() const;
+
+  /**
+   * Value at the given percentile (0 < percentile <= 1), or 0 if the
+   * histogram is empty.  The result is the midpoint of the bucket the
+   * percentile falls into.
+   */
+  uint64_t estimatePercentile(double percentile) const;
+
+ private:
+  // 32 linear sub-buckets per power of two, the compact log-linear layout
+  // popularized by HdrHistogram.
+  static constexpr int kSubBucketBits = 5;
+  static constexpr uint64_t kSubBuckets = 1ull << kSubBucketBits;
+  // Highest representable value is 2^kMaxValueBits - 1 microseconds.
+  static constexpr int kMaxValueBits = 40;
+  static constexpr size_t kNumBuckets =
+      kSubBuckets * (kMaxValueBits - kSubBucketBits + 1);
+  // Bound on synthetic samples generated by one coordinated-omission
+  // correction, to keep a pathological value/interval pair from stalling
+  // the load generator.
+  static constexpr uint64_t kMaxSyntheticSamples = 100000;
+
+  static size_t valueToIndex(uint64_t value_us);
+  static uint64_t indexToValue(size_t index);
+
+  std::array<std::atomic<uint64_t>, kNumBuckets> counts_{};
+  std::atomic<uint64_t> total_{0};
+};
+
 /**
  * BenchStats defines the stats content and provides access/update operations
  * It will be a thread-local object and managed by BenchStatsHolder
@@ -41,6 +110,13 @@ class BenchStats {
    */
   void incStat(StatsType attr, int64_t num);
 
+  /**
+   * Record the latency of a completed request, with coordinated-omission
+   * correction against the given pacing interval (0 to disable).
+   * @see LatencyHistogram::addWithExpectedInterval()
+   */
+  void recordLatency(uint64_t latency_us, uint64_t expected_interval_us = 0);
+
   /**
    * Aggregate its own attributes with another BenchStats object
    */
@@ -64,6 +140,7 @@ class BenchStats {
   std::atomic<int64_t> in_flight_;    // total number of in-flights records
   std::atomic<int64_t> failure_;      // total number of failed records
   std::atomic<int64_t> skipped_;      // total number of skipped records
+  LatencyHistogram latencies_;        // latencies of completed requests
   std::string type_;                  // request types for different workloads
 };
 
@@ -26,6 +26,58 @@ class BenchStatsTest : public ::testing::Test {
   std::unique_ptr<BenchStats> bench_stats;
 };
 
+TEST(LatencyHistogramTest, percentileAccuracy) {
+  LatencyHistogram hist;
+  // 1..100000us, uniformly: p50 ~ 50000, p99 ~ 99000
+  for (uint64_t v = 1; v <= 100000; ++v) {
+    hist.add(v);
+  }
+  EXPECT_EQ(100000, hist.totalCount());
+  // Buckets are 32 linear sub-buckets per power of two, so estimates are
+  // within ~3.2% of the true value.
+  EXPECT_NEAR(50000, hist.estimatePercentile(0.50), 50000 * 0.04);
+  EXPECT_NEAR(99000, hist.estimatePercentile(0.99), 99000 * 0.04);
+  EXPECT_NEAR(99900, hist.estimatePercentile(0.999), 99900 * 0.04);
+  EXPECT_NEAR(100000, hist.estimatePercentile(1.0), 100000 * 0.04);
+}
+
+TEST(LatencyHistogramTest, coordinatedOmissionCorrection) {
+  LatencyHistogram hist;
+  // One 1000us stall recorded under a 100us pacing interval stands in for
+  // the 9 requests that could not be issued meanwhile.
+  hist.addWithExpectedInterval(1000, 100);
+  EXPECT_EQ(10, hist.totalCount());
+  // The synthetic samples (900, 800, ..., 100) pull the median to ~500.
+  EXPECT_NEAR(500, hist.estimatePercentile(0.50), 500 * 0.05);
+
+  // Without an interval only the value itself is recorded.
+  LatencyHistogram uncorrected;
+  uncorrected.addWithExpectedInterval(1000, 0);
+  EXPECT_EQ(1, uncorrected.totalCount());
+}
+
+TEST(LatencyHistogramTest, aggregation) {
+  LatencyHistogram h1;
+  LatencyHistogram h2;
+  for (int i = 0; i < 1000; ++i) {
+    h1.add(100);
+    h2.add(10000);
+  }
+  h1.aggregate(h2);
+  EXPECT_EQ(2000, h1.totalCount());
+  EXPECT_NEAR(100, h1.estimatePercentile(0.25), 100 * 0.04);
+  EXPECT_NEAR(10000, h1.estimatePercentile(0.75), 10000 * 0.04);
+}
+
+TEST_F(BenchStatsTest, latencyPercentilesInStatsPairs) {
+  bench_stats->recordLatency(1000);
+  bench_stats->recordLatency(2000);
+  folly::dynamic stats_obj = bench_stats->collectStatsAsPairs();
+  EXPECT_EQ(2, stats_obj["latency_count"].asInt());
+  EXPECT_NEAR(1000, stats_obj["latency_us_p50"].asInt(), 1000 * 0.04);
+  EXPECT_NEAR(2000, stats_obj["latency_us_max"].asInt(), 2000 * 0.04);
+}
+
 TEST_F(BenchStatsTest, updateStatsTest) {
   // collect the stats
   folly::dynamic stats_obj = bench_stats->collectStatsAsPairs();
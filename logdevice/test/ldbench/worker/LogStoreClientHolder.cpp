@@ -33,6 +33,13 @@ namespace facebook { namespace logdevice { namespace ldbench {
 
 LogStoreClientHolder::LogStoreClientHolder() {
   bench_stats_holder_ = std::make_shared<BenchStatsHolder>(options.bench_name);
+  if (options.write_rate > 0) {
+    // The configured rate is for the whole worker; under it, one request is
+    // expected every 1/rate seconds. A completion slower than that stalled
+    // the generator, and the latency histogram compensates for the
+    // measurements that were omitted meanwhile.
+    expected_interval_us_ = static_cast<uint64_t>(1e6 / options.write_rate);
+  }
   if (options.publish_dir != "") {
     std::string filename = options.bench_name;
     if (options.restart_backlog_probability > 0) {
@@ -130,6 +137,14 @@ folly::dynamic LogStoreClientHolder::getAllStats() {
   return bench_stats_holder_->aggregateAllStats();
 }
 
+bool LogStoreClientHolder::publishEvent(folly::dynamic event_obj) {
+  if (event_store_ == nullptr) {
+    return false;
+  }
+  event_store_->logEvent(std::move(event_obj));
+  return true;
+}
+
 std::shared_ptr<void> LogStoreClientHolder::getRawClient() {
   return client_->getRawClient();
 }
@@ -168,6 +183,19 @@ void LogStoreClientHolder::doSample(LogIDType log_id,
   bench_tracer_->doSample(event_record);
 }
 
+void LogStoreClientHolder::recordLatency(const std::string& payload_str) {
+  RecordWriterInfo info;
+  Payload payload(payload_str.c_str(), payload_str.size());
+  if (info.deserialize(payload) != 0) {
+    return;
+  }
+  auto now_us = std::chrono::time_point_cast<std::chrono::microseconds>(
+      std::chrono::system_clock::now());
+  uint64_t lat_us = (now_us - info.client_timestamp).time_since_epoch().count();
+  bench_stats_holder_->getOrCreateTLStats()->recordLatency(
+      lat_us, expected_interval_us_);
+}
+
 void LogStoreClientHolder::onAppendDone(bool successful,
                                         LogIDType log_id,
                                         LogPositionType lsn,
@@ -185,11 +213,11 @@ void LogStoreClientHolder::onAppendDone(bool successful,
   for (auto it = contexts.begin(); it != contexts.end(); it++) {
     const std::string& payload = std::get<std::string>(it->second);
     payload_size += payload.size();
-    // start to sample event
-    // Current example is sampling latency
-    if (bench_tracer_) {
-      if (successful && options.record_writer_info &&
-          bench_tracer_->isSample()) {
+    if (successful && options.record_writer_info) {
+      // Every completion feeds the latency histogram; the event store only
+      // gets a sampled subset.
+      recordLatency(payload);
+      if (bench_tracer_ && bench_tracer_->isSample()) {
         std::string event_name =
             options.use_buffered_writer ? "bufferedWriter" : "Writer";
         doSample(log_id, lsn, payload, event_name);
@@ -226,8 +254,9 @@ void LogStoreClientHolder::onReadDone(bool successful,
     bench_stats_holder_->getOrCreateTLStats()->incStat(
         StatsType::FAILURE, num_records);
   }
-  if (bench_tracer_) {
-    if (successful && options.record_writer_info && bench_tracer_->isSample()) {
+  if (successful && options.record_writer_info) {
+    recordLatency(payload);
+    if (bench_tracer_ && bench_tracer_->isSample()) {
       doSample(log_id, lsn, payload, options.bench_name);
     }
   }
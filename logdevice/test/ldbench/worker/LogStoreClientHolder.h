@@ -73,6 +73,15 @@ class LogStoreClientHolder {
    */
   folly::dynamic getAllStats();
 
+  /**
+   * Write an arbitrary event object to the event store, bypassing
+   * sampling. Used for rare but important events such as benchmark phase
+   * transitions.
+   *
+   * @return false if no event store is configured, true otherwise.
+   */
+  bool publishEvent(folly::dynamic event_obj);
+
   /**
    * Get pointer to the implementation-specific client object.
    * E.g. logdevice::Client or RdKafka::Producer."
@@ -138,6 +147,13 @@ class LogStoreClientHolder {
                 const std::string& payload,
                 std::string& event_name);
 
+  /**
+   * Extract the writer timestamp from the payload and record the end-to-end
+   * latency into the thread-local BenchStats, with coordinated-omission
+   * correction against the configured write rate.
+   */
+  void recordLatency(const std::string& payload);
+
   // Explaination of define order
   // callbacks of client use everything so client go first
   // bench_tracer uses event_store
@@ -149,5 +165,9 @@ class LogStoreClientHolder {
   std::shared_ptr<EventStore> event_store_;
   std::unique_ptr<BenchTracer> bench_tracer_;
   std::unique_ptr<LogStoreClient> client_;
+  // Pacing interval implied by the configured write rate, used for
+  // coordinated-omission correction of latency percentiles. 0 disables the
+  // correction.
+  uint64_t expected_interval_us_{0};
 };
 }}} // namespace facebook::logdevice::ldbench
@@ -509,6 +509,16 @@ void Options::get_named_options(options_description& named) {
             }
           }),
       "Like --max-appends-in-flight but in bytes.");
+  named.add_options()(
+      "appends-in-flight-auto",
+      value<bool>(&appends_in_flight_auto)->default_value(false),
+      "Size the in-flight append window automatically from the measured "
+      "append throughput and completion latency (bandwidth-delay product), "
+      "like TCP BBR, instead of using the static --max-appends-in-flight "
+      "limit. --max-appends-in-flight then only acts as an upper cap. "
+      "Removes the need to tune the window per cluster: too small a static "
+      "window leaves the link idle, too large a one queues appends into "
+      "timeouts.");
   named.add_options()("use-buffered-writer",
                       value<bool>(&use_buffered_writer)->default_value(false),
                       "Append using BufferedWriter.");
@@ -550,6 +560,25 @@ void Options::get_named_options(options_description& named) {
       "compression on client followed by additional ~2x compression in "
       "sequencer; this can be simulated with --payload-entropy=0.455 "
       "--payload-entropy-sequencer=0.5");
+  named.add_options()(
+      "replay-trace-path",
+      value<std::string>(&replay_trace_path)->default_value(""),
+      "Path to the append trace to replay, one append per line: "
+      "\"<offset_ms> <log_id> <payload_size>\". Lines starting with '#' are "
+      "ignored. Required for the 'replay' bench.");
+  named.add_options()(
+      "replay-time-scale",
+      value<double>(&replay_time_scale)
+          ->default_value(1.0)
+          ->notifier([](double val) {
+            if (val <= 0) {
+              throw boost::program_options::error(
+                  "--replay-time-scale must be positive");
+            }
+          }),
+      "Multiplier applied to the time offsets in the trace. Values below 1 "
+      "replay the trace faster than it was captured, e.g. 0.5 replays at "
+      "twice the original throughput.");
   named.add_options()(
       "meta-requests-per-sec",
       value<uint64_t>(&meta_requests_per_sec)->default_value(100),
@@ -119,11 +119,16 @@ struct Options {
   Log2Histogram log_payload_size_distribution;
   uint64_t max_appends_in_flight;
   uint64_t max_append_bytes_in_flight;
+  bool appends_in_flight_auto;
   bool use_buffered_writer;
   BufferedWriter::Options buffered_writer_options;
   double payload_entropy;
   double payload_entropy_sequencer;
 
+  // Options of "replay" bench.
+  std::string replay_trace_path;
+  double replay_time_scale;
+
   // Options of metadata API benchmarks.
   uint64_t meta_requests_per_sec;
   Spikiness meta_requests_spikiness;
@@ -169,14 +169,21 @@ int ReadYourWriteLatencyWorker::run() {
     return 1;
   }
 
+  // Align the phase boundaries across workers if a common start time was
+  // given.
+  waitUntilStartTime();
+
   // Warm up. Perform appends at steady write rate until
   // options.warmup_duration has passed. This is to make sure the servers are
   // in a steady state when we commence the actual benchmark.
   ld_info(
       "Performing warm-up for %" PRIu64 " seconds", options.warmup_duration);
+  publishPhaseEvent(BenchPhase::WARMUP);
   std::unique_lock<std::recursive_mutex> lock(mutex_);
   TimePoint start_time = Clock::now();
-  end_time_ = start_time + std::chrono::seconds(options.warmup_duration);
+  end_time_ = start_time +
+      remainingPhaseTime(BenchPhase::WARMUP,
+                         std::chrono::seconds(options.warmup_duration));
   while (!tryAppend(lock, log_id_dist, append_cb)) {
     /* keep going */
   }
@@ -187,8 +194,11 @@ int ReadYourWriteLatencyWorker::run() {
   ld_info("Performing read-your-write latency benchmark for %" PRIu64 " "
           "seconds",
           options.duration);
+  publishPhaseEvent(BenchPhase::MEASURE);
   collect_samples_ = true;
-  end_time_ = Clock::now() + std::chrono::seconds(options.duration);
+  end_time_ = Clock::now() +
+      remainingPhaseTime(BenchPhase::MEASURE,
+                         std::chrono::seconds(options.duration));
   while (!tryAppend(lock, log_id_dist, append_cb)) {
     /* keep going */
   }
@@ -203,7 +213,10 @@ int ReadYourWriteLatencyWorker::run() {
   // times.
   ld_info("Performing cool-down for %" PRIu64 " seconds",
           options.cooldown_duration);
-  end_time_ = Clock::now() + std::chrono::seconds(options.cooldown_duration);
+  publishPhaseEvent(BenchPhase::COOLDOWN);
+  end_time_ = Clock::now() +
+      remainingPhaseTime(BenchPhase::COOLDOWN,
+                         std::chrono::seconds(options.cooldown_duration));
   while (!tryAppend(lock, log_id_dist, append_cb)) {
     /* keep going */
   }
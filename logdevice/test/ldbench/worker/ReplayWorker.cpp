@@ -0,0 +1,318 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <folly/Optional.h>
+#include <folly/String.h>
+#include <folly/hash/Hash.h>
+
+#include "logdevice/common/debug.h"
+#include "logdevice/include/Err.h"
+#include "logdevice/include/Record.h"
+#include "logdevice/include/types.h"
+#include "logdevice/test/ldbench/worker/Options.h"
+#include "logdevice/test/ldbench/worker/Worker.h"
+#include "logdevice/test/ldbench/worker/WorkerRegistry.h"
+
+namespace facebook { namespace logdevice { namespace ldbench {
+namespace {
+
+static constexpr const char* BENCH_NAME = "replay";
+
+/**
+ * Trace replay benchmark worker.
+ *
+ * Replays a previously captured append trace against the configured logs,
+ * preserving the relative timing and payload sizes of the original workload.
+ * Unlike the synthetic workers, which draw log ids and payload sizes from
+ * analytic distributions, this reproduces the skew of a real workload:
+ * hot logs stay hot, bursts stay bursty.
+ *
+ * The trace is a text file with one append per line:
+ *
+ *   <offset_ms> <log_id> <payload_size>
+ *
+ * where offset_ms is milliseconds since the start of the trace. Empty lines
+ * and lines starting with '#' are ignored. Trace log ids are mapped onto the
+ * configured logs by hashing, so a trace can be replayed against a cluster
+ * with a different log range as long as the number of logs is comparable.
+ *
+ * --replay-time-scale stretches or compresses the trace timeline; values
+ * below 1 replay the trace faster than it was captured.
+ */
+class ReplayWorker final : public Worker {
+ public:
+  using Worker::Worker;
+  ~ReplayWorker() override;
+  int run() override;
+
+ private:
+  struct TraceEntry {
+    std::chrono::milliseconds offset;
+    uint64_t trace_log_id;
+    uint64_t payload_size;
+  };
+
+  bool loadTrace(std::vector<TraceEntry>& entries_out);
+  bool waitUntil(std::unique_lock<std::mutex>& lock,
+                 std::chrono::steady_clock::time_point target);
+  void appendCallback(Status status, const DataRecord& record);
+  inline bool error() const noexcept;
+  inline bool errorOrStopped() const noexcept;
+
+  std::mutex mutex_;
+  std::condition_variable cond_var_;
+  uint64_t nsuccess_ = 0;
+  uint64_t nerrors_ = 0;
+  uint64_t npending_ = 0;
+  uint64_t nlate_ = 0;
+};
+
+ReplayWorker::~ReplayWorker() {
+  // Make sure no callbacks are called after this subclass is destroyed.
+  destroyClient();
+}
+
+bool ReplayWorker::loadTrace(std::vector<TraceEntry>& entries_out) {
+  if (options.replay_trace_path.empty()) {
+    ld_error("--replay-trace-path is required for the replay bench.");
+    return true;
+  }
+  std::ifstream in(options.replay_trace_path);
+  if (!in) {
+    ld_error(
+        "Failed to open trace file: %s", options.replay_trace_path.c_str());
+    return true;
+  }
+  std::string line;
+  uint64_t line_no = 0;
+  while (std::getline(in, line)) {
+    ++line_no;
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    uint64_t offset_ms;
+    TraceEntry entry;
+    if (!folly::split(
+            ' ', line, offset_ms, entry.trace_log_id, entry.payload_size)) {
+      ld_error("Malformed line %" PRIu64 " in trace file %s, expected "
+               "\"<offset_ms> <log_id> <payload_size>\": %s",
+               line_no,
+               options.replay_trace_path.c_str(),
+               line.c_str());
+      return true;
+    }
+    entry.offset = std::chrono::milliseconds(
+        static_cast<uint64_t>(offset_ms * options.replay_time_scale));
+    entries_out.push_back(entry);
+  }
+  // Traces captured from multiple sequencers may not be globally ordered.
+  std::stable_sort(entries_out.begin(),
+                   entries_out.end(),
+                   [](const TraceEntry& lhs, const TraceEntry& rhs) {
+                     return lhs.offset < rhs.offset;
+                   });
+  return false;
+}
+
+bool ReplayWorker::waitUntil(std::unique_lock<std::mutex>& lock,
+                             std::chrono::steady_clock::time_point target) {
+  // Wait until `target`, the window opening and, if end of benchmark was
+  // requested, until `target` is before the end. We need to wake up every
+  // second to poll for isStopped() in errorOrStopped(), because stop() is an
+  // async-safe function. It cannot signal the condition variable.
+  for (;;) {
+    auto now = std::chrono::steady_clock::now();
+    auto wakeup_time = std::min(now + std::chrono::seconds(1), target);
+    cond_var_.wait_until(lock, wakeup_time, [this] {
+      return errorOrStopped() || npending_ < options.max_appends_in_flight;
+    });
+    if (errorOrStopped()) {
+      return true;
+    }
+    if (std::chrono::steady_clock::now() >= target &&
+        npending_ < options.max_appends_in_flight) {
+      return false;
+    }
+  }
+}
+
+int ReplayWorker::run() {
+  std::vector<logid_t> all_logs;
+  if (getLogs(all_logs)) {
+    return 1;
+  }
+  if (all_logs.empty()) {
+    ld_error("No logs.");
+    return 1;
+  }
+
+  std::vector<TraceEntry> entries;
+  if (loadTrace(entries)) {
+    return 1;
+  }
+  ld_info("Loaded %lu trace entries from %s",
+          entries.size(),
+          options.replay_trace_path.c_str());
+
+  // The partition of logs this worker is responsible for, in LOG mode.
+  std::vector<logid_t> my_logs = options.partition_by == PartitioningMode::LOG
+      ? getLogsPartition(all_logs)
+      : all_logs;
+  std::sort(my_logs.begin(), my_logs.end());
+
+  // Callback for use with Client::append. Created once for efficiency.
+  append_callback_t cb([this](Status status, const DataRecord& record) {
+    appendCallback(status, record);
+  });
+
+  // Align the trace origin across workers if a common start time was given.
+  waitUntilStartTime();
+  publishPhaseEvent(BenchPhase::MEASURE);
+
+  auto base_time = std::chrono::steady_clock::now();
+  folly::Optional<std::chrono::steady_clock::time_point> end_time;
+  if (options.duration >= 0) {
+    end_time = base_time + std::chrono::seconds(options.duration);
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  uint64_t nreplayed = 0;
+  for (uint64_t i = 0; i < entries.size(); ++i) {
+    const TraceEntry& entry = entries[i];
+    // Map the trace log id onto the configured logs deterministically, so
+    // that all appends of one production log land on one benchmark log and
+    // the per-log skew of the trace is preserved.
+    logid_t log_id = all_logs[folly::hash::twang_mix64(entry.trace_log_id) %
+                              all_logs.size()];
+    // Partition the trace among workers.
+    if (options.partition_by == PartitioningMode::LOG) {
+      if (!std::binary_search(my_logs.begin(), my_logs.end(), log_id)) {
+        continue;
+      }
+    } else if (i % options.worker_id_count != options.worker_id_index) {
+      // RECORD mode: round-robin over trace entries.
+      continue;
+    }
+    auto target = base_time + entry.offset;
+    if (end_time.has_value() && target >= end_time.value()) {
+      ld_info("Reached --duration before the end of the trace, stopping "
+              "after %" PRIu64 " appends.",
+              nreplayed);
+      break;
+    }
+    if (waitUntil(lock, target)) {
+      // Fatal error or stop requested.
+      break;
+    }
+    if (std::chrono::steady_clock::now() - target >
+        std::chrono::milliseconds(100)) {
+      // We fell more than 100ms behind the (scaled) trace timeline; the
+      // result no longer reflects the traced workload. Keep going but count
+      // it, so the summary shows how faithful the replay was.
+      ++nlate_;
+    }
+    if (!tryAppend(log_id, generatePayload(entry.payload_size), cb)) {
+      ++npending_;
+      ++nreplayed;
+    } else {
+      ++nerrors_;
+      RATELIMIT_ERROR(std::chrono::seconds(10),
+                      1,
+                      "Append failed synchronously: %s (%s), "
+                      "nerrors=%" PRIu64,
+                      error_name(err),
+                      error_description(err),
+                      nerrors_);
+    }
+  }
+  auto actual_end_time = std::chrono::steady_clock::now();
+
+  // Wait for pending appends (otherwise the callbacks may crash).
+  ld_info("Waiting for pending appends: npending=%" PRIu64, npending_);
+  cond_var_.wait(lock, [this] { return npending_ == 0; });
+
+  ld_info("Replay complete: nreplayed=%" PRIu64 ", nsuccess=%" PRIu64
+          ", nerrors=%" PRIu64 ", nlate=%" PRIu64,
+          nreplayed,
+          nsuccess_,
+          nerrors_,
+          nlate_);
+  if (!error()) {
+    auto actual_duration_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(actual_end_time -
+                                                              base_time)
+            .count();
+    std::cout << actual_duration_ms << ' ' << nsuccess_ << ' ' << nerrors_
+              << ' ' << nlate_ << '\n';
+  }
+
+  // Return 1 if fatal error occurred, 0 otherwise.
+  return error();
+}
+
+void ReplayWorker::appendCallback(Status st, const DataRecord&) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  --npending_;
+  if (st == E::OK) {
+    ++nsuccess_;
+  } else {
+    ++nerrors_;
+    RATELIMIT_ERROR(std::chrono::seconds(10),
+                    1,
+                    "Append failed: %s (%s), nerrors=%" PRIu64,
+                    error_name(st),
+                    error_description(st),
+                    nerrors_);
+  }
+  lock.unlock();
+
+  // Notify main thread in waitUntil() or run().
+  cond_var_.notify_one();
+}
+
+bool ReplayWorker::error() const noexcept {
+  return !options.ignore_errors && (nerrors_ > 0);
+}
+
+bool ReplayWorker::errorOrStopped() const noexcept {
+  return error() || isStopped();
+}
+
+} // namespace
+
+void registerReplayWorker() {
+  registerWorkerImpl(BENCH_NAME,
+                     []() -> std::unique_ptr<Worker> {
+                       return std::make_unique<ReplayWorker>();
+                     },
+                     OptionsRestrictions(
+                         {
+                             "pretend",
+                             "duration",
+                             "replay-trace-path",
+                             "replay-time-scale",
+                             "max-appends-in-flight",
+                             "start-time",
+                             "record-writer-info",
+                         },
+                         {PartitioningMode::LOG, PartitioningMode::RECORD}));
+}
+
+}}} // namespace facebook::logdevice::ldbench
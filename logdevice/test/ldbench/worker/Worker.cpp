@@ -15,9 +15,11 @@
 #include <thread>
 #include <time.h>
 
+#include <folly/Conv.h>
 #include <folly/Hash.h>
 #include <folly/Random.h>
 #include <folly/Range.h>
+#include <folly/dynamic.h>
 #include <folly/synchronization/Baton.h>
 
 #include "logdevice/common/ReadStreamAttributes.h"
@@ -369,6 +371,74 @@ void Worker::waitUntilStartTime() {
             << std::endl;
 }
 
+namespace {
+const char* phaseName(Worker::BenchPhase phase) {
+  switch (phase) {
+    case Worker::BenchPhase::WARMUP:
+      return "warmup";
+    case Worker::BenchPhase::MEASURE:
+      return "measure";
+    case Worker::BenchPhase::COOLDOWN:
+      return "cooldown";
+  }
+  return "unknown";
+}
+} // namespace
+
+std::chrono::milliseconds
+Worker::remainingPhaseTime(BenchPhase phase,
+                           std::chrono::milliseconds fallback) {
+  if (options.start_time.toMilliseconds().count() <= 0 ||
+      options.duration <= 0) {
+    // No common epoch (or an open-ended run): keep the local-timer
+    // behavior.
+    return fallback;
+  }
+  auto boundary = options.start_time.timePoint() +
+      std::chrono::seconds(options.warmup_duration);
+  if (phase == BenchPhase::MEASURE || phase == BenchPhase::COOLDOWN) {
+    boundary += std::chrono::seconds(options.duration);
+  }
+  if (phase == BenchPhase::COOLDOWN) {
+    boundary += std::chrono::seconds(options.cooldown_duration);
+  }
+  auto now = std::chrono::system_clock::now();
+  if (boundary <= now) {
+    return std::chrono::milliseconds(0);
+  }
+  return std::chrono::duration_cast<std::chrono::milliseconds>(boundary - now);
+}
+
+void Worker::publishPhaseEvent(BenchPhase phase) {
+  if (client_holder_ == nullptr) {
+    return;
+  }
+  // Offset between the actual transition and the common boundary; analysis
+  // tooling uses it to verify alignment and trim ragged edges.
+  int64_t skew_ms = 0;
+  if (options.start_time.toMilliseconds().count() > 0 &&
+      options.duration > 0) {
+    auto boundary = options.start_time.timePoint();
+    if (phase == BenchPhase::MEASURE || phase == BenchPhase::COOLDOWN) {
+      boundary += std::chrono::seconds(options.warmup_duration);
+    }
+    if (phase == BenchPhase::COOLDOWN) {
+      boundary += std::chrono::seconds(options.duration);
+    }
+    skew_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                  std::chrono::system_clock::now() - boundary)
+                  .count();
+  }
+  auto now_ms = SystemTimestamp::now().toMilliseconds().count();
+  folly::dynamic event_obj = folly::dynamic::object();
+  event_obj["timestamp"] = now_ms;
+  event_obj["eventid"] = folly::to<std::string>(
+      options.worker_id_index, "-", phaseName(phase));
+  event_obj["type"] = "phase";
+  event_obj["value"] = skew_ms;
+  client_holder_->publishEvent(std::move(event_obj));
+}
+
 void Worker::destroyClient() {
   reader_.reset();
   if (client_) {
@@ -467,7 +537,21 @@ std::chrono::milliseconds Worker::sleepForDurationOfTheBench() {
   auto start_time = std::chrono::steady_clock::now();
   auto end_time = std::chrono::steady_clock::time_point::max();
   if (options.duration > 0) {
-    end_time = start_time + std::chrono::seconds(options.duration);
+    auto run_for = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::seconds(options.duration));
+    if (options.start_time.toMilliseconds().count() > 0) {
+      // A common start time was given: end at the wall-clock boundary all
+      // workers derive from it, so that workers across hosts stop together
+      // even if some of them started late.
+      auto boundary = options.start_time.timePoint() +
+          std::chrono::seconds(options.duration);
+      auto now = std::chrono::system_clock::now();
+      run_for = boundary > now
+          ? std::chrono::duration_cast<std::chrono::milliseconds>(boundary -
+                                                                  now)
+          : std::chrono::milliseconds(0);
+    }
+    end_time = start_time + run_for;
   }
 
   const auto print_progress_every = std::chrono::seconds(1);
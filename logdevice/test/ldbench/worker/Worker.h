@@ -90,6 +90,30 @@ class Worker : private boost::noncopyable {
    */
   void waitUntilStartTime();
 
+  // Benchmark phases, in chronological order.
+  enum class BenchPhase { WARMUP, MEASURE, COOLDOWN };
+
+  /**
+   * Returns how much longer the given phase should run so that it ends at
+   * the wall-clock boundary that all workers derive from --start-time and
+   * the warmup/duration/cooldown options. Workers launched on different
+   * hosts with the same --start-time therefore switch phases
+   * simultaneously, which keeps the edges of the measurement window clean
+   * in multi-host runs. Returns `fallback` (the historical local-timer
+   * behavior) when --start-time was not given or the run is open-ended.
+   */
+  std::chrono::milliseconds
+  remainingPhaseTime(BenchPhase phase, std::chrono::milliseconds fallback);
+
+  /**
+   * Publishes a phase-transition event to the event store, if one is
+   * configured, so that analysis tooling can verify phase alignment
+   * across workers and trim ragged edges. The event value is the offset
+   * in milliseconds between the actual transition and the common
+   * wall-clock boundary (0 when phases are not time-aligned).
+   */
+  void publishPhaseEvent(BenchPhase phase);
+
   /**
    * Destroys Client.
    * Call this to make sure no more Client callbacks will be called.
@@ -25,6 +25,7 @@ const WorkerFactoryMap& getWorkerFactoryMap() {
   registerReadYourWriteLatencyWorker();
   registerWriteSaturationWorker();
   registerIsLogEmptyWorker();
+  registerReplayWorker();
   registerFindTimeWorker();
 
   return getWorkerFactoryMapImpl();
@@ -66,6 +66,7 @@ void registerBackfillWorker();
 void registerReadYourWriteLatencyWorker();
 void registerWriteSaturationWorker();
 void registerIsLogEmptyWorker();
+void registerReplayWorker();
 void registerFindTimeWorker();
 
 } // namespace ldbench
@@ -159,15 +159,21 @@ int WriteSaturationWorker::run() {
     appendCallback(status, record);
   });
 
+  // Align the phase boundaries across workers if a common start time was
+  // given.
+  waitUntilStartTime();
+
   // Warm up. Perform appends until warmup_duration has passed. The purpose of
   // this is to make sure the servers are in a steady state when we commence
   // the actual benchmark.
   ld_info(
       "Performing warm-up for %" PRIu64 " seconds", options.warmup_duration);
+  publishPhaseEvent(BenchPhase::WARMUP);
   std::unique_lock<std::mutex> lock(mutex_);
   window_ = std::max<uint64_t>(options.init_window, 1);
   end_time_ = std::chrono::steady_clock::now() +
-      std::chrono::seconds(options.warmup_duration);
+      remainingPhaseTime(BenchPhase::WARMUP,
+                         std::chrono::seconds(options.warmup_duration));
   while (!tryAppend(lock, logs, cb)) {
     /* keep going */
   }
@@ -178,10 +184,13 @@ int WriteSaturationWorker::run() {
   // Actual benchmark. Perform appends until duration has passed.
   ld_info("Performing write saturation benchmark for %" PRIi64 " seconds",
           options.duration);
+  publishPhaseEvent(BenchPhase::MEASURE);
   npushbacks_ = nsuccess_ = 0;
   start_time_ = std::chrono::steady_clock::now();
   if (options.duration >= 0) {
-    end_time_ = start_time_ + std::chrono::seconds(options.duration);
+    end_time_ = start_time_ +
+        remainingPhaseTime(BenchPhase::MEASURE,
+                           std::chrono::seconds(options.duration));
   } else {
     end_time_.reset();
   }
@@ -208,9 +217,11 @@ int WriteSaturationWorker::run() {
   // at slightly different times.
   ld_info("Performing cool-down for %" PRIu64 " seconds",
           options.cooldown_duration);
+  publishPhaseEvent(BenchPhase::COOLDOWN);
   npushbacks_ = nsuccess_ = 0;
   end_time_ = std::chrono::steady_clock::now() +
-      std::chrono::seconds(options.cooldown_duration);
+      remainingPhaseTime(BenchPhase::COOLDOWN,
+                         std::chrono::seconds(options.cooldown_duration));
   while (!tryAppend(lock, logs, cb)) {
     /* keep going */
   }
@@ -6,6 +6,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <deque>
 #include <iostream>
 
 #include "logdevice/common/LibeventTimer.h"
@@ -49,6 +50,17 @@ class WriteWorker final : public Worker {
 
   void updateThroughput();
 
+  // One tick of the adaptive in-flight window (--appends-in-flight-auto).
+  // Runs on the event loop every kWindowTick.
+  void adaptWindow();
+
+  // Current limit on the number of in-flight appends: the adaptive window
+  // when --appends-in-flight-auto is set, --max-appends-in-flight otherwise.
+  uint64_t appendsInFlightLimit() const {
+    return options.appends_in_flight_auto ? appends_in_flight_limit_.load()
+                                          : options.max_appends_in_flight;
+  }
+
   void onAppendDone(LogIDType log_id,
                     bool successful,
                     bool buffered,
@@ -80,6 +92,26 @@ class WriteWorker final : public Worker {
   std::atomic<uint64_t> bytes_ok_since_last_call_{0};
   LibeventTimer next_increase_throughput_timer_;
   uint64_t increase_count_;
+
+  // State of the adaptive in-flight window, only used when
+  // --appends-in-flight-auto is set. All fields except the atomic limit are
+  // touched only from the event loop, see adaptWindow().
+  static constexpr std::chrono::milliseconds kWindowTick{100};
+  static constexpr double kWindowGain = 2.0;       // headroom over the BDP
+  static constexpr double kBandwidthWindow = 2.0;  // seconds
+  static constexpr double kRttWindow = 10.0;       // seconds
+  static constexpr double kRttProbeInterval = 10.0; // seconds
+  static constexpr uint64_t kMinWindow = 2;
+
+  std::atomic<uint64_t> appends_in_flight_limit_{kMinWindow};
+  LibeventTimer adapt_window_timer_;
+  uint64_t appends_completed_at_last_tick_{0};
+  double last_window_tick_time_{0};
+  // Windowed estimators: (sample time, value) pairs, expired by age.
+  std::deque<std::pair<double, double>> bandwidth_samples_;
+  std::deque<std::pair<double, double>> rtt_samples_;
+  double last_rtt_probe_time_{0};
+  bool in_rtt_probe_{false};
 };
 
 static double steadyTime() {
@@ -280,7 +312,7 @@ void WriteWorker::maybeAppend(LogState* state) {
     client_holder_->getBenchStatsHolder()->getOrCreateTLStats()->incStat(
         StatsType::SKIPPED, 1);
     return;
-  } else if (appends_in_flight_.load() >= options.max_appends_in_flight) {
+  } else if (appends_in_flight_.load() >= appendsInFlightLimit()) {
     ++appends_skipped_;
     STAT_INCR(stats_.get(), ldbench->writer_appends_skipped_appends_in_flight);
     client_holder_->getBenchStatsHolder()->getOrCreateTLStats()->incStat(
@@ -330,6 +362,76 @@ void WriteWorker::maybeAppend(LogState* state) {
   }
 }
 
+void WriteWorker::adaptWindow() {
+  adapt_window_timer_.activate(kWindowTick);
+
+  double now = steadyTime();
+  uint64_t completed = appends_succeeded_.load() + appends_failed_.load();
+  uint64_t delivered = completed - appends_completed_at_last_tick_;
+  double dt = now - last_window_tick_time_;
+  appends_completed_at_last_tick_ = completed;
+  last_window_tick_time_ = now;
+
+  auto expire = [now](std::deque<std::pair<double, double>>& q, double age) {
+    while (!q.empty() && q.front().first < now - age) {
+      q.pop_front();
+    }
+  };
+  expire(bandwidth_samples_, kBandwidthWindow);
+  expire(rtt_samples_, kRttWindow);
+
+  if (delivered > 0 && dt > 0) {
+    // Appends don't carry individual timestamps through the client, so
+    // estimate both sides of the bandwidth-delay product from aggregate
+    // counters: completions per second give the bandwidth, and Little's law
+    // (time in flight = in flight / throughput) gives the round-trip time.
+    double bandwidth = delivered / dt;
+    bandwidth_samples_.emplace_back(now, bandwidth);
+    uint64_t in_flight = appends_in_flight_.load();
+    if (in_flight > 0) {
+      rtt_samples_.emplace_back(now, in_flight / bandwidth);
+    }
+  }
+
+  // An RTT measured while the window is full includes our own queueing
+  // delay. Periodically shrink the window to kMinWindow for one tick so the
+  // pipeline drains and the next sample observes the intrinsic round-trip
+  // time, like BBR's PROBE_RTT phase.
+  if (in_rtt_probe_) {
+    in_rtt_probe_ = false;
+  } else if (now - last_rtt_probe_time_ > kRttProbeInterval) {
+    last_rtt_probe_time_ = now;
+    in_rtt_probe_ = true;
+    appends_in_flight_limit_.store(
+        std::min(appends_in_flight_limit_.load(), kMinWindow));
+    STAT_SET(stats_.get(),
+             ldbench->writer_appends_in_flight_limit,
+             appends_in_flight_limit_.load());
+    return;
+  }
+
+  if (bandwidth_samples_.empty() || rtt_samples_.empty()) {
+    return;
+  }
+  double max_bandwidth = 0;
+  for (const auto& s : bandwidth_samples_) {
+    max_bandwidth = std::max(max_bandwidth, s.second);
+  }
+  double min_rtt = std::numeric_limits<double>::max();
+  for (const auto& s : rtt_samples_) {
+    min_rtt = std::min(min_rtt, s.second);
+  }
+
+  // The window covers one bandwidth-delay product of appends with some gain
+  // so the estimators can observe bandwidth growing; the static limit stays
+  // on as an upper cap.
+  uint64_t window = std::max<uint64_t>(
+      kMinWindow, (uint64_t)(kWindowGain * max_bandwidth * min_rtt + 0.5));
+  window = std::min(window, options.max_appends_in_flight);
+  appends_in_flight_limit_.store(window);
+  STAT_SET(stats_.get(), ldbench->writer_appends_in_flight_limit, window);
+}
+
 // Produces probability distribution for per-log payload size multiplier,
 // i.e. how big the payloads in this log should be on average, relative to
 // global average payload size.
@@ -522,6 +624,15 @@ int WriteWorker::run() {
           options.write_bytes_increase_interval);
     }
 
+    if (options.appends_in_flight_auto) {
+      appends_in_flight_limit_.store(
+          std::min(options.max_appends_in_flight, uint64_t(100)));
+      last_window_tick_time_ = steadyTime();
+      last_rtt_probe_time_ = last_window_tick_time_;
+      adapt_window_timer_.assign(&ev_->getEvBase(), [this] { adaptWindow(); });
+      adapt_window_timer_.activate(kWindowTick);
+    }
+
     if (!options.pretend) {
       ld_info("Starting appends in %lu logs", logs_.size());
     }
@@ -538,6 +649,9 @@ int WriteWorker::run() {
     if (next_increase_throughput_timer_.isActive()) {
       next_increase_throughput_timer_.cancel();
     }
+    if (adapt_window_timer_.isActive()) {
+      adapt_window_timer_.cancel();
+    }
     for (auto& kv : logs_) {
       kv.second->next_append_timer.cancel();
     }
@@ -576,6 +690,7 @@ void registerWriteWorker() {
                              "log-payload-size-distribution",
                              "max-appends-in-flight",
                              "max-append-bytes-in-flight",
+                             "appends-in-flight-auto",
                              "use-buffered-writer",
                              "payload-entropy",
                              "payload-entropy-sequencer",
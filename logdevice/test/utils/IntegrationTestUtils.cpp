@@ -3883,6 +3883,130 @@ Status getSeqState(Client* client,
   return st;
 }
 
+// Sums up the number of received messages belonging to the phases of epoch
+// recovery on the given node. See
+// RecoveryBenchmarkResult::recovery_messages_received.
+static size_t countRecoveryMessages(Node& node) {
+  static const char* kMessageTypes[] = {"SEAL",
+                                        "SEALED",
+                                        "START",
+                                        "STARTED",
+                                        "MUTATED",
+                                        "CLEAN",
+                                        "CLEANED",
+                                        "GET_EPOCH_RECOVERY_METADATA",
+                                        "GET_EPOCH_RECOVERY_METADATA_REPLY"};
+  auto stats = node.stats();
+  size_t total = 0;
+  for (const char* type : kMessageTypes) {
+    total += stats["message_received." + std::string(type)];
+  }
+  return total;
+}
+
+int populateRecoveryBenchmarkData(Cluster& cluster,
+                                  const RecoveryBenchmarkOptions& options) {
+  auto client = cluster.createClient();
+  if (client == nullptr) {
+    return -1;
+  }
+  std::string payload(options.payload_size, 'p');
+  for (size_t e = 0; e < options.num_epochs; ++e) {
+    if (e > 0) {
+      // Each restart of the sequencer node moves every log to a new epoch.
+      cluster.getSequencerNode().restart(
+          /* graceful */ false, /* wait_until_available */ true);
+    }
+    for (size_t i = 0; i < options.records_per_epoch; ++i) {
+      for (size_t l = 1; l <= options.num_logs; ++l) {
+        // Appends can fail transiently right after the sequencer restart.
+        int rv = wait_until("append succeeds", [&] {
+          return client->appendSync(logid_t(l), payload) != LSN_INVALID;
+        });
+        if (rv != 0) {
+          return -1;
+        }
+      }
+    }
+  }
+  return 0;
+}
+
+int runRecoveryBenchmark(Cluster& cluster,
+                         const RecoveryBenchmarkOptions& options,
+                         RecoveryBenchmarkResult* result_out) {
+  ld_check(result_out != nullptr);
+  if (populateRecoveryBenchmarkData(cluster, options) != 0) {
+    return -1;
+  }
+
+  auto client = cluster.createClient();
+  if (client == nullptr) {
+    return -1;
+  }
+
+  Node& sequencer = cluster.getSequencerNode();
+
+  // Snapshot the message counters so that only the failover is measured.
+  // The sequencer node's counters are reset by the restart, so its
+  // pre-failover counts don't need to be recorded.
+  std::map<node_index_t, size_t> received_before;
+  for (const auto& kv : cluster.getNodes()) {
+    if (kv.first != sequencer.node_index_ && kv.second->isRunning()) {
+      received_before[kv.first] = countRecoveryMessages(*kv.second);
+    }
+  }
+
+  std::string payload(options.payload_size, 'p');
+  auto start_time = std::chrono::steady_clock::now();
+
+  sequencer.kill();
+  sequencer.start();
+  if (sequencer.waitUntilStarted() != 0) {
+    return -1;
+  }
+
+  // An append is "released" once the sequencer advances last_released past
+  // its LSN, which requires recovery of all preceding epochs to finish.
+  for (size_t l = 1; l <= options.num_logs; ++l) {
+    lsn_t lsn = LSN_INVALID;
+    int rv = wait_until("append after failover succeeds", [&] {
+      lsn = client->appendSync(logid_t(l), payload);
+      return lsn != LSN_INVALID;
+    });
+    if (rv != 0) {
+      return -1;
+    }
+    rv = wait_until("append is released", [&] {
+      SequencerState state;
+      return getSeqState(client.get(), logid_t(l), state, true) == E::OK &&
+          state.last_released_lsn >= lsn;
+    });
+    if (rv != 0) {
+      return -1;
+    }
+  }
+
+  result_out->time_to_first_released_append =
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          std::chrono::steady_clock::now() - start_time);
+
+  size_t total = 0;
+  for (const auto& kv : cluster.getNodes()) {
+    if (!kv.second->isRunning()) {
+      continue;
+    }
+    size_t count = countRecoveryMessages(*kv.second);
+    auto it = received_before.find(kv.first);
+    if (it != received_before.end()) {
+      count -= std::min(count, it->second);
+    }
+    total += count;
+  }
+  result_out->recovery_messages_received = total;
+  return 0;
+}
+
 lsn_t requestShardRebuilding(Client& client,
                              node_index_t node,
                              uint32_t shard,
@@ -2136,6 +2136,62 @@ Status getSeqState(Client* client,
                    SequencerState& seq_state,
                    bool wait_for_recovery);
 
+/**
+ * Options for the recovery benchmark harness; see runRecoveryBenchmark().
+ */
+struct RecoveryBenchmarkOptions {
+  // Logs to populate and append to after the failover. Log IDs
+  // 1..num_logs must exist in the cluster's config.
+  size_t num_logs = 1;
+  // Number of epochs each log accumulates before the measured failover.
+  // Epochs are created by restarting the sequencer node between rounds of
+  // appends.
+  size_t num_epochs = 2;
+  // Records appended to each log in each epoch.
+  size_t records_per_epoch = 100;
+  size_t payload_size = 100;
+};
+
+/**
+ * Result of one runRecoveryBenchmark() run.
+ */
+struct RecoveryBenchmarkResult {
+  // Time from killing the sequencer node until an append to every log was
+  // acknowledged and released for delivery, i.e. until recovery let readers
+  // make progress again.
+  std::chrono::milliseconds time_to_first_released_append{0};
+  // Cluster-wide number of recovery-phase messages received during the
+  // failover: sealing (SEAL/SEALED), digest (START/STARTED), mutation
+  // (MUTATED) and cleaning (CLEAN/CLEANED) phases, plus the epoch recovery
+  // metadata exchange. Digest read streams share START/STARTED with regular
+  // readers, so the harness must be the only traffic in the cluster.
+  size_t recovery_messages_received{0};
+};
+
+/**
+ * Fills logs 1..options.num_logs with options.num_epochs epochs of
+ * options.records_per_epoch records each, bumping epochs by restarting the
+ * sequencer node between rounds of appends.
+ *
+ * @return 0 on success, -1 on failure.
+ */
+int populateRecoveryBenchmarkData(Cluster& cluster,
+                                  const RecoveryBenchmarkOptions& options);
+
+/**
+ * Measures one sequencer failover: populates the cluster with
+ * populateRecoveryBenchmarkData(), kills and restarts the sequencer node,
+ * then appends to every log and waits until the appends are released.
+ * Meant to be run over a sweep of options and tracked across releases as a
+ * regression gate for recovery latency; see RecoveryBenchmarkTest.cpp.
+ * Requires static sequencer placement (no hash-based assignment).
+ *
+ * @return 0 on success, -1 on failure.
+ */
+int runRecoveryBenchmark(Cluster& cluster,
+                         const RecoveryBenchmarkOptions& options,
+                         RecoveryBenchmarkResult* result_out);
+
 // Returns the default path for logdeviced
 std::string defaultLogdevicedPath();
 